@@ -18,6 +18,21 @@
 #include <stdint.h>
 #include "resource.h"
 #include "cache.h"
+#include "cacheindex.h"
+#include "cachetable.h"
+#include "stringarena.h"
+#include "cachecolumns.h"
+#include "cachesort.h"
+#include "cachechanges.h"
+#include "cachesearch.h"
+#include "cacheevict.h"
+#include "cachereconcile.h"
+#include "cachewatch.h"
+#include "cacheinfo.h"
+#include "cachededupe.h"
+#include "cacheverify.h"
+#include "cacheview.h"
+#include "cachestats.h"
 #include "base64.h"
 #include "memory.h"
 #include "error.h"
@@ -51,8 +66,12 @@
 #define BUTTON_WIDTH        78
 
 // Custom window messages
-#define WM_CACHE_SIZE_UPDATE (WM_USER + 200)
+#define WM_CACHE_CHANGED (WM_USER + 200)
 #define WM_LOG_VIEWER_UPDATE (WM_USER + 201)
+#define WM_CACHE_SORT_COMPLETE (WM_USER + 202)
+#define WM_CACHE_SCAN_PROGRESS (WM_USER + 203)
+#define WM_CACHE_DEDUPE_COMPLETE (WM_USER + 204)  // lParam: CacheDedupeReport*, freed by the receiver
+#define WM_METADATA_PREFETCHED (WM_USER + 205)    // lParam: MetadataPrefetchResult*, freed by the receiver
 #define BUTTON_HEIGHT_SMALL 24
 #define BUTTON_HEIGHT_LARGE 30
 #define TEXT_FIELD_HEIGHT   20
@@ -73,7 +92,8 @@ typedef enum {
     YTDLP_OP_DOWNLOAD,
     YTDLP_OP_VALIDATE,
     YTDLP_OP_GET_PLAYLIST_INFO,  // Get playlist metadata without downloading
-    YTDLP_OP_DOWNLOAD_PLAYLIST   // Download all videos in a playlist
+    YTDLP_OP_DOWNLOAD_PLAYLIST,  // Download all videos in a playlist
+    YTDLP_OP_DOWNLOAD_BATCH      // Download every URL in a --batch-file with one process
 } YtDlpOperation;
 
 // Validation result types
@@ -225,6 +245,9 @@ typedef struct {
 #include "settings.h"
 #include "threading.h"
 #include "threadsafe.h"
+#include "outputpipe.h"
+#include "linedecoder.h"
+#include "outputring.h"
 
 // Process options structure
 typedef struct {
@@ -403,6 +426,9 @@ typedef struct {
 #define REG_ENABLE_DEBUG    L"EnableDebug"
 #define REG_ENABLE_LOGFILE  L"EnableLogfile"
 #define REG_ENABLE_AUTOPASTE L"EnableAutopaste"
+#define REG_CACHE_BUDGETS   L"CacheBudgets"     // Subkey: one "<bytes>,<policy>" value per download root
+#define REG_FILE_INFO_THREADS L"FileInfoThreads" // Concurrency of the startup file size scan
+#define REG_YTDLP_BATCH_SIZE L"YtDlpBatchSize"  // URLs handed to each yt-dlp process by the multi-download dialog
 
 // Enhanced error dialog function prototypes moved to ui.h
 
@@ -505,6 +531,8 @@ typedef struct {
     volatile LONG stopRequested;
     volatile LONG pauseRequested;
     HANDLE hPauseEvent;          // Manual-reset event, signaled = not paused
+    volatile LONG pendingPlaylistResults; // Resolved playlists posted but not yet added to items
+    HANDLE hPlaylistEvent;       // Auto-reset, set when a resolved playlist lands or stop is requested
 
     // Statistics
     volatile LONG completedCount;
@@ -726,7 +754,9 @@ extern HWND g_hLogViewerDialog;
 #include "uri.h"
 #include "parser.h"
 #include "log.h"
+#include "ytdlpbatch.h"
 #include "ytdlp.h"
+#include "metaprefetch.h"
 #include "ui.h"
 #include "accessibility.h"
 #include "keyboard.h"
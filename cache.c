@@ -3,17 +3,228 @@
 
 // Forward declarations
 static DWORD WINAPI CacheSaveWorkerThread(LPVOID lpParam);
+static DWORD WINAPI CacheEvictionWorkerThread(LPVOID lpParam);
+static DWORD WINAPI CacheVerifyWorkerThread(LPVOID lpParam);
+static DWORD WINAPI CacheSortWorkerThread(LPVOID lpParam);
 static BOOL SaveCacheToFileInternal(CacheManager* manager);
+static BOOL CommitCacheChanges(CacheManager* manager);
 
-// Hash function for videoId (djb2)
-static unsigned int GetCacheHash(const wchar_t* videoId) {
-    if (!videoId) return 0;
-    unsigned int hash = 5381;
-    const wchar_t* p = videoId;
-    while (*p) {
-        hash = ((hash << 5) + hash) + *p++;
+// Replace what an entry adds to the running totals with what its fields say
+// now, or take it out of them once it is unlinked (caller holds the lock)
+static void CountCacheEntryStats(CacheManager* manager, CacheEntry* entry, BOOL linked) {
+    CacheStatsItem current;
+    memset(&current, 0, sizeof(CacheStatsItem));
+    if (linked) {
+        MakeCacheStatsItem(&current, entry->fileSize, entry->subtitleCount, entry->fileMissing, entry->damaged,
+                           IsCacheRootPath(manager->downloadRoot, entry->mainVideoFile));
     }
-    return hash % CACHE_HASH_BUCKETS;
+    UpdateCacheStats(&manager->stats, &entry->counted, &current);
+}
+
+// Queue a change event for the published snapshot and the listener, and wake
+// the listener once per batch (caller holds the lock)
+static void NotifyCacheChange(CacheManager* manager, const wchar_t* videoId, DWORD types) {
+    // Every change to a linked entry is notified, so the totals follow them all here
+    CacheEntry* entry = CacheHashTableFind(&manager->lookup, videoId);
+    if (entry) {
+        CountCacheEntryStats(manager, entry, !(types & CACHE_CHANGE_REMOVED));
+    }
+    
+    PushCacheChange(&manager->unpublished, videoId, types);
+    if (!manager->hChangeWindow) return;
+
+    if (PushCacheChange(&manager->changes, videoId, types)) {
+        PostMessage(manager->hChangeWindow, WM_CACHE_CHANGED, 0, 0);
+    }
+}
+
+// Link an entry into the list after 'previous' (or at the head when NULL), the
+// lookup table and the columns. Fails without linking if the video ID is already
+// cached or the table or columns cannot grow. Caller holds the lock.
+static BOOL LinkCacheEntry(CacheManager* manager, CacheEntry* entry, CacheEntry* previous) {
+    if (CacheHashTableFind(&manager->lookup, entry->videoId)) {
+        return FALSE;
+    }
+    if (!CacheHashTableInsert(&manager->lookup, entry)) {
+        ThreadSafeDebugOutput(L"YouTubeCacher: LinkCacheEntry - ERROR: Cannot grow lookup table");
+        return FALSE;
+    }
+    if (!AppendCacheColumnsRow(&manager->columns, entry)) {
+        CacheHashTableRemove(&manager->lookup, entry->videoId);
+        ThreadSafeDebugOutput(L"YouTubeCacher: LinkCacheEntry - ERROR: Cannot grow cache columns");
+        return FALSE;
+    }
+    // On failure the order is marked invalid and rebuilt by the next refresh
+    InsertCacheSortOrder(&manager->displayOrder, &manager->columns, entry);
+    AddCacheSearchDocument(&manager->search, entry);
+
+    CacheEntry* next = previous ? previous->next : manager->entries;
+    entry->prev = previous;
+    entry->next = next;
+    if (next) next->prev = entry;
+    if (previous) {
+        previous->next = entry;
+    } else {
+        manager->entries = entry;
+    }
+
+    manager->totalEntries++;
+    NotifyCacheChange(manager, entry->videoId, CACHE_CHANGE_ADDED);
+    return TRUE;
+}
+
+// Unlink an entry from the list, lookup table and columns without freeing it (caller holds the lock)
+static void UnlinkCacheEntry(CacheManager* manager, CacheEntry* entry) {
+    NotifyCacheChange(manager, entry->videoId, CACHE_CHANGE_REMOVED);
+    CacheHashTableRemove(&manager->lookup, entry->videoId);
+    RemoveCacheSearchDocument(&manager->search, entry);
+    RemoveCacheSortOrder(&manager->displayOrder, &manager->columns, entry);
+    RemoveCacheColumnsRow(&manager->columns, entry);
+
+    if (entry->prev) {
+        entry->prev->next = entry->next;
+    } else {
+        manager->entries = entry->next;
+    }
+    if (entry->next) entry->next->prev = entry->prev;
+    entry->next = NULL;
+    entry->prev = NULL;
+
+    manager->totalEntries--;
+}
+
+// Refresh the keys of a linked entry whose fields changed in place (caller holds the lock)
+static void RefreshCacheEntryKeys(CacheManager* manager, CacheEntry* entry) {
+    RemoveCacheSortOrder(&manager->displayOrder, &manager->columns, entry);
+    UpdateCacheColumnsRow(&manager->columns, entry);
+    InsertCacheSortOrder(&manager->displayOrder, &manager->columns, entry);
+}
+
+// Copy every linked entry into a new snapshot, in list order (caller holds the lock)
+static CacheViewSnapshot* BuildCacheListOrderSnapshot(CacheManager* manager) {
+    // Every linked entry has a column row, so the row count bounds the list
+    DWORD capacity = manager->columns.count;
+    CacheEntry** entries = capacity > 0 ? (CacheEntry**)SAFE_MALLOC((size_t)capacity * sizeof(CacheEntry*)) : NULL;
+    if (!entries && capacity > 0) return NULL;
+    
+    DWORD count = 0;
+    for (CacheEntry* current = manager->entries; current && count < capacity; current = current->next) {
+        entries[count++] = current;
+    }
+    CacheViewSnapshot* snapshot = BuildCacheViewSnapshot(entries, count, &manager->columns, CACHE_SORT_NONE, TRUE);
+    if (entries) SAFE_FREE(entries);
+    return snapshot;
+}
+
+// Publish a snapshot with the changes made since the last one (caller holds
+// the lock). A small batch is applied to the previous snapshot, copying only
+// the changed entries; an overflowed batch copies every entry. Unless forced,
+// changes within CACHE_SNAPSHOT_PUBLISH_INTERVAL_MS of the last publish wait
+// for a later one, so they are copied together.
+static void PublishCacheSnapshot(CacheManager* manager, BOOL force) {
+    if (manager->unpublished.count == 0 && !manager->unpublished.overflowed) return;
+    
+    DWORD now = GetTickCount();
+    if (!force && now - manager->snapshotPublishTick < CACHE_SNAPSHOT_PUBLISH_INTERVAL_MS) {
+        manager->bSnapshotStale = TRUE;
+        return;
+    }
+    manager->snapshotPublishTick = now;
+    manager->bSnapshotStale = FALSE;
+    
+    CacheChangeQueue changes;
+    TakeCacheChanges(&manager->unpublished, &changes);
+    
+    // Only publishers replace the current snapshot, and they hold the lock
+    CacheViewSnapshot* current = manager->snapshot.current;
+    CacheViewSnapshot* next = NULL;
+    if (current && !changes.overflowed && CoalesceCacheChanges(&changes) > 0) {
+        // Rows for changed entries that still exist, in video ID order like the changes
+        CacheEntry** entries = (CacheEntry**)SAFE_MALLOC((size_t)changes.count * sizeof(CacheEntry*));
+        const wchar_t** changedIds = (const wchar_t**)SAFE_MALLOC((size_t)changes.count * sizeof(wchar_t*));
+        if (entries && changedIds) {
+            DWORD count = 0;
+            for (DWORD i = 0; i < changes.count; i++) {
+                changedIds[i] = changes.changes[i].videoId;
+                CacheEntry* entry = CacheHashTableFind(&manager->lookup, changedIds[i]);
+                if (entry) entries[count++] = entry;
+            }
+            CacheViewSnapshot* patch = BuildCacheViewSnapshot(entries, count, &manager->columns, CACHE_SORT_NONE, TRUE);
+            if (patch) {
+                next = ApplyCacheViewChanges(current, changedIds, changes.count, patch);
+                ReleaseCacheViewSnapshot(patch);
+            }
+        }
+        if (entries) SAFE_FREE(entries);
+        if (changedIds) SAFE_FREE(changedIds);
+    }
+    if (!next) {
+        next = BuildCacheListOrderSnapshot(manager);
+    }
+    
+    if (next) {
+        PublishCacheViewSnapshot(&manager->snapshot, next);
+    } else {
+        // Readers keep the previous snapshot; the next publish tries again in full
+        ThreadSafeDebugOutput(L"YouTubeCacher: PublishCacheSnapshot - ERROR: Cannot allocate snapshot");
+        manager->unpublished.overflowed = TRUE;
+        manager->bSnapshotStale = TRUE;
+    }
+    FreeCacheChangeQueue(&changes);
+}
+
+// Release the lock, first publishing whatever changed while it was held
+// unless the last publish was too recent
+static void LeaveCacheLock(CacheManager* manager) {
+    PublishCacheSnapshot(manager, FALSE);
+    LeaveCriticalSection(&manager->lock);
+}
+
+// Running totals of the cache, read without taking the lock
+void GetCacheStats(CacheManager* manager, CacheStats* stats) {
+    ReadCacheStats(manager ? &manager->stats : NULL, stats);
+}
+
+#ifndef NDEBUG
+// Recount the totals from every entry and report if the running ones drifted
+// from them, which means a change was made without being notified (caller
+// holds the lock; debug builds only)
+static void CheckCacheStats(CacheManager* manager) {
+    DWORD capacity = manager->totalEntries > 0 ? (DWORD)manager->totalEntries : 0;
+    CacheStatsItem* items = capacity > 0 ? (CacheStatsItem*)SAFE_MALLOC((size_t)capacity * sizeof(CacheStatsItem)) : NULL;
+    if (!items && capacity > 0) return;
+    
+    DWORD count = 0;
+    for (CacheEntry* current = manager->entries; current && count < capacity; current = current->next) {
+        MakeCacheStatsItem(&items[count++], current->fileSize, current->subtitleCount, current->fileMissing,
+                           current->damaged, IsCacheRootPath(manager->downloadRoot, current->mainVideoFile));
+    }
+    
+    CacheStats recount;
+    SumCacheStatsItems(items, count, &recount);
+    const CacheStats* running = &manager->stats.stats;
+    if (memcmp(&recount, running, sizeof(CacheStats)) != 0) {
+        ThreadSafeDebugOutputF(L"YouTubeCacher: CheckCacheStats - ERROR: Running totals drifted: %llu bytes in %lu entries "
+                               L"(%lu missing, %lu damaged), recount %llu bytes in %lu entries (%lu missing, %lu damaged)",
+                               running->totalBytes, running->entries, running->missingEntries, running->damagedEntries,
+                               recount.totalBytes, recount.entries, recount.missingEntries, recount.damagedEntries);
+    }
+    if (items) SAFE_FREE(items);
+}
+#endif
+
+// Latest snapshot of every entry, in list order. The lock is only taken when
+// changes are waiting to be published. The caller releases it with
+// ReleaseCacheViewSnapshot.
+CacheViewSnapshot* AcquireCacheSnapshot(CacheManager* manager) {
+    if (!manager) return NULL;
+    
+    if (manager->bSnapshotStale) {
+        EnterCriticalSection(&manager->lock);
+        PublishCacheSnapshot(manager, TRUE);
+        LeaveCriticalSection(&manager->lock);
+    }
+    return AcquireCacheViewSnapshot(&manager->snapshot);
 }
 
 // Enhanced file operation error handling macro for cache operations
@@ -95,17 +306,29 @@ BOOL InitializeCacheManager(CacheManager* manager, const wchar_t* downloadPath)
     
     memset(manager, 0, sizeof(CacheManager));
     
-    // Initialize hash buckets to NULL
-    for (int i = 0; i < CACHE_HASH_BUCKETS; i++) {
-        manager->hashBuckets[i] = NULL;
-    }
+    // Lookup table starts small and grows with the cache
+    InitCacheHashTable(&manager->lookup, 0);
+    InitCacheColumns(&manager->columns, 0);
+    InitCacheSortOrder(&manager->displayOrder);
+    InitCacheChangeQueue(&manager->changes);
+    InitCacheChangeQueue(&manager->unpublished);
+    InitCacheStatsCounter(&manager->stats);
+    InitCacheViewPublisher(&manager->snapshot);
+    PublishCacheViewSnapshot(&manager->snapshot, BuildCacheViewSnapshot(NULL, 0, NULL, CACHE_SORT_NONE, TRUE));
+    InitCacheSearchIndex(&manager->search);
+    manager->sortRequestColumn = CACHE_SORT_NONE;
+    manager->sortRequestAscending = TRUE;
+    manager->downloadRoot = SAFE_WCSDUP(downloadPath);
+    manager->budget.policy = CACHE_EVICT_LRU;
     
     // Initialize critical section for thread safety
     InitializeCriticalSection(&manager->lock);
     ThreadSafeDebugOutput(L"YouTubeCacher: InitializeCacheManager - Critical section initialized");
     
-    // Build cache file path
-    swprintf(manager->cacheFilePath, MAX_EXTENDED_PATH, L"%ls\\%ls", downloadPath, CACHE_FILE_NAME);
+    // Build cache file paths
+    swprintf(manager->cacheFilePath, MAX_EXTENDED_PATH, L"%ls\\%ls", downloadPath, CACHE_INDEX_FILE_NAME);
+    swprintf(manager->legacyFilePath, MAX_EXTENDED_PATH, L"%ls\\%ls", downloadPath, CACHE_FILE_NAME);
+    swprintf(manager->journalFilePath, MAX_EXTENDED_PATH, L"%ls\\%ls", downloadPath, CACHE_JOURNAL_FILE_NAME);
     ThreadSafeDebugOutputF(L"YouTubeCacher: InitializeCacheManager - cacheFilePath: %ls", manager->cacheFilePath);
     
     // Load existing cache from file
@@ -120,6 +343,18 @@ BOOL InitializeCacheManager(CacheManager* manager, const wchar_t* downloadPath)
 
     ThreadSafeDebugOutput(L"YouTubeCacher: InitializeCacheManager - Async save thread started");
 
+    // The eviction thread sleeps until a budget is set or the cache grows
+    manager->hEvictEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+    manager->hEvictThread = CreateThread(NULL, 0, CacheEvictionWorkerThread, manager, 0, NULL);
+
+    // The integrity check thread works through the cache at its own pace
+    manager->hVerifyEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+    manager->hVerifyThread = CreateThread(NULL, 0, CacheVerifyWorkerThread, manager, 0, NULL);
+
+    // The sort thread sleeps until a column header is clicked
+    manager->hSortEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+    manager->hSortThread = CreateThread(NULL, 0, CacheSortWorkerThread, manager, 0, NULL);
+
     ThreadSafeDebugOutputF(L"YouTubeCacher: InitializeCacheManager - SUCCESS, loaded %d entries", manager->totalEntries);
     
     return TRUE;
@@ -129,16 +364,105 @@ BOOL InitializeCacheManager(CacheManager* manager, const wchar_t* downloadPath)
 void CleanupCacheManager(CacheManager* manager) {
     if (!manager) return;
     
-    // Stop the background saving thread
-    ThreadSafeDebugOutput(L"YouTubeCacher: CleanupCacheManager - Stopping async save thread");
+    // Stop the eviction thread first; its deletions still queue saves. Every worker
+    // checks bShuttingDown between units of work, so each is waited for until it
+    // has exited: freeing the cache under a thread still in it is never safe.
+    ThreadSafeDebugOutput(L"YouTubeCacher: CleanupCacheManager - Stopping eviction and async save threads");
     manager->bShuttingDown = TRUE;
+    if (manager->hEvictEvent) {
+        SetEvent(manager->hEvictEvent);
+    }
+
+    if (manager->hEvictThread) {
+        // Waits for the file deletions in progress
+        WaitForSingleObject(manager->hEvictThread, INFINITE);
+        CloseHandle(manager->hEvictThread);
+        manager->hEvictThread = NULL;
+    }
+
+    if (manager->hEvictEvent) {
+        CloseHandle(manager->hEvictEvent);
+        manager->hEvictEvent = NULL;
+    }
+
+    // The integrity check stops after the chunk it is reading
+    if (manager->hVerifyEvent) {
+        SetEvent(manager->hVerifyEvent);
+    }
+
+    if (manager->hVerifyThread) {
+        WaitForSingleObject(manager->hVerifyThread, INFINITE);
+        CloseHandle(manager->hVerifyThread);
+        manager->hVerifyThread = NULL;
+    }
+
+    if (manager->hVerifyEvent) {
+        CloseHandle(manager->hVerifyEvent);
+        manager->hVerifyEvent = NULL;
+    }
+
+    // A sort in progress finishes its one pass over the columns
+    if (manager->hSortEvent) {
+        SetEvent(manager->hSortEvent);
+    }
+
+    if (manager->hSortThread) {
+        WaitForSingleObject(manager->hSortThread, INFINITE);
+        CloseHandle(manager->hSortThread);
+        manager->hSortThread = NULL;
+    }
+
+    if (manager->hSortEvent) {
+        CloseHandle(manager->hSortEvent);
+        manager->hSortEvent = NULL;
+    }
+
+    // The startup scan starts the file scan and the folder watch, so it is
+    // waited for first; it stops after the directory each thread is listing
+    if (manager->hScanThread) {
+        WaitForSingleObject(manager->hScanThread, INFINITE);
+        CloseHandle(manager->hScanThread);
+        manager->hScanThread = NULL;
+    }
+
+    // The folder watch can start a file scan, so it stops before the scan is waited for
+    if (manager->watchBackend) {
+        StopCacheWatchBackend(manager->watchBackend);
+    }
+
+    if (manager->hWatchThread) {
+        // Waits for the directory listing in progress; the backend is only
+        // closed once nothing waits on it
+        WaitForSingleObject(manager->hWatchThread, INFINITE);
+        if (manager->watchBackend) {
+            CloseCacheWatchBackend(manager->watchBackend);
+        }
+        CloseHandle(manager->hWatchThread);
+        manager->hWatchThread = NULL;
+        manager->watchBackend = NULL;
+    }
+
+    // The file size scan stops after the stat call each I/O thread is in
+    if (manager->hSizeThread) {
+        WaitForSingleObject(manager->hSizeThread, INFINITE);
+        CloseHandle(manager->hSizeThread);
+        manager->hSizeThread = NULL;
+    }
+    
+    // The duplicate scan stops after the chunk each hashing thread is reading
+    if (manager->hDedupeThread) {
+        WaitForSingleObject(manager->hDedupeThread, INFINITE);
+        CloseHandle(manager->hDedupeThread);
+        manager->hDedupeThread = NULL;
+    }
+
     if (manager->hSaveEvent) {
         SetEvent(manager->hSaveEvent);
     }
 
     if (manager->hSaveThread) {
-        // Wait for the thread to finish (max 5 seconds)
-        WaitForSingleObject(manager->hSaveThread, 5000);
+        // Waits for the commit in progress
+        WaitForSingleObject(manager->hSaveThread, INFINITE);
         CloseHandle(manager->hSaveThread);
         manager->hSaveThread = NULL;
     }
@@ -165,83 +489,270 @@ void CleanupCacheManager(CacheManager* manager) {
     manager->entries = NULL;
     manager->totalEntries = 0;
 
-    // Clear hash buckets
-    for (int i = 0; i < CACHE_HASH_BUCKETS; i++) {
-        manager->hashBuckets[i] = NULL;
+    // Release the lookup table
+    FreeCacheHashTable(&manager->lookup);
+    FreeCacheColumns(&manager->columns);
+    FreeCacheSortOrder(&manager->displayOrder);
+    FreeCacheChangeQueue(&manager->changes);
+    manager->hChangeWindow = NULL;
+    FreeCacheChangeQueue(&manager->unpublished);
+    FreeCacheViewPublisher(&manager->snapshot);
+    FreeCacheSearchIndex(&manager->search);
+    if (manager->listFilter) {
+        SAFE_FREE(manager->listFilter);
+        manager->listFilter = NULL;
+    }
+    if (manager->downloadRoot) {
+        SAFE_FREE(manager->downloadRoot);
+        manager->downloadRoot = NULL;
+    }
+    
+    // Entries that borrowed from the index mapping are gone, so the view can be released
+    if (manager->indexView) {
+        UnmapViewOfFile((LPCVOID)manager->indexView);
+        manager->indexView = NULL;
     }
     
+    FreeCacheJournalBuffer(&manager->pendingJournal);
+    
     LeaveCriticalSection(&manager->lock);
     DeleteCriticalSection(&manager->lock);
     
     ThreadSafeDebugOutput(L"YouTubeCacher: CleanupCacheManager - Cleanup complete");
 }
 
-// Free a single cache entry
-void FreeCacheEntry(CacheEntry* entry) {
-    if (!entry) return;
+// Free the string fields of an entry, leaving the entry itself allocated
+static void ReleaseCacheEntryStrings(CacheEntry* entry) {
+    if (entry->stringArena) {
+        // Strings and the subtitle array live in a shared arena; drop this entry's reference
+        ReleaseStringArena(entry->stringArena);
+        entry->stringArena = NULL;
+        entry->videoId = NULL;
+        entry->title = NULL;
+        entry->duration = NULL;
+        entry->mainVideoFile = NULL;
+        entry->subtitleFiles = NULL;
+    }
     
-    if (entry->videoId) SAFE_FREE(entry->videoId);
-    if (entry->title) SAFE_FREE(entry->title);
-    if (entry->duration) SAFE_FREE(entry->duration);
-    if (entry->mainVideoFile) SAFE_FREE(entry->mainVideoFile);
+    // Borrowed strings belong to the index mapping and are released with it
+    if (!entry->borrowedStrings) {
+        if (entry->videoId) SAFE_FREE(entry->videoId);
+        if (entry->title) SAFE_FREE(entry->title);
+        if (entry->duration) SAFE_FREE(entry->duration);
+        if (entry->mainVideoFile) SAFE_FREE(entry->mainVideoFile);
+    }
     
     if (entry->subtitleFiles) {
-        for (int i = 0; i < entry->subtitleCount; i++) {
-            if (entry->subtitleFiles[i]) {
-                SAFE_FREE(entry->subtitleFiles[i]);
+        if (!entry->borrowedStrings) {
+            for (int i = 0; i < entry->subtitleCount; i++) {
+                if (entry->subtitleFiles[i]) {
+                    SAFE_FREE(entry->subtitleFiles[i]);
+                }
             }
         }
         SAFE_FREE(entry->subtitleFiles);
     }
     
+    entry->videoId = NULL;
+    entry->title = NULL;
+    entry->duration = NULL;
+    entry->mainVideoFile = NULL;
+    entry->subtitleFiles = NULL;
+    entry->subtitleCount = 0;
+    entry->borrowedStrings = FALSE;
+}
+
+// Free a single cache entry
+void FreeCacheEntry(CacheEntry* entry) {
+    if (!entry) return;
+    
+    ReleaseCacheEntryStrings(entry);
     SAFE_FREE(entry);
 }
 
-// Optimized cache loading: Load entire file into memory and process in-place
-BOOL LoadCacheFromFile(CacheManager* manager) {
-    if (!manager) return FALSE;
+// Legacy files are parsed on up to this many threads, each taking at least this many lines
+#define LEGACY_PARSE_MAX_WORKERS            16
+#define LEGACY_PARSE_MIN_LINES_PER_WORKER   4096
+
+// One contiguous slice of the legacy line array and the entries parsed from it
+typedef struct {
+    char** lines;
+    int firstLine;
+    int lineCount;
+    int skipLine;               // Index of the CACHE_VERSION header line, or -1
+    StringArena* arena;         // Holds the strings of every entry in the batch
+    CacheEntry** entries;       // Parsed entries in line order
+    int entryCount;
+    int invalidEntries;
+} LegacyParseBatch;
+
+// Parse one legacy index line: VIDEO_ID|TITLE|DURATION|MAIN_FILE|SUBTITLE_COUNT|...
+// Returns NULL for lines that are skipped or invalid; *invalid is set for the latter.
+// Strings are allocated from the caller's arena, which no other thread may use meanwhile.
+static CacheEntry* ParseLegacyCacheLine(const char* line, StringArena* arena, BOOL* invalid) {
+    *invalid = FALSE;
+    if (!line || strlen(line) == 0) return NULL; // Skip empty lines
+    if (line[0] == '#') return NULL; // Skip comments
+    
+    // Convert line to wide string for processing
+    int wideLen = MultiByteToWideChar(CP_UTF8, 0, line, -1, NULL, 0);
+    if (wideLen <= 0) return NULL;
+    
+    wchar_t* wideLine = (wchar_t*)SAFE_MALLOC(wideLen * sizeof(wchar_t));
+    if (!wideLine) return NULL;
+    
+    if (MultiByteToWideChar(CP_UTF8, 0, line, -1, wideLine, wideLen) <= 0) {
+        SAFE_FREE(wideLine);
+        return NULL;
+    }
+    
+    wchar_t* context = NULL;
+    wchar_t* videoId = wcstok(wideLine, L"|", &context);
+    if (!videoId || wcslen(videoId) == 0) {
+        SAFE_FREE(wideLine);
+        *invalid = TRUE;
+        return NULL;
+    }
+    
+    // Quick validation and parsing
+    CacheEntry* entry = (CacheEntry*)SAFE_MALLOC(sizeof(CacheEntry));
+    if (!entry) {
+        SAFE_FREE(wideLine);
+        return NULL;
+    }
     
-    ThreadSafeDebugOutput(L"YouTubeCacher: LoadCacheFromFile - ENTRY (optimized version)");
+    memset(entry, 0, sizeof(CacheEntry));
+    entry->stringArena = arena;
+    RetainStringArena(arena);
+    entry->videoId = StringArenaWcsDup(arena, videoId);
+    if (!entry->videoId) {
+        FreeCacheEntry(entry);
+        SAFE_FREE(wideLine);
+        return NULL;
+    }
+    
+    // Parse title (base64 encoded)
+    wchar_t* titleToken = wcstok(NULL, L"|", &context);
+    wchar_t* decodedTitle = (titleToken && wcslen(titleToken) > 0) ? Base64DecodeWide(titleToken) : NULL;
+    if (decodedTitle) {
+        entry->title = StringArenaWcsDup(arena, decodedTitle);
+        SAFE_FREE(decodedTitle);
+    } else {
+        entry->title = StringArenaWcsDup(arena, L"Unknown Title");
+    }
+    
+    // Parse duration
+    wchar_t* durationToken = wcstok(NULL, L"|", &context);
+    if (durationToken && wcslen(durationToken) > 0) {
+        entry->duration = StringArenaWcsDup(arena, durationToken);
+    } else {
+        entry->duration = StringArenaWcsDup(arena, L"Unknown");
+    }
+    
+    // Parse main video file
+    wchar_t* fileToken = wcstok(NULL, L"|", &context);
+    if (fileToken && wcslen(fileToken) > 0) {
+        entry->mainVideoFile = StringArenaWcsDup(arena, fileToken);
+    } else {
+        // Missing main file - invalid entry
+        FreeCacheEntry(entry);
+        SAFE_FREE(wideLine);
+        *invalid = TRUE;
+        return NULL;
+    }
+    
+    // Parse subtitle count and files (simplified for performance)
+    wchar_t* subtitleCountToken = wcstok(NULL, L"|", &context);
+    if (subtitleCountToken) {
+        entry->subtitleCount = _wtoi(subtitleCountToken);
+        if (entry->subtitleCount > 0 && entry->subtitleCount <= 100) { // Reasonable limit
+            entry->subtitleFiles = (wchar_t**)StringArenaAlloc(arena, entry->subtitleCount * sizeof(wchar_t*));
+            if (entry->subtitleFiles) {
+                memset(entry->subtitleFiles, 0, entry->subtitleCount * sizeof(wchar_t*));
+                for (int j = 0; j < entry->subtitleCount; j++) {
+                    wchar_t* subtitleToken = wcstok(NULL, L"|", &context);
+                    if (subtitleToken && wcslen(subtitleToken) > 0) {
+                        entry->subtitleFiles[j] = StringArenaWcsDup(arena, subtitleToken);
+                    }
+                }
+            }
+        }
+    }
+    
+    SAFE_FREE(wideLine);
+    return entry;
+}
+
+// Parse one slice of the legacy line array into its own entry batch
+static DWORD WINAPI LegacyParseWorker(LPVOID lpParam) {
+    LegacyParseBatch* batch = (LegacyParseBatch*)lpParam;
+    
+    batch->arena = CreateStringArena(STRING_ARENA_DEFAULT_BLOCK_SIZE);
+    batch->entries = (CacheEntry**)SAFE_MALLOC((batch->lineCount > 0 ? batch->lineCount : 1) * sizeof(CacheEntry*));
+    if (!batch->arena || !batch->entries) {
+        batch->invalidEntries = batch->lineCount;
+        return 1;
+    }
+    
+    for (int i = 0; i < batch->lineCount; i++) {
+        int lineIndex = batch->firstLine + i;
+        if (lineIndex == batch->skipLine) continue;
+        
+        BOOL invalid = FALSE;
+        CacheEntry* entry = ParseLegacyCacheLine(batch->lines[lineIndex], batch->arena, &invalid);
+        if (entry) {
+            batch->entries[batch->entryCount++] = entry;
+        } else if (invalid) {
+            batch->invalidEntries++;
+        }
+    }
+    return 0;
+}
+
+// Legacy text index loader (CACHE_VERSION=1.0), used only to migrate to the binary index.
+// Loads entire file into memory and processes it in-place.
+static BOOL LoadLegacyCacheFile(CacheManager* manager) {
+    ThreadSafeDebugOutput(L"YouTubeCacher: LoadLegacyCacheFile - ENTRY");
     
     // Step 1: Use Windows API to get file size (equivalent to stat())
-    HANDLE hFile = CreateFileW(manager->cacheFilePath, GENERIC_READ, FILE_SHARE_READ, NULL, 
+    HANDLE hFile = CreateFileW(manager->legacyFilePath, GENERIC_READ, FILE_SHARE_READ, NULL, 
                               OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
     if (hFile == INVALID_HANDLE_VALUE) {
         DWORD error = GetLastError();
         if (error == ERROR_FILE_NOT_FOUND) {
-            ThreadSafeDebugOutput(L"YouTubeCacher: LoadCacheFromFile - Cache file does not exist, starting with empty cache");
+            ThreadSafeDebugOutput(L"YouTubeCacher: LoadLegacyCacheFile - Cache file does not exist, starting with empty cache");
             return TRUE; // Not an error - just no cache file yet
         }
-        ThreadSafeDebugOutputF(L"YouTubeCacher: LoadCacheFromFile - ERROR: Cannot open file (error %lu)", error);
+        ThreadSafeDebugOutputF(L"YouTubeCacher: LoadLegacyCacheFile - ERROR: Cannot open file (error %lu)", error);
         return FALSE;
     }
     
     LARGE_INTEGER fileSize;
     if (!GetFileSizeEx(hFile, &fileSize)) {
-        ThreadSafeDebugOutput(L"YouTubeCacher: LoadCacheFromFile - ERROR: Cannot get file size");
+        ThreadSafeDebugOutput(L"YouTubeCacher: LoadLegacyCacheFile - ERROR: Cannot get file size");
         CloseHandle(hFile);
         return FALSE;
     }
     
     if (fileSize.QuadPart == 0) {
-        ThreadSafeDebugOutput(L"YouTubeCacher: LoadCacheFromFile - File is empty, starting with empty cache");
+        ThreadSafeDebugOutput(L"YouTubeCacher: LoadLegacyCacheFile - File is empty, starting with empty cache");
         CloseHandle(hFile);
         return TRUE;
     }
     
     if (fileSize.QuadPart > 50 * 1024 * 1024) { // 50MB limit for safety
-        ThreadSafeDebugOutput(L"YouTubeCacher: LoadCacheFromFile - ERROR: File too large for in-memory processing");
+        ThreadSafeDebugOutput(L"YouTubeCacher: LoadLegacyCacheFile - ERROR: File too large for in-memory processing");
         CloseHandle(hFile);
         return FALSE;
     }
     
-    ThreadSafeDebugOutputF(L"YouTubeCacher: LoadCacheFromFile - File size: %lld bytes", fileSize.QuadPart);
+    ThreadSafeDebugOutputF(L"YouTubeCacher: LoadLegacyCacheFile - File size: %lld bytes", fileSize.QuadPart);
     
     // Step 2: Allocate buffer to load entire file (use ANSI for simplicity, convert to wide later)
     DWORD fileSizeBytes = (DWORD)fileSize.QuadPart;
     char* fileBuffer = (char*)SAFE_MALLOC(fileSizeBytes + 1); // +1 for null terminator
     if (!fileBuffer) {
-        ThreadSafeDebugOutput(L"YouTubeCacher: LoadCacheFromFile - ERROR: Cannot allocate file buffer");
+        ThreadSafeDebugOutput(L"YouTubeCacher: LoadLegacyCacheFile - ERROR: Cannot allocate file buffer");
         CloseHandle(hFile);
         return FALSE;
     }
@@ -252,7 +763,7 @@ BOOL LoadCacheFromFile(CacheManager* manager) {
         DWORD chunkSize = min(4096, fileSizeBytes - totalBytesRead);
         DWORD bytesRead;
         if (!ReadFile(hFile, fileBuffer + totalBytesRead, chunkSize, &bytesRead, NULL) || bytesRead == 0) {
-            ThreadSafeDebugOutput(L"YouTubeCacher: LoadCacheFromFile - ERROR: Failed to read file");
+            ThreadSafeDebugOutput(L"YouTubeCacher: LoadLegacyCacheFile - ERROR: Failed to read file");
             SAFE_FREE(fileBuffer);
             CloseHandle(hFile);
             return FALSE;
@@ -263,7 +774,7 @@ BOOL LoadCacheFromFile(CacheManager* manager) {
     CloseHandle(hFile);
     fileBuffer[fileSizeBytes] = '\0'; // Null terminate
     
-    ThreadSafeDebugOutput(L"YouTubeCacher: LoadCacheFromFile - File loaded into memory successfully");
+    ThreadSafeDebugOutput(L"YouTubeCacher: LoadLegacyCacheFile - File loaded into memory successfully");
     
     // Step 3: Scan for newlines and count them
     int newlineCount = 0;
@@ -273,10 +784,10 @@ BOOL LoadCacheFromFile(CacheManager* manager) {
         }
     }
     
-    ThreadSafeDebugOutputF(L"YouTubeCacher: LoadCacheFromFile - Found %d lines", newlineCount);
+    ThreadSafeDebugOutputF(L"YouTubeCacher: LoadLegacyCacheFile - Found %d lines", newlineCount);
     
     if (newlineCount == 0) {
-        ThreadSafeDebugOutput(L"YouTubeCacher: LoadCacheFromFile - No lines found in file");
+        ThreadSafeDebugOutput(L"YouTubeCacher: LoadLegacyCacheFile - No lines found in file");
         SAFE_FREE(fileBuffer);
         return TRUE;
     }
@@ -284,7 +795,7 @@ BOOL LoadCacheFromFile(CacheManager* manager) {
     // Step 4: Allocate pointer array (2 more than newline count for safety)
     char** lines = (char**)SAFE_MALLOC((newlineCount + 2) * sizeof(char*));
     if (!lines) {
-        ThreadSafeDebugOutput(L"YouTubeCacher: LoadCacheFromFile - ERROR: Cannot allocate line pointer array");
+        ThreadSafeDebugOutput(L"YouTubeCacher: LoadLegacyCacheFile - ERROR: Cannot allocate line pointer array");
         SAFE_FREE(fileBuffer);
         return FALSE;
     }
@@ -314,744 +825,2156 @@ BOOL LoadCacheFromFile(CacheManager* manager) {
     }
     
     int totalLines = lineIndex;
-    ThreadSafeDebugOutputF(L"YouTubeCacher: LoadCacheFromFile - Processed into %d lines", totalLines);
-    
-    // Step 6: Process cache entries in-place
-    EnterCriticalSection(&manager->lock);
-    
-    int validEntries = 0;
-    int invalidEntries = 0;
-    BOOL versionValidated = FALSE;
+    ThreadSafeDebugOutputF(L"YouTubeCacher: LoadLegacyCacheFile - Processed into %d lines", totalLines);
     
+    // Step 6: Locate the version header so workers can skip it
+    int versionLine = -1;
     for (int i = 0; i < totalLines; i++) {
         char* line = lines[i];
-        if (!line || strlen(line) == 0) continue; // Skip empty lines
-        if (line[0] == '#') continue; // Skip comments
-        
-        // Convert line to wide string for processing
-        int wideLen = MultiByteToWideChar(CP_UTF8, 0, line, -1, NULL, 0);
-        if (wideLen <= 0) continue;
-        
-        wchar_t* wideLine = (wchar_t*)SAFE_MALLOC(wideLen * sizeof(wchar_t));
-        if (!wideLine) continue;
-        
-        if (MultiByteToWideChar(CP_UTF8, 0, line, -1, wideLine, wideLen) <= 0) {
-            SAFE_FREE(wideLine);
-            continue;
-        }
-        
-        // Handle version header
-        if (!versionValidated && wcsncmp(wideLine, L"CACHE_VERSION=", 14) == 0) {
-            const wchar_t* version = wideLine + 14;
-            if (wcscmp(version, CACHE_VERSION) != 0) {
-                ThreadSafeDebugOutputF(L"YouTubeCacher: LoadCacheFromFile - WARNING: Version mismatch. File: '%ls', Expected: '%ls'", version, CACHE_VERSION);
+        if (!line || line[0] == '\0' || line[0] == '#') continue;
+        if (strncmp(line, "CACHE_VERSION=", 14) == 0) {
+            wchar_t version[64];
+            if (MultiByteToWideChar(CP_UTF8, 0, line + 14, -1, version, 64) > 0 && wcscmp(version, CACHE_VERSION) != 0) {
+                ThreadSafeDebugOutputF(L"YouTubeCacher: LoadLegacyCacheFile - WARNING: Version mismatch. File: '%ls', Expected: '%ls'", version, CACHE_VERSION);
             }
-            versionValidated = TRUE;
-            SAFE_FREE(wideLine);
-            continue;
+            versionLine = i;
+            break;
         }
-        
-        // Parse cache entry: VIDEO_ID|TITLE|DURATION|MAIN_FILE|SUBTITLE_COUNT|...
-        wchar_t* context = NULL;
-        wchar_t* videoId = wcstok(wideLine, L"|", &context);
-        if (!videoId || wcslen(videoId) == 0) {
-            SAFE_FREE(wideLine);
-            invalidEntries++;
-            continue;
+    }
+    
+    // Step 7: Parse contiguous slices of the line array in parallel, one entry batch per slice
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    int workerCount = (int)systemInfo.dwNumberOfProcessors;
+    int maxUsefulWorkers = (totalLines + LEGACY_PARSE_MIN_LINES_PER_WORKER - 1) / LEGACY_PARSE_MIN_LINES_PER_WORKER;
+    if (workerCount > maxUsefulWorkers) workerCount = maxUsefulWorkers;
+    if (workerCount > LEGACY_PARSE_MAX_WORKERS) workerCount = LEGACY_PARSE_MAX_WORKERS;
+    if (workerCount < 1) workerCount = 1;
+    
+    LegacyParseBatch batches[LEGACY_PARSE_MAX_WORKERS];
+    HANDLE workers[LEGACY_PARSE_MAX_WORKERS];
+    int linesPerWorker = (totalLines + workerCount - 1) / workerCount;
+    for (int w = 0; w < workerCount; w++) {
+        memset(&batches[w], 0, sizeof(LegacyParseBatch));
+        batches[w].lines = lines;
+        batches[w].firstLine = w * linesPerWorker;
+        batches[w].lineCount = min(linesPerWorker, totalLines - batches[w].firstLine);
+        batches[w].skipLine = versionLine;
+        workers[w] = NULL;
+    }
+    
+    // Slice 0 runs on this thread; a slice whose thread cannot start also runs here
+    for (int w = 1; w < workerCount; w++) {
+        workers[w] = CreateThread(NULL, 0, LegacyParseWorker, &batches[w], 0, NULL);
+        if (!workers[w]) {
+            LegacyParseWorker(&batches[w]);
         }
-        
-        // Quick validation and parsing
-        CacheEntry* entry = (CacheEntry*)SAFE_MALLOC(sizeof(CacheEntry));
-        if (!entry) {
-            SAFE_FREE(wideLine);
-            continue;
+    }
+    LegacyParseWorker(&batches[0]);
+    for (int w = 1; w < workerCount; w++) {
+        if (workers[w]) {
+            WaitForSingleObject(workers[w], INFINITE);
+            CloseHandle(workers[w]);
         }
-        
-        memset(entry, 0, sizeof(CacheEntry));
-        entry->videoId = SAFE_WCSDUP(videoId);
-        
-        // Parse title (base64 encoded)
-        wchar_t* titleToken = wcstok(NULL, L"|", &context);
-        if (titleToken && wcslen(titleToken) > 0) {
-            entry->title = Base64DecodeWide(titleToken);
-            if (!entry->title) {
-                entry->title = SAFE_WCSDUP(L"Unknown Title");
+    }
+    
+    ThreadSafeDebugOutputF(L"YouTubeCacher: LoadLegacyCacheFile - Parsed %d lines on %d threads", totalLines, workerCount);
+    
+    // Step 8: Gather the batches in file order. A video listed on several lines
+    // keeps its last line, which the serial loader's head-first lookups found.
+    int validEntries = 0;
+    int invalidEntries = 0;
+    DWORD parsedEntries = 0;
+    for (int w = 0; w < workerCount; w++) {
+        invalidEntries += batches[w].invalidEntries;
+        parsedEntries += (DWORD)batches[w].entryCount;
+    }
+    
+    CacheEntry** parsed = (CacheEntry**)SAFE_MALLOC((parsedEntries > 0 ? parsedEntries : 1) * sizeof(CacheEntry*));
+    DWORD keptEntries = 0;
+    if (parsed) {
+        DWORD next = 0;
+        for (int w = 0; w < workerCount; w++) {
+            for (int i = 0; i < batches[w].entryCount; i++) {
+                parsed[next++] = batches[w].entries[i];
             }
-        } else {
-            entry->title = SAFE_WCSDUP(L"Unknown Title");
         }
-        
-        // Parse duration
-        wchar_t* durationToken = wcstok(NULL, L"|", &context);
-        if (durationToken && wcslen(durationToken) > 0) {
-            entry->duration = SAFE_WCSDUP(durationToken);
-        } else {
-            entry->duration = SAFE_WCSDUP(L"Unknown");
+        keptEntries = KeepLastCacheEntries(parsed, parsedEntries);
+    } else {
+        ThreadSafeDebugOutput(L"YouTubeCacher: LoadLegacyCacheFile - ERROR: Cannot allocate entry array");
+        for (int w = 0; w < workerCount; w++) {
+            for (int i = 0; i < batches[w].entryCount; i++) {
+                FreeCacheEntry(batches[w].entries[i]);
+            }
         }
-        
-        // Parse main video file
-        wchar_t* fileToken = wcstok(NULL, L"|", &context);
-        if (fileToken && wcslen(fileToken) > 0) {
-            entry->mainVideoFile = SAFE_WCSDUP(fileToken);
+        parsedEntries = 0;
+    }
+    
+    // Step 9: Link the entries in file order under one short lock, each at the
+    // head, which gives the order of the serial pass
+    EnterCriticalSection(&manager->lock);
+    
+    ReserveCacheHashTable(&manager->lookup, (DWORD)manager->totalEntries + keptEntries);
+    ReserveCacheColumns(&manager->columns, (DWORD)manager->totalEntries + keptEntries);
+    for (DWORD i = 0; i < parsedEntries; i++) {
+        CacheEntry* entry = parsed[i];
+        // Add entry to cache (file info will be populated by background thread)
+        if (i < keptEntries && LinkCacheEntry(manager, entry, NULL)) {
+            validEntries++;
         } else {
-            // Missing main file - invalid entry
-            FreeCacheEntry(entry);
-            SAFE_FREE(wideLine);
+            FreeCacheEntry(entry); // Replaced by a later line, or already cached
             invalidEntries++;
-            continue;
-        }
-        
-        // Parse subtitle count and files (simplified for performance)
-        wchar_t* subtitleCountToken = wcstok(NULL, L"|", &context);
-        if (subtitleCountToken) {
-            entry->subtitleCount = _wtoi(subtitleCountToken);
-            if (entry->subtitleCount > 0 && entry->subtitleCount <= 100) { // Reasonable limit
-                entry->subtitleFiles = (wchar_t**)SAFE_MALLOC(entry->subtitleCount * sizeof(wchar_t*));
-                if (entry->subtitleFiles) {
-                    memset(entry->subtitleFiles, 0, entry->subtitleCount * sizeof(wchar_t*));
-                    for (int j = 0; j < entry->subtitleCount; j++) {
-                        wchar_t* subtitleToken = wcstok(NULL, L"|", &context);
-                        if (subtitleToken && wcslen(subtitleToken) > 0) {
-                            entry->subtitleFiles[j] = SAFE_WCSDUP(subtitleToken);
-                        }
-                    }
-                }
-            }
         }
-        
-        // Add entry to cache (file info will be populated by background thread)
-        entry->next = manager->entries;
-        manager->entries = entry;
-        manager->totalEntries++;
-        validEntries++;
-        
-        SAFE_FREE(wideLine);
     }
     
-    LeaveCriticalSection(&manager->lock);
+    LeaveCacheLock(manager);
+    
+    // Entries now hold the only references to the batch arenas
+    if (parsed) SAFE_FREE(parsed);
+    for (int w = 0; w < workerCount; w++) {
+        if (batches[w].entries) SAFE_FREE(batches[w].entries);
+        ReleaseStringArena(batches[w].arena);
+    }
+    if (!parsed) {
+        SAFE_FREE(lines);
+        SAFE_FREE(fileBuffer);
+        return FALSE;
+    }
     
     // Cleanup
     SAFE_FREE(lines);
     SAFE_FREE(fileBuffer);
     
-    ThreadSafeDebugOutputF(L"YouTubeCacher: LoadCacheFromFile - COMPLETE: Loaded %d valid entries, %d invalid entries", validEntries, invalidEntries);
+    ThreadSafeDebugOutputF(L"YouTubeCacher: LoadLegacyCacheFile - COMPLETE: Loaded %d valid entries, %d invalid entries", validEntries, invalidEntries);
     
     return TRUE;
 }
 
-// Internal function to perform synchronous cache saving
-static BOOL SaveCacheToFileInternal(CacheManager* manager) {
-    ThreadSafeDebugOutput(L"YouTubeCacher: SaveCacheToFileInternal - ENTRY");
-    
-    if (!manager) {
-        ThreadSafeDebugOutput(L"YouTubeCacher: SaveCacheToFileInternal - ERROR: NULL manager");
-        return FALSE;
-    }
-    
-    ThreadSafeDebugOutputF(L"YouTubeCacher: SaveCacheToFileInternal - Attempting to save to: %ls", manager->cacheFilePath);
-    
-    FILE* file = _wfopen(manager->cacheFilePath, L"w,ccs=UTF-8");
-    if (!file) {
-        DWORD error = GetLastError();
-        
-        // Use enhanced error handling with better context information
-        ErrorContext* ctx = CREATE_ERROR_CONTEXT(YTC_ERROR_FILE_ACCESS, YTC_SEVERITY_ERROR);
-        if (ctx) {
-            AddContextVariable(ctx, L"FilePath", manager->cacheFilePath);
-            AddContextVariable(ctx, L"Operation", L"Open cache file for writing");
-            wchar_t errorCodeStr[32];
-            swprintf(errorCodeStr, 32, L"%lu", error);
-            AddContextVariable(ctx, L"SystemError", errorCodeStr);
-            
-            if (error == ERROR_ACCESS_DENIED) {
-                SetUserFriendlyMessage(ctx, L"Cannot save cache file due to insufficient permissions.\r\nPlease check folder permissions or run as administrator.");
-            } else if (error == ERROR_DISK_FULL) {
-                SetUserFriendlyMessage(ctx, L"Cannot save cache file because the disk is full.\r\nPlease free up disk space and try again.");
-            } else if (error == ERROR_PATH_NOT_FOUND) {
-                SetUserFriendlyMessage(ctx, L"Cannot save cache file because the folder path does not exist.\r\nPlease check that the download folder is accessible.");
-            } else {
-                SetUserFriendlyMessage(ctx, L"Unable to save cache file due to a system error.\r\nThe storage device may have issues or be write-protected.");
-            }
-            FreeErrorContext(ctx);
+// Copy borrowed string fields into an arena so the entry no longer depends on the index mapping
+static BOOL MaterializeCacheEntryStrings(CacheEntry* entry, StringArena* arena) {
+    if (!entry || !entry->borrowedStrings) return TRUE;
+
+    wchar_t* videoId = StringArenaWcsDup(arena, entry->videoId);
+    wchar_t* title = StringArenaWcsDup(arena, entry->title);
+    wchar_t* duration = StringArenaWcsDup(arena, entry->duration);
+    wchar_t* mainVideoFile = StringArenaWcsDup(arena, entry->mainVideoFile);
+    BOOL ok = (videoId || !entry->videoId) && (title || !entry->title) &&
+              (duration || !entry->duration) && (mainVideoFile || !entry->mainVideoFile);
+
+    wchar_t** subtitleFiles = NULL;
+    if (ok && entry->subtitleFiles && entry->subtitleCount > 0) {
+        subtitleFiles = (wchar_t**)StringArenaAlloc(arena, entry->subtitleCount * sizeof(wchar_t*));
+        ok = (subtitleFiles != NULL);
+        for (int i = 0; i < entry->subtitleCount && ok; i++) {
+            subtitleFiles[i] = StringArenaWcsDup(arena, entry->subtitleFiles[i]);
+            ok = (subtitleFiles[i] || !entry->subtitleFiles[i]);
+        }
+    }
+
+    // On failure the partial copies are reclaimed with the arena and the entry keeps borrowing
+    if (!ok) return FALSE;
+
+    if (entry->subtitleFiles) SAFE_FREE(entry->subtitleFiles);
+    entry->subtitleFiles = subtitleFiles;
+    entry->videoId = videoId;
+    entry->title = title;
+    entry->duration = duration;
+    entry->mainVideoFile = mainVideoFile;
+    entry->borrowedStrings = FALSE;
+    entry->stringArena = arena;
+    RetainStringArena(arena);
+    return TRUE;
+}
+
+// Release the index mapping so the index file can be replaced.
+// Entries still borrowing strings from the view are copied into one shared arena first.
+static BOOL ReleaseCacheIndexView(CacheManager* manager) {
+    EnterCriticalSection(&manager->lock);
+
+    if (!manager->indexView) {
+        LeaveCacheLock(manager);
+        return TRUE;
+    }
+
+    StringArena* arena = CreateStringArena(STRING_ARENA_DEFAULT_BLOCK_SIZE);
+    CacheEntry* current = manager->entries;
+    while (current) {
+        if (!arena || !MaterializeCacheEntryStrings(current, arena)) {
+            ReleaseStringArena(arena);
+            LeaveCacheLock(manager);
+            ThreadSafeDebugOutput(L"YouTubeCacher: ReleaseCacheIndexView - ERROR: Cannot copy index strings out of the mapping");
+            return FALSE;
+        }
+        current = current->next;
+    }
+    ReleaseStringArena(arena);
+
+    UnmapViewOfFile((LPCVOID)manager->indexView);
+    manager->indexView = NULL;
+
+    LeaveCacheLock(manager);
+    return TRUE;
+}
+
+// Build an entry from an index record. Without an arena the entry points into the
+// reader's data, which must outlive it; otherwise every string is copied into the arena.
+static CacheEntry* CreateCacheEntryFromIndexRecord(const CacheIndexReader* reader, const CacheIndexRecord* record, StringArena* arena) {
+    const wchar_t* videoId = GetCacheIndexString(reader, record->videoId);
+    const wchar_t* mainVideoFile = GetCacheIndexString(reader, record->mainVideoFile);
+    if (!videoId || !*videoId || !mainVideoFile || !*mainVideoFile) {
+        return NULL;
+    }
+
+    CacheEntry* entry = (CacheEntry*)SAFE_MALLOC(sizeof(CacheEntry));
+    if (!entry) return NULL;
+
+    memset(entry, 0, sizeof(CacheEntry));
+    entry->borrowedStrings = TRUE;
+    entry->videoId = (wchar_t*)videoId;
+    entry->title = (wchar_t*)GetCacheIndexString(reader, record->title);
+    entry->duration = (wchar_t*)GetCacheIndexString(reader, record->duration);
+    entry->mainVideoFile = (wchar_t*)mainVideoFile;
+    entry->downloadTime = record->downloadTime;
+    entry->fileSize = record->fileSize;
+    entry->lastAccessTime = record->lastAccessTime;
+    entry->accessCount = record->accessCount;
+    entry->hashWriteTime = record->hashWriteTime;
+    entry->sampleHash = record->sampleHash;
+    entry->contentHash = record->contentHash;
+    entry->verifyTime = record->verifyTime;
+    entry->damaged = (record->flags & CACHE_INDEX_FLAG_DAMAGED) != 0;
+    entry->fileMissing = (record->flags & CACHE_INDEX_FLAG_MISSING) != 0;
+
+    if (record->subtitleCount > 0 && record->subtitleCount <= 100) { // Same limit as the legacy format
+        entry->subtitleFiles = (wchar_t**)SAFE_MALLOC(record->subtitleCount * sizeof(wchar_t*));
+        if (entry->subtitleFiles) {
+            for (DWORD j = 0; j < record->subtitleCount; j++) {
+                entry->subtitleFiles[j] = (wchar_t*)GetCacheIndexSubtitle(reader, record, j);
+            }
+            entry->subtitleCount = (int)record->subtitleCount;
+        }
+    }
+
+    if (arena && !MaterializeCacheEntryStrings(entry, arena)) {
+        // Nothing was copied, so only the containers need freeing
+        if (entry->subtitleFiles) SAFE_FREE(entry->subtitleFiles);
+        SAFE_FREE(entry);
+        return NULL;
+    }
+
+    return entry;
+}
+
+// Map cache_index.bin and link entries whose strings point straight into the view.
+// *found is set when an index file exists, so callers can tell "missing" from "corrupt".
+static BOOL LoadCacheIndexFile(CacheManager* manager, BOOL* found) {
+    *found = FALSE;
+
+    HANDLE hFile = CreateFileW(manager->cacheFilePath, GENERIC_READ, FILE_SHARE_READ, NULL,
+                               OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) {
+        DWORD error = GetLastError();
+        if (error != ERROR_FILE_NOT_FOUND && error != ERROR_PATH_NOT_FOUND) {
+            *found = TRUE;
+            ThreadSafeDebugOutputF(L"YouTubeCacher: LoadCacheIndexFile - ERROR: Cannot open index (error %lu)", error);
+        }
+        return FALSE;
+    }
+
+    *found = TRUE;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart < (LONGLONG)CACHE_INDEX_HEADER_V4_SIZE ||
+        fileSize.QuadPart > CACHE_INDEX_MAX_FILE_SIZE) {
+        ThreadSafeDebugOutput(L"YouTubeCacher: LoadCacheIndexFile - ERROR: Index file has an invalid size");
+        CloseHandle(hFile);
+        return FALSE;
+    }
+
+    // The view keeps the mapping and file alive, so both handles can be closed right away
+    HANDLE hMapping = CreateFileMappingW(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(hFile);
+    if (!hMapping) {
+        ThreadSafeDebugOutputF(L"YouTubeCacher: LoadCacheIndexFile - ERROR: CreateFileMappingW failed (error %lu)", GetLastError());
+        return FALSE;
+    }
+
+    const BYTE* view = (const BYTE*)MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(hMapping);
+    if (!view) {
+        ThreadSafeDebugOutputF(L"YouTubeCacher: LoadCacheIndexFile - ERROR: MapViewOfFile failed (error %lu)", GetLastError());
+        return FALSE;
+    }
+
+    CacheIndexReader reader;
+    if (!OpenCacheIndexImage(view, (size_t)fileSize.QuadPart, &reader)) {
+        ThreadSafeDebugOutput(L"YouTubeCacher: LoadCacheIndexFile - ERROR: Index header or tables are invalid");
+        UnmapViewOfFile((LPCVOID)view);
+        return FALSE;
+    }
+
+    DWORD recordCount = GetCacheIndexEntryCount(&reader);
+    int validEntries = 0;
+    int invalidEntries = 0;
+
+    EnterCriticalSection(&manager->lock);
+
+    // Size the lookup table once instead of rehashing as entries stream in
+    ReserveCacheHashTable(&manager->lookup, (DWORD)manager->totalEntries + recordCount);
+    ReserveCacheColumns(&manager->columns, (DWORD)manager->totalEntries + recordCount);
+
+    // Append in file order so the list order survives a save/load cycle
+    CacheEntry* tail = manager->entries;
+    while (tail && tail->next) {
+        tail = tail->next;
+    }
+
+    for (DWORD i = 0; i < recordCount; i++) {
+        CacheIndexRecord record;
+        CacheEntry* entry = NULL;
+        if (ReadCacheIndexRecord(&reader, i, &record)) {
+            entry = CreateCacheEntryFromIndexRecord(&reader, &record, NULL);
+        }
+        if (!entry) {
+            invalidEntries++;
+            continue;
+        }
+
+        if (!LinkCacheEntry(manager, entry, tail)) {
+            FreeCacheEntry(entry); // Duplicate video ID
+            invalidEntries++;
+            continue;
+        }
+        tail = entry;
+        validEntries++;
+    }
+
+    manager->indexView = view;
+    manager->indexGeneration = GetCacheIndexGeneration(&reader);
+
+    LeaveCacheLock(manager);
+
+    ThreadSafeDebugOutputF(L"YouTubeCacher: LoadCacheIndexFile - COMPLETE: Mapped %d valid entries, %d invalid entries", validEntries, invalidEntries);
+
+    return TRUE;
+}
+
+// Apply one journal record to the in-memory cache (caller holds the lock).
+// PUT strings are copied into the replay's arena.
+static BOOL ApplyCacheJournalRecord(CacheManager* manager, const CacheJournalRecord* record, StringArena* arena) {
+    if (record->type == CACHE_JOURNAL_REMOVE) {
+        const wchar_t* videoId = GetCacheJournalRemoveId(record);
+        if (!videoId) return FALSE;
+
+        CacheEntry* existing = FindCacheEntry(manager, videoId);
+        if (existing) {
+            UnlinkCacheEntry(manager, existing);
+            FreeCacheEntry(existing);
+        }
+        return TRUE;
+    }
+
+    // PUT: the payload is a one-entry index image; copy it since the journal buffer is temporary
+    CacheIndexReader reader;
+    CacheIndexRecord indexRecord;
+    if (!OpenCacheIndexImage(record->payload, record->payloadSize, &reader) ||
+        !ReadCacheIndexRecord(&reader, 0, &indexRecord)) {
+        return FALSE;
+    }
+
+    CacheEntry* entry = CreateCacheEntryFromIndexRecord(&reader, &indexRecord, arena);
+    if (!entry) return FALSE;
+
+    CacheEntry* existing = FindCacheEntry(manager, entry->videoId);
+    if (existing) {
+        // Update in place so list position and the lookup slot stay valid
+        ReleaseCacheEntryStrings(existing);
+        existing->videoId = entry->videoId;
+        existing->title = entry->title;
+        existing->duration = entry->duration;
+        existing->mainVideoFile = entry->mainVideoFile;
+        existing->subtitleFiles = entry->subtitleFiles;
+        existing->subtitleCount = entry->subtitleCount;
+        existing->downloadTime = entry->downloadTime;
+        existing->fileSize = entry->fileSize;
+        existing->lastAccessTime = entry->lastAccessTime;
+        existing->accessCount = entry->accessCount;
+        existing->hashWriteTime = entry->hashWriteTime;
+        existing->sampleHash = entry->sampleHash;
+        existing->contentHash = entry->contentHash;
+        existing->verifyTime = entry->verifyTime;
+        existing->damaged = entry->damaged;
+        existing->fileMissing = entry->fileMissing;
+        existing->borrowedStrings = entry->borrowedStrings;
+        existing->stringArena = entry->stringArena; // Reference moves with the strings
+        SAFE_FREE(entry);
+        RefreshCacheEntryKeys(manager, existing);
+        UpdateCacheSearchDocument(&manager->search, existing);
+        NotifyCacheChange(manager, existing->videoId, CACHE_CHANGE_METADATA | CACHE_CHANGE_SIZE);
+    } else if (!LinkCacheEntry(manager, entry, NULL)) {
+        FreeCacheEntry(entry);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+// Replay the journal on top of the loaded index. A torn tail (crash mid-append)
+// is cut off so later appends continue from the last complete record. With
+// matchIndex set, a journal that follows another index generation is stale -
+// left behind by a crash between an index rewrite and the journal delete - and
+// is deleted instead of replayed.
+static void ReplayCacheJournal(CacheManager* manager, BOOL matchIndex) {
+    manager->journalRecords = 0;
+    manager->journalBytes = 0;
+
+    HANDLE hFile = CreateFileW(manager->journalFilePath, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL,
+                               OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) {
+        return; // No journal - the index is complete
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(hFile, &fileSize) || fileSize.QuadPart == 0 || fileSize.QuadPart > CACHE_INDEX_MAX_FILE_SIZE) {
+        CloseHandle(hFile);
+        return;
+    }
+
+    DWORD journalSize = (DWORD)fileSize.QuadPart;
+    BYTE* journalData = (BYTE*)SAFE_MALLOC(journalSize);
+    StringArena* arena = CreateStringArena(STRING_ARENA_DEFAULT_BLOCK_SIZE);
+    if (!journalData || !arena) {
+        ThreadSafeDebugOutput(L"YouTubeCacher: ReplayCacheJournal - ERROR: Cannot allocate journal buffer");
+        if (journalData) SAFE_FREE(journalData);
+        ReleaseStringArena(arena);
+        CloseHandle(hFile);
+        return;
+    }
+
+    DWORD totalBytesRead = 0;
+    while (totalBytesRead < journalSize) {
+        DWORD bytesRead = 0;
+        if (!ReadFile(hFile, journalData + totalBytesRead, journalSize - totalBytesRead, &bytesRead, NULL) || bytesRead == 0) {
+            break;
+        }
+        totalBytesRead += bytesRead;
+    }
+
+    size_t offset = 0;
+    ULONGLONG generation = 0;
+    BOOL stale = !ReadCacheJournalFileHeader(journalData, totalBytesRead, &offset, &generation);
+    if (!stale && matchIndex && generation != manager->indexGeneration) {
+        ThreadSafeDebugOutputF(L"YouTubeCacher: ReplayCacheJournal - Discarding journal for generation %llu, index is generation %llu",
+                generation, manager->indexGeneration);
+        stale = TRUE;
+    }
+    if (stale) {
+        ReleaseStringArena(arena);
+        SAFE_FREE(journalData);
+        CloseHandle(hFile);
+        DeleteFileW(manager->journalFilePath);
+        return;
+    }
+
+    int applied = 0;
+    int skipped = 0;
+    CacheJournalRecord record;
+
+    EnterCriticalSection(&manager->lock);
+    if (!matchIndex) {
+        // No index to match; the next one has to be numbered past this journal
+        manager->indexGeneration = generation;
+    }
+    while (ReadCacheJournalRecord(journalData, totalBytesRead, &offset, &record)) {
+        if (ApplyCacheJournalRecord(manager, &record, arena)) {
+            applied++;
+        } else {
+            skipped++;
+        }
+    }
+    manager->journalRecords = (DWORD)(applied + skipped);
+    manager->journalBytes = offset;
+    LeaveCacheLock(manager);
+
+    ReleaseStringArena(arena);
+    SAFE_FREE(journalData);
+
+    if (offset < (size_t)fileSize.QuadPart) {
+        ThreadSafeDebugOutputF(L"YouTubeCacher: ReplayCacheJournal - Truncating torn journal tail at %zu of %lld bytes",
+                offset, fileSize.QuadPart);
+        LARGE_INTEGER truncateAt;
+        truncateAt.QuadPart = (LONGLONG)offset;
+        if (SetFilePointerEx(hFile, truncateAt, NULL, FILE_BEGIN)) {
+            SetEndOfFile(hFile);
+        }
+    }
+    CloseHandle(hFile);
+
+    ThreadSafeDebugOutputF(L"YouTubeCacher: ReplayCacheJournal - Applied %d records, skipped %d", applied, skipped);
+}
+
+// Load the cache index, migrating the legacy text index on first run
+BOOL LoadCacheFromFile(CacheManager* manager) {
+    if (!manager) return FALSE;
+
+    ThreadSafeDebugOutput(L"YouTubeCacher: LoadCacheFromFile - ENTRY");
+
+    BOOL indexFound = FALSE;
+    if (LoadCacheIndexFile(manager, &indexFound)) {
+        ReplayCacheJournal(manager, TRUE);
+        return TRUE;
+    }
+
+    if (indexFound) {
+        ThreadSafeDebugOutput(L"YouTubeCacher: LoadCacheFromFile - WARNING: Binary index unusable, trying legacy text index");
+    }
+
+    if (GetFileAttributesW(manager->legacyFilePath) == INVALID_FILE_ATTRIBUTES) {
+        // The journal alone still describes everything added since the index was lost
+        ThreadSafeDebugOutput(L"YouTubeCacher: LoadCacheFromFile - No cache index found, replaying journal only");
+        ReplayCacheJournal(manager, FALSE);
+        return TRUE; // Not an error - just no cache file yet
+    }
+
+    if (!LoadLegacyCacheFile(manager)) {
+        return FALSE;
+    }
+    ReplayCacheJournal(manager, FALSE);
+
+    // One-time migration: write the binary index, then retire the text file so it is not read again
+    if (SaveCacheToFileInternal(manager)) {
+        wchar_t migratedPath[MAX_EXTENDED_PATH];
+        swprintf(migratedPath, MAX_EXTENDED_PATH, L"%ls%ls", manager->legacyFilePath, CACHE_FILE_MIGRATED_SUFFIX);
+        if (MoveFileExW(manager->legacyFilePath, migratedPath, MOVEFILE_REPLACE_EXISTING)) {
+            ThreadSafeDebugOutput(L"YouTubeCacher: LoadCacheFromFile - Migrated legacy text index to binary index");
+        } else {
+            ThreadSafeDebugOutputF(L"YouTubeCacher: LoadCacheFromFile - WARNING: Could not rename legacy index (error %lu)", GetLastError());
+        }
+    } else {
+        ThreadSafeDebugOutput(L"YouTubeCacher: LoadCacheFromFile - WARNING: Migration failed, legacy index kept");
+    }
+
+    return TRUE;
+}
+
+// Internal function to perform synchronous cache saving (journal compaction).
+// Entries are serialized to memory under the lock; file I/O happens outside it,
+// and the new index replaces the old one atomically via a temporary file.
+// Once the new index is in place the journal it supersedes is deleted.
+// The new index takes the next generation, so the old journal no longer
+// matches it even if the delete never happens.
+static BOOL SaveCacheToFileInternal(CacheManager* manager) {
+    ThreadSafeDebugOutput(L"YouTubeCacher: SaveCacheToFileInternal - ENTRY");
+    
+    if (!manager) {
+        ThreadSafeDebugOutput(L"YouTubeCacher: SaveCacheToFileInternal - ERROR: NULL manager");
+        return FALSE;
+    }
+    
+    ThreadSafeDebugOutputF(L"YouTubeCacher: SaveCacheToFileInternal - Attempting to save to: %ls", manager->cacheFilePath);
+    
+    // Step 1: Collect valid entries and build the index image while holding the lock
+    CacheIndexImage image = {0};
+    CacheEntry** validEntries = NULL;
+    DWORD validCount = 0;
+    int entryCount = 0;
+    
+    EnterCriticalSection(&manager->lock);
+    
+    if (manager->totalEntries > 0) {
+        validEntries = (CacheEntry**)SAFE_MALLOC(manager->totalEntries * sizeof(CacheEntry*));
+        if (!validEntries) {
+            LeaveCacheLock(manager);
+            ThreadSafeDebugOutput(L"YouTubeCacher: SaveCacheToFileInternal - ERROR: Cannot allocate entry array");
+            return FALSE;
+        }
+    }
+    
+    CacheEntry* current = manager->entries;
+    while (current && entryCount < manager->totalEntries) {
+        entryCount++;
+        // Only fields are checked: a stat per entry here would keep every reader
+        // waiting on the disk. Whether the file still exists is the reconcile's call.
+        if (current->videoId && current->mainVideoFile) {
+            validEntries[validCount++] = current;
+        } else {
+            ThreadSafeDebugOutputF(L"YouTubeCacher: SaveCacheToFileInternal - Skipping invalid entry %d: %ls",
+                    entryCount, current->videoId ? current->videoId : L"NULL");
+        }
+        current = current->next;
+    }
+    
+    ULONGLONG generation = manager->indexGeneration + 1;
+    BOOL imageBuilt = BuildCacheIndexImage(validEntries, validCount, generation, &image);
+    
+#ifndef NDEBUG
+    // Every entry was just walked anyway
+    CheckCacheStats(manager);
+#endif
+    if (imageBuilt) {
+        // Queued records are all reflected in the image; a failure below sets the flag again
+        ResetCacheJournalBuffer(&manager->pendingJournal);
+        manager->bSnapshotRequired = FALSE;
+    }
+    
+    LeaveCacheLock(manager);
+    
+    if (validEntries) SAFE_FREE(validEntries);
+    
+    if (!imageBuilt) {
+        ThreadSafeDebugOutput(L"YouTubeCacher: SaveCacheToFileInternal - ERROR: Failed to build index image");
+        return FALSE;
+    }
+    
+    // Step 2: Write the image to a temporary file
+    wchar_t tempPath[MAX_EXTENDED_PATH];
+    swprintf(tempPath, MAX_EXTENDED_PATH, L"%ls.tmp", manager->cacheFilePath);
+    
+    HANDLE hFile = CreateFileW(tempPath, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) {
+        DWORD error = GetLastError();
+        
+        // Use enhanced error handling with better context information
+        ErrorContext* ctx = CREATE_ERROR_CONTEXT(YTC_ERROR_FILE_ACCESS, YTC_SEVERITY_ERROR);
+        if (ctx) {
+            AddContextVariable(ctx, L"FilePath", tempPath);
+            AddContextVariable(ctx, L"Operation", L"Open cache file for writing");
+            wchar_t errorCodeStr[32];
+            swprintf(errorCodeStr, 32, L"%lu", error);
+            AddContextVariable(ctx, L"SystemError", errorCodeStr);
+            
+            if (error == ERROR_ACCESS_DENIED) {
+                SetUserFriendlyMessage(ctx, L"Cannot save cache file due to insufficient permissions.\r\nPlease check folder permissions or run as administrator.");
+            } else if (error == ERROR_DISK_FULL) {
+                SetUserFriendlyMessage(ctx, L"Cannot save cache file because the disk is full.\r\nPlease free up disk space and try again.");
+            } else if (error == ERROR_PATH_NOT_FOUND) {
+                SetUserFriendlyMessage(ctx, L"Cannot save cache file because the folder path does not exist.\r\nPlease check that the download folder is accessible.");
+            } else {
+                SetUserFriendlyMessage(ctx, L"Unable to save cache file due to a system error.\r\nThe storage device may have issues or be write-protected.");
+            }
+            FreeErrorContext(ctx);
         }
         ThreadSafeDebugOutputF(L"YouTubeCacher: SaveCacheToFileInternal - ERROR: Failed to open file for writing (error %lu): %ls",
-                error, manager->cacheFilePath);
+                error, tempPath);
+        FreeCacheIndexImage(&image);
+        manager->bSnapshotRequired = TRUE;
+        return FALSE;
+    }
+    
+    size_t totalWritten = 0;
+    BOOL writeSucceeded = TRUE;
+    while (totalWritten < image.size) {
+        DWORD chunkSize = (DWORD)min(image.size - totalWritten, (size_t)(1024 * 1024));
+        DWORD bytesWritten = 0;
+        if (!WriteFile(hFile, image.data + totalWritten, chunkSize, &bytesWritten, NULL) || bytesWritten == 0) {
+            writeSucceeded = FALSE;
+            break;
+        }
+        totalWritten += bytesWritten;
+    }
+    
+    // Explicitly flush to ensure data is written to disk
+    if (writeSucceeded && !FlushFileBuffers(hFile)) {
+        writeSucceeded = FALSE;
+    }
+    CloseHandle(hFile);
+    FreeCacheIndexImage(&image);
+    
+    if (!writeSucceeded) {
+        ThreadSafeDebugOutputF(L"YouTubeCacher: SaveCacheToFileInternal - ERROR: Failed to write index (error %lu)", GetLastError());
+        DeleteFileW(tempPath);
+        manager->bSnapshotRequired = TRUE;
+        return FALSE;
+    }
+    
+    // Step 3: Drop the mapping of the old index and swap the new file into place
+    if (!ReleaseCacheIndexView(manager)) {
+        DeleteFileW(tempPath);
+        manager->bSnapshotRequired = TRUE;
         return FALSE;
     }
     
-    ThreadSafeDebugOutput(L"YouTubeCacher: SaveCacheToFileInternal - File opened for writing");
+    if (!MoveFileExW(tempPath, manager->cacheFilePath, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        ThreadSafeDebugOutputF(L"YouTubeCacher: SaveCacheToFileInternal - ERROR: Failed to replace index (error %lu)", GetLastError());
+        DeleteFileW(tempPath);
+        manager->bSnapshotRequired = TRUE;
+        return FALSE;
+    }
+    
+    // Step 4: The journal is folded into the new index. Should this delete not
+    // happen, the journal still names the old generation and the next load
+    // discards it rather than replaying stale records over the new index.
+    manager->indexGeneration = generation;
+    DeleteFileW(manager->journalFilePath);
+    manager->journalRecords = 0;
+    manager->journalBytes = 0;
+    
+    ThreadSafeDebugOutputF(L"YouTubeCacher: SaveCacheToFileInternal - COMPLETE: Wrote %lu entries to file", validCount);
     
-    // Write version header
-    fwprintf(file, L"CACHE_VERSION=%ls\n", CACHE_VERSION);
+    return TRUE;
+}
+
+// Write all of data at the current file position
+static BOOL WriteCacheJournalBytes(HANDLE hFile, const BYTE* data, size_t size) {
+    size_t totalWritten = 0;
+    while (totalWritten < size) {
+        DWORD chunkSize = (DWORD)min(size - totalWritten, (size_t)(1024 * 1024));
+        DWORD bytesWritten = 0;
+        if (!WriteFile(hFile, data + totalWritten, chunkSize, &bytesWritten, NULL) || bytesWritten == 0) {
+            return FALSE;
+        }
+        totalWritten += bytesWritten;
+    }
+    return TRUE;
+}
+
+// Append a batch of encoded records to the journal with a single write and flush.
+// Writing starts at the last known good size, so a previously torn append is overwritten.
+// A new journal starts with a file header naming the index generation it follows.
+static BOOL AppendCacheJournalFile(CacheManager* manager, const BYTE* data, size_t size) {
+    HANDLE hFile = CreateFileW(manager->journalFilePath, GENERIC_WRITE, 0, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) {
+        ThreadSafeDebugOutputF(L"YouTubeCacher: AppendCacheJournalFile - ERROR: Cannot open journal (error %lu)", GetLastError());
+        return FALSE;
+    }
+
+    LARGE_INTEGER position;
+    position.QuadPart = (LONGLONG)manager->journalBytes;
+    BOOL writeSucceeded = SetFilePointerEx(hFile, position, NULL, FILE_BEGIN);
+
+    ULONGLONG end = manager->journalBytes + size;
+    if (writeSucceeded && manager->journalBytes == 0) {
+        CacheJournalFileHeader header;
+        InitCacheJournalFileHeader(&header, manager->indexGeneration);
+        writeSucceeded = WriteCacheJournalBytes(hFile, (const BYTE*)&header, sizeof(header));
+        end += sizeof(header);
+    }
+    if (writeSucceeded) {
+        writeSucceeded = WriteCacheJournalBytes(hFile, data, size);
+    }
+
+    if (writeSucceeded) {
+        writeSucceeded = SetEndOfFile(hFile) && FlushFileBuffers(hFile);
+    }
+
+    if (!writeSucceeded) {
+        ThreadSafeDebugOutputF(L"YouTubeCacher: AppendCacheJournalFile - ERROR: Failed to append journal (error %lu)", GetLastError());
+        // Cut off whatever part of the batch made it to disk
+        if (SetFilePointerEx(hFile, position, NULL, FILE_BEGIN)) {
+            SetEndOfFile(hFile);
+        }
+    } else {
+        manager->journalBytes = end;
+    }
+
+    CloseHandle(hFile);
+    return writeSucceeded;
+}
+
+// Group commit: everything queued since the last commit is appended with one write
+// and one flush. The index is rewritten instead once the journal outgrows the cache,
+// which keeps the total bytes written linear in the number of mutations.
+static BOOL CommitCacheChanges(CacheManager* manager) {
+    if (!manager) return FALSE;
+
+    EnterCriticalSection(&manager->lock);
+
+    DWORD compactRecords = max((DWORD)CACHE_JOURNAL_MIN_COMPACT_RECORDS, (DWORD)manager->totalEntries);
+    BOOL compact = manager->bSnapshotRequired ||
+                   manager->journalRecords + manager->pendingJournal.recordCount > compactRecords ||
+                   manager->journalBytes + manager->pendingJournal.size > CACHE_JOURNAL_MAX_BYTES;
+
+    // Take the queued records so new mutations can keep queuing during the write
+    CacheJournalBuffer batch = {0};
+    if (!compact) {
+        batch = manager->pendingJournal;
+        memset(&manager->pendingJournal, 0, sizeof(CacheJournalBuffer));
+    }
+
+    LeaveCacheLock(manager);
+
+    if (compact) {
+        ThreadSafeDebugOutput(L"YouTubeCacher: CommitCacheChanges - Compacting journal into index");
+        return SaveCacheToFileInternal(manager);
+    }
+
+    if (batch.size == 0) {
+        FreeCacheJournalBuffer(&batch);
+        return TRUE;
+    }
+
+    BOOL result = AppendCacheJournalFile(manager, batch.data, batch.size);
+    if (result) {
+        manager->journalRecords += batch.recordCount;
+        ThreadSafeDebugOutputF(L"YouTubeCacher: CommitCacheChanges - Appended %lu records to journal", batch.recordCount);
+    } else {
+        // The batch is lost from the journal but still in memory, so a full rewrite recovers it
+        result = SaveCacheToFileInternal(manager);
+    }
+
+    FreeCacheJournalBuffer(&batch);
+    return result;
+}
+
+// Background thread function for asynchronous cache saving
+static DWORD WINAPI CacheSaveWorkerThread(LPVOID lpParam) {
+    CacheManager* manager = (CacheManager*)lpParam;
+    if (!manager) return 1;
+
+    ThreadSafeDebugOutput(L"YouTubeCacher: CacheSaveWorkerThread - Started");
+
+    while (!manager->bShuttingDown) {
+        // Wait for a save request or shutdown
+        DWORD waitResult = WaitForSingleObject(manager->hSaveEvent, INFINITE);
+
+        if (manager->bShuttingDown) break;
+
+        if (waitResult == WAIT_OBJECT_0) {
+            // Debounce: wait a short period to batch multiple rapid changes
+            Sleep(500);
+
+            if (manager->bShuttingDown) break;
+
+            if (manager->bDirty) {
+                // Clear dirty flag before saving so we can detect changes made DURING save
+                manager->bDirty = FALSE;
+                CommitCacheChanges(manager);
+            }
+        }
+    }
+
+    ThreadSafeDebugOutput(L"YouTubeCacher: CacheSaveWorkerThread - Exiting");
+    return 0;
+}
+
+// Asynchronous cache saving - signals the background thread
+BOOL SaveCacheToFile(CacheManager* manager) {
+    if (!manager) return FALSE;
+
+    manager->bDirty = TRUE;
+    if (manager->hSaveEvent) {
+        SetEvent(manager->hSaveEvent);
+        return TRUE;
+    }
+
+    // Fallback to synchronous save if background thread isn't initialized
+    return CommitCacheChanges(manager);
+}
+
+// Synchronous cache saving wrapper (commits queued journal records, compacting when due)
+BOOL SaveCacheToFileSync(CacheManager* manager) {
+    return CommitCacheChanges(manager);
+}
+
+// Queue journal records for the next commit (caller holds the lock). If a record
+// cannot be encoded, the next commit rewrites the whole index instead.
+static void QueueCacheJournalPut(CacheManager* manager, CacheEntry* entry) {
+    if (!AppendCacheJournalPut(&manager->pendingJournal, entry)) {
+        manager->bSnapshotRequired = TRUE;
+    }
+}
+
+static void QueueCacheJournalRemove(CacheManager* manager, const wchar_t* videoId) {
+    if (!AppendCacheJournalRemove(&manager->pendingJournal, videoId)) {
+        manager->bSnapshotRequired = TRUE;
+    }
+}
+
+// Current time as FILETIME ticks, the unit of the access stats
+static ULONGLONG GetCacheAccessTime(void) {
+    FILETIME now;
+    GetSystemTimeAsFileTime(&now);
+    return ((ULONGLONG)now.dwHighDateTime << 32) | now.dwLowDateTime;
+}
+
+// Count a play or download toward the eviction policy (caller holds the lock)
+static void RecordCacheEntryAccess(CacheManager* manager, CacheEntry* entry) {
+    entry->lastAccessTime = GetCacheAccessTime();
+    entry->accessCount++;
+    QueueCacheJournalPut(manager, entry);
+}
+
+// Let the eviction thread check the budget again
+static void WakeCacheEviction(CacheManager* manager) {
+    if (manager->hEvictEvent) {
+        SetEvent(manager->hEvictEvent);
+    }
+}
+
+// Let the integrity check thread look for due entries again
+static void WakeCacheVerifier(CacheManager* manager) {
+    if (manager->hVerifyEvent) {
+        SetEvent(manager->hVerifyEvent);
+    }
+}
+
+// Add a new cache entry
+BOOL AddCacheEntry(CacheManager* manager, const wchar_t* videoId, const wchar_t* title, 
+                   const wchar_t* duration, const wchar_t* mainVideoFile, 
+                   wchar_t** subtitleFiles, int subtitleCount) {
+    if (!manager || !videoId || !mainVideoFile) return FALSE;
+    
+    // Debug logging
+    ThreadSafeDebugOutput(L"YouTubeCacher: AddCacheEntry - Starting");
+    if (title) {
+        ThreadSafeDebugOutputF(L"YouTubeCacher: AddCacheEntry - Title: %ls (length: %zu)", title, wcslen(title));
+    }
+    
+    EnterCriticalSection(&manager->lock);
+    
+    // Check if entry already exists
+    CacheEntry* existing = FindCacheEntry(manager, videoId);
+    if (existing) {
+        LeaveCacheLock(manager);
+        return FALSE; // Already exists
+    }
+    
+    // Create new entry
+    CacheEntry* entry = (CacheEntry*)SAFE_MALLOC(sizeof(CacheEntry));
+    if (!entry) {
+        LeaveCacheLock(manager);
+        return FALSE;
+    }
+    
+    memset(entry, 0, sizeof(CacheEntry));
+    
+    entry->videoId = SAFE_WCSDUP(videoId);
+    entry->title = title ? SAFE_WCSDUP(title) : NULL;
+    entry->duration = duration ? SAFE_WCSDUP(duration) : NULL;
+    entry->mainVideoFile = SAFE_WCSDUP(mainVideoFile);
+    entry->subtitleCount = subtitleCount;
+    
+    // Copy subtitle files
+    if (subtitleCount > 0 && subtitleFiles) {
+        entry->subtitleFiles = (wchar_t**)SAFE_MALLOC(subtitleCount * sizeof(wchar_t*));
+        if (entry->subtitleFiles) {
+            for (int i = 0; i < subtitleCount; i++) {
+                entry->subtitleFiles[i] = subtitleFiles[i] ? SAFE_WCSDUP(subtitleFiles[i]) : NULL;
+            }
+        }
+    }
+    
+    // Get file info
+    GetVideoFileInfo(mainVideoFile, &entry->fileSize, &entry->downloadTime);
+    
+    // Add to linked list and lookup table
+    if (!LinkCacheEntry(manager, entry, NULL)) {
+        LeaveCacheLock(manager);
+        FreeCacheEntry(entry);
+        return FALSE;
+    }
+    
+    // The download is the first access; this also journals the new entry
+    RecordCacheEntryAccess(manager, entry);
+    
+    LeaveCacheLock(manager);
+    
+    WakeCacheEviction(manager);
+    
+    // A new download is checksummed before anything else is checked
+    WakeCacheVerifier(manager);
+    
+    ThreadSafeDebugOutput(L"YouTubeCacher: AddCacheEntry - Entry added to memory, saving to file");
+    
+    // Save to file
+    BOOL saveResult = SaveCacheToFile(manager);
+    
+    if (saveResult) {
+        ThreadSafeDebugOutput(L"YouTubeCacher: AddCacheEntry - Successfully saved to file");
+    } else {
+        ThreadSafeDebugOutput(L"YouTubeCacher: AddCacheEntry - ERROR: Failed to save to file");
+    }
+    
+    return TRUE;
+}
+
+// Remove a cache entry
+BOOL RemoveCacheEntry(CacheManager* manager, const wchar_t* videoId) {
+    if (!manager || !videoId) return FALSE;
+    
+    EnterCriticalSection(&manager->lock);
+    
+    CacheEntry* current = FindCacheEntry(manager, videoId);
+    if (!current) {
+        LeaveCacheLock(manager);
+        return FALSE;
+    }
+    
+    // Remove from linked list and lookup table
+    UnlinkCacheEntry(manager, current);
+    QueueCacheJournalRemove(manager, videoId);
+    FreeCacheEntry(current);
+    
+    LeaveCacheLock(manager);
+    
+    // Save updated cache
+    SaveCacheToFile(manager);
+    return TRUE;
+}
+
+// Find a cache entry by video ID
+CacheEntry* FindCacheEntry(CacheManager* manager, const wchar_t* videoId) {
+    if (!manager || !videoId) return NULL;
+    
+    return CacheHashTableFind(&manager->lookup, videoId);
+}
+
+// Whether the entry's video file failed its last integrity check
+BOOL IsCacheEntryDamaged(CacheManager* manager, const wchar_t* videoId) {
+    if (!manager || !videoId) return FALSE;
+    
+    CacheViewSnapshot* snapshot = AcquireCacheSnapshot(manager);
+    const CacheViewRow* row = FindCacheViewRow(snapshot, videoId);
+    BOOL damaged = row && row->damaged;
+    ReleaseCacheViewSnapshot(snapshot);
+    return damaged;
+}
+
+// One entry whose files are being deleted. The entry stays in the cache, marked
+// deletePending, and may change meanwhile, so the paths are copies.
+typedef struct {
+    CacheEntry* entry;          // Only compared, never followed outside the lock
+    const wchar_t* videoId;
+    const wchar_t* mainVideoFile;
+    const wchar_t** subtitleFiles;
+    int subtitleCount;
+    BOOL done;                  // Its files were tried
+    int failed;                 // Files that could not be deleted
+} CacheDeleteItem;
+
+// Deletion state shared by the threads of one batch
+typedef struct {
+    CacheManager* manager;
+    CacheDeleteItem* items;
+    LONG count;
+    volatile LONG next;         // First item not yet claimed by a thread
+    FileDeleteError* errors;    // Room for every file of every item
+    volatile LONG errorCount;
+    volatile LONG successfulDeletes;
+} CacheDeleteBatch;
+
+// Copy the paths of an entry's files into a batch item (caller holds the lock)
+static BOOL CopyCacheDeleteItem(CacheDeleteItem* item, CacheEntry* entry, StringArena* arena) {
+    memset(item, 0, sizeof(CacheDeleteItem));
+    item->entry = entry;
+    item->videoId = StringArenaWcsDup(arena, entry->videoId);
+    if (!item->videoId) return FALSE;
+    
+    if (entry->mainVideoFile) {
+        item->mainVideoFile = StringArenaWcsDup(arena, entry->mainVideoFile);
+        if (!item->mainVideoFile) return FALSE;
+    }
+    if (entry->subtitleFiles && entry->subtitleCount > 0) {
+        item->subtitleFiles = (const wchar_t**)StringArenaAlloc(arena, entry->subtitleCount * sizeof(wchar_t*));
+        if (!item->subtitleFiles) return FALSE;
+        for (int i = 0; i < entry->subtitleCount; i++) {
+            item->subtitleFiles[i] = StringArenaWcsDup(arena, entry->subtitleFiles[i]);
+            if (entry->subtitleFiles[i] && !item->subtitleFiles[i]) return FALSE;
+        }
+        item->subtitleCount = entry->subtitleCount;
+    }
+    return TRUE;
+}
+
+// Delete one file of a batch, recording a failure in the batch's error list
+static BOOL DeleteCacheBatchFile(CacheDeleteBatch* batch, const wchar_t* filePath) {
+    if (DeleteFileW(filePath)) {
+        InterlockedIncrement(&batch->successfulDeletes);
+        return TRUE;
+    }
+    
+    DWORD error = GetLastError();
+    LONG slot = InterlockedIncrement(&batch->errorCount) - 1;
+    batch->errors[slot].fileName = SAFE_WCSDUP(filePath);
+    batch->errors[slot].errorCode = error;
+    return FALSE;
+}
+
+// Deletion thread: claim entries and delete their files
+static DWORD WINAPI CacheDeleteWorker(LPVOID param) {
+    CacheDeleteBatch* batch = (CacheDeleteBatch*)param;
+    
+    while (!batch->manager->bShuttingDown) {
+        LONG index = InterlockedIncrement(&batch->next) - 1;
+        if (index >= batch->count) break;
+        
+        CacheDeleteItem* item = &batch->items[index];
+        if (item->mainVideoFile && !DeleteCacheBatchFile(batch, item->mainVideoFile)) {
+            item->failed++;
+        }
+        for (int i = 0; i < item->subtitleCount; i++) {
+            if (item->subtitleFiles[i] && !DeleteCacheBatchFile(batch, item->subtitleFiles[i])) {
+                item->failed++;
+            }
+        }
+        item->done = TRUE;
+    }
+    return 0;
+}
+
+// Write one log message for a batch: the totals and every file that could not be deleted
+static void LogCacheDeleteBatch(const DeleteResult* result) {
+    size_t bufferSize = 256;
+    for (int i = 0; i < result->errorCount; i++) {
+        bufferSize += (result->errors[i].fileName ? wcslen(result->errors[i].fileName) : 0) + 64;
+    }
+    
+    wchar_t* logMsg = (wchar_t*)SAFE_MALLOC(bufferSize * sizeof(wchar_t));
+    if (!logMsg) return;
+    
+    size_t used = (size_t)swprintf(logMsg, bufferSize, L"Deleted %d of %d files of %d videos, removed %d cache entries\r\n",
+                                   result->successfulDeletes, result->totalFiles, result->entryCount, result->removedEntries);
+    for (int i = 0; i < result->errorCount; i++) {
+        used += (size_t)swprintf(logMsg + used, bufferSize - used, L"Failed to delete file: %ls (Error: %lu)\r\n",
+                                 result->errors[i].fileName ? result->errors[i].fileName : L"(unknown)",
+                                 result->errors[i].errorCode);
+    }
+    WriteToLogfile(logMsg);
+    SAFE_FREE(logMsg);
+}
+
+// Delete the files of many entries and remove the entries whose files are all
+// gone. The entries are marked under one lock, their files are deleted in
+// parallel outside it, and only then are the finished ones unlinked, so an
+// entry with files left over never leaves the cache or its place in the list.
+// The index is saved once. Returns one result for the whole batch (IDs not in
+// the cache are skipped), or NULL if it could not be started.
+DeleteResult* DeleteCacheEntriesDetailed(CacheManager* manager, wchar_t* const* videoIds, int count) {
+    if (!manager || !videoIds || count <= 0) return NULL;
+    
+    DeleteResult* result = (DeleteResult*)SAFE_MALLOC(sizeof(DeleteResult));
+    CacheDeleteItem* items = (CacheDeleteItem*)SAFE_MALLOC(count * sizeof(CacheDeleteItem));
+    StringArena* arena = CreateStringArena(STRING_ARENA_DEFAULT_BLOCK_SIZE);
+    if (!result || !items || !arena) {
+        if (result) SAFE_FREE(result);
+        if (items) SAFE_FREE(items);
+        ReleaseStringArena(arena);
+        return NULL;
+    }
+    memset(result, 0, sizeof(DeleteResult));
+    
+    CacheDeleteBatch batch;
+    memset(&batch, 0, sizeof(batch));
+    batch.manager = manager;
+    batch.items = items;
+    
+    EnterCriticalSection(&manager->lock);
+    
+    for (int i = 0; i < count; i++) {
+        CacheEntry* entry = videoIds[i] ? FindCacheEntry(manager, videoIds[i]) : NULL;
+        // An entry another batch is deleting is left to it
+        if (!entry || entry->deletePending) continue;
+        
+        CacheDeleteItem* item = &items[batch.count];
+        if (!CopyCacheDeleteItem(item, entry, arena)) {
+            ThreadSafeDebugOutputF(L"YouTubeCacher: DeleteCacheEntriesDetailed - Cannot copy paths of %ls, not deleted", videoIds[i]);
+            continue;
+        }
+        entry->deletePending = TRUE;
+        batch.count++;
+        result->totalFiles += (item->mainVideoFile ? 1 : 0) + item->subtitleCount;
+    }
+    
+    LeaveCacheLock(manager);
+    
+    result->entryCount = (int)batch.count;
+    if (result->totalFiles > 0) {
+        batch.errors = (FileDeleteError*)SAFE_MALLOC(result->totalFiles * sizeof(FileDeleteError));
+        if (batch.errors) {
+            memset(batch.errors, 0, result->totalFiles * sizeof(FileDeleteError));
+        } else {
+            // Nothing is deleted; every entry stays below
+            batch.next = batch.count;
+        }
+    }
+    
+    // A few entries are deleted on this thread alone; more get helpers as well
+    DWORD helperCount = batch.errors ? (DWORD)(batch.count / CACHE_DELETE_ENTRIES_PER_WORKER) : 0;
+    if (helperCount > CACHE_STAT_DEFAULT_WORKERS - 1) helperCount = CACHE_STAT_DEFAULT_WORKERS - 1;
+    HANDLE helpers[CACHE_STAT_DEFAULT_WORKERS];
+    DWORD started = 0;
+    for (DWORD i = 0; i < helperCount; i++) {
+        helpers[started] = CreateThread(NULL, 0, CacheDeleteWorker, &batch, 0, NULL);
+        if (helpers[started]) started++;
+    }
+    CacheDeleteWorker(&batch);
+    if (started > 0) {
+        WaitForMultipleObjects(started, helpers, TRUE, INFINITE);
+        for (DWORD i = 0; i < started; i++) {
+            CloseHandle(helpers[i]);
+        }
+    }
+    
+    result->errors = batch.errors;
+    result->errorCount = (int)batch.errorCount;
+    result->successfulDeletes = (int)batch.successfulDeletes;
+    
+    // Entries whose files are all gone leave the cache; the rest just lose the mark
+    EnterCriticalSection(&manager->lock);
+    for (LONG i = 0; i < batch.count; i++) {
+        CacheDeleteItem* item = &items[i];
+        CacheEntry* entry = FindCacheEntry(manager, item->videoId);
+        // Removed, or removed and added again, while its files were deleted
+        if (entry != item->entry || !entry->deletePending) continue;
+        
+        entry->deletePending = FALSE;
+        // A reconcile may have pointed it at a file this batch never touched
+        BOOL sameFile = entry->mainVideoFile && item->mainVideoFile ?
+                        _wcsicmp(entry->mainVideoFile, item->mainVideoFile) == 0 :
+                        entry->mainVideoFile == item->mainVideoFile;
+        if (item->done && item->failed == 0 && sameFile) {
+            UnlinkCacheEntry(manager, entry);
+            QueueCacheJournalRemove(manager, item->videoId);
+            FreeCacheEntry(entry);
+            result->removedEntries++;
+        }
+    }
+    LeaveCacheLock(manager);
+    
+    SAFE_FREE(items);
+    ReleaseStringArena(arena);
+    
+    if (result->errorCount > 0) {
+        ErrorContext* ctx = CREATE_ERROR_CONTEXT(YTC_ERROR_FILE_ACCESS, YTC_SEVERITY_WARNING);
+        if (ctx) {
+            wchar_t failedStr[32];
+            swprintf(failedStr, 32, L"%d", result->errorCount);
+            AddContextVariable(ctx, L"Operation", L"Delete cached videos");
+            AddContextVariable(ctx, L"FailedFiles", failedStr);
+            AddContextVariable(ctx, L"FilePath", result->errors[0].fileName ? result->errors[0].fileName : L"");
+            SetUserFriendlyMessage(ctx, L"Some files could not be deleted.\r\nThey may be in use, read-only, or on a storage device with issues.");
+            FreeErrorContext(ctx);
+        }
+    }
+    if (result->entryCount > 0) {
+        LogCacheDeleteBatch(result);
+    }
+    
+    ThreadSafeDebugOutputF(L"YouTubeCacher: DeleteCacheEntriesDetailed - Removed %d of %d entries, %d of %d files failed, on %lu threads",
+                          result->removedEntries, result->entryCount, result->errorCount, result->totalFiles, started + 1);
+    
+    if (result->removedEntries > 0) {
+        SaveCacheToFile(manager);
+    }
+    return result;
+}
+
+// Delete all files associated with a cache entry with detailed error reporting.
+// Returns NULL if the entry is not in the cache.
+DeleteResult* DeleteCacheEntryFilesDetailed(CacheManager* manager, const wchar_t* videoId) {
+    if (!manager || !videoId) return NULL;
+    
+    wchar_t* videoIds[1];
+    videoIds[0] = (wchar_t*)videoId;
+    DeleteResult* result = DeleteCacheEntriesDetailed(manager, videoIds, 1);
+    if (result && result->entryCount == 0) {
+        FreeDeleteResult(result);
+        return NULL;
+    }
+    return result;
+}
+
+// Free delete result structure
+void FreeDeleteResult(DeleteResult* result) {
+    if (!result) return;
+    
+    if (result->errors) {
+        for (int i = 0; i < result->errorCount; i++) {
+            if (result->errors[i].fileName) {
+                SAFE_FREE(result->errors[i].fileName);
+            }
+        }
+        SAFE_FREE(result->errors);
+    }
+    
+    SAFE_FREE(result);
+}
+
+// Format delete error details for display
+wchar_t* FormatDeleteErrorDetails(const DeleteResult* result) {
+    if (!result) return NULL;
+    
+    // Calculate required buffer size
+    size_t bufferSize = 1024; // Base size for headers
+    for (int i = 0; i < result->errorCount; i++) {
+        if (result->errors[i].fileName) {
+            bufferSize += wcslen(result->errors[i].fileName) + 100; // File name + error info
+        }
+    }
+    
+    wchar_t* details = (wchar_t*)SAFE_MALLOC(bufferSize * sizeof(wchar_t));
+    if (!details) return NULL;
+    
+    // Format summary
+    swprintf(details, bufferSize, 
+        L"Delete Operation Summary:\n"
+        L"Total files: %d\n"
+        L"Successfully deleted: %d\n"
+        L"Failed to delete: %d\n\n",
+        result->totalFiles, result->successfulDeletes, result->errorCount);
+    
+    if (result->errorCount > 0) {
+        wcscat(details, L"Failed Files:\n");
+        wcscat(details, L"=============\n\n");
+        
+        for (int i = 0; i < result->errorCount; i++) {
+            wchar_t errorInfo[1024];
+            wchar_t* fileName = result->errors[i].fileName;
+            DWORD errorCode = result->errors[i].errorCode;
+            
+            // Get just the filename without full path for display
+            wchar_t* displayName = wcsrchr(fileName, L'\\');
+            if (displayName) {
+                displayName++; // Skip the backslash
+            } else {
+                displayName = fileName;
+            }
+            
+            // Format error message
+            wchar_t errorMessage[256] = L"Unknown error";
+            FormatMessageW(FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
+                          NULL, errorCode, MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT),
+                          errorMessage, 256, NULL);
+            
+            // Remove trailing newlines from error message
+            size_t len = wcslen(errorMessage);
+            while (len > 0 && (errorMessage[len-1] == L'\n' || errorMessage[len-1] == L'\r')) {
+                errorMessage[len-1] = L'\0';
+                len--;
+            }
+            
+            swprintf(errorInfo, 1024, 
+                L"File: %ls\n"
+                L"Error Code: %lu (0x%08lX)\n"
+                L"Error: %ls\n"
+                L"Full Path: %ls\n\n",
+                displayName, errorCode, errorCode, errorMessage, fileName);
+            
+            // Check if we have enough space
+            const wchar_t* truncationMessage = L"... (additional errors truncated)\n";
+            if (wcslen(details) + wcslen(errorInfo) < bufferSize) {
+                wcscat(details, errorInfo);
+            } else {
+                // Before truncating, ensure we have space for the truncation message
+                if (wcslen(details) + wcslen(truncationMessage) < bufferSize) {
+                    wcscat(details, truncationMessage);
+                }
+                break;
+            }
+        }
+    }
+    
+    return details;
+}
+
+// Play a cached video
+BOOL PlayCacheEntry(CacheManager* manager, const wchar_t* videoId, const wchar_t* playerPath) {
+    if (!manager || !videoId || !playerPath) return FALSE;
+    
+    // The path comes from the published snapshot, so the file checks below run without the lock
+    CacheViewSnapshot* snapshot = AcquireCacheSnapshot(manager);
+    const CacheViewRow* row = FindCacheViewRow(snapshot, videoId);
+    wchar_t* videoFile = row && row->mainVideoFile ? SAFE_WCSDUP(row->mainVideoFile) : NULL;
+    ReleaseCacheViewSnapshot(snapshot);
+    if (!videoFile) {
+        return FALSE;
+    }
+    
+    // Check if video file still exists with enhanced error handling
+    DWORD attributes = GetFileAttributesW(videoFile);
+    if (attributes == INVALID_FILE_ATTRIBUTES) {
+        DWORD error = GetLastError();
+        
+        // Report file access failure for playback
+        ErrorContext* ctx = CREATE_ERROR_CONTEXT(YTC_ERROR_FILE_NOT_FOUND, YTC_SEVERITY_ERROR);
+        if (ctx) {
+            AddContextVariable(ctx, L"FilePath", videoFile);
+            AddContextVariable(ctx, L"Operation", L"Check file for playback");
+            if (error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND) {
+                SetUserFriendlyMessage(ctx, L"The video file no longer exists at the expected location.\r\nIt may have been moved, deleted, or the storage device may be disconnected.");
+            } else if (error == ERROR_ACCESS_DENIED) {
+                SetUserFriendlyMessage(ctx, L"Cannot access the video file due to insufficient permissions.\r\nPlease check file permissions or run as administrator.");
+            } else {
+                SetUserFriendlyMessage(ctx, L"Unable to access the video file due to a system error.\r\nThe storage device may have issues or be disconnected.");
+            }
+            FreeErrorContext(ctx);
+        }
+        
+        SAFE_FREE(videoFile);
+        return FALSE;
+    }
+    
+    // Escape arguments to prevent command injection
+    wchar_t* escapedPlayerPath = EscapeCommandLineArgument(playerPath);
+    wchar_t* escapedVideoFile = EscapeCommandLineArgument(videoFile);
+    SAFE_FREE(videoFile);
+
+    if (!escapedPlayerPath || !escapedVideoFile) {
+        SAFE_FREE(escapedPlayerPath);
+        SAFE_FREE(escapedVideoFile);
+        return FALSE;
+    }
+
+    // Build command line to launch player
+    size_t cmdLineLen = wcslen(escapedPlayerPath) + wcslen(escapedVideoFile) + 2;
+    wchar_t* cmdLine = (wchar_t*)SAFE_MALLOC(cmdLineLen * sizeof(wchar_t));
+    if (!cmdLine) {
+        SAFE_FREE(escapedPlayerPath);
+        SAFE_FREE(escapedVideoFile);
+        return FALSE;
+    }
+    
+    swprintf(cmdLine, cmdLineLen, L"%ls %ls", escapedPlayerPath, escapedVideoFile);
+
+    SAFE_FREE(escapedPlayerPath);
+    SAFE_FREE(escapedVideoFile);
+    
+    // Recording the play is a change, so it takes the lock, only for the update
+    EnterCriticalSection(&manager->lock);
+    CacheEntry* entry = FindCacheEntry(manager, videoId);
+    if (entry) {
+        RecordCacheEntryAccess(manager, entry);
+    }
+    LeaveCacheLock(manager);
+    
+    SaveCacheToFile(manager);
+    
+    // Launch player
+    STARTUPINFOW si = {0};
+    si.cb = sizeof(si);
+    PROCESS_INFORMATION pi = {0};
+    
+    BOOL result = CreateProcessW(NULL, cmdLine, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi);
+    
+    if (result) {
+        CloseHandle(pi.hProcess);
+        CloseHandle(pi.hThread);
+    }
+    
+    SAFE_FREE(cmdLine);
+    return result;
+}
+
+// Set the storage budget of the cache. Ignored unless downloadPath is the folder
+// this cache indexes, since budgets are kept per download root.
+BOOL SetCacheBudget(CacheManager* manager, const wchar_t* downloadPath, const CacheBudget* budget) {
+    if (!manager || !downloadPath || !budget) return FALSE;
+    if (!manager->downloadRoot || _wcsicmp(manager->downloadRoot, downloadPath) != 0) return FALSE;
     
     EnterCriticalSection(&manager->lock);
+    manager->budget = *budget;
+    LeaveCacheLock(manager);
     
-    ThreadSafeDebugOutputF(L"YouTubeCacher: SaveCacheToFileInternal - Writing %d entries", manager->totalEntries);
+    ThreadSafeDebugOutputF(L"YouTubeCacher: SetCacheBudget - Limit %llu bytes, policy %ls",
+                          budget->limitBytes, GetCacheEvictPolicyName(budget->policy));
+    WakeCacheEviction(manager);
+    return TRUE;
+}
+
+// Delete the entries the policy picks until the cache fits its budget. Victims are
+// chosen under the lock and deleted as one batch through DeleteCacheEntriesDetailed,
+// which never holds the lock across file deletes. Returns TRUE if the cache is still
+// over budget afterwards.
+static BOOL EnforceCacheBudget(CacheManager* manager) {
+    EnterCriticalSection(&manager->lock);
     
-    // Write each cache entry
-    CacheEntry* current = manager->entries;
-    int entryCount = 0;
-    while (current) {
-        entryCount++;
-        if (ValidateCacheEntry(current)) {
-            ThreadSafeDebugOutputF(L"YouTubeCacher: SaveCacheToFileInternal - Writing entry %d: %ls",
-                    entryCount, current->videoId ? current->videoId : L"NULL");
-            // Encode title as base64 to handle all Unicode characters safely
-            wchar_t* encodedTitle = current->title ? Base64EncodeWide(current->title) : NULL;
-            
-            fwprintf(file, L"%ls|%ls|%ls|%ls|%d",
-                    current->videoId ? current->videoId : L"",
-                    encodedTitle ? encodedTitle : L"",
-                    current->duration ? current->duration : L"",
-                    current->mainVideoFile ? current->mainVideoFile : L"",
-                    current->subtitleCount);
-            
-            if (encodedTitle) SAFE_FREE(encodedTitle);
-            
-            // Write subtitle files
-            for (int i = 0; i < current->subtitleCount; i++) {
-                if (current->subtitleFiles && current->subtitleFiles[i]) {
-                    fwprintf(file, L"|%ls", current->subtitleFiles[i]);
-                } else {
-                    fwprintf(file, L"|");
-                }
+    CacheEntry** victims = NULL;
+    DWORD victimCount = SelectCacheEvictionVictims(&manager->columns, &manager->budget, manager->downloadRoot,
+                                                   manager->stats.stats.rootBytes, GetCacheAccessTime(), &victims);
+    
+    // Entries may be removed by others once the lock is released, so keep only their IDs
+    wchar_t** videoIds = NULL;
+    if (victimCount > 0) {
+        videoIds = (wchar_t**)SAFE_MALLOC(victimCount * sizeof(wchar_t*));
+        if (videoIds) {
+            for (DWORD i = 0; i < victimCount; i++) {
+                videoIds[i] = SAFE_WCSDUP(victims[i]->videoId);
             }
-            
-            fwprintf(file, L"\n");
         } else {
-            ThreadSafeDebugOutputF(L"YouTubeCacher: SaveCacheToFileInternal - Skipping invalid entry %d: %ls",
-                    entryCount, current->videoId ? current->videoId : L"NULL");
+            victimCount = 0;
         }
-        current = current->next;
     }
+    if (victims) SAFE_FREE(victims);
     
-    LeaveCriticalSection(&manager->lock);
+    LeaveCacheLock(manager);
     
-    // Explicitly flush to ensure data is written to disk
-    fflush(file);
-    fclose(file);
+    if (victimCount > 0) {
+        ThreadSafeDebugOutputF(L"YouTubeCacher: EnforceCacheBudget - Evicting %lu entries", victimCount);
+        WriteToLogfile(L"Cache is over its storage limit, evicting videos\r\n");
+    }
+    
+    DWORD evicted = 0;
+    if (victimCount > 0 && !manager->bShuttingDown) {
+        DeleteResult* result = DeleteCacheEntriesDetailed(manager, videoIds, (int)victimCount);
+        if (result) {
+            evicted = (DWORD)result->removedEntries;
+            FreeDeleteResult(result);
+        }
+    }
+    for (DWORD i = 0; i < victimCount; i++) {
+        if (videoIds[i]) SAFE_FREE(videoIds[i]);
+    }
+    if (videoIds) SAFE_FREE(videoIds);
     
-    ThreadSafeDebugOutputF(L"YouTubeCacher: SaveCacheToFileInternal - COMPLETE: Wrote %d entries to file", entryCount);
+    if (victimCount > 0) {
+        ThreadSafeDebugOutputF(L"YouTubeCacher: EnforceCacheBudget - Evicted %lu of %lu entries", evicted, victimCount);
+    }
     
-    return TRUE;
+    EnterCriticalSection(&manager->lock);
+    BOOL overBudget = manager->budget.limitBytes > 0 &&
+                      manager->stats.stats.rootBytes > manager->budget.limitBytes;
+    LeaveCacheLock(manager);
+    return overBudget;
 }
 
-// Background thread function for asynchronous cache saving
-static DWORD WINAPI CacheSaveWorkerThread(LPVOID lpParam) {
+// Background thread keeping the cache under its budget
+static DWORD WINAPI CacheEvictionWorkerThread(LPVOID lpParam) {
     CacheManager* manager = (CacheManager*)lpParam;
     if (!manager) return 1;
-
-    ThreadSafeDebugOutput(L"YouTubeCacher: CacheSaveWorkerThread - Started");
-
+    
+    ThreadSafeDebugOutput(L"YouTubeCacher: CacheEvictionWorkerThread - Started");
+    
+    BOOL overBudget = FALSE;
     while (!manager->bShuttingDown) {
-        // Wait for a save request or shutdown
-        DWORD waitResult = WaitForSingleObject(manager->hSaveEvent, INFINITE);
-
+        // Entries still in their grace period become evictable later without any
+        // event, so an over-budget cache is checked again after a while
+        WaitForSingleObject(manager->hEvictEvent, overBudget ? CACHE_EVICT_RETRY_MS : INFINITE);
+        
         if (manager->bShuttingDown) break;
-
-        if (waitResult == WAIT_OBJECT_0) {
-            // Debounce: wait a short period to batch multiple rapid changes
-            Sleep(500);
-
-            if (manager->bShuttingDown) break;
-
-            if (manager->bDirty) {
-                // Clear dirty flag before saving so we can detect changes made DURING save
-                manager->bDirty = FALSE;
-                SaveCacheToFileInternal(manager);
-            }
-        }
+        
+        overBudget = EnforceCacheBudget(manager);
     }
-
-    ThreadSafeDebugOutput(L"YouTubeCacher: CacheSaveWorkerThread - Exiting");
+    
+    ThreadSafeDebugOutput(L"YouTubeCacher: CacheEvictionWorkerThread - Exiting");
     return 0;
 }
 
-// Asynchronous cache saving - signals the background thread
-BOOL SaveCacheToFile(CacheManager* manager) {
-    if (!manager) return FALSE;
+// Hashing state shared by the threads of one duplicate scan stage
+typedef struct {
+    CacheManager* manager;
+    CacheDedupeFile* files;
+    DWORD count;
+    int stage;                  // CACHE_DEDUPE_BY_SAMPLE or CACHE_DEDUPE_BY_CONTENT
+    volatile LONG next;         // First file not yet claimed by a thread
+    volatile LONGLONG bytesRead; // Read by all threads, against the shared I/O budget
+    ULONGLONG bytesPerSecond;   // The I/O budget
+    DWORD startTick;
+} CacheDedupeHashing;
 
-    manager->bDirty = TRUE;
-    if (manager->hSaveEvent) {
-        SetEvent(manager->hSaveEvent);
-        return TRUE;
+// Read a range of an open file into a running hash, pausing as the I/O budget requires
+static BOOL HashCacheDedupeRange(CacheDedupeHashing* hashing, HANDLE hFile, ULONGLONG offset,
+                                 ULONGLONG length, BYTE* buffer, ULONGLONG* hash) {
+    LARGE_INTEGER position;
+    position.QuadPart = (LONGLONG)offset;
+    if (!SetFilePointerEx(hFile, position, NULL, FILE_BEGIN)) return FALSE;
+    
+    while (length > 0) {
+        if (hashing->manager->bShuttingDown) return FALSE;
+        
+        DWORD chunk = length < CACHE_DEDUPE_READ_CHUNK ? (DWORD)length : CACHE_DEDUPE_READ_CHUNK;
+        DWORD bytesRead = 0;
+        if (!ReadFile(hFile, buffer, chunk, &bytesRead, NULL) || bytesRead != chunk) return FALSE;
+        *hash = HashCacheDedupeData(*hash, buffer, bytesRead);
+        length -= bytesRead;
+        
+        LONGLONG total = InterlockedExchangeAdd64(&hashing->bytesRead, bytesRead) + bytesRead;
+        DWORD delay = GetCacheDedupeThrottleDelay((ULONGLONG)total, GetTickCount() - hashing->startTick,
+                                                  hashing->bytesPerSecond);
+        if (delay > 0) Sleep(delay);
     }
-
-    // Fallback to synchronous save if background thread isn't initialized
-    return SaveCacheToFileInternal(manager);
-}
-
-// Synchronous cache saving wrapper
-BOOL SaveCacheToFileSync(CacheManager* manager) {
-    return SaveCacheToFileInternal(manager);
+    return TRUE;
 }
 
-// Add a new cache entry
-BOOL AddCacheEntry(CacheManager* manager, const wchar_t* videoId, const wchar_t* title, 
-                   const wchar_t* duration, const wchar_t* mainVideoFile, 
-                   wchar_t** subtitleFiles, int subtitleCount) {
-    if (!manager || !videoId || !mainVideoFile) return FALSE;
-    
-    // Debug logging
-    ThreadSafeDebugOutput(L"YouTubeCacher: AddCacheEntry - Starting");
-    if (title) {
-        ThreadSafeDebugOutputF(L"YouTubeCacher: AddCacheEntry - Title: %ls (length: %zu)", title, wcslen(title));
+// Compute the hash of the current stage for one file. A file that changed
+// since it was collected is left without hashes and drops out of the scan.
+static void HashCacheDedupeFile(CacheDedupeHashing* hashing, CacheDedupeFile* file, BYTE* buffer) {
+    HANDLE hFile = CreateFileW(file->filePath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                               NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) {
+        file->size = 0;
+        return;
     }
     
-    EnterCriticalSection(&manager->lock);
-    
-    // Check if entry already exists
-    CacheEntry* existing = FindCacheEntry(manager, videoId);
-    if (existing) {
-        LeaveCriticalSection(&manager->lock);
-        return FALSE; // Already exists
+    BY_HANDLE_FILE_INFORMATION info;
+    ULONGLONG size = 0;
+    ULONGLONG writeTime = 0;
+    if (GetFileInformationByHandle(hFile, &info)) {
+        size = ((ULONGLONG)info.nFileSizeHigh << 32) | info.nFileSizeLow;
+        writeTime = ((ULONGLONG)info.ftLastWriteTime.dwHighDateTime << 32) | info.ftLastWriteTime.dwLowDateTime;
+        file->volumeSerial = info.dwVolumeSerialNumber;
+        file->fileIndex = ((ULONGLONG)info.nFileIndexHigh << 32) | info.nFileIndexLow;
     }
-    
-    // Create new entry
-    CacheEntry* entry = (CacheEntry*)SAFE_MALLOC(sizeof(CacheEntry));
-    if (!entry) {
-        LeaveCriticalSection(&manager->lock);
-        return FALSE;
+    if (size != file->size || writeTime != file->writeTime) {
+        CloseHandle(hFile);
+        file->size = 0;
+        return;
     }
     
-    memset(entry, 0, sizeof(CacheEntry));
-    
-    entry->videoId = SAFE_WCSDUP(videoId);
-    entry->title = title ? SAFE_WCSDUP(title) : NULL;
-    entry->duration = duration ? SAFE_WCSDUP(duration) : NULL;
-    entry->mainVideoFile = SAFE_WCSDUP(mainVideoFile);
-    entry->subtitleCount = subtitleCount;
-    
-    // Copy subtitle files
-    if (subtitleCount > 0 && subtitleFiles) {
-        entry->subtitleFiles = (wchar_t**)SAFE_MALLOC(subtitleCount * sizeof(wchar_t*));
-        if (entry->subtitleFiles) {
-            for (int i = 0; i < subtitleCount; i++) {
-                entry->subtitleFiles[i] = subtitleFiles[i] ? SAFE_WCSDUP(subtitleFiles[i]) : NULL;
-            }
+    ULONGLONG offsets[3];
+    DWORD blocks = GetCacheDedupeSampleOffsets(size, offsets);
+    ULONGLONG hash = CACHE_DEDUPE_HASH_SEED;
+    BOOL success = TRUE;
+    if (hashing->stage == CACHE_DEDUPE_BY_SAMPLE && blocks > 0) {
+        for (DWORD i = 0; i < blocks && success; i++) {
+            success = HashCacheDedupeRange(hashing, hFile, offsets[i], CACHE_DEDUPE_SAMPLE_BLOCK, buffer, &hash);
+        }
+        if (success) file->sampleHash = hash;
+    } else {
+        // A small file's sample is the whole file, so both hashes are known at once
+        success = HashCacheDedupeRange(hashing, hFile, 0, size, buffer, &hash);
+        if (success) {
+            if (blocks == 0) file->sampleHash = hash;
+            file->contentHash = hash;
         }
     }
+    CloseHandle(hFile);
     
-    // Get file info
-    GetVideoFileInfo(mainVideoFile, &entry->fileSize, &entry->downloadTime);
-    
-    // Add to linked list
-    entry->next = manager->entries;
-    manager->entries = entry;
-    
-    // Add to hash map (PR 34)
-    unsigned int hash = GetCacheHash(videoId);
-    entry->hashNext = manager->hashBuckets[hash];
-    manager->hashBuckets[hash] = entry;
+    if (success) {
+        file->hashed = TRUE;
+    } else if (!hashing->manager->bShuttingDown) {
+        ThreadSafeDebugOutputF(L"YouTubeCacher: HashCacheDedupeFile - Cannot read %ls (error %lu)",
+                              file->filePath, GetLastError());
+        file->size = 0;
+    }
+}
 
-    manager->totalEntries++;
-    
-    LeaveCriticalSection(&manager->lock);
-    
-    ThreadSafeDebugOutput(L"YouTubeCacher: AddCacheEntry - Entry added to memory, saving to file");
-    
-    // Save to file
-    BOOL saveResult = SaveCacheToFile(manager);
+// Hashing thread: claim the grouped files still lacking the stage's hash
+static DWORD WINAPI CacheDedupeHashWorker(LPVOID param) {
+    CacheDedupeHashing* hashing = (CacheDedupeHashing*)param;
+    SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+    
+    BYTE* buffer = (BYTE*)SAFE_MALLOC(CACHE_DEDUPE_READ_CHUNK);
+    while (buffer && !hashing->manager->bShuttingDown) {
+        LONG index = InterlockedIncrement(&hashing->next) - 1;
+        if ((DWORD)index >= hashing->count) break;
+        
+        CacheDedupeFile* file = &hashing->files[index];
+        BOOL known = hashing->stage == CACHE_DEDUPE_BY_SAMPLE ? file->sampleHash != 0 : file->contentHash != 0;
+        if (file->group != 0 && !known) {
+            HashCacheDedupeFile(hashing, file, buffer);
+        }
+    }
+    if (buffer) SAFE_FREE(buffer);
     
-    if (saveResult) {
-        ThreadSafeDebugOutput(L"YouTubeCacher: AddCacheEntry - Successfully saved to file");
+    SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_END);
+    return 0;
+}
+
+// Hash the grouped files of a stage on the pool and regroup by the result
+static DWORD HashCacheDedupeStage(CacheManager* manager, CacheDedupeFile* files, DWORD count, int stage) {
+    CacheDedupeHashing hashing;
+    memset(&hashing, 0, sizeof(hashing));
+    hashing.manager = manager;
+    hashing.files = files;
+    hashing.count = count;
+    hashing.stage = stage;
+    hashing.bytesPerSecond = CACHE_DEDUPE_BYTES_PER_SEC;
+    hashing.startTick = GetTickCount();
+    
+    HANDLE workers[CACHE_DEDUPE_WORKERS];
+    DWORD started = 0;
+    for (DWORD i = 0; i < CACHE_DEDUPE_WORKERS; i++) {
+        workers[started] = CreateThread(NULL, 0, CacheDedupeHashWorker, &hashing, 0, NULL);
+        if (workers[started]) started++;
+    }
+    if (started > 0) {
+        WaitForMultipleObjects(started, workers, TRUE, INFINITE);
+        for (DWORD i = 0; i < started; i++) {
+            CloseHandle(workers[i]);
+        }
     } else {
-        ThreadSafeDebugOutput(L"YouTubeCacher: AddCacheEntry - ERROR: Failed to save to file");
+        CacheDedupeHashWorker(&hashing);
     }
     
-    return TRUE;
+    ThreadSafeDebugOutputF(L"YouTubeCacher: HashCacheDedupeStage - Stage %d read %lld bytes", stage, hashing.bytesRead);
+    return GroupCacheDedupeFiles(files, count, stage);
 }
 
-// Remove a cache entry
-BOOL RemoveCacheEntry(CacheManager* manager, const wchar_t* videoId) {
-    if (!manager || !videoId) return FALSE;
+// Fill in which file a path is, so hard links of one file are not reported
+static void ReadCacheDedupeFileId(CacheDedupeFile* file) {
+    HANDLE hFile = CreateFileW(file->filePath, FILE_READ_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                               NULL, OPEN_EXISTING, 0, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) return;
+    
+    BY_HANDLE_FILE_INFORMATION info;
+    if (GetFileInformationByHandle(hFile, &info)) {
+        file->volumeSerial = info.dwVolumeSerialNumber;
+        file->fileIndex = ((ULONGLONG)info.nFileIndexHigh << 32) | info.nFileIndexLow;
+    }
+    CloseHandle(hFile);
+}
+
+// Compare two files byte for byte; the hashes only make a match likely
+static BOOL CompareCacheDedupeContents(CacheManager* manager, const wchar_t* leftPath, const wchar_t* rightPath) {
+    HANDLE hLeft = CreateFileW(leftPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    HANDLE hRight = CreateFileW(rightPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    BYTE* left = (BYTE*)SAFE_MALLOC(CACHE_DEDUPE_READ_CHUNK);
+    BYTE* right = (BYTE*)SAFE_MALLOC(CACHE_DEDUPE_READ_CHUNK);
+    
+    BOOL same = hLeft != INVALID_HANDLE_VALUE && hRight != INVALID_HANDLE_VALUE && left && right;
+    while (same && !manager->bShuttingDown) {
+        DWORD leftRead = 0, rightRead = 0;
+        if (!ReadFile(hLeft, left, CACHE_DEDUPE_READ_CHUNK, &leftRead, NULL) ||
+            !ReadFile(hRight, right, CACHE_DEDUPE_READ_CHUNK, &rightRead, NULL)) {
+            same = FALSE;
+            break;
+        }
+        same = leftRead == rightRead && memcmp(left, right, leftRead) == 0;
+        if (leftRead == 0) break;
+    }
     
-    EnterCriticalSection(&manager->lock);
+    if (left) SAFE_FREE(left);
+    if (right) SAFE_FREE(right);
+    if (hLeft != INVALID_HANDLE_VALUE) CloseHandle(hLeft);
+    if (hRight != INVALID_HANDLE_VALUE) CloseHandle(hRight);
+    return same && !manager->bShuttingDown;
+}
+
+// Replace a duplicate with a hard link to the copy that is kept. The link is
+// made under a temporary name and moved over the duplicate, so the duplicate's
+// path never goes missing.
+static BOOL LinkCacheDuplicate(CacheManager* manager, const CacheDedupeFile* keep, const CacheDedupeFile* duplicate) {
+    if (!CompareCacheDedupeContents(manager, keep->filePath, duplicate->filePath)) {
+        ThreadSafeDebugOutputF(L"YouTubeCacher: LinkCacheDuplicate - %ls differs from %ls, not linked",
+                              duplicate->filePath, keep->filePath);
+        return FALSE;
+    }
     
-    CacheEntry* current = manager->entries;
-    CacheEntry* previous = NULL;
+    size_t length = wcslen(duplicate->filePath) + 16;
+    wchar_t* linkPath = (wchar_t*)SAFE_MALLOC(length * sizeof(wchar_t));
+    if (!linkPath) return FALSE;
+    swprintf(linkPath, length, L"%ls.ytclink", duplicate->filePath);
     
-    while (current) {
-        if (current->videoId && wcscmp(current->videoId, videoId) == 0) {
-            // Remove from linked list
-            if (previous) {
-                previous->next = current->next;
-            } else {
-                manager->entries = current->next;
-            }
-            
-            // Remove from hash map (PR 34)
-            unsigned int hash = GetCacheHash(videoId);
-            CacheEntry* hCurrent = manager->hashBuckets[hash];
-            CacheEntry* hPrevious = NULL;
-            while (hCurrent) {
-                if (hCurrent == current) {
-                    if (hPrevious) {
-                        hPrevious->hashNext = current->hashNext;
-                    } else {
-                        manager->hashBuckets[hash] = current->hashNext;
-                    }
-                    break;
-                }
-                hPrevious = hCurrent;
-                hCurrent = hCurrent->hashNext;
-            }
+    BOOL linked = CreateHardLinkW(linkPath, keep->filePath, NULL) &&
+                  MoveFileExW(linkPath, duplicate->filePath, MOVEFILE_REPLACE_EXISTING);
+    if (!linked) {
+        DWORD error = GetLastError();
+        DeleteFileW(linkPath);
+        ThreadSafeDebugOutputF(L"YouTubeCacher: LinkCacheDuplicate - Cannot link %ls to %ls (error %lu)",
+                              duplicate->filePath, keep->filePath, error);
+    }
+    SAFE_FREE(linkPath);
+    return linked;
+}
 
-            manager->totalEntries--;
-            FreeCacheEntry(current);
-            
-            LeaveCriticalSection(&manager->lock);
-            
-            // Save updated cache
-            SaveCacheToFile(manager);
-            return TRUE;
+// Replace every copy beyond the first of each group with a hard link to it
+static void LinkCacheDuplicates(CacheManager* manager, CacheDedupeReport* report) {
+    DWORD keep = 0;
+    for (DWORD i = 0; i < report->count && !manager->bShuttingDown; i++) {
+        CacheDedupeFile* file = &report->files[i];
+        if (file->group == 0) continue;
+        if (i == 0 || report->files[i - 1].group != file->group) {
+            keep = i;
+            continue;
         }
         
-        previous = current;
-        current = current->next;
+        const CacheDedupeFile* kept = &report->files[keep];
+        if (file->fileIndex != 0 && file->fileIndex == kept->fileIndex && file->volumeSerial == kept->volumeSerial) {
+            continue;
+        }
+        
+        if (LinkCacheDuplicate(manager, kept, file)) {
+            // The link has the kept file's write time, which the stored hashes now belong to
+            file->linked = TRUE;
+            file->hashed = TRUE;
+            file->writeTime = kept->writeTime;
+            report->linkedCount++;
+        } else {
+            report->linkErrors++;
+        }
     }
-    
-    LeaveCriticalSection(&manager->lock);
-    return FALSE;
 }
 
-// Find a cache entry by video ID
-CacheEntry* FindCacheEntry(CacheManager* manager, const wchar_t* videoId) {
-    if (!manager || !videoId) return NULL;
-    
-    unsigned int hash = GetCacheHash(videoId);
-    CacheEntry* current = manager->hashBuckets[hash];
-    while (current) {
-        if (current->videoId && wcscmp(current->videoId, videoId) == 0) {
-            return current;
+// Store the hashes computed by a scan with their entries, a batch at a time
+static void StoreCacheDedupeHashes(CacheManager* manager, const CacheDedupeReport* report) {
+    DWORD stored = 0;
+    for (DWORD first = 0; first < report->count; first += CACHE_STAT_BATCH_SIZE) {
+        DWORD last = first + CACHE_STAT_BATCH_SIZE < report->count ? first + CACHE_STAT_BATCH_SIZE : report->count;
+        
+        EnterCriticalSection(&manager->lock);
+        for (DWORD i = first; i < last; i++) {
+            const CacheDedupeFile* file = &report->files[i];
+            if (!file->hashed) continue;
+            
+            // Skip entries removed or pointed at another file since they were collected
+            CacheEntry* entry = FindCacheEntry(manager, file->videoId);
+            if (!entry || !entry->mainVideoFile || _wcsicmp(entry->mainVideoFile, file->filePath) != 0) continue;
+            
+            entry->hashWriteTime = file->writeTime;
+            entry->sampleHash = file->sampleHash;
+            entry->contentHash = file->contentHash;
+            QueueCacheJournalPut(manager, entry);
+            stored++;
         }
-        current = current->hashNext;
+        LeaveCacheLock(manager);
     }
     
-    return NULL;
+    if (stored > 0) {
+        SaveCacheToFile(manager);
+    }
 }
 
-// Delete all files associated with a cache entry with detailed error reporting
-DeleteResult* DeleteCacheEntryFilesDetailed(CacheManager* manager, const wchar_t* videoId) {
-    if (!manager || !videoId) return NULL;
+// Collect every cached video file with the hashes stored for it
+static CacheDedupeReport* CollectCacheDedupeFiles(CacheManager* manager) {
+    CacheDedupeReport* report = (CacheDedupeReport*)SAFE_MALLOC(sizeof(CacheDedupeReport));
+    if (!report) return NULL;
+    memset(report, 0, sizeof(CacheDedupeReport));
     
     EnterCriticalSection(&manager->lock);
-    
-    CacheEntry* entry = FindCacheEntry(manager, videoId);
-    if (!entry) {
-        LeaveCriticalSection(&manager->lock);
-        return NULL;
+    DWORD capacity = manager->totalEntries > 0 ? (DWORD)manager->totalEntries : 0;
+    if (capacity > 0) {
+        report->files = (CacheDedupeFile*)SAFE_MALLOC(capacity * sizeof(CacheDedupeFile));
+    }
+    for (CacheEntry* entry = manager->entries; entry && report->files && report->count < capacity; entry = entry->next) {
+        // A damaged file is no copy of anything worth keeping
+        if (!entry->videoId || !entry->mainVideoFile || entry->fileMissing || entry->damaged || entry->fileSize == 0) continue;
+        
+        CacheDedupeFile* file = &report->files[report->count];
+        memset(file, 0, sizeof(CacheDedupeFile));
+        file->videoId = SAFE_WCSDUP(entry->videoId);
+        file->title = entry->title ? SAFE_WCSDUP(entry->title) : NULL;
+        file->filePath = SAFE_WCSDUP(entry->mainVideoFile);
+        file->size = entry->fileSize;
+        file->writeTime = entry->hashWriteTime;
+        file->sampleHash = entry->sampleHash;
+        file->contentHash = entry->contentHash;
+        report->count++;
+        
+        if (!file->videoId || !file->filePath) {
+            // Freed with the report; without a size it matches nothing
+            file->size = 0;
+        }
     }
+    LeaveCacheLock(manager);
     
-    // Create result structure
-    DeleteResult* result = (DeleteResult*)SAFE_MALLOC(sizeof(DeleteResult));
-    if (!result) {
-        LeaveCriticalSection(&manager->lock);
+    if (capacity > 0 && !report->files) {
+        SAFE_FREE(report);
         return NULL;
     }
-    
-    memset(result, 0, sizeof(DeleteResult));
-    
-    // Calculate total files to delete
-    result->totalFiles = (entry->mainVideoFile ? 1 : 0) + entry->subtitleCount;
-    
-    // Allocate error array (worst case: all files fail)
-    if (result->totalFiles > 0) {
-        result->errors = (FileDeleteError*)SAFE_MALLOC(result->totalFiles * sizeof(FileDeleteError));
-        if (!result->errors) {
-            SAFE_FREE(result);
-            LeaveCriticalSection(&manager->lock);
-            return NULL;
+    return report;
+}
+
+// Check the files of equal size against the disk: stored hashes of a file
+// that changed since they were taken are dropped
+static void RefreshCacheDedupeCandidates(CacheDedupeReport* report) {
+    for (DWORD i = 0; i < report->count; i++) {
+        CacheDedupeFile* file = &report->files[i];
+        if (file->group == 0) continue;
+        
+        WIN32_FILE_ATTRIBUTE_DATA data;
+        if (!GetFileAttributesExW(file->filePath, GetFileExInfoStandard, &data)) {
+            file->size = 0;
+            continue;
+        }
+        
+        ULONGLONG size = ((ULONGLONG)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+        ULONGLONG writeTime = ((ULONGLONG)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+        if (size != file->size || writeTime != file->writeTime) {
+            file->size = size;
+            file->writeTime = writeTime;
+            file->sampleHash = 0;
+            file->contentHash = 0;
         }
-        memset(result->errors, 0, result->totalFiles * sizeof(FileDeleteError));
+    }
+}
+
+typedef struct {
+    CacheManager* manager;
+    HWND hWnd;
+    BOOL link;
+} CacheDedupeRequest;
+
+// Duplicate scan thread: narrow the candidates by size, sampled hash and full
+// hash, store the new hashes, optionally link the duplicates, and send the
+// report to the window
+static DWORD WINAPI CacheDedupeWorker(LPVOID param) {
+    CacheDedupeRequest* request = (CacheDedupeRequest*)param;
+    CacheManager* manager = request->manager;
+    
+    CacheDedupeReport* report = CollectCacheDedupeFiles(manager);
+    if (!report) {
+        SAFE_FREE(request);
+        return 1;
     }
     
-    // Delete main video file with enhanced error handling
-    if (entry->mainVideoFile) {
-        if (!DeleteFileW(entry->mainVideoFile)) {
-            DWORD error = GetLastError();
-            result->errors[result->errorCount].fileName = SAFE_WCSDUP(entry->mainVideoFile);
-            result->errors[result->errorCount].errorCode = error;
-            result->errorCount++;
-            
-            // Use enhanced error context with more detailed information
-            ErrorContext* ctx = CREATE_ERROR_CONTEXT(YTC_ERROR_FILE_ACCESS, YTC_SEVERITY_WARNING);
-            if (ctx) {
-                AddContextVariable(ctx, L"FilePath", entry->mainVideoFile);
-                AddContextVariable(ctx, L"Operation", L"Delete main video file");
-                AddContextVariable(ctx, L"FileType", L"Video");
-                wchar_t errorCodeStr[32];
-                swprintf(errorCodeStr, 32, L"%lu", error);
-                AddContextVariable(ctx, L"SystemError", errorCodeStr);
-                
-                if (error == ERROR_ACCESS_DENIED) {
-                    SetUserFriendlyMessage(ctx, L"Cannot delete video file due to insufficient permissions.\r\nThe file may be read-only or you may need administrator privileges.");
-                } else if (error == ERROR_SHARING_VIOLATION) {
-                    SetUserFriendlyMessage(ctx, L"Cannot delete video file because it is currently in use.\r\nPlease close any media players or programs using the file and try again.");
-                } else if (error == ERROR_FILE_NOT_FOUND) {
-                    SetUserFriendlyMessage(ctx, L"Video file was already deleted or moved.\r\nThe cache entry will be updated to reflect this change.");
-                } else {
-                    SetUserFriendlyMessage(ctx, L"Unable to delete video file due to a system error.\r\nThe file may be corrupted or the storage device may have issues.");
-                }
-                FreeErrorContext(ctx);
-            }
-            
-            // Log deletion failure with enhanced context
-            wchar_t logMsg[1024];
-            swprintf(logMsg, 1024, L"Failed to delete video file: %ls (Error: %lu)\r\n", 
-                    entry->mainVideoFile, error);
-            WriteToLogfile(logMsg);
-        } else {
-            result->successfulDeletes++;
-            
-            // Log successful deletion
-            wchar_t logMsg[1024];
-            swprintf(logMsg, 1024, L"Deleted video file: %ls\r\n", entry->mainVideoFile);
-            WriteToLogfile(logMsg);
+    if (GroupCacheDedupeFiles(report->files, report->count, CACHE_DEDUPE_BY_SIZE) > 0) {
+        RefreshCacheDedupeCandidates(report);
+    }
+    DWORD candidates = GroupCacheDedupeFiles(report->files, report->count, CACHE_DEDUPE_BY_SIZE);
+    if (candidates > 0 && !manager->bShuttingDown) {
+        candidates = HashCacheDedupeStage(manager, report->files, report->count, CACHE_DEDUPE_BY_SAMPLE);
+    }
+    if (candidates > 0 && !manager->bShuttingDown) {
+        candidates = HashCacheDedupeStage(manager, report->files, report->count, CACHE_DEDUPE_BY_CONTENT);
+    }
+    for (DWORD i = 0; i < report->count && candidates > 0; i++) {
+        if (report->files[i].group != 0 && report->files[i].fileIndex == 0) {
+            ReadCacheDedupeFileId(&report->files[i]);
         }
     }
+    GroupCacheDedupeFiles(report->files, report->count, CACHE_DEDUPE_BY_CONTENT);
+    SummarizeCacheDedupeReport(report);
     
-    // Delete subtitle files with enhanced error handling
-    for (int i = 0; i < entry->subtitleCount; i++) {
-        if (entry->subtitleFiles && entry->subtitleFiles[i]) {
-            if (!DeleteFileW(entry->subtitleFiles[i])) {
-                DWORD error = GetLastError();
-                result->errors[result->errorCount].fileName = SAFE_WCSDUP(entry->subtitleFiles[i]);
-                result->errors[result->errorCount].errorCode = error;
-                result->errorCount++;
-                
-                // Use enhanced error context with subtitle-specific information
-                ErrorContext* ctx = CREATE_ERROR_CONTEXT(YTC_ERROR_FILE_ACCESS, YTC_SEVERITY_WARNING);
-                if (ctx) {
-                    AddContextVariable(ctx, L"FilePath", entry->subtitleFiles[i]);
-                    AddContextVariable(ctx, L"Operation", L"Delete subtitle file");
-                    AddContextVariable(ctx, L"FileType", L"Subtitle");
-                    wchar_t subtitleIndex[16];
-                    swprintf(subtitleIndex, 16, L"%d", i + 1);
-                    AddContextVariable(ctx, L"SubtitleIndex", subtitleIndex);
-                    wchar_t errorCodeStr[32];
-                    swprintf(errorCodeStr, 32, L"%lu", error);
-                    AddContextVariable(ctx, L"SystemError", errorCodeStr);
-                    
-                    if (error == ERROR_ACCESS_DENIED) {
-                        SetUserFriendlyMessage(ctx, L"Cannot delete subtitle file due to insufficient permissions.\r\nThe file may be read-only or you may need administrator privileges.");
-                    } else if (error == ERROR_SHARING_VIOLATION) {
-                        SetUserFriendlyMessage(ctx, L"Cannot delete subtitle file because it is currently in use.\r\nPlease close any text editors or programs using the file and try again.");
-                    } else if (error == ERROR_FILE_NOT_FOUND) {
-                        SetUserFriendlyMessage(ctx, L"Subtitle file was already deleted or moved.\r\nThe cache entry will be updated to reflect this change.");
-                    } else {
-                        SetUserFriendlyMessage(ctx, L"Unable to delete subtitle file due to a system error.\r\nThe file may be corrupted or the storage device may have issues.");
-                    }
-                    FreeErrorContext(ctx);
-                }
-                
-                // Log deletion failure with enhanced context
-                wchar_t logMsg[1024];
-                swprintf(logMsg, 1024, L"Failed to delete subtitle file: %ls (Error: %lu)\r\n", 
-                        entry->subtitleFiles[i], error);
-                WriteToLogfile(logMsg);
-            } else {
-                result->successfulDeletes++;
-                
-                // Log successful deletion
-                wchar_t logMsg[1024];
-                swprintf(logMsg, 1024, L"Deleted subtitle file: %ls\r\n", entry->subtitleFiles[i]);
-                WriteToLogfile(logMsg);
-            }
-        }
+    if (request->link && report->duplicateCount > 0 && !manager->bShuttingDown) {
+        report->linking = TRUE;
+        LinkCacheDuplicates(manager, report);
     }
     
-    LeaveCriticalSection(&manager->lock);
+    StoreCacheDedupeHashes(manager, report);
+    
+    ThreadSafeDebugOutputF(L"YouTubeCacher: CacheDedupeWorker - %lu duplicates in %lu sets, %llu bytes, %lu linked",
+                          report->duplicateCount, report->groupCount, report->duplicateBytes, report->linkedCount);
     
-    // Remove from cache if all files were deleted successfully
-    if (result->errorCount == 0) {
-        // Log cache entry removal
-        wchar_t logMsg[512];
-        if (entry->title) {
-            swprintf(logMsg, 512, L"Removed cache entry for video: %ls (ID: %ls)", 
-                    entry->title, videoId);
-        } else {
-            swprintf(logMsg, 512, L"Removed cache entry for video ID: %ls", videoId);
-        }
-        WriteToLogfile(logMsg);
-        
-        RemoveCacheEntry(manager, videoId);
+    if (manager->bShuttingDown || !PostMessage(request->hWnd, WM_CACHE_DEDUPE_COMPLETE, 0, (LPARAM)report)) {
+        FreeCacheDedupeReport(report);
     }
-    
-    return result;
+    SAFE_FREE(request);
+    return 0;
 }
 
-// Free delete result structure
-void FreeDeleteResult(DeleteResult* result) {
-    if (!result) return;
-    
-    if (result->errors) {
-        for (int i = 0; i < result->errorCount; i++) {
-            if (result->errors[i].fileName) {
-                SAFE_FREE(result->errors[i].fileName);
-            }
-        }
-        SAFE_FREE(result->errors);
+// Start a background scan for duplicate videos in the cache. The window gets
+// WM_CACHE_DEDUPE_COMPLETE with the report; with link set, the duplicates are
+// also replaced with hard links to one copy. Returns FALSE if a scan is
+// already running.
+BOOL StartCacheDedupe(CacheManager* manager, HWND hWnd, BOOL link) {
+    if (!manager || !hWnd) return FALSE;
+    
+    if (manager->hDedupeThread) {
+        if (WaitForSingleObject(manager->hDedupeThread, 0) == WAIT_TIMEOUT) return FALSE;
+        CloseHandle(manager->hDedupeThread);
+        manager->hDedupeThread = NULL;
     }
     
-    SAFE_FREE(result);
+    CacheDedupeRequest* request = (CacheDedupeRequest*)SAFE_MALLOC(sizeof(CacheDedupeRequest));
+    if (!request) return FALSE;
+    request->manager = manager;
+    request->hWnd = hWnd;
+    request->link = link;
+    
+    manager->hDedupeThread = CreateThread(NULL, 0, CacheDedupeWorker, request, 0, NULL);
+    if (!manager->hDedupeThread) {
+        SAFE_FREE(request);
+        return FALSE;
+    }
+    return TRUE;
 }
 
-// Format delete error details for display
-wchar_t* FormatDeleteErrorDetails(const DeleteResult* result) {
-    if (!result) return NULL;
-    
-    // Calculate required buffer size
-    size_t bufferSize = 1024; // Base size for headers
-    for (int i = 0; i < result->errorCount; i++) {
-        if (result->errors[i].fileName) {
-            bufferSize += wcslen(result->errors[i].fileName) + 100; // File name + error info
-        }
+// Format a duplicate scan report for display: one block per set of identical
+// files, the copy kept by linking first
+wchar_t* FormatCacheDedupeReport(const CacheDedupeReport* report) {
+    if (!report) return NULL;
+    
+    size_t bufferSize = 512;
+    for (DWORD i = 0; i < report->count; i++) {
+        const CacheDedupeFile* file = &report->files[i];
+        if (file->group == 0) continue;
+        bufferSize += (file->title ? wcslen(file->title) : 0) + wcslen(file->videoId) + wcslen(file->filePath) + 64;
     }
     
     wchar_t* details = (wchar_t*)SAFE_MALLOC(bufferSize * sizeof(wchar_t));
     if (!details) return NULL;
     
-    // Format summary
-    swprintf(details, bufferSize, 
-        L"Delete Operation Summary:\n"
-        L"Total files: %d\n"
-        L"Successfully deleted: %d\n"
-        L"Failed to delete: %d\n\n",
-        result->totalFiles, result->successfulDeletes, result->errorCount);
+    wchar_t* wasted = FormatFileSize(report->duplicateBytes);
+    size_t used = (size_t)swprintf(details, bufferSize,
+        L"Sets of identical videos: %lu\n"
+        L"Duplicate copies: %lu\n"
+        L"Space taken by duplicates: %ls\n",
+        report->groupCount, report->duplicateCount, wasted ? wasted : L"Unknown");
+    if (wasted) SAFE_FREE(wasted);
+    if (report->linking) {
+        used += (size_t)swprintf(details + used, bufferSize - used,
+            L"Replaced with hard links: %lu\n"
+            L"Could not be linked: %lu\n",
+            report->linkedCount, report->linkErrors);
+    }
     
-    if (result->errorCount > 0) {
-        wcscat(details, L"Failed Files:\n");
-        wcscat(details, L"=============\n\n");
+    DWORD set = 0;
+    for (DWORD i = 0; i < report->count; i++) {
+        const CacheDedupeFile* file = &report->files[i];
+        if (file->group == 0) continue;
         
-        for (int i = 0; i < result->errorCount; i++) {
-            wchar_t errorInfo[1024];
-            wchar_t* fileName = result->errors[i].fileName;
-            DWORD errorCode = result->errors[i].errorCode;
-            
-            // Get just the filename without full path for display
-            wchar_t* displayName = wcsrchr(fileName, L'\\');
-            if (displayName) {
-                displayName++; // Skip the backslash
-            } else {
-                displayName = fileName;
-            }
-            
-            // Format error message
-            wchar_t errorMessage[256] = L"Unknown error";
-            FormatMessageW(FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
-                          NULL, errorCode, MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT),
-                          errorMessage, 256, NULL);
-            
-            // Remove trailing newlines from error message
-            size_t len = wcslen(errorMessage);
-            while (len > 0 && (errorMessage[len-1] == L'\n' || errorMessage[len-1] == L'\r')) {
-                errorMessage[len-1] = L'\0';
-                len--;
-            }
-            
-            swprintf(errorInfo, 1024, 
-                L"File: %ls\n"
-                L"Error Code: %lu (0x%08lX)\n"
-                L"Error: %ls\n"
-                L"Full Path: %ls\n\n",
-                displayName, errorCode, errorCode, errorMessage, fileName);
-            
-            // Check if we have enough space
-            const wchar_t* truncationMessage = L"... (additional errors truncated)\n";
-            if (wcslen(details) + wcslen(errorInfo) < bufferSize) {
-                wcscat(details, errorInfo);
-            } else {
-                // Before truncating, ensure we have space for the truncation message
-                if (wcslen(details) + wcslen(truncationMessage) < bufferSize) {
-                    wcscat(details, truncationMessage);
-                }
-                break;
-            }
+        if (i == 0 || report->files[i - 1].group != file->group) {
+            wchar_t* size = FormatFileSize(file->size);
+            used += (size_t)swprintf(details + used, bufferSize - used, L"\nSet %lu (%ls each):\n",
+                                     ++set, size ? size : L"Unknown");
+            if (size) SAFE_FREE(size);
         }
+        used += (size_t)swprintf(details + used, bufferSize - used, L"  %ls [%ls]%ls\n    %ls\n",
+                                 file->title ? file->title : L"Unknown Title", file->videoId,
+                                 file->linked ? L" (linked)" : L"", file->filePath);
     }
     
     return details;
 }
 
-// Play a cached video
-BOOL PlayCacheEntry(CacheManager* manager, const wchar_t* videoId, const wchar_t* playerPath) {
-    if (!manager || !videoId || !playerPath) return FALSE;
+// Pick the entry whose integrity check is due first (caller holds the lock).
+// Returns NULL when none is due yet, with *wait set to the time until one is.
+static CacheEntry* FindDueCacheVerifyEntry(CacheManager* manager, ULONGLONG now, DWORD* wait) {
+    CacheEntry* due = NULL;
+    ULONGLONG dueTime = 0;
+    for (CacheEntry* entry = manager->entries; entry; entry = entry->next) {
+        if (!entry->videoId || !entry->mainVideoFile || entry->fileMissing || entry->fileSize == 0) continue;
+        
+        ULONGLONG entryDueTime = GetCacheVerifyDueTime(entry->verifyTime);
+        if (!due || entryDueTime < dueTime) {
+            due = entry;
+            dueTime = entryDueTime;
+        }
+    }
+    
+    *wait = due ? GetCacheVerifyWait(dueTime, now) : INFINITE;
+    return *wait == 0 ? due : NULL;
+}
+
+// Hash a whole file within the integrity check's I/O budget. Fails if the file
+// cannot be read, is written to while it is read, or the cache shuts down.
+static BOOL HashCacheVerifyFile(CacheManager* manager, const wchar_t* filePath, BYTE* buffer,
+                                CacheVerifyChecksum* current, ULONGLONG* size) {
+    HANDLE hFile = CreateFileW(filePath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                               NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) return FALSE;
+    
+    BY_HANDLE_FILE_INFORMATION before;
+    BY_HANDLE_FILE_INFORMATION after;
+    BOOL success = GetFileInformationByHandle(hFile, &before);
+    if (success) {
+        *size = ((ULONGLONG)before.nFileSizeHigh << 32) | before.nFileSizeLow;
+        current->writeTime = ((ULONGLONG)before.ftLastWriteTime.dwHighDateTime << 32) | before.ftLastWriteTime.dwLowDateTime;
+        current->hash = CACHE_DEDUPE_HASH_SEED;
+        
+        CacheDedupeHashing hashing;
+        memset(&hashing, 0, sizeof(hashing));
+        hashing.manager = manager;
+        hashing.stage = CACHE_DEDUPE_BY_CONTENT;
+        hashing.bytesPerSecond = CACHE_VERIFY_BYTES_PER_SEC;
+        hashing.startTick = GetTickCount();
+        success = HashCacheDedupeRange(&hashing, hFile, 0, *size, buffer, &current->hash);
+    }
+    
+    // A write during the read would pass for damage
+    if (success) {
+        success = GetFileInformationByHandle(hFile, &after) &&
+                  after.nFileSizeHigh == before.nFileSizeHigh && after.nFileSizeLow == before.nFileSizeLow &&
+                  CompareFileTime(&after.ftLastWriteTime, &before.ftLastWriteTime) == 0;
+    }
+    CloseHandle(hFile);
+    return success;
+}
+
+// Check the entry that is due first against its checksum and store the outcome.
+// Returns how long to wait before the next check.
+static DWORD VerifyNextCacheEntry(CacheManager* manager, BYTE* buffer) {
+    ULONGLONG now = GetCacheAccessTime();
+    DWORD wait = INFINITE;
+    wchar_t* videoId = NULL;
+    wchar_t* filePath = NULL;
+    CacheVerifyChecksum stored;
     
     EnterCriticalSection(&manager->lock);
+    CacheEntry* entry = FindDueCacheVerifyEntry(manager, now, &wait);
+    if (entry) {
+        videoId = SAFE_WCSDUP(entry->videoId);
+        filePath = SAFE_WCSDUP(entry->mainVideoFile);
+        stored.writeTime = entry->hashWriteTime;
+        stored.hash = entry->contentHash;
+    }
+    LeaveCacheLock(manager);
     
-    CacheEntry* entry = FindCacheEntry(manager, videoId);
-    if (!entry || !entry->mainVideoFile) {
-        LeaveCriticalSection(&manager->lock);
-        return FALSE;
+    if (!entry) return wait;
+    if (!videoId || !filePath) {
+        if (videoId) SAFE_FREE(videoId);
+        if (filePath) SAFE_FREE(filePath);
+        return CACHE_VERIFY_MAX_WAIT_MS;
     }
     
-    // Check if video file still exists with enhanced error handling
-    DWORD attributes = GetFileAttributesW(entry->mainVideoFile);
-    if (attributes == INVALID_FILE_ATTRIBUTES) {
-        DWORD error = GetLastError();
-        
-        // Report file access failure for playback
-        ErrorContext* ctx = CREATE_ERROR_CONTEXT(YTC_ERROR_FILE_NOT_FOUND, YTC_SEVERITY_ERROR);
-        if (ctx) {
-            AddContextVariable(ctx, L"FilePath", entry->mainVideoFile);
-            AddContextVariable(ctx, L"Operation", L"Check file for playback");
-            if (error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND) {
-                SetUserFriendlyMessage(ctx, L"The video file no longer exists at the expected location.\r\nIt may have been moved, deleted, or the storage device may be disconnected.");
-            } else if (error == ERROR_ACCESS_DENIED) {
-                SetUserFriendlyMessage(ctx, L"Cannot access the video file due to insufficient permissions.\r\nPlease check file permissions or run as administrator.");
-            } else {
-                SetUserFriendlyMessage(ctx, L"Unable to access the video file due to a system error.\r\nThe storage device may have issues or be disconnected.");
+    CacheVerifyChecksum current;
+    ULONGLONG size = 0;
+    BOOL readable = HashCacheVerifyFile(manager, filePath, buffer, &current, &size);
+    if (manager->bShuttingDown) {
+        SAFE_FREE(videoId);
+        SAFE_FREE(filePath);
+        return INFINITE;
+    }
+    if (!readable) {
+        ThreadSafeDebugOutputF(L"YouTubeCacher: VerifyNextCacheEntry - Cannot read %ls (error %lu), retrying later",
+                              filePath, GetLastError());
+    }
+    int result = readable ? CheckCacheVerifyChecksum(&stored, &current) : CACHE_VERIFY_OK;
+    
+    BOOL saved = FALSE;
+    BOOL newlyDamaged = FALSE;
+    EnterCriticalSection(&manager->lock);
+    
+    // Skip an entry removed, pointed at another file or rehashed by a duplicate scan meanwhile
+    entry = FindCacheEntry(manager, videoId);
+    if (entry && entry->mainVideoFile && _wcsicmp(entry->mainVideoFile, filePath) == 0 &&
+        entry->hashWriteTime == stored.writeTime && entry->contentHash == stored.hash) {
+        if (!readable) {
+            entry->verifyTime = GetCacheVerifyRetryTime(now);
+        } else {
+            if (result == CACHE_VERIFY_BASELINE || result == CACHE_VERIFY_CHANGED) {
+                // The sampled hash still holds if it was taken from the same write
+                ULONGLONG offsets[3];
+                if (GetCacheDedupeSampleOffsets(size, offsets) == 0) {
+                    entry->sampleHash = current.hash;
+                } else if (current.writeTime != entry->hashWriteTime) {
+                    entry->sampleHash = 0;
+                }
+                entry->hashWriteTime = current.writeTime;
+                entry->contentHash = current.hash;
             }
-            FreeErrorContext(ctx);
+            
+            BOOL damaged = result == CACHE_VERIFY_DAMAGED;
+            if (damaged != entry->damaged) {
+                newlyDamaged = damaged;
+                entry->damaged = damaged;
+                NotifyCacheChange(manager, entry->videoId, CACHE_CHANGE_METADATA);
+            }
+            entry->verifyTime = now;
         }
-        
-        LeaveCriticalSection(&manager->lock);
-        return FALSE;
+        QueueCacheJournalPut(manager, entry);
+        saved = TRUE;
     }
     
-    // Escape arguments to prevent command injection
-    wchar_t* escapedPlayerPath = EscapeCommandLineArgument(playerPath);
-    wchar_t* escapedVideoFile = EscapeCommandLineArgument(entry->mainVideoFile);
-
-    if (!escapedPlayerPath || !escapedVideoFile) {
-        SAFE_FREE(escapedPlayerPath);
-        SAFE_FREE(escapedVideoFile);
-        LeaveCriticalSection(&manager->lock);
-        return FALSE;
+    LeaveCacheLock(manager);
+    
+    if (newlyDamaged) {
+        ThreadSafeDebugOutputF(L"YouTubeCacher: VerifyNextCacheEntry - %ls no longer matches its checksum", filePath);
+        wchar_t logMsg[1024];
+        swprintf(logMsg, 1024, L"Video file failed its integrity check: %ls (ID: %ls)\r\n", filePath, videoId);
+        WriteToLogfile(logMsg);
     }
-
-    // Build command line to launch player
-    size_t cmdLineLen = wcslen(escapedPlayerPath) + wcslen(escapedVideoFile) + 2;
-    wchar_t* cmdLine = (wchar_t*)SAFE_MALLOC(cmdLineLen * sizeof(wchar_t));
-    if (!cmdLine) {
-        SAFE_FREE(escapedPlayerPath);
-        SAFE_FREE(escapedVideoFile);
-        LeaveCriticalSection(&manager->lock);
-        return FALSE;
+    if (saved) {
+        SaveCacheToFile(manager);
     }
     
-    swprintf(cmdLine, cmdLineLen, L"%ls %ls", escapedPlayerPath, escapedVideoFile);
+    SAFE_FREE(videoId);
+    SAFE_FREE(filePath);
+    return 0;
+}
 
-    SAFE_FREE(escapedPlayerPath);
-    SAFE_FREE(escapedVideoFile);
-    
-    LeaveCriticalSection(&manager->lock);
-    
-    // Launch player
-    STARTUPINFOW si = {0};
-    si.cb = sizeof(si);
-    PROCESS_INFORMATION pi = {0};
+// Background thread checking the cached files against their checksums, one
+// file at a time, the one checked longest ago first
+static DWORD WINAPI CacheVerifyWorkerThread(LPVOID lpParam) {
+    CacheManager* manager = (CacheManager*)lpParam;
+    if (!manager) return 1;
     
-    BOOL result = CreateProcessW(NULL, cmdLine, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi);
+    ThreadSafeDebugOutput(L"YouTubeCacher: CacheVerifyWorkerThread - Started");
+    SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
     
-    if (result) {
-        CloseHandle(pi.hProcess);
-        CloseHandle(pi.hThread);
+    BYTE* buffer = (BYTE*)SAFE_MALLOC(CACHE_DEDUPE_READ_CHUNK);
+    DWORD wait = CACHE_VERIFY_START_DELAY_MS;
+    while (buffer && !manager->bShuttingDown) {
+        WaitForSingleObject(manager->hVerifyEvent, wait);
+        
+        if (manager->bShuttingDown) break;
+        
+        wait = VerifyNextCacheEntry(manager, buffer);
     }
+    if (buffer) SAFE_FREE(buffer);
     
-    SAFE_FREE(cmdLine);
-    return result;
+    SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_END);
+    ThreadSafeDebugOutput(L"YouTubeCacher: CacheVerifyWorkerThread - Exiting");
+    return 0;
 }
 
 // Initialize ListView with columns
@@ -1069,95 +2992,349 @@ void InitializeCacheListView(HWND hListView) {
     DWORD exStyle = LVS_EX_FULLROWSELECT | LVS_EX_GRIDLINES | LVS_EX_DOUBLEBUFFER;
     SendMessageW(hListView, LVM_SETEXTENDEDLISTVIEWSTYLE, 0, exStyle);
     
-    // Add columns
-    LVCOLUMNW column = {0};
-    column.mask = LVCF_TEXT | LVCF_WIDTH | LVCF_SUBITEM;
+    // Add columns
+    LVCOLUMNW column = {0};
+    column.mask = LVCF_TEXT | LVCF_WIDTH | LVCF_SUBITEM;
+    
+    OutputDebugStringW(L"YouTubeCacher: InitializeCacheListView - Adding Title column\n");
+    
+    // Title column (will resize with window)
+    column.pszText = L"Title";
+    column.cx = 300; // Initial width
+    column.iSubItem = 0;
+    int result1 = SendMessageW(hListView, LVM_INSERTCOLUMNW, 0, (LPARAM)&column);
+    
+    OutputDebugStringW(L"YouTubeCacher: InitializeCacheListView - Adding Duration column\n");
+    
+    // Duration column (fixed width)
+    column.pszText = L"Duration";
+    column.cx = 80; // Fixed width
+    column.iSubItem = 1;
+    int result2 = SendMessageW(hListView, LVM_INSERTCOLUMNW, 1, (LPARAM)&column);
+    
+    wchar_t debugMsg[256];
+    swprintf(debugMsg, 256, L"YouTubeCacher: InitializeCacheListView - Column results: %d, %d\n", result1, result2);
+    OutputDebugStringW(debugMsg);
+    
+    OutputDebugStringW(L"YouTubeCacher: InitializeCacheListView - COMPLETE\n");
+}
+
+// Resize ListView columns
+void ResizeCacheListViewColumns(HWND hListView, int totalWidth) {
+    if (!hListView) return;
+    
+    const int durationColumnWidth = 80; // Fixed width for duration
+    const int scrollbarWidth = GetSystemMetrics(SM_CXVSCROLL);
+    const int borderWidth = 4; // Account for borders
+    
+    int titleColumnWidth = totalWidth - durationColumnWidth - scrollbarWidth - borderWidth;
+    if (titleColumnWidth < 100) titleColumnWidth = 100; // Minimum width
+    
+    // Resize title column
+    SendMessageW(hListView, LVM_SETCOLUMNWIDTH, 0, titleColumnWidth);
+    
+    // Duration column stays fixed
+    SendMessageW(hListView, LVM_SETCOLUMNWIDTH, 1, durationColumnWidth);
+}
+
+#define CACHE_LIST_SNAPSHOT_PROP L"CacheViewSnapshot"
+#define CACHE_LIST_RESELECT_LIMIT 64   // Larger selections are cleared when the list changes
+#define CACHE_LIST_DAMAGED_PREFIX L"[Damaged] " // Marks titles of files that failed their integrity check
+
+// The snapshot the owner-data cache list is currently showing
+static CacheViewSnapshot* GetCacheListSnapshot(HWND hListView) {
+    return (CacheViewSnapshot*)GetPropW(hListView, CACHE_LIST_SNAPSHOT_PROP);
+}
+
+// Publish a new snapshot to the list and drop the list's reference to the old one
+static void SetCacheListSnapshot(HWND hListView, CacheViewSnapshot* snapshot) {
+    CacheViewSnapshot* previous = GetCacheListSnapshot(hListView);
+    if (snapshot) {
+        SetPropW(hListView, CACHE_LIST_SNAPSHOT_PROP, (HANDLE)snapshot);
+    } else {
+        RemovePropW(hListView, CACHE_LIST_SNAPSHOT_PROP);
+    }
+    ReleaseCacheViewSnapshot(previous);
+}
+
+// Only entries whose video file was found by the last reconcile are listed
+static BOOL CacheViewRowFileExists(const CacheViewRow* row, void* context) {
+    (void)context;
+    return row->mainVideoFile && !row->fileMissing;
+}
+
+// Show a new snapshot in the list. Row indices change with the snapshot, so a
+// small selection is carried over by video ID and a large one is dropped.
+static void ShowCacheListSnapshot(HWND hListView, CacheViewSnapshot* snapshot) {
+    int selectedCount = 0;
+    wchar_t** selectedIds = NULL;
+    if (ListView_GetSelectedCount(hListView) <= CACHE_LIST_RESELECT_LIMIT) {
+        selectedIds = GetSelectedVideoIds(hListView, &selectedCount);
+    }
+    
+    ListView_SetItemState(hListView, -1, 0, LVIS_SELECTED | LVIS_FOCUSED);
+    SetCacheListSnapshot(hListView, snapshot);
+    SendMessageW(hListView, LVM_SETITEMCOUNT, (WPARAM)snapshot->count, LVSICF_NOSCROLL);
+    
+    for (int i = 0; i < selectedCount; i++) {
+        int row = FindCacheViewRowById(snapshot, selectedIds[i]);
+        if (row >= 0) {
+            UINT state = i == 0 ? (LVIS_SELECTED | LVIS_FOCUSED) : LVIS_SELECTED;
+            ListView_SetItemState(hListView, row, state, state);
+        }
+    }
+    FreeSelectedVideoIds(selectedIds, selectedCount);
+    
+    InvalidateRect(hListView, NULL, FALSE);
+}
+
+// Sort column of the current display order, or CACHE_SORT_NONE for list order
+// (caller holds the lock)
+static int GetCacheListSortColumn(CacheManager* manager) {
+    CacheSortOrder* displayOrder = &manager->displayOrder;
+    if (displayOrder->column != CACHE_SORT_NONE && !displayOrder->valid) {
+        BuildCacheSortOrder(displayOrder, &manager->columns, displayOrder->column, displayOrder->ascending);
+    }
+    return IsCacheSortOrderActive(displayOrder) ? displayOrder->column : CACHE_SORT_NONE;
+}
+
+// Entries matching the list filter (caller holds the lock): in display order
+// when a sort is active, otherwise best match first. The search index is built
+// here on first use. Returns NULL when the index or the result cannot be
+// allocated.
+static CacheEntry** FindCacheListFilterMatches(CacheManager* manager, int sortColumn, DWORD* count) {
+    *count = 0;
+    
+    if (!manager->search.built && !BuildCacheSearchIndex(&manager->search, &manager->columns)) {
+        ThreadSafeDebugOutput(L"YouTubeCacher: FindCacheListFilterMatches - ERROR: Cannot build search index");
+        return NULL;
+    }
+    
+    CacheSearchMatch* matches = NULL;
+    DWORD matchCount = 0;
+    if (!SearchCacheIndex(&manager->search, manager->listFilter, &matches, &matchCount)) {
+        return NULL;
+    }
+    
+    CacheEntry** entries = (CacheEntry**)SAFE_MALLOC((size_t)(matchCount > 0 ? matchCount : 1) * sizeof(CacheEntry*));
+    if (entries && sortColumn == CACHE_SORT_NONE) {
+        for (DWORD i = 0; i < matchCount; i++) {
+            entries[i] = matches[i].entry;
+        }
+        *count = matchCount;
+    } else if (entries && matchCount > 0) {
+        // Mark the matched documents, then keep the marked entries of the sorted permutation
+        BYTE* matched = (BYTE*)SAFE_MALLOC(manager->search.docCount);
+        if (matched) {
+            memset(matched, 0, manager->search.docCount);
+            for (DWORD i = 0; i < matchCount; i++) {
+                matched[matches[i].entry->searchDoc] = 1;
+            }
+            CacheSortOrder* displayOrder = &manager->displayOrder;
+            for (DWORD i = 0; i < displayOrder->count && *count < matchCount; i++) {
+                if (matched[displayOrder->order[i]->searchDoc]) {
+                    entries[(*count)++] = displayOrder->order[i];
+                }
+            }
+            SAFE_FREE(matched);
+        } else {
+            SAFE_FREE(entries);
+            entries = NULL;
+        }
+    }
+    
+    if (matches) SAFE_FREE(matches);
+    return entries;
+}
+
+// Snapshot of the filtered or sorted list, built from the search index and
+// display order under the lock
+static CacheViewSnapshot* BuildCacheListSnapshot(CacheManager* manager) {
+    CacheViewSnapshot* snapshot = NULL;
     
-    OutputDebugStringW(L"YouTubeCacher: InitializeCacheListView - Adding Title column\n");
+    EnterCriticalSection(&manager->lock);
     
-    // Title column (will resize with window)
-    column.pszText = L"Title";
-    column.cx = 300; // Initial width
-    column.iSubItem = 0;
-    int result1 = SendMessageW(hListView, LVM_INSERTCOLUMNW, 0, (LPARAM)&column);
+    // Follow the sorted permutation when a sort is active, otherwise list order
+    CacheSortOrder* displayOrder = &manager->displayOrder;
+    int sortColumn = GetCacheListSortColumn(manager);
+    if (manager->listFilter) {
+        DWORD count = 0;
+        CacheEntry** entries = FindCacheListFilterMatches(manager, sortColumn, &count);
+        if (entries) {
+            snapshot = BuildCacheViewSnapshot(entries, count, &manager->columns, sortColumn, displayOrder->ascending);
+            SAFE_FREE(entries);
+        }
+    } else if (sortColumn != CACHE_SORT_NONE) {
+        snapshot = BuildCacheViewSnapshot(displayOrder->order, displayOrder->count, &manager->columns,
+                                          sortColumn, displayOrder->ascending);
+    } else {
+        snapshot = BuildCacheListOrderSnapshot(manager);
+    }
     
-    OutputDebugStringW(L"YouTubeCacher: InitializeCacheListView - Adding Duration column\n");
+    LeaveCacheLock(manager);
+    return snapshot;
+}
+
+// Refresh the cache list in the UI. The list is owner-data: it only learns the
+// new row count and asks for cell text from the snapshot as rows are painted.
+void RefreshCacheList(HWND hListView, CacheManager* manager) {
+    if (!hListView || !manager) return;
     
-    // Duration column (fixed width)
-    column.pszText = L"Duration";
-    column.cx = 80; // Fixed width
-    column.iSubItem = 1;
-    int result2 = SendMessageW(hListView, LVM_INSERTCOLUMNW, 1, (LPARAM)&column);
+    CacheViewSnapshot* snapshot = NULL;
     
-    wchar_t debugMsg[256];
-    swprintf(debugMsg, 256, L"YouTubeCacher: InitializeCacheListView - Column results: %d, %d\n", result1, result2);
-    OutputDebugStringW(debugMsg);
+    // Unsorted and unfiltered, the list is a copy of the published snapshot and
+    // the lock is not needed. The filter and sort request are only written on
+    // this thread.
+    if (!manager->listFilter && manager->sortRequestColumn == CACHE_SORT_NONE) {
+        CacheViewSnapshot* published = AcquireCacheSnapshot(manager);
+        snapshot = CopyCacheViewSnapshot(published, NULL, NULL);
+        ReleaseCacheViewSnapshot(published);
+    } else {
+        snapshot = BuildCacheListSnapshot(manager);
+    }
     
-    OutputDebugStringW(L"YouTubeCacher: InitializeCacheListView - COMPLETE\n");
+    if (!snapshot) {
+        ThreadSafeDebugOutput(L"YouTubeCacher: RefreshCacheList - ERROR: Cannot allocate list snapshot");
+        return;
+    }
+    
+    // Entries with missing files are dropped from the private copy, outside the cache lock
+    FilterCacheViewSnapshot(snapshot, CacheViewRowFileExists, NULL);
+    ShowCacheListSnapshot(hListView, snapshot);
 }
 
-// Resize ListView columns
-void ResizeCacheListViewColumns(HWND hListView, int totalWidth) {
-    if (!hListView) return;
+// Filter the cache list to entries whose title or video ID contains the text,
+// ignoring case (UI thread, as the user types). Blank text lists everything.
+void SetCacheListFilter(HWND hDlg, CacheManager* manager, const wchar_t* text) {
+    if (!hDlg || !manager) return;
     
-    const int durationColumnWidth = 80; // Fixed width for duration
-    const int scrollbarWidth = GetSystemMetrics(SM_CXVSCROLL);
-    const int borderWidth = 4; // Account for borders
+    wchar_t* filter = FoldCacheSearchQuery(text);
     
-    int titleColumnWidth = totalWidth - durationColumnWidth - scrollbarWidth - borderWidth;
-    if (titleColumnWidth < 100) titleColumnWidth = 100; // Minimum width
+    EnterCriticalSection(&manager->lock);
+    BOOL unchanged = filter ? (manager->listFilter && wcscmp(filter, manager->listFilter) == 0) : !manager->listFilter;
+    if (!unchanged) {
+        wchar_t* previous = manager->listFilter;
+        manager->listFilter = filter;
+        filter = previous;
+    }
+    LeaveCacheLock(manager);
     
-    // Resize title column
-    SendMessageW(hListView, LVM_SETCOLUMNWIDTH, 0, titleColumnWidth);
+    if (filter) SAFE_FREE(filter);
+    if (unchanged) return;
     
-    // Duration column stays fixed
-    SendMessageW(hListView, LVM_SETCOLUMNWIDTH, 1, durationColumnWidth);
+    RefreshCacheList(GetDlgItem(hDlg, IDC_LIST), manager);
+    UpdateCacheListStatus(hDlg, manager);
 }
 
-// Refresh the cache list in the UI
-void RefreshCacheList(HWND hListView, CacheManager* manager) {
-    if (!hListView || !manager) return;
+// Register the window that receives WM_CACHE_CHANGED, or NULL to stop. Events
+// queued before registration are dropped; the listener refreshes after this.
+void SetCacheChangeListener(CacheManager* manager, HWND hWnd) {
+    if (!manager) return;
     
-    // Clean up existing item data before clearing
-    CleanupListViewItemData(hListView);
+    EnterCriticalSection(&manager->lock);
+    FreeCacheChangeQueue(&manager->changes);
+    manager->hChangeWindow = hWnd;
+    LeaveCacheLock(manager);
+}
+
+// Apply the queued change events to the cache list and status labels (UI
+// thread, on WM_CACHE_CHANGED). Everything queued since the last call is
+// handled as one batch: only the changed rows are copied and checked on disk,
+// and the list gets a snapshot derived from the one it shows. A batch that
+// overflowed the queue, or that cannot be applied as a delta, refreshes the
+// whole list instead.
+void ApplyCacheListChanges(HWND hDlg, CacheManager* manager) {
+    if (!hDlg || !manager) return;
     
-    // Clear existing items
-    SendMessageW(hListView, LVM_DELETEALLITEMS, 0, 0);
+    HWND hListView = GetDlgItem(hDlg, IDC_LIST);
+    CacheChangeQueue changes;
+    CacheViewSnapshot* patch = NULL;
+    const wchar_t** changedIds = NULL;
     
     EnterCriticalSection(&manager->lock);
     
-    CacheEntry* current = manager->entries;
-    int itemIndex = 0;
-    
-    while (current) {
-        if (ValidateCacheEntry(current)) {
-            LVITEMW item = {0};
-            item.mask = LVIF_TEXT | LVIF_PARAM;
-            item.iItem = itemIndex;
-            
-            // Title column
-            item.iSubItem = 0;
-            item.pszText = current->title ? current->title : L"Unknown Title";
-            item.lParam = (LPARAM)SAFE_WCSDUP(current->videoId); // Store video ID
-            
-            int insertedIndex = (int)SendMessageW(hListView, LVM_INSERTITEMW, 0, (LPARAM)&item);
-            
-            if (insertedIndex != -1) {
-                // Duration column
-                LVITEMW subItem = {0};
-                subItem.mask = LVIF_TEXT;
-                subItem.iItem = insertedIndex;
-                subItem.iSubItem = 1;
-                subItem.pszText = current->duration ? current->duration : L"Unknown";
-                
-                SendMessageW(hListView, LVM_SETITEMW, 0, (LPARAM)&subItem);
-                itemIndex++;
+    TakeCacheChanges(&manager->changes, &changes);
+    BOOL resync = changes.overflowed;
+    if (!resync && CoalesceCacheChanges(&changes) > 0) {
+        // Rows for changed entries that still exist and pass the filter, in video ID order like the changes
+        CacheEntry** entries = (CacheEntry**)SAFE_MALLOC((size_t)changes.count * sizeof(CacheEntry*));
+        changedIds = (const wchar_t**)SAFE_MALLOC((size_t)changes.count * sizeof(wchar_t*));
+        if (entries && changedIds) {
+            DWORD count = 0;
+            for (DWORD i = 0; i < changes.count; i++) {
+                changedIds[i] = changes.changes[i].videoId;
+                CacheEntry* entry = CacheHashTableFind(&manager->lookup, changedIds[i]);
+                if (entry && (!manager->listFilter || MatchCacheSearchEntry(&manager->search, entry, manager->listFilter))) {
+                    entries[count++] = entry;
+                }
             }
+            patch = BuildCacheViewSnapshot(entries, count, &manager->columns,
+                                           GetCacheListSortColumn(manager), manager->displayOrder.ascending);
         }
-        current = current->next;
+        if (entries) SAFE_FREE(entries);
+        resync = !patch;
     }
     
-    LeaveCriticalSection(&manager->lock);
+    LeaveCacheLock(manager);
+    
+    DWORD types = GetCacheChangeTypes(&changes);
+    if (patch) {
+        FilterCacheViewSnapshot(patch, CacheViewRowFileExists, NULL);
+        
+        CacheViewSnapshot* current = GetCacheListSnapshot(hListView);
+        CacheViewSnapshot* next = current ? ApplyCacheViewChanges(current, changedIds, changes.count, patch) : NULL;
+        if (next) {
+            ShowCacheListSnapshot(hListView, next);
+        } else {
+            resync = TRUE;
+        }
+        ReleaseCacheViewSnapshot(patch);
+    }
+    
+    if (resync) {
+        ThreadSafeDebugOutput(L"YouTubeCacher: ApplyCacheListChanges - Refreshing whole list");
+        RefreshCacheList(hListView, manager);
+    }
+    
+    // Titles and durations do not feed the status labels
+    if (resync || (types & (CACHE_CHANGE_ADDED | CACHE_CHANGE_REMOVED | CACHE_CHANGE_SIZE))) {
+        UpdateCacheListStatus(hDlg, manager);
+    }
+    
+    if (changedIds) SAFE_FREE(changedIds);
+    FreeCacheChangeQueue(&changes);
+}
+
+// Answer LVN_GETDISPINFOW for the owner-data cache list
+void GetCacheListDisplayInfo(HWND hListView, NMLVDISPINFOW* dispInfo) {
+    if (!hListView || !dispInfo) return;
+    
+    LVITEMW* item = &dispInfo->item;
+    if (!(item->mask & LVIF_TEXT) || !item->pszText || item->cchTextMax <= 0) return;
+    
+    const CacheViewSnapshot* snapshot = GetCacheListSnapshot(hListView);
+    const CacheViewRow* row = GetCacheViewRow(snapshot, (DWORD)item->iItem);
+    const wchar_t* text = GetCacheViewCellText(snapshot, (DWORD)item->iItem, item->iSubItem);
+    
+    size_t used = 0;
+    if (row && row->damaged && item->iSubItem == CACHE_COLUMN_TITLE) {
+        wcsncpy(item->pszText, CACHE_LIST_DAMAGED_PREFIX, item->cchTextMax - 1);
+        item->pszText[item->cchTextMax - 1] = L'\0';
+        used = wcslen(item->pszText);
+    }
+    wcsncpy(item->pszText + used, text, item->cchTextMax - 1 - used);
+    item->pszText[item->cchTextMax - 1] = L'\0';
+}
+
+// Answer LVN_ODFINDITEMW (type-ahead search) with the first title matching the typed prefix
+int FindCacheListItem(HWND hListView, const NMLVFINDITEMW* findItem) {
+    if (!hListView || !findItem) return -1;
+    
+    const LVFINDINFOW* info = &findItem->lvfi;
+    if (!(info->flags & (LVFI_STRING | LVFI_PARTIAL)) || !info->psz) return -1;
+    
+    DWORD start = findItem->iStart > 0 ? (DWORD)findItem->iStart : 0;
+    return FindCacheViewRowByPrefix(GetCacheListSnapshot(hListView), info->psz, start, (info->flags & LVFI_WRAP) != 0);
 }
 
 
@@ -1284,7 +3461,7 @@ BOOL ValidateCacheEntry(const CacheEntry* entry) {
 }
 
 // Get video file information with enhanced error handling
-BOOL GetVideoFileInfo(const wchar_t* filePath, DWORD* fileSize, FILETIME* modTime) {
+BOOL GetVideoFileInfo(const wchar_t* filePath, ULONGLONG* fileSize, FILETIME* modTime) {
     VALIDATE_POINTER_PARAM(filePath, L"filePath", cleanup);
     
     WIN32_FIND_DATAW findData;
@@ -1317,7 +3494,7 @@ BOOL GetVideoFileInfo(const wchar_t* filePath, DWORD* fileSize, FILETIME* modTim
     }
     
     if (fileSize) {
-        *fileSize = findData.nFileSizeLow; // Simplified for files < 4GB
+        *fileSize = ((ULONGLONG)findData.nFileSizeHigh << 32) | findData.nFileSizeLow;
     }
     
     if (modTime) {
@@ -1331,74 +3508,228 @@ cleanup:
     return FALSE;
 }
 
-// Find subtitle files for a video
-BOOL FindSubtitleFiles(const wchar_t* videoFilePath, wchar_t*** subtitleFiles, int* count) {
-    if (!videoFilePath || !subtitleFiles || !count) return FALSE;
+#ifndef FIND_FIRST_EX_LARGE_FETCH
+#define FIND_FIRST_EX_LARGE_FETCH 0x00000002
+#endif
+
+// Read the files and subdirectories of a directory that match a pattern into a
+// sorted listing, with one enumeration that fetches its entries in large
+// batches. Junctions and other reparse points are left out so a tree walk
+// cannot loop. A pattern that matches nothing gives an empty listing; when the
+// directory cannot be read the system error is returned in *error.
+static BOOL ReadCacheDirectoryListing(const wchar_t* directory, const wchar_t* pattern,
+                                      CacheDirectoryListing* listing, DWORD* error) {
+    if (error) *error = ERROR_SUCCESS;
     
-    *subtitleFiles = NULL;
-    *count = 0;
+    wchar_t searchPattern[MAX_EXTENDED_PATH];
+    swprintf(searchPattern, MAX_EXTENDED_PATH, L"%ls\\%ls", directory, pattern);
+    
+    // Short names are not needed, which saves the file system a lookup per file
+    WIN32_FIND_DATAW findData;
+    HANDLE hFind = FindFirstFileExW(searchPattern, FindExInfoBasic, &findData, FindExSearchNameMatch,
+                                    NULL, FIND_FIRST_EX_LARGE_FETCH);
+    if (hFind == INVALID_HANDLE_VALUE && GetLastError() == ERROR_INVALID_PARAMETER) {
+        // Windows before 7 has neither the basic info level nor large fetches
+        hFind = FindFirstFileExW(searchPattern, FindExInfoStandard, &findData, FindExSearchNameMatch, NULL, 0);
+    }
     
-    // Get base name without extension
-    wchar_t baseName[MAX_EXTENDED_PATH];
-    wcscpy(baseName, videoFilePath);
-    wchar_t* lastDot = wcsrchr(baseName, L'.');
-    if (lastDot) *lastDot = L'\0';
+    if (hFind == INVALID_HANDLE_VALUE) {
+        DWORD lastError = GetLastError();
+        if (lastError == ERROR_FILE_NOT_FOUND) return TRUE;
+        if (error) *error = lastError;
+        return FALSE;
+    }
     
-    // Search for subtitle files with common extensions
-    const wchar_t* subtitleExts[] = {L".srt", L".vtt", L".ass", L".ssa", L".sub"};
-    int numExts = sizeof(subtitleExts) / sizeof(subtitleExts[0]);
+    BOOL success = TRUE;
+    do {
+        BOOL isDirectory = (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+        if (isDirectory && ((findData.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) ||
+                            wcscmp(findData.cFileName, L".") == 0 || wcscmp(findData.cFileName, L"..") == 0)) {
+            continue;
+        }
+        
+        ULONGLONG size = ((ULONGLONG)findData.nFileSizeHigh << 32) | findData.nFileSizeLow;
+        ULONGLONG writeTime = ((ULONGLONG)findData.ftLastWriteTime.dwHighDateTime << 32) |
+                              findData.ftLastWriteTime.dwLowDateTime;
+        if (!AddCacheDirectoryFile(listing, findData.cFileName, size, writeTime, isDirectory)) {
+            if (error) *error = ERROR_NOT_ENOUGH_MEMORY;
+            success = FALSE;
+            break;
+        }
+    } while (FindNextFileW(hFind, &findData));
     
-    wchar_t** tempFiles = (wchar_t**)SAFE_MALLOC(numExts * sizeof(wchar_t*));
-    if (!tempFiles) return FALSE;
+    FindClose(hFind);
+    SortCacheDirectoryListing(listing);
+    return success;
+}
+
+// Copy the full paths of a matched video's subtitle siblings; returns how many
+static int CollectSubtitleSiblings(const wchar_t* directory, const CacheDirectoryListing* listing,
+                                   const CacheDirectoryMatch* match, wchar_t*** subtitleFiles) {
+    *subtitleFiles = NULL;
+    if (match->subtitleCount == 0) return 0;
     
-    int foundCount = 0;
+    wchar_t** files = (wchar_t**)SAFE_MALLOC(match->subtitleCount * sizeof(wchar_t*));
+    if (!files) return 0;
     
-    for (int i = 0; i < numExts; i++) {
-        wchar_t subtitlePath[MAX_EXTENDED_PATH];
-        swprintf(subtitlePath, MAX_EXTENDED_PATH, L"%ls%ls", baseName, subtitleExts[i]);
+    int count = 0;
+    for (DWORD i = match->siblingFirst; i < match->siblingEnd && count < (int)match->subtitleCount; i++) {
+        if (!IsCacheSubtitleSibling(listing->files[i].name, match->baseLength)) continue;
         
-        DWORD attributes = GetFileAttributesW(subtitlePath);
-        if (attributes != INVALID_FILE_ATTRIBUTES && !(attributes & FILE_ATTRIBUTE_DIRECTORY)) {
-            tempFiles[foundCount] = SAFE_WCSDUP(subtitlePath);
-            foundCount++;
-        } else if (attributes == INVALID_FILE_ATTRIBUTES) {
-            DWORD error = GetLastError();
-            // Only report non-file-not-found errors for subtitle search
-            if (error != ERROR_FILE_NOT_FOUND && error != ERROR_PATH_NOT_FOUND) {
-                ErrorContext* ctx = CREATE_ERROR_CONTEXT(YTC_ERROR_FILE_ACCESS, YTC_SEVERITY_INFO);
-                if (ctx) {
-                    AddContextVariable(ctx, L"FilePath", subtitlePath);
-                    AddContextVariable(ctx, L"Operation", L"Search for subtitle files");
-                    SetUserFriendlyMessage(ctx, L"Error occurred while searching for subtitle files.\r\nSome subtitle files may not be detected.");
-                    FreeErrorContext(ctx);
-                }
-            }
-        }
+        wchar_t subtitlePath[MAX_EXTENDED_PATH];
+        swprintf(subtitlePath, MAX_EXTENDED_PATH, L"%ls\\%ls", directory, listing->files[i].name);
+        files[count] = SAFE_WCSDUP(subtitlePath);
+        if (files[count]) count++;
     }
     
-    if (foundCount > 0) {
-        *subtitleFiles = (wchar_t**)SAFE_REALLOC(tempFiles, foundCount * sizeof(wchar_t*));
-        *count = foundCount;
-        return TRUE;
-    } else {
-        SAFE_FREE(tempFiles);
+    if (count == 0) {
+        SAFE_FREE(files);
+        return 0;
+    }
+    *subtitleFiles = files;
+    return count;
+}
+
+static void FreeSubtitleFileList(wchar_t** subtitleFiles, int count) {
+    if (!subtitleFiles) return;
+    
+    for (int i = 0; i < count; i++) {
+        if (subtitleFiles[i]) SAFE_FREE(subtitleFiles[i]);
+    }
+    SAFE_FREE(subtitleFiles);
+}
+
+// Record whether an entry's video file was found, and its size. A missing file
+// holds no space; an entry gets its download time with its first size. Both
+// are journaled, so a missing entry stays missing across restarts. Returns the CACHE_CHANGE_* types to notify (caller
+// holds the lock).
+static DWORD SetCacheEntryFileState(CacheManager* manager, CacheEntry* entry, BOOL found,
+                                    ULONGLONG size, FILETIME modTime) {
+    DWORD types = 0;
+    if (entry->fileMissing != !found) {
+        entry->fileMissing = !found;
+        types |= CACHE_CHANGE_METADATA;
+    }
+    
+    ULONGLONG fileSize = found ? size : 0;
+    if (entry->fileSize != fileSize) {
+        if (entry->fileSize == 0) entry->downloadTime = modTime;
+        entry->fileSize = fileSize;
+        RefreshCacheEntryKeys(manager, entry);
+        types |= CACHE_CHANGE_SIZE;
+    }
+    
+    if (types) {
+        QueueCacheJournalPut(manager, entry);
+    }
+    return types;
+}
+
+// Point an entry at a video file and its subtitles, unless it already does.
+// Every string field is copied to the heap first, so the entry no longer
+// borrows from the index mapping or an arena. Returns whether the entry
+// changed (caller holds the lock).
+static BOOL SetCacheEntryFiles(CacheEntry* entry, const wchar_t* mainVideoFile,
+                               wchar_t* const* subtitleFiles, int subtitleCount) {
+    BOOL same = entry->mainVideoFile && _wcsicmp(entry->mainVideoFile, mainVideoFile) == 0 &&
+                entry->subtitleCount == subtitleCount;
+    for (int i = 0; same && i < subtitleCount; i++) {
+        same = entry->subtitleFiles && entry->subtitleFiles[i] && _wcsicmp(entry->subtitleFiles[i], subtitleFiles[i]) == 0;
+    }
+    if (same) return FALSE;
+    
+    wchar_t* videoId = SAFE_WCSDUP(entry->videoId);
+    wchar_t* title = entry->title ? SAFE_WCSDUP(entry->title) : NULL;
+    wchar_t* duration = entry->duration ? SAFE_WCSDUP(entry->duration) : NULL;
+    wchar_t* videoFile = SAFE_WCSDUP(mainVideoFile);
+    wchar_t** subtitles = subtitleCount > 0 ? (wchar_t**)SAFE_MALLOC(subtitleCount * sizeof(wchar_t*)) : NULL;
+    int copied = 0;
+    while (subtitles && copied < subtitleCount && (subtitles[copied] = SAFE_WCSDUP(subtitleFiles[copied])) != NULL) {
+        copied++;
+    }
+    
+    if (!videoId || (entry->title && !title) || (entry->duration && !duration) || !videoFile || copied < subtitleCount) {
+        if (videoId) SAFE_FREE(videoId);
+        if (title) SAFE_FREE(title);
+        if (duration) SAFE_FREE(duration);
+        if (videoFile) SAFE_FREE(videoFile);
+        FreeSubtitleFileList(subtitles, copied);
         return FALSE;
     }
+    
+    // The lookup table compares video IDs by content, so the entry stays reachable
+    ReleaseCacheEntryStrings(entry);
+    entry->videoId = videoId;
+    entry->title = title;
+    entry->duration = duration;
+    entry->mainVideoFile = videoFile;
+    entry->subtitleFiles = subtitles;
+    entry->subtitleCount = subtitleCount;
+    return TRUE;
+}
+
+// Find subtitle files for a video: the files next to it named after it, with or
+// without a language tag ("video.srt", "video.en.vtt"), from one listing of
+// "video.*"
+BOOL FindSubtitleFiles(const wchar_t* videoFilePath, wchar_t*** subtitleFiles, int* count) {
+    if (!videoFilePath || !subtitleFiles || !count) return FALSE;
+    
+    *subtitleFiles = NULL;
+    *count = 0;
+    
+    // Split the path into its directory and file name
+    const wchar_t* fileName = GetCachePathFileName(videoFilePath);
+    size_t directoryLength = (size_t)(fileName - videoFilePath);
+    if (directoryLength < 2 || directoryLength >= MAX_EXTENDED_PATH || !*fileName) return FALSE;
+    
+    wchar_t directory[MAX_EXTENDED_PATH];
+    wcsncpy(directory, videoFilePath, directoryLength - 1);
+    directory[directoryLength - 1] = L'\0';
+    
+    // Every sibling starts with the base name and a dot
+    const wchar_t* lastDot = wcsrchr(fileName, L'.');
+    int baseLength = lastDot ? (int)(lastDot - fileName) : (int)wcslen(fileName);
+    wchar_t pattern[MAX_EXTENDED_PATH];
+    swprintf(pattern, MAX_EXTENDED_PATH, L"%.*ls.*", baseLength, fileName);
+    
+    CacheDirectoryListing listing;
+    if (!InitCacheDirectoryListing(&listing)) return FALSE;
+    
+    DWORD error = ERROR_SUCCESS;
+    if (ReadCacheDirectoryListing(directory, pattern, &listing, &error)) {
+        CacheDirectoryMatch match;
+        MatchCacheDirectoryFile(&listing, fileName, &match);
+        *count = CollectSubtitleSiblings(directory, &listing, &match, subtitleFiles);
+    } else if (error != ERROR_PATH_NOT_FOUND) {
+        // Only report errors other than a missing folder for subtitle search
+        ErrorContext* ctx = CREATE_ERROR_CONTEXT(YTC_ERROR_FILE_ACCESS, YTC_SEVERITY_INFO);
+        if (ctx) {
+            AddContextVariable(ctx, L"FilePath", videoFilePath);
+            AddContextVariable(ctx, L"Operation", L"Search for subtitle files");
+            SetUserFriendlyMessage(ctx, L"Error occurred while searching for subtitle files.\r\nSome subtitle files may not be detected.");
+            FreeErrorContext(ctx);
+        }
+    }
+    
+    FreeCacheDirectoryListing(&listing);
+    return *count > 0;
 }
 
 // Format file size for display
-wchar_t* FormatFileSize(DWORD sizeBytes) {
+wchar_t* FormatFileSize(ULONGLONG sizeBytes) {
     wchar_t* result = (wchar_t*)SAFE_MALLOC(32 * sizeof(wchar_t));
     if (!result) return NULL;
     
     if (sizeBytes < 1024) {
-        swprintf(result, 32, L"%lu B", sizeBytes);
+        swprintf(result, 32, L"%llu B", sizeBytes);
     } else if (sizeBytes < 1024 * 1024) {
         swprintf(result, 32, L"%.1f KB", sizeBytes / 1024.0);
     } else if (sizeBytes < 1024 * 1024 * 1024) {
         swprintf(result, 32, L"%.1f MB", sizeBytes / (1024.0 * 1024.0));
-    } else {
+    } else if (sizeBytes < 1024ULL * 1024 * 1024 * 1024) {
         swprintf(result, 32, L"%.1f GB", sizeBytes / (1024.0 * 1024.0 * 1024.0));
+    } else {
+        swprintf(result, 32, L"%.1f TB", sizeBytes / (1024.0 * 1024.0 * 1024.0 * 1024.0));
     }
     
     return result;
@@ -1513,78 +3844,487 @@ BOOL AddDummyVideo(CacheManager* manager, const wchar_t* downloadPath) {
             CloseHandle(hVtt);
         }
     }
-    
-    // Add to cache
-    BOOL result = AddCacheEntry(manager, videoId, title, duration, fullPath, subtitleFiles, 2);
-    
-    // Clean up
-    if (subtitleFiles) {
-        if (subtitleFiles[0]) SAFE_FREE(subtitleFiles[0]);
-        if (subtitleFiles[1]) SAFE_FREE(subtitleFiles[1]);
-        SAFE_FREE(subtitleFiles);
+    
+    // Add to cache
+    BOOL result = AddCacheEntry(manager, videoId, title, duration, fullPath, subtitleFiles, 2);
+    
+    // Clean up
+    if (subtitleFiles) {
+        if (subtitleFiles[0]) SAFE_FREE(subtitleFiles[0]);
+        if (subtitleFiles[1]) SAFE_FREE(subtitleFiles[1]);
+        SAFE_FREE(subtitleFiles);
+    }
+    
+    dummyCounter++;
+    return result;
+}
+
+// A video a folder scan found that the cache does not know yet
+typedef struct {
+    wchar_t videoId[CACHE_VIDEO_ID_LENGTH + 1];
+    wchar_t* filePath;
+    wchar_t* infoPath;          // Info JSON written with the download, or NULL
+    wchar_t** subtitleFiles;
+    int subtitleCount;
+    ULONGLONG fileSize;
+    ULONGLONG writeTime;
+    CacheInfo info;             // Read from infoPath by the recovery threads
+} CacheRecoveryItem;
+
+// The new videos of one scan, added together once their info JSON is read
+typedef struct {
+    CacheManager* manager;
+    CRITICAL_SECTION lock;      // Guards items while the listing threads collect them
+    CacheRecoveryItem* items;
+    LONG count;
+    LONG capacity;
+    volatile LONG next;         // First item not yet claimed by a reader thread
+} CacheRecoveryList;
+
+static void InitCacheRecoveryList(CacheRecoveryList* list, CacheManager* manager) {
+    memset(list, 0, sizeof(CacheRecoveryList));
+    list->manager = manager;
+    InitializeCriticalSection(&list->lock);
+}
+
+static void FreeCacheRecoveryList(CacheRecoveryList* list) {
+    for (LONG i = 0; i < list->count; i++) {
+        CacheRecoveryItem* item = &list->items[i];
+        if (item->filePath) SAFE_FREE(item->filePath);
+        if (item->infoPath) SAFE_FREE(item->infoPath);
+        FreeSubtitleFileList(item->subtitleFiles, item->subtitleCount);
+        FreeCacheInfo(&item->info);
+    }
+    if (list->items) SAFE_FREE(list->items);
+    list->items = NULL;
+    list->count = 0;
+    list->capacity = 0;
+    DeleteCriticalSection(&list->lock);
+}
+
+static wchar_t* JoinCacheFilePath(const wchar_t* directory, const wchar_t* name) {
+    size_t length = wcslen(directory) + wcslen(name) + 2;
+    wchar_t* path = (wchar_t*)SAFE_MALLOC(length * sizeof(wchar_t));
+    if (path) swprintf(path, length, L"%ls\\%ls", directory, name);
+    return path;
+}
+
+// Collect a new video with its subtitles and info JSON from a listing; any
+// listing thread of a scan may add to the list
+static void AddCacheRecoveryItem(CacheRecoveryList* list, const wchar_t* videoId, const wchar_t* directory,
+                                 const CacheDirectoryListing* listing, const CacheDirectoryFile* file,
+                                 const CacheDirectoryMatch* match) {
+    CacheRecoveryItem item;
+    memset(&item, 0, sizeof(CacheRecoveryItem));
+    wcsncpy(item.videoId, videoId, CACHE_VIDEO_ID_LENGTH);
+    item.videoId[CACHE_VIDEO_ID_LENGTH] = L'\0';
+    item.filePath = JoinCacheFilePath(directory, file->name);
+    if (!item.filePath) return;
+    
+    item.infoPath = match->infoFile ? JoinCacheFilePath(directory, match->infoFile->name) : NULL;
+    item.subtitleCount = CollectSubtitleSiblings(directory, listing, match, &item.subtitleFiles);
+    item.fileSize = file->size;
+    item.writeTime = file->writeTime;
+    
+    EnterCriticalSection(&list->lock);
+    if (list->count == list->capacity) {
+        LONG capacity = list->capacity ? list->capacity * 2 : CACHE_LISTING_MIN_CAPACITY;
+        CacheRecoveryItem* items = (CacheRecoveryItem*)SAFE_REALLOC(list->items, (size_t)capacity * sizeof(CacheRecoveryItem));
+        if (items) {
+            list->items = items;
+            list->capacity = capacity;
+        }
+    }
+    BOOL added = list->count < list->capacity;
+    if (added) list->items[list->count++] = item;
+    LeaveCriticalSection(&list->lock);
+    
+    if (!added) {
+        SAFE_FREE(item.filePath);
+        if (item.infoPath) SAFE_FREE(item.infoPath);
+        FreeSubtitleFileList(item.subtitleFiles, item.subtitleCount);
+    }
+}
+
+// Reader thread: claim videos and read their info JSON until none are left
+static DWORD WINAPI CacheRecoveryWorker(LPVOID param) {
+    CacheRecoveryList* list = (CacheRecoveryList*)param;
+    
+    while (!list->manager->bShuttingDown) {
+        LONG index = InterlockedIncrement(&list->next) - 1;
+        if (index >= list->count) break;
+        
+        CacheRecoveryItem* item = &list->items[index];
+        if (item->infoPath && !ReadCacheInfoFile(item->infoPath, &item->info)) {
+            ThreadSafeDebugOutputF(L"YouTubeCacher: CacheRecoveryWorker - No metadata in %ls", item->infoPath);
+        } else if (item->info.id && wcscmp(item->info.id, item->videoId) != 0) {
+            // The file is named for another video than the one it describes; its title would mislabel this one
+            ThreadSafeDebugOutputF(L"YouTubeCacher: CacheRecoveryWorker - Ignoring %ls, which is for video %ls, not %ls",
+                                  item->infoPath, item->info.id, item->videoId);
+            FreeCacheInfo(&item->info);
+        }
+    }
+    return 0;
+}
+
+// Turn a recovered video into an entry, taking over its paths. The title and
+// duration come from the info JSON when it has them and is for this video.
+static CacheEntry* CreateRecoveredCacheEntry(CacheRecoveryItem* item) {
+    CacheEntry* entry = (CacheEntry*)SAFE_MALLOC(sizeof(CacheEntry));
+    if (!entry) return NULL;
+    memset(entry, 0, sizeof(CacheEntry));
+    
+    wchar_t duration[64] = L"Unknown";
+    if (item->info.duration >= 1) {
+        swprintf(duration, 64, L"%lld", (long long)item->info.duration);
+        FormatDuration(duration, 64);
+    }
+    
+    entry->videoId = SAFE_WCSDUP(item->videoId);
+    entry->title = SAFE_WCSDUP(item->info.title ? item->info.title : GetCachePathFileName(item->filePath));
+    entry->duration = SAFE_WCSDUP(duration);
+    if (!entry->videoId || !entry->title || !entry->duration) {
+        FreeCacheEntry(entry);
+        return NULL;
+    }
+    
+    entry->mainVideoFile = item->filePath;
+    entry->subtitleFiles = item->subtitleFiles;
+    entry->subtitleCount = item->subtitleCount;
+    item->filePath = NULL;
+    item->subtitleFiles = NULL;
+    item->subtitleCount = 0;
+    
+    entry->fileSize = item->fileSize;
+    entry->downloadTime.dwHighDateTime = (DWORD)(item->writeTime >> 32);
+    entry->downloadTime.dwLowDateTime = (DWORD)item->writeTime;
+    return entry;
+}
+
+// Add the videos a scan found: their info JSON files are read on a pool of
+// threads, which is most of the work when a lost index is rebuilt, and the
+// entries are then linked a batch at a time under the lock
+static void AddRecoveredVideos(CacheManager* manager, CacheRecoveryList* list) {
+    if (list->count == 0) return;
+    
+    LONG infoCount = 0;
+    for (LONG i = 0; i < list->count; i++) {
+        if (list->items[i].infoPath) infoCount++;
+    }
+    
+    // A few files are read on this thread alone; more get helpers as well
+    DWORD helperCount = (DWORD)(infoCount / CACHE_RECOVERY_FILES_PER_WORKER);
+    if (helperCount > CACHE_STAT_DEFAULT_WORKERS - 1) helperCount = CACHE_STAT_DEFAULT_WORKERS - 1;
+    HANDLE helpers[CACHE_STAT_DEFAULT_WORKERS];
+    DWORD started = 0;
+    for (DWORD i = 0; i < helperCount; i++) {
+        helpers[started] = CreateThread(NULL, 0, CacheRecoveryWorker, list, 0, NULL);
+        if (helpers[started]) started++;
+    }
+    CacheRecoveryWorker(list);
+    if (started > 0) {
+        WaitForMultipleObjects(started, helpers, TRUE, INFINITE);
+        for (DWORD i = 0; i < started; i++) {
+            CloseHandle(helpers[i]);
+        }
+    }
+    if (manager->bShuttingDown) return;
+    
+    LONG added = 0;
+    for (LONG first = 0; first < list->count; first += CACHE_STAT_BATCH_SIZE) {
+        LONG last = first + CACHE_STAT_BATCH_SIZE < list->count ? first + CACHE_STAT_BATCH_SIZE : list->count;
+        
+        EnterCriticalSection(&manager->lock);
+        for (LONG i = first; i < last; i++) {
+            CacheEntry* entry = CreateRecoveredCacheEntry(&list->items[i]);
+            if (!entry) continue;
+            
+            // The same video found twice keeps its first copy
+            if (!LinkCacheEntry(manager, entry, NULL)) {
+                FreeCacheEntry(entry);
+                continue;
+            }
+            
+            // Found on disk counts as the download, the first access; this also journals the entry
+            RecordCacheEntryAccess(manager, entry);
+            added++;
+        }
+        LeaveCacheLock(manager);
+    }
+    
+    ThreadSafeDebugOutputF(L"YouTubeCacher: AddRecoveredVideos - Added %ld of %ld videos found, %ld with info JSON, on %lu threads",
+                          added, list->count, infoCount, started + 1);
+    
+    if (added > 0) {
+        SaveCacheToFile(manager);
+        WakeCacheEviction(manager);
+    }
+}
+
+// Bring the cache in line with one video file of a directory listing. A video
+// the cache does not know is collected in the recovery list. With reconcile set, an entry already
+// pointing at the file gets its size and subtitles refreshed, and an entry
+// whose own file is gone follows the video here; otherwise cached videos are
+// left as they are.
+static void ReconcileCacheVideoFile(CacheManager* manager, const wchar_t* directory,
+                                    const CacheDirectoryListing* listing, const CacheDirectoryFile* file,
+                                    const wchar_t* videoId, BOOL reconcile, CacheRecoveryList* recovered) {
+    wchar_t fullPath[MAX_EXTENDED_PATH];
+    swprintf(fullPath, MAX_EXTENDED_PATH, L"%ls\\%ls", directory, file->name);
+    
+    EnterCriticalSection(&manager->lock);
+    CacheEntry* entry = FindCacheEntry(manager, videoId);
+    BOOL cached = entry != NULL;
+    BOOL here = entry && entry->mainVideoFile && _wcsicmp(entry->mainVideoFile, fullPath) == 0;
+    BOOL moved = entry && !here && entry->fileMissing;
+    wchar_t* otherPath = entry && !here && !moved && reconcile && entry->mainVideoFile ?
+                         SAFE_WCSDUP(entry->mainVideoFile) : NULL;
+    LeaveCacheLock(manager);
+    
+    if (cached && !reconcile) return;
+    
+    // Another copy of a cached video only takes over once the entry's own file is gone
+    if (otherPath) {
+        moved = !SafeFileExists(otherPath);
+        SAFE_FREE(otherPath);
+    }
+    if (cached && !here && !moved) return;
+    
+    // Subtitles and the info JSON are the video's siblings in the same listing
+    CacheDirectoryMatch match;
+    MatchCacheDirectoryFile(listing, file->name, &match);
+    if (!cached) {
+        AddCacheRecoveryItem(recovered, videoId, directory, listing, file, &match);
+        return;
+    }
+    
+    wchar_t** subtitleFiles = NULL;
+    int subtitleCount = CollectSubtitleSiblings(directory, listing, &match, &subtitleFiles);
+    
+    FILETIME modTime;
+    modTime.dwHighDateTime = (DWORD)(file->writeTime >> 32);
+    modTime.dwLowDateTime = (DWORD)file->writeTime;
+    
+    BOOL journaled = FALSE;
+    EnterCriticalSection(&manager->lock);
+    entry = FindCacheEntry(manager, videoId);
+    if (entry) {
+        BOOL filesChanged = SetCacheEntryFiles(entry, fullPath, subtitleFiles, subtitleCount);
+        DWORD types = SetCacheEntryFileState(manager, entry, TRUE, file->size, modTime);
+        journaled = filesChanged || (types & CACHE_CHANGE_SIZE);
+        if (filesChanged) {
+            if (!(types & CACHE_CHANGE_SIZE)) QueueCacheJournalPut(manager, entry);
+            types |= CACHE_CHANGE_METADATA;
+        }
+        if (types) NotifyCacheChange(manager, entry->videoId, types);
+    }
+    LeaveCacheLock(manager);
+    
+    FreeSubtitleFileList(subtitleFiles, subtitleCount);
+    if (journaled) SaveCacheToFile(manager);
+}
+
+// Directories of one tree scan, listed by a pool of threads: each thread takes
+// a queued directory, queues the directories below it and reconciles its videos
+typedef struct {
+    CacheManager* manager;
+    BOOL reconcile;
+    CacheRecoveryList* recovered;
+    CRITICAL_SECTION lock;      // Guards pending and busy
+    HANDLE hWorkEvent;          // Set while a directory is queued, and once the walk is done
+    wchar_t** pending;          // Directories not yet claimed by a thread
+    DWORD pendingCount;
+    DWORD pendingCapacity;
+    DWORD busy;                 // Threads listing a directory, which may queue more
+} CacheTreeScan;
+
+static void QueueCacheTreeDirectory(CacheTreeScan* scan, const wchar_t* directory, const wchar_t* name) {
+    wchar_t* path = name ? JoinCacheFilePath(directory, name) : SAFE_WCSDUP(directory);
+    if (!path) return;
+    
+    EnterCriticalSection(&scan->lock);
+    if (scan->pendingCount == scan->pendingCapacity) {
+        DWORD capacity = scan->pendingCapacity ? scan->pendingCapacity * 2 : CACHE_LISTING_MIN_CAPACITY;
+        wchar_t** pending = (wchar_t**)SAFE_REALLOC(scan->pending, capacity * sizeof(wchar_t*));
+        if (pending) {
+            scan->pending = pending;
+            scan->pendingCapacity = capacity;
+        }
+    }
+    if (scan->pendingCount < scan->pendingCapacity) {
+        scan->pending[scan->pendingCount++] = path;
+        path = NULL;
+        if (scan->hWorkEvent) SetEvent(scan->hWorkEvent);
+    }
+    LeaveCriticalSection(&scan->lock);
+    
+    if (path) SAFE_FREE(path);
+}
+
+// List one directory of a tree scan: its subdirectories are queued, and its
+// videos reconciled against the listing
+static void ScanCacheTreeDirectory(CacheTreeScan* scan, const wchar_t* directory) {
+    CacheManager* manager = scan->manager;
+    CacheDirectoryListing listing;
+    if (!InitCacheDirectoryListing(&listing)) return;
+    
+    if (ReadCacheDirectoryListing(directory, L"*", &listing, NULL)) {
+        for (DWORD i = 0; i < listing.count && !manager->bShuttingDown; i++) {
+            const CacheDirectoryFile* file = &listing.files[i];
+            if (file->directory) {
+                if (wcslen(directory) + wcslen(file->name) + 2 <= MAX_EXTENDED_PATH) {
+                    QueueCacheTreeDirectory(scan, directory, file->name);
+                }
+                continue;
+            }
+            
+            // Any video container, named by the app ("<id>.<ext>") or by yt-dlp's default ("<title> [<id>].<ext>")
+            wchar_t videoId[CACHE_VIDEO_ID_LENGTH + 1];
+            if (ClassifyCacheFileName(file->name, videoId) != CACHE_FILE_VIDEO) continue;
+            
+            ReconcileCacheVideoFile(manager, directory, &listing, file, videoId, scan->reconcile, scan->recovered);
+        }
+    }
+    
+    FreeCacheDirectoryListing(&listing);
+}
+
+// Tree scan thread: list queued directories until none are queued and none
+// are being listed, or the cache manager is cleaned up
+static DWORD WINAPI CacheTreeScanWorker(LPVOID param) {
+    CacheTreeScan* scan = (CacheTreeScan*)param;
+    CacheManager* manager = scan->manager;
+    
+    for (;;) {
+        EnterCriticalSection(&scan->lock);
+        while (scan->pendingCount == 0 && scan->busy > 0 && !manager->bShuttingDown) {
+            // Another thread's listing may still queue directories
+            ResetEvent(scan->hWorkEvent);
+            LeaveCriticalSection(&scan->lock);
+            WaitForSingleObject(scan->hWorkEvent, INFINITE);
+            EnterCriticalSection(&scan->lock);
+        }
+        if (scan->pendingCount == 0 || manager->bShuttingDown) {
+            LeaveCriticalSection(&scan->lock);
+            return 0;
+        }
+        wchar_t* directory = scan->pending[--scan->pendingCount];
+        scan->busy++;
+        LeaveCriticalSection(&scan->lock);
+        
+        ScanCacheTreeDirectory(scan, directory);
+        SAFE_FREE(directory);
+        
+        EnterCriticalSection(&scan->lock);
+        scan->busy--;
+        if ((scan->busy == 0 && scan->pendingCount == 0) || manager->bShuttingDown) {
+            if (scan->hWorkEvent) SetEvent(scan->hWorkEvent);
+        }
+        LeaveCriticalSection(&scan->lock);
+    }
+}
+
+// Collect the new videos in a directory, and in the directories below it, from
+// one listing per directory. The top directory is listed on this thread; the
+// directories it holds are then shared with helper threads, as a deep tree is
+// mostly time spent waiting on the disk. With reconcile set the videos already
+// cached are reconciled as well (see ReconcileCacheVideoFile).
+static void ScanCacheDirectory(CacheManager* manager, const wchar_t* directory, BOOL reconcile,
+                               CacheRecoveryList* recovered) {
+    CacheTreeScan scan;
+    memset(&scan, 0, sizeof(CacheTreeScan));
+    scan.manager = manager;
+    scan.reconcile = reconcile;
+    scan.recovered = recovered;
+    InitializeCriticalSection(&scan.lock);
+    
+    ScanCacheTreeDirectory(&scan, directory);
+    
+    // One helper for every directory found, up to the pool size; without the
+    // event this thread lists them alone
+    DWORD helperCount = scan.pendingCount < CACHE_STAT_DEFAULT_WORKERS - 1 ? scan.pendingCount : CACHE_STAT_DEFAULT_WORKERS - 1;
+    if (helperCount > 0) scan.hWorkEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+    if (!scan.hWorkEvent) helperCount = 0;
+    HANDLE helpers[CACHE_STAT_DEFAULT_WORKERS];
+    DWORD started = 0;
+    for (DWORD i = 0; i < helperCount; i++) {
+        helpers[started] = CreateThread(NULL, 0, CacheTreeScanWorker, &scan, 0, NULL);
+        if (helpers[started]) started++;
+    }
+    CacheTreeScanWorker(&scan);
+    if (started > 0) {
+        WaitForMultipleObjects(started, helpers, TRUE, INFINITE);
+        for (DWORD i = 0; i < started; i++) {
+            CloseHandle(helpers[i]);
+        }
     }
     
-    dummyCounter++;
-    return result;
+    // Directories left unlisted by a shutdown
+    for (DWORD i = 0; i < scan.pendingCount; i++) {
+        SAFE_FREE(scan.pending[i]);
+    }
+    if (scan.pending) SAFE_FREE(scan.pending);
+    if (scan.hWorkEvent) CloseHandle(scan.hWorkEvent);
+    DeleteCriticalSection(&scan.lock);
 }
 
-// Scan download folder for existing videos (for initial cache population)
+// Scan the download folder tree for videos the cache does not know yet (for
+// initial cache population); videos already in the cache are kept as they are.
+// The info JSON saved with each download restores its title and duration, so
+// a lost or damaged index is rebuilt with its metadata.
 BOOL ScanDownloadFolderForVideos(CacheManager* manager, const wchar_t* downloadPath) {
     if (!manager || !downloadPath) return FALSE;
     
-    wchar_t searchPattern[MAX_EXTENDED_PATH];
-    swprintf(searchPattern, MAX_EXTENDED_PATH, L"%ls\\*.mp4", downloadPath);
-    
-    WIN32_FIND_DATAW findData;
-    HANDLE hFind = FindFirstFileW(searchPattern, &findData);
+    CacheRecoveryList recovered;
+    InitCacheRecoveryList(&recovered, manager);
+    ScanCacheDirectory(manager, downloadPath, FALSE, &recovered);
+    AddRecoveredVideos(manager, &recovered);
+    FreeCacheRecoveryList(&recovered);
+    return TRUE;
+}
+
+// What the startup scan thread hands on once the folder is scanned
+typedef struct {
+    CacheManager* manager;
+    HWND hMainWindow;
+    DWORD statThreads;
+} CacheStartupScanData;
+
+static DWORD WINAPI CacheStartupScanThread(LPVOID param) {
+    CacheStartupScanData* data = (CacheStartupScanData*)param;
+    CacheManager* manager = data->manager;
     
-    if (hFind == INVALID_HANDLE_VALUE) {
-        return TRUE; // No files found, but that's okay
+    ScanDownloadFolderForVideos(manager, manager->downloadRoot);
+    if (!manager->bShuttingDown) {
+        PostMessage(data->hMainWindow, WM_CACHE_SCAN_PROGRESS, 0, 0);
+        StartFileSizeUpdateThread(manager, data->hMainWindow, data->statThreads);
+        StartCacheWatcher(manager);
     }
     
-    do {
-        if (!(findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
-            wchar_t fullPath[MAX_EXTENDED_PATH];
-            swprintf(fullPath, MAX_EXTENDED_PATH, L"%ls\\%ls", downloadPath, findData.cFileName);
-            
-            // Try to extract video ID from filename (if it follows yt-dlp naming)
-            wchar_t* videoId = NULL;
-            wchar_t* bracket = wcschr(findData.cFileName, L'[');
-            if (bracket) {
-                wchar_t* closeBracket = wcschr(bracket, L']');
-                if (closeBracket && (closeBracket - bracket) == 12) {
-                    videoId = (wchar_t*)SAFE_MALLOC(12 * sizeof(wchar_t));
-                    if (videoId) {
-                        wcsncpy(videoId, bracket + 1, 11);
-                        videoId[11] = L'\0';
-                    }
-                }
-            }
-            
-            if (videoId) {
-                // Find subtitle files
-                wchar_t** subtitleFiles = NULL;
-                int subtitleCount = 0;
-                FindSubtitleFiles(fullPath, &subtitleFiles, &subtitleCount);
-                
-                // Add to cache (title and duration will be unknown)
-                AddCacheEntry(manager, videoId, findData.cFileName, L"Unknown", 
-                             fullPath, subtitleFiles, subtitleCount);
-                
-                // Clean up
-                if (subtitleFiles) {
-                    for (int i = 0; i < subtitleCount; i++) {
-                        if (subtitleFiles[i]) SAFE_FREE(subtitleFiles[i]);
-                    }
-                    SAFE_FREE(subtitleFiles);
-                }
-                
-                SAFE_FREE(videoId);
-            }
-        }
-    } while (FindNextFileW(hFind, &findData));
+    SAFE_FREE(data);
+    return 0;
+}
+
+// Scan the download folder for videos the cache does not know on a background
+// thread, so the window is up while a large tree is listed. The videos found
+// reach hMainWindow through its change listener, which must be set first.
+// Once the folder is scanned the file size scan runs on statThreads threads
+// (0 for the default) and the folder watch starts; until then this thread is
+// the only one that starts them.
+BOOL StartCacheFolderScan(CacheManager* manager, HWND hMainWindow, DWORD statThreads) {
+    if (!manager || !manager->downloadRoot || !hMainWindow || manager->hScanThread) return FALSE;
+    
+    CacheStartupScanData* data = (CacheStartupScanData*)SAFE_MALLOC(sizeof(CacheStartupScanData));
+    if (!data) return FALSE;
+    data->manager = manager;
+    data->hMainWindow = hMainWindow;
+    data->statThreads = statThreads;
     
-    FindClose(hFind);
+    manager->hScanThread = CreateThread(NULL, 0, CacheStartupScanThread, data, 0, NULL);
+    if (!manager->hScanThread) {
+        SAFE_FREE(data);
+        return FALSE;
+    }
     return TRUE;
 }
 
@@ -1597,27 +4337,41 @@ void UpdateCacheListStatus(HWND hDlg, CacheManager* manager) {
     wchar_t statusText[256];
     wchar_t itemsText[64];
     
-    EnterCriticalSection(&manager->lock);
+    // Running totals, so a writer's batch or a save never holds up the labels
+    CacheStats stats;
+    GetCacheStats(manager, &stats);
     
-    // Calculate total size
-    DWORD totalSize = 0;
-    CacheEntry* current = manager->entries;
-    while (current) {
-        if (ValidateCacheEntry(current)) {
-            totalSize += current->fileSize;
-        }
-        current = current->next;
+    // Format status text, with the progress of a running file size scan
+    wchar_t* sizeStr = FormatFileSize(stats.totalBytes);
+    if (manager->sizeScanTotal > 0) {
+        swprintf(statusText, 256, L"Status: Checking files (%ld of %ld) - Total size: %ls",
+                 manager->sizeScanDone, manager->sizeScanTotal, sizeStr ? sizeStr : L"0 B");
+    } else {
+        swprintf(statusText, 256, L"Status: Ready - Total size: %ls", sizeStr ? sizeStr : L"0 B");
     }
-    
-    // Format status text
-    wchar_t* sizeStr = FormatFileSize(totalSize);
-    swprintf(statusText, 256, L"Status: Ready - Total size: %ls", sizeStr ? sizeStr : L"0 B");
     if (sizeStr) SAFE_FREE(sizeStr);
     
-    // Format items count
-    swprintf(itemsText, 64, L"Items: %d", manager->totalEntries);
+    // Videos kept from an earlier download folder count towards the total too
+    if (stats.totalBytes > stats.rootBytes) {
+        wchar_t* outsideStr = FormatFileSize(stats.totalBytes - stats.rootBytes);
+        size_t length = wcslen(statusText);
+        swprintf(statusText + length, 256 - length, L" (%ls outside the download folder)", outsideStr ? outsideStr : L"0 B");
+        if (outsideStr) SAFE_FREE(outsideStr);
+    }
     
-    LeaveCriticalSection(&manager->lock);
+    // Format items count; a filtered list also shows how many entries it lists
+    CacheViewSnapshot* shown = manager->listFilter ? GetCacheListSnapshot(GetDlgItem(hDlg, IDC_LIST)) : NULL;
+    if (shown) {
+        swprintf(itemsText, 64, L"Items: %lu of %lu", (unsigned long)shown->count, (unsigned long)stats.entries);
+    } else {
+        swprintf(itemsText, 64, L"Items: %lu", (unsigned long)stats.entries);
+    }
+    
+    // Entries whose file is gone are counted but not listed
+    if (stats.missingEntries > 0) {
+        size_t length = wcslen(itemsText);
+        swprintf(itemsText + length, 64 - length, L" (%lu missing)", (unsigned long)stats.missingEntries);
+    }
     
     // Update UI labels
     SetDlgItemTextW(hDlg, IDC_LABEL2, statusText);
@@ -1628,9 +4382,136 @@ void UpdateCacheListStatus(HWND hDlg, CacheManager* manager) {
 typedef struct {
     CacheManager* manager;
     HWND hMainWindow;
+    DWORD workerCount;
 } FileSizeWorkerData;
 
-// Worker thread function to populate file sizes for cache entries
+// One entry whose file is checked by the scan
+typedef struct {
+    wchar_t* videoId;
+    wchar_t* filePath;
+    const wchar_t* fileName;    // Points into filePath
+    size_t directoryLength;     // Characters of filePath before the separator
+    ULONGLONG fileSize;
+    FILETIME modTime;
+    BOOL checked;               // The directory was read, so found is known
+    BOOL found;
+} FileSizeUpdate;
+
+// A run of updates whose files share a directory
+typedef struct {
+    LONG first;
+    LONG last;
+} FileSizeDirectory;
+
+// State shared by the I/O threads of one scan
+typedef struct {
+    CacheManager* manager;
+    HWND hMainWindow;
+    FileSizeUpdate* updates;    // Grouped by directory
+    LONG count;
+    FileSizeDirectory* directories;
+    LONG directoryCount;
+    volatile LONG nextDirectory; // First directory not yet claimed by a thread
+} FileSizeScan;
+
+// Order updates by directory, ignoring case, so each directory is one run
+static int CompareFileSizeUpdateDirectories(const void* a, const void* b) {
+    const FileSizeUpdate* left = (const FileSizeUpdate*)a;
+    const FileSizeUpdate* right = (const FileSizeUpdate*)b;
+    size_t length = left->directoryLength < right->directoryLength ? left->directoryLength : right->directoryLength;
+    int result = _wcsnicmp(left->filePath, right->filePath, length);
+    if (result != 0) return result;
+    if (left->directoryLength != right->directoryLength) return left->directoryLength < right->directoryLength ? -1 : 1;
+    return 0;
+}
+
+// Apply the results of one batch under a single lock and report progress
+static void ApplyFileSizeBatch(FileSizeScan* scan, LONG first, LONG last) {
+    CacheManager* manager = scan->manager;
+    BOOL anyUpdated = FALSE;
+    
+    EnterCriticalSection(&manager->lock);
+    for (LONG i = first; i < last; i++) {
+        FileSizeUpdate* update = &scan->updates[i];
+        if (!update->checked) continue;
+        
+        // Re-find the entry as it might have moved or been removed
+        CacheEntry* entry = FindCacheEntry(manager, update->videoId);
+        if (!entry) continue;
+        
+        DWORD types = SetCacheEntryFileState(manager, entry, update->found, update->fileSize, update->modTime);
+        if (types & CACHE_CHANGE_SIZE) anyUpdated = TRUE;
+        if (types) NotifyCacheChange(manager, entry->videoId, types);
+    }
+    manager->sizeScanDone += last - first;
+    LeaveCacheLock(manager);
+    
+    // The listener is notified per entry through the change queue; the progress
+    // message covers batches where nothing changed
+    if (anyUpdated) {
+        SaveCacheToFile(manager);
+    }
+    PostMessage(scan->hMainWindow, WM_CACHE_SCAN_PROGRESS, 0, 0);
+}
+
+// List one directory and match its updates against the listing. When the
+// directory is gone its files are missing; when it cannot be read for another
+// reason its entries are left as they are.
+static void ReconcileFileSizeDirectory(FileSizeScan* scan, const FileSizeDirectory* group) {
+    const FileSizeUpdate* sample = &scan->updates[group->first];
+    wchar_t directory[MAX_EXTENDED_PATH];
+    wcsncpy(directory, sample->filePath, sample->directoryLength);
+    directory[sample->directoryLength] = L'\0';
+    
+    CacheDirectoryListing listing;
+    DWORD error = ERROR_SUCCESS;
+    BOOL listed = InitCacheDirectoryListing(&listing) &&
+                  ReadCacheDirectoryListing(directory, L"*", &listing, &error);
+    BOOL directoryMissing = !listed && error == ERROR_PATH_NOT_FOUND;
+    
+    for (LONG i = group->first; i < group->last; i++) {
+        FileSizeUpdate* update = &scan->updates[i];
+        const CacheDirectoryFile* file = listed ? FindCacheDirectoryFile(&listing, update->fileName) : NULL;
+        if (file && file->directory) file = NULL;
+        update->checked = listed || directoryMissing;
+        update->found = file != NULL;
+        if (file) {
+            update->fileSize = file->size;
+            update->modTime.dwHighDateTime = (DWORD)(file->writeTime >> 32);
+            update->modTime.dwLowDateTime = (DWORD)file->writeTime;
+        }
+    }
+    FreeCacheDirectoryListing(&listing);
+    
+    if (!listed && !directoryMissing) {
+        ThreadSafeDebugOutputF(L"YouTubeCacher: ReconcileFileSizeDirectory - Cannot list %ls (error %lu)",
+                              directory, error);
+    }
+    
+    // Apply in batches so progress keeps moving through a large directory
+    for (LONG first = group->first; first < group->last && !scan->manager->bShuttingDown; first += CACHE_STAT_BATCH_SIZE) {
+        LONG last = first + CACHE_STAT_BATCH_SIZE < group->last ? first + CACHE_STAT_BATCH_SIZE : group->last;
+        ApplyFileSizeBatch(scan, first, last);
+    }
+}
+
+// I/O thread: claim directories and reconcile them until none are left or the
+// cache is shutting down
+static DWORD WINAPI FileSizeStatWorker(LPVOID param) {
+    FileSizeScan* scan = (FileSizeScan*)param;
+    CacheManager* manager = scan->manager;
+    
+    while (!manager->bShuttingDown) {
+        LONG index = InterlockedIncrement(&scan->nextDirectory) - 1;
+        if (index >= scan->directoryCount) break;
+        
+        ReconcileFileSizeDirectory(scan, &scan->directories[index]);
+    }
+    return 0;
+}
+
+// Coordinator thread: collect every entry, group the entries by directory,
+// fan the directory listings out over the I/O threads and wait for them
 static DWORD WINAPI UpdateFileSizesWorker(LPVOID param) {
     FileSizeWorkerData* data = (FileSizeWorkerData*)param;
     if (!data || !data->manager || !data->hMainWindow) {
@@ -1639,127 +4520,367 @@ static DWORD WINAPI UpdateFileSizesWorker(LPVOID param) {
     }
     
     CacheManager* manager = data->manager;
-    HWND hMainWindow = data->hMainWindow;
-    
-    // Define a structure to hold pending updates
-    typedef struct {
-        wchar_t* videoId;
-        wchar_t* filePath;
-        DWORD fileSize;
-        FILETIME modTime;
-        BOOL success;
-    } PendingUpdate;
-
-    PendingUpdate* updates = NULL;
-    int pendingCount = 0;
-    int totalCapacity = 0;
-
-    // Step 1: Collect entries that need updates while holding the lock briefly
+    FileSizeScan scan;
+    memset(&scan, 0, sizeof(scan));
+    scan.manager = manager;
+    scan.hMainWindow = data->hMainWindow;
+    
+    // Step 1: Collect the entries while holding the lock briefly
     EnterCriticalSection(&manager->lock);
-    totalCapacity = manager->totalEntries;
+    LONG totalCapacity = manager->totalEntries;
     if (totalCapacity > 0) {
-        updates = (PendingUpdate*)SAFE_MALLOC(totalCapacity * sizeof(PendingUpdate));
-        if (updates) {
+        scan.updates = (FileSizeUpdate*)SAFE_MALLOC(totalCapacity * sizeof(FileSizeUpdate));
+        if (scan.updates) {
             CacheEntry* current = manager->entries;
-            while (current && pendingCount < totalCapacity) {
-                // Only collect if fileSize is 0 (not yet populated)
-                if (current->fileSize == 0 && current->mainVideoFile && current->videoId) {
-                    wchar_t* vId = SAFE_WCSDUP(current->videoId);
-                    wchar_t* fPath = SAFE_WCSDUP(current->mainVideoFile);
-
-                    if (vId && fPath) {
-                        updates[pendingCount].videoId = vId;
-                        updates[pendingCount].filePath = fPath;
-                        updates[pendingCount].success = FALSE;
-                        pendingCount++;
+            while (current && scan.count < totalCapacity) {
+                if (current->mainVideoFile && current->videoId) {
+                    FileSizeUpdate* update = &scan.updates[scan.count];
+                    memset(update, 0, sizeof(FileSizeUpdate));
+                    update->videoId = SAFE_WCSDUP(current->videoId);
+                    update->filePath = SAFE_WCSDUP(current->mainVideoFile);
+                    
+                    if (update->videoId && update->filePath) {
+                        update->fileName = GetCachePathFileName(update->filePath);
+                        update->directoryLength = update->fileName > update->filePath ?
+                                                  (size_t)(update->fileName - update->filePath) - 1 : 0;
+                    }
+                    
+                    // Entries without a directory cannot be listed
+                    if (update->directoryLength > 0 && *update->fileName) {
+                        scan.count++;
                     } else {
-                        // Memory allocation failure for strings
-                        if (vId) SAFE_FREE(vId);
-                        if (fPath) SAFE_FREE(fPath);
+                        if (update->videoId) SAFE_FREE(update->videoId);
+                        if (update->filePath) SAFE_FREE(update->filePath);
                     }
                 }
                 current = current->next;
             }
         }
     }
-    LeaveCriticalSection(&manager->lock);
-    
-    // Step 2: Perform blocking I/O operations without holding any locks
-    if (updates) {
-        for (int i = 0; i < pendingCount; i++) {
-            if (GetVideoFileInfo(updates[i].filePath, &updates[i].fileSize, &updates[i].modTime)) {
-                updates[i].success = TRUE;
+    manager->sizeScanDone = 0;
+    manager->sizeScanTotal = scan.count;
+    LeaveCacheLock(manager);
+    
+    // Step 2: Group the entries by directory
+    if (scan.count > 0) {
+        qsort(scan.updates, scan.count, sizeof(FileSizeUpdate), CompareFileSizeUpdateDirectories);
+        scan.directories = (FileSizeDirectory*)SAFE_MALLOC(scan.count * sizeof(FileSizeDirectory));
+        if (scan.directories) {
+            for (LONG i = 0; i < scan.count; i++) {
+                if (i == 0 || CompareFileSizeUpdateDirectories(&scan.updates[i - 1], &scan.updates[i]) != 0) {
+                    scan.directories[scan.directoryCount].first = i;
+                    scan.directoryCount++;
+                }
+                scan.directories[scan.directoryCount - 1].last = i + 1;
             }
         }
+    }
+    
+    // Step 3: List the directories on the pool without holding any locks; no
+    // more threads than there are directories
+    if (scan.directoryCount > 0) {
+        DWORD workerCount = data->workerCount < (DWORD)scan.directoryCount ? data->workerCount : (DWORD)scan.directoryCount;
+        HANDLE workers[CACHE_STAT_MAX_WORKERS];
+        DWORD started = 0;
+        for (DWORD i = 0; i < workerCount; i++) {
+            workers[started] = CreateThread(NULL, 0, FileSizeStatWorker, &scan, 0, NULL);
+            if (workers[started]) started++;
+        }
         
-        // Step 3: Update the cache entries while holding the lock briefly
-        BOOL anyUpdated = FALSE;
-        EnterCriticalSection(&manager->lock);
-        for (int i = 0; i < pendingCount; i++) {
-            if (updates[i].success) {
-                // Re-find the entry as it might have moved or been removed
-                CacheEntry* entry = FindCacheEntry(manager, updates[i].videoId);
-                if (entry && entry->fileSize == 0) {
-                    entry->fileSize = updates[i].fileSize;
-                    entry->downloadTime = updates[i].modTime;
-                    anyUpdated = TRUE;
-                }
+        ThreadSafeDebugOutputF(L"YouTubeCacher: UpdateFileSizesWorker - Checking %ld files in %ld folders on %lu threads",
+                              scan.count, scan.directoryCount, started);
+        
+        if (started > 0) {
+            WaitForMultipleObjects(started, workers, TRUE, INFINITE);
+            for (DWORD i = 0; i < started; i++) {
+                CloseHandle(workers[i]);
             }
-            // Free temporary strings
-            SAFE_FREE(updates[i].videoId);
-            SAFE_FREE(updates[i].filePath);
-        }
-        LeaveCriticalSection(&manager->lock);
-
-        SAFE_FREE(updates);
-
-        // Notify the main window to update the display if any changes were made
-        if (anyUpdated) {
-            PostMessage(hMainWindow, WM_CACHE_SIZE_UPDATE, 0, 0);
+        } else {
+            FileSizeStatWorker(&scan);
         }
     }
     
-    // Final update to ensure display is current
-    PostMessage(hMainWindow, WM_CACHE_SIZE_UPDATE, 0, 0);
+    // Step 4: Free temporary strings
+    for (LONG i = 0; i < scan.count; i++) {
+        SAFE_FREE(scan.updates[i].videoId);
+        SAFE_FREE(scan.updates[i].filePath);
+    }
+    if (scan.updates) SAFE_FREE(scan.updates);
+    if (scan.directories) SAFE_FREE(scan.directories);
+    
+    EnterCriticalSection(&manager->lock);
+    manager->sizeScanTotal = 0;
+    LeaveCacheLock(manager);
+    
+    if (!manager->bShuttingDown) {
+        PostMessage(data->hMainWindow, WM_CACHE_SCAN_PROGRESS, 0, 0);
+        
+        // Sizes found by the scan count toward the storage budget
+        WakeCacheEviction(manager);
+    }
     
     SAFE_FREE(data);
     return 0;
 }
 
-// Start a background thread to update file sizes for cache entries
-void StartFileSizeUpdateThread(CacheManager* manager, HWND hMainWindow) {
+// Start a background scan that reconciles the cache entries with the disk:
+// their sizes, and whether their files still exist. Up to workerCount
+// directories are listed at once (0 for the default). The scan stops early
+// when the cache manager is cleaned up.
+void StartFileSizeUpdateThread(CacheManager* manager, HWND hMainWindow, DWORD workerCount) {
     if (!manager || !hMainWindow) return;
     
+    // One scan at a time
+    if (manager->hSizeThread) {
+        if (WaitForSingleObject(manager->hSizeThread, 0) == WAIT_TIMEOUT) return;
+        CloseHandle(manager->hSizeThread);
+        manager->hSizeThread = NULL;
+    }
+    
     FileSizeWorkerData* data = (FileSizeWorkerData*)SAFE_MALLOC(sizeof(FileSizeWorkerData));
     if (!data) return;
     
+    if (workerCount == 0) workerCount = CACHE_STAT_DEFAULT_WORKERS;
+    if (workerCount > CACHE_STAT_MAX_WORKERS) workerCount = CACHE_STAT_MAX_WORKERS;
+    
     data->manager = manager;
     data->hMainWindow = hMainWindow;
+    data->workerCount = workerCount;
     
-    HANDLE hThread = CreateThread(NULL, 0, UpdateFileSizesWorker, data, 0, NULL);
-    if (hThread) {
-        CloseHandle(hThread); // We don't need to wait for it
-    } else {
+    manager->hSizeThread = CreateThread(NULL, 0, UpdateFileSizesWorker, data, 0, NULL);
+    if (!manager->hSizeThread) {
         SAFE_FREE(data);
     }
 }
 
-// Get the video ID of the currently selected item (single selection)
+// Mark the entries whose video file was at a path that is gone: the entry for
+// one video file, or with tree set, every entry below a directory
+static void MarkCacheFilesMissing(CacheManager* manager, const wchar_t* path, const wchar_t* videoId, BOOL tree) {
+    size_t length = wcslen(path);
+    BOOL anyUpdated = FALSE;
+    FILETIME noTime = { 0, 0 };
+    
+    EnterCriticalSection(&manager->lock);
+    CacheEntry* entry = tree ? manager->entries : FindCacheEntry(manager, videoId);
+    while (entry) {
+        CacheEntry* next = tree ? entry->next : NULL;
+        const wchar_t* file = entry->mainVideoFile;
+        BOOL gone = file && (tree ? _wcsnicmp(file, path, length) == 0 && file[length] == L'\\'
+                                  : _wcsicmp(file, path) == 0);
+        if (gone) {
+            DWORD types = SetCacheEntryFileState(manager, entry, FALSE, 0, noTime);
+            if (types & CACHE_CHANGE_SIZE) anyUpdated = TRUE;
+            if (types) NotifyCacheChange(manager, entry->videoId, types);
+        }
+        entry = next;
+    }
+    LeaveCacheLock(manager);
+    
+    if (anyUpdated) SaveCacheToFile(manager);
+}
+
+// Refresh the subtitles of a video in a directory from its listing
+static void RefreshCacheEntrySubtitles(CacheManager* manager, const wchar_t* directory,
+                                       const CacheDirectoryListing* listing, const wchar_t* videoId) {
+    size_t length = wcslen(directory);
+    wchar_t* videoFile = NULL;
+    
+    EnterCriticalSection(&manager->lock);
+    CacheEntry* entry = FindCacheEntry(manager, videoId);
+    if (entry && entry->mainVideoFile && _wcsnicmp(entry->mainVideoFile, directory, length) == 0 &&
+        entry->mainVideoFile[length] == L'\\' && !wcschr(entry->mainVideoFile + length + 1, L'\\')) {
+        videoFile = SAFE_WCSDUP(entry->mainVideoFile);
+    }
+    LeaveCacheLock(manager);
+    if (!videoFile) return;
+    
+    CacheDirectoryMatch match;
+    MatchCacheDirectoryFile(listing, GetCachePathFileName(videoFile), &match);
+    wchar_t** subtitleFiles = NULL;
+    int subtitleCount = CollectSubtitleSiblings(directory, listing, &match, &subtitleFiles);
+    
+    BOOL changed = FALSE;
+    EnterCriticalSection(&manager->lock);
+    entry = FindCacheEntry(manager, videoId);
+    if (entry && entry->mainVideoFile && _wcsicmp(entry->mainVideoFile, videoFile) == 0 &&
+        SetCacheEntryFiles(entry, videoFile, subtitleFiles, subtitleCount)) {
+        QueueCacheJournalPut(manager, entry);
+        NotifyCacheChange(manager, entry->videoId, CACHE_CHANGE_METADATA);
+        changed = TRUE;
+    }
+    LeaveCacheLock(manager);
+    
+    FreeSubtitleFileList(subtitleFiles, subtitleCount);
+    SAFE_FREE(videoFile);
+    if (changed) SaveCacheToFile(manager);
+}
+
+// Reconcile one changed path against the listing of its directory (NULL when
+// the directory itself is gone)
+static void ApplyCacheWatchPath(CacheManager* manager, const wchar_t* directory,
+                                const CacheDirectoryListing* listing, const wchar_t* path,
+                                CacheRecoveryList* recovered) {
+    const wchar_t* fileName = GetCachePathFileName(path);
+    const CacheDirectoryFile* file = listing ? FindCacheDirectoryFile(listing, fileName) : NULL;
+    
+    // A directory created or moved in is scanned like the download folder
+    if (file && file->directory) {
+        ScanCacheDirectory(manager, path, TRUE, recovered);
+        return;
+    }
+    
+    wchar_t videoId[CACHE_VIDEO_ID_LENGTH + 1];
+    switch (ClassifyCacheFileName(fileName, videoId)) {
+        case CACHE_FILE_VIDEO:
+            if (file) {
+                ReconcileCacheVideoFile(manager, directory, listing, file, videoId, TRUE, recovered);
+            } else {
+                MarkCacheFilesMissing(manager, path, videoId, FALSE);
+            }
+            break;
+        case CACHE_FILE_SUBTITLE:
+            if (listing) RefreshCacheEntrySubtitles(manager, directory, listing, videoId);
+            break;
+        default:
+            // Anything else that is gone may have been a directory of videos
+            if (!file) MarkCacheFilesMissing(manager, path, NULL, TRUE);
+            break;
+    }
+}
+
+// Order full paths by directory, ignoring case, so each directory is one run
+static int CompareCacheWatchDirectories(const void* a, const void* b) {
+    const wchar_t* left = *(const wchar_t* const*)a;
+    const wchar_t* right = *(const wchar_t* const*)b;
+    size_t leftLength = (size_t)(GetCachePathFileName(left) - left);
+    size_t rightLength = (size_t)(GetCachePathFileName(right) - right);
+    int result = _wcsnicmp(left, right, leftLength < rightLength ? leftLength : rightLength);
+    if (result != 0) return result;
+    if (leftLength != rightLength) return leftLength < rightLength ? -1 : 1;
+    return 0;
+}
+
+// Folder watch thread: apply settled changes. Each directory the paths are in
+// is listed once and every path is reconciled against that listing; lost
+// changes rescan the whole folder and start a file scan. This thread is the
+// only one that starts file scans once the watch runs.
+static void ApplyCacheWatchChanges(void* context, wchar_t* const* paths, DWORD count, BOOL rescan) {
+    CacheManager* manager = (CacheManager*)context;
+    if (manager->bShuttingDown) return;
+    
+    if (rescan) {
+        ThreadSafeDebugOutput(L"YouTubeCacher: ApplyCacheWatchChanges - Changes were lost, rescanning the download folder");
+        CacheRecoveryList recovered;
+        InitCacheRecoveryList(&recovered, manager);
+        ScanCacheDirectory(manager, manager->downloadRoot, TRUE, &recovered);
+        AddRecoveredVideos(manager, &recovered);
+        FreeCacheRecoveryList(&recovered);
+        
+        EnterCriticalSection(&manager->lock);
+        HWND hChangeWindow = manager->hChangeWindow;
+        LeaveCacheLock(manager);
+        if (hChangeWindow) StartFileSizeUpdateThread(manager, hChangeWindow, 0);
+        return;
+    }
+    
+    wchar_t** fullPaths = (wchar_t**)SAFE_MALLOC(count * sizeof(wchar_t*));
+    if (!fullPaths) return;
+    
+    DWORD pathCount = 0;
+    size_t rootLength = wcslen(manager->downloadRoot);
+    for (DWORD i = 0; i < count; i++) {
+        wchar_t* fullPath = (wchar_t*)SAFE_MALLOC((rootLength + wcslen(paths[i]) + 2) * sizeof(wchar_t));
+        if (!fullPath) continue;
+        swprintf(fullPath, rootLength + wcslen(paths[i]) + 2, L"%ls\\%ls", manager->downloadRoot, paths[i]);
+        fullPaths[pathCount++] = fullPath;
+    }
+    qsort(fullPaths, pathCount, sizeof(wchar_t*), CompareCacheWatchDirectories);
+    
+    CacheRecoveryList recovered;
+    InitCacheRecoveryList(&recovered, manager);
+    
+    for (DWORD first = 0; first < pathCount && !manager->bShuttingDown; ) {
+        DWORD last = first + 1;
+        while (last < pathCount && CompareCacheWatchDirectories(&fullPaths[first], &fullPaths[last]) == 0) {
+            last++;
+        }
+        
+        const wchar_t* sample = fullPaths[first];
+        size_t directoryLength = (size_t)(GetCachePathFileName(sample) - sample) - 1;
+        wchar_t directory[MAX_EXTENDED_PATH];
+        wcsncpy(directory, sample, directoryLength);
+        directory[directoryLength] = L'\0';
+        
+        CacheDirectoryListing listing;
+        DWORD error = ERROR_SUCCESS;
+        BOOL listed = InitCacheDirectoryListing(&listing) &&
+                      ReadCacheDirectoryListing(directory, L"*", &listing, &error);
+        
+        // A directory that cannot be read for another reason keeps its entries as they are
+        if (listed || error == ERROR_PATH_NOT_FOUND) {
+            for (DWORD i = first; i < last && !manager->bShuttingDown; i++) {
+                ApplyCacheWatchPath(manager, directory, listed ? &listing : NULL, fullPaths[i], &recovered);
+            }
+        } else {
+            ThreadSafeDebugOutputF(L"YouTubeCacher: ApplyCacheWatchChanges - Cannot list %ls (error %lu)",
+                                  directory, error);
+        }
+        FreeCacheDirectoryListing(&listing);
+        first = last;
+    }
+    
+    for (DWORD i = 0; i < pathCount; i++) {
+        SAFE_FREE(fullPaths[i]);
+    }
+    SAFE_FREE(fullPaths);
+    
+    // New videos, with the metadata of their info JSON
+    AddRecoveredVideos(manager, &recovered);
+    FreeCacheRecoveryList(&recovered);
+    
+    // Sizes the watch found count toward the storage budget
+    WakeCacheEviction(manager);
+}
+
+static DWORD WINAPI CacheWatchThread(LPVOID param) {
+    CacheManager* manager = (CacheManager*)param;
+    
+    if (RunCacheWatch(manager->watchBackend, CACHE_WATCH_DEBOUNCE_MS, ApplyCacheWatchChanges, manager) == CACHE_WATCH_FAILED) {
+        ThreadSafeDebugOutput(L"YouTubeCacher: CacheWatchThread - Folder watch failed; changes are picked up at the next start");
+    }
+    return 0;
+}
+
+// Watch the download folder tree so videos added, moved or deleted outside the
+// app reach the cache as they happen. Call after the startup scan and once the
+// change listener is set; the watch runs until CleanupCacheManager.
+BOOL StartCacheWatcher(CacheManager* manager) {
+    if (!manager || !manager->downloadRoot || manager->hWatchThread) return FALSE;
+    
+    manager->watchBackend = OpenCacheWatchBackend(manager->downloadRoot);
+    if (!manager->watchBackend) return FALSE;
+    
+    manager->hWatchThread = CreateThread(NULL, 0, CacheWatchThread, manager, 0, NULL);
+    if (!manager->hWatchThread) {
+        CloseCacheWatchBackend(manager->watchBackend);
+        manager->watchBackend = NULL;
+        return FALSE;
+    }
+    
+    ThreadSafeDebugOutputF(L"YouTubeCacher: StartCacheWatcher - Watching %ls", manager->downloadRoot);
+    return TRUE;
+}
+
+// Get a copy of the video ID of the currently selected item (single selection).
+// The caller frees the result.
 wchar_t* GetSelectedVideoId(HWND hListView) {
     if (!hListView) return NULL;
     
     int selectedIndex = (int)SendMessageW(hListView, LVM_GETNEXTITEM, -1, LVNI_SELECTED);
     if (selectedIndex == -1) return NULL;
     
-    LVITEMW item = {0};
-    item.mask = LVIF_PARAM;
-    item.iItem = selectedIndex;
-    
-    if (SendMessageW(hListView, LVM_GETITEMW, 0, (LPARAM)&item)) {
-        return (wchar_t*)item.lParam;
-    }
-    
-    return NULL;
+    const CacheViewRow* row = GetCacheViewRow(GetCacheListSnapshot(hListView), (DWORD)selectedIndex);
+    return row ? SAFE_WCSDUP(row->videoId) : NULL;
 }
 
 // Get all selected video IDs (multiple selection)
@@ -1768,33 +4889,23 @@ wchar_t** GetSelectedVideoIds(HWND hListView, int* count) {
     
     *count = 0;
     
-    // First pass: count selected items
-    int selectedCount = 0;
-    int index = -1;
-    while ((index = (int)SendMessageW(hListView, LVM_GETNEXTITEM, index, LVNI_SELECTED)) != -1) {
-        selectedCount++;
-    }
-    
-    if (selectedCount == 0) return NULL;
+    int selectedCount = (int)SendMessageW(hListView, LVM_GETSELECTEDCOUNT, 0, 0);
+    if (selectedCount <= 0) return NULL;
     
     // Allocate array for video IDs
     wchar_t** videoIds = (wchar_t**)SAFE_MALLOC(selectedCount * sizeof(wchar_t*));
     if (!videoIds) return NULL;
     
-    // Second pass: collect video IDs
+    // Collect video IDs from the rows the list is showing
+    const CacheViewSnapshot* snapshot = GetCacheListSnapshot(hListView);
     int currentIndex = 0;
-    index = -1;
-    while ((index = (int)SendMessageW(hListView, LVM_GETNEXTITEM, index, LVNI_SELECTED)) != -1) {
-        LVITEMW item = {0};
-        item.mask = LVIF_PARAM;
-        item.iItem = index;
-        
-        if (SendMessageW(hListView, LVM_GETITEMW, 0, (LPARAM)&item)) {
-            wchar_t* videoId = (wchar_t*)item.lParam;
-            if (videoId) {
-                videoIds[currentIndex] = SAFE_WCSDUP(videoId);
-                currentIndex++;
-            }
+    int index = -1;
+    while (currentIndex < selectedCount &&
+           (index = (int)SendMessageW(hListView, LVM_GETNEXTITEM, index, LVNI_SELECTED)) != -1) {
+        const CacheViewRow* row = GetCacheViewRow(snapshot, (DWORD)index);
+        if (row) {
+            videoIds[currentIndex] = SAFE_WCSDUP(row->videoId);
+            if (videoIds[currentIndex]) currentIndex++;
         }
     }
     
@@ -1815,23 +4926,12 @@ void FreeSelectedVideoIds(wchar_t** videoIds, int count) {
     SAFE_FREE(videoIds);
 }
 
-// Clean up item data when clearing the ListView
+// Release the snapshot behind the ListView when the list goes away
 void CleanupListViewItemData(HWND hListView) {
     if (!hListView) return;
     
-    int count = (int)SendMessageW(hListView, LVM_GETITEMCOUNT, 0, 0);
-    for (int i = 0; i < count; i++) {
-        LVITEMW item = {0};
-        item.mask = LVIF_PARAM;
-        item.iItem = i;
-        
-        if (SendMessageW(hListView, LVM_GETITEMW, 0, (LPARAM)&item)) {
-            wchar_t* videoId = (wchar_t*)item.lParam;
-            if (videoId) {
-                SAFE_FREE(videoId);
-            }
-        }
-    }
+    SendMessageW(hListView, LVM_SETITEMCOUNT, 0, 0);
+    SetCacheListSnapshot(hListView, NULL);
 }
 
 // Reconstruct YouTube URL from video ID
@@ -1864,64 +4964,41 @@ int ParseDurationToSeconds(const wchar_t* duration) {
     return 0;
 }
 
-// Comparison callback for ListView sorting
-int CALLBACK CompareListViewItems(LPARAM lParam1, LPARAM lParam2, LPARAM lParamSort) {
-    ListViewSortInfo* sortInfo = (ListViewSortInfo*)lParamSort;
-    
-    // lParam1 and lParam2 are the video ID strings stored in the ListView items
-    wchar_t* videoId1 = (wchar_t*)lParam1;
-    wchar_t* videoId2 = (wchar_t*)lParam2;
-    
-    if (!sortInfo || !sortInfo->manager || !videoId1 || !videoId2) return 0;
-    
-    EnterCriticalSection(&sortInfo->manager->lock);
-    
-    CacheEntry* entry1 = FindCacheEntry(sortInfo->manager, videoId1);
-    CacheEntry* entry2 = FindCacheEntry(sortInfo->manager, videoId2);
-    
-    if (!entry1 || !entry2) {
-        LeaveCriticalSection(&sortInfo->manager->lock);
-        return 0;
-    }
-    
-    int result = 0;
+// Build the display order for the latest sort request off the UI thread. The
+// keys are already in the columns, so this is one merge sort over integers
+// with no per-comparison lookups. Clicks that arrive during a sort are built
+// together by the next pass.
+static DWORD WINAPI CacheSortWorkerThread(LPVOID lpParam) {
+    CacheManager* manager = (CacheManager*)lpParam;
+    if (!manager) return 1;
     
-    switch (sortInfo->column) {
-        case 0: // Title
-            if (entry1->title && entry2->title) {
-                result = _wcsicmp(entry1->title, entry2->title);
-            } else if (entry1->title) {
-                result = 1;
-            } else if (entry2->title) {
-                result = -1;
-            }
-            break;
-            
-        case 1: // Duration
-            {
-                int duration1 = ParseDurationToSeconds(entry1->duration);
-                int duration2 = ParseDurationToSeconds(entry2->duration);
-                result = duration1 - duration2;
-            }
-            break;
-            
-        case 2: // File Size
-            if (entry1->fileSize > entry2->fileSize) {
-                result = 1;
-            } else if (entry1->fileSize < entry2->fileSize) {
-                result = -1;
-            } else {
-                result = 0;
-            }
-            break;
+    while (!manager->bShuttingDown) {
+        WaitForSingleObject(manager->hSortEvent, INFINITE);
+        
+        if (manager->bShuttingDown) break;
+        
+        EnterCriticalSection(&manager->lock);
+        BOOL built = BuildCacheSortOrder(&manager->displayOrder, &manager->columns,
+                                         manager->sortRequestColumn, manager->sortRequestAscending);
+        DWORD count = manager->displayOrder.count;
+        HWND hWindow = manager->hSortWindow;
+        LeaveCacheLock(manager);
+        
+        if (built) {
+            ThreadSafeDebugOutputF(L"YouTubeCacher: CacheSortWorkerThread - Sorted %lu entries", count);
+        } else {
+            ThreadSafeDebugOutput(L"YouTubeCacher: CacheSortWorkerThread - ERROR: Cannot allocate sort order");
+        }
+        
+        if (hWindow) {
+            PostMessage(hWindow, WM_CACHE_SORT_COMPLETE, 0, 0);
+        }
     }
-    
-    LeaveCriticalSection(&sortInfo->manager->lock);
-    
-    return sortInfo->ascending ? result : -result;
+    return 0;
 }
 
-// Sort ListView by column
+// Sort ListView by column. The permutation is built on a worker thread; the
+// list is repopulated from it when WM_CACHE_SORT_COMPLETE arrives.
 void SortListViewByColumn(HWND hListView, int column, CacheManager* manager, ListViewSortInfo* sortInfo) {
     if (!hListView || !manager || !sortInfo) return;
     
@@ -1935,16 +5012,29 @@ void SortListViewByColumn(HWND hListView, int column, CacheManager* manager, Lis
     
     sortInfo->manager = manager;
     
-    // Use ListView_SortItems which properly passes lParam values
-    ListView_SortItems(hListView, CompareListViewItems, (LPARAM)sortInfo);
+    // Record the request; a pass that runs after a newer click builds the newer request
+    EnterCriticalSection(&manager->lock);
+    manager->sortRequestColumn = column;
+    manager->sortRequestAscending = sortInfo->ascending;
+    manager->hSortWindow = GetParent(hListView);
+    LeaveCacheLock(manager);
+    
+    if (manager->hSortThread && manager->hSortEvent) {
+        SetEvent(manager->hSortEvent);
+        return;
+    }
+    
+    // No worker available - sort inline
+    EnterCriticalSection(&manager->lock);
+    BuildCacheSortOrder(&manager->displayOrder, &manager->columns, column, sortInfo->ascending);
+    LeaveCacheLock(manager);
+    RefreshCacheList(hListView, manager);
 }
 
 // Select all items in ListView
 void SelectAllListViewItems(HWND hListView) {
     if (!hListView) return;
     
-    int itemCount = ListView_GetItemCount(hListView);
-    for (int i = 0; i < itemCount; i++) {
-        ListView_SetItemState(hListView, i, LVIS_SELECTED, LVIS_SELECTED);
-    }
+    // Index -1 applies the state to every row at once
+    ListView_SetItemState(hListView, -1, LVIS_SELECTED, LVIS_SELECTED);
 }
@@ -2,6 +2,21 @@
 #define CACHE_H
 
 #include <windows.h>
+#include "cacheindex.h"
+#include "cachetable.h"
+#include "stringarena.h"
+#include "cachecolumns.h"
+#include "cachesort.h"
+#include "cachechanges.h"
+#include "cachesearch.h"
+#include "cacheevict.h"
+#include "cachereconcile.h"
+#include "cachewatch.h"
+#include "cacheinfo.h"
+#include "cachededupe.h"
+#include "cacheverify.h"
+#include "cacheview.h"
+#include "cachestats.h"
 
 // Long path support constants (must match YouTubeCacher.h)
 #define MAX_LONG_PATH       32767  // Windows 10 long path limit
@@ -16,31 +31,105 @@ typedef struct CacheEntry {
     wchar_t** subtitleFiles;    // Array of subtitle file paths
     int subtitleCount;          // Number of subtitle files
     FILETIME downloadTime;      // When the video was downloaded
-    DWORD fileSize;             // Total size of all files
+    ULONGLONG fileSize;         // Total size of all files
+    ULONGLONG lastAccessTime;   // FILETIME ticks of the last play or download, 0 if unknown
+    DWORD accessCount;          // Plays and downloads, for the eviction policy
+    ULONGLONG hashWriteTime;    // FILETIME ticks of the file the hashes below were taken from
+    ULONGLONG sampleHash;       // Duplicate detection hashes (see cachededupe.h), 0 if not computed
+    ULONGLONG contentHash;      // Also the integrity checksum (see cacheverify.h)
+    ULONGLONG verifyTime;       // FILETIME ticks of the last integrity check, 0 if never checked
+    BOOL damaged;               // The last integrity check found the contents changed on disk
+    BOOL fileMissing;           // The last reconcile did not find the main video file
+    BOOL deletePending;         // Its files are being deleted; it leaves once they are gone (guarded by lock)
+    BOOL borrowedStrings;       // String fields point into the index mapping, not the heap
+    StringArena* stringArena;   // Arena holding the strings and subtitle array, or NULL if heap-owned
+    DWORD row;                  // Row in CacheManager.columns while linked
+    DWORD searchDoc;            // Document in CacheManager.search while the index is built
+    CacheStatsItem counted;     // What the entry adds to CacheManager.stats (guarded by lock)
     struct CacheEntry* next;    // Linked list pointer
-    struct CacheEntry* hashNext;// Hash bucket linked list pointer
+    struct CacheEntry* prev;    // Previous list entry, for O(1) unlinking
 } CacheEntry;
 
-#define CACHE_HASH_BUCKETS 1024
-
 // Cache management structure
 typedef struct {
     CacheEntry* entries;        // Linked list of cache entries
-    CacheEntry* hashBuckets[CACHE_HASH_BUCKETS]; // Hash map for O(1) lookups
+    CacheHashTable lookup;      // videoId -> entry index for O(1) lookups
+    CacheColumns columns;       // Contiguous sort/total keys, one row per entry
+    CacheSortOrder displayOrder; // Sorted permutation shown by the cache list
+    int sortRequestColumn;      // Latest sort requested by the UI, built by the sort worker
+    BOOL sortRequestAscending;
+    HWND hSortWindow;           // Told by the sort worker when the order is built
+    CacheChangeQueue changes;   // Events not yet taken by the listener (guarded by lock)
+    HWND hChangeWindow;         // Receives WM_CACHE_CHANGED when changes are queued, or NULL
+    CacheChangeQueue unpublished; // Changes not yet in the published snapshot (guarded by lock)
+    CacheViewPublisher snapshot; // Every entry in list order, for readers that skip the lock
+    DWORD snapshotPublishTick;  // GetTickCount of the last publish (guarded by lock)
+    volatile BOOL bSnapshotStale; // Changes are waiting for the next publish (written under lock)
+    CacheSearchIndex search;    // Title/ID trigram index, built by the first filtered refresh
+    wchar_t* listFilter;        // Folded filter of the cache list, or NULL to list everything
+    wchar_t* downloadRoot;      // Download folder this cache indexes
+    CacheBudget budget;         // Storage limit enforced by the eviction thread (guarded by lock)
     int totalEntries;           // Total number of cached videos
-    wchar_t cacheFilePath[MAX_EXTENDED_PATH]; // Path to cache index file
+    CacheStatsCounter stats;    // Running totals, written under lock and read without it
+    wchar_t cacheFilePath[MAX_EXTENDED_PATH]; // Path to binary cache index file
+    wchar_t legacyFilePath[MAX_EXTENDED_PATH]; // Path to legacy text index (migration only)
+    wchar_t journalFilePath[MAX_EXTENDED_PATH]; // Path to mutation journal appended after the index
+    const BYTE* indexView;      // Read-only mapping of the index that loaded entries borrow from
+    CacheJournalBuffer pendingJournal; // Records not yet committed to the journal (guarded by lock)
+    BOOL bSnapshotRequired;     // A record could not be journaled; next commit rewrites the index
+    DWORD journalRecords;       // Records in the journal file since the last snapshot
+    ULONGLONG journalBytes;     // Size of the journal file
+    ULONGLONG indexGeneration;  // Generation of the index on disk, which the journal must follow
     CRITICAL_SECTION lock;      // Thread safety
     HANDLE hSaveEvent;          // Event to signal background save
     HANDLE hSaveThread;         // Background save thread
     volatile BOOL bShuttingDown; // Flag to stop background thread
     volatile BOOL bDirty;        // Flag indicating unsaved changes
+    HANDLE hEvictEvent;         // Event to wake the eviction thread
+    HANDLE hEvictThread;        // Background eviction thread
+    HANDLE hSizeThread;         // File scan coordinator, waited for on cleanup
+    CacheWatchBackend* watchBackend; // Download folder watch, or NULL when not watching
+    HANDLE hWatchThread;        // Applies the folder watch's changes to the cache
+    HANDLE hDedupeThread;       // Duplicate scan, waited for on cleanup
+    HANDLE hScanThread;         // Startup folder scan, waited for on cleanup
+    HANDLE hVerifyEvent;        // Event to wake the integrity check thread
+    HANDLE hVerifyThread;       // Background integrity check thread
+    HANDLE hSortEvent;          // Event to wake the sort thread
+    HANDLE hSortThread;         // Builds the display order for the latest sort request
+    LONG sizeScanDone;          // Files checked by the running scan (written under lock)
+    LONG sizeScanTotal;         // Files the running scan checks, 0 when idle (written under lock)
 } CacheManager;
 
-// Cache file constants
+// Legacy text cache file constants (read once and migrated to cache_index.bin)
 #define CACHE_FILE_NAME         L"cache_index.txt"
+#define CACHE_FILE_MIGRATED_SUFFIX L".migrated"
 #define CACHE_VERSION           L"1.0"
 #define MAX_CACHE_LINE_LENGTH   2048
 
+// Journal compaction thresholds: the index is rewritten once the journal holds more
+// records than the cache has entries (but at least the minimum), or exceeds the size cap
+#define CACHE_JOURNAL_MIN_COMPACT_RECORDS 256
+#define CACHE_JOURNAL_MAX_BYTES     (4u * 1024u * 1024u)
+
+// The published snapshot is rebuilt at most this often while changes stream
+// in; a reader that finds changes waiting publishes them itself
+#define CACHE_SNAPSHOT_PUBLISH_INTERVAL_MS 100
+
+// File scan: entries are grouped by directory and each directory is listed
+// once by one of a bounded pool of I/O threads, which matches its entries
+// against the listing and applies the results a batch at a time under one lock
+#define CACHE_STAT_DEFAULT_WORKERS  8
+#define CACHE_STAT_MAX_WORKERS      32
+#define CACHE_STAT_BATCH_SIZE       64
+
+// Videos a folder scan finds get their metadata from their info JSON, read by
+// one more thread (up to CACHE_STAT_DEFAULT_WORKERS) for every this many files
+#define CACHE_RECOVERY_FILES_PER_WORKER 32
+
+// Deleting many entries at once: their files are deleted by one more thread
+// (up to CACHE_STAT_DEFAULT_WORKERS) for every this many entries
+#define CACHE_DELETE_ENTRIES_PER_WORKER 16
+
 // File deletion error information
 typedef struct {
     wchar_t* fileName;
@@ -52,6 +141,8 @@ typedef struct {
     int errorCount;
     int totalFiles;
     int successfulDeletes;
+    int entryCount;             // Entries found in the cache
+    int removedEntries;         // Entries whose files were all deleted, now out of the cache
 } DeleteResult;
 
 // Function prototypes
@@ -65,11 +156,21 @@ BOOL AddCacheEntry(CacheManager* manager, const wchar_t* videoId, const wchar_t*
                    wchar_t** subtitleFiles, int subtitleCount);
 BOOL RemoveCacheEntry(CacheManager* manager, const wchar_t* videoId);
 CacheEntry* FindCacheEntry(CacheManager* manager, const wchar_t* videoId);
+CacheViewSnapshot* AcquireCacheSnapshot(CacheManager* manager);
 DeleteResult* DeleteCacheEntryFilesDetailed(CacheManager* manager, const wchar_t* videoId);
+DeleteResult* DeleteCacheEntriesDetailed(CacheManager* manager, wchar_t* const* videoIds, int count);
 void FreeDeleteResult(DeleteResult* result);
 wchar_t* FormatDeleteErrorDetails(const DeleteResult* result);
+BOOL IsCacheEntryDamaged(CacheManager* manager, const wchar_t* videoId);
+void GetCacheStats(CacheManager* manager, CacheStats* stats);
+BOOL StartCacheDedupe(CacheManager* manager, HWND hWnd, BOOL link);
+wchar_t* FormatCacheDedupeReport(const CacheDedupeReport* report);
 BOOL PlayCacheEntry(CacheManager* manager, const wchar_t* videoId, const wchar_t* playerPath);
+BOOL SetCacheBudget(CacheManager* manager, const wchar_t* downloadPath, const CacheBudget* budget);
 void RefreshCacheList(HWND hListView, CacheManager* manager);
+void SetCacheChangeListener(CacheManager* manager, HWND hWnd);
+void ApplyCacheListChanges(HWND hDlg, CacheManager* manager);
+void SetCacheListFilter(HWND hDlg, CacheManager* manager, const wchar_t* text);
 wchar_t* ExtractVideoIdFromUrl(const wchar_t* url);
 BOOL ScanDownloadFolderForVideos(CacheManager* manager, const wchar_t* downloadPath);
 BOOL AddDummyVideo(CacheManager* manager, const wchar_t* downloadPath);
@@ -77,9 +178,9 @@ void FreeCacheEntry(CacheEntry* entry);
 BOOL ValidateCacheEntry(const CacheEntry* entry);
 
 // Utility functions
-BOOL GetVideoFileInfo(const wchar_t* filePath, DWORD* fileSize, FILETIME* modTime);
+BOOL GetVideoFileInfo(const wchar_t* filePath, ULONGLONG* fileSize, FILETIME* modTime);
 BOOL FindSubtitleFiles(const wchar_t* videoFilePath, wchar_t*** subtitleFiles, int* count);
-wchar_t* FormatFileSize(DWORD sizeBytes);
+wchar_t* FormatFileSize(ULONGLONG sizeBytes);
 wchar_t* FormatCacheEntryDisplay(const CacheEntry* entry);
 wchar_t* GetYouTubeUrlFromVideoId(const wchar_t* videoId);
 int ParseDurationToSeconds(const wchar_t* duration);
@@ -93,13 +194,17 @@ typedef struct {
 
 // UI helper functions for ListView management
 void UpdateCacheListStatus(HWND hDlg, CacheManager* manager);
-void StartFileSizeUpdateThread(CacheManager* manager, HWND hMainWindow);
+void StartFileSizeUpdateThread(CacheManager* manager, HWND hMainWindow, DWORD workerCount);
+BOOL StartCacheWatcher(CacheManager* manager);
+BOOL StartCacheFolderScan(CacheManager* manager, HWND hMainWindow, DWORD statThreads);
 wchar_t* GetSelectedVideoId(HWND hListView);
 wchar_t** GetSelectedVideoIds(HWND hListView, int* count);
 void FreeSelectedVideoIds(wchar_t** videoIds, int count);
 void InitializeCacheListView(HWND hListView);
 void ResizeCacheListViewColumns(HWND hListView, int totalWidth);
 void CleanupListViewItemData(HWND hListView);
+void GetCacheListDisplayInfo(HWND hListView, NMLVDISPINFOW* dispInfo);
+int FindCacheListItem(HWND hListView, const NMLVFINDITEMW* findItem);
 void SortListViewByColumn(HWND hListView, int column, CacheManager* manager, ListViewSortInfo* sortInfo);
 void SelectAllListViewItems(HWND hListView);
 
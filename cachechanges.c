@@ -0,0 +1,108 @@
+#include "YouTubeCacher.h"
+
+void InitCacheChangeQueue(CacheChangeQueue* queue) {
+    if (!queue) return;
+
+    memset(queue, 0, sizeof(CacheChangeQueue));
+}
+
+void FreeCacheChangeQueue(CacheChangeQueue* queue) {
+    if (!queue) return;
+
+    if (queue->changes) SAFE_FREE(queue->changes);
+    ReleaseStringArena(queue->strings);
+    InitCacheChangeQueue(queue);
+}
+
+// Drop everything recorded so far and only remember that the listener must resync
+static void OverflowCacheChangeQueue(CacheChangeQueue* queue) {
+    if (queue->changes) SAFE_FREE(queue->changes);
+    ReleaseStringArena(queue->strings);
+    queue->changes = NULL;
+    queue->strings = NULL;
+    queue->count = 0;
+    queue->capacity = 0;
+    queue->overflowed = TRUE;
+}
+
+// Record one event. Returns TRUE when the queue was idle before, meaning the
+// listener has not been notified about this batch yet.
+BOOL PushCacheChange(CacheChangeQueue* queue, const wchar_t* videoId, DWORD types) {
+    if (!queue || !videoId) return FALSE;
+
+    BOOL wasIdle = queue->count == 0 && !queue->overflowed;
+    if (queue->overflowed) return FALSE;
+
+    if (queue->count >= CACHE_CHANGE_QUEUE_LIMIT) {
+        OverflowCacheChangeQueue(queue);
+        return wasIdle;
+    }
+
+    if (queue->count == queue->capacity) {
+        DWORD capacity = queue->capacity ? queue->capacity * 2 : 16;
+        CacheChange* changes = (CacheChange*)SAFE_REALLOC(queue->changes, (size_t)capacity * sizeof(CacheChange));
+        if (!changes) {
+            OverflowCacheChangeQueue(queue);
+            return wasIdle;
+        }
+        queue->changes = changes;
+        queue->capacity = capacity;
+    }
+
+    if (!queue->strings) {
+        queue->strings = CreateStringArena(4096);
+    }
+    const wchar_t* copy = StringArenaWcsDup(queue->strings, videoId);
+    if (!copy) {
+        OverflowCacheChangeQueue(queue);
+        return wasIdle;
+    }
+
+    queue->changes[queue->count].videoId = copy;
+    queue->changes[queue->count].types = types;
+    queue->count++;
+    return wasIdle;
+}
+
+// Move every recorded event into taken, leaving the queue idle
+void TakeCacheChanges(CacheChangeQueue* queue, CacheChangeQueue* taken) {
+    if (!queue || !taken) return;
+
+    *taken = *queue;
+    InitCacheChangeQueue(queue);
+}
+
+static int CompareCacheChanges(const void* a, const void* b) {
+    return wcscmp(((const CacheChange*)a)->videoId, ((const CacheChange*)b)->videoId);
+}
+
+// Merge the events of each video ID into one and sort the batch by video ID.
+// The merged types tell what may have changed; the current state of the cache
+// decides what the listener shows.
+DWORD CoalesceCacheChanges(CacheChangeQueue* queue) {
+    if (!queue || queue->count == 0) return 0;
+
+    qsort(queue->changes, queue->count, sizeof(CacheChange), CompareCacheChanges);
+
+    DWORD merged = 0;
+    for (DWORD i = 0; i < queue->count; i++) {
+        if (merged > 0 && wcscmp(queue->changes[merged - 1].videoId, queue->changes[i].videoId) == 0) {
+            queue->changes[merged - 1].types |= queue->changes[i].types;
+        } else {
+            queue->changes[merged++] = queue->changes[i];
+        }
+    }
+    queue->count = merged;
+    return merged;
+}
+
+// Union of the types of every recorded event
+DWORD GetCacheChangeTypes(const CacheChangeQueue* queue) {
+    if (!queue) return 0;
+
+    DWORD types = 0;
+    for (DWORD i = 0; i < queue->count; i++) {
+        types |= queue->changes[i].types;
+    }
+    return types;
+}
@@ -0,0 +1,42 @@
+#ifndef CACHECHANGES_H
+#define CACHECHANGES_H
+
+#include <windows.h>
+#include "stringarena.h"
+
+// Typed change events published by CacheManager for incremental UI updates.
+//
+// Mutations push one event per affected video ID while the cache lock is held.
+// The UI takes the whole queue once per message loop turn, coalesces it to one
+// event per ID and applies the result as a delta. Past the limit the queue
+// stops recording and only reports that it overflowed, and the listener falls
+// back to a full refresh.
+
+#define CACHE_CHANGE_ADDED          0x01
+#define CACHE_CHANGE_REMOVED        0x02
+#define CACHE_CHANGE_SIZE           0x04    // File size or download time changed
+#define CACHE_CHANGE_METADATA       0x08    // Title, duration or files changed
+
+#define CACHE_CHANGE_QUEUE_LIMIT    1024
+
+typedef struct {
+    const wchar_t* videoId;     // Owned by the queue's arena
+    DWORD types;                // CACHE_CHANGE_* flags
+} CacheChange;
+
+typedef struct {
+    CacheChange* changes;
+    DWORD count;
+    DWORD capacity;
+    StringArena* strings;       // Video ID copies for the current batch
+    BOOL overflowed;            // Events were dropped; the listener must resync
+} CacheChangeQueue;
+
+void InitCacheChangeQueue(CacheChangeQueue* queue);
+void FreeCacheChangeQueue(CacheChangeQueue* queue);
+BOOL PushCacheChange(CacheChangeQueue* queue, const wchar_t* videoId, DWORD types);
+void TakeCacheChanges(CacheChangeQueue* queue, CacheChangeQueue* taken);
+DWORD CoalesceCacheChanges(CacheChangeQueue* queue);
+DWORD GetCacheChangeTypes(const CacheChangeQueue* queue);
+
+#endif // CACHECHANGES_H
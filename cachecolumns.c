@@ -0,0 +1,174 @@
+#include "YouTubeCacher.h"
+
+#define TITLE_SORT_KEY_CHARS 4
+
+// Pack the first four case-folded UTF-16 units of a title into an integer that
+// orders like the case-insensitive comparison of those units. Titles with equal
+// keys are tie-broken on the full string.
+ULONGLONG MakeTitleSortKey(const wchar_t* title) {
+    ULONGLONG key = 0;
+    int i = 0;
+    if (title) {
+        for (; i < TITLE_SORT_KEY_CHARS && title[i]; i++) {
+            ULONGLONG unit = (ULONGLONG)towlower(title[i]);
+            if (unit > 0xFFFF) unit = 0xFFFF;
+            key = (key << 16) | unit;
+        }
+    }
+    for (; i < TITLE_SORT_KEY_CHARS; i++) {
+        key <<= 16;
+    }
+    return key;
+}
+
+static BOOL ResizeCacheColumns(CacheColumns* columns, DWORD newCapacity) {
+    CacheEntry** owner = (CacheEntry**)SAFE_REALLOC(columns->owner, (size_t)newCapacity * sizeof(CacheEntry*));
+    if (!owner) return FALSE;
+    columns->owner = owner;
+
+    ULONGLONG* fileSize = (ULONGLONG*)SAFE_REALLOC(columns->fileSize, (size_t)newCapacity * sizeof(ULONGLONG));
+    if (!fileSize) return FALSE;
+    columns->fileSize = fileSize;
+
+    DWORD* durationSeconds = (DWORD*)SAFE_REALLOC(columns->durationSeconds, (size_t)newCapacity * sizeof(DWORD));
+    if (!durationSeconds) return FALSE;
+    columns->durationSeconds = durationSeconds;
+
+    ULONGLONG* downloadTime = (ULONGLONG*)SAFE_REALLOC(columns->downloadTime, (size_t)newCapacity * sizeof(ULONGLONG));
+    if (!downloadTime) return FALSE;
+    columns->downloadTime = downloadTime;
+
+    ULONGLONG* titleKey = (ULONGLONG*)SAFE_REALLOC(columns->titleKey, (size_t)newCapacity * sizeof(ULONGLONG));
+    if (!titleKey) return FALSE;
+    columns->titleKey = titleKey;
+
+    // Only committed once every array has grown, so a failure leaves the old capacity usable
+    columns->capacity = newCapacity;
+    return TRUE;
+}
+
+BOOL InitCacheColumns(CacheColumns* columns, DWORD expectedRows) {
+    if (!columns) return FALSE;
+
+    memset(columns, 0, sizeof(CacheColumns));
+    return ReserveCacheColumns(columns, expectedRows);
+}
+
+void FreeCacheColumns(CacheColumns* columns) {
+    if (!columns) return;
+
+    if (columns->owner) SAFE_FREE(columns->owner);
+    if (columns->fileSize) SAFE_FREE(columns->fileSize);
+    if (columns->durationSeconds) SAFE_FREE(columns->durationSeconds);
+    if (columns->downloadTime) SAFE_FREE(columns->downloadTime);
+    if (columns->titleKey) SAFE_FREE(columns->titleKey);
+    memset(columns, 0, sizeof(CacheColumns));
+}
+
+// Forget all rows but keep the arrays
+void ClearCacheColumns(CacheColumns* columns) {
+    if (columns) columns->count = 0;
+}
+
+BOOL ReserveCacheColumns(CacheColumns* columns, DWORD expectedRows) {
+    if (!columns) return FALSE;
+
+    DWORD capacity = columns->capacity ? columns->capacity : CACHE_COLUMNS_MIN_CAPACITY;
+    while (capacity < expectedRows) {
+        if (capacity > 0x7FFFFFFFu) return FALSE;
+        capacity *= 2;
+    }
+    if (capacity <= columns->capacity) return TRUE;
+    return ResizeCacheColumns(columns, capacity);
+}
+
+static void FillCacheColumnsRow(CacheColumns* columns, DWORD row, const CacheEntry* entry) {
+    int seconds = ParseDurationToSeconds(entry->duration);
+
+    columns->fileSize[row] = entry->fileSize;
+    columns->durationSeconds[row] = seconds > 0 ? (DWORD)seconds : 0;
+    columns->downloadTime[row] = ((ULONGLONG)entry->downloadTime.dwHighDateTime << 32) | entry->downloadTime.dwLowDateTime;
+    columns->titleKey[row] = MakeTitleSortKey(entry->title);
+}
+
+// Give an entry the next row and fill it from the entry's fields
+BOOL AppendCacheColumnsRow(CacheColumns* columns, CacheEntry* entry) {
+    if (!columns || !entry) return FALSE;
+
+    if (columns->count == columns->capacity && !ReserveCacheColumns(columns, columns->count + 1)) {
+        return FALSE;
+    }
+
+    DWORD row = columns->count++;
+    columns->owner[row] = entry;
+    entry->row = row;
+    FillCacheColumnsRow(columns, row, entry);
+    return TRUE;
+}
+
+// Remove an entry's row by moving the last row into it
+void RemoveCacheColumnsRow(CacheColumns* columns, CacheEntry* entry) {
+    if (!columns || !entry || entry->row >= columns->count || columns->owner[entry->row] != entry) return;
+
+    DWORD row = entry->row;
+    DWORD last = --columns->count;
+    if (row != last) {
+        columns->owner[row] = columns->owner[last];
+        columns->fileSize[row] = columns->fileSize[last];
+        columns->durationSeconds[row] = columns->durationSeconds[last];
+        columns->downloadTime[row] = columns->downloadTime[last];
+        columns->titleKey[row] = columns->titleKey[last];
+        columns->owner[row]->row = row;
+    }
+    entry->row = 0;
+}
+
+// Refresh a row after the entry's fields were changed in place
+void UpdateCacheColumnsRow(CacheColumns* columns, const CacheEntry* entry) {
+    if (!columns || !entry || entry->row >= columns->count || columns->owner[entry->row] != entry) return;
+
+    FillCacheColumnsRow(columns, entry->row, entry);
+}
+
+ULONGLONG SumCacheColumnsFileSize(const CacheColumns* columns) {
+    if (!columns) return 0;
+
+    ULONGLONG total = 0;
+    for (DWORD row = 0; row < columns->count; row++) {
+        total += columns->fileSize[row];
+    }
+    return total;
+}
+
+// Three-way title comparison: sort keys first, then the full case-insensitive
+// comparison, with missing titles first
+int CompareCacheTitles(ULONGLONG keyA, const wchar_t* titleA, ULONGLONG keyB, const wchar_t* titleB) {
+    if (keyA != keyB) return keyA < keyB ? -1 : 1;
+
+    if (titleA && titleB) return _wcsicmp(titleA, titleB);
+    if (titleA) return 1;
+    if (titleB) return -1;
+    return 0;
+}
+
+// Three-way comparison of two rows on a CACHE_COLUMN_* column
+int CompareCacheColumnsRows(const CacheColumns* columns, DWORD rowA, DWORD rowB, int column) {
+    switch (column) {
+        case CACHE_COLUMN_TITLE:
+            return CompareCacheTitles(columns->titleKey[rowA], columns->owner[rowA]->title,
+                                      columns->titleKey[rowB], columns->owner[rowB]->title);
+
+        case CACHE_COLUMN_DURATION: {
+            DWORD a = columns->durationSeconds[rowA];
+            DWORD b = columns->durationSeconds[rowB];
+            return a < b ? -1 : (a > b ? 1 : 0);
+        }
+
+        case CACHE_COLUMN_SIZE: {
+            ULONGLONG a = columns->fileSize[rowA];
+            ULONGLONG b = columns->fileSize[rowB];
+            return a < b ? -1 : (a > b ? 1 : 0);
+        }
+    }
+    return 0;
+}
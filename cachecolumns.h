@@ -0,0 +1,45 @@
+#ifndef CACHECOLUMNS_H
+#define CACHECOLUMNS_H
+
+#include <windows.h>
+
+// Columnar copy of the fields that sorting, totals and filtering scan.
+//
+// Each cached entry owns one row; entry->row indexes every array and
+// owner[row] points back at the entry. Rows are dense: removing an entry moves
+// the last row into the hole. The per-entry fields remain the record that is
+// serialized, so callers update the row whenever they change an entry in place.
+
+#define CACHE_COLUMNS_MIN_CAPACITY  64
+
+// Sort columns, matching the cache ListView column order
+#define CACHE_COLUMN_TITLE          0
+#define CACHE_COLUMN_DURATION       1
+#define CACHE_COLUMN_SIZE           2
+
+struct CacheEntry;
+
+typedef struct {
+    struct CacheEntry** owner;  // Row -> entry
+    ULONGLONG* fileSize;        // Bytes
+    DWORD* durationSeconds;     // Parsed once from entry->duration
+    ULONGLONG* downloadTime;    // FILETIME as 100 ns ticks
+    ULONGLONG* titleKey;        // Case-folded title prefix, see MakeTitleSortKey
+    DWORD count;
+    DWORD capacity;
+} CacheColumns;
+
+BOOL InitCacheColumns(CacheColumns* columns, DWORD expectedRows);
+void FreeCacheColumns(CacheColumns* columns);
+void ClearCacheColumns(CacheColumns* columns);
+BOOL ReserveCacheColumns(CacheColumns* columns, DWORD expectedRows);
+BOOL AppendCacheColumnsRow(CacheColumns* columns, struct CacheEntry* entry);
+void RemoveCacheColumnsRow(CacheColumns* columns, struct CacheEntry* entry);
+void UpdateCacheColumnsRow(CacheColumns* columns, const struct CacheEntry* entry);
+
+ULONGLONG SumCacheColumnsFileSize(const CacheColumns* columns);
+int CompareCacheColumnsRows(const CacheColumns* columns, DWORD rowA, DWORD rowB, int column);
+int CompareCacheTitles(ULONGLONG keyA, const wchar_t* titleA, ULONGLONG keyB, const wchar_t* titleB);
+ULONGLONG MakeTitleSortKey(const wchar_t* title);
+
+#endif // CACHECOLUMNS_H
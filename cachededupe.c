@@ -0,0 +1,143 @@
+#include "YouTubeCacher.h"
+
+ULONGLONG HashCacheDedupeData(ULONGLONG hash, const BYTE* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+DWORD GetCacheDedupeSampleOffsets(ULONGLONG size, ULONGLONG offsets[3]) {
+    if (size <= 3 * (ULONGLONG)CACHE_DEDUPE_SAMPLE_BLOCK) return 0;
+
+    offsets[0] = 0;
+    offsets[1] = (size / 2 - CACHE_DEDUPE_SAMPLE_BLOCK / 2) & ~(ULONGLONG)(CACHE_DEDUPE_SAMPLE_BLOCK - 1);
+    offsets[2] = size - CACHE_DEDUPE_SAMPLE_BLOCK;
+    return 3;
+}
+
+static ULONGLONG GetCacheDedupeKey(const CacheDedupeFile* file, int stage) {
+    if (stage == CACHE_DEDUPE_BY_SAMPLE) return file->sampleHash;
+    if (stage == CACHE_DEDUPE_BY_CONTENT) return file->contentHash;
+    return 0;
+}
+
+static int CompareCacheDedupeFiles(const CacheDedupeFile* left, const CacheDedupeFile* right, int stage) {
+    if (left->size != right->size) return left->size < right->size ? -1 : 1;
+
+    ULONGLONG leftKey = GetCacheDedupeKey(left, stage);
+    ULONGLONG rightKey = GetCacheDedupeKey(right, stage);
+    if (leftKey != rightKey) return leftKey < rightKey ? -1 : 1;
+
+    // Hard links of one file end up next to each other
+    if (left->volumeSerial != right->volumeSerial) return left->volumeSerial < right->volumeSerial ? -1 : 1;
+    if (left->fileIndex != right->fileIndex) return left->fileIndex < right->fileIndex ? -1 : 1;
+    return wcscmp(left->videoId, right->videoId);
+}
+
+static int CompareCacheDedupeBySize(const void* a, const void* b) {
+    return CompareCacheDedupeFiles((const CacheDedupeFile*)a, (const CacheDedupeFile*)b, CACHE_DEDUPE_BY_SIZE);
+}
+
+static int CompareCacheDedupeBySample(const void* a, const void* b) {
+    return CompareCacheDedupeFiles((const CacheDedupeFile*)a, (const CacheDedupeFile*)b, CACHE_DEDUPE_BY_SAMPLE);
+}
+
+static int CompareCacheDedupeByContent(const void* a, const void* b) {
+    return CompareCacheDedupeFiles((const CacheDedupeFile*)a, (const CacheDedupeFile*)b, CACHE_DEDUPE_BY_CONTENT);
+}
+
+// Whether two adjacent files are known to be the same file under two names
+static BOOL IsSameCacheDedupeFile(const CacheDedupeFile* left, const CacheDedupeFile* right) {
+    return left->fileIndex != 0 && left->fileIndex == right->fileIndex && left->volumeSerial == right->volumeSerial;
+}
+
+// Distinct files among a run of files with the same key
+static DWORD CountCacheDedupeCopies(const CacheDedupeFile* files, DWORD first, DWORD last) {
+    DWORD copies = 0;
+    for (DWORD i = first; i < last; i++) {
+        if (i == first || !IsSameCacheDedupeFile(&files[i - 1], &files[i])) copies++;
+    }
+    return copies;
+}
+
+DWORD GroupCacheDedupeFiles(CacheDedupeFile* files, DWORD count, int stage) {
+    if (!files || count == 0) return 0;
+
+    int (*compare)(const void*, const void*) = stage == CACHE_DEDUPE_BY_CONTENT ? CompareCacheDedupeByContent :
+                                               stage == CACHE_DEDUPE_BY_SAMPLE ? CompareCacheDedupeBySample :
+                                               CompareCacheDedupeBySize;
+    qsort(files, count, sizeof(CacheDedupeFile), compare);
+
+    DWORD group = 0;
+    DWORD grouped = 0;
+    DWORD first = 0;
+    while (first < count) {
+        ULONGLONG key = GetCacheDedupeKey(&files[first], stage);
+        DWORD last = first + 1;
+        while (last < count && files[last].size == files[first].size &&
+               GetCacheDedupeKey(&files[last], stage) == key) {
+            last++;
+        }
+
+        // Empty files and files whose hash is unknown match nothing
+        BOOL candidates = last - first >= 2 && files[first].size > 0 &&
+                          (stage == CACHE_DEDUPE_BY_SIZE || key != 0);
+        if (candidates && stage == CACHE_DEDUPE_BY_CONTENT) {
+            candidates = CountCacheDedupeCopies(files, first, last) >= 2;
+        }
+
+        if (candidates) group++;
+        for (DWORD i = first; i < last; i++) {
+            files[i].group = candidates ? group : 0;
+        }
+        if (candidates) grouped += last - first;
+        first = last;
+    }
+    return grouped;
+}
+
+DWORD GetCacheDedupeThrottleDelay(ULONGLONG bytes, DWORD elapsedMs, ULONGLONG bytesPerSecond) {
+    if (bytesPerSecond == 0) return 0;
+
+    ULONGLONG dueMs = bytes * 1000 / bytesPerSecond;
+    if (dueMs <= elapsedMs) return 0;
+    return dueMs - elapsedMs > 1000 ? 1000 : (DWORD)(dueMs - elapsedMs);
+}
+
+void SummarizeCacheDedupeReport(CacheDedupeReport* report) {
+    if (!report) return;
+
+    report->groupCount = 0;
+    report->duplicateCount = 0;
+    report->duplicateBytes = 0;
+
+    DWORD first = 0;
+    while (first < report->count) {
+        DWORD last = first + 1;
+        while (last < report->count && report->files[last].group == report->files[first].group) {
+            last++;
+        }
+        if (report->files[first].group != 0) {
+            DWORD copies = CountCacheDedupeCopies(report->files, first, last);
+            report->groupCount++;
+            report->duplicateCount += copies - 1;
+            report->duplicateBytes += (ULONGLONG)(copies - 1) * report->files[first].size;
+        }
+        first = last;
+    }
+}
+
+void FreeCacheDedupeReport(CacheDedupeReport* report) {
+    if (!report) return;
+
+    for (DWORD i = 0; i < report->count; i++) {
+        CacheDedupeFile* file = &report->files[i];
+        if (file->videoId) SAFE_FREE(file->videoId);
+        if (file->title) SAFE_FREE(file->title);
+        if (file->filePath) SAFE_FREE(file->filePath);
+    }
+    if (report->files) SAFE_FREE(report->files);
+    SAFE_FREE(report);
+}
@@ -0,0 +1,80 @@
+#ifndef CACHEDEDUPE_H
+#define CACHEDEDUPE_H
+
+#include <windows.h>
+
+// Duplicate detection across the cache.
+//
+// The same video often ends up cached more than once under different IDs
+// (re-uploads, mirrors, playlist copies). Duplicates are found in stages that
+// each read as little as possible: only files of exactly the same size are
+// candidates, only candidates whose sampled hash (a block from the head, the
+// middle and the tail) matches are hashed in full, and only files whose full
+// hashes match are reported. Files that are already hard links of one another
+// count as one copy.
+//
+// The hashes are stored with each entry along with the write time of the file
+// they were taken from, so a file is read again only after it changed. Hashing
+// runs on a few background-priority threads sharing one I/O budget, so a scan
+// of a large library does not starve playback or downloads.
+
+#define CACHE_DEDUPE_SAMPLE_BLOCK   (64 * 1024)
+#define CACHE_DEDUPE_READ_CHUNK     (256 * 1024)
+#define CACHE_DEDUPE_WORKERS        2
+#define CACHE_DEDUPE_BYTES_PER_SEC  (32ull * 1024 * 1024)   // Shared by all hashing threads
+#define CACHE_DEDUPE_HASH_SEED      14695981039346656037ull // FNV-1a 64-bit offset basis
+
+// Stages; each groups by size and the hash of that stage
+#define CACHE_DEDUPE_BY_SIZE        0
+#define CACHE_DEDUPE_BY_SAMPLE      1
+#define CACHE_DEDUPE_BY_CONTENT     2
+
+// One cached video file taking part in a scan
+typedef struct {
+    wchar_t* videoId;
+    wchar_t* title;
+    wchar_t* filePath;
+    ULONGLONG size;
+    ULONGLONG writeTime;        // FILETIME ticks the hashes belong to
+    ULONGLONG sampleHash;       // 0 while unknown
+    ULONGLONG contentHash;      // 0 while unknown
+    DWORD volumeSerial;         // With fileIndex, tells hard links of one file apart
+    ULONGLONG fileIndex;        // 0 while unknown
+    DWORD group;                // Group found by the last stage, 0 for none
+    BOOL hashed;                // New hashes to store with the entry
+    BOOL linked;                // Replaced by a hard link to the first file of its group
+} CacheDedupeFile;
+
+// Outcome of a scan, sent to the window that started it
+typedef struct {
+    CacheDedupeFile* files;     // Ordered by group, as left by GroupCacheDedupeFiles
+    DWORD count;
+    DWORD groupCount;           // Sets of identical files
+    DWORD duplicateCount;       // Copies beyond the first of each set
+    ULONGLONG duplicateBytes;   // Space those copies take
+    BOOL linking;               // The scan replaced the copies with hard links
+    DWORD linkedCount;
+    DWORD linkErrors;
+} CacheDedupeReport;
+
+// Continue an FNV-1a hash over more data; start from CACHE_DEDUPE_HASH_SEED
+ULONGLONG HashCacheDedupeData(ULONGLONG hash, const BYTE* data, size_t size);
+
+// Offsets of the head, middle and tail blocks sampled from a file of this size.
+// Returns 0 when the file is small enough that the sample is the whole file.
+DWORD GetCacheDedupeSampleOffsets(ULONGLONG size, ULONGLONG offsets[3]);
+
+// Sort the files so that candidates of one group are adjacent and number the
+// groups from 1. A group needs two files of the same size and the same hash of
+// the stage, or for CACHE_DEDUPE_BY_CONTENT two distinct files (not hard links
+// of one another). Returns the number of files in groups.
+DWORD GroupCacheDedupeFiles(CacheDedupeFile* files, DWORD count, int stage);
+
+// Milliseconds to pause so bytes read since start stay within the budget
+DWORD GetCacheDedupeThrottleDelay(ULONGLONG bytes, DWORD elapsedMs, ULONGLONG bytesPerSecond);
+
+// Count the groups and duplicates of a report grouped by content
+void SummarizeCacheDedupeReport(CacheDedupeReport* report);
+void FreeCacheDedupeReport(CacheDedupeReport* report);
+
+#endif // CACHEDEDUPE_H
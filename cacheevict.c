@@ -0,0 +1,138 @@
+#include "YouTubeCacher.h"
+
+static const wchar_t* const cacheEvictPolicyNames[CACHE_EVICT_POLICY_COUNT] = { L"lru", L"lfu", L"size" };
+
+const wchar_t* GetCacheEvictPolicyName(int policy) {
+    if (policy < 0 || policy >= CACHE_EVICT_POLICY_COUNT) return cacheEvictPolicyNames[CACHE_EVICT_LRU];
+    return cacheEvictPolicyNames[policy];
+}
+
+// Parse "<bytes>,<policy>"; an unknown or missing policy falls back to LRU
+BOOL ParseCacheBudget(const wchar_t* text, CacheBudget* budget) {
+    if (!text || !budget || !iswdigit(*text)) return FALSE;
+
+    wchar_t* end = NULL;
+    ULONGLONG limit = wcstoull(text, &end, 10);
+    if (end == text || (*end != L'\0' && *end != L',')) return FALSE;
+
+    budget->limitBytes = limit;
+    budget->policy = CACHE_EVICT_LRU;
+    if (*end == L',') {
+        for (int i = 0; i < CACHE_EVICT_POLICY_COUNT; i++) {
+            if (_wcsicmp(end + 1, cacheEvictPolicyNames[i]) == 0) {
+                budget->policy = i;
+                break;
+            }
+        }
+    }
+    return TRUE;
+}
+
+void FormatCacheBudget(const CacheBudget* budget, wchar_t* buffer, size_t bufferSize) {
+    if (!budget || !buffer || bufferSize == 0) return;
+
+    swprintf(buffer, bufferSize, L"%llu,%ls", budget->limitBytes, GetCacheEvictPolicyName(budget->policy));
+}
+
+// One evictable entry; larger keys are evicted first
+typedef struct {
+    CacheEntry* entry;
+    ULONGLONG size;
+    ULONGLONG primary;
+    ULONGLONG secondary;
+} CacheEvictCandidate;
+
+static int CompareCacheEvictCandidates(const void* a, const void* b) {
+    const CacheEvictCandidate* left = (const CacheEvictCandidate*)a;
+    const CacheEvictCandidate* right = (const CacheEvictCandidate*)b;
+    if (left->primary != right->primary) return left->primary > right->primary ? -1 : 1;
+    if (left->secondary != right->secondary) return left->secondary > right->secondary ? -1 : 1;
+    return 0;
+}
+
+// Entries without recorded accesses (written before access stats existed)
+// count as accessed once, when they were downloaded
+static ULONGLONG GetCacheEvictLastAccess(const CacheColumns* columns, DWORD row) {
+    const CacheEntry* entry = columns->owner[row];
+    return entry->lastAccessTime ? entry->lastAccessTime : columns->downloadTime[row];
+}
+
+static void MakeCacheEvictKeys(const CacheColumns* columns, DWORD row, int policy, ULONGLONG now,
+                               CacheEvictCandidate* candidate) {
+    const CacheEntry* entry = columns->owner[row];
+    ULONGLONG lastAccess = GetCacheEvictLastAccess(columns, row);
+    ULONGLONG age = now > lastAccess ? now - lastAccess : 0;
+    DWORD accesses = entry->accessCount ? entry->accessCount : 1;
+    ULONGLONG size = columns->fileSize[row];
+
+    candidate->entry = columns->owner[row];
+    candidate->size = size;
+
+    switch (policy) {
+        case CACHE_EVICT_LFU:
+            candidate->primary = 0xFFFFFFFFu - accesses;
+            candidate->secondary = age;
+            break;
+
+        case CACHE_EVICT_SIZE: {
+            // Megabytes held times seconds idle, per access
+            double cost = ((double)size / (1024.0 * 1024.0)) * ((double)age / 10000000.0) / (double)accesses;
+            candidate->primary = cost >= 1.8e19 ? 0xFFFFFFFFFFFFFFFFull : (ULONGLONG)cost;
+            candidate->secondary = size;
+            break;
+        }
+
+        default:
+            candidate->primary = age;
+            candidate->secondary = size;
+            break;
+    }
+}
+
+DWORD SelectCacheEvictionVictims(const CacheColumns* columns, const CacheBudget* budget, const wchar_t* root,
+                                 ULONGLONG rootBytes, ULONGLONG now, CacheEntry*** victims) {
+    if (!victims) return 0;
+    *victims = NULL;
+    if (!columns || !budget || !root || budget->limitBytes == 0) return 0;
+
+    if (rootBytes <= budget->limitBytes) return 0;
+    ULONGLONG excess = rootBytes - budget->limitBytes;
+
+    CacheEvictCandidate* candidates = (CacheEvictCandidate*)SAFE_MALLOC((size_t)columns->count * sizeof(CacheEvictCandidate));
+    if (!candidates) return 0;
+
+    DWORD candidateCount = 0;
+    for (DWORD row = 0; row < columns->count; row++) {
+        // Nothing to free, or too recently used to delete
+        if (columns->fileSize[row] == 0) continue;
+        if (GetCacheEvictLastAccess(columns, row) + CACHE_EVICT_GRACE_TICKS > now) continue;
+        // The budget belongs to the download root; files elsewhere are not its to delete
+        if (!IsCacheRootPath(root, columns->owner[row]->mainVideoFile)) continue;
+
+        MakeCacheEvictKeys(columns, row, budget->policy, now, &candidates[candidateCount]);
+        candidateCount++;
+    }
+
+    qsort(candidates, candidateCount, sizeof(CacheEvictCandidate), CompareCacheEvictCandidates);
+
+    DWORD victimCount = 0;
+    ULONGLONG freed = 0;
+    while (victimCount < candidateCount && freed < excess) {
+        freed += candidates[victimCount].size;
+        victimCount++;
+    }
+
+    if (victimCount > 0) {
+        *victims = (CacheEntry**)SAFE_MALLOC((size_t)victimCount * sizeof(CacheEntry*));
+        if (*victims) {
+            for (DWORD i = 0; i < victimCount; i++) {
+                (*victims)[i] = candidates[i].entry;
+            }
+        } else {
+            victimCount = 0;
+        }
+    }
+
+    SAFE_FREE(candidates);
+    return victimCount;
+}
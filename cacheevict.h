@@ -0,0 +1,45 @@
+#ifndef CACHEEVICT_H
+#define CACHEEVICT_H
+
+#include <windows.h>
+#include "cachecolumns.h"
+
+// Storage budget of one download root and the policy used to stay under it.
+//
+// The budget is kept in the registry under REG_CACHE_BUDGETS, one value per
+// download root named after the root path, holding "<bytes>,<policy>" (for
+// example "53687091200,lru"). A limit of zero means the cache may grow freely.
+//
+// When the cached files outgrow the limit, victims are chosen from the access
+// stats recorded on every download and play: the least recently used entries,
+// the least often used ones, or under the size-aware policy the entries that
+// free the most space for the least use. Entries accessed within the grace
+// period are never chosen, so a download is not evicted the moment it lands
+// and a video that was just opened is not deleted under the player.
+
+#define CACHE_EVICT_LRU             0   // Oldest last access first
+#define CACHE_EVICT_LFU             1   // Fewest accesses first, then oldest
+#define CACHE_EVICT_SIZE            2   // Largest size x age per access first
+#define CACHE_EVICT_POLICY_COUNT    3
+
+#define CACHE_EVICT_GRACE_TICKS     (10ull * 60 * 10000000)  // 10 minutes of FILETIME ticks
+#define CACHE_EVICT_RETRY_MS        (5 * 60 * 1000)          // Recheck while protected entries keep the cache over budget
+
+typedef struct {
+    ULONGLONG limitBytes;           // 0 for no limit
+    int policy;                     // CACHE_EVICT_*
+} CacheBudget;
+
+const wchar_t* GetCacheEvictPolicyName(int policy);
+BOOL ParseCacheBudget(const wchar_t* text, CacheBudget* budget);
+void FormatCacheBudget(const CacheBudget* budget, wchar_t* buffer, size_t bufferSize);
+
+// Pick the entries to delete so the download root fits its budget, in eviction
+// order. Only entries whose video file lies inside root are chosen, and
+// rootBytes is their size, from the cache's running totals. The caller holds
+// the cache lock and frees *victims; returns the number chosen, which may free
+// less than needed when too much of the root is protected.
+DWORD SelectCacheEvictionVictims(const CacheColumns* columns, const CacheBudget* budget, const wchar_t* root,
+                                 ULONGLONG rootBytes, ULONGLONG now, struct CacheEntry*** victims);
+
+#endif // CACHEEVICT_H
@@ -0,0 +1,399 @@
+#include "YouTubeCacher.h"
+
+// Round a byte offset up to the next 8-byte boundary
+#define CACHE_INDEX_ALIGN(value) (((value) + 7) & ~((ULONGLONG)7))
+
+// FNV-1a over the header's headerSize bytes with the checksum field treated as zero.
+// Only those bytes are read, so an older, shorter header is safe to pass.
+static DWORD ComputeCacheIndexHeaderChecksum(const CacheIndexHeader* header) {
+    CacheIndexHeader copy;
+    size_t size = header->headerSize < sizeof(copy) ? header->headerSize : sizeof(copy);
+    memset(&copy, 0, sizeof(copy));
+    memcpy(&copy, header, size);
+    copy.headerChecksum = 0;
+
+    const BYTE* bytes = (const BYTE*)&copy;
+    DWORD hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Copy a string into the string table and return its character offset
+static DWORD AppendCacheIndexString(wchar_t* table, DWORD* cursor, const wchar_t* str) {
+    if (!str) return CACHE_INDEX_NO_STRING;
+
+    DWORD offset = *cursor;
+    size_t len = wcslen(str);
+    memcpy(table + offset, str, (len + 1) * sizeof(wchar_t));
+    *cursor += (DWORD)(len + 1);
+    return offset;
+}
+
+static ULONGLONG GetCacheIndexStringChars(const wchar_t* str) {
+    return str ? (ULONGLONG)wcslen(str) + 1 : 0;
+}
+
+// Serialize cache entries into a single contiguous index image.
+// The caller must keep the entries stable (hold the cache lock) for the duration.
+BOOL BuildCacheIndexImage(CacheEntry* const* entries, DWORD count, ULONGLONG generation, CacheIndexImage* image) {
+    if (!image || (count > 0 && !entries)) return FALSE;
+
+    image->data = NULL;
+    image->size = 0;
+
+    // Pass 1: measure the string table and subtitle slots
+    ULONGLONG stringChars = 0;
+    ULONGLONG subtitleSlots = 0;
+    for (DWORD i = 0; i < count; i++) {
+        const CacheEntry* entry = entries[i];
+        stringChars += GetCacheIndexStringChars(entry->videoId);
+        stringChars += GetCacheIndexStringChars(entry->title);
+        stringChars += GetCacheIndexStringChars(entry->duration);
+        stringChars += GetCacheIndexStringChars(entry->mainVideoFile);
+        if (entry->subtitleFiles && entry->subtitleCount > 0) {
+            for (int j = 0; j < entry->subtitleCount; j++) {
+                stringChars += GetCacheIndexStringChars(entry->subtitleFiles[j]);
+            }
+            subtitleSlots += (ULONGLONG)entry->subtitleCount;
+        }
+    }
+
+    if (stringChars >= CACHE_INDEX_NO_STRING || subtitleSlots >= CACHE_INDEX_NO_STRING) {
+        return FALSE;
+    }
+
+    CacheIndexHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = CACHE_INDEX_MAGIC;
+    header.version = CACHE_INDEX_VERSION;
+    header.headerSize = sizeof(CacheIndexHeader);
+    header.recordSize = sizeof(CacheIndexRecord);
+    header.charSize = sizeof(wchar_t);
+    header.entryCount = count;
+    header.subtitleCount = (DWORD)subtitleSlots;
+    header.recordsOffset = CACHE_INDEX_ALIGN((ULONGLONG)sizeof(CacheIndexHeader));
+    header.subtitlesOffset = CACHE_INDEX_ALIGN(header.recordsOffset + (ULONGLONG)count * sizeof(CacheIndexRecord));
+    header.stringsOffset = CACHE_INDEX_ALIGN(header.subtitlesOffset + subtitleSlots * sizeof(DWORD));
+    header.stringsSize = stringChars * sizeof(wchar_t);
+    header.generation = generation;
+    header.headerChecksum = ComputeCacheIndexHeaderChecksum(&header);
+
+    ULONGLONG totalSize = header.stringsOffset + header.stringsSize;
+    if (totalSize > CACHE_INDEX_MAX_FILE_SIZE) {
+        return FALSE;
+    }
+
+    BYTE* data = (BYTE*)SAFE_MALLOC((size_t)totalSize);
+    if (!data) return FALSE;
+    memset(data, 0, (size_t)totalSize);
+
+    memcpy(data, &header, sizeof(header));
+
+    // Pass 2: fill records, subtitle table and string table
+    CacheIndexRecord* records = (CacheIndexRecord*)(data + header.recordsOffset);
+    DWORD* subtitles = (DWORD*)(data + header.subtitlesOffset);
+    wchar_t* strings = (wchar_t*)(data + header.stringsOffset);
+    DWORD stringCursor = 0;
+    DWORD subtitleCursor = 0;
+
+    for (DWORD i = 0; i < count; i++) {
+        const CacheEntry* entry = entries[i];
+        CacheIndexRecord* record = &records[i];
+
+        record->videoId = AppendCacheIndexString(strings, &stringCursor, entry->videoId);
+        record->title = AppendCacheIndexString(strings, &stringCursor, entry->title);
+        record->duration = AppendCacheIndexString(strings, &stringCursor, entry->duration);
+        record->mainVideoFile = AppendCacheIndexString(strings, &stringCursor, entry->mainVideoFile);
+        record->firstSubtitle = subtitleCursor;
+        record->subtitleCount = 0;
+        record->downloadTime = entry->downloadTime;
+        record->fileSize = entry->fileSize;
+        record->lastAccessTime = entry->lastAccessTime;
+        record->accessCount = entry->accessCount;
+        record->hashWriteTime = entry->hashWriteTime;
+        record->sampleHash = entry->sampleHash;
+        record->contentHash = entry->contentHash;
+        record->verifyTime = entry->verifyTime;
+        record->flags = (entry->damaged ? CACHE_INDEX_FLAG_DAMAGED : 0) |
+                        (entry->fileMissing ? CACHE_INDEX_FLAG_MISSING : 0);
+
+        if (entry->subtitleFiles && entry->subtitleCount > 0) {
+            for (int j = 0; j < entry->subtitleCount; j++) {
+                subtitles[subtitleCursor++] = AppendCacheIndexString(strings, &stringCursor, entry->subtitleFiles[j]);
+            }
+            record->subtitleCount = (DWORD)entry->subtitleCount;
+        }
+    }
+
+    image->data = data;
+    image->size = (size_t)totalSize;
+    return TRUE;
+}
+
+// Free an image produced by BuildCacheIndexImage
+void FreeCacheIndexImage(CacheIndexImage* image) {
+    if (!image) return;
+
+    if (image->data) {
+        SAFE_FREE(image->data);
+        image->data = NULL;
+    }
+    image->size = 0;
+}
+
+// Validate a serialized index and prepare a reader over it.
+// Only the header and table bounds are checked here; individual offsets are
+// range-checked when accessed so opening a large index stays O(1).
+BOOL OpenCacheIndexImage(const BYTE* data, size_t size, CacheIndexReader* reader) {
+    if (!data || !reader) return FALSE;
+
+    memset(reader, 0, sizeof(CacheIndexReader));
+
+    if (size < CACHE_INDEX_HEADER_V4_SIZE) return FALSE;
+
+    // Only the first headerSize bytes of the header are read
+    const CacheIndexHeader* header = (const CacheIndexHeader*)data;
+    if (header->magic != CACHE_INDEX_MAGIC) return FALSE;
+    if (header->version == 0 || header->version > CACHE_INDEX_VERSION) return FALSE;
+    size_t headerSize = header->version >= 5 ? sizeof(CacheIndexHeader) : CACHE_INDEX_HEADER_V4_SIZE;
+    if (header->headerSize != headerSize || size < headerSize) return FALSE;
+    if (header->charSize != sizeof(wchar_t)) return FALSE;
+    if (header->headerChecksum != ComputeCacheIndexHeaderChecksum(header)) return FALSE;
+    if (header->recordSize < CACHE_INDEX_RECORD_V1_SIZE) return FALSE;
+
+    // Table bounds (all arithmetic in 64 bits to avoid wrap-around)
+    ULONGLONG fileSize = (ULONGLONG)size;
+    if (header->recordsOffset % 8 != 0 || header->subtitlesOffset % sizeof(DWORD) != 0 ||
+        header->stringsOffset % sizeof(wchar_t) != 0 || header->stringsSize % sizeof(wchar_t) != 0) {
+        return FALSE;
+    }
+    if (header->recordsOffset > fileSize ||
+        (ULONGLONG)header->entryCount * header->recordSize > fileSize - header->recordsOffset) {
+        return FALSE;
+    }
+    if (header->subtitlesOffset > fileSize ||
+        (ULONGLONG)header->subtitleCount * sizeof(DWORD) > fileSize - header->subtitlesOffset) {
+        return FALSE;
+    }
+    if (header->stringsOffset > fileSize || header->stringsSize > fileSize - header->stringsOffset) {
+        return FALSE;
+    }
+
+    const wchar_t* strings = (const wchar_t*)(data + header->stringsOffset);
+    DWORD stringChars = (DWORD)(header->stringsSize / sizeof(wchar_t));
+
+    // The table must end with a terminator so no string can run past it
+    if (stringChars > 0 && strings[stringChars - 1] != L'\0') return FALSE;
+
+    reader->data = data;
+    reader->size = size;
+    reader->header = header;
+    reader->subtitles = (const DWORD*)(data + header->subtitlesOffset);
+    reader->strings = strings;
+    reader->stringChars = stringChars;
+    reader->generation = header->version >= 5 ? header->generation : 0;
+    return TRUE;
+}
+
+DWORD GetCacheIndexEntryCount(const CacheIndexReader* reader) {
+    return (reader && reader->header) ? reader->header->entryCount : 0;
+}
+
+ULONGLONG GetCacheIndexGeneration(const CacheIndexReader* reader) {
+    return reader ? reader->generation : 0;
+}
+
+// Copy one record out of the image. Records written by a newer version may be
+// larger; only the fields known to this version are read. Records written by an
+// older version are shorter; the fields they lack read as zero.
+BOOL ReadCacheIndexRecord(const CacheIndexReader* reader, DWORD index, CacheIndexRecord* record) {
+    if (!reader || !reader->header || !record) return FALSE;
+    if (index >= reader->header->entryCount) return FALSE;
+
+    const BYTE* source = reader->data + reader->header->recordsOffset +
+                         (ULONGLONG)index * reader->header->recordSize;
+    DWORD copySize = reader->header->recordSize < sizeof(CacheIndexRecord) ?
+                     reader->header->recordSize : (DWORD)sizeof(CacheIndexRecord);
+    memset(record, 0, sizeof(CacheIndexRecord));
+    memcpy(record, source, copySize);
+    return TRUE;
+}
+
+// Resolve a string table offset; returns NULL for missing or out-of-range offsets
+const wchar_t* GetCacheIndexString(const CacheIndexReader* reader, DWORD offset) {
+    if (!reader || !reader->strings) return NULL;
+    if (offset == CACHE_INDEX_NO_STRING || offset >= reader->stringChars) return NULL;
+    return reader->strings + offset;
+}
+
+const wchar_t* GetCacheIndexSubtitle(const CacheIndexReader* reader, const CacheIndexRecord* record, DWORD subtitleIndex) {
+    if (!reader || !reader->header || !record) return NULL;
+    if (subtitleIndex >= record->subtitleCount) return NULL;
+
+    ULONGLONG slot = (ULONGLONG)record->firstSubtitle + subtitleIndex;
+    if (slot >= reader->header->subtitleCount) return NULL;
+
+    return GetCacheIndexString(reader, reader->subtitles[slot]);
+}
+
+// Checksum covering the record type, size and payload
+static DWORD ComputeCacheJournalChecksum(DWORD type, const BYTE* payload, DWORD payloadSize) {
+    DWORD hash = 2166136261u;
+    DWORD fields[2] = { type, payloadSize };
+    const BYTE* bytes = (const BYTE*)fields;
+    for (size_t i = 0; i < sizeof(fields); i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    for (DWORD i = 0; i < payloadSize; i++) {
+        hash ^= payload[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void InitCacheJournalFileHeader(CacheJournalFileHeader* header, ULONGLONG generation) {
+    if (!header) return;
+    memset(header, 0, sizeof(CacheJournalFileHeader));
+    header->magic = CACHE_JOURNAL_FILE_MAGIC;
+    header->generation = generation;
+}
+
+// A journal that starts straight with a record predates the file header
+BOOL ReadCacheJournalFileHeader(const BYTE* data, size_t size, size_t* recordsOffset, ULONGLONG* generation) {
+    if (!data || !recordsOffset || !generation) return FALSE;
+
+    DWORD magic = 0;
+    if (size >= sizeof(magic)) {
+        memcpy(&magic, data, sizeof(magic));
+    }
+    if (magic != CACHE_JOURNAL_FILE_MAGIC) {
+        *recordsOffset = 0;
+        *generation = 0;
+        return TRUE;
+    }
+    if (size < sizeof(CacheJournalFileHeader)) return FALSE;
+
+    CacheJournalFileHeader header;
+    memcpy(&header, data, sizeof(header));
+    *recordsOffset = sizeof(header);
+    *generation = header.generation;
+    return TRUE;
+}
+
+// Append one framed record; the buffer grows geometrically so appends are amortized O(1)
+static BOOL AppendCacheJournalRecord(CacheJournalBuffer* buffer, DWORD type, const BYTE* payload, DWORD payloadSize) {
+    if (!buffer || (payloadSize > 0 && !payload)) return FALSE;
+    if (payloadSize > CACHE_JOURNAL_MAX_PAYLOAD) return FALSE;
+
+    size_t recordSize = sizeof(CacheJournalRecordHeader) + (size_t)CACHE_INDEX_ALIGN((ULONGLONG)payloadSize);
+    if (buffer->size + recordSize > buffer->capacity) {
+        size_t newCapacity = buffer->capacity ? buffer->capacity * 2 : 4096;
+        while (newCapacity < buffer->size + recordSize) {
+            newCapacity *= 2;
+        }
+        BYTE* newData = (BYTE*)SAFE_REALLOC(buffer->data, newCapacity);
+        if (!newData) return FALSE;
+        buffer->data = newData;
+        buffer->capacity = newCapacity;
+    }
+
+    CacheJournalRecordHeader header;
+    header.magic = CACHE_JOURNAL_MAGIC;
+    header.type = type;
+    header.payloadSize = payloadSize;
+    header.checksum = ComputeCacheJournalChecksum(type, payload, payloadSize);
+
+    BYTE* target = buffer->data + buffer->size;
+    memset(target, 0, recordSize);
+    memcpy(target, &header, sizeof(header));
+    if (payloadSize > 0) {
+        memcpy(target + sizeof(header), payload, payloadSize);
+    }
+
+    buffer->size += recordSize;
+    buffer->recordCount++;
+    return TRUE;
+}
+
+// Record an added or updated entry
+BOOL AppendCacheJournalPut(CacheJournalBuffer* buffer, CacheEntry* entry) {
+    if (!buffer || !entry) return FALSE;
+
+    CacheIndexImage image;
+    if (!BuildCacheIndexImage(&entry, 1, 0, &image)) return FALSE;
+
+    BOOL result = FALSE;
+    if (image.size <= CACHE_JOURNAL_MAX_PAYLOAD) {
+        result = AppendCacheJournalRecord(buffer, CACHE_JOURNAL_PUT, image.data, (DWORD)image.size);
+    }
+    FreeCacheIndexImage(&image);
+    return result;
+}
+
+// Record a removed entry
+BOOL AppendCacheJournalRemove(CacheJournalBuffer* buffer, const wchar_t* videoId) {
+    if (!buffer || !videoId) return FALSE;
+
+    size_t bytes = (wcslen(videoId) + 1) * sizeof(wchar_t);
+    if (bytes > CACHE_JOURNAL_MAX_PAYLOAD) return FALSE;
+    return AppendCacheJournalRecord(buffer, CACHE_JOURNAL_REMOVE, (const BYTE*)videoId, (DWORD)bytes);
+}
+
+// Drop buffered records but keep the allocation for reuse
+void ResetCacheJournalBuffer(CacheJournalBuffer* buffer) {
+    if (!buffer) return;
+    buffer->size = 0;
+    buffer->recordCount = 0;
+}
+
+void FreeCacheJournalBuffer(CacheJournalBuffer* buffer) {
+    if (!buffer) return;
+
+    if (buffer->data) {
+        SAFE_FREE(buffer->data);
+        buffer->data = NULL;
+    }
+    buffer->size = 0;
+    buffer->capacity = 0;
+    buffer->recordCount = 0;
+}
+
+// Decode the record at *offset and advance past it. Returns FALSE at the end of
+// the data or at the first torn/corrupt record; *offset then marks the end of the
+// valid prefix, which is where the next append should start.
+BOOL ReadCacheJournalRecord(const BYTE* data, size_t size, size_t* offset, CacheJournalRecord* record) {
+    if (!data || !offset || !record) return FALSE;
+    if (*offset > size || size - *offset < sizeof(CacheJournalRecordHeader)) return FALSE;
+
+    CacheJournalRecordHeader header;
+    memcpy(&header, data + *offset, sizeof(header));
+    if (header.magic != CACHE_JOURNAL_MAGIC) return FALSE;
+    if (header.type != CACHE_JOURNAL_PUT && header.type != CACHE_JOURNAL_REMOVE) return FALSE;
+    if (header.payloadSize > CACHE_JOURNAL_MAX_PAYLOAD) return FALSE;
+
+    ULONGLONG recordSize = sizeof(CacheJournalRecordHeader) + CACHE_INDEX_ALIGN((ULONGLONG)header.payloadSize);
+    if (recordSize > (ULONGLONG)(size - *offset)) return FALSE;
+
+    const BYTE* payload = data + *offset + sizeof(CacheJournalRecordHeader);
+    if (header.checksum != ComputeCacheJournalChecksum(header.type, payload, header.payloadSize)) return FALSE;
+
+    record->type = header.type;
+    record->payload = payload;
+    record->payloadSize = header.payloadSize;
+    *offset += (size_t)recordSize;
+    return TRUE;
+}
+
+// Video ID carried by a REMOVE record, or NULL if the payload is malformed
+const wchar_t* GetCacheJournalRemoveId(const CacheJournalRecord* record) {
+    if (!record || record->type != CACHE_JOURNAL_REMOVE) return NULL;
+    if (record->payloadSize < sizeof(wchar_t) * 2 || record->payloadSize % sizeof(wchar_t) != 0) return NULL;
+
+    const wchar_t* videoId = (const wchar_t*)record->payload;
+    if (videoId[record->payloadSize / sizeof(wchar_t) - 1] != L'\0') return NULL;
+    return videoId;
+}
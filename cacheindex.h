@@ -0,0 +1,173 @@
+#ifndef CACHEINDEX_H
+#define CACHEINDEX_H
+
+#include <windows.h>
+#include <stddef.h>
+
+// Binary cache index (cache_index.bin)
+//
+// Layout (all offsets are from the start of the file):
+//   CacheIndexHeader
+//   CacheIndexRecord[entryCount]      - fixed-size records, recordSize bytes each
+//   DWORD[subtitleCount]              - string offsets of all subtitle paths
+//   wchar_t[stringsSize / charSize]   - NUL-terminated string table
+//
+// The file is designed to be memory-mapped and used in place: string offsets
+// are character indices into the string table, so a loaded CacheEntry can point
+// straight into the view instead of copying every field to the heap.
+//
+// Every rewrite gives the index the next generation number, which ties it to
+// the journal appended after it (see below).
+
+#define CACHE_INDEX_FILE_NAME       L"cache_index.bin"
+#define CACHE_INDEX_MAGIC           0x49435459  // "YTCI"
+#define CACHE_INDEX_VERSION         5
+#define CACHE_INDEX_NO_STRING       0xFFFFFFFF
+#define CACHE_INDEX_MAX_FILE_SIZE   (512u * 1024u * 1024u)  // Sanity limit for mapping
+
+typedef struct {
+    DWORD magic;                // CACHE_INDEX_MAGIC
+    DWORD version;              // CACHE_INDEX_VERSION of the writer
+    DWORD headerSize;           // sizeof(CacheIndexHeader)
+    DWORD recordSize;           // Size of one record; newer writers may append fields
+    DWORD charSize;             // sizeof(wchar_t) of the writer
+    DWORD entryCount;           // Number of records
+    DWORD subtitleCount;        // Number of entries in the subtitle offset table
+    DWORD headerChecksum;       // FNV-1a of the header with this field zeroed
+    ULONGLONG recordsOffset;    // Byte offset of the first record
+    ULONGLONG subtitlesOffset;  // Byte offset of the subtitle offset table
+    ULONGLONG stringsOffset;    // Byte offset of the string table
+    ULONGLONG stringsSize;      // Size of the string table in bytes
+    // Version 5
+    ULONGLONG generation;       // One more than the index this one replaced
+} CacheIndexHeader;
+
+// Headers of versions 1 to 4 end before the generation, which reads as 0
+#define CACHE_INDEX_HEADER_V4_SIZE  offsetof(CacheIndexHeader, generation)
+
+typedef struct {
+    DWORD videoId;              // String table offsets, or CACHE_INDEX_NO_STRING
+    DWORD title;
+    DWORD duration;
+    DWORD mainVideoFile;
+    DWORD firstSubtitle;        // Index of the first slot in the subtitle offset table
+    DWORD subtitleCount;        // Number of subtitle slots used by this entry
+    FILETIME downloadTime;
+    ULONGLONG fileSize;
+    // Version 2
+    ULONGLONG lastAccessTime;   // FILETIME ticks of the last play or download, 0 if unknown
+    DWORD accessCount;          // Plays and downloads
+    DWORD reserved;
+    // Version 3
+    ULONGLONG hashWriteTime;    // FILETIME ticks of the file the hashes were taken from
+    ULONGLONG sampleHash;       // Duplicate detection hashes, 0 if not computed
+    ULONGLONG contentHash;
+    // Version 4
+    ULONGLONG verifyTime;       // FILETIME ticks of the last integrity check, 0 if never checked
+    DWORD flags;                // CACHE_INDEX_FLAG_*
+    DWORD reserved2;
+} CacheIndexRecord;
+
+#define CACHE_INDEX_FLAG_DAMAGED    0x00000001  // The last integrity check failed
+#define CACHE_INDEX_FLAG_MISSING    0x00000002  // The last reconcile did not find the main video file
+
+// Version 1 records end after fileSize; their access fields read as zero
+#define CACHE_INDEX_RECORD_V1_SIZE  (offsetof(CacheIndexRecord, fileSize) + sizeof(ULONGLONG))
+
+// Serialized index produced by BuildCacheIndexImage
+typedef struct {
+    BYTE* data;
+    size_t size;
+} CacheIndexImage;
+
+// Validated view over a serialized index (file mapping or memory buffer)
+typedef struct {
+    const BYTE* data;
+    size_t size;
+    const CacheIndexHeader* header;
+    const DWORD* subtitles;
+    const wchar_t* strings;
+    DWORD stringChars;
+    ULONGLONG generation;
+} CacheIndexReader;
+
+// Mutation journal (cache_index.journal)
+//
+// The records appended after the snapshot above was written:
+//   CacheJournalFileHeader
+//   CacheJournalRecordHeader, then its payload padded with zeros to an 8-byte
+//   boundary, for each record
+//
+// PUT payloads are a one-entry index image (add or update; replay is an upsert),
+// REMOVE payloads are the NUL-terminated video ID. A torn or corrupt record ends
+// the journal.
+//
+// Records only make sense on top of the snapshot they follow: replayed over a
+// newer one, a PUT brings back an entry that snapshot dropped. The file header
+// names the generation of the index the records follow, and a journal for any
+// other generation is ignored, so a crash between writing a new index and
+// deleting the old journal is harmless. Journals written before generations
+// existed have no file header and follow generation 0.
+
+#define CACHE_JOURNAL_FILE_NAME     L"cache_index.journal"
+#define CACHE_JOURNAL_FILE_MAGIC    0x464A5459  // "YTJF"
+#define CACHE_JOURNAL_MAGIC         0x4A435459  // "YTCJ"
+#define CACHE_JOURNAL_PUT           1
+#define CACHE_JOURNAL_REMOVE        2
+#define CACHE_JOURNAL_MAX_PAYLOAD   (16u * 1024u * 1024u)
+
+typedef struct {
+    DWORD magic;                // CACHE_JOURNAL_FILE_MAGIC
+    DWORD reserved;
+    ULONGLONG generation;       // Generation of the index the records follow
+} CacheJournalFileHeader;
+
+typedef struct {
+    DWORD magic;                // CACHE_JOURNAL_MAGIC
+    DWORD type;                 // CACHE_JOURNAL_PUT or CACHE_JOURNAL_REMOVE
+    DWORD payloadSize;          // Unpadded payload size in bytes
+    DWORD checksum;             // FNV-1a of type, payloadSize and payload
+} CacheJournalRecordHeader;
+
+// Growable buffer of encoded journal records waiting to be committed
+typedef struct {
+    BYTE* data;
+    size_t size;
+    size_t capacity;
+    DWORD recordCount;
+} CacheJournalBuffer;
+
+// Decoded record; payload points into the buffer passed to ReadCacheJournalRecord
+typedef struct {
+    DWORD type;
+    const BYTE* payload;
+    DWORD payloadSize;
+} CacheJournalRecord;
+
+struct CacheEntry;
+
+// Writing
+BOOL BuildCacheIndexImage(struct CacheEntry* const* entries, DWORD count, ULONGLONG generation, CacheIndexImage* image);
+void FreeCacheIndexImage(CacheIndexImage* image);
+
+// Reading
+BOOL OpenCacheIndexImage(const BYTE* data, size_t size, CacheIndexReader* reader);
+DWORD GetCacheIndexEntryCount(const CacheIndexReader* reader);
+ULONGLONG GetCacheIndexGeneration(const CacheIndexReader* reader);
+BOOL ReadCacheIndexRecord(const CacheIndexReader* reader, DWORD index, CacheIndexRecord* record);
+const wchar_t* GetCacheIndexString(const CacheIndexReader* reader, DWORD offset);
+const wchar_t* GetCacheIndexSubtitle(const CacheIndexReader* reader, const CacheIndexRecord* record, DWORD subtitleIndex);
+
+// Journal
+void InitCacheJournalFileHeader(CacheJournalFileHeader* header, ULONGLONG generation);
+// Where the records start and which generation they follow; FALSE if the
+// file header is torn
+BOOL ReadCacheJournalFileHeader(const BYTE* data, size_t size, size_t* recordsOffset, ULONGLONG* generation);
+BOOL AppendCacheJournalPut(CacheJournalBuffer* buffer, struct CacheEntry* entry);
+BOOL AppendCacheJournalRemove(CacheJournalBuffer* buffer, const wchar_t* videoId);
+void ResetCacheJournalBuffer(CacheJournalBuffer* buffer);
+void FreeCacheJournalBuffer(CacheJournalBuffer* buffer);
+BOOL ReadCacheJournalRecord(const BYTE* data, size_t size, size_t* offset, CacheJournalRecord* record);
+const wchar_t* GetCacheJournalRemoveId(const CacheJournalRecord* record);
+
+#endif // CACHEINDEX_H
@@ -0,0 +1,313 @@
+#include "YouTubeCacher.h"
+
+void InitCacheInfoParser(CacheInfoParser* parser) {
+    if (!parser) return;
+
+    memset(parser, 0, sizeof(CacheInfoParser));
+    parser->field = CACHE_INFO_FIELD_NONE;
+}
+
+void FreeCacheInfoParser(CacheInfoParser* parser) {
+    if (!parser) return;
+
+    for (int i = 0; i < CACHE_INFO_FIELD_COUNT; i++) {
+        if (parser->fields[i]) SAFE_FREE(parser->fields[i]);
+        parser->fields[i] = NULL;
+    }
+    parser->found = 0;
+}
+
+static int FindCacheInfoField(const char* key, DWORD length) {
+    static const char* const names[CACHE_INFO_FIELD_COUNT] = { "id", "title", "duration" };
+
+    for (int i = 0; i < CACHE_INFO_FIELD_COUNT; i++) {
+        if (strlen(names[i]) == length && memcmp(names[i], key, length) == 0) return i;
+    }
+    return CACHE_INFO_FIELD_NONE;
+}
+
+// Keep the value just read for the current field
+static void KeepCacheInfoValue(CacheInfoParser* parser) {
+    parser->capturing = FALSE;
+
+    char* copy = (char*)SAFE_MALLOC(parser->valueLength + 1);
+    if (!copy) return;
+    memcpy(copy, parser->value, parser->valueLength);
+    copy[parser->valueLength] = '\0';
+
+    if (parser->fields[parser->field]) SAFE_FREE(parser->fields[parser->field]);
+    parser->fields[parser->field] = copy;
+    parser->found |= 1u << parser->field;
+}
+
+BOOL FeedCacheInfoParser(CacheInfoParser* parser, const char* data, size_t size) {
+    if (!parser || !data || parser->failed) return FALSE;
+
+    for (size_t i = 0; i < size && !parser->complete; i++) {
+        char c = data[i];
+
+        if (parser->inString) {
+            if (parser->escape) {
+                parser->escape = FALSE;
+            } else if (c == '\\') {
+                parser->escape = TRUE;
+            } else if (c == '"') {
+                parser->inString = FALSE;
+                if (parser->readingKey) {
+                    parser->readingKey = FALSE;
+                    parser->field = parser->keyLength < sizeof(parser->key) ?
+                                    FindCacheInfoField(parser->key, parser->keyLength) : CACHE_INFO_FIELD_NONE;
+                } else if (parser->capturing) {
+                    KeepCacheInfoValue(parser);
+                }
+                continue;
+            }
+
+            // Escapes are kept as they are and decoded with the value
+            if (parser->readingKey) {
+                if (parser->keyLength < sizeof(parser->key)) parser->key[parser->keyLength] = c;
+                parser->keyLength++;
+            } else if (parser->capturing && parser->valueLength < CACHE_INFO_MAX_VALUE) {
+                parser->value[parser->valueLength++] = c;
+            }
+            continue;
+        }
+
+        if (parser->inNumber) {
+            if ((c >= '0' && c <= '9') || c == '.' || c == '-' || c == '+' || c == 'e' || c == 'E') {
+                if (parser->valueLength < CACHE_INFO_MAX_VALUE) parser->value[parser->valueLength++] = c;
+                continue;
+            }
+            parser->inNumber = FALSE;
+            KeepCacheInfoValue(parser);
+        }
+
+        switch (c) {
+            case '{':
+            case '[':
+                if (parser->depth == 0) {
+                    if (c != '{') parser->failed = TRUE;
+                    parser->expectKey = TRUE;
+                }
+                parser->depth++;
+                break;
+
+            case '}':
+            case ']':
+                if (parser->depth == 0) {
+                    parser->failed = TRUE;
+                } else if (--parser->depth == 0) {
+                    parser->complete = TRUE;
+                }
+                break;
+
+            case '"':
+                if (parser->depth == 0) {
+                    parser->failed = TRUE;
+                    break;
+                }
+                parser->inString = TRUE;
+                if (parser->depth == 1 && parser->expectKey) {
+                    parser->readingKey = TRUE;
+                    parser->keyLength = 0;
+                } else if (parser->depth == 1 && parser->field != CACHE_INFO_FIELD_NONE) {
+                    parser->capturing = TRUE;
+                    parser->valueLength = 0;
+                }
+                break;
+
+            case ':':
+                if (parser->depth == 1) parser->expectKey = FALSE;
+                break;
+
+            case ',':
+                if (parser->depth == 1) {
+                    parser->expectKey = TRUE;
+                    parser->field = CACHE_INFO_FIELD_NONE;
+                }
+                break;
+
+            default:
+                if (parser->depth == 1 && !parser->expectKey && parser->field != CACHE_INFO_FIELD_NONE &&
+                    (c == '-' || (c >= '0' && c <= '9'))) {
+                    parser->inNumber = TRUE;
+                    parser->capturing = TRUE;
+                    parser->valueLength = 0;
+                    parser->value[parser->valueLength++] = c;
+                } else if (parser->depth == 0 && c != ' ' && c != '\t' && c != '\r' && c != '\n' &&
+                           (unsigned char)c < 0x80) {
+                    // Anything but white space or a byte order mark before the object
+                    parser->failed = TRUE;
+                }
+                break;
+        }
+
+        if (parser->failed) break;
+    }
+
+    return !parser->failed;
+}
+
+static BOOL ParseCacheInfoHex(const char* digits, unsigned int* value) {
+    *value = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = digits[i];
+        unsigned int digit;
+        if (c >= '0' && c <= '9') digit = (unsigned int)(c - '0');
+        else if (c >= 'a' && c <= 'f') digit = (unsigned int)(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F') digit = (unsigned int)(c - 'A' + 10);
+        else return FALSE;
+        *value = (*value << 4) | digit;
+    }
+    return TRUE;
+}
+
+wchar_t* DecodeCacheInfoString(const char* raw, size_t length) {
+    if (!raw) return NULL;
+
+    // Never more UTF-16 units than bytes
+    wchar_t* text = (wchar_t*)SAFE_MALLOC((length + 1) * sizeof(wchar_t));
+    if (!text) return NULL;
+
+    size_t out = 0;
+    size_t i = 0;
+    while (i < length) {
+        unsigned char c = (unsigned char)raw[i];
+
+        if (c == '\\') {
+            // A value cut in the middle of an escape ends before it
+            if (i + 1 >= length) break;
+            char escape = raw[i + 1];
+            i += 2;
+            switch (escape) {
+                case 'b': text[out++] = L'\b'; break;
+                case 'f': text[out++] = L'\f'; break;
+                case 'n': text[out++] = L'\n'; break;
+                case 'r': text[out++] = L'\r'; break;
+                case 't': text[out++] = L'\t'; break;
+                case 'u': {
+                    // Already a UTF-16 unit; surrogate pairs arrive as two escapes
+                    unsigned int unit;
+                    if (i + 4 > length || !ParseCacheInfoHex(raw + i, &unit)) {
+                        i = length;
+                        break;
+                    }
+                    text[out++] = (wchar_t)unit;
+                    i += 4;
+                    break;
+                }
+                default: text[out++] = (wchar_t)escape; break;
+            }
+            continue;
+        }
+
+        // UTF-8 sequence; invalid or cut sequences become U+FFFD
+        DWORD codePoint;
+        int extra;
+        if (c < 0x80) {
+            codePoint = c;
+            extra = 0;
+        } else if ((c & 0xE0) == 0xC0) {
+            codePoint = c & 0x1F;
+            extra = 1;
+        } else if ((c & 0xF0) == 0xE0) {
+            codePoint = c & 0x0F;
+            extra = 2;
+        } else if ((c & 0xF8) == 0xF0) {
+            codePoint = c & 0x07;
+            extra = 3;
+        } else {
+            codePoint = 0xFFFD;
+            extra = 0;
+        }
+        i++;
+
+        for (int k = 0; k < extra; k++) {
+            if (i >= length || ((unsigned char)raw[i] & 0xC0) != 0x80) {
+                codePoint = 0xFFFD;
+                break;
+            }
+            codePoint = (codePoint << 6) | ((unsigned char)raw[i] & 0x3F);
+            i++;
+        }
+        if (codePoint > 0x10FFFF) codePoint = 0xFFFD;
+
+        if (codePoint >= 0x10000) {
+            codePoint -= 0x10000;
+            text[out++] = (wchar_t)(0xD800 + (codePoint >> 10));
+            text[out++] = (wchar_t)(0xDC00 + (codePoint & 0x3FF));
+        } else {
+            text[out++] = (wchar_t)codePoint;
+        }
+    }
+
+    text[out] = L'\0';
+    return text;
+}
+
+BOOL GetCacheInfoFields(const CacheInfoParser* parser, CacheInfo* info) {
+    if (!parser || !info) return FALSE;
+
+    memset(info, 0, sizeof(CacheInfo));
+
+    const char* id = parser->fields[CACHE_INFO_FIELD_ID];
+    if (!id || !*id) return FALSE;
+
+    info->id = DecodeCacheInfoString(id, strlen(id));
+    if (!info->id) return FALSE;
+
+    const char* title = parser->fields[CACHE_INFO_FIELD_TITLE];
+    if (title && *title) {
+        info->title = DecodeCacheInfoString(title, strlen(title));
+    }
+
+    const char* duration = parser->fields[CACHE_INFO_FIELD_DURATION];
+    if (duration) {
+        info->duration = strtod(duration, NULL);
+        if (info->duration < 0) info->duration = 0;
+    }
+
+    return TRUE;
+}
+
+void FreeCacheInfo(CacheInfo* info) {
+    if (!info) return;
+
+    if (info->id) SAFE_FREE(info->id);
+    if (info->title) SAFE_FREE(info->title);
+    memset(info, 0, sizeof(CacheInfo));
+}
+
+BOOL ReadCacheInfoFile(const wchar_t* path, CacheInfo* info) {
+    if (!path || !info) return FALSE;
+
+    memset(info, 0, sizeof(CacheInfo));
+
+    HANDLE hFile = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING,
+                               FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) return FALSE;
+
+    char* buffer = (char*)SAFE_MALLOC(CACHE_INFO_READ_CHUNK);
+    if (!buffer) {
+        CloseHandle(hFile);
+        return FALSE;
+    }
+
+    CacheInfoParser parser;
+    InitCacheInfoParser(&parser);
+
+    // Stop at the first chunk that completes the fields; the rest of the file is formats
+    DWORD bytesRead = 0;
+    while (parser.found != CACHE_INFO_ALL_FIELDS &&
+           ReadFile(hFile, buffer, CACHE_INFO_READ_CHUNK, &bytesRead, NULL) && bytesRead > 0) {
+        if (!FeedCacheInfoParser(&parser, buffer, bytesRead) || parser.complete) break;
+        bytesRead = 0;
+    }
+
+    BOOL success = GetCacheInfoFields(&parser, info);
+
+    FreeCacheInfoParser(&parser);
+    SAFE_FREE(buffer);
+    CloseHandle(hFile);
+    return success;
+}
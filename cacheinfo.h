@@ -0,0 +1,71 @@
+#ifndef CACHEINFO_H
+#define CACHEINFO_H
+
+#include <windows.h>
+
+// Reader for the info JSON yt-dlp writes next to each download
+// ("<name>.info.json", from --write-info-json), so a folder scan can give the
+// videos it recovers their real title and duration.
+//
+// These files run to a megabyte or more, almost all of it the formats and
+// thumbnails lists, while the fields the cache wants are top-level scalars.
+// The parser is fed the file in chunks of any size and only tracks strings
+// and nesting: everything below the top-level object is skipped without
+// being decoded, only the wanted values are kept, and reading stops as soon
+// as all of them have been seen. It is not a validator; malformed input
+// yields whatever fields were complete.
+
+#define CACHE_INFO_MAX_VALUE        2048    // Bytes of a value kept; longer values are cut
+#define CACHE_INFO_READ_CHUNK       (64 * 1024)
+
+// Top-level fields the parser keeps
+#define CACHE_INFO_FIELD_ID         0
+#define CACHE_INFO_FIELD_TITLE      1
+#define CACHE_INFO_FIELD_DURATION   2
+#define CACHE_INFO_FIELD_COUNT      3
+#define CACHE_INFO_FIELD_NONE       (-1)
+
+#define CACHE_INFO_ALL_FIELDS       ((1u << CACHE_INFO_FIELD_COUNT) - 1)
+
+typedef struct {
+    int depth;                  // Open objects and arrays; the fields are at depth 1
+    BOOL inString;
+    BOOL escape;                // The previous string byte was a backslash
+    BOOL expectKey;             // The next string at depth 1 is a key
+    BOOL readingKey;
+    BOOL inNumber;
+    BOOL capturing;             // The current string or number is a wanted value
+    BOOL complete;              // The top-level object has been closed
+    BOOL failed;                // The input is not a JSON object
+    int field;                  // CACHE_INFO_FIELD_* the current key names
+    char key[16];
+    DWORD keyLength;
+    char value[CACHE_INFO_MAX_VALUE];
+    DWORD valueLength;
+    char* fields[CACHE_INFO_FIELD_COUNT]; // Raw values, strings still escaped
+    DWORD found;                // Bit per field seen
+} CacheInfoParser;
+
+// What an info JSON says about its video
+typedef struct {
+    wchar_t* id;
+    wchar_t* title;
+    double duration;            // Seconds, 0 when unknown
+} CacheInfo;
+
+void InitCacheInfoParser(CacheInfoParser* parser);
+void FreeCacheInfoParser(CacheInfoParser* parser);
+// Feed the next chunk; returns FALSE once the input cannot be an info JSON
+BOOL FeedCacheInfoParser(CacheInfoParser* parser, const char* data, size_t size);
+// Decode the fields seen so far; fails unless a video ID was seen
+BOOL GetCacheInfoFields(const CacheInfoParser* parser, CacheInfo* info);
+
+void FreeCacheInfo(CacheInfo* info);
+
+// Read the fields of an info JSON file
+BOOL ReadCacheInfoFile(const wchar_t* path, CacheInfo* info);
+
+// Decode the contents of a JSON string (without quotes) from UTF-8 to UTF-16
+wchar_t* DecodeCacheInfoString(const char* raw, size_t length);
+
+#endif // CACHEINFO_H
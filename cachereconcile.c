@@ -0,0 +1,183 @@
+#include "YouTubeCacher.h"
+
+BOOL InitCacheDirectoryListing(CacheDirectoryListing* listing) {
+    if (!listing) return FALSE;
+
+    memset(listing, 0, sizeof(CacheDirectoryListing));
+    listing->names = CreateStringArena(0);
+    return listing->names != NULL;
+}
+
+void FreeCacheDirectoryListing(CacheDirectoryListing* listing) {
+    if (!listing) return;
+
+    if (listing->files) SAFE_FREE(listing->files);
+    if (listing->names) ReleaseStringArena(listing->names);
+    memset(listing, 0, sizeof(CacheDirectoryListing));
+}
+
+BOOL AddCacheDirectoryFile(CacheDirectoryListing* listing, const wchar_t* name, ULONGLONG size, ULONGLONG writeTime,
+                           BOOL directory) {
+    if (!listing || !listing->names || !name) return FALSE;
+
+    if (listing->count == listing->capacity) {
+        DWORD capacity = listing->capacity ? listing->capacity * 2 : CACHE_LISTING_MIN_CAPACITY;
+        CacheDirectoryFile* files = (CacheDirectoryFile*)SAFE_REALLOC(listing->files, (size_t)capacity * sizeof(CacheDirectoryFile));
+        if (!files) return FALSE;
+        listing->files = files;
+        listing->capacity = capacity;
+    }
+
+    const wchar_t* copy = StringArenaWcsDup(listing->names, name);
+    if (!copy) return FALSE;
+
+    CacheDirectoryFile* file = &listing->files[listing->count++];
+    file->name = copy;
+    file->size = size;
+    file->writeTime = writeTime;
+    file->directory = directory;
+    return TRUE;
+}
+
+static int CompareCacheDirectoryFiles(const void* a, const void* b) {
+    return _wcsicmp(((const CacheDirectoryFile*)a)->name, ((const CacheDirectoryFile*)b)->name);
+}
+
+void SortCacheDirectoryListing(CacheDirectoryListing* listing) {
+    if (!listing || listing->count < 2) return;
+
+    qsort(listing->files, listing->count, sizeof(CacheDirectoryFile), CompareCacheDirectoryFiles);
+}
+
+const CacheDirectoryFile* FindCacheDirectoryFile(const CacheDirectoryListing* listing, const wchar_t* name) {
+    if (!listing || !name) return NULL;
+
+    DWORD low = 0;
+    DWORD high = listing->count;
+    while (low < high) {
+        DWORD mid = low + (high - low) / 2;
+        int result = _wcsicmp(listing->files[mid].name, name);
+        if (result == 0) return &listing->files[mid];
+        if (result < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return NULL;
+}
+
+// Order a name against the prefix "<base>." the way the listing is sorted
+static int CompareCacheSiblingPrefix(const wchar_t* name, const wchar_t* base, size_t baseLength) {
+    int result = _wcsnicmp(name, base, baseLength);
+    if (result != 0) return result;
+    return (int)towlower(name[baseLength]) - (int)L'.';
+}
+
+// "<base>.<ext>" or "<base>.<lang>.<ext>" with a subtitle extension. A name with
+// more dots belongs to another video whose own name starts with "<base>."
+BOOL IsCacheSubtitleSibling(const wchar_t* name, size_t baseLength) {
+    if (!name || wcslen(name) <= baseLength || name[baseLength] != L'.') return FALSE;
+
+    const wchar_t* rest = name + baseLength;
+    const wchar_t* extension = wcsrchr(rest, L'.');
+    if (!IsSubtitleFileExtension(extension)) return FALSE;
+    if (extension == rest) return TRUE;
+
+    // A non-empty language tag without dots
+    if (extension == rest + 1) return FALSE;
+    for (const wchar_t* p = rest + 1; p < extension; p++) {
+        if (*p == L'.') return FALSE;
+    }
+    return TRUE;
+}
+
+void MatchCacheDirectoryFile(const CacheDirectoryListing* listing, const wchar_t* fileName, CacheDirectoryMatch* match) {
+    if (!match) return;
+    memset(match, 0, sizeof(CacheDirectoryMatch));
+    if (!listing || !fileName) return;
+
+    match->file = FindCacheDirectoryFile(listing, fileName);
+    if (match->file && match->file->directory) match->file = NULL;
+
+    const wchar_t* extension = wcsrchr(fileName, L'.');
+    match->baseLength = extension ? (size_t)(extension - fileName) : wcslen(fileName);
+
+    // Names starting with "<base>." sort together; find the first, then walk the run
+    DWORD low = 0;
+    DWORD high = listing->count;
+    while (low < high) {
+        DWORD mid = low + (high - low) / 2;
+        if (CompareCacheSiblingPrefix(listing->files[mid].name, fileName, match->baseLength) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    match->siblingFirst = low;
+    match->siblingEnd = low;
+    while (match->siblingEnd < listing->count &&
+           CompareCacheSiblingPrefix(listing->files[match->siblingEnd].name, fileName, match->baseLength) == 0) {
+        const CacheDirectoryFile* sibling = &listing->files[match->siblingEnd];
+        if (!sibling->directory && IsCacheSubtitleSibling(sibling->name, match->baseLength)) {
+            match->subtitleCount++;
+        } else if (!sibling->directory && _wcsicmp(sibling->name + match->baseLength, L".info.json") == 0) {
+            match->infoFile = sibling;
+        }
+        match->siblingEnd++;
+    }
+}
+
+// Video ID from a base name that is the ID or ends with "[<id>]"
+static BOOL GetCacheVideoIdFromBaseName(const wchar_t* name, size_t length, wchar_t* videoId) {
+    const wchar_t* id = NULL;
+    if (length == CACHE_VIDEO_ID_LENGTH) {
+        id = name;
+    } else if (length > CACHE_VIDEO_ID_LENGTH + 2 && name[length - 1] == L']' &&
+               name[length - CACHE_VIDEO_ID_LENGTH - 2] == L'[') {
+        id = name + length - CACHE_VIDEO_ID_LENGTH - 1;
+    } else {
+        return FALSE;
+    }
+
+    for (int i = 0; i < CACHE_VIDEO_ID_LENGTH; i++) {
+        if (!iswalnum(id[i]) && id[i] != L'-' && id[i] != L'_') return FALSE;
+    }
+    wcsncpy(videoId, id, CACHE_VIDEO_ID_LENGTH);
+    videoId[CACHE_VIDEO_ID_LENGTH] = L'\0';
+    return TRUE;
+}
+
+int ClassifyCacheFileName(const wchar_t* name, wchar_t* videoId) {
+    if (!name || !videoId) return CACHE_FILE_OTHER;
+
+    const wchar_t* extension = wcsrchr(name, L'.');
+    if (!extension || extension == name) return CACHE_FILE_OTHER;
+    size_t baseLength = (size_t)(extension - name);
+
+    if (IsVideoFileExtension(extension)) {
+        return GetCacheVideoIdFromBaseName(name, baseLength, videoId) ? CACHE_FILE_VIDEO : CACHE_FILE_OTHER;
+    }
+
+    if (IsSubtitleFileExtension(extension)) {
+        // "<video base>.<ext>", or "<video base>.<lang>.<ext>"
+        if (GetCacheVideoIdFromBaseName(name, baseLength, videoId)) return CACHE_FILE_SUBTITLE;
+        for (size_t i = baseLength; i > 0; i--) {
+            if (name[i - 1] == L'.') {
+                return GetCacheVideoIdFromBaseName(name, i - 1, videoId) ? CACHE_FILE_SUBTITLE : CACHE_FILE_OTHER;
+            }
+        }
+    }
+    return CACHE_FILE_OTHER;
+}
+
+const wchar_t* GetCachePathFileName(const wchar_t* path) {
+    if (!path) return NULL;
+
+    const wchar_t* name = path;
+    for (const wchar_t* p = path; *p; p++) {
+        if (*p == L'\\' || *p == L'/') name = p + 1;
+    }
+    return name;
+}
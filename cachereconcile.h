@@ -0,0 +1,73 @@
+#ifndef CACHERECONCILE_H
+#define CACHERECONCILE_H
+
+#include <windows.h>
+#include "stringarena.h"
+
+// Listing of one download directory, and the matching of cached files against it.
+//
+// Reconciling the cache with the disk reads each directory once, in large
+// batches, instead of asking about every file: the listing holds the name,
+// size and write time of each file, sorted by name ignoring case like the file
+// system. A video file is then found with a binary search, and its subtitle
+// siblings are the files named after the video without its extension,
+// optionally with a language tag ("<name>.vtt", "<name>.en.vtt"), which sort
+// next to each other. Filling the listing is left to the caller, so the
+// matching works the same on a synthetic listing.
+//
+// Video files are recognized by name: a video extension and a base name that
+// is the video ID ("<id>.mp4", the app's own downloads) or ends with it in
+// brackets ("<title> [<id>].webm", yt-dlp's default). The info JSON yt-dlp
+// writes with a download ("<base>.info.json") is found among the siblings too.
+
+#define CACHE_LISTING_MIN_CAPACITY  64
+#define CACHE_VIDEO_ID_LENGTH       11
+
+// What a file name is to the cache
+#define CACHE_FILE_OTHER            0
+#define CACHE_FILE_VIDEO            1
+#define CACHE_FILE_SUBTITLE         2
+
+typedef struct {
+    const wchar_t* name;        // File name within the directory
+    ULONGLONG size;
+    ULONGLONG writeTime;        // FILETIME ticks of the last write
+    BOOL directory;             // A subdirectory, which never matches a file
+} CacheDirectoryFile;
+
+typedef struct {
+    CacheDirectoryFile* files;  // In name order once sorted
+    DWORD count;
+    DWORD capacity;
+    StringArena* names;         // Holds every file name
+} CacheDirectoryListing;
+
+// A video file matched against a listing
+typedef struct {
+    const CacheDirectoryFile* file; // NULL when the file is missing
+    size_t baseLength;          // Characters of the name before its extension
+    DWORD siblingFirst;         // Files named "<base>.*", which include the subtitles
+    DWORD siblingEnd;
+    DWORD subtitleCount;        // Subtitle siblings among them
+    const CacheDirectoryFile* infoFile; // "<base>.info.json" among them, or NULL
+} CacheDirectoryMatch;
+
+BOOL InitCacheDirectoryListing(CacheDirectoryListing* listing);
+void FreeCacheDirectoryListing(CacheDirectoryListing* listing);
+BOOL AddCacheDirectoryFile(CacheDirectoryListing* listing, const wchar_t* name, ULONGLONG size, ULONGLONG writeTime,
+                           BOOL directory);
+void SortCacheDirectoryListing(CacheDirectoryListing* listing);
+
+// Lookups need a sorted listing
+const CacheDirectoryFile* FindCacheDirectoryFile(const CacheDirectoryListing* listing, const wchar_t* name);
+void MatchCacheDirectoryFile(const CacheDirectoryListing* listing, const wchar_t* fileName, CacheDirectoryMatch* match);
+BOOL IsCacheSubtitleSibling(const wchar_t* name, size_t baseLength);
+
+// Returns CACHE_FILE_*, with the ID of the video a video or subtitle file
+// belongs to in videoId (CACHE_VIDEO_ID_LENGTH + 1 characters)
+int ClassifyCacheFileName(const wchar_t* name, wchar_t* videoId);
+
+// File name part of a path; the directory is everything before it
+const wchar_t* GetCachePathFileName(const wchar_t* path);
+
+#endif // CACHERECONCILE_H
@@ -0,0 +1,381 @@
+#include "YouTubeCacher.h"
+
+#define CACHE_SEARCH_SEPARATOR      L'\n'
+#define CACHE_SEARCH_NO_MATCH       0xFFFFFFFFu
+#define CACHE_SEARCH_MIN_DOCS       64
+
+// Case-fold one character. The separator between title and video ID cannot
+// occur in folded text, so no trigram or match spans the two.
+static wchar_t FoldCacheSearchChar(wchar_t c) {
+    c = (wchar_t)towlower(c);
+    return c == CACHE_SEARCH_SEPARATOR ? L' ' : c;
+}
+
+// Pack three folded UTF-16 units into a posting key; the top bit keeps keys non-zero
+static ULONGLONG MakeCacheSearchTrigram(const wchar_t* text) {
+    return (1ULL << 63) |
+           ((ULONGLONG)(text[0] & 0xFFFF) << 32) |
+           ((ULONGLONG)(text[1] & 0xFFFF) << 16) |
+           (ULONGLONG)(text[2] & 0xFFFF);
+}
+
+static DWORD HashCacheSearchTrigram(ULONGLONG trigram, DWORD mask) {
+    return (DWORD)((trigram * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+}
+
+// Folded "title\nvideoId" of an entry
+static wchar_t* MakeCacheSearchText(const CacheEntry* entry, DWORD* titleLength) {
+    size_t titleChars = entry->title ? wcslen(entry->title) : 0;
+    size_t idChars = wcslen(entry->videoId);
+    wchar_t* text = (wchar_t*)SAFE_MALLOC((titleChars + idChars + 2) * sizeof(wchar_t));
+    if (!text) return NULL;
+
+    for (size_t i = 0; i < titleChars; i++) {
+        text[i] = FoldCacheSearchChar(entry->title[i]);
+    }
+    text[titleChars] = CACHE_SEARCH_SEPARATOR;
+    for (size_t i = 0; i < idChars; i++) {
+        text[titleChars + 1 + i] = FoldCacheSearchChar(entry->videoId[i]);
+    }
+    text[titleChars + 1 + idChars] = L'\0';
+
+    *titleLength = (DWORD)titleChars;
+    return text;
+}
+
+void InitCacheSearchIndex(CacheSearchIndex* index) {
+    if (!index) return;
+
+    memset(index, 0, sizeof(CacheSearchIndex));
+}
+
+void FreeCacheSearchIndex(CacheSearchIndex* index) {
+    if (!index) return;
+
+    for (DWORD i = 0; i < index->docCount; i++) {
+        if (index->docs[i].text) SAFE_FREE(index->docs[i].text);
+    }
+    if (index->docs) SAFE_FREE(index->docs);
+    for (DWORD i = 0; i < index->bucketCount; i++) {
+        if (index->buckets[i].docs) SAFE_FREE(index->buckets[i].docs);
+    }
+    if (index->buckets) SAFE_FREE(index->buckets);
+    if (index->freeDocs) SAFE_FREE(index->freeDocs);
+    InitCacheSearchIndex(index);
+}
+
+static CacheSearchPostings* FindCacheSearchPostings(const CacheSearchIndex* index, ULONGLONG trigram) {
+    if (index->bucketCount == 0) return NULL;
+
+    DWORD mask = index->bucketCount - 1;
+    for (DWORD i = HashCacheSearchTrigram(trigram, mask);; i = (i + 1) & mask) {
+        CacheSearchPostings* postings = &index->buckets[i];
+        if (postings->trigram == trigram) return postings;
+        if (postings->trigram == 0) return NULL;
+    }
+}
+
+static BOOL GrowCacheSearchBuckets(CacheSearchIndex* index) {
+    DWORD bucketCount = index->bucketCount ? index->bucketCount * 2 : CACHE_SEARCH_MIN_BUCKETS;
+    CacheSearchPostings* buckets = (CacheSearchPostings*)SAFE_MALLOC((size_t)bucketCount * sizeof(CacheSearchPostings));
+    if (!buckets) return FALSE;
+    memset(buckets, 0, (size_t)bucketCount * sizeof(CacheSearchPostings));
+
+    DWORD mask = bucketCount - 1;
+    for (DWORD i = 0; i < index->bucketCount; i++) {
+        if (index->buckets[i].trigram == 0) continue;
+
+        DWORD slot = HashCacheSearchTrigram(index->buckets[i].trigram, mask);
+        while (buckets[slot].trigram != 0) {
+            slot = (slot + 1) & mask;
+        }
+        buckets[slot] = index->buckets[i];
+    }
+
+    if (index->buckets) SAFE_FREE(index->buckets);
+    index->buckets = buckets;
+    index->bucketCount = bucketCount;
+    return TRUE;
+}
+
+// Posting list of a trigram, added empty if the trigram is new
+static CacheSearchPostings* GetCacheSearchPostings(CacheSearchIndex* index, ULONGLONG trigram) {
+    if ((index->trigramCount + 1) * 2 > index->bucketCount && !GrowCacheSearchBuckets(index)) {
+        return NULL;
+    }
+
+    DWORD mask = index->bucketCount - 1;
+    for (DWORD i = HashCacheSearchTrigram(trigram, mask);; i = (i + 1) & mask) {
+        CacheSearchPostings* postings = &index->buckets[i];
+        if (postings->trigram == trigram) return postings;
+        if (postings->trigram == 0) {
+            postings->trigram = trigram;
+            index->trigramCount++;
+            return postings;
+        }
+    }
+}
+
+static BOOL AppendCacheSearchPosting(CacheSearchPostings* postings, DWORD doc) {
+    // Documents are indexed one at a time, so a trigram repeated within one is caught at the tail
+    if (postings->count > 0 && postings->docs[postings->count - 1] == doc) return TRUE;
+
+    if (postings->count == postings->capacity) {
+        DWORD capacity = postings->capacity ? postings->capacity * 2 : 4;
+        DWORD* docs = (DWORD*)SAFE_REALLOC(postings->docs, (size_t)capacity * sizeof(DWORD));
+        if (!docs) return FALSE;
+        postings->docs = docs;
+        postings->capacity = capacity;
+    }
+    postings->docs[postings->count++] = doc;
+    return TRUE;
+}
+
+// Give an entry a document and list it under each of its trigrams. On failure
+// the index is left inconsistent and must be dropped by the caller.
+static BOOL IndexCacheSearchEntry(CacheSearchIndex* index, CacheEntry* entry) {
+    DWORD titleLength;
+    wchar_t* text = MakeCacheSearchText(entry, &titleLength);
+    if (!text) return FALSE;
+
+    DWORD doc;
+    if (index->freeCount > 0) {
+        doc = index->freeDocs[--index->freeCount];
+    } else {
+        if (index->docCount == index->docCapacity) {
+            DWORD capacity = index->docCapacity ? index->docCapacity * 2 : CACHE_SEARCH_MIN_DOCS;
+            CacheSearchDocument* docs = (CacheSearchDocument*)SAFE_REALLOC(index->docs, (size_t)capacity * sizeof(CacheSearchDocument));
+            if (!docs) {
+                SAFE_FREE(text);
+                return FALSE;
+            }
+            index->docs = docs;
+            index->docCapacity = capacity;
+        }
+        doc = index->docCount++;
+    }
+
+    index->docs[doc].text = text;
+    index->docs[doc].titleLength = titleLength;
+    index->docs[doc].listed = TRUE;
+    index->docs[doc].owner = entry;
+    entry->searchDoc = doc;
+    index->liveCount++;
+
+    for (const wchar_t* p = text; p[0] && p[1] && p[2]; p++) {
+        if (p[0] == CACHE_SEARCH_SEPARATOR || p[1] == CACHE_SEARCH_SEPARATOR || p[2] == CACHE_SEARCH_SEPARATOR) continue;
+
+        CacheSearchPostings* postings = GetCacheSearchPostings(index, MakeCacheSearchTrigram(p));
+        if (!postings || !AppendCacheSearchPosting(postings, doc)) return FALSE;
+    }
+    return TRUE;
+}
+
+// Drop removed documents from every posting list and make their slots reusable
+static void SweepCacheSearchIndex(CacheSearchIndex* index) {
+    DWORD* freeDocs = (DWORD*)SAFE_REALLOC(index->freeDocs, (size_t)(index->freeCount + index->deadCount) * sizeof(DWORD));
+    if (!freeDocs) return; // Retried on the next removal
+    index->freeDocs = freeDocs;
+
+    for (DWORD i = 0; i < index->bucketCount; i++) {
+        CacheSearchPostings* postings = &index->buckets[i];
+        DWORD kept = 0;
+        for (DWORD j = 0; j < postings->count; j++) {
+            if (index->docs[postings->docs[j]].text) {
+                postings->docs[kept++] = postings->docs[j];
+            }
+        }
+        postings->count = kept;
+    }
+
+    for (DWORD doc = 0; doc < index->docCount; doc++) {
+        if (!index->docs[doc].text && index->docs[doc].listed) {
+            index->docs[doc].listed = FALSE;
+            index->freeDocs[index->freeCount++] = doc;
+        }
+    }
+    index->deadCount = 0;
+}
+
+BOOL BuildCacheSearchIndex(CacheSearchIndex* index, const CacheColumns* columns) {
+    if (!index || !columns) return FALSE;
+
+    FreeCacheSearchIndex(index);
+    index->built = TRUE;
+
+    for (DWORD row = 0; row < columns->count; row++) {
+        if (!IndexCacheSearchEntry(index, columns->owner[row])) {
+            FreeCacheSearchIndex(index);
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+void AddCacheSearchDocument(CacheSearchIndex* index, CacheEntry* entry) {
+    if (!index || !entry || !index->built) return;
+
+    if (!IndexCacheSearchEntry(index, entry)) {
+        ThreadSafeDebugOutput(L"YouTubeCacher: AddCacheSearchDocument - ERROR: Cannot grow search index, dropping it");
+        FreeCacheSearchIndex(index);
+    }
+}
+
+void RemoveCacheSearchDocument(CacheSearchIndex* index, CacheEntry* entry) {
+    if (!index || !entry || !index->built) return;
+
+    // Entries linked while the index was not built carry a stale slot number
+    if (entry->searchDoc >= index->docCount || index->docs[entry->searchDoc].owner != entry) return;
+
+    CacheSearchDocument* doc = &index->docs[entry->searchDoc];
+    SAFE_FREE(doc->text);
+    doc->text = NULL;
+    doc->owner = NULL;
+    index->liveCount--;
+    index->deadCount++;
+
+    if (index->deadCount >= CACHE_SEARCH_SWEEP_MIN_DEAD && index->deadCount * 4 >= index->liveCount + index->deadCount) {
+        SweepCacheSearchIndex(index);
+    }
+}
+
+// Re-index an entry whose title or video ID changed in place
+void UpdateCacheSearchDocument(CacheSearchIndex* index, CacheEntry* entry) {
+    RemoveCacheSearchDocument(index, entry);
+    AddCacheSearchDocument(index, entry);
+}
+
+// Fold and trim what the user typed. Returns NULL when nothing is left to search for.
+wchar_t* FoldCacheSearchQuery(const wchar_t* text) {
+    if (!text) return NULL;
+
+    while (iswspace(*text)) text++;
+    size_t length = wcslen(text);
+    while (length > 0 && iswspace(text[length - 1])) length--;
+    if (length == 0) return NULL;
+
+    wchar_t* query = (wchar_t*)SAFE_MALLOC((length + 1) * sizeof(wchar_t));
+    if (!query) return NULL;
+
+    for (size_t i = 0; i < length; i++) {
+        query[i] = FoldCacheSearchChar(text[i]);
+    }
+    query[length] = L'\0';
+    return query;
+}
+
+// Next occurrence of the query. Titles are short, so scanning for the first
+// character and comparing from there beats a general substring search.
+static const wchar_t* FindCacheSearchText(const wchar_t* text, const wchar_t* query, size_t queryLength) {
+    for (const wchar_t* p = wcschr(text, query[0]); p; p = wcschr(p + 1, query[0])) {
+        if (wcsncmp(p, query, queryLength) == 0) return p;
+    }
+    return NULL;
+}
+
+// Rank of a document for a query, or CACHE_SEARCH_NO_MATCH
+static DWORD RankCacheSearchDocument(const CacheSearchDocument* doc, const wchar_t* query, size_t queryLength) {
+    const wchar_t* text = doc->text;
+    const wchar_t* videoId = text + doc->titleLength + 1;
+    if (wcscmp(videoId, query) == 0) return CACHE_SEARCH_RANK_ID;
+
+    DWORD rank = CACHE_SEARCH_NO_MATCH;
+    for (const wchar_t* found = FindCacheSearchText(text, query, queryLength); found;
+         found = FindCacheSearchText(found + 1, query, queryLength)) {
+        if (found >= videoId) {
+            return rank == CACHE_SEARCH_NO_MATCH ? CACHE_SEARCH_RANK_ID_PART : rank;
+        }
+        if (found == text) return CACHE_SEARCH_RANK_PREFIX;
+        if (!iswalnum(found[-1])) return CACHE_SEARCH_RANK_WORD;
+        rank = CACHE_SEARCH_RANK_TITLE;
+    }
+    return rank;
+}
+
+// Find every entry whose folded title or video ID contains the folded query,
+// best match first. The caller frees *matches with SAFE_FREE.
+BOOL SearchCacheIndex(const CacheSearchIndex* index, const wchar_t* query, CacheSearchMatch** matches, DWORD* count) {
+    if (!index || !query || !matches || !count) return FALSE;
+
+    *matches = NULL;
+    *count = 0;
+    if (!index->built) return FALSE;
+
+    // Candidates are the documents of the rarest trigram, or every slot for short queries
+    size_t queryLength = wcslen(query);
+    const DWORD* candidates = NULL;
+    DWORD candidateCount = index->docCount;
+    if (queryLength >= 3) {
+        const CacheSearchPostings* rarest = NULL;
+        for (size_t i = 0; i + 3 <= queryLength; i++) {
+            const CacheSearchPostings* postings = FindCacheSearchPostings(index, MakeCacheSearchTrigram(query + i));
+            if (!postings || postings->count == 0) return TRUE; // No document has this trigram
+            if (!rarest || postings->count < rarest->count) rarest = postings;
+        }
+        candidates = rarest->docs;
+        candidateCount = rarest->count;
+    }
+    if (queryLength == 0 || candidateCount == 0 || index->liveCount == 0) return TRUE;
+
+    DWORD capacity = candidateCount < index->liveCount ? candidateCount : index->liveCount;
+    CacheSearchMatch* found = (CacheSearchMatch*)SAFE_MALLOC((size_t)capacity * sizeof(CacheSearchMatch));
+    if (!found) return FALSE;
+
+    DWORD foundCount = 0;
+    DWORD rankCounts[CACHE_SEARCH_RANK_COUNT] = {0};
+    for (DWORD i = 0; i < candidateCount && foundCount < capacity; i++) {
+        DWORD doc = candidates ? candidates[i] : i;
+        const CacheSearchDocument* document = &index->docs[doc];
+        if (!document->text) continue;
+
+        DWORD rank = RankCacheSearchDocument(document, query, queryLength);
+        if (rank != CACHE_SEARCH_NO_MATCH) {
+            found[foundCount].entry = document->owner;
+            found[foundCount].rank = rank;
+            foundCount++;
+            rankCounts[rank]++;
+        }
+    }
+
+    if (foundCount > 0) {
+        *matches = (CacheSearchMatch*)SAFE_MALLOC((size_t)foundCount * sizeof(CacheSearchMatch));
+        if (!*matches) {
+            SAFE_FREE(found);
+            return FALSE;
+        }
+
+        // Few ranks, so a counting sort orders them in one pass; ties keep index order
+        DWORD next[CACHE_SEARCH_RANK_COUNT];
+        DWORD offset = 0;
+        for (DWORD rank = 0; rank < CACHE_SEARCH_RANK_COUNT; rank++) {
+            next[rank] = offset;
+            offset += rankCounts[rank];
+        }
+        for (DWORD i = 0; i < foundCount; i++) {
+            (*matches)[next[found[i].rank]++] = found[i];
+        }
+    }
+    *count = foundCount;
+
+    SAFE_FREE(found);
+    return TRUE;
+}
+
+// Whether one entry matches a folded query, for filtering entries that changed
+// after a search. Entries missing from the index are folded on the spot.
+BOOL MatchCacheSearchEntry(const CacheSearchIndex* index, const CacheEntry* entry, const wchar_t* query) {
+    if (!entry || !query) return FALSE;
+
+    if (index && index->built && entry->searchDoc < index->docCount &&
+        index->docs[entry->searchDoc].owner == entry) {
+        return wcsstr(index->docs[entry->searchDoc].text, query) != NULL;
+    }
+
+    DWORD titleLength;
+    wchar_t* text = MakeCacheSearchText(entry, &titleLength);
+    if (!text) return FALSE;
+
+    BOOL match = wcsstr(text, query) != NULL;
+    SAFE_FREE(text);
+    return match;
+}
@@ -0,0 +1,82 @@
+#ifndef CACHESEARCH_H
+#define CACHESEARCH_H
+
+#include <windows.h>
+#include "cachecolumns.h"
+
+// Trigram index over the case-folded titles and video IDs of cached entries.
+//
+// Each indexed entry owns one document holding its folded text, and every
+// distinct three-character sequence of that text maps to a posting list of
+// documents. A query of three or more characters takes the shortest posting
+// list among its trigrams as candidates and confirms each candidate with a
+// substring check, so its cost follows the rarest trigram of the query instead
+// of the size of the cache. Shorter queries scan every document.
+//
+// The index is built on the first search and kept current as entries are
+// linked, unlinked and updated, all under the cache lock. Removed documents are
+// only marked dead; they are swept out of the posting lists once they make up a
+// quarter of the index. If an update cannot allocate, the index drops itself
+// and the next search builds it again.
+
+#define CACHE_SEARCH_MIN_BUCKETS    1024
+#define CACHE_SEARCH_SWEEP_MIN_DEAD 64
+
+// Match ranks, best first
+#define CACHE_SEARCH_RANK_ID        0   // The query is the video ID
+#define CACHE_SEARCH_RANK_PREFIX    1   // The title starts with the query
+#define CACHE_SEARCH_RANK_WORD      2   // A word of the title starts with the query
+#define CACHE_SEARCH_RANK_TITLE     3   // The query is inside a title word
+#define CACHE_SEARCH_RANK_ID_PART   4   // The query is only part of the video ID
+#define CACHE_SEARCH_RANK_COUNT     5
+
+struct CacheEntry;
+
+typedef struct {
+    wchar_t* text;                  // Folded "title\nvideoId", NULL once removed
+    DWORD titleLength;              // Characters before the separator
+    BOOL listed;                    // Still referenced from posting lists
+    struct CacheEntry* owner;
+} CacheSearchDocument;
+
+typedef struct {
+    ULONGLONG trigram;              // 0 for an empty bucket
+    DWORD* docs;                    // Documents containing the trigram, in insertion order
+    DWORD count;
+    DWORD capacity;
+} CacheSearchPostings;
+
+typedef struct {
+    CacheSearchDocument* docs;      // Indexed by entry->searchDoc
+    DWORD docCount;                 // Slots handed out, in any state
+    DWORD docCapacity;
+    DWORD liveCount;
+    DWORD deadCount;                // Removed but still in posting lists
+    DWORD* freeDocs;                // Swept slots ready for reuse
+    DWORD freeCount;
+    CacheSearchPostings* buckets;   // Open addressing on the trigram, power-of-two size
+    DWORD bucketCount;
+    DWORD trigramCount;
+    BOOL built;                     // FALSE until built, and again after a failed update
+} CacheSearchIndex;
+
+typedef struct {
+    struct CacheEntry* entry;
+    DWORD rank;                     // CACHE_SEARCH_RANK_*
+} CacheSearchMatch;
+
+void InitCacheSearchIndex(CacheSearchIndex* index);
+void FreeCacheSearchIndex(CacheSearchIndex* index);
+BOOL BuildCacheSearchIndex(CacheSearchIndex* index, const CacheColumns* columns);
+
+// Keep a built index current; these do nothing while the index is not built
+void AddCacheSearchDocument(CacheSearchIndex* index, struct CacheEntry* entry);
+void RemoveCacheSearchDocument(CacheSearchIndex* index, struct CacheEntry* entry);
+void UpdateCacheSearchDocument(CacheSearchIndex* index, struct CacheEntry* entry);
+
+// Queries are folded with FoldCacheSearchQuery first
+wchar_t* FoldCacheSearchQuery(const wchar_t* text);
+BOOL SearchCacheIndex(const CacheSearchIndex* index, const wchar_t* query, CacheSearchMatch** matches, DWORD* count);
+BOOL MatchCacheSearchEntry(const CacheSearchIndex* index, const struct CacheEntry* entry, const wchar_t* query);
+
+#endif // CACHESEARCH_H
@@ -0,0 +1,152 @@
+#include "YouTubeCacher.h"
+
+// Order two linked entries by the sort column, then by video ID
+static int CompareSortedEntries(const CacheSortOrder* sortOrder, const CacheColumns* columns,
+                                const CacheEntry* a, const CacheEntry* b) {
+    int result = CompareCacheColumnsRows(columns, a->row, b->row, sortOrder->column);
+    if (!sortOrder->ascending) result = -result;
+    if (result == 0) result = wcscmp(a->videoId, b->videoId);
+    return result;
+}
+
+static BOOL GrowCacheSortOrder(CacheSortOrder* sortOrder, DWORD needed) {
+    if (needed <= sortOrder->capacity) return TRUE;
+
+    DWORD capacity = sortOrder->capacity ? sortOrder->capacity : CACHE_COLUMNS_MIN_CAPACITY;
+    while (capacity < needed) {
+        if (capacity > 0x7FFFFFFFu) return FALSE;
+        capacity *= 2;
+    }
+
+    CacheEntry** order = (CacheEntry**)SAFE_REALLOC(sortOrder->order, (size_t)capacity * sizeof(CacheEntry*));
+    if (!order) return FALSE;
+    sortOrder->order = order;
+    sortOrder->capacity = capacity;
+    return TRUE;
+}
+
+void InitCacheSortOrder(CacheSortOrder* sortOrder) {
+    if (!sortOrder) return;
+
+    memset(sortOrder, 0, sizeof(CacheSortOrder));
+    sortOrder->column = CACHE_SORT_NONE;
+    sortOrder->ascending = TRUE;
+}
+
+void FreeCacheSortOrder(CacheSortOrder* sortOrder) {
+    if (!sortOrder) return;
+
+    if (sortOrder->order) SAFE_FREE(sortOrder->order);
+    InitCacheSortOrder(sortOrder);
+}
+
+BOOL IsCacheSortOrderActive(const CacheSortOrder* sortOrder) {
+    return sortOrder && sortOrder->column != CACHE_SORT_NONE && sortOrder->valid;
+}
+
+// Sort every row of the columns into a new permutation (bottom-up merge sort)
+BOOL BuildCacheSortOrder(CacheSortOrder* sortOrder, const CacheColumns* columns, int column, BOOL ascending) {
+    if (!sortOrder || !columns) return FALSE;
+
+    sortOrder->column = column;
+    sortOrder->ascending = ascending;
+    sortOrder->valid = FALSE;
+    sortOrder->count = 0;
+    if (column == CACHE_SORT_NONE) return TRUE;
+
+    DWORD count = columns->count;
+    if (count == 0) {
+        sortOrder->valid = TRUE;
+        return TRUE;
+    }
+    if (!GrowCacheSortOrder(sortOrder, count)) return FALSE;
+
+    CacheEntry** scratch = NULL;
+    if (count > 1) {
+        scratch = (CacheEntry**)SAFE_MALLOC((size_t)count * sizeof(CacheEntry*));
+        if (!scratch) return FALSE;
+    }
+
+    CacheEntry** src = sortOrder->order;
+    CacheEntry** dst = scratch;
+    memcpy(src, columns->owner, (size_t)count * sizeof(CacheEntry*));
+
+    for (DWORD width = 1; width < count; width *= 2) {
+        for (DWORD left = 0; left < count; left += 2 * width) {
+            DWORD mid = (count - left > width) ? left + width : count;
+            DWORD right = (count - mid > width) ? mid + width : count;
+            DWORD i = left, j = mid, k = left;
+            while (i < mid && j < right) {
+                dst[k++] = CompareSortedEntries(sortOrder, columns, src[i], src[j]) <= 0 ? src[i++] : src[j++];
+            }
+            while (i < mid) dst[k++] = src[i++];
+            while (j < right) dst[k++] = src[j++];
+        }
+        CacheEntry** swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    if (src != sortOrder->order) {
+        memcpy(sortOrder->order, src, (size_t)count * sizeof(CacheEntry*));
+    }
+    if (scratch) SAFE_FREE(scratch);
+
+    sortOrder->count = count;
+    sortOrder->valid = TRUE;
+    return TRUE;
+}
+
+// Insert a newly linked entry at its sorted position. The entry must already
+// have a row in the columns. Does nothing while no sort is active.
+BOOL InsertCacheSortOrder(CacheSortOrder* sortOrder, const CacheColumns* columns, CacheEntry* entry) {
+    if (!IsCacheSortOrderActive(sortOrder)) return TRUE;
+
+    if (!GrowCacheSortOrder(sortOrder, sortOrder->count + 1)) {
+        sortOrder->valid = FALSE;
+        return FALSE;
+    }
+
+    DWORD low = 0, high = sortOrder->count;
+    while (low < high) {
+        DWORD mid = low + (high - low) / 2;
+        if (CompareSortedEntries(sortOrder, columns, sortOrder->order[mid], entry) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    memmove(&sortOrder->order[low + 1], &sortOrder->order[low], (size_t)(sortOrder->count - low) * sizeof(CacheEntry*));
+    sortOrder->order[low] = entry;
+    sortOrder->count++;
+    return TRUE;
+}
+
+// Remove an entry before its row leaves the columns. Keys are looked up by
+// binary search; a linear scan covers an entry whose title changed in place.
+void RemoveCacheSortOrder(CacheSortOrder* sortOrder, const CacheColumns* columns, const CacheEntry* entry) {
+    if (!IsCacheSortOrderActive(sortOrder)) return;
+
+    DWORD low = 0, high = sortOrder->count;
+    while (low < high) {
+        DWORD mid = low + (high - low) / 2;
+        if (CompareSortedEntries(sortOrder, columns, sortOrder->order[mid], entry) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    DWORD index = low;
+    if (index >= sortOrder->count || sortOrder->order[index] != entry) {
+        index = 0;
+        while (index < sortOrder->count && sortOrder->order[index] != entry) {
+            index++;
+        }
+        if (index == sortOrder->count) return;
+    }
+
+    sortOrder->count--;
+    memmove(&sortOrder->order[index], &sortOrder->order[index + 1], (size_t)(sortOrder->count - index) * sizeof(CacheEntry*));
+}
@@ -0,0 +1,35 @@
+#ifndef CACHESORT_H
+#define CACHESORT_H
+
+#include <windows.h>
+#include "cachecolumns.h"
+
+// Display order of the cache list as a permutation of entries.
+//
+// The order is built once per sort request from the CacheColumns keys and then
+// kept sorted as entries are linked and unlinked, so the list never has to be
+// re-sorted for a single change. Ties on the sort column are broken by video
+// ID, which makes the order total and lets removal find an entry by binary
+// search. Sorting and maintenance happen under the cache lock.
+
+#define CACHE_SORT_NONE -1          // Keep list (insertion) order; no permutation is maintained
+
+struct CacheEntry;
+
+typedef struct {
+    int column;                     // CACHE_COLUMN_* the order is sorted by, or CACHE_SORT_NONE
+    BOOL ascending;
+    BOOL valid;                     // FALSE when maintenance failed and a rebuild is due
+    struct CacheEntry** order;      // Entries in display order
+    DWORD count;
+    DWORD capacity;
+} CacheSortOrder;
+
+void InitCacheSortOrder(CacheSortOrder* sortOrder);
+void FreeCacheSortOrder(CacheSortOrder* sortOrder);
+BOOL BuildCacheSortOrder(CacheSortOrder* sortOrder, const CacheColumns* columns, int column, BOOL ascending);
+BOOL InsertCacheSortOrder(CacheSortOrder* sortOrder, const CacheColumns* columns, struct CacheEntry* entry);
+void RemoveCacheSortOrder(CacheSortOrder* sortOrder, const CacheColumns* columns, const struct CacheEntry* entry);
+BOOL IsCacheSortOrderActive(const CacheSortOrder* sortOrder);
+
+#endif // CACHESORT_H
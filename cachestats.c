@@ -0,0 +1,97 @@
+#include "YouTubeCacher.h"
+
+void InitCacheStatsCounter(CacheStatsCounter* counter) {
+    if (!counter) return;
+
+    memset(&counter->stats, 0, sizeof(CacheStats));
+    counter->sequence = 0;
+}
+
+void MakeCacheStatsItem(CacheStatsItem* item, ULONGLONG bytes, int subtitleFiles, BOOL missing, BOOL damaged, BOOL inRoot) {
+    item->bytes = bytes;
+    item->subtitleFiles = subtitleFiles > 0 ? (DWORD)subtitleFiles : 0;
+    item->flags = CACHE_STATS_COUNTED;
+    if (missing) item->flags |= CACHE_STATS_MISSING;
+    if (damaged) item->flags |= CACHE_STATS_DAMAGED;
+    if (inRoot) item->flags |= CACHE_STATS_IN_ROOT;
+}
+
+// Add (sign 1) or take away (sign -1) one item. Unsigned wraparound makes the
+// subtraction exact as long as the item was added before.
+static void ApplyCacheStatsItem(CacheStats* stats, const CacheStatsItem* item, int sign) {
+    if (!(item->flags & CACHE_STATS_COUNTED)) return;
+
+    ULONGLONG bytes = sign > 0 ? item->bytes : (ULONGLONG)0 - item->bytes;
+    DWORD one = sign > 0 ? 1 : (DWORD)-1;
+    DWORD subtitleFiles = sign > 0 ? item->subtitleFiles : (DWORD)0 - item->subtitleFiles;
+
+    stats->totalBytes += bytes;
+    stats->entries += one;
+    stats->subtitleFiles += subtitleFiles;
+    if (item->subtitleFiles > 0) stats->subtitledEntries += one;
+    if (item->flags & CACHE_STATS_MISSING) stats->missingEntries += one;
+    if (item->flags & CACHE_STATS_DAMAGED) stats->damagedEntries += one;
+    if (item->flags & CACHE_STATS_IN_ROOT) {
+        stats->rootBytes += bytes;
+        stats->rootEntries += one;
+    }
+}
+
+// Replace what an entry counted with current (an item with no flags takes the
+// entry out of the totals) and remember current as what it counts now. Writers
+// must not run this concurrently; the cache lock keeps them apart.
+void UpdateCacheStats(CacheStatsCounter* counter, CacheStatsItem* counted, const CacheStatsItem* current) {
+    if (!counter || !counted || !current) return;
+    if (memcmp(counted, current, sizeof(CacheStatsItem)) == 0) return;
+
+    InterlockedIncrement(&counter->sequence);
+    ApplyCacheStatsItem(&counter->stats, counted, -1);
+    ApplyCacheStatsItem(&counter->stats, current, 1);
+    InterlockedIncrement(&counter->sequence);
+
+    *counted = *current;
+}
+
+// Copy the totals as they were between two updates. A writer holds the
+// sequence odd for a handful of additions, so the retries are short.
+void ReadCacheStats(const CacheStatsCounter* counter, CacheStats* stats) {
+    if (!stats) return;
+    if (!counter) {
+        memset(stats, 0, sizeof(CacheStats));
+        return;
+    }
+
+    for (;;) {
+        LONG before = counter->sequence;
+        MemoryBarrier();
+        if (before & 1) {
+            Sleep(0);
+            continue;
+        }
+        *stats = counter->stats;
+        MemoryBarrier();
+        if (counter->sequence == before) return;
+    }
+}
+
+// Totals recounted from scratch, to check the running ones against
+void SumCacheStatsItems(const CacheStatsItem* items, DWORD count, CacheStats* stats) {
+    if (!stats) return;
+
+    memset(stats, 0, sizeof(CacheStats));
+    for (DWORD i = 0; items && i < count; i++) {
+        ApplyCacheStatsItem(stats, &items[i], 1);
+    }
+}
+
+// Whether path is a file inside the folder root (or a folder below it), ignoring case
+BOOL IsCacheRootPath(const wchar_t* root, const wchar_t* path) {
+    if (!root || !path) return FALSE;
+
+    size_t length = wcslen(root);
+    while (length > 0 && (root[length - 1] == L'\\' || root[length - 1] == L'/')) {
+        length--;
+    }
+    if (length == 0 || _wcsnicmp(root, path, length) != 0) return FALSE;
+    return (path[length] == L'\\' || path[length] == L'/') && path[length + 1] != L'\0';
+}
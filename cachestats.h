@@ -0,0 +1,50 @@
+#ifndef CACHESTATS_H
+#define CACHESTATS_H
+
+#include <windows.h>
+
+// Running totals of the cache, kept up to date by every mutation.
+//
+// Each linked entry remembers what it last added to the totals. Whenever an
+// entry changes, that contribution is replaced by one made from its current
+// fields, so keeping the totals costs O(1) per change and no path has to know
+// the old values. Writers update the totals under the cache lock; readers on
+// any thread take a consistent copy without it, retrying while a write is in
+// progress, so status queries never walk the cache or wait for a writer.
+
+// What one entry adds to the totals
+typedef struct {
+    ULONGLONG bytes;            // Video and subtitle bytes as recorded on the entry
+    DWORD subtitleFiles;
+    DWORD flags;                // CACHE_STATS_*
+} CacheStatsItem;
+
+#define CACHE_STATS_COUNTED     0x01    // The item is in the totals
+#define CACHE_STATS_MISSING     0x02    // The video file was not found on disk
+#define CACHE_STATS_DAMAGED     0x04    // The video file failed its integrity check
+#define CACHE_STATS_IN_ROOT     0x08    // The video file is inside the download folder
+
+typedef struct {
+    ULONGLONG totalBytes;
+    ULONGLONG rootBytes;        // Bytes of the entries inside the download folder
+    DWORD entries;
+    DWORD rootEntries;          // Entries whose video file is inside the download folder
+    DWORD missingEntries;
+    DWORD damagedEntries;
+    DWORD subtitledEntries;     // Entries with at least one subtitle file
+    DWORD subtitleFiles;
+} CacheStats;
+
+typedef struct {
+    CacheStats stats;
+    volatile LONG sequence;     // Odd while a writer is changing stats
+} CacheStatsCounter;
+
+void InitCacheStatsCounter(CacheStatsCounter* counter);
+void MakeCacheStatsItem(CacheStatsItem* item, ULONGLONG bytes, int subtitleFiles, BOOL missing, BOOL damaged, BOOL inRoot);
+void UpdateCacheStats(CacheStatsCounter* counter, CacheStatsItem* counted, const CacheStatsItem* current);
+void ReadCacheStats(const CacheStatsCounter* counter, CacheStats* stats);
+void SumCacheStatsItems(const CacheStatsItem* items, DWORD count, CacheStats* stats);
+BOOL IsCacheRootPath(const wchar_t* root, const wchar_t* path);
+
+#endif // CACHESTATS_H
@@ -0,0 +1,201 @@
+#include "YouTubeCacher.h"
+
+// FNV-1a over the UTF-16/UTF-32 code units of a video ID
+static DWORD HashVideoId(const wchar_t* videoId) {
+    DWORD hash = 2166136261u;
+    for (const wchar_t* p = videoId; *p; p++) {
+        hash ^= (DWORD)*p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Smallest power-of-two capacity that holds expectedEntries under the load limit
+static DWORD GetCacheTableCapacityFor(DWORD expectedEntries) {
+    ULONGLONG needed = ((ULONGLONG)expectedEntries * 100 + CACHE_TABLE_MAX_LOAD_PERCENT - 1) / CACHE_TABLE_MAX_LOAD_PERCENT;
+    ULONGLONG capacity = CACHE_TABLE_MIN_CAPACITY;
+    while (capacity < needed) {
+        capacity <<= 1;
+    }
+    return capacity > 0x80000000u ? 0 : (DWORD)capacity;
+}
+
+// Place an entry into a slot array known to have room and not to contain the key
+static void PlaceCacheTableSlot(CacheTableSlot* slots, DWORD capacity, DWORD hash, CacheEntry* entry) {
+    DWORD mask = capacity - 1;
+    DWORD index = hash & mask;
+    while (slots[index].entry) {
+        index = (index + 1) & mask;
+    }
+    slots[index].hash = hash;
+    slots[index].entry = entry;
+}
+
+static BOOL ResizeCacheHashTable(CacheHashTable* table, DWORD newCapacity) {
+    CacheTableSlot* newSlots = (CacheTableSlot*)SAFE_MALLOC((size_t)newCapacity * sizeof(CacheTableSlot));
+    if (!newSlots) return FALSE;
+    memset(newSlots, 0, (size_t)newCapacity * sizeof(CacheTableSlot));
+
+    for (DWORD i = 0; i < table->capacity; i++) {
+        if (table->slots[i].entry) {
+            PlaceCacheTableSlot(newSlots, newCapacity, table->slots[i].hash, table->slots[i].entry);
+        }
+    }
+
+    if (table->slots) SAFE_FREE(table->slots);
+    table->slots = newSlots;
+    table->capacity = newCapacity;
+    return TRUE;
+}
+
+// Find the slot holding videoId, or the empty slot that ends its probe sequence
+static DWORD FindCacheTableSlot(const CacheHashTable* table, DWORD hash, const wchar_t* videoId) {
+    DWORD mask = table->capacity - 1;
+    DWORD index = hash & mask;
+    while (table->slots[index].entry) {
+        if (table->slots[index].hash == hash &&
+            wcscmp(table->slots[index].entry->videoId, videoId) == 0) {
+            break;
+        }
+        index = (index + 1) & mask;
+    }
+    return index;
+}
+
+BOOL InitCacheHashTable(CacheHashTable* table, DWORD expectedEntries) {
+    if (!table) return FALSE;
+
+    table->slots = NULL;
+    table->capacity = 0;
+    table->count = 0;
+    return ReserveCacheHashTable(table, expectedEntries);
+}
+
+void FreeCacheHashTable(CacheHashTable* table) {
+    if (!table) return;
+
+    if (table->slots) {
+        SAFE_FREE(table->slots);
+        table->slots = NULL;
+    }
+    table->capacity = 0;
+    table->count = 0;
+}
+
+// Forget all entries but keep the slot array
+void ClearCacheHashTable(CacheHashTable* table) {
+    if (!table) return;
+
+    if (table->slots) {
+        memset(table->slots, 0, (size_t)table->capacity * sizeof(CacheTableSlot));
+    }
+    table->count = 0;
+}
+
+// Grow ahead of a bulk load so it does not rehash repeatedly
+BOOL ReserveCacheHashTable(CacheHashTable* table, DWORD expectedEntries) {
+    if (!table) return FALSE;
+
+    DWORD capacity = GetCacheTableCapacityFor(expectedEntries);
+    if (capacity == 0) return FALSE;
+    if (capacity <= table->capacity) return TRUE;
+    return ResizeCacheHashTable(table, capacity);
+}
+
+// Insert an entry, replacing any entry with the same video ID
+BOOL CacheHashTableInsert(CacheHashTable* table, CacheEntry* entry) {
+    if (!table || !entry || !entry->videoId) return FALSE;
+
+    // Double once the insert would push the load factor past the limit
+    if ((ULONGLONG)(table->count + 1) * 100 > (ULONGLONG)table->capacity * CACHE_TABLE_MAX_LOAD_PERCENT) {
+        DWORD newCapacity = table->capacity ? table->capacity * 2 : CACHE_TABLE_MIN_CAPACITY;
+        if (newCapacity == 0 || !ResizeCacheHashTable(table, newCapacity)) {
+            // Growth failed; keep going above the load limit while a free slot remains
+            if (table->count + 1 >= table->capacity) return FALSE;
+        }
+    }
+
+    DWORD hash = HashVideoId(entry->videoId);
+    DWORD index = FindCacheTableSlot(table, hash, entry->videoId);
+    if (!table->slots[index].entry) {
+        table->count++;
+    }
+    table->slots[index].hash = hash;
+    table->slots[index].entry = entry;
+    return TRUE;
+}
+
+CacheEntry* CacheHashTableFind(const CacheHashTable* table, const wchar_t* videoId) {
+    if (!table || !videoId || table->count == 0) return NULL;
+
+    DWORD index = FindCacheTableSlot(table, HashVideoId(videoId), videoId);
+    return table->slots[index].entry;
+}
+
+// Remove and return the entry for videoId. Later members of the probe run are
+// shifted back into the hole so every remaining key stays reachable.
+CacheEntry* CacheHashTableRemove(CacheHashTable* table, const wchar_t* videoId) {
+    if (!table || !videoId || table->count == 0) return NULL;
+
+    DWORD mask = table->capacity - 1;
+    DWORD hole = FindCacheTableSlot(table, HashVideoId(videoId), videoId);
+    CacheEntry* removed = table->slots[hole].entry;
+    if (!removed) return NULL;
+
+    DWORD index = hole;
+    for (;;) {
+        index = (index + 1) & mask;
+        if (!table->slots[index].entry) break;
+
+        // Move the slot back only if its home position is not in (hole, index]
+        DWORD home = table->slots[index].hash & mask;
+        if (((index - home) & mask) >= ((index - hole) & mask)) {
+            table->slots[hole] = table->slots[index];
+            hole = index;
+        }
+    }
+
+    table->slots[hole].entry = NULL;
+    table->slots[hole].hash = 0;
+    table->count--;
+    return removed;
+}
+
+// Keep only the last entry of each video ID, the way a later index line
+// replaces an earlier one. The kept entries move to the front in their
+// original order and the replaced ones follow them. Returns the number kept;
+// when memory runs out nothing is moved and count is returned.
+DWORD KeepLastCacheEntries(CacheEntry** entries, DWORD count) {
+    if (!entries || count < 2) return count;
+
+    CacheHashTable latest;
+    CacheEntry** replaced = (CacheEntry**)SAFE_MALLOC((size_t)count * sizeof(CacheEntry*));
+    if (!replaced || !InitCacheHashTable(&latest, count)) {
+        if (replaced) SAFE_FREE(replaced);
+        return count;
+    }
+
+    // Inserting an ID again replaces its entry, so the table ends up with the last of each
+    for (DWORD i = 0; i < count; i++) {
+        if (!CacheHashTableInsert(&latest, entries[i])) {
+            FreeCacheHashTable(&latest);
+            SAFE_FREE(replaced);
+            return count;
+        }
+    }
+
+    DWORD kept = 0;
+    DWORD replacedCount = 0;
+    for (DWORD i = 0; i < count; i++) {
+        if (CacheHashTableFind(&latest, entries[i]->videoId) == entries[i]) {
+            entries[kept++] = entries[i];
+        } else {
+            replaced[replacedCount++] = entries[i];
+        }
+    }
+    memcpy(&entries[kept], replaced, (size_t)replacedCount * sizeof(CacheEntry*));
+
+    FreeCacheHashTable(&latest);
+    SAFE_FREE(replaced);
+    return kept;
+}
@@ -0,0 +1,39 @@
+#ifndef CACHETABLE_H
+#define CACHETABLE_H
+
+#include <windows.h>
+
+// Open-addressing hash table mapping video IDs to cache entries.
+//
+// Linear probing over a power-of-two slot array. Each slot keeps the full hash
+// next to the entry pointer, so probes compare hashes in one contiguous array and
+// only dereference an entry (and its videoId) on a hash match. The table doubles
+// when the load factor would exceed CACHE_TABLE_MAX_LOAD_PERCENT. Removal uses
+// backward-shift deletion, so there are no tombstones and lookups never degrade.
+
+#define CACHE_TABLE_MIN_CAPACITY        64
+#define CACHE_TABLE_MAX_LOAD_PERCENT    70
+
+struct CacheEntry;
+
+typedef struct {
+    DWORD hash;                 // Full hash of entry->videoId (valid when entry != NULL)
+    struct CacheEntry* entry;   // NULL marks an empty slot
+} CacheTableSlot;
+
+typedef struct {
+    CacheTableSlot* slots;
+    DWORD capacity;             // Power of two, or 0 before first insert
+    DWORD count;
+} CacheHashTable;
+
+BOOL InitCacheHashTable(CacheHashTable* table, DWORD expectedEntries);
+void FreeCacheHashTable(CacheHashTable* table);
+void ClearCacheHashTable(CacheHashTable* table);
+BOOL ReserveCacheHashTable(CacheHashTable* table, DWORD expectedEntries);
+BOOL CacheHashTableInsert(CacheHashTable* table, struct CacheEntry* entry);
+struct CacheEntry* CacheHashTableFind(const CacheHashTable* table, const wchar_t* videoId);
+struct CacheEntry* CacheHashTableRemove(CacheHashTable* table, const wchar_t* videoId);
+DWORD KeepLastCacheEntries(struct CacheEntry** entries, DWORD count);
+
+#endif // CACHETABLE_H
@@ -0,0 +1,26 @@
+#include "YouTubeCacher.h"
+
+int CheckCacheVerifyChecksum(const CacheVerifyChecksum* stored, const CacheVerifyChecksum* current) {
+    if (!stored || stored->hash == 0) return CACHE_VERIFY_BASELINE;
+
+    // Writing a file moves its write time; anything else changing it is damage
+    if (current->writeTime != stored->writeTime) return CACHE_VERIFY_CHANGED;
+    return current->hash == stored->hash ? CACHE_VERIFY_OK : CACHE_VERIFY_DAMAGED;
+}
+
+ULONGLONG GetCacheVerifyDueTime(ULONGLONG verifyTime) {
+    return verifyTime == 0 ? 0 : verifyTime + CACHE_VERIFY_INTERVAL;
+}
+
+ULONGLONG GetCacheVerifyRetryTime(ULONGLONG now) {
+    // Never 0, which would make the file due at once
+    if (now <= CACHE_VERIFY_INTERVAL - CACHE_VERIFY_RETRY) return 1;
+    return now - (CACHE_VERIFY_INTERVAL - CACHE_VERIFY_RETRY);
+}
+
+DWORD GetCacheVerifyWait(ULONGLONG dueTime, ULONGLONG now) {
+    if (dueTime <= now) return 0;
+
+    ULONGLONG waitMs = (dueTime - now) / 10000;
+    return waitMs > CACHE_VERIFY_MAX_WAIT_MS ? CACHE_VERIFY_MAX_WAIT_MS : (DWORD)waitMs;
+}
@@ -0,0 +1,52 @@
+#ifndef CACHEVERIFY_H
+#define CACHEVERIFY_H
+
+#include <windows.h>
+
+// Background integrity checks of cached videos.
+//
+// Every video file gets a checksum once it is in the cache: the full-file
+// hash duplicate detection uses (see cachededupe.h), stored with the write
+// time of the file it was taken from. A background-priority thread reads the
+// files again on a rolling schedule, one at a time and within its own I/O
+// budget, oldest check first, so new downloads get their checksum soon after
+// they finish and the rest are re-read once per interval. The time of each
+// check is stored in the cache index, so the work is spread across sessions
+// instead of starting over at every launch.
+//
+// A file whose contents changed while its write time did not was damaged on
+// disk; it is flagged in the cache list and can be downloaded again. A file
+// with a new write time was replaced on purpose and gets a new checksum.
+
+#define CACHE_VERIFY_BYTES_PER_SEC  (8ull * 1024 * 1024)
+#define CACHE_VERIFY_INTERVAL       (30ull * 24 * 60 * 60 * 10000000) // FILETIME ticks between checks of a file
+#define CACHE_VERIFY_RETRY          (24ull * 60 * 60 * 10000000)      // FILETIME ticks before an unreadable file is tried again
+#define CACHE_VERIFY_START_DELAY_MS (60 * 1000)     // Leave startup scans the disk to themselves
+#define CACHE_VERIFY_MAX_WAIT_MS    (60 * 60 * 1000) // Look again at least this often, in case the clock moved
+
+// Outcomes of a check
+#define CACHE_VERIFY_OK             0   // Contents match the checksum
+#define CACHE_VERIFY_BASELINE       1   // No checksum yet; the new hash becomes it
+#define CACHE_VERIFY_CHANGED        2   // File was rewritten; the new hash replaces the checksum
+#define CACHE_VERIFY_DAMAGED        3   // Contents changed but the write time did not
+
+// A full-file hash and the write time of the file it was taken from
+typedef struct {
+    ULONGLONG writeTime;        // FILETIME ticks
+    ULONGLONG hash;             // 0 while unknown
+} CacheVerifyChecksum;
+
+// Compare a file as just read against its stored checksum
+int CheckCacheVerifyChecksum(const CacheVerifyChecksum* stored, const CacheVerifyChecksum* current);
+
+// When a file last checked at verifyTime is due again; 0 (never checked) is due at once
+ULONGLONG GetCacheVerifyDueTime(ULONGLONG verifyTime);
+
+// Check time to record for a file that could not be read, so that it is due
+// again after CACHE_VERIFY_RETRY instead of holding up the files behind it
+ULONGLONG GetCacheVerifyRetryTime(ULONGLONG now);
+
+// Milliseconds to wait from now until dueTime, capped at CACHE_VERIFY_MAX_WAIT_MS
+DWORD GetCacheVerifyWait(ULONGLONG dueTime, ULONGLONG now);
+
+#endif // CACHEVERIFY_H
@@ -0,0 +1,442 @@
+#include "YouTubeCacher.h"
+
+// Allocate an empty snapshot with room for rows and one reference
+static CacheViewSnapshot* AllocCacheViewSnapshot(DWORD rowCapacity) {
+    CacheViewSnapshot* snapshot = (CacheViewSnapshot*)SAFE_MALLOC(sizeof(CacheViewSnapshot));
+    if (!snapshot) return NULL;
+
+    memset(snapshot, 0, sizeof(CacheViewSnapshot));
+    snapshot->sortColumn = CACHE_SORT_NONE;
+    snapshot->ascending = TRUE;
+    snapshot->refCount = 1;
+
+    if (rowCapacity > 0) {
+        snapshot->rows = (CacheViewRow*)SAFE_MALLOC((size_t)rowCapacity * sizeof(CacheViewRow));
+        if (!snapshot->rows) {
+            SAFE_FREE(snapshot);
+            return NULL;
+        }
+    }
+    return snapshot;
+}
+
+// Block size for an arena holding the strings of count rows: small batches
+// of changes should not pin a full default block each
+static size_t GetCacheViewArenaBlockSize(DWORD count) {
+    size_t size = (size_t)count * 256;
+    if (size < 1024) size = 1024;
+    if (size > STRING_ARENA_DEFAULT_BLOCK_SIZE) size = STRING_ARENA_DEFAULT_BLOCK_SIZE;
+    return size;
+}
+
+// Copy the strings of every row into one new arena and make it the snapshot's
+// only arena. The arenas the rows pointed into are not released here; the
+// snapshot must not hold references to them yet.
+static BOOL CopyCacheViewStrings(CacheViewSnapshot* snapshot) {
+    StringArena* strings = CreateStringArena(GetCacheViewArenaBlockSize(snapshot->count));
+    if (!strings) return FALSE;
+
+    for (DWORD i = 0; i < snapshot->count; i++) {
+        CacheViewRow* row = &snapshot->rows[i];
+        const wchar_t* videoId = StringArenaWcsDup(strings, row->videoId);
+        const wchar_t* title = StringArenaWcsDup(strings, row->title);
+        const wchar_t* duration = StringArenaWcsDup(strings, row->duration);
+        const wchar_t* mainVideoFile = StringArenaWcsDup(strings, row->mainVideoFile);
+        if (!videoId || (row->title && !title) || (row->duration && !duration) ||
+            (row->mainVideoFile && !mainVideoFile)) {
+            ReleaseStringArena(strings);
+            return FALSE;
+        }
+        row->videoId = videoId;
+        row->title = title;
+        row->duration = duration;
+        row->mainVideoFile = mainVideoFile;
+    }
+
+    snapshot->arenas[0] = strings;
+    snapshot->arenaCount = 1;
+    return TRUE;
+}
+
+// Copy every entry's displayed fields into a new snapshot. The entries must be
+// linked into columns, which supply the sort keys; sortColumn and ascending
+// record the order the caller passes them in.
+CacheViewSnapshot* BuildCacheViewSnapshot(CacheEntry* const* entries, DWORD count,
+                                          const CacheColumns* columns, int sortColumn, BOOL ascending) {
+    if (!entries && count > 0) return NULL;
+
+    CacheViewSnapshot* snapshot = AllocCacheViewSnapshot(count);
+    if (!snapshot) return NULL;
+
+    snapshot->sortColumn = sortColumn;
+    snapshot->ascending = ascending;
+
+    StringArena* strings = CreateStringArena(GetCacheViewArenaBlockSize(count));
+    if (!strings) {
+        ReleaseCacheViewSnapshot(snapshot);
+        return NULL;
+    }
+    snapshot->arenas[snapshot->arenaCount++] = strings;
+
+    for (DWORD i = 0; i < count; i++) {
+        const CacheEntry* entry = entries[i];
+        CacheViewRow* row = &snapshot->rows[snapshot->count];
+
+        row->videoId = StringArenaWcsDup(strings, entry->videoId);
+        row->title = StringArenaWcsDup(strings, entry->title);
+        row->duration = StringArenaWcsDup(strings, entry->duration);
+        row->mainVideoFile = StringArenaWcsDup(strings, entry->mainVideoFile);
+        row->fileSize = entry->fileSize;
+        row->fileMissing = entry->fileMissing;
+        row->damaged = entry->damaged;
+
+        if (columns && entry->row < columns->count && columns->owner[entry->row] == entry) {
+            row->titleKey = columns->titleKey[entry->row];
+            row->durationSeconds = columns->durationSeconds[entry->row];
+        } else {
+            row->titleKey = MakeTitleSortKey(entry->title);
+            row->durationSeconds = 0;
+        }
+
+        if ((entry->videoId && !row->videoId) || (entry->title && !row->title) ||
+            (entry->duration && !row->duration) || (entry->mainVideoFile && !row->mainVideoFile)) {
+            ReleaseCacheViewSnapshot(snapshot);
+            return NULL;
+        }
+
+        // Rows without an ID cannot be acted on, so they are never listed
+        if (row->videoId) snapshot->count++;
+    }
+
+    return snapshot;
+}
+
+// Order two rows the way CacheSortOrder orders their entries
+static int CompareCacheViewRows(const CacheViewSnapshot* snapshot, const CacheViewRow* a, const CacheViewRow* b) {
+    int result = 0;
+    switch (snapshot->sortColumn) {
+        case CACHE_COLUMN_TITLE:
+            result = CompareCacheTitles(a->titleKey, a->title, b->titleKey, b->title);
+            break;
+        case CACHE_COLUMN_DURATION:
+            result = a->durationSeconds < b->durationSeconds ? -1 : (a->durationSeconds > b->durationSeconds ? 1 : 0);
+            break;
+        case CACHE_COLUMN_SIZE:
+            result = a->fileSize < b->fileSize ? -1 : (a->fileSize > b->fileSize ? 1 : 0);
+            break;
+    }
+    if (!snapshot->ascending) result = -result;
+    if (result == 0) result = wcscmp(a->videoId, b->videoId);
+    return result;
+}
+
+// Binary search for a video ID in an array of IDs or rows sorted by video ID
+static int FindSortedVideoId(const wchar_t* const* ids, DWORD count, const wchar_t* videoId) {
+    DWORD low = 0, high = count;
+    while (low < high) {
+        DWORD mid = low + (high - low) / 2;
+        int result = wcscmp(ids[mid], videoId);
+        if (result == 0) return (int)mid;
+        if (result < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return -1;
+}
+
+static int FindPatchRow(const CacheViewSnapshot* patch, const wchar_t* videoId) {
+    DWORD low = 0, high = patch->count;
+    while (low < high) {
+        DWORD mid = low + (high - low) / 2;
+        int result = wcscmp(patch->rows[mid].videoId, videoId);
+        if (result == 0) return (int)mid;
+        if (result < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return -1;
+}
+
+// Derive a snapshot from base with every row in changedIds (sorted by video ID)
+// replaced by its row in patch, or dropped if patch has none. Patch rows must
+// be sorted by video ID and come from the same display order as base. Without
+// a sort, replaced rows keep their position and new rows go first, where newly
+// linked entries are; with a sort, every patch row is merged in at its sorted
+// position. Returns NULL when the orders differ or memory runs out; the caller
+// then rebuilds the list.
+CacheViewSnapshot* ApplyCacheViewChanges(const CacheViewSnapshot* base, const wchar_t* const* changedIds,
+                                         DWORD changedCount, const CacheViewSnapshot* patch) {
+    if (!base || !patch || (changedCount > 0 && !changedIds)) return NULL;
+    if (base->sortColumn != patch->sortColumn) return NULL;
+    if (base->sortColumn != CACHE_SORT_NONE && base->ascending != patch->ascending) return NULL;
+
+    BOOL sorted = base->sortColumn != CACHE_SORT_NONE;
+    DWORD capacity = base->count + patch->count;
+
+    CacheViewSnapshot* snapshot = AllocCacheViewSnapshot(capacity);
+    BOOL* placed = patch->count > 0 ? (BOOL*)SAFE_MALLOC((size_t)patch->count * sizeof(BOOL)) : NULL;
+    if (!snapshot || (patch->count > 0 && !placed)) {
+        ReleaseCacheViewSnapshot(snapshot);
+        if (placed) SAFE_FREE(placed);
+        return NULL;
+    }
+    if (placed) memset(placed, 0, (size_t)patch->count * sizeof(BOOL));
+
+    snapshot->sortColumn = base->sortColumn;
+    snapshot->ascending = base->ascending;
+
+    // Sorted: kept rows go after a gap the size of the patch, so the merge below
+    // can run forward in place
+    DWORD offset = sorted ? patch->count : 0;
+    DWORD kept = 0;
+    for (DWORD i = 0; i < base->count; i++) {
+        const CacheViewRow* row = &base->rows[i];
+        if (changedCount > 0 && FindSortedVideoId(changedIds, changedCount, row->videoId) >= 0) {
+            if (sorted) continue;
+            int patchRow = FindPatchRow(patch, row->videoId);
+            if (patchRow < 0 || placed[patchRow]) continue;
+            placed[patchRow] = TRUE;
+            snapshot->rows[offset + kept++] = patch->rows[patchRow];
+        } else {
+            snapshot->rows[offset + kept++] = *row;
+        }
+    }
+
+    if (!sorted) {
+        // Rows for newly listed entries go first, in patch order
+        DWORD added = 0;
+        for (DWORD i = 0; i < patch->count; i++) {
+            if (!placed[i]) added++;
+        }
+        if (added > 0) {
+            memmove(&snapshot->rows[added], &snapshot->rows[0], (size_t)kept * sizeof(CacheViewRow));
+            DWORD next = 0;
+            for (DWORD i = 0; i < patch->count; i++) {
+                if (!placed[i]) snapshot->rows[next++] = patch->rows[i];
+            }
+        }
+        snapshot->count = added + kept;
+    } else if (patch->count > 0) {
+        // Sort the patch rows (insertion sort; batches are small) ...
+        CacheViewRow* inserts = (CacheViewRow*)SAFE_MALLOC((size_t)patch->count * sizeof(CacheViewRow));
+        if (!inserts) {
+            SAFE_FREE(placed);
+            ReleaseCacheViewSnapshot(snapshot);
+            return NULL;
+        }
+        for (DWORD n = 0; n < patch->count; n++) {
+            DWORD j = n;
+            while (j > 0 && CompareCacheViewRows(snapshot, &inserts[j - 1], &patch->rows[n]) > 0) {
+                inserts[j] = inserts[j - 1];
+                j--;
+            }
+            inserts[j] = patch->rows[n];
+        }
+
+        // ... then merge them with the kept rows stored after the gap. The write
+        // position never passes the next unread kept row, so no second row
+        // buffer is needed.
+        const CacheViewRow* keptRows = &snapshot->rows[offset];
+        DWORD i = 0, j = 0, k = 0;
+        while (i < kept && j < patch->count) {
+            if (CompareCacheViewRows(snapshot, &keptRows[i], &inserts[j]) <= 0) {
+                snapshot->rows[k++] = keptRows[i++];
+            } else {
+                snapshot->rows[k++] = inserts[j++];
+            }
+        }
+        while (i < kept) snapshot->rows[k++] = keptRows[i++];
+        while (j < patch->count) snapshot->rows[k++] = inserts[j++];
+        snapshot->count = k;
+
+        SAFE_FREE(inserts);
+    } else {
+        snapshot->count = kept; // No gap was left without patch rows
+    }
+
+    if (placed) SAFE_FREE(placed);
+
+    // Share the source arenas while few enough, otherwise compact into one
+    if (base->arenaCount + patch->arenaCount <= CACHE_VIEW_MAX_ARENAS) {
+        for (DWORD i = 0; i < base->arenaCount; i++) {
+            RetainStringArena(base->arenas[i]);
+            snapshot->arenas[snapshot->arenaCount++] = base->arenas[i];
+        }
+        for (DWORD i = 0; i < patch->arenaCount; i++) {
+            RetainStringArena(patch->arenas[i]);
+            snapshot->arenas[snapshot->arenaCount++] = patch->arenas[i];
+        }
+    } else if (!CopyCacheViewStrings(snapshot)) {
+        ReleaseCacheViewSnapshot(snapshot);
+        return NULL;
+    }
+    return snapshot;
+}
+
+// Drop the rows the filter rejects, keeping the order of the rest. Only valid
+// before the snapshot is published. Returns the number of rows kept.
+DWORD FilterCacheViewSnapshot(CacheViewSnapshot* snapshot, CacheViewRowFilter keep, void* context) {
+    if (!snapshot) return 0;
+    if (!keep) return snapshot->count;
+
+    DWORD kept = 0;
+    for (DWORD i = 0; i < snapshot->count; i++) {
+        if (keep(&snapshot->rows[i], context)) {
+            if (kept != i) snapshot->rows[kept] = snapshot->rows[i];
+            kept++;
+        }
+    }
+    snapshot->count = kept;
+    return kept;
+}
+
+// Derive a snapshot holding the rows of base the filter keeps, in the same
+// order, sharing base's strings. Unlike FilterCacheViewSnapshot this leaves
+// base untouched, so it works on published snapshots.
+CacheViewSnapshot* CopyCacheViewSnapshot(const CacheViewSnapshot* base, CacheViewRowFilter keep, void* context) {
+    if (!base) return NULL;
+
+    CacheViewSnapshot* snapshot = AllocCacheViewSnapshot(base->count);
+    if (!snapshot) return NULL;
+
+    snapshot->sortColumn = base->sortColumn;
+    snapshot->ascending = base->ascending;
+    for (DWORD i = 0; i < base->count; i++) {
+        if (!keep || keep(&base->rows[i], context)) {
+            snapshot->rows[snapshot->count++] = base->rows[i];
+        }
+    }
+    for (DWORD i = 0; i < base->arenaCount; i++) {
+        RetainStringArena(base->arenas[i]);
+        snapshot->arenas[snapshot->arenaCount++] = base->arenas[i];
+    }
+    return snapshot;
+}
+
+void RetainCacheViewSnapshot(CacheViewSnapshot* snapshot) {
+    if (snapshot) {
+        InterlockedIncrement(&snapshot->refCount);
+    }
+}
+
+void ReleaseCacheViewSnapshot(CacheViewSnapshot* snapshot) {
+    if (!snapshot || InterlockedDecrement(&snapshot->refCount) != 0) return;
+
+    if (snapshot->rows) SAFE_FREE(snapshot->rows);
+    for (DWORD i = 0; i < snapshot->arenaCount; i++) {
+        ReleaseStringArena(snapshot->arenas[i]);
+    }
+    SAFE_FREE(snapshot);
+}
+
+const CacheViewRow* GetCacheViewRow(const CacheViewSnapshot* snapshot, DWORD row) {
+    if (!snapshot || row >= snapshot->count) return NULL;
+    return &snapshot->rows[row];
+}
+
+// Text shown in a list cell, with the list's placeholders for missing values
+const wchar_t* GetCacheViewCellText(const CacheViewSnapshot* snapshot, DWORD row, int column) {
+    const CacheViewRow* viewRow = GetCacheViewRow(snapshot, row);
+    if (!viewRow) return L"";
+
+    switch (column) {
+        case CACHE_COLUMN_TITLE:
+            return viewRow->title ? viewRow->title : L"Unknown Title";
+        case CACHE_COLUMN_DURATION:
+            return viewRow->duration ? viewRow->duration : L"Unknown";
+    }
+    return L"";
+}
+
+// Row showing a video ID, or -1. Linear; used to restore a handful of selected rows.
+int FindCacheViewRowById(const CacheViewSnapshot* snapshot, const wchar_t* videoId) {
+    if (!snapshot || !videoId) return -1;
+
+    for (DWORD i = 0; i < snapshot->count; i++) {
+        if (wcscmp(snapshot->rows[i].videoId, videoId) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+const CacheViewRow* FindCacheViewRow(const CacheViewSnapshot* snapshot, const wchar_t* videoId) {
+    int row = FindCacheViewRowById(snapshot, videoId);
+    return row >= 0 ? &snapshot->rows[row] : NULL;
+}
+
+// Find the first row at or after startRow whose title starts with prefix
+// (case-insensitive), for keyboard search in the list. Returns -1 if none.
+int FindCacheViewRowByPrefix(const CacheViewSnapshot* snapshot, const wchar_t* prefix, DWORD startRow, BOOL wrap) {
+    if (!snapshot || !prefix || snapshot->count == 0) return -1;
+
+    size_t prefixLen = wcslen(prefix);
+    if (startRow >= snapshot->count) {
+        if (!wrap) return -1;
+        startRow = 0;
+    }
+
+    DWORD scanned = wrap ? snapshot->count : snapshot->count - startRow;
+    for (DWORD i = 0; i < scanned; i++) {
+        DWORD row = (startRow + i) % snapshot->count;
+        const wchar_t* title = GetCacheViewCellText(snapshot, row, CACHE_COLUMN_TITLE);
+        if (_wcsnicmp(title, prefix, prefixLen) == 0) {
+            return (int)row;
+        }
+    }
+    return -1;
+}
+
+void InitCacheViewPublisher(CacheViewPublisher* publisher) {
+    if (!publisher) return;
+
+    publisher->current = NULL;
+    publisher->busy = 0;
+}
+
+void FreeCacheViewPublisher(CacheViewPublisher* publisher) {
+    if (!publisher) return;
+
+    ReleaseCacheViewSnapshot(publisher->current);
+    publisher->current = NULL;
+}
+
+// Held for a few instructions only, so spinning beats a kernel wait
+static void LockCacheViewPublisher(CacheViewPublisher* publisher) {
+    while (InterlockedCompareExchange(&publisher->busy, 1, 0) != 0) {
+        Sleep(0);
+    }
+}
+
+static void UnlockCacheViewPublisher(CacheViewPublisher* publisher) {
+    InterlockedExchange(&publisher->busy, 0);
+}
+
+// Make snapshot the one readers acquire, taking over the caller's reference.
+// The previous snapshot is released once its last reader is done with it.
+void PublishCacheViewSnapshot(CacheViewPublisher* publisher, CacheViewSnapshot* snapshot) {
+    if (!publisher) return;
+
+    LockCacheViewPublisher(publisher);
+    CacheViewSnapshot* previous = publisher->current;
+    publisher->current = snapshot;
+    UnlockCacheViewPublisher(publisher);
+
+    ReleaseCacheViewSnapshot(previous);
+}
+
+// The latest published snapshot with a reference for the caller to release,
+// or NULL if none was published yet
+CacheViewSnapshot* AcquireCacheViewSnapshot(CacheViewPublisher* publisher) {
+    if (!publisher) return NULL;
+
+    LockCacheViewPublisher(publisher);
+    CacheViewSnapshot* snapshot = publisher->current;
+    RetainCacheViewSnapshot(snapshot);
+    UnlockCacheViewPublisher(publisher);
+    return snapshot;
+}
@@ -0,0 +1,87 @@
+#ifndef CACHEVIEW_H
+#define CACHEVIEW_H
+
+#include <windows.h>
+#include "stringarena.h"
+#include "cachecolumns.h"
+
+// Immutable row model behind the owner-data cache list.
+//
+// A snapshot copies the displayed fields of every listed entry, in display
+// order, into one row array and one string arena. It is built under the cache
+// lock and never changes once published, so the list can answer
+// LVN_GETDISPINFO from it without touching the lock, and a refresh is just a
+// swap of snapshots plus LVM_SETITEMCOUNT. Columns use the CACHE_COLUMN_*
+// numbering of the list view.
+//
+// Small batches of changes are applied by deriving a new snapshot from the
+// current one: unchanged rows are copied by value and keep pointing into the
+// arenas of the snapshots they came from, which the new snapshot retains. Once
+// a snapshot would hold more than CACHE_VIEW_MAX_ARENAS, its strings are
+// copied into a single arena so replaced strings do not accumulate.
+//
+// The cache manager also publishes a snapshot of every entry, in list order,
+// as the cache lock is released after changes, at most once per publish
+// interval so a stream of small batches is not copied batch by batch. Readers
+// on any thread acquire a reference to the latest one from the publisher,
+// which takes a spin lock around the pointer swap and the retain only; only a
+// reader that finds changes still waiting takes the cache lock to publish
+// them, so an idle cache never makes a reader wait for a save or a disk scan.
+
+#define CACHE_VIEW_MAX_ARENAS       8
+
+struct CacheEntry;
+
+typedef struct {
+    const wchar_t* videoId;
+    const wchar_t* title;           // NULL when the entry has no title
+    const wchar_t* duration;        // NULL when the entry has no duration
+    const wchar_t* mainVideoFile;
+    ULONGLONG fileSize;
+    BOOL fileMissing;               // The entry's video file was not found on disk
+    BOOL damaged;                   // The entry's video file failed its integrity check
+    ULONGLONG titleKey;             // Sort keys, copied from the entry's CacheColumns row
+    DWORD durationSeconds;
+} CacheViewRow;
+
+typedef struct {
+    CacheViewRow* rows;
+    DWORD count;
+    int sortColumn;                 // CACHE_COLUMN_* the rows are sorted by, or CACHE_SORT_NONE
+    BOOL ascending;
+    StringArena* arenas[CACHE_VIEW_MAX_ARENAS]; // Hold every string the rows point to
+    DWORD arenaCount;
+    volatile LONG refCount;
+} CacheViewSnapshot;
+
+// Decides whether a row stays in the snapshot
+typedef BOOL (*CacheViewRowFilter)(const CacheViewRow* row, void* context);
+
+// Hands the latest published snapshot to readers
+typedef struct {
+    CacheViewSnapshot* current; // Holds one reference, or NULL before the first publish
+    volatile LONG busy;         // Spin lock held for the pointer swap or a reader's retain
+} CacheViewPublisher;
+
+// Returns a snapshot holding one reference
+CacheViewSnapshot* BuildCacheViewSnapshot(struct CacheEntry* const* entries, DWORD count,
+                                          const CacheColumns* columns, int sortColumn, BOOL ascending);
+CacheViewSnapshot* ApplyCacheViewChanges(const CacheViewSnapshot* base, const wchar_t* const* changedIds,
+                                         DWORD changedCount, const CacheViewSnapshot* patch);
+DWORD FilterCacheViewSnapshot(CacheViewSnapshot* snapshot, CacheViewRowFilter keep, void* context);
+CacheViewSnapshot* CopyCacheViewSnapshot(const CacheViewSnapshot* base, CacheViewRowFilter keep, void* context);
+void RetainCacheViewSnapshot(CacheViewSnapshot* snapshot);
+void ReleaseCacheViewSnapshot(CacheViewSnapshot* snapshot);
+
+const CacheViewRow* GetCacheViewRow(const CacheViewSnapshot* snapshot, DWORD row);
+const wchar_t* GetCacheViewCellText(const CacheViewSnapshot* snapshot, DWORD row, int column);
+int FindCacheViewRowById(const CacheViewSnapshot* snapshot, const wchar_t* videoId);
+const CacheViewRow* FindCacheViewRow(const CacheViewSnapshot* snapshot, const wchar_t* videoId);
+int FindCacheViewRowByPrefix(const CacheViewSnapshot* snapshot, const wchar_t* prefix, DWORD startRow, BOOL wrap);
+
+void InitCacheViewPublisher(CacheViewPublisher* publisher);
+void FreeCacheViewPublisher(CacheViewPublisher* publisher);
+void PublishCacheViewSnapshot(CacheViewPublisher* publisher, CacheViewSnapshot* snapshot);
+CacheViewSnapshot* AcquireCacheViewSnapshot(CacheViewPublisher* publisher);
+
+#endif // CACHEVIEW_H
@@ -0,0 +1,148 @@
+#include "YouTubeCacher.h"
+
+void InitCacheWatchQueue(CacheWatchQueue* queue, DWORD debounceMs) {
+    if (!queue) return;
+
+    memset(queue, 0, sizeof(CacheWatchQueue));
+    queue->debounceMs = debounceMs;
+}
+
+static void ClearCacheWatchQueue(CacheWatchQueue* queue) {
+    for (DWORD i = 0; i < queue->count; i++) {
+        SAFE_FREE(queue->items[i].path);
+    }
+    queue->count = 0;
+}
+
+void FreeCacheWatchQueue(CacheWatchQueue* queue) {
+    if (!queue) return;
+
+    ClearCacheWatchQueue(queue);
+    if (queue->items) SAFE_FREE(queue->items);
+    queue->items = NULL;
+    queue->capacity = 0;
+    queue->rescan = FALSE;
+}
+
+// A rescan covers every pending path
+static void RequestCacheWatchRescan(CacheWatchQueue* queue) {
+    ClearCacheWatchQueue(queue);
+    queue->rescan = TRUE;
+}
+
+void PushCacheWatchPath(CacheWatchQueue* queue, const wchar_t* path, DWORD now) {
+    if (!queue || !path || !*path || queue->rescan) return;
+
+    // A path reported again waits for the debounce period again
+    for (DWORD i = 0; i < queue->count; i++) {
+        if (_wcsicmp(queue->items[i].path, path) == 0) {
+            queue->items[i].lastChange = now;
+            return;
+        }
+    }
+
+    if (queue->count == CACHE_WATCH_MAX_PENDING) {
+        RequestCacheWatchRescan(queue);
+        return;
+    }
+
+    if (queue->count == queue->capacity) {
+        DWORD capacity = queue->capacity ? queue->capacity * 2 : 16;
+        CacheWatchPending* items = (CacheWatchPending*)SAFE_REALLOC(queue->items, capacity * sizeof(CacheWatchPending));
+        if (!items) {
+            RequestCacheWatchRescan(queue);
+            return;
+        }
+        queue->items = items;
+        queue->capacity = capacity;
+    }
+
+    wchar_t* copy = SAFE_WCSDUP(path);
+    if (!copy) {
+        RequestCacheWatchRescan(queue);
+        return;
+    }
+    queue->items[queue->count].path = copy;
+    queue->items[queue->count].lastChange = now;
+    queue->count++;
+}
+
+DWORD GetCacheWatchTimeout(const CacheWatchQueue* queue, DWORD now) {
+    if (!queue) return INFINITE;
+    if (queue->rescan) return 0;
+
+    DWORD timeout = INFINITE;
+    for (DWORD i = 0; i < queue->count; i++) {
+        // Unsigned differences stay right across the tick count wrapping
+        DWORD elapsed = now - queue->items[i].lastChange;
+        DWORD remaining = elapsed >= queue->debounceMs ? 0 : queue->debounceMs - elapsed;
+        if (remaining < timeout) timeout = remaining;
+    }
+    return timeout;
+}
+
+BOOL FlushCacheWatchQueue(CacheWatchQueue* queue, DWORD now, CacheWatchApply apply, void* context) {
+    if (!queue || !apply) return FALSE;
+
+    if (queue->rescan) {
+        queue->rescan = FALSE;
+        apply(context, NULL, 0, TRUE);
+        return TRUE;
+    }
+
+    // Move settled paths to the front, keeping the rest in report order
+    DWORD settled = 0;
+    for (DWORD i = 0; i < queue->count; i++) {
+        if (now - queue->items[i].lastChange >= queue->debounceMs) {
+            CacheWatchPending item = queue->items[i];
+            memmove(&queue->items[settled + 1], &queue->items[settled], (i - settled) * sizeof(CacheWatchPending));
+            queue->items[settled++] = item;
+        }
+    }
+    if (settled == 0) return FALSE;
+
+    wchar_t** paths = (wchar_t**)SAFE_MALLOC(settled * sizeof(wchar_t*));
+    if (!paths) {
+        // The paths are still worth applying; a rescan finds them
+        RequestCacheWatchRescan(queue);
+        return FALSE;
+    }
+    for (DWORD i = 0; i < settled; i++) {
+        paths[i] = queue->items[i].path;
+    }
+    memmove(&queue->items[0], &queue->items[settled], (queue->count - settled) * sizeof(CacheWatchPending));
+    queue->count -= settled;
+
+    apply(context, paths, settled, FALSE);
+
+    for (DWORD i = 0; i < settled; i++) {
+        SAFE_FREE(paths[i]);
+    }
+    SAFE_FREE(paths);
+    return TRUE;
+}
+
+static void QueueCacheWatchReport(void* context, const wchar_t* path) {
+    PushCacheWatchPath((CacheWatchQueue*)context, path, GetTickCount());
+}
+
+int RunCacheWatch(CacheWatchBackend* backend, DWORD debounceMs, CacheWatchApply apply, void* context) {
+    if (!backend || !apply) return CACHE_WATCH_FAILED;
+
+    CacheWatchQueue queue;
+    InitCacheWatchQueue(&queue, debounceMs);
+
+    int result;
+    for (;;) {
+        result = WaitCacheWatchBackend(backend, GetCacheWatchTimeout(&queue, GetTickCount()),
+                                       QueueCacheWatchReport, &queue);
+        if (result == CACHE_WATCH_STOPPED || result == CACHE_WATCH_FAILED) break;
+        if (result == CACHE_WATCH_OVERFLOW) RequestCacheWatchRescan(&queue);
+
+        FlushCacheWatchQueue(&queue, GetTickCount(), apply, context);
+    }
+
+    // Changes still settling when the watch stops are dropped with it
+    FreeCacheWatchQueue(&queue);
+    return result;
+}
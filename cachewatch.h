@@ -0,0 +1,71 @@
+#ifndef CACHEWATCH_H
+#define CACHEWATCH_H
+
+#include <windows.h>
+
+// Watch of a download folder tree, so files added, moved or deleted outside the
+// app reach the cache without a rescan.
+//
+// A platform backend reports the path of every file or directory created,
+// deleted, renamed or written under the folder, relative to it. The paths wait
+// in a queue until they have been quiet for the debounce period and are then
+// applied together, so a download that writes a file in many steps, or a move
+// reported as a delete and a create, is applied once and in one pass. When the
+// backend loses events, or too many paths pile up, the queue asks for a full
+// rescan instead.
+//
+// ReadDirectoryChangesW is the Windows backend; an inotify backend lets the
+// same watch run on Linux.
+
+#define CACHE_WATCH_DEBOUNCE_MS     750
+#define CACHE_WATCH_MAX_PENDING     4096
+
+// Results of waiting on a backend
+#define CACHE_WATCH_EVENTS          0   // Changes were reported
+#define CACHE_WATCH_TIMEOUT         1
+#define CACHE_WATCH_OVERFLOW        2   // Changes were lost; the folder must be rescanned
+#define CACHE_WATCH_STOPPED         3
+#define CACHE_WATCH_FAILED          4
+
+typedef struct CacheWatchBackend CacheWatchBackend;
+
+// Receives one changed path, relative to the watched folder
+typedef void (*CacheWatchReport)(void* context, const wchar_t* path);
+
+CacheWatchBackend* OpenCacheWatchBackend(const wchar_t* directory);
+// Wait up to timeoutMs (or INFINITE) for changes and report them
+int WaitCacheWatchBackend(CacheWatchBackend* backend, DWORD timeoutMs, CacheWatchReport report, void* context);
+// Make a wait in progress, and every later one, return CACHE_WATCH_STOPPED; any thread
+void StopCacheWatchBackend(CacheWatchBackend* backend);
+void CloseCacheWatchBackend(CacheWatchBackend* backend);
+
+typedef struct {
+    wchar_t* path;
+    DWORD lastChange;           // Tick count of the latest report
+} CacheWatchPending;
+
+// Paths reported but not yet applied, one slot per path
+typedef struct {
+    CacheWatchPending* items;
+    DWORD count;
+    DWORD capacity;
+    DWORD debounceMs;
+    BOOL rescan;                // Changes were lost, so the next batch is a full rescan
+} CacheWatchQueue;
+
+// Receives settled paths, or a request to rescan everything (paths NULL)
+typedef void (*CacheWatchApply)(void* context, wchar_t* const* paths, DWORD count, BOOL rescan);
+
+void InitCacheWatchQueue(CacheWatchQueue* queue, DWORD debounceMs);
+void FreeCacheWatchQueue(CacheWatchQueue* queue);
+void PushCacheWatchPath(CacheWatchQueue* queue, const wchar_t* path, DWORD now);
+// Milliseconds until the next path settles, or INFINITE when nothing is pending
+DWORD GetCacheWatchTimeout(const CacheWatchQueue* queue, DWORD now);
+// Hand settled paths, or a pending rescan, to apply; returns whether anything was applied
+BOOL FlushCacheWatchQueue(CacheWatchQueue* queue, DWORD now, CacheWatchApply apply, void* context);
+
+// Wait on the backend and apply settled changes until it is stopped or fails;
+// returns CACHE_WATCH_STOPPED or CACHE_WATCH_FAILED
+int RunCacheWatch(CacheWatchBackend* backend, DWORD debounceMs, CacheWatchApply apply, void* context);
+
+#endif // CACHEWATCH_H
@@ -0,0 +1,243 @@
+#include "YouTubeCacher.h"
+
+// inotify backend, so the folder watch can be exercised on Linux. inotify
+// watches one directory at a time, so every subdirectory gets a watch of its
+// own: the existing ones when the backend opens, and new ones as they appear.
+// Whatever lands in a new directory before its watch is added is reported from
+// a listing of it instead.
+// Paths are converted with the C library's multibyte functions and reported
+// with '/' separators.
+
+#ifdef __linux__
+
+#include <sys/inotify.h>
+#include <poll.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+
+#define CACHE_WATCH_INOTIFY_MASK    (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE | \
+                                     IN_DELETE_SELF | IN_ONLYDIR)
+
+// A watched directory and its path relative to the root ("" for the root)
+typedef struct {
+    int wd;
+    char* path;
+} CacheWatchDirectory;
+
+struct CacheWatchBackend {
+    int fd;
+    int stopPipe[2];            // Written by StopCacheWatchBackend to wake a wait
+    char* root;
+    CacheWatchDirectory* directories;
+    int directoryCount;
+    int directoryCapacity;
+};
+
+static char* JoinCacheWatchPath(const char* parent, const char* name) {
+    size_t parentLength = strlen(parent);
+    char* path = (char*)SAFE_MALLOC(parentLength + strlen(name) + 2);
+    if (!path) return NULL;
+
+    if (parentLength > 0) {
+        sprintf(path, "%s/%s", parent, name);
+    } else {
+        strcpy(path, name);
+    }
+    return path;
+}
+
+static CacheWatchDirectory* FindCacheWatchDirectory(CacheWatchBackend* backend, int wd) {
+    for (int i = 0; i < backend->directoryCount; i++) {
+        if (backend->directories[i].wd == wd) return &backend->directories[i];
+    }
+    return NULL;
+}
+
+static void ReportCacheWatchPath(const char* path, CacheWatchReport report, void* context);
+
+// Watch a directory given relative to the root, and every directory below it,
+// reporting their contents when a report callback is given
+static void AddCacheWatchDirectory(CacheWatchBackend* backend, const char* relative,
+                                   CacheWatchReport report, void* context) {
+    char* full = JoinCacheWatchPath(backend->root, relative);
+    if (!full) return;
+
+    int wd = inotify_add_watch(backend->fd, full, CACHE_WATCH_INOTIFY_MASK);
+    if (wd < 0 || FindCacheWatchDirectory(backend, wd)) {
+        SAFE_FREE(full);
+        return;
+    }
+
+    if (backend->directoryCount == backend->directoryCapacity) {
+        int capacity = backend->directoryCapacity ? backend->directoryCapacity * 2 : 16;
+        CacheWatchDirectory* directories = (CacheWatchDirectory*)SAFE_REALLOC(backend->directories,
+                                                                            capacity * sizeof(CacheWatchDirectory));
+        if (!directories) {
+            inotify_rm_watch(backend->fd, wd);
+            SAFE_FREE(full);
+            return;
+        }
+        backend->directories = directories;
+        backend->directoryCapacity = capacity;
+    }
+
+    char* path = (char*)SAFE_MALLOC(strlen(relative) + 1);
+    if (!path) {
+        inotify_rm_watch(backend->fd, wd);
+        SAFE_FREE(full);
+        return;
+    }
+    strcpy(path, relative);
+    backend->directories[backend->directoryCount].wd = wd;
+    backend->directories[backend->directoryCount].path = path;
+    backend->directoryCount++;
+
+    DIR* dir = opendir(full);
+    if (dir) {
+        struct dirent* item;
+        while ((item = readdir(dir)) != NULL) {
+            if (strcmp(item->d_name, ".") == 0 || strcmp(item->d_name, "..") == 0) continue;
+            if (item->d_type != DT_DIR && !report) continue;
+
+            char* child = JoinCacheWatchPath(relative, item->d_name);
+            if (!child) continue;
+            if (report) ReportCacheWatchPath(child, report, context);
+            if (item->d_type == DT_DIR) AddCacheWatchDirectory(backend, child, report, context);
+            SAFE_FREE(child);
+        }
+        closedir(dir);
+    }
+    SAFE_FREE(full);
+}
+
+static void RemoveCacheWatchDirectory(CacheWatchBackend* backend, int wd) {
+    CacheWatchDirectory* directory = FindCacheWatchDirectory(backend, wd);
+    if (!directory) return;
+
+    SAFE_FREE(directory->path);
+    *directory = backend->directories[--backend->directoryCount];
+}
+
+// Drop the watches of a directory moved out from under its path, and of everything below it
+static void RemoveCacheWatchTree(CacheWatchBackend* backend, const char* relative) {
+    size_t length = strlen(relative);
+    for (int i = backend->directoryCount - 1; i >= 0; i--) {
+        const char* path = backend->directories[i].path;
+        if (strncmp(path, relative, length) == 0 && (path[length] == '\0' || path[length] == '/')) {
+            inotify_rm_watch(backend->fd, backend->directories[i].wd);
+            RemoveCacheWatchDirectory(backend, backend->directories[i].wd);
+        }
+    }
+}
+
+CacheWatchBackend* OpenCacheWatchBackend(const wchar_t* directory) {
+    if (!directory) return NULL;
+
+    CacheWatchBackend* backend = (CacheWatchBackend*)SAFE_MALLOC(sizeof(CacheWatchBackend));
+    if (!backend) return NULL;
+    memset(backend, 0, sizeof(CacheWatchBackend));
+    backend->fd = -1;
+    backend->stopPipe[0] = backend->stopPipe[1] = -1;
+
+    size_t size = wcstombs(NULL, directory, 0);
+    backend->root = size != (size_t)-1 ? (char*)SAFE_MALLOC(size + 1) : NULL;
+    if (backend->root) wcstombs(backend->root, directory, size + 1);
+
+    backend->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (!backend->root || backend->fd < 0 || pipe(backend->stopPipe) != 0) {
+        CloseCacheWatchBackend(backend);
+        return NULL;
+    }
+
+    AddCacheWatchDirectory(backend, "", NULL, NULL);
+    if (backend->directoryCount == 0) {
+        CloseCacheWatchBackend(backend);
+        return NULL;
+    }
+    return backend;
+}
+
+static void ReportCacheWatchPath(const char* path, CacheWatchReport report, void* context) {
+    size_t size = mbstowcs(NULL, path, 0);
+    if (size == (size_t)-1) return;
+
+    wchar_t* wide = (wchar_t*)SAFE_MALLOC((size + 1) * sizeof(wchar_t));
+    if (!wide) return;
+    mbstowcs(wide, path, size + 1);
+    report(context, wide);
+    SAFE_FREE(wide);
+}
+
+int WaitCacheWatchBackend(CacheWatchBackend* backend, DWORD timeoutMs, CacheWatchReport report, void* context) {
+    if (!backend || !report) return CACHE_WATCH_FAILED;
+
+    struct pollfd fds[2] = { { backend->stopPipe[0], POLLIN, 0 }, { backend->fd, POLLIN, 0 } };
+    int ready = poll(fds, 2, timeoutMs == INFINITE ? -1 : (timeoutMs > INT_MAX ? INT_MAX : (int)timeoutMs));
+    if (ready < 0) return errno == EINTR ? CACHE_WATCH_TIMEOUT : CACHE_WATCH_FAILED;
+    if (fds[0].revents) return CACHE_WATCH_STOPPED;
+    if (ready == 0) return CACHE_WATCH_TIMEOUT;
+
+    int result = CACHE_WATCH_EVENTS;
+    char buffer[16 * 1024] __attribute__((aligned(__alignof__(struct inotify_event))));
+    for (;;) {
+        ssize_t length = read(backend->fd, buffer, sizeof(buffer));
+        if (length <= 0) break;
+
+        for (char* p = buffer; p < buffer + length; p += sizeof(struct inotify_event) + ((struct inotify_event*)p)->len) {
+            const struct inotify_event* event = (const struct inotify_event*)p;
+            if (event->mask & IN_Q_OVERFLOW) {
+                result = CACHE_WATCH_OVERFLOW;
+                continue;
+            }
+
+            CacheWatchDirectory* directory = FindCacheWatchDirectory(backend, event->wd);
+            if (!directory) continue;
+            if (event->mask & (IN_DELETE_SELF | IN_IGNORED)) {
+                RemoveCacheWatchDirectory(backend, event->wd);
+                continue;
+            }
+            if (event->len == 0) continue;
+
+            char* path = JoinCacheWatchPath(directory->path, event->name);
+            if (!path) continue;
+
+            // A directory created or moved in needs its own watch; one moved away
+            // would report under its old path
+            if ((event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO))) {
+                AddCacheWatchDirectory(backend, path, report, context);
+            } else if ((event->mask & IN_ISDIR) && (event->mask & IN_MOVED_FROM)) {
+                RemoveCacheWatchTree(backend, path);
+            }
+            ReportCacheWatchPath(path, report, context);
+            SAFE_FREE(path);
+        }
+    }
+    return result;
+}
+
+void StopCacheWatchBackend(CacheWatchBackend* backend) {
+    if (!backend || backend->stopPipe[1] < 0) return;
+
+    char signal = 1;
+    ssize_t written = write(backend->stopPipe[1], &signal, 1);
+    (void)written;
+}
+
+void CloseCacheWatchBackend(CacheWatchBackend* backend) {
+    if (!backend) return;
+
+    for (int i = 0; i < backend->directoryCount; i++) {
+        SAFE_FREE(backend->directories[i].path);
+    }
+    if (backend->directories) SAFE_FREE(backend->directories);
+    if (backend->fd >= 0) close(backend->fd);
+    if (backend->stopPipe[0] >= 0) close(backend->stopPipe[0]);
+    if (backend->stopPipe[1] >= 0) close(backend->stopPipe[1]);
+    if (backend->root) SAFE_FREE(backend->root);
+    SAFE_FREE(backend);
+}
+
+#endif // __linux__
@@ -0,0 +1,127 @@
+#include "YouTubeCacher.h"
+
+// ReadDirectoryChangesW backend. One overlapped read is kept outstanding on
+// the folder between waits, so changes made while the queue is being applied
+// are buffered by the system rather than lost.
+
+#define CACHE_WATCH_BUFFER_SIZE     (64 * 1024)   // Network shares cap the buffer at 64 KB
+
+struct CacheWatchBackend {
+    HANDLE hDirectory;
+    HANDLE hStopEvent;
+    OVERLAPPED overlapped;
+    BOOL readPending;
+    DWORD* buffer;              // FILE_NOTIFY_INFORMATION records, DWORD aligned
+};
+
+static BOOL IssueCacheWatchRead(CacheWatchBackend* backend) {
+    HANDLE hEvent = backend->overlapped.hEvent;
+    memset(&backend->overlapped, 0, sizeof(OVERLAPPED));
+    backend->overlapped.hEvent = hEvent;
+    backend->readPending = ReadDirectoryChangesW(backend->hDirectory, backend->buffer, CACHE_WATCH_BUFFER_SIZE, TRUE,
+                                                 FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME |
+                                                 FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE,
+                                                 NULL, &backend->overlapped, NULL);
+    return backend->readPending;
+}
+
+CacheWatchBackend* OpenCacheWatchBackend(const wchar_t* directory) {
+    if (!directory) return NULL;
+
+    CacheWatchBackend* backend = (CacheWatchBackend*)SAFE_MALLOC(sizeof(CacheWatchBackend));
+    if (!backend) return NULL;
+    memset(backend, 0, sizeof(CacheWatchBackend));
+
+    backend->buffer = (DWORD*)SAFE_MALLOC(CACHE_WATCH_BUFFER_SIZE);
+    backend->hStopEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+    backend->overlapped.hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+    backend->hDirectory = CreateFileW(directory, FILE_LIST_DIRECTORY,
+                                      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING,
+                                      FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+
+    if (!backend->buffer || !backend->hStopEvent || !backend->overlapped.hEvent ||
+        backend->hDirectory == INVALID_HANDLE_VALUE || !IssueCacheWatchRead(backend)) {
+        ThreadSafeDebugOutputF(L"YouTubeCacher: OpenCacheWatchBackend - Cannot watch %ls (error %lu)",
+                              directory, GetLastError());
+        CloseCacheWatchBackend(backend);
+        return NULL;
+    }
+
+    return backend;
+}
+
+// Report every record of a completed read; names are relative and not terminated
+static void ReportCacheWatchRecords(CacheWatchBackend* backend, DWORD bytes, CacheWatchReport report, void* context) {
+    const BYTE* record = (const BYTE*)backend->buffer;
+    const BYTE* end = record + bytes;
+    wchar_t path[MAX_EXTENDED_PATH];
+
+    while (record + sizeof(FILE_NOTIFY_INFORMATION) <= end) {
+        const FILE_NOTIFY_INFORMATION* info = (const FILE_NOTIFY_INFORMATION*)record;
+        DWORD length = info->FileNameLength / sizeof(wchar_t);
+        if (length >= MAX_EXTENDED_PATH) length = MAX_EXTENDED_PATH - 1;
+        wcsncpy(path, info->FileName, length);
+        path[length] = L'\0';
+        report(context, path);
+
+        if (info->NextEntryOffset == 0) break;
+        record += info->NextEntryOffset;
+    }
+}
+
+int WaitCacheWatchBackend(CacheWatchBackend* backend, DWORD timeoutMs, CacheWatchReport report, void* context) {
+    if (!backend || !report) return CACHE_WATCH_FAILED;
+    if (!backend->readPending) return CACHE_WATCH_FAILED;
+
+    HANDLE handles[2] = { backend->hStopEvent, backend->overlapped.hEvent };
+    DWORD wait = WaitForMultipleObjects(2, handles, FALSE, timeoutMs);
+    if (wait == WAIT_OBJECT_0) return CACHE_WATCH_STOPPED;
+    if (wait == WAIT_TIMEOUT) return CACHE_WATCH_TIMEOUT;
+    if (wait != WAIT_OBJECT_0 + 1) return CACHE_WATCH_FAILED;
+
+    DWORD bytes = 0;
+    BOOL completed = GetOverlappedResult(backend->hDirectory, &backend->overlapped, &bytes, FALSE);
+    DWORD error = completed ? ERROR_SUCCESS : GetLastError();
+    backend->readPending = FALSE;
+    ResetEvent(backend->overlapped.hEvent);
+
+    int result;
+    if (!completed && error != ERROR_NOTIFY_ENUM_DIR) {
+        // The folder itself was deleted or its volume went away
+        ThreadSafeDebugOutputF(L"YouTubeCacher: WaitCacheWatchBackend - Read failed (error %lu)", error);
+        return CACHE_WATCH_FAILED;
+    } else if (!completed || bytes == 0) {
+        // More changes than the buffer holds; the system dropped them
+        result = CACHE_WATCH_OVERFLOW;
+    } else {
+        ReportCacheWatchRecords(backend, bytes, report, context);
+        result = CACHE_WATCH_EVENTS;
+    }
+
+    // Keep a read outstanding so nothing is missed until the next wait
+    if (!IssueCacheWatchRead(backend)) return CACHE_WATCH_FAILED;
+    return result;
+}
+
+void StopCacheWatchBackend(CacheWatchBackend* backend) {
+    if (backend && backend->hStopEvent) SetEvent(backend->hStopEvent);
+}
+
+void CloseCacheWatchBackend(CacheWatchBackend* backend) {
+    if (!backend) return;
+
+    if (backend->hDirectory && backend->hDirectory != INVALID_HANDLE_VALUE) {
+        // The outstanding read writes into the buffer until it is cancelled; it
+        // may have been issued on another thread
+        if (backend->readPending) {
+            DWORD bytes = 0;
+            CancelIoEx(backend->hDirectory, &backend->overlapped);
+            GetOverlappedResult(backend->hDirectory, &backend->overlapped, &bytes, TRUE);
+        }
+        CloseHandle(backend->hDirectory);
+    }
+    if (backend->overlapped.hEvent) CloseHandle(backend->overlapped.hEvent);
+    if (backend->hStopEvent) CloseHandle(backend->hStopEvent);
+    if (backend->buffer) SAFE_FREE(backend->buffer);
+    SAFE_FREE(backend);
+}
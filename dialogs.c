@@ -3077,8 +3077,19 @@ DWORD WINAPI MultiDlPlaylistResolverThread(LPVOID lpParam) {
                             playlist.videos[pi].title ? playlist.videos[pi].title : L"Unknown");
                     }
 
-                    // Post result to dialog (UI thread will handle insertion)
-                    PostMessageW(ctx->hDialog, WM_MULTI_DL_PLAYLIST_RESOLVED, 0, (LPARAM)plResult);
+                    // Post result to dialog (UI thread will handle insertion); the
+                    // coordinator waits for it before downloading the queue
+                    InterlockedIncrement(&ctx->pendingPlaylistResults);
+                    if (!PostMessageW(ctx->hDialog, WM_MULTI_DL_PLAYLIST_RESOLVED, 0, (LPARAM)plResult)) {
+                        InterlockedDecrement(&ctx->pendingPlaylistResults);
+                        for (pi = 0; pi < playlist.videoCount; pi++) {
+                            SAFE_FREE(plResult->urls[pi]);
+                            SAFE_FREE(plResult->titles[pi]);
+                        }
+                        SAFE_FREE(plResult->urls);
+                        SAFE_FREE(plResult->titles);
+                        SAFE_FREE(plResult);
+                    }
                 } else {
                     SAFE_FREE(plResult->urls);
                     SAFE_FREE(plResult->titles);
@@ -3107,6 +3118,150 @@ DWORD WINAPI MultiDlPlaylistResolverThread(LPVOID lpParam) {
     return 0;
 }
 
+// Maps the items of a running yt-dlp batch back to the queue
+typedef struct {
+    MultiDownloadContext* ctx;
+    const int* itemIndexes;
+} MultiDlBatchProgress;
+
+// Batch callback - runs on the subprocess output thread as each item moves on
+static void MultiDlBatchItemChanged(const YtDlpBatch* batch, int index, void* userData) {
+    MultiDlBatchProgress* progress = (MultiDlBatchProgress*)userData;
+    MultiDownloadContext* ctx = progress->ctx;
+    const YtDlpBatchItem* item = &batch->items[index];
+    int itemIndex = progress->itemIndexes[index];
+
+    if (item->state == YTDLP_BATCH_STARTED) {
+        MultiDlProgressData* progData = (MultiDlProgressData*)SAFE_MALLOC(sizeof(MultiDlProgressData));
+        if (progData) {
+            memset(progData, 0, sizeof(MultiDlProgressData));
+            progData->itemIndex = itemIndex;
+            progData->percentage = item->percentage;
+            PostMessageW(ctx->hDialog, WM_MULTI_DL_PROGRESS, 0, (LPARAM)progData);
+        }
+        return;
+    }
+
+    if (item->state == YTDLP_BATCH_CANCELLED) {
+        EnterCriticalSection(&ctx->itemLock);
+        ctx->items[itemIndex].status = MULTI_DL_CANCELLED;
+        LeaveCriticalSection(&ctx->itemLock);
+        return;
+    }
+
+    {
+        BOOL success = (item->state == YTDLP_BATCH_SUCCEEDED);
+        MultiDlItemResult* itemResult;
+
+        EnterCriticalSection(&ctx->itemLock);
+        ctx->items[itemIndex].status = success ? MULTI_DL_COMPLETE : MULTI_DL_FAILED;
+        if (success) ctx->items[itemIndex].progressPercent = 100;
+        if (item->title) {
+            wcsncpy(ctx->items[itemIndex].title, item->title, 511);
+            ctx->items[itemIndex].title[511] = L'\0';
+        }
+        LeaveCriticalSection(&ctx->itemLock);
+
+        if (success) {
+            InterlockedIncrement(&ctx->completedCount);
+        } else {
+            InterlockedIncrement(&ctx->failedCount);
+            ThreadSafeDebugOutputF(L"MultiDlBatchItemChanged: %ls failed: %ls", item->url,
+                                   item->errorMessage ? item->errorMessage : L"(no error reported)");
+        }
+
+        itemResult = (MultiDlItemResult*)SAFE_MALLOC(sizeof(MultiDlItemResult));
+        if (itemResult) {
+            memset(itemResult, 0, sizeof(MultiDlItemResult));
+            itemResult->itemIndex = itemIndex;
+            itemResult->success = success;
+            wcsncpy(itemResult->url, item->url, MAX_URL_LENGTH - 1); itemResult->url[MAX_URL_LENGTH - 1] = L'\0';
+            if (item->title) {
+                wcsncpy(itemResult->title, item->title, 511); itemResult->title[511] = L'\0';
+            }
+            PostMessageW(ctx->hDialog, WM_MULTI_DL_ITEM_DONE, 0, (LPARAM)itemResult);
+        }
+    }
+}
+
+// Download every pending item, handing up to YtDlpBatchSize URLs to each
+// yt-dlp process so the queue pays its startup cost once per batch rather
+// than once per video
+static void MultiDlDownloadQueue(MultiDownloadContext* ctx) {
+    YtDlpConfig config = {0};
+    wchar_t downloadPath[MAX_EXTENDED_PATH];
+    wchar_t tempDir[MAX_EXTENDED_PATH];
+    wchar_t batchSizeText[16];
+    wchar_t** urls;
+    int* itemIndexes;
+    int batchSize;
+    int i;
+
+    if (!InitializeYtDlpConfig(&config)) {
+        ThreadSafeDebugOutput(L"MultiDlDownloadQueue: Failed to init config");
+        return;
+    }
+
+    if (!LoadSettingFromRegistry(REG_DOWNLOAD_PATH, downloadPath, MAX_EXTENDED_PATH)) {
+        GetDefaultDownloadPath(downloadPath, MAX_EXTENDED_PATH);
+    }
+    if (!CreateDownloadDirectoryIfNeeded(downloadPath) ||
+        (!CreateTempDirectory(&config, tempDir, MAX_EXTENDED_PATH) &&
+         !CreateYtDlpTempDirWithFallback(tempDir, MAX_EXTENDED_PATH))) {
+        ThreadSafeDebugOutput(L"MultiDlDownloadQueue: Failed to prepare download or temp directory");
+        CleanupYtDlpConfig(&config);
+        return;
+    }
+
+    batchSize = ParseYtDlpBatchSize(
+        LoadSettingFromRegistry(REG_YTDLP_BATCH_SIZE, batchSizeText, 16) ? batchSizeText : NULL);
+    ThreadSafeDebugOutputF(L"MultiDlDownloadQueue: Up to %d URLs per yt-dlp process", batchSize);
+
+    urls = (wchar_t**)SAFE_MALLOC(sizeof(wchar_t*) * batchSize);
+    itemIndexes = (int*)SAFE_MALLOC(sizeof(int) * batchSize);
+
+    while (urls && itemIndexes) {
+        YtDlpBatch batch;
+        MultiDlBatchProgress progress;
+        BOOL initialized;
+        int count = 0;
+
+        // Pausing holds back the next batch; the one running finishes
+        WaitForSingleObject(ctx->hPauseEvent, INFINITE);
+        if (InterlockedCompareExchange(&ctx->stopRequested, 0, 0)) break;
+
+        EnterCriticalSection(&ctx->itemLock);
+        for (i = 0; i < ctx->itemCount && count < batchSize; i++) {
+            if (ctx->items[i].status != MULTI_DL_PENDING) continue;
+            urls[count] = SAFE_WCSDUP(ctx->items[i].url);
+            if (!urls[count]) break;
+            ctx->items[i].status = MULTI_DL_DOWNLOADING;
+            itemIndexes[count++] = i;
+        }
+        LeaveCriticalSection(&ctx->itemLock);
+        if (count == 0) break;
+
+        progress.ctx = ctx;
+        progress.itemIndexes = itemIndexes;
+        initialized = InitYtDlpBatch(&batch, (const wchar_t* const*)urls, count, MultiDlBatchItemChanged, &progress);
+        if (initialized && !ExecuteYtDlpBatchThreadSafe(&config, &batch, downloadPath, tempDir, &ctx->stopRequested)) {
+            // yt-dlp never ran, so none of the batch was downloaded
+            FinishYtDlpBatch(&batch, FALSE);
+        }
+        FreeYtDlpBatch(&batch);
+
+        for (i = 0; i < count; i++) {
+            SAFE_FREE(urls[i]);
+        }
+        if (!initialized) break;
+    }
+
+    SAFE_FREE(urls);
+    SAFE_FREE(itemIndexes);
+    CleanupTempDirectory(tempDir);
+    CleanupYtDlpConfig(&config);
+}
+
 DWORD WINAPI MultiDlCoordinatorThread(LPVOID lpParam) {
     MultiDownloadContext* ctx = (MultiDownloadContext*)lpParam;
     int i;
@@ -3153,6 +3308,17 @@ DWORD WINAPI MultiDlCoordinatorThread(LPVOID lpParam) {
         }
     }
 
+    // Resolved playlists join the queue on the UI thread; let them land first
+    while (InterlockedCompareExchange(&ctx->pendingPlaylistResults, 0, 0) > 0 &&
+           !InterlockedCompareExchange(&ctx->stopRequested, 0, 0)) {
+        WaitForSingleObject(ctx->hPlaylistEvent, INFINITE);
+    }
+
+    // Phase 2: Download the queue
+    if (!InterlockedCompareExchange(&ctx->stopRequested, 0, 0)) {
+        MultiDlDownloadQueue(ctx);
+    }
+
     ThreadSafeDebugOutput(L"MultiDlCoordinatorThread: All done");
     PostMessageW(ctx->hDialog, WM_MULTI_DL_ALL_DONE, 0, 0);
     return 0;
@@ -3380,6 +3546,7 @@ INT_PTR CALLBACK MultiDownloadDialogProc(HWND hDlg, UINT message, WPARAM wParam,
                     ctx->failedCount = 0;
                     InitializeCriticalSection(&ctx->itemLock);
                     ctx->hPauseEvent = CreateEventW(NULL, TRUE, TRUE, NULL);
+                    ctx->hPlaylistEvent = CreateEventW(NULL, FALSE, FALSE, NULL);
 
                     SetPropW(hDlg, PROP_CTX, (HANDLE)ctx);
 
@@ -3430,6 +3597,7 @@ INT_PTR CALLBACK MultiDownloadDialogProc(HWND hDlg, UINT message, WPARAM wParam,
 
                     InterlockedExchange(&ctx->stopRequested, 1);
                     SetEvent(ctx->hPauseEvent);
+                    SetEvent(ctx->hPlaylistEvent);
                     SetDlgItemTextW(hDlg, IDC_MULTI_STATUS_LABEL, L"Status: Stopping...");
                     EnableWindow(GetDlgItem(hDlg, IDC_MULTI_STOP_BTN), FALSE);
                     EnableWindow(GetDlgItem(hDlg, IDC_MULTI_PAUSE_BTN), FALSE);
@@ -3441,12 +3609,14 @@ INT_PTR CALLBACK MultiDownloadDialogProc(HWND hDlg, UINT message, WPARAM wParam,
                     if (ctx && ctx->hCoordinatorThread) {
                         InterlockedExchange(&ctx->stopRequested, 1);
                         SetEvent(ctx->hPauseEvent);
+                        SetEvent(ctx->hPlaylistEvent);
                         WaitForSingleObject(ctx->hCoordinatorThread, 5000);
                         CloseHandle(ctx->hCoordinatorThread);
                         ctx->hCoordinatorThread = NULL;
 
                         DeleteCriticalSection(&ctx->itemLock);
                         if (ctx->hPauseEvent) CloseHandle(ctx->hPauseEvent);
+                        if (ctx->hPlaylistEvent) CloseHandle(ctx->hPlaylistEvent);
                         SAFE_FREE(ctx->items);
                         SAFE_FREE(ctx);
                         RemovePropW(hDlg, PROP_CTX);
@@ -3522,6 +3692,7 @@ INT_PTR CALLBACK MultiDownloadDialogProc(HWND hDlg, UINT message, WPARAM wParam,
 
                 DeleteCriticalSection(&ctx->itemLock);
                 if (ctx->hPauseEvent) CloseHandle(ctx->hPauseEvent);
+                if (ctx->hPlaylistEvent) CloseHandle(ctx->hPlaylistEvent);
                 SAFE_FREE(ctx->items);
                 SAFE_FREE(ctx);
                 RemovePropW(hDlg, PROP_CTX);
@@ -3601,6 +3772,11 @@ INT_PTR CALLBACK MultiDownloadDialogProc(HWND hDlg, UINT message, WPARAM wParam,
 
                     MultiDl_UpdateStatusLabel(hDlg, ctx);
                 }
+                if (ctx) {
+                    // Landed, even when empty, so the coordinator stops waiting on it
+                    InterlockedDecrement(&ctx->pendingPlaylistResults);
+                    SetEvent(ctx->hPlaylistEvent);
+                }
 
                 {
                     int freeIdx;
@@ -0,0 +1,102 @@
+#include "YouTubeCacher.h"
+
+#define LINE_DECODER_MIN_CAPACITY   256
+
+void InitLineDecoder(LineDecoder* decoder) {
+    if (decoder) memset(decoder, 0, sizeof(LineDecoder));
+}
+
+static void ReportLine(LineDecoder* decoder, const char* bytes, size_t length, LineDecoderCallback callback, void* context) {
+    int needed = 0;
+    if (length > 0) {
+        needed = MultiByteToWideChar(CP_UTF8, 0, bytes, (int)length, NULL, 0);
+        if (needed <= 0) return;
+    }
+
+    if ((size_t)needed + 1 > decoder->wideCapacity) {
+        size_t capacity = decoder->wideCapacity ? decoder->wideCapacity : LINE_DECODER_MIN_CAPACITY;
+        while (capacity < (size_t)needed + 1) capacity *= 2;
+        wchar_t* wide = (wchar_t*)SAFE_REALLOC(decoder->wide, capacity * sizeof(wchar_t));
+        if (!wide) return;
+        decoder->wide = wide;
+        decoder->wideCapacity = capacity;
+    }
+
+    if (needed > 0) {
+        needed = MultiByteToWideChar(CP_UTF8, 0, bytes, (int)length, decoder->wide, needed);
+        if (needed <= 0) return;
+    }
+    decoder->wide[needed] = L'\0';
+    callback(context, decoder->wide, (size_t)needed);
+}
+
+// Keep bytes of an unfinished line. Without the memory to grow, the line
+// is reported as it stands rather than losing any of it.
+static void KeepBytes(LineDecoder* decoder, const char* data, size_t length, LineDecoderCallback callback, void* context) {
+    if (decoder->length + length > decoder->capacity) {
+        size_t capacity = decoder->capacity ? decoder->capacity : LINE_DECODER_MIN_CAPACITY;
+        while (capacity < decoder->length + length) capacity *= 2;
+        char* bytes = (char*)SAFE_REALLOC(decoder->bytes, capacity);
+        if (!bytes) {
+            ReportLine(decoder, decoder->bytes, decoder->length, callback, context);
+            decoder->length = 0;
+            ReportLine(decoder, data, length, callback, context);
+            return;
+        }
+        decoder->bytes = bytes;
+        decoder->capacity = capacity;
+    }
+    memcpy(decoder->bytes + decoder->length, data, length);
+    decoder->length += length;
+}
+
+void DecodeLines(LineDecoder* decoder, const char* data, size_t length, LineDecoderCallback callback, void* context) {
+    if (!decoder || !data || !callback) return;
+
+    const char* end = data + length;
+    const char* start = data;
+    for (const char* p = data; p < end; p++) {
+        if (*p != '\n' && *p != '\r') {
+            decoder->afterCR = FALSE;
+            continue;
+        }
+
+        BOOL skip = (*p == '\n' && decoder->afterCR);
+        decoder->afterCR = (*p == '\r');
+        if (skip) {
+            start = p + 1;
+            continue;
+        }
+
+        // A line held over from earlier data is completed in place; one that
+        // lies wholly in this data is converted straight from it
+        if (decoder->length > 0) {
+            KeepBytes(decoder, start, (size_t)(p - start), callback, context);
+            ReportLine(decoder, decoder->bytes, decoder->length, callback, context);
+            decoder->length = 0;
+        } else {
+            ReportLine(decoder, start, (size_t)(p - start), callback, context);
+        }
+        start = p + 1;
+    }
+
+    if (start < end) KeepBytes(decoder, start, (size_t)(end - start), callback, context);
+}
+
+void FlushLineDecoder(LineDecoder* decoder, LineDecoderCallback callback, void* context) {
+    if (!decoder || !callback) return;
+
+    if (decoder->length > 0) {
+        ReportLine(decoder, decoder->bytes, decoder->length, callback, context);
+        decoder->length = 0;
+    }
+    decoder->afterCR = FALSE;
+}
+
+void FreeLineDecoder(LineDecoder* decoder) {
+    if (!decoder) return;
+
+    SAFE_FREE(decoder->bytes);
+    SAFE_FREE(decoder->wide);
+    memset(decoder, 0, sizeof(LineDecoder));
+}
@@ -0,0 +1,36 @@
+#ifndef LINEDECODER_H
+#define LINEDECODER_H
+
+#include <windows.h>
+
+// Splits a stream of UTF-8 output into wide-character lines.
+//
+// Bytes arrive in whatever pieces the pipe hands over; a line, or a single
+// character, may be split across any number of them. yt-dlp ends ordinary
+// lines with \n and redraws its progress line with \r, so both end a line,
+// and \r\n counts once. Neither byte can occur inside a multi-byte UTF-8
+// sequence, so a line is converted only once it is complete and a split
+// character is always whole by then. Lines can be of any length.
+//
+// A decoder holds all of its state, so every stream needs its own.
+
+// Receives one line without its terminator, NUL-terminated; valid only during the call
+typedef void (*LineDecoderCallback)(void* context, const wchar_t* line, size_t length);
+
+typedef struct {
+    char* bytes;            // UTF-8 of the unfinished line
+    size_t length;
+    size_t capacity;
+    wchar_t* wide;          // Conversion buffer, reused from line to line
+    size_t wideCapacity;
+    BOOL afterCR;           // The last byte was a \r, so a \n next ends nothing
+} LineDecoder;
+
+void InitLineDecoder(LineDecoder* decoder);
+// Report every line the data completes and keep the rest for later
+void DecodeLines(LineDecoder* decoder, const char* data, size_t length, LineDecoderCallback callback, void* context);
+// Report the unfinished line, if any, once the stream has ended
+void FlushLineDecoder(LineDecoder* decoder, LineDecoderCallback callback, void* context);
+void FreeLineDecoder(LineDecoder* decoder);
+
+#endif // LINEDECODER_H
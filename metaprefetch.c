@@ -0,0 +1,263 @@
+#include "YouTubeCacher.h"
+
+typedef struct {
+    wchar_t url[MAX_URL_LENGTH];
+    HWND hDlg;
+    volatile LONG cancelled;
+    BOOL adopted;                   // Guarded by the prefetcher's lock
+} MetadataPrefetch;
+
+typedef struct {
+    CRITICAL_SECTION lock;
+    BOOL initialized;
+    MetadataPrefetch* active[METADATA_PREFETCH_MAX_ACTIVE];
+    int activeCount;
+} MetadataPrefetcher;
+
+static MetadataPrefetcher g_prefetcher = {0};
+
+// Call with the lock held
+static void CancelPrefetchesLocked(const wchar_t* keepUrl, BOOL includeAdopted) {
+    for (int i = 0; i < g_prefetcher.activeCount; i++) {
+        MetadataPrefetch* prefetch = g_prefetcher.active[i];
+        if (keepUrl && wcscmp(prefetch->url, keepUrl) == 0) continue;
+        if (prefetch->adopted && !includeAdopted) continue;
+        if (!InterlockedExchange(&prefetch->cancelled, 1)) {
+            ThreadSafeDebugOutputF(L"MetadataPrefetch: Cancelling fetch for %ls", prefetch->url);
+        }
+    }
+}
+
+// Call with the lock held
+static void RemovePrefetchLocked(MetadataPrefetch* prefetch) {
+    for (int i = 0; i < g_prefetcher.activeCount; i++) {
+        if (g_prefetcher.active[i] == prefetch) {
+            g_prefetcher.active[i] = g_prefetcher.active[--g_prefetcher.activeCount];
+            g_prefetcher.active[g_prefetcher.activeCount] = NULL;
+            return;
+        }
+    }
+}
+
+// Run yt-dlp for the title and duration, giving up as soon as the fetch is cancelled
+static BOOL FetchMetadata(MetadataPrefetch* prefetch, VideoMetadata* metadata) {
+    YtDlpConfig config;
+    if (!InitializeYtDlpConfig(&config)) return FALSE;
+
+    BOOL fetched = FALSE;
+    YtDlpRequest* request = CreateYtDlpRequest(YTDLP_OP_GET_TITLE_DURATION, prefetch->url, NULL);
+    ThreadSafeSubprocessContext* context = request ? CreateThreadSafeSubprocessFromYtDlp(&config, request) : NULL;
+    if (context) {
+        // Whatever the user does next matters more than a guess
+        SetSubprocessPriorityClass(context, BELOW_NORMAL_PRIORITY_CLASS);
+
+        if (ExecuteThreadSafeSubprocessWithOutput(context)) {
+            BOOL finished = TRUE;
+            while (!WaitForThreadSafeSubprocessCompletion(context, 100)) {
+                if (InterlockedCompareExchange(&prefetch->cancelled, 0, 0)) {
+                    CancelThreadSafeSubprocess(context);
+                    if (!WaitForThreadSafeSubprocessCompletion(context, 1000)) {
+                        ForceKillThreadSafeSubprocess(context);
+                    }
+                    finished = FALSE;
+                    break;
+                }
+            }
+
+            wchar_t* output = NULL;
+            size_t length = 0;
+            DWORD exitCode = 0;
+            if (finished && WaitForThreadSafeSubprocessWithOutputCompletion(context, 2000) &&
+                GetFinalThreadSafeSubprocessOutput(context, &output, &length, &exitCode)) {
+                if (exitCode == 0) {
+                    fetched = ParseTitleDurationOutput(output, metadata);
+                } else {
+                    ThreadSafeDebugOutputF(L"MetadataPrefetch: yt-dlp exited with code %lu", exitCode);
+                }
+            }
+            SAFE_FREE(output);
+        }
+        CleanupThreadSafeSubprocessContext(context);
+        SAFE_FREE(context);
+    }
+
+    if (request) FreeYtDlpRequest(request);
+    CleanupYtDlpConfig(&config);
+    return fetched;
+}
+
+static DWORD WINAPI MetadataPrefetchThread(LPVOID lpParam) {
+    MetadataPrefetch* prefetch = (MetadataPrefetch*)lpParam;
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+
+    VideoMetadata* metadata = (VideoMetadata*)SAFE_MALLOC(sizeof(VideoMetadata));
+    BOOL fetched = FALSE;
+    if (metadata) {
+        memset(metadata, 0, sizeof(VideoMetadata));
+        fetched = FetchMetadata(prefetch, metadata);
+    }
+    ThreadSafeDebugOutputF(L"MetadataPrefetch: Fetch for %ls %ls", prefetch->url,
+                           fetched ? L"succeeded" : L"failed");
+
+    // Leave the active set, and settle where the result goes, in one step so
+    // a click either takes over this fetch or finds it gone
+    EnterCriticalSection(&g_prefetcher.lock);
+    RemovePrefetchLocked(prefetch);
+    BOOL adopted = prefetch->adopted;
+    BOOL cancelled = prefetch->cancelled != 0;
+    LeaveCriticalSection(&g_prefetcher.lock);
+
+    if (adopted) {
+        // The receiver frees the metadata, as for a Get Info
+        if (!PostMessageW(prefetch->hDlg, WM_USER + 103, (WPARAM)fetched, (LPARAM)metadata)) {
+            if (metadata) {
+                FreeVideoMetadata(metadata);
+                SAFE_FREE(metadata);
+            }
+        }
+    } else {
+        MetadataPrefetchResult* result = NULL;
+        if (!cancelled && metadata) {
+            result = (MetadataPrefetchResult*)SAFE_MALLOC(sizeof(MetadataPrefetchResult));
+        }
+        if (result) {
+            result->url = SAFE_WCSDUP(prefetch->url);
+            result->metadata = metadata;
+            if (!result->url || !PostMessageW(prefetch->hDlg, WM_METADATA_PREFETCHED, 0, (LPARAM)result)) {
+                FreeMetadataPrefetchResult(result);
+            }
+        } else if (metadata) {
+            FreeVideoMetadata(metadata);
+            SAFE_FREE(metadata);
+        }
+    }
+
+    SAFE_FREE(prefetch);
+    return fetched ? 0 : 1;
+}
+
+void InitializeMetadataPrefetcher(void) {
+    if (g_prefetcher.initialized) return;
+
+    InitializeCriticalSection(&g_prefetcher.lock);
+    g_prefetcher.activeCount = 0;
+    g_prefetcher.initialized = TRUE;
+}
+
+void ShutdownMetadataPrefetcher(void) {
+    if (!g_prefetcher.initialized) return;
+
+    EnterCriticalSection(&g_prefetcher.lock);
+    CancelPrefetchesLocked(NULL, TRUE);
+    LeaveCriticalSection(&g_prefetcher.lock);
+
+    // A cancelled fetch stops its yt-dlp within about a second
+    int remaining = 0;
+    for (int waited = 0; waited <= 3000; waited += 50) {
+        EnterCriticalSection(&g_prefetcher.lock);
+        remaining = g_prefetcher.activeCount;
+        LeaveCriticalSection(&g_prefetcher.lock);
+        if (remaining == 0) break;
+        Sleep(50);
+    }
+
+    // A fetch still running will take the lock again, so it has to outlive us
+    if (remaining > 0) {
+        ThreadSafeDebugOutputF(L"MetadataPrefetch: %d fetches still running at shutdown", remaining);
+        return;
+    }
+    g_prefetcher.initialized = FALSE;
+    DeleteCriticalSection(&g_prefetcher.lock);
+}
+
+BOOL StartMetadataPrefetch(HWND hDlg, const wchar_t* url) {
+    if (!g_prefetcher.initialized || !hDlg || !url || url[0] == L'\0' || wcslen(url) >= MAX_URL_LENGTH) {
+        return FALSE;
+    }
+
+    MetadataPrefetch* prefetch = NULL;
+    BOOL running = FALSE;
+
+    EnterCriticalSection(&g_prefetcher.lock);
+    // Nobody needs the other URLs any more
+    CancelPrefetchesLocked(url, FALSE);
+
+    for (int i = 0; i < g_prefetcher.activeCount; i++) {
+        MetadataPrefetch* other = g_prefetcher.active[i];
+        if (wcscmp(other->url, url) == 0 && !other->cancelled) {
+            running = TRUE;
+            break;
+        }
+    }
+
+    if (!running && g_prefetcher.activeCount < METADATA_PREFETCH_MAX_ACTIVE) {
+        prefetch = (MetadataPrefetch*)SAFE_MALLOC(sizeof(MetadataPrefetch));
+        if (prefetch) {
+            memset(prefetch, 0, sizeof(MetadataPrefetch));
+            wcscpy(prefetch->url, url);
+            prefetch->hDlg = hDlg;
+            g_prefetcher.active[g_prefetcher.activeCount++] = prefetch;
+        }
+    }
+    int activeCount = g_prefetcher.activeCount;
+    LeaveCriticalSection(&g_prefetcher.lock);
+
+    if (running) return TRUE;
+    if (!prefetch) {
+        ThreadSafeDebugOutputF(L"MetadataPrefetch: Not fetching %ls, %d fetches already running", url, activeCount);
+        return FALSE;
+    }
+
+    HANDLE hThread = CreateThread(NULL, 0, MetadataPrefetchThread, prefetch, 0, NULL);
+    if (!hThread) {
+        EnterCriticalSection(&g_prefetcher.lock);
+        RemovePrefetchLocked(prefetch);
+        LeaveCriticalSection(&g_prefetcher.lock);
+        SAFE_FREE(prefetch);
+        return FALSE;
+    }
+    CloseHandle(hThread);
+
+    ThreadSafeDebugOutputF(L"MetadataPrefetch: Fetching metadata for %ls", url);
+    return TRUE;
+}
+
+void CancelMetadataPrefetchesExcept(const wchar_t* url) {
+    if (!g_prefetcher.initialized) return;
+
+    EnterCriticalSection(&g_prefetcher.lock);
+    CancelPrefetchesLocked(url, FALSE);
+    LeaveCriticalSection(&g_prefetcher.lock);
+}
+
+BOOL AdoptMetadataPrefetch(const wchar_t* url) {
+    if (!g_prefetcher.initialized || !url) return FALSE;
+
+    BOOL adopted = FALSE;
+    EnterCriticalSection(&g_prefetcher.lock);
+    for (int i = 0; i < g_prefetcher.activeCount; i++) {
+        MetadataPrefetch* prefetch = g_prefetcher.active[i];
+        if (wcscmp(prefetch->url, url) == 0 && !prefetch->cancelled) {
+            prefetch->adopted = TRUE;
+            adopted = TRUE;
+            break;
+        }
+    }
+    LeaveCriticalSection(&g_prefetcher.lock);
+
+    if (adopted) {
+        ThreadSafeDebugOutputF(L"MetadataPrefetch: Taking over the fetch for %ls", url);
+    }
+    return adopted;
+}
+
+void FreeMetadataPrefetchResult(MetadataPrefetchResult* result) {
+    if (!result) return;
+
+    if (result->metadata) {
+        FreeVideoMetadata(result->metadata);
+        SAFE_FREE(result->metadata);
+    }
+    SAFE_FREE(result->url);
+    SAFE_FREE(result);
+}
@@ -0,0 +1,49 @@
+#ifndef METAPREFETCH_H
+#define METAPREFETCH_H
+
+#include <windows.h>
+
+// Speculative title and duration fetch for a URL that has just landed in the
+// URL box.
+//
+// Autopaste puts a YouTube URL in the box long before the user clicks
+// Download, and that click used to begin with a few seconds of waiting on
+// yt-dlp for the title and duration. The prefetcher asks yt-dlp straight
+// away, from a below-normal priority thread and process, and posts the answer
+// to the main window, which keeps it as the cached metadata for that URL. A
+// click that comes while the fetch is still running takes it over rather than
+// starting a second one.
+//
+// Only the URL in the box is worth fetching: a fetch for another URL is
+// cancelled when a new one starts, the same URL is never fetched twice at
+// once, and no more than METADATA_PREFETCH_MAX_ACTIVE run at a time, counting
+// cancelled ones that have not finished yet.
+
+#define METADATA_PREFETCH_MAX_ACTIVE    2
+
+// Result of a fetch nobody took over, posted as WM_METADATA_PREFETCHED
+typedef struct {
+    wchar_t* url;
+    VideoMetadata* metadata;        // success is FALSE when yt-dlp failed
+} MetadataPrefetchResult;
+
+void InitializeMetadataPrefetcher(void);
+
+// Cancel every fetch and wait a little while for them to end
+void ShutdownMetadataPrefetcher(void);
+
+// Start fetching url's metadata for hDlg. TRUE if a fetch for url is running
+// afterwards, whether this call started it or an earlier one did.
+BOOL StartMetadataPrefetch(HWND hDlg, const wchar_t* url);
+
+// Cancel the fetches for any URL but url (NULL cancels them all), except one
+// that has been taken over
+void CancelMetadataPrefetchesExcept(const wchar_t* url);
+
+// Take over the running fetch for url: its result comes as the WM_USER + 103
+// a Get Info would have posted. FALSE if there is none to take over.
+BOOL AdoptMetadataPrefetch(const wchar_t* url);
+
+void FreeMetadataPrefetchResult(MetadataPrefetchResult* result);
+
+#endif // METAPREFETCH_H
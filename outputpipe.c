@@ -0,0 +1,154 @@
+#include "YouTubeCacher.h"
+
+struct OutputPipeReader {
+    HANDLE hPipe;
+    OVERLAPPED overlapped;
+    BOOL readPending;
+    char buffer[OUTPUT_PIPE_READ_SIZE + 1];
+};
+
+BOOL CreateOutputPipe(HANDLE* hRead, HANDLE* hWrite, LPSECURITY_ATTRIBUTES writeAttributes) {
+    static volatile LONG pipeCount = 0;
+    if (!hRead || !hWrite) return FALSE;
+    *hRead = NULL;
+    *hWrite = NULL;
+
+    // Anonymous pipes cannot do overlapped I/O, so give each pipe a name no
+    // other process can have opened first
+    wchar_t name[64];
+    swprintf(name, 64, L"\\\\.\\pipe\\YouTubeCacher.%08lx.%08lx",
+             (unsigned long)GetCurrentProcessId(), (unsigned long)InterlockedIncrement(&pipeCount));
+
+    HANDLE hServer = CreateNamedPipeW(name, PIPE_ACCESS_INBOUND | FILE_FLAG_OVERLAPPED | FILE_FLAG_FIRST_PIPE_INSTANCE,
+                                      PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT, 1,
+                                      OUTPUT_PIPE_BUFFER_SIZE, OUTPUT_PIPE_BUFFER_SIZE, 0, NULL);
+    if (hServer == INVALID_HANDLE_VALUE) {
+        ThreadSafeDebugOutputF(L"YouTubeCacher: CreateOutputPipe - Cannot create pipe (error %lu)", GetLastError());
+        return FALSE;
+    }
+
+    HANDLE hClient = CreateFileW(name, GENERIC_WRITE, 0, writeAttributes, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hClient == INVALID_HANDLE_VALUE) {
+        ThreadSafeDebugOutputF(L"YouTubeCacher: CreateOutputPipe - Cannot open pipe (error %lu)", GetLastError());
+        CloseHandle(hServer);
+        return FALSE;
+    }
+
+    *hRead = hServer;
+    *hWrite = hClient;
+    return TRUE;
+}
+
+OutputPipeReader* OpenOutputPipeReader(HANDLE hPipe) {
+    if (!hPipe || hPipe == INVALID_HANDLE_VALUE) return NULL;
+
+    OutputPipeReader* reader = (OutputPipeReader*)SAFE_MALLOC(sizeof(OutputPipeReader));
+    if (!reader) return NULL;
+    memset(reader, 0, sizeof(OutputPipeReader));
+
+    reader->hPipe = hPipe;
+    reader->overlapped.hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+    if (!reader->overlapped.hEvent) {
+        SAFE_FREE(reader);
+        return NULL;
+    }
+    return reader;
+}
+
+// Collect the outstanding read once it has finished
+static int CompleteOutputPipeRead(OutputPipeReader* reader, DWORD* length) {
+    reader->readPending = FALSE;
+    if (GetOverlappedResult(reader->hPipe, &reader->overlapped, length, TRUE)) {
+        reader->buffer[*length] = '\0';
+        return OUTPUT_PIPE_DATA;
+    }
+
+    *length = 0;
+    DWORD error = GetLastError();
+    if (error == ERROR_BROKEN_PIPE) return OUTPUT_PIPE_CLOSED;
+    if (error != ERROR_OPERATION_ABORTED) {
+        ThreadSafeDebugOutputF(L"YouTubeCacher: ReadOutputPipe - Read failed (error %lu)", error);
+    }
+    return OUTPUT_PIPE_FAILED;
+}
+
+// Give up on the outstanding read, unless it took some bytes before it could be cancelled
+static int AbandonOutputPipeRead(OutputPipeReader* reader, int result, DWORD* length) {
+    CancelIoEx(reader->hPipe, &reader->overlapped);
+    if (CompleteOutputPipeRead(reader, length) == OUTPUT_PIPE_DATA && *length > 0) return OUTPUT_PIPE_DATA;
+
+    *length = 0;
+    return result;
+}
+
+int ReadOutputPipe(OutputPipeReader* reader, HANDLE hProcess, HANDLE hCancel, DWORD timeoutMs,
+                   char** data, DWORD* length) {
+    if (!reader || !data || !length) return OUTPUT_PIPE_FAILED;
+    *data = reader->buffer;
+    *length = 0;
+
+    for (;;) {
+        if (!reader->readPending) {
+            HANDLE hEvent = reader->overlapped.hEvent;
+            memset(&reader->overlapped, 0, sizeof(OVERLAPPED));
+            reader->overlapped.hEvent = hEvent;
+
+            // A read that completes at once still signals the event, so it is
+            // collected below like one that had to wait
+            if (!ReadFile(reader->hPipe, reader->buffer, OUTPUT_PIPE_READ_SIZE, NULL, &reader->overlapped)) {
+                DWORD error = GetLastError();
+                if (error == ERROR_BROKEN_PIPE) return OUTPUT_PIPE_CLOSED;
+                if (error != ERROR_IO_PENDING) {
+                    ThreadSafeDebugOutputF(L"YouTubeCacher: ReadOutputPipe - Cannot read (error %lu)", error);
+                    return OUTPUT_PIPE_FAILED;
+                }
+            }
+            reader->readPending = TRUE;
+        }
+
+        // The read comes first so that output wins over an exit signalled at the same time
+        HANDLE handles[3];
+        int results[3];
+        DWORD count = 0;
+        handles[count] = reader->overlapped.hEvent;
+        results[count++] = OUTPUT_PIPE_DATA;
+        if (hCancel) {
+            handles[count] = hCancel;
+            results[count++] = OUTPUT_PIPE_CANCELLED;
+        }
+        if (hProcess) {
+            handles[count] = hProcess;
+            results[count++] = OUTPUT_PIPE_EXITED;
+        }
+
+        DWORD wait = WaitForMultipleObjects(count, handles, FALSE, timeoutMs);
+        if (wait == WAIT_TIMEOUT) return OUTPUT_PIPE_TIMEOUT;
+        if (wait >= WAIT_OBJECT_0 + count) {
+            ThreadSafeDebugOutputF(L"YouTubeCacher: ReadOutputPipe - Wait failed (error %lu)", GetLastError());
+            return AbandonOutputPipeRead(reader, OUTPUT_PIPE_FAILED, length);
+        }
+
+        int result = results[wait - WAIT_OBJECT_0];
+        if (result != OUTPUT_PIPE_DATA) {
+            // Whatever the process wrote before it exited is already in the pipe,
+            // and a read still waiting now would only wait for its children
+            return AbandonOutputPipeRead(reader, result, length);
+        }
+
+        result = CompleteOutputPipeRead(reader, length);
+        if (result != OUTPUT_PIPE_DATA || *length > 0) return result;
+    }
+}
+
+void CloseOutputPipeReader(OutputPipeReader* reader) {
+    if (!reader) return;
+
+    // The outstanding read writes into the buffer until it is cancelled
+    if (reader->readPending) {
+        DWORD bytes = 0;
+        CancelIoEx(reader->hPipe, &reader->overlapped);
+        GetOverlappedResult(reader->hPipe, &reader->overlapped, &bytes, TRUE);
+    }
+    if (reader->overlapped.hEvent) CloseHandle(reader->overlapped.hEvent);
+    SAFE_FREE(reader);
+}
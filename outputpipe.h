@@ -0,0 +1,48 @@
+#ifndef OUTPUTPIPE_H
+#define OUTPUTPIPE_H
+
+#include <windows.h>
+
+// Output capture for yt-dlp and other child processes.
+//
+// The child writes to an ordinary inheritable handle; the parent reads the
+// other end of a named pipe opened for overlapped I/O. One read is kept
+// outstanding and the reader thread sleeps in a single wait on the read, the
+// process and a cancel event together, so output is consumed the moment it is
+// written and a download that prints nothing costs no wakeups at all.
+//
+// The pipe buffer is large enough that a burst of progress lines never blocks
+// the child while the reader is busy with the previous batch.
+
+#define OUTPUT_PIPE_BUFFER_SIZE     (64 * 1024)   // Pipe quota, in each direction
+#define OUTPUT_PIPE_READ_SIZE       4096          // Most bytes returned by one read
+
+// Results of a read
+#define OUTPUT_PIPE_DATA            0   // Bytes are in the reader's buffer
+#define OUTPUT_PIPE_TIMEOUT         1   // Nothing yet; the read stays outstanding
+#define OUTPUT_PIPE_EXITED          2   // The process exited and everything it wrote has been read
+#define OUTPUT_PIPE_CLOSED          3   // Every write end was closed and the pipe is drained
+#define OUTPUT_PIPE_CANCELLED       4
+#define OUTPUT_PIPE_FAILED          5
+
+typedef struct OutputPipeReader OutputPipeReader;
+
+// Create a pipe for a child's stdout and stderr. The write end gets the given
+// attributes so the child can inherit it; the read end is never inherited.
+BOOL CreateOutputPipe(HANDLE* hRead, HANDLE* hWrite, LPSECURITY_ATTRIBUTES writeAttributes);
+
+// Reads from the read end of an output pipe, which stays owned by the caller.
+// A reader belongs to the thread that reads with it.
+OutputPipeReader* OpenOutputPipeReader(HANDLE hPipe);
+
+// Wait up to timeoutMs (or INFINITE) for output, for hProcess to exit or for
+// hCancel to be set; either handle may be NULL. On OUTPUT_PIPE_DATA *data
+// points at *length bytes, followed by a NUL, which the caller may modify
+// until the next read. Output written before the process exited is always returned before
+// OUTPUT_PIPE_EXITED, even when another process still holds the write end.
+int ReadOutputPipe(OutputPipeReader* reader, HANDLE hProcess, HANDLE hCancel, DWORD timeoutMs,
+                   char** data, DWORD* length);
+
+void CloseOutputPipeReader(OutputPipeReader* reader);
+
+#endif // OUTPUTPIPE_H
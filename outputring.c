@@ -0,0 +1,174 @@
+#include "YouTubeCacher.h"
+
+struct OutputRing {
+    char* bytes;
+    DWORD size;                 // A power of two, so positions wrap with a mask
+    volatile LONG writePos;     // Bytes ever written, modulo 2^32; moved by the writer only
+    volatile LONG readPos;      // Bytes ever consumed, modulo 2^32; moved by the reader only
+    volatile LONG writerClosed;
+    volatile LONG readerClosed;
+    volatile LONG readerWaiting; // The reader found the ring empty and waits, or is about to
+    volatile LONG writerWaiting; // The writer found the ring full and waits, or is about to
+    HANDLE dataEvent;           // Set when bytes arrive for a waiting reader, or the writer closes
+    HANDLE spaceEvent;          // Set when room is given back to a waiting writer, or the reader closes
+    OutputRingStats stats;      // Each field is written by one side only
+};
+
+OutputRing* CreateOutputRing(DWORD size) {
+    if (size == 0 || size > 0x40000000) return NULL;
+
+    OutputRing* ring = (OutputRing*)SAFE_MALLOC(sizeof(OutputRing));
+    if (!ring) return NULL;
+    memset(ring, 0, sizeof(OutputRing));
+
+    ring->size = 1;
+    while (ring->size < size) ring->size <<= 1;
+    ring->stats.size = ring->size;
+
+    ring->bytes = (char*)SAFE_MALLOC(ring->size);
+    ring->dataEvent = CreateEventW(NULL, FALSE, FALSE, NULL);
+    ring->spaceEvent = CreateEventW(NULL, FALSE, FALSE, NULL);
+    if (!ring->bytes || !ring->dataEvent || !ring->spaceEvent) {
+        FreeOutputRing(ring);
+        return NULL;
+    }
+    return ring;
+}
+
+void FreeOutputRing(OutputRing* ring) {
+    if (!ring) return;
+
+    if (ring->dataEvent) CloseHandle(ring->dataEvent);
+    if (ring->spaceEvent) CloseHandle(ring->spaceEvent);
+    SAFE_FREE(ring->bytes);
+    SAFE_FREE(ring);
+}
+
+BOOL WriteOutputRing(OutputRing* ring, const char* data, DWORD length, HANDLE hCancel) {
+    if (!ring || (!data && length > 0)) return FALSE;
+
+    while (length > 0) {
+        if (ring->readerClosed) return FALSE;
+
+        DWORD writePos = (DWORD)ring->writePos;
+        DWORD used = writePos - (DWORD)ring->readPos;
+        // The reader is done with everything before readPos before we reuse it
+        MemoryBarrier();
+
+        if (used == ring->size) {
+            // The parser has fallen a whole ring behind; wait for it. The flag
+            // goes up before the second look, so room given back after that
+            // look finds it raised and sets the event.
+            InterlockedExchange(&ring->writerWaiting, 1);
+            if ((DWORD)ring->readPos != writePos - ring->size || ring->readerClosed) {
+                InterlockedExchange(&ring->writerWaiting, 0);
+                continue;
+            }
+            HANDLE handles[2] = { ring->spaceEvent, hCancel };
+            DWORD waitStart = GetTickCount();
+            ring->stats.writerStalls++;
+            DWORD waitResult = WaitForMultipleObjects(hCancel ? 2 : 1, handles, FALSE, INFINITE);
+            ring->stats.writerStallMs += GetTickCount() - waitStart;
+            InterlockedExchange(&ring->writerWaiting, 0);
+            if (waitResult != WAIT_OBJECT_0) return FALSE;
+            continue;
+        }
+
+        DWORD offset = writePos & (ring->size - 1);
+        DWORD chunk = ring->size - used;
+        if (chunk > ring->size - offset) chunk = ring->size - offset;
+        if (chunk > length) chunk = length;
+        memcpy(ring->bytes + offset, data, chunk);
+
+        // Publish the bytes, then wake the reader only if it found the ring empty
+        InterlockedExchange(&ring->writePos, (LONG)(writePos + chunk));
+        if (ring->readerWaiting) SetEvent(ring->dataEvent);
+
+        used += chunk;
+        if (used > ring->stats.highWater) ring->stats.highWater = used;
+        ring->stats.bytesWritten += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+    return TRUE;
+}
+
+void CloseOutputRingWriter(OutputRing* ring) {
+    if (!ring) return;
+
+    InterlockedExchange(&ring->writerClosed, 1);
+    SetEvent(ring->dataEvent);
+}
+
+int ReadOutputRing(OutputRing* ring, DWORD timeoutMs, const char** data, DWORD* length) {
+    if (data) *data = NULL;
+    if (length) *length = 0;
+    if (!ring || !data || !length) return OUTPUT_RING_CLOSED;
+
+    DWORD start = GetTickCount();
+    for (;;) {
+        // The writer publishes its last bytes before closing, so a ring seen
+        // closed and then empty is drained for good
+        LONG closed = ring->writerClosed;
+        MemoryBarrier();
+        DWORD readPos = (DWORD)ring->readPos;
+        DWORD used = (DWORD)ring->writePos - readPos;
+        MemoryBarrier();
+
+        if (used > 0) {
+            DWORD offset = readPos & (ring->size - 1);
+            *data = ring->bytes + offset;
+            *length = used < ring->size - offset ? used : ring->size - offset;
+            return OUTPUT_RING_DATA;
+        }
+        if (closed) return OUTPUT_RING_CLOSED;
+
+        DWORD waitMs = INFINITE;
+        if (timeoutMs != INFINITE) {
+            DWORD elapsed = GetTickCount() - start;
+            if (elapsed >= timeoutMs) return OUTPUT_RING_TIMEOUT;
+            waitMs = timeoutMs - elapsed;
+        }
+
+        // As for the writer: raise the flag, then look once more before waiting
+        InterlockedExchange(&ring->readerWaiting, 1);
+        if ((DWORD)ring->writePos != readPos || ring->writerClosed) {
+            InterlockedExchange(&ring->readerWaiting, 0);
+            continue;
+        }
+        DWORD waitStart = GetTickCount();
+        DWORD waitResult = WaitForSingleObject(ring->dataEvent, waitMs);
+        ring->stats.readerWaitMs += GetTickCount() - waitStart;
+        InterlockedExchange(&ring->readerWaiting, 0);
+        if (waitResult == WAIT_TIMEOUT) timeoutMs = 0;
+        else if (waitResult != WAIT_OBJECT_0) return OUTPUT_RING_CLOSED;
+    }
+}
+
+void ConsumeOutputRing(OutputRing* ring, DWORD length) {
+    if (!ring || length == 0) return;
+
+    DWORD readPos = (DWORD)ring->readPos;
+    DWORD used = (DWORD)ring->writePos - readPos;
+    if (length > used) length = used;
+
+    // Hand the room back, then wake the writer only if it found the ring full
+    InterlockedExchange(&ring->readPos, (LONG)(readPos + length));
+    if (ring->writerWaiting) SetEvent(ring->spaceEvent);
+}
+
+void CloseOutputRingReader(OutputRing* ring) {
+    if (!ring) return;
+
+    InterlockedExchange(&ring->readerClosed, 1);
+    SetEvent(ring->spaceEvent);
+}
+
+void GetOutputRingStats(const OutputRing* ring, OutputRingStats* stats) {
+    if (!stats) return;
+    if (!ring) {
+        memset(stats, 0, sizeof(OutputRingStats));
+        return;
+    }
+    *stats = ring->stats;
+}
@@ -0,0 +1,61 @@
+#ifndef OUTPUTRING_H
+#define OUTPUTRING_H
+
+#include <windows.h>
+
+// A byte ring between the thread that drains a child's output pipe and the
+// thread that parses what it wrote.
+//
+// Exactly one thread writes and one reads, so the ring takes no lock: the
+// writer alone moves the write position and the reader alone the read
+// position, each publishing its own with a barrier once the bytes behind it
+// are in place. Events only wake a side that ran out of data or of room: a
+// side raises a flag before it waits and looks once more, and the other sets
+// the event only while the flag is up, so a chunk costs no kernel call while
+// both keep up. The ring is far larger than the pipe, so a slow parse, a
+// stalled debug log or a busy UI thread holds up the parser alone while the
+// drain keeps the pipe empty and yt-dlp never waits on its stdout.
+//
+// Both sides record backpressure: how full the ring got and how long the
+// writer waited for room, which means the parser fell behind, and how long
+// the reader waited for data, which means it kept up.
+
+#define OUTPUT_RING_SIZE            (1024 * 1024)   // Rounded up to a power of two
+
+// Results of a read
+#define OUTPUT_RING_DATA            0   // Bytes are waiting at *data
+#define OUTPUT_RING_TIMEOUT         1
+#define OUTPUT_RING_CLOSED          2   // The writer closed the ring and every byte has been read
+
+typedef struct {
+    DWORD size;
+    DWORD highWater;            // Most bytes held at once
+    ULONGLONG bytesWritten;
+    DWORD writerStalls;         // Times the writer found the ring full
+    DWORD writerStallMs;        // Time the writer spent waiting for room
+    DWORD readerWaitMs;         // Time the reader spent waiting for data
+} OutputRingStats;
+
+typedef struct OutputRing OutputRing;
+
+OutputRing* CreateOutputRing(DWORD size);
+void FreeOutputRing(OutputRing* ring);
+
+// Writer side. Copy in all of data, waiting for room while the reader is
+// behind; FALSE if the reader closed its end or hCancel (may be NULL) was set
+// first. Once closed, the reader sees OUTPUT_RING_CLOSED after the last byte.
+BOOL WriteOutputRing(OutputRing* ring, const char* data, DWORD length, HANDLE hCancel);
+void CloseOutputRingWriter(OutputRing* ring);
+
+// Reader side. Wait up to timeoutMs (or INFINITE) for bytes; on
+// OUTPUT_RING_DATA *data points at *length of them, which stay in place
+// until ConsumeOutputRing gives the room back. A wrapped run comes in two
+// reads. Closing the reader makes any further write fail.
+int ReadOutputRing(OutputRing* ring, DWORD timeoutMs, const char** data, DWORD* length);
+void ConsumeOutputRing(OutputRing* ring, DWORD length);
+void CloseOutputRingReader(OutputRing* ring);
+
+// A copy of the figures so far; exact once both sides are done
+void GetOutputRingStats(const OutputRing* ring, OutputRingStats* stats);
+
+#endif // OUTPUTRING_H
@@ -1032,6 +1032,91 @@ BOOL StartEnhancedSubprocessExecution(EnhancedSubprocessContext* context) {
     return TRUE;
 }
 
+// State the worker's line handler needs, one per download
+typedef struct {
+    EnhancedSubprocessContext* enhancedContext;
+    size_t outputLength;            // Characters in accumulatedOutput
+    DWORD lastOutputTime;
+    DWORD noOutputWarningTime;
+} EnhancedOutputLines;
+
+// Process one decoded line of yt-dlp output
+static void HandleEnhancedOutputLine(void* param, const wchar_t* line, size_t length) {
+    EnhancedOutputLines* lines = (EnhancedOutputLines*)param;
+    EnhancedSubprocessContext* enhancedContext = lines->enhancedContext;
+    SubprocessContext* context = enhancedContext->baseContext;
+    EnhancedProgressInfo* progress = enhancedContext->enhancedProgress;
+
+    if (length == 0) return;
+
+    // Update last output time since we received data
+    lines->lastOutputTime = GetTickCount();
+    lines->noOutputWarningTime = 0; // Reset warning flag
+
+    // Process the line with enhanced processing
+    EnterCriticalSection(&enhancedContext->progressLock);
+    ProcessYtDlpOutputLine(line, progress);
+    LeaveCriticalSection(&enhancedContext->progressLock);
+
+    // Add to accumulated output, keeping what was collected if it cannot grow
+    if (context->accumulatedOutput) {
+        size_t newLen = lines->outputLength + length + 2;
+        if (newLen > context->outputBufferSize) {
+            wchar_t* newBuffer = (wchar_t*)SAFE_REALLOC(context->accumulatedOutput, newLen * 2 * sizeof(wchar_t));
+            if (newBuffer) {
+                context->accumulatedOutput = newBuffer;
+                context->outputBufferSize = newLen * 2;
+            }
+        }
+
+        if (newLen <= context->outputBufferSize) {
+            memcpy(context->accumulatedOutput + lines->outputLength, line, length * sizeof(wchar_t));
+            lines->outputLength += length;
+            context->accumulatedOutput[lines->outputLength++] = L'\n';
+            context->accumulatedOutput[lines->outputLength] = L'\0';
+        }
+    }
+
+    // Update progress callback with enhanced information
+    if (context->progressCallback) {
+        EnterCriticalSection(&enhancedContext->progressLock);
+        const wchar_t* statusMsg = progress->statusMessage ? progress->statusMessage : L"Processing...";
+        context->progressCallback(progress->progressPercentage, statusMsg, context->callbackUserData);
+        LeaveCriticalSection(&enhancedContext->progressLock);
+    }
+}
+
+// The drain stage of a download: moves yt-dlp's output from the pipe into the
+// ring as fast as it is written, however far behind the parser is
+typedef struct {
+    OutputPipeReader* reader;
+    HANDLE hProcess;
+    HANDLE hCancel;
+    OutputRing* ring;
+    int result;                     // How the output ended, one of OUTPUT_PIPE_*
+} EnhancedOutputDrain;
+
+static DWORD WINAPI EnhancedOutputDrainThread(LPVOID lpParam) {
+    EnhancedOutputDrain* drain = (EnhancedOutputDrain*)lpParam;
+    char* buffer = NULL;
+    DWORD bytesRead = 0;
+
+    for (;;) {
+        drain->result = ReadOutputPipe(drain->reader, drain->hProcess, drain->hCancel, INFINITE, &buffer, &bytesRead);
+        if (drain->result != OUTPUT_PIPE_DATA) break;
+
+        // Only cancellation, or the parser giving up, stops a write
+        if (!WriteOutputRing(drain->ring, buffer, bytesRead, drain->hCancel)) {
+            drain->result = OUTPUT_PIPE_CANCELLED;
+            break;
+        }
+    }
+
+    // The result is in place before the parser can see the ring closed
+    CloseOutputRingWriter(drain->ring);
+    return 0;
+}
+
 // Enhanced subprocess worker thread
 DWORD WINAPI EnhancedSubprocessWorkerThread(LPVOID lpParam) {
     ThreadSafeDebugOutput(L"YouTubeCacher: EnhancedSubprocessWorkerThread started");
@@ -1090,7 +1175,7 @@ DWORD WINAPI EnhancedSubprocessWorkerThread(LPVOID lpParam) {
 
     // Create pipes for output capture
     SECURITY_ATTRIBUTES sa = { sizeof(sa), NULL, TRUE };
-    if (!CreatePipe(&context->hOutputRead, &context->hOutputWrite, &sa, 0)) {
+    if (!CreateOutputPipe(&context->hOutputRead, &context->hOutputWrite, &sa)) {
         DWORD error = GetLastError();
         ThreadSafeDebugOutput(L"YouTubeCacher: EnhancedSubprocessWorkerThread - FAILED to create output pipe");
         context->result->success = FALSE;
@@ -1100,8 +1185,6 @@ DWORD WINAPI EnhancedSubprocessWorkerThread(LPVOID lpParam) {
         return 1;
     }
 
-    SetHandleInformation(context->hOutputRead, HANDLE_FLAG_INHERIT, 0);
-
     // Setup process startup info
     STARTUPINFOW si = {0};
     si.cb = sizeof(si);
@@ -1178,27 +1261,44 @@ DWORD WINAPI EnhancedSubprocessWorkerThread(LPVOID lpParam) {
         context->accumulatedOutput[0] = L'\0';
     }
 
-    // Enhanced output reading loop with line-by-line processing
-    char buffer[4096];
-    DWORD bytesRead;
-    BOOL processRunning = TRUE;
-    int loopCount = 0;
-
-    // Line accumulator for UTF-8 processing
-    static char lineAccumulator[8192] = {0};
-    static size_t fillCounter = 0;
+    // Output goes through two stages: a drain thread empties the pipe into a
+    // ring the moment yt-dlp writes, and this thread parses from the ring, so
+    // slow parsing, logging or UI updates never leave yt-dlp blocked on stdout
+    OutputPipeReader* reader = OpenOutputPipeReader(context->hOutputRead);
+    OutputRing* ring = CreateOutputRing(OUTPUT_RING_SIZE);
+    EnhancedOutputDrain drain;
+    drain.reader = reader;
+    drain.hProcess = pi.hProcess;
+    drain.hCancel = context->threadContext.cancelEvent;
+    drain.ring = ring;
+    drain.result = OUTPUT_PIPE_FAILED;
+    HANDLE hDrainThread = NULL;
+    if (reader && ring) {
+        hDrainThread = CreateThread(NULL, 0, EnhancedOutputDrainThread, &drain, 0, NULL);
+    }
+    if (!hDrainThread) {
+        // Nobody would drain the pipe, so yt-dlp would block once it filled
+        ThreadSafeDebugOutput(L"YouTubeCacher: EnhancedSubprocessWorkerThread - FAILED to start output drain");
+        TerminateProcess(pi.hProcess, 1);
+    }
+
+    // Output lines are split and decoded per download, so downloads running
+    // at the same time never share a partial line
+    LineDecoder decoder;
+    InitLineDecoder(&decoder);
+    EnhancedOutputLines lines;
+    lines.enhancedContext = enhancedContext;
+    lines.outputLength = 0;
 
     // Timeout tracking
     DWORD startTime = GetTickCount();
     // Use a very long timeout (24 hours) - downloads should be allowed to run as long as needed
     DWORD timeoutMs = 24 * 60 * 60 * 1000; // 24 hours
-    DWORD lastOutputTime = startTime;
-    DWORD noOutputWarningTime = 0;
+    lines.lastOutputTime = startTime;
+    lines.noOutputWarningTime = 0;
     const DWORD NO_OUTPUT_WARNING_THRESHOLD = 30000; // Warn after 30 seconds of no output
 
-    while (processRunning || fillCounter > 0) {
-        loopCount++;
-
+    while (hDrainThread) {
         // Check for cancellation
         if (IsCancellationRequested(&context->threadContext)) {
             ThreadSafeDebugOutput(L"YouTubeCacher: EnhancedSubprocessWorkerThread - Cancellation requested");
@@ -1216,147 +1316,64 @@ DWORD WINAPI EnhancedSubprocessWorkerThread(LPVOID lpParam) {
             break;
         }
 
-        // Check if process is still running
-        DWORD waitResult = WaitForSingleObject(pi.hProcess, 100); // 100ms timeout
-        if (waitResult == WAIT_OBJECT_0) {
-            processRunning = FALSE;
-        }
-
         // Warn if no output for extended period (but process still running)
-        DWORD timeSinceLastOutput = currentTime - lastOutputTime;
-        if (processRunning && timeSinceLastOutput > NO_OUTPUT_WARNING_THRESHOLD && noOutputWarningTime == 0) {
+        DWORD timeSinceLastOutput = currentTime - lines.lastOutputTime;
+        if (timeSinceLastOutput > NO_OUTPUT_WARNING_THRESHOLD && lines.noOutputWarningTime == 0) {
             ThreadSafeDebugOutput(L"YouTubeCacher: EnhancedSubprocessWorkerThread - No output for 30+ seconds, but process still running");
-            noOutputWarningTime = currentTime;
+            lines.noOutputWarningTime = currentTime;
             UpdateDownloadState(progress, DOWNLOAD_STATE_DOWNLOADING, L"Download in progress (no progress info available)");
         }
 
-        // Read available output
-        DWORD bytesAvailable = 0;
-        if (PeekNamedPipe(context->hOutputRead, NULL, 0, NULL, &bytesAvailable, NULL) && bytesAvailable > 0) {
-            if (ReadFile(context->hOutputRead, buffer, sizeof(buffer) - 1, &bytesRead, NULL) && bytesRead > 0) {
-                buffer[bytesRead] = '\0';
-
-                // Safely add new bytes to accumulator with bounds checking
-                size_t spaceAvailable = sizeof(lineAccumulator) - fillCounter - 1;
-                size_t bytesToCopy = (bytesRead < spaceAvailable) ? bytesRead : spaceAvailable;
-
-                if (bytesToCopy > 0) {
-                    memcpy(lineAccumulator + fillCounter, buffer, bytesToCopy);
-                    fillCounter += bytesToCopy;
-                    lineAccumulator[fillCounter] = '\0';
-                }
-
-                // Process complete lines with enhanced processing
-                // yt-dlp uses both \n and \r as line terminators
-                // Progress updates use \r to overwrite the same line
-                char* start = lineAccumulator;
-                char* lineEnd;
-
-                // Look for either \n or \r as line terminators
-                while ((lineEnd = strpbrk(start, "\n\r")) != NULL) {
-                    char terminator = *lineEnd;
-                    *lineEnd = '\0';
-
-                    // Calculate line length
-                    size_t lineLen = lineEnd - start;
-
-                    // Remove trailing \r or \n if present
-                    if (lineLen > 0 && (start[lineLen - 1] == '\r' || start[lineLen - 1] == '\n')) {
-                        start[lineLen - 1] = '\0';
-                        lineLen--;
-                    }
-
-                    // Convert this complete UTF-8 line to wide chars
-                    if (lineLen > 0) {
-                        wchar_t wideLineBuffer[2048];
-                        int converted = MultiByteToWideChar(CP_UTF8, 0, start, (int)lineLen, wideLineBuffer, 2047);
-                        if (converted > 0) {
-                            wideLineBuffer[converted] = L'\0';
-
-                            // Update last output time since we received data
-                            lastOutputTime = GetTickCount();
-                            noOutputWarningTime = 0; // Reset warning flag
-
-                            // Process the line with enhanced processing
-                            EnterCriticalSection(&enhancedContext->progressLock);
-                            ProcessYtDlpOutputLine(wideLineBuffer, progress);
-                            LeaveCriticalSection(&enhancedContext->progressLock);
-
-                            // Add to accumulated output
-                            if (context->accumulatedOutput) {
-                                size_t currentLen = wcslen(context->accumulatedOutput);
-                                size_t newLen = currentLen + converted + 2;
-                                if (newLen >= context->outputBufferSize) {
-                                    context->outputBufferSize = newLen * 2;
-                                    wchar_t* newBuffer = (wchar_t*)SAFE_REALLOC(context->accumulatedOutput,
-                                                                          context->outputBufferSize * sizeof(wchar_t));
-                                    if (newBuffer) {
-                                        context->accumulatedOutput = newBuffer;
-                                    }
-                                }
-
-                                if (context->accumulatedOutput) {
-                                    wcscat(context->accumulatedOutput, wideLineBuffer);
-                                    wcscat(context->accumulatedOutput, L"\n");
-                                }
-                            }
-
-                            // Update progress callback with enhanced information
-                            if (context->progressCallback) {
-                                EnterCriticalSection(&enhancedContext->progressLock);
-                                const wchar_t* statusMsg = progress->statusMessage ? progress->statusMessage : L"Processing...";
-                                context->progressCallback(progress->progressPercentage, statusMsg, context->callbackUserData);
-                                LeaveCriticalSection(&enhancedContext->progressLock);
-                            }
-                        }
-                    }
-
-                    start = lineEnd + 1;
-
-                    // If we hit a \r, skip any following \n (handle \r\n sequences)
-                    if (terminator == '\r' && *start == '\n') {
-                        start++;
-                    }
-                }
-
-                // Move remaining incomplete data to start of buffer
-                size_t remaining = fillCounter - (start - lineAccumulator);
-                if (remaining > 0 && start != lineAccumulator) {
-                    memmove(lineAccumulator, start, remaining);
-                }
-                fillCounter = remaining;
-                lineAccumulator[fillCounter] = '\0';
-            }
+        // Sleep until output arrives, or until the next deadline: the warning
+        // while it is still to come, then the overall timeout
+        DWORD waitMs = timeoutMs - elapsedTime;
+        if (lines.noOutputWarningTime == 0 && NO_OUTPUT_WARNING_THRESHOLD - timeSinceLastOutput < waitMs) {
+            waitMs = NO_OUTPUT_WARNING_THRESHOLD - timeSinceLastOutput + 1;
         }
 
-        // If process has exited and no more data, break
-        if (!processRunning && fillCounter == 0) {
+        const char* data = NULL;
+        DWORD dataLength = 0;
+        int ringResult = ReadOutputRing(ring, waitMs, &data, &dataLength);
+        if (ringResult == OUTPUT_RING_TIMEOUT) {
+            continue;
+        }
+        if (ringResult == OUTPUT_RING_CLOSED) {
+            // Everything drained has been parsed; the drain says why it stopped
+            if (drain.result == OUTPUT_PIPE_CANCELLED) {
+                ThreadSafeDebugOutput(L"YouTubeCacher: EnhancedSubprocessWorkerThread - Cancellation requested");
+                TerminateProcess(pi.hProcess, 1);
+            } else if (drain.result == OUTPUT_PIPE_FAILED) {
+                ThreadSafeDebugOutput(L"YouTubeCacher: EnhancedSubprocessWorkerThread - FAILED to read output");
+                TerminateProcess(pi.hProcess, 1);
+            }
             break;
         }
 
-        // Small delay to prevent excessive CPU usage
-        if (bytesAvailable == 0) {
-            Sleep(50);
-        }
+        // Hand every complete line to the parser, then give the room back
+        DecodeLines(&decoder, data, dataLength, HandleEnhancedOutputLine, &lines);
+        ConsumeOutputRing(ring, dataLength);
     }
 
-    // Process any remaining data in the accumulator
-    if (fillCounter > 0) {
-        wchar_t wideLineBuffer[2048];
-        int converted = MultiByteToWideChar(CP_UTF8, 0, lineAccumulator, (int)fillCounter, wideLineBuffer, 2047);
-        if (converted > 0) {
-            wideLineBuffer[converted] = L'\0';
+    // Process any unterminated last line
+    FlushLineDecoder(&decoder, HandleEnhancedOutputLine, &lines);
+    FreeLineDecoder(&decoder);
 
-            EnterCriticalSection(&enhancedContext->progressLock);
-            ProcessYtDlpOutputLine(wideLineBuffer, progress);
-            LeaveCriticalSection(&enhancedContext->progressLock);
+    // Stop the drain stage. Leaving the loop early terminated the process,
+    // which ends the drain's wait on the pipe.
+    if (hDrainThread) {
+        CloseOutputRingReader(ring);
+        WaitForSingleObject(hDrainThread, INFINITE);
+        CloseHandle(hDrainThread);
 
-            if (context->accumulatedOutput) {
-                wcscat(context->accumulatedOutput, wideLineBuffer);
-            }
-        }
-        fillCounter = 0;
+        OutputRingStats* stats = &enhancedContext->outputStats;
+        GetOutputRingStats(ring, stats);
+        ThreadSafeDebugOutputF(L"YouTubeCacher: EnhancedSubprocessWorkerThread - Output %llu bytes, ring high-water %lu of %lu, "
+                               L"drain stalled %lu times for %lu ms, parser waited %lu ms",
+                               stats->bytesWritten, stats->highWater, stats->size,
+                               stats->writerStalls, stats->writerStallMs, stats->readerWaitMs);
     }
+    FreeOutputRing(ring);
+    CloseOutputPipeReader(reader);
 
     // Wait for process completion and get exit code
     WaitForSingleObject(pi.hProcess, INFINITE);
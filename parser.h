@@ -128,6 +128,7 @@ typedef struct {
     EnhancedProgressInfo* enhancedProgress;
     CRITICAL_SECTION progressLock;
     BOOL useEnhancedProcessing;
+    OutputRingStats outputStats;    // Backpressure between output drain and parser, once the process is done
 } EnhancedSubprocessContext;
 
 // Enhanced subprocess functions
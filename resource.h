@@ -64,6 +64,10 @@
 #define IDC_ENABLE_DEBUG       1055
 #define IDC_ENABLE_LOGFILE     1056
 #define IDC_ENABLE_AUTOPASTE   1057
+#define IDC_CACHE_LIMIT_LABEL  1048
+#define IDC_CACHE_LIMIT        1049
+#define IDC_CACHE_POLICY_LABEL 1050
+#define IDC_CACHE_POLICY       1051
 
 // Video Information Controls
 #define IDC_VIDEO_TITLE_LABEL  1041
@@ -73,6 +77,9 @@
 #define IDC_PROGRESS_TEXT      1045
 #define IDC_VIDEO_PROGRESS     1046  // "Video: X/Y" for playlist downloads
 
+// Cache list search box
+#define IDC_CACHE_FILTER       1047
+
 // Unified Dialog - handles all message types (info, warning, error, success)
 #define IDD_UNIFIED_DIALOG     105
 #define IDC_UNIFIED_ICON       1032
@@ -135,5 +142,7 @@
 #define ID_LISTVIEW_COPY_PATH  2022
 #define ID_LISTVIEW_COPY_URL   2023
 #define ID_LISTVIEW_SELECTALL  2024
+#define ID_LISTVIEW_FIND_DUPLICATES 2025
+#define ID_LISTVIEW_REDOWNLOAD 2026
 
 #endif // RESOURCE_H
\ No newline at end of file
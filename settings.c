@@ -235,6 +235,50 @@ BOOL SaveSettingToRegistry(const wchar_t* valueName, const wchar_t* value) {
     return result;
 }
 
+// Load the storage budget of a download root; roots without one have no limit
+BOOL LoadCacheBudgetSetting(const wchar_t* downloadPath, CacheBudget* budget) {
+    if (!downloadPath || !budget) return FALSE;
+    
+    budget->limitBytes = 0;
+    budget->policy = CACHE_EVICT_LRU;
+    
+    HKEY hKey;
+    BOOL result = FALSE;
+    if (RegOpenKeyExW(HKEY_CURRENT_USER, REGISTRY_KEY L"\\" REG_CACHE_BUDGETS, 0, KEY_READ, &hKey) == ERROR_SUCCESS) {
+        wchar_t value[64];
+        DWORD dataType;
+        DWORD dataSize = sizeof(value) - sizeof(wchar_t);
+        if (RegQueryValueExW(hKey, downloadPath, NULL, &dataType, (LPBYTE)value, &dataSize) == ERROR_SUCCESS &&
+            dataType == REG_SZ) {
+            value[dataSize / sizeof(wchar_t)] = L'\0';
+            result = ParseCacheBudget(value, budget);
+        }
+        RegCloseKey(hKey);
+    }
+    
+    return result;
+}
+
+// Save the storage budget of a download root
+BOOL SaveCacheBudgetSetting(const wchar_t* downloadPath, const CacheBudget* budget) {
+    if (!downloadPath || !budget) return FALSE;
+    
+    HKEY hKey;
+    BOOL result = FALSE;
+    if (RegCreateKeyExW(HKEY_CURRENT_USER, REGISTRY_KEY L"\\" REG_CACHE_BUDGETS, 0, NULL, REG_OPTION_NON_VOLATILE,
+                       KEY_WRITE, NULL, &hKey, NULL) == ERROR_SUCCESS) {
+        wchar_t value[64];
+        FormatCacheBudget(budget, value, 64);
+        DWORD dataSize = (DWORD)((wcslen(value) + 1) * sizeof(wchar_t));
+        if (RegSetValueExW(hKey, downloadPath, 0, REG_SZ, (const BYTE*)value, dataSize) == ERROR_SUCCESS) {
+            result = TRUE;
+        }
+        RegCloseKey(hKey);
+    }
+    
+    return result;
+}
+
 // Function to load settings from registry into dialog controls
 void LoadSettings(HWND hDlg) {
     wchar_t buffer[MAX_EXTENDED_PATH];
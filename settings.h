@@ -6,6 +6,8 @@
 // Registry operations
 BOOL LoadSettingFromRegistry(const wchar_t* valueName, wchar_t* buffer, DWORD bufferSize);
 BOOL SaveSettingToRegistry(const wchar_t* valueName, const wchar_t* value);
+BOOL LoadCacheBudgetSetting(const wchar_t* downloadPath, CacheBudget* budget);
+BOOL SaveCacheBudgetSetting(const wchar_t* downloadPath, const CacheBudget* budget);
 
 // Settings management
 void LoadSettings(HWND hDlg);
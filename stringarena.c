@@ -0,0 +1,75 @@
+#include "YouTubeCacher.h"
+
+#define STRING_ARENA_ALIGN(n) (((n) + sizeof(void*) - 1) & ~(sizeof(void*) - 1))
+
+static StringArenaBlock* AddStringArenaBlock(StringArena* arena, size_t minSize) {
+    size_t size = arena->blockSize;
+    if (size < minSize) size = minSize;
+
+    StringArenaBlock* block = (StringArenaBlock*)SAFE_MALLOC(STRING_ARENA_ALIGN(sizeof(StringArenaBlock)) + size);
+    if (!block) return NULL;
+
+    block->size = size;
+    block->used = 0;
+    block->next = arena->blocks;
+    arena->blocks = block;
+    return block;
+}
+
+StringArena* CreateStringArena(size_t blockSize) {
+    StringArena* arena = (StringArena*)SAFE_MALLOC(sizeof(StringArena));
+    if (!arena) return NULL;
+
+    arena->blocks = NULL;
+    arena->blockSize = blockSize ? STRING_ARENA_ALIGN(blockSize) : STRING_ARENA_DEFAULT_BLOCK_SIZE;
+    arena->totalBytes = 0;
+    arena->refCount = 1;
+    return arena;
+}
+
+void* StringArenaAlloc(StringArena* arena, size_t size) {
+    if (!arena || size == 0) return NULL;
+
+    size = STRING_ARENA_ALIGN(size);
+    StringArenaBlock* block = arena->blocks;
+    if (!block || block->size - block->used < size) {
+        // Oversized requests get a block of their own
+        block = AddStringArenaBlock(arena, size);
+        if (!block) return NULL;
+    }
+
+    BYTE* result = (BYTE*)block + STRING_ARENA_ALIGN(sizeof(StringArenaBlock)) + block->used;
+    block->used += size;
+    arena->totalBytes += size;
+    return result;
+}
+
+wchar_t* StringArenaWcsDup(StringArena* arena, const wchar_t* str) {
+    if (!str) return NULL;
+
+    size_t bytes = (wcslen(str) + 1) * sizeof(wchar_t);
+    wchar_t* copy = (wchar_t*)StringArenaAlloc(arena, bytes);
+    if (copy) {
+        memcpy(copy, str, bytes);
+    }
+    return copy;
+}
+
+void RetainStringArena(StringArena* arena) {
+    if (arena) {
+        InterlockedIncrement(&arena->refCount);
+    }
+}
+
+// Drop one reference; the last one frees every block at once
+void ReleaseStringArena(StringArena* arena) {
+    if (!arena || InterlockedDecrement(&arena->refCount) != 0) return;
+
+    StringArenaBlock* block = arena->blocks;
+    while (block) {
+        StringArenaBlock* next = block->next;
+        SAFE_FREE(block);
+        block = next;
+    }
+    SAFE_FREE(arena);
+}
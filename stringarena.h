@@ -0,0 +1,36 @@
+#ifndef STRINGARENA_H
+#define STRINGARENA_H
+
+#include <windows.h>
+
+// Bump allocator for many small strings that share one lifetime.
+//
+// Allocations are carved out of large blocks and are never freed one by one;
+// the whole arena is freed when its last reference is released. One thread
+// fills an arena at a time, while references can be dropped from any thread.
+// Cache loads create one arena per batch and every entry built from the batch
+// holds a reference, so removing entries never frees arena memory directly.
+
+#define STRING_ARENA_DEFAULT_BLOCK_SIZE (64u * 1024u)
+
+typedef struct StringArenaBlock {
+    struct StringArenaBlock* next;
+    size_t size;                // Usable bytes after the header
+    size_t used;
+} StringArenaBlock;
+
+typedef struct StringArena {
+    StringArenaBlock* blocks;   // Most recent block first
+    size_t blockSize;
+    size_t totalBytes;          // Bytes handed out, including alignment padding
+    volatile LONG refCount;
+} StringArena;
+
+// Returns an arena holding one reference
+StringArena* CreateStringArena(size_t blockSize);
+void* StringArenaAlloc(StringArena* arena, size_t size);
+wchar_t* StringArenaWcsDup(StringArena* arena, const wchar_t* str);
+void RetainStringArena(StringArena* arena);
+void ReleaseStringArena(StringArena* arena);
+
+#endif // STRINGARENA_H
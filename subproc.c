@@ -159,6 +159,85 @@ YtDlpResult* ExecuteYtDlpRequestThreadSafe(const YtDlpConfig* config, const YtDl
     return result;
 }
 
+static void TrackYtDlpBatchOutputLine(const wchar_t* line, void* userData) {
+    TrackYtDlpBatchLine((YtDlpBatch*)userData, line);
+}
+
+/**
+ * Download a batch of URLs with one yt-dlp process, attributing each line of
+ * its output to the URL it belongs to as it arrives
+ */
+BOOL ExecuteYtDlpBatchThreadSafe(const YtDlpConfig* config, YtDlpBatch* batch, const wchar_t* outputPath,
+                                 const wchar_t* tempDir, volatile LONG* stopRequested) {
+    if (!config || !batch || batch->count <= 0 || !outputPath || !tempDir) {
+        return FALSE;
+    }
+
+    ThreadSafeDebugOutputF(L"ExecuteYtDlpBatchThreadSafe: Starting batch of %d URLs", batch->count);
+
+    wchar_t batchFile[MAX_EXTENDED_PATH];
+    swprintf(batchFile, MAX_EXTENDED_PATH, L"%ls\\batch-%lu.txt", tempDir, GetCurrentThreadId());
+    if (!WriteYtDlpBatchFile(batch, batchFile)) {
+        ThreadSafeDebugOutputF(L"ExecuteYtDlpBatchThreadSafe: Failed to write batch file %ls", batchFile);
+        return FALSE;
+    }
+
+    StartNewYtDlpInvocation();
+
+    BOOL started = FALSE;
+    ThreadSafeSubprocessContext* context = NULL;
+    YtDlpRequest* request = CreateYtDlpRequest(YTDLP_OP_DOWNLOAD_BATCH, batchFile, outputPath);
+    if (request) {
+        request->tempDir = SAFE_WCSDUP(tempDir);
+        context = CreateThreadSafeSubprocessFromYtDlp(config, request);
+    }
+    if (context) {
+        SetSubprocessLineCallback(context, TrackYtDlpBatchOutputLine, batch);
+        started = ExecuteThreadSafeSubprocessWithOutput(context);
+    }
+
+    if (started) {
+        // The batch runs as long as its downloads take, so rather than a
+        // timeout it waits on the process and the stop request
+        BOOL stopped = FALSE;
+        while (!WaitForThreadSafeSubprocessCompletion(context, 250)) {
+            if (stopRequested && InterlockedCompareExchange(stopRequested, 0, 0)) {
+                ThreadSafeDebugOutput(L"ExecuteYtDlpBatchThreadSafe: Stop requested, cancelling yt-dlp");
+                CancelThreadSafeSubprocess(context);
+                if (!WaitForThreadSafeSubprocessCompletion(context, 2000)) {
+                    ForceKillThreadSafeSubprocess(context);
+                }
+                stopped = TRUE;
+                break;
+            }
+        }
+
+        // Let the reader hand over the last lines before settling the results
+        WaitForThreadSafeSubprocessWithOutputCompletion(context, 5000);
+        ThreadSafeDebugOutputF(L"ExecuteYtDlpBatchThreadSafe: yt-dlp exited with code %lu",
+                              GetThreadSafeSubprocessExitCode(context));
+
+        // The caller frees the batch once this returns, so a reader still going
+        // is cut off from it, and keeps the context it still reads
+        if (!IsThreadSafeSubprocessOutputComplete(context)) {
+            ThreadSafeDebugOutput(L"ExecuteYtDlpBatchThreadSafe: Output reader still running, leaving it the context");
+            SetSubprocessLineCallback(context, NULL, NULL);
+            context = NULL;
+        }
+        FinishYtDlpBatch(batch, stopped);
+    } else {
+        ThreadSafeDebugOutput(L"ExecuteYtDlpBatchThreadSafe: Failed to start yt-dlp");
+    }
+
+    if (context) {
+        CleanupThreadSafeSubprocessContext(context);
+        SAFE_FREE(context);
+    }
+    if (request) FreeYtDlpRequest(request);
+    DeleteFileW(batchFile);
+    return started;
+}
+
 /**
  * Enhanced subprocess context creation with progress callback support
  */
@@ -0,0 +1,151 @@
+#include "mock_windows.h"
+
+// Prevent inclusion of the full application header
+#define YOUTUBECACHER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <wctype.h>
+#include <time.h>
+
+#include "../cache.h"
+
+void ThreadSafeDebugOutput(const wchar_t* message) { (void)message; }
+
+#include "cache_duration.c"
+#include "../cachecolumns.c"
+#include "../cachesearch.c"
+
+// Microbenchmark: trigram index build time and query latency against a
+// case-insensitive wcsstr scan of every title, at 10k and 100k entries.
+
+static const wchar_t* const vocabulary[] = {
+    L"Official", L"Music", L"Video", L"Live", L"Lyrics", L"Remix", L"Tutorial", L"Guitar", L"Piano", L"Lesson",
+    L"Cooking", L"Recipe", L"Pasta", L"Bread", L"Review", L"Unboxing", L"Phone", L"Camera", L"Travel", L"Vlog",
+    L"Tokyo", L"Paris", L"Lecture", L"Physics", L"History", L"Rome", L"Speedrun", L"World", L"Record", L"Highlights",
+    L"Football", L"Chess", L"Opening", L"Documentary", L"Ocean", L"Space", L"Station", L"Interview", L"Podcast", L"Episode"
+};
+#define VOCABULARY_SIZE (sizeof(vocabulary) / sizeof(vocabulary[0]))
+
+static double NowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static unsigned long long NextRandom(unsigned long long* state) {
+    unsigned long long x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1Dull;
+}
+
+// Video IDs shaped like YouTube's: 11 characters from the base64url alphabet
+static void MakeVideoId(wchar_t* out, unsigned long long* state) {
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+    for (int i = 0; i < 11; i++) {
+        out[i] = (wchar_t)alphabet[NextRandom(state) & 63];
+    }
+    out[11] = L'\0';
+}
+
+// Four to eight vocabulary words and an episode number
+static void MakeTitle(wchar_t* out, size_t size, unsigned long long* state) {
+    int words = 4 + (int)(NextRandom(state) % 5);
+    size_t used = 0;
+    for (int i = 0; i < words; i++) {
+        used += swprintf(out + used, size - used, L"%ls ", vocabulary[NextRandom(state) % VOCABULARY_SIZE]);
+    }
+    swprintf(out + used, size - used, L"#%u", (unsigned int)(NextRandom(state) % 5000));
+}
+
+// What a filter without an index does: fold and search every title on each keystroke
+static DWORD NaiveSearch(CacheEntry* entries, int count, const wchar_t* query) {
+    DWORD found = 0;
+    wchar_t folded[256];
+    for (int i = 0; i < count; i++) {
+        size_t j = 0;
+        for (const wchar_t* p = entries[i].title; *p && j < 255; p++) {
+            folded[j++] = (wchar_t)towlower(*p);
+        }
+        folded[j] = L'\0';
+        if (wcsstr(folded, query)) found++;
+    }
+    return found;
+}
+
+static void RunBenchmark(int count) {
+    CacheEntry* entries = (CacheEntry*)calloc(count, sizeof(CacheEntry));
+    wchar_t* ids = (wchar_t*)malloc((size_t)count * 12 * sizeof(wchar_t));
+    wchar_t* titles = (wchar_t*)malloc((size_t)count * 128 * sizeof(wchar_t));
+    CacheColumns columns;
+    if (!entries || !ids || !titles || !InitCacheColumns(&columns, (DWORD)count)) {
+        printf("%8d: allocation failed\n", count);
+        free(entries);
+        free(ids);
+        free(titles);
+        return;
+    }
+
+    unsigned long long state = 0x9E3779B97F4A7C15ull;
+    for (int i = 0; i < count; i++) {
+        MakeVideoId(ids + (size_t)i * 12, &state);
+        MakeTitle(titles + (size_t)i * 128, 128, &state);
+        entries[i].videoId = ids + (size_t)i * 12;
+        entries[i].title = titles + (size_t)i * 128;
+        AppendCacheColumnsRow(&columns, &entries[i]);
+    }
+
+    CacheSearchIndex index;
+    InitCacheSearchIndex(&index);
+    double start = NowSeconds();
+    BuildCacheSearchIndex(&index, &columns);
+    double buildTime = NowSeconds() - start;
+    printf("%8d entries  build %7.1f ms  (%lu trigrams)\n",
+           count, buildTime * 1e3, (unsigned long)index.trigramCount);
+
+    // Rare and common words, a word prefix, an exact video ID and a miss
+    wchar_t idQuery[12];
+    for (int i = 0; i < 12; i++) idQuery[i] = (wchar_t)towlower(entries[count / 2].videoId[i]);
+    const wchar_t* queries[] = { L"#1234", L"documentary", L"guitar lesson", L"pho", L"vi", idQuery, L"zebra" };
+
+    for (size_t q = 0; q < sizeof(queries) / sizeof(queries[0]); q++) {
+        int iterations = 200;
+        DWORD matchCount = 0;
+        start = NowSeconds();
+        for (int i = 0; i < iterations; i++) {
+            CacheSearchMatch* matches = NULL;
+            SearchCacheIndex(&index, queries[q], &matches, &matchCount);
+            free(matches);
+        }
+        double indexTime = (NowSeconds() - start) / iterations;
+
+        int naiveIterations = 5;
+        volatile DWORD naiveCount = 0;
+        start = NowSeconds();
+        for (int i = 0; i < naiveIterations; i++) {
+            naiveCount = NaiveSearch(entries, count, queries[q]);
+        }
+        double naiveTime = (NowSeconds() - start) / naiveIterations;
+
+        printf("%8d entries  %-14ls %7lu hits  index %9.1f us  scan %9.1f us\n",
+               count, queries[q], (unsigned long)matchCount, indexTime * 1e6, naiveTime * 1e6);
+        (void)naiveCount;
+    }
+
+    FreeCacheSearchIndex(&index);
+    FreeCacheColumns(&columns);
+    free(entries);
+    free(ids);
+    free(titles);
+}
+
+int main() {
+    RunBenchmark(10000);
+    RunBenchmark(100000);
+    return 0;
+}
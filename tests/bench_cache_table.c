@@ -0,0 +1,130 @@
+#include "mock_windows.h"
+
+// Prevent inclusion of the full application header
+#define YOUTUBECACHER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <time.h>
+
+#include "../cache.h"
+#include "../cachetable.h"
+#include "../cachetable.c"
+
+// Microbenchmark: insert and lookup cost of CacheHashTable against the previous
+// fixed 1024-bucket djb2 chains, at 1k, 100k and 1M entries.
+
+#define LEGACY_BUCKETS 1024
+
+typedef struct LegacyNode {
+    CacheEntry* entry;
+    struct LegacyNode* next;
+} LegacyNode;
+
+static unsigned int LegacyHash(const wchar_t* videoId) {
+    unsigned int hash = 5381;
+    while (*videoId) {
+        hash = ((hash << 5) + hash) + *videoId++;
+    }
+    return hash % LEGACY_BUCKETS;
+}
+
+static double NowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Video IDs shaped like YouTube's: 11 characters from the base64url alphabet
+static void MakeVideoId(wchar_t* out, unsigned int seed) {
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+    unsigned long long x = (unsigned long long)seed * 0x9E3779B97F4A7C15ull + 1;
+    for (int i = 0; i < 11; i++) {
+        x ^= x >> 29;
+        x *= 0xBF58476D1CE4E5B9ull;
+        out[i] = (wchar_t)alphabet[(x >> 58) & 63];
+    }
+    out[11] = L'\0';
+}
+
+static void RunBenchmark(int count, BOOL includeLegacy) {
+    CacheEntry* entries = (CacheEntry*)calloc(count, sizeof(CacheEntry));
+    wchar_t* ids = (wchar_t*)malloc((size_t)count * 12 * sizeof(wchar_t));
+    if (!entries || !ids) {
+        printf("%8d: allocation failed\n", count);
+        free(entries);
+        free(ids);
+        return;
+    }
+    for (int i = 0; i < count; i++) {
+        MakeVideoId(ids + (size_t)i * 12, (unsigned int)i);
+        entries[i].videoId = ids + (size_t)i * 12;
+    }
+
+    int lookups = count < 1000000 ? 1000000 : count;
+    volatile size_t found = 0;
+
+    // Open-addressing table (growing from empty, as AddCacheEntry does)
+    CacheHashTable table;
+    InitCacheHashTable(&table, 0);
+    double start = NowSeconds();
+    for (int i = 0; i < count; i++) {
+        CacheHashTableInsert(&table, &entries[i]);
+    }
+    double insertTime = NowSeconds() - start;
+
+    start = NowSeconds();
+    for (int i = 0; i < lookups; i++) {
+        found += CacheHashTableFind(&table, entries[i % count].videoId) != NULL;
+    }
+    double lookupTime = NowSeconds() - start;
+
+    printf("%8d entries  table:  insert %7.1f ns/op  lookup %7.1f ns/op  (capacity %lu)\n",
+           count, insertTime * 1e9 / count, lookupTime * 1e9 / lookups, (unsigned long)table.capacity);
+    FreeCacheHashTable(&table);
+
+    // Previous fixed-size chained buckets
+    if (includeLegacy) {
+        LegacyNode* buckets[LEGACY_BUCKETS] = {0};
+        LegacyNode* nodes = (LegacyNode*)malloc((size_t)count * sizeof(LegacyNode));
+        if (nodes) {
+            start = NowSeconds();
+            for (int i = 0; i < count; i++) {
+                unsigned int h = LegacyHash(entries[i].videoId);
+                nodes[i].entry = &entries[i];
+                nodes[i].next = buckets[h];
+                buckets[h] = &nodes[i];
+            }
+            insertTime = NowSeconds() - start;
+
+            int legacyLookups = count >= 100000 ? 20000 : lookups;
+            start = NowSeconds();
+            for (int i = 0; i < legacyLookups; i++) {
+                const wchar_t* id = entries[i % count].videoId;
+                for (LegacyNode* n = buckets[LegacyHash(id)]; n; n = n->next) {
+                    if (wcscmp(n->entry->videoId, id) == 0) {
+                        found++;
+                        break;
+                    }
+                }
+            }
+            lookupTime = NowSeconds() - start;
+
+            printf("%8d entries  chains: insert %7.1f ns/op  lookup %7.1f ns/op\n",
+                   count, insertTime * 1e9 / count, lookupTime * 1e9 / legacyLookups);
+            free(nodes);
+        }
+    }
+
+    free(entries);
+    free(ids);
+}
+
+int main() {
+    RunBenchmark(1000, TRUE);
+    RunBenchmark(100000, TRUE);
+    RunBenchmark(1000000, TRUE);
+    return 0;
+}
@@ -24,6 +24,7 @@ typedef unsigned char BYTE;
 typedef unsigned short WORD;
 typedef uint32_t DWORD;
 typedef uint64_t DWORDLONG;
+typedef uint64_t ULONGLONG;
 typedef int32_t LONG;
 typedef uint32_t UINT;
 typedef void* HANDLE;
@@ -49,7 +50,7 @@ typedef INT_PTR (CALLBACK *DLGPROC)(HWND, UINT, WPARAM, LPARAM);
 typedef struct { long x; long y; } POINT;
 typedef struct { long left; long top; long right; long bottom; } RECT;
 
-typedef struct { DWORD LowPart; DWORD HighPart; } FILETIME;
+typedef struct { DWORD dwLowDateTime; DWORD dwHighDateTime; } FILETIME;
 
 typedef union _LARGE_INTEGER {
   struct {
@@ -269,6 +270,29 @@ static inline BOOL TerminateProcess(HANDLE h, DWORD code) {
     return TRUE;
 }
 
+// List view notification payloads (only passed through by pointer)
+typedef struct tagLVDISPINFOW NMLVDISPINFOW;
+typedef struct tagNMLVFINDITEMW NMLVFINDITEMW;
+
+static inline LONG InterlockedIncrement(volatile LONG* value) {
+    return __atomic_add_fetch(value, 1, __ATOMIC_SEQ_CST);
+}
+
+static inline LONG InterlockedDecrement(volatile LONG* value) {
+    return __atomic_sub_fetch(value, 1, __ATOMIC_SEQ_CST);
+}
+
+#define MemoryBarrier() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+static inline LONG InterlockedExchange(volatile LONG* target, LONG value) {
+    return __atomic_exchange_n(target, value, __ATOMIC_SEQ_CST);
+}
+
+static inline LONG InterlockedCompareExchange(volatile LONG* target, LONG exchange, LONG comparand) {
+    __atomic_compare_exchange_n(target, &comparand, exchange, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return comparand;
+}
+
 static inline DWORD WaitForSingleObject(HANDLE h, DWORD ms) {
     (void)h; (void)ms;
     return WAIT_OBJECT_0;
@@ -305,6 +329,53 @@ static inline BOOL ReadFile(HANDLE h, LPVOID buf, DWORD bufsz, DWORD* read, LPVO
     return TRUE;
 }
 
+// Overlapped I/O on named pipes
+#define INFINITE 0xFFFFFFFF
+#define WAIT_TIMEOUT 258
+#define WAIT_FAILED 0xFFFFFFFF
+#define ERROR_IO_PENDING 997
+#define ERROR_OPERATION_ABORTED 995
+#define GENERIC_WRITE 0x40000000
+#define FILE_FLAG_OVERLAPPED 0x40000000
+#define FILE_FLAG_FIRST_PIPE_INSTANCE 0x00080000
+#define PIPE_ACCESS_INBOUND 0x00000001
+#define PIPE_TYPE_BYTE 0x00000000
+#define PIPE_READMODE_BYTE 0x00000000
+#define PIPE_WAIT 0x00000000
+
+typedef struct _OVERLAPPED {
+    uintptr_t Internal;
+    uintptr_t InternalHigh;
+    DWORD Offset;
+    DWORD OffsetHigh;
+    HANDLE hEvent;
+} OVERLAPPED, *LPOVERLAPPED;
+
+static inline DWORD GetCurrentProcessId(void) {
+    return 1;
+}
+
+static inline HANDLE CreateNamedPipeW(LPCWSTR name, DWORD openMode, DWORD pipeMode, DWORD instances, DWORD outSize, DWORD inSize, DWORD timeout, LPSECURITY_ATTRIBUTES sa) {
+    (void)name; (void)openMode; (void)pipeMode; (void)instances; (void)outSize; (void)inSize; (void)timeout; (void)sa;
+    return (HANDLE)1;
+}
+
+static inline BOOL GetOverlappedResult(HANDLE h, LPOVERLAPPED overlapped, DWORD* bytes, BOOL wait) {
+    (void)h; (void)overlapped; (void)wait;
+    if (bytes) *bytes = 0;
+    return TRUE;
+}
+
+static inline BOOL CancelIoEx(HANDLE h, LPOVERLAPPED overlapped) {
+    (void)h; (void)overlapped;
+    return TRUE;
+}
+
+static inline DWORD WaitForMultipleObjects(DWORD count, const HANDLE* handles, BOOL waitAll, DWORD ms) {
+    (void)count; (void)handles; (void)waitAll; (void)ms;
+    return WAIT_OBJECT_0;
+}
+
 static inline int MultiByteToWideChar(uint32_t cp, DWORD flags, const char* src, int srclen, wchar_t* dst, int dstlen) {
     (void)cp; (void)flags; (void)src; (void)srclen; (void)dst; (void)dstlen;
     return 0;
@@ -0,0 +1,271 @@
+#ifndef POSTPROCESS_LOGIC_C
+#define POSTPROCESS_LOGIC_C
+#define windows_h
+#define _INC_WINDOWS
+BOOL InitializeEnhancedProgressInfo(EnhancedProgressInfo* progress) {
+    if (!progress) return FALSE;
+
+    memset(progress, 0, sizeof(EnhancedProgressInfo));
+
+    progress->currentState = DOWNLOAD_STATE_INITIALIZING;
+    progress->stateDescription = SAFE_WCSDUP(L"Initializing download process");
+    progress->progressPercentage = 0;
+    progress->statusMessage = SAFE_WCSDUP(L"Starting...");
+
+    // Initialize file tracking arrays
+    progress->maxFiles = 10;
+    progress->trackedFiles = (TrackedFile**)SAFE_MALLOC(progress->maxFiles * sizeof(TrackedFile*));
+    if (!progress->trackedFiles) {
+        FreeEnhancedProgressInfo(progress);
+        return FALSE;
+    }
+
+    // Initialize message tracking arrays
+    progress->maxMessages = 50;
+    progress->preDownloadMessages = (wchar_t**)SAFE_MALLOC(progress->maxMessages * sizeof(wchar_t*));
+    if (!progress->preDownloadMessages) {
+        FreeEnhancedProgressInfo(progress);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+void FreeEnhancedProgressInfo(EnhancedProgressInfo* progress) {
+    if (!progress) return;
+
+    if (progress->stateDescription) SAFE_FREE(progress->stateDescription);
+    if (progress->statusMessage) SAFE_FREE(progress->statusMessage);
+    if (progress->currentOperation) SAFE_FREE(progress->currentOperation);
+    if (progress->videoId) SAFE_FREE(progress->videoId);
+    if (progress->videoTitle) SAFE_FREE(progress->videoTitle);
+    if (progress->videoDuration) SAFE_FREE(progress->videoDuration);
+    if (progress->videoFormat) SAFE_FREE(progress->videoFormat);
+    if (progress->finalVideoFile) SAFE_FREE(progress->finalVideoFile);
+    if (progress->eta) SAFE_FREE(progress->eta);
+    if (progress->errorMessage) SAFE_FREE(progress->errorMessage);
+    if (progress->errorDetails) SAFE_FREE(progress->errorDetails);
+
+    // Free tracked files
+    if (progress->trackedFiles) {
+        for (int i = 0; i < progress->fileCount; i++) {
+            if (progress->trackedFiles[i]) {
+                if (progress->trackedFiles[i]->filePath) SAFE_FREE(progress->trackedFiles[i]->filePath);
+                if (progress->trackedFiles[i]->extension) SAFE_FREE(progress->trackedFiles[i]->extension);
+                SAFE_FREE(progress->trackedFiles[i]);
+            }
+        }
+        SAFE_FREE(progress->trackedFiles);
+    }
+
+    // Free pre-download messages
+    if (progress->preDownloadMessages) {
+        for (int i = 0; i < progress->messageCount; i++) {
+            if (progress->preDownloadMessages[i]) {
+                SAFE_FREE(progress->preDownloadMessages[i]);
+            }
+        }
+        SAFE_FREE(progress->preDownloadMessages);
+    }
+
+    memset(progress, 0, sizeof(EnhancedProgressInfo));
+}
+BOOL AddTrackedFile(EnhancedProgressInfo* progress, const wchar_t* filePath, BOOL isMainVideo) {
+    if (!progress || !filePath) return FALSE;
+
+    // Expand array if needed
+    if (progress->fileCount >= progress->maxFiles) {
+        progress->maxFiles *= 2;
+        TrackedFile** newArray = (TrackedFile**)SAFE_REALLOC(progress->trackedFiles,
+                                                        progress->maxFiles * sizeof(TrackedFile*));
+        if (!newArray) return FALSE;
+        progress->trackedFiles = newArray;
+    }
+
+    // Create new tracked file
+    TrackedFile* file = (TrackedFile*)SAFE_MALLOC(sizeof(TrackedFile));
+    if (!file) return FALSE;
+
+    memset(file, 0, sizeof(TrackedFile));
+    file->filePath = SAFE_WCSDUP(filePath);
+    file->extension = ExtractFileExtension(filePath);
+    file->isMainVideo = isMainVideo;
+    file->isSubtitle = IsSubtitleFileExtension(file->extension);
+    file->isMetadata = (wcsstr(filePath, L".info.json") != NULL);
+    file->isThumbnail = (wcsstr(filePath, L".jpg") != NULL || wcsstr(filePath, L".png") != NULL);
+
+    // Get file creation time if file exists
+    HANDLE hFile = CreateFileW(filePath, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hFile != INVALID_HANDLE_VALUE) {
+        GetFileTime(hFile, &file->creationTime, NULL, NULL);
+
+        LARGE_INTEGER fileSize;
+        if (GetFileSizeEx(hFile, &fileSize)) {
+            file->fileSize = fileSize.LowPart; // Simplified for files < 4GB
+        }
+
+        CloseHandle(hFile);
+    }
+
+    progress->trackedFiles[progress->fileCount++] = file;
+    ThreadSafeDebugOutputF(L"YouTubeCacher: Added tracked file: %ls (main video: %s)", filePath, isMainVideo ? L"yes" : L"no");
+
+    return TRUE;
+}
+BOOL AddPreDownloadMessage(EnhancedProgressInfo* progress, const wchar_t* message) {
+    if (!progress || !message) return FALSE;
+
+    // Expand array if needed
+    if (progress->messageCount >= progress->maxMessages) {
+        progress->maxMessages *= 2;
+        wchar_t** newArray = (wchar_t**)SAFE_REALLOC(progress->preDownloadMessages,
+                                               progress->maxMessages * sizeof(wchar_t*));
+        if (!newArray) return FALSE;
+        progress->preDownloadMessages = newArray;
+    }
+
+    progress->preDownloadMessages[progress->messageCount++] = SAFE_WCSDUP(message);
+    return TRUE;
+}
+void UpdateDownloadState(EnhancedProgressInfo* progress, DownloadState newState, const wchar_t* description) {
+    if (!progress) return;
+
+    if (progress->currentState != newState) {
+        progress->currentState = newState;
+
+        if (progress->stateDescription) SAFE_FREE(progress->stateDescription);
+        progress->stateDescription = description ? SAFE_WCSDUP(description) : NULL;
+        ThreadSafeDebugOutputF(L"YouTubeCacher: Download state changed to: %d (%ls)", newState, description ? description : L"no description");
+
+        // Update the status message to reflect the new state
+        if (progress->statusMessage) SAFE_FREE(progress->statusMessage);
+        progress->statusMessage = description ? SAFE_WCSDUP(description) : NULL;
+    }
+}
+BOOL IsVideoFileExtension(const wchar_t* extension) {
+    if (!extension) return FALSE;
+
+    const wchar_t* videoExts[] = {
+        L".mp4", L".mkv", L".webm", L".avi", L".mov", L".flv",
+        L".m4v", L".3gp", L".wmv", L".mpg", L".mpeg", L".ts", L".m2ts"
+    };
+
+    int numExts = sizeof(videoExts) / sizeof(videoExts[0]);
+    for (int i = 0; i < numExts; i++) {
+        if (wcsicmp(extension, videoExts[i]) == 0) {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+wchar_t* ExtractFileExtension(const wchar_t* fileName) {
+    if (!fileName) return NULL;
+
+    const wchar_t* lastDot = wcsrchr(fileName, L'.');
+    if (lastDot && wcslen(lastDot) > 1) {
+        return SAFE_WCSDUP(lastDot);
+    }
+
+    return NULL;
+}
+BOOL ParseFileDestinationLine(const wchar_t* line, EnhancedProgressInfo* progress) {
+    if (!line || !progress) return FALSE;
+
+    wchar_t* filePath = NULL;
+
+    // Look for various destination patterns
+    if (wcsstr(line, L"Destination: ")) {
+        const wchar_t* start = wcsstr(line, L"Destination: ") + 13;
+        filePath = SAFE_WCSDUP(start);
+    }
+    else if (wcsstr(line, L"[download] ") && wcsstr(line, L" has already been downloaded")) {
+        // Extract filename from "has already been downloaded" message
+        const wchar_t* start = wcsstr(line, L"[download] ") + 11;
+        const wchar_t* end = wcsstr(start, L" has already been downloaded");
+        if (end && end > start) {
+            size_t len = end - start;
+            filePath = (wchar_t*)SAFE_MALLOC((len + 1) * sizeof(wchar_t));
+            if (filePath) {
+                wcsncpy(filePath, start, len);
+                filePath[len] = L'\0';
+            }
+        }
+    }
+    else if (wcsstr(line, L"[download] Downloading video ")) {
+        // Extract from downloading message
+        const wchar_t* start = wcsstr(line, L"[download] Downloading video ") + 29;
+        const wchar_t* end = wcsstr(start, L" of ");
+        if (!end) end = start + wcslen(start);
+        if (end > start) {
+            size_t len = end - start;
+            filePath = (wchar_t*)SAFE_MALLOC((len + 1) * sizeof(wchar_t));
+            if (filePath) {
+                wcsncpy(filePath, start, len);
+                filePath[len] = L'\0';
+            }
+        }
+    }
+
+    if (filePath) {
+        // Clean up the file path (remove quotes, trim whitespace)
+        wchar_t* cleanPath = filePath;
+        while (*cleanPath == L' ' || *cleanPath == L'"') cleanPath++;
+
+        wchar_t* end = cleanPath + wcslen(cleanPath) - 1;
+        while (end > cleanPath && (*end == L' ' || *end == L'"' || *end == L'\n' || *end == L'\r')) {
+            *end = L'\0';
+            end--;
+        }
+
+        if (wcslen(cleanPath) > 0) {
+            wchar_t* extension = ExtractFileExtension(cleanPath);
+            BOOL isMainVideo = IsVideoFileExtension(extension);
+
+            AddTrackedFile(progress, cleanPath, isMainVideo);
+
+            // If this is a video file, it might be our final output
+            if (isMainVideo) {
+                if (progress->finalVideoFile) SAFE_FREE(progress->finalVideoFile);
+                progress->finalVideoFile = SAFE_WCSDUP(cleanPath);
+
+                // Extract video format from extension
+                if (progress->videoFormat) SAFE_FREE(progress->videoFormat);
+                progress->videoFormat = SAFE_WCSDUP(extension ? extension : L"unknown");
+            }
+
+            if (extension) SAFE_FREE(extension);
+        }
+
+        SAFE_FREE(filePath);
+        return TRUE;
+    }
+
+    return FALSE;
+}
+BOOL ParsePostProcessingLine(const wchar_t* line, EnhancedProgressInfo* progress) {
+    if (!line || !progress) return FALSE;
+
+    if (progress->currentOperation) SAFE_FREE(progress->currentOperation);
+
+    if (wcsstr(line, L"[ffmpeg]")) {
+        progress->currentOperation = SAFE_WCSDUP(L"Converting video format");
+    }
+    else if (wcsstr(line, L"Merging formats")) {
+        progress->currentOperation = SAFE_WCSDUP(L"Merging video and audio");
+    }
+    else if (wcsstr(line, L"Correcting container")) {
+        progress->currentOperation = SAFE_WCSDUP(L"Correcting video container");
+    }
+    else {
+        progress->currentOperation = SAFE_WCSDUP(L"Post-processing video");
+    }
+
+    // Look for output file in post-processing messages
+    if (wcsstr(line, L"Destination: ")) {
+        ParseFileDestinationLine(line, progress);
+    }
+
+    return TRUE;
+}
+#endif // POSTPROCESS_LOGIC_C
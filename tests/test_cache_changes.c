@@ -0,0 +1,113 @@
+#include "mock_windows.h"
+
+// Prevent inclusion of the full application header
+#define YOUTUBECACHER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <assert.h>
+
+#include "../cache.h"
+#include "../stringarena.c"
+#include "../cachechanges.c"
+
+void test_push_and_take() {
+    printf("Running cache change queue tests...\n");
+
+    CacheChangeQueue queue;
+    InitCacheChangeQueue(&queue);
+
+    // Only the first event of a batch asks for a notification
+    wchar_t id[] = L"aaaaaaaaaaa";
+    assert(PushCacheChange(&queue, id, CACHE_CHANGE_ADDED));
+    assert(!PushCacheChange(&queue, L"bbbbbbbbbbb", CACHE_CHANGE_SIZE));
+    assert(!PushCacheChange(&queue, NULL, CACHE_CHANGE_SIZE));
+    assert(queue.count == 2);
+
+    // Events hold their own copy of the video ID
+    id[0] = L'z';
+    assert(wcscmp(queue.changes[0].videoId, L"aaaaaaaaaaa") == 0);
+
+    // Taking the batch leaves the queue idle, so the next event notifies again
+    CacheChangeQueue taken;
+    TakeCacheChanges(&queue, &taken);
+    assert(taken.count == 2 && queue.count == 0 && !queue.overflowed);
+    assert(GetCacheChangeTypes(&taken) == (CACHE_CHANGE_ADDED | CACHE_CHANGE_SIZE));
+    assert(PushCacheChange(&queue, L"ccccccccccc", CACHE_CHANGE_REMOVED));
+
+    FreeCacheChangeQueue(&taken);
+    FreeCacheChangeQueue(&queue);
+    assert(queue.changes == NULL && queue.count == 0);
+
+    printf("All cache change queue tests passed!\n");
+}
+
+void test_coalesce() {
+    printf("Running cache change coalescing tests...\n");
+
+    CacheChangeQueue queue;
+    InitCacheChangeQueue(&queue);
+
+    PushCacheChange(&queue, L"ccc", CACHE_CHANGE_SIZE);
+    PushCacheChange(&queue, L"aaa", CACHE_CHANGE_ADDED);
+    PushCacheChange(&queue, L"ccc", CACHE_CHANGE_SIZE);
+    PushCacheChange(&queue, L"bbb", CACHE_CHANGE_REMOVED);
+    PushCacheChange(&queue, L"aaa", CACHE_CHANGE_METADATA);
+    PushCacheChange(&queue, L"ccc", CACHE_CHANGE_REMOVED);
+
+    // One event per ID, sorted by ID, with the types merged
+    assert(CoalesceCacheChanges(&queue) == 3);
+    assert(wcscmp(queue.changes[0].videoId, L"aaa") == 0);
+    assert(queue.changes[0].types == (CACHE_CHANGE_ADDED | CACHE_CHANGE_METADATA));
+    assert(wcscmp(queue.changes[1].videoId, L"bbb") == 0);
+    assert(queue.changes[1].types == CACHE_CHANGE_REMOVED);
+    assert(wcscmp(queue.changes[2].videoId, L"ccc") == 0);
+    assert(queue.changes[2].types == (CACHE_CHANGE_SIZE | CACHE_CHANGE_REMOVED));
+
+    // Coalescing again changes nothing
+    assert(CoalesceCacheChanges(&queue) == 3);
+
+    FreeCacheChangeQueue(&queue);
+    assert(CoalesceCacheChanges(&queue) == 0);
+
+    printf("All cache change coalescing tests passed!\n");
+}
+
+void test_overflow() {
+    printf("Running cache change overflow tests...\n");
+
+    CacheChangeQueue queue;
+    InitCacheChangeQueue(&queue);
+
+    wchar_t id[16];
+    for (int i = 0; i < CACHE_CHANGE_QUEUE_LIMIT; i++) {
+        swprintf(id, 16, L"id%05d", i);
+        assert(PushCacheChange(&queue, id, CACHE_CHANGE_SIZE) == (i == 0));
+    }
+    assert(queue.count == CACHE_CHANGE_QUEUE_LIMIT && !queue.overflowed);
+
+    // Past the limit the queue drops its events and only reports the overflow
+    assert(!PushCacheChange(&queue, L"one too many", CACHE_CHANGE_SIZE));
+    assert(queue.overflowed && queue.count == 0);
+    assert(!PushCacheChange(&queue, L"ignored", CACHE_CHANGE_ADDED));
+    assert(queue.count == 0);
+
+    // The overflow is handed to the listener with the batch
+    CacheChangeQueue taken;
+    TakeCacheChanges(&queue, &taken);
+    assert(taken.overflowed && !queue.overflowed);
+    FreeCacheChangeQueue(&taken);
+
+    FreeCacheChangeQueue(&queue);
+
+    printf("All cache change overflow tests passed!\n");
+}
+
+int main() {
+    test_push_and_take();
+    test_coalesce();
+    test_overflow();
+    return 0;
+}
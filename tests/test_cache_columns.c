@@ -0,0 +1,142 @@
+#include "mock_windows.h"
+
+// Prevent inclusion of the full application header
+#define YOUTUBECACHER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <wctype.h>
+#include <assert.h>
+
+#include "../cache.h"
+#include "cache_duration.c"
+#include "../cachecolumns.c"
+
+static void InitEntry(CacheEntry* entry, wchar_t* id, wchar_t* title, wchar_t* duration, ULONGLONG size) {
+    memset(entry, 0, sizeof(CacheEntry));
+    entry->videoId = id;
+    entry->title = title;
+    entry->duration = duration;
+    entry->mainVideoFile = L"C:\\v\\file.mp4";
+    entry->fileSize = size;
+    entry->downloadTime.dwLowDateTime = 0x89ABCDEF;
+    entry->downloadTime.dwHighDateTime = 0x01234567;
+}
+
+void test_rows() {
+    printf("Running cache column row tests...\n");
+
+    CacheColumns columns;
+    assert(InitCacheColumns(&columns, 0));
+    assert(columns.capacity == CACHE_COLUMNS_MIN_CAPACITY && columns.count == 0);
+
+    CacheEntry a, b, c;
+    InitEntry(&a, L"aaaaaaaaaaa", L"Alpha", L"1:02:03", 5ULL * 1024 * 1024 * 1024); // Over 4 GB
+    InitEntry(&b, L"bbbbbbbbbbb", L"beta", L"4:05", 100);
+    InitEntry(&c, L"ccccccccccc", NULL, NULL, 7);
+
+    assert(AppendCacheColumnsRow(&columns, &a));
+    assert(AppendCacheColumnsRow(&columns, &b));
+    assert(AppendCacheColumnsRow(&columns, &c));
+    assert(columns.count == 3);
+    assert(a.row == 0 && b.row == 1 && c.row == 2);
+    assert(columns.owner[1] == &b);
+
+    assert(columns.fileSize[a.row] == 5ULL * 1024 * 1024 * 1024);
+    assert(columns.durationSeconds[a.row] == 3723);
+    assert(columns.durationSeconds[b.row] == 245);
+    assert(columns.durationSeconds[c.row] == 0);
+    assert(columns.downloadTime[a.row] == 0x0123456789ABCDEFULL);
+    assert(SumCacheColumnsFileSize(&columns) == 5ULL * 1024 * 1024 * 1024 + 107);
+
+    // Removing a middle row moves the last row into it
+    RemoveCacheColumnsRow(&columns, &b);
+    assert(columns.count == 2);
+    assert(c.row == 1 && columns.owner[1] == &c);
+    assert(columns.fileSize[c.row] == 7);
+
+    // Removing an entry that is not in the columns is ignored
+    RemoveCacheColumnsRow(&columns, &b);
+    assert(columns.count == 2);
+
+    // In-place updates refresh the row
+    c.fileSize = 9;
+    c.duration = L"0:30";
+    UpdateCacheColumnsRow(&columns, &c);
+    assert(columns.fileSize[c.row] == 9);
+    assert(columns.durationSeconds[c.row] == 30);
+
+    // Growth keeps rows intact
+    CacheEntry* many = (CacheEntry*)malloc(1000 * sizeof(CacheEntry));
+    for (int i = 0; i < 1000; i++) {
+        InitEntry(&many[i], L"xxxxxxxxxxx", L"Bulk", L"1:00", (ULONGLONG)i);
+        assert(AppendCacheColumnsRow(&columns, &many[i]));
+    }
+    assert(columns.count == 1002 && columns.capacity >= 1002);
+    assert(columns.owner[a.row] == &a && columns.fileSize[a.row] == 5ULL * 1024 * 1024 * 1024);
+    assert(columns.owner[many[999].row] == &many[999] && columns.fileSize[many[999].row] == 999);
+
+    ClearCacheColumns(&columns);
+    assert(columns.count == 0 && SumCacheColumnsFileSize(&columns) == 0);
+
+    free(many);
+    FreeCacheColumns(&columns);
+    assert(columns.owner == NULL && columns.capacity == 0);
+
+    printf("All cache column row tests passed!\n");
+}
+
+void test_compare() {
+    printf("Running cache column comparison tests...\n");
+
+    // Title keys order like the case-insensitive comparison of the prefix
+    assert(MakeTitleSortKey(L"abc") < MakeTitleSortKey(L"abd"));
+    assert(MakeTitleSortKey(L"ABC") == MakeTitleSortKey(L"abc"));
+    assert(MakeTitleSortKey(L"ab") < MakeTitleSortKey(L"abc"));
+    assert(MakeTitleSortKey(NULL) == 0 && MakeTitleSortKey(L"") == 0);
+
+    CacheColumns columns;
+    assert(InitCacheColumns(&columns, 8));
+
+    CacheEntry e[6];
+    InitEntry(&e[0], L"id0", L"Zebra", L"10:00", 10);
+    InitEntry(&e[1], L"id1", L"apple pie", L"2:00", 5ULL * 1024 * 1024 * 1024);
+    InitEntry(&e[2], L"id2", L"Apple Crumble", L"1:00:00", 3);
+    InitEntry(&e[3], L"id3", NULL, L"9:00", 3);
+    InitEntry(&e[4], L"id4", L"", L"bogus", 0);
+    InitEntry(&e[5], L"id5", L"APPLE PIE", L"2:00", 1);
+    for (int i = 0; i < 6; i++) {
+        assert(AppendCacheColumnsRow(&columns, &e[i]));
+    }
+
+    // Title: equal prefixes fall back to the full case-insensitive comparison
+    assert(CompareCacheColumnsRows(&columns, e[2].row, e[1].row, CACHE_COLUMN_TITLE) < 0);
+    assert(CompareCacheColumnsRows(&columns, e[1].row, e[0].row, CACHE_COLUMN_TITLE) < 0);
+    assert(CompareCacheColumnsRows(&columns, e[1].row, e[5].row, CACHE_COLUMN_TITLE) == 0);
+    assert(CompareCacheColumnsRows(&columns, e[3].row, e[4].row, CACHE_COLUMN_TITLE) < 0);
+    assert(CompareCacheColumnsRows(&columns, e[4].row, e[2].row, CACHE_COLUMN_TITLE) < 0);
+    assert(CompareCacheColumnsRows(&columns, e[3].row, e[3].row, CACHE_COLUMN_TITLE) == 0);
+
+    // Duration compares parsed seconds, not strings
+    assert(CompareCacheColumnsRows(&columns, e[1].row, e[0].row, CACHE_COLUMN_DURATION) < 0);
+    assert(CompareCacheColumnsRows(&columns, e[2].row, e[0].row, CACHE_COLUMN_DURATION) > 0);
+    assert(CompareCacheColumnsRows(&columns, e[4].row, e[1].row, CACHE_COLUMN_DURATION) < 0);
+    assert(CompareCacheColumnsRows(&columns, e[1].row, e[5].row, CACHE_COLUMN_DURATION) == 0);
+
+    // Size compares full 64-bit values
+    assert(CompareCacheColumnsRows(&columns, e[0].row, e[1].row, CACHE_COLUMN_SIZE) < 0);
+    assert(CompareCacheColumnsRows(&columns, e[1].row, e[0].row, CACHE_COLUMN_SIZE) > 0);
+    assert(CompareCacheColumnsRows(&columns, e[2].row, e[3].row, CACHE_COLUMN_SIZE) == 0);
+
+    FreeCacheColumns(&columns);
+
+    printf("All cache column comparison tests passed!\n");
+}
+
+int main() {
+    test_rows();
+    test_compare();
+    return 0;
+}
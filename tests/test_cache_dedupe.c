@@ -0,0 +1,197 @@
+#include "mock_windows.h"
+
+// Prevent inclusion of the full application header
+#define YOUTUBECACHER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <assert.h>
+
+#include "../cachededupe.h"
+#include "../cachededupe.c"
+
+static CacheDedupeFile MakeFile(const wchar_t* videoId, ULONGLONG size, ULONGLONG sampleHash, ULONGLONG contentHash) {
+    CacheDedupeFile file;
+    memset(&file, 0, sizeof(file));
+    file.videoId = wcsdup(videoId);
+    file.title = NULL;
+    file.filePath = wcsdup(videoId);
+    file.size = size;
+    file.sampleHash = sampleHash;
+    file.contentHash = contentHash;
+    return file;
+}
+
+static const CacheDedupeFile* Find(const CacheDedupeFile* files, DWORD count, const wchar_t* videoId) {
+    for (DWORD i = 0; i < count; i++) {
+        if (wcscmp(files[i].videoId, videoId) == 0) return &files[i];
+    }
+    assert(!"file not found");
+    return NULL;
+}
+
+void test_hash() {
+    printf("Running dedupe hash tests...\n");
+
+    // FNV-1a 64 reference values
+    assert(HashCacheDedupeData(CACHE_DEDUPE_HASH_SEED, (const BYTE*)"", 0) == 0xcbf29ce484222325ull);
+    assert(HashCacheDedupeData(CACHE_DEDUPE_HASH_SEED, (const BYTE*)"a", 1) == 0xaf63dc4c8601ec8cull);
+
+    // Hashing in pieces gives the same result as hashing at once
+    const BYTE* text = (const BYTE*)"The quick brown fox jumps over the lazy dog";
+    ULONGLONG whole = HashCacheDedupeData(CACHE_DEDUPE_HASH_SEED, text, 43);
+    ULONGLONG split = HashCacheDedupeData(HashCacheDedupeData(CACHE_DEDUPE_HASH_SEED, text, 10), text + 10, 33);
+    assert(whole == split);
+
+    printf("All dedupe hash tests passed!\n");
+}
+
+void test_sample_offsets() {
+    printf("Running dedupe sample offset tests...\n");
+
+    ULONGLONG offsets[3];
+
+    // Up to three blocks the sample is the whole file
+    assert(GetCacheDedupeSampleOffsets(0, offsets) == 0);
+    assert(GetCacheDedupeSampleOffsets(3 * CACHE_DEDUPE_SAMPLE_BLOCK, offsets) == 0);
+
+    // Head, a block-aligned middle and the tail, all inside the file and not overlapping
+    ULONGLONG sizes[] = { 3 * CACHE_DEDUPE_SAMPLE_BLOCK + 1, 10ull * 1024 * 1024 + 12345, 5000000000ull };
+    for (int i = 0; i < 3; i++) {
+        assert(GetCacheDedupeSampleOffsets(sizes[i], offsets) == 3);
+        assert(offsets[0] == 0);
+        assert(offsets[1] % CACHE_DEDUPE_SAMPLE_BLOCK == 0);
+        assert(offsets[1] >= CACHE_DEDUPE_SAMPLE_BLOCK);
+        assert(offsets[1] + CACHE_DEDUPE_SAMPLE_BLOCK <= offsets[2]);
+        assert(offsets[2] + CACHE_DEDUPE_SAMPLE_BLOCK == sizes[i]);
+    }
+
+    printf("All dedupe sample offset tests passed!\n");
+}
+
+void test_grouping() {
+    printf("Running dedupe grouping tests...\n");
+
+    CacheDedupeFile files[] = {
+        MakeFile(L"unique", 500, 0, 0),
+        MakeFile(L"a1", 1000, 11, 111),
+        MakeFile(L"b1", 2000, 0, 0),
+        MakeFile(L"a2", 1000, 11, 111),
+        MakeFile(L"c1", 1000, 12, 0),     // Same size as a1, different sample
+        MakeFile(L"a3", 1000, 11, 112),   // Same sample as a1, different content
+        MakeFile(L"b2", 2000, 0, 0),      // Hashes unknown
+        MakeFile(L"empty1", 0, 0, 0),
+        MakeFile(L"empty2", 0, 0, 0),
+    };
+    DWORD count = sizeof(files) / sizeof(files[0]);
+
+    // By size: every size shared by two non-empty files
+    assert(GroupCacheDedupeFiles(files, count, CACHE_DEDUPE_BY_SIZE) == 6);
+    assert(Find(files, count, L"unique")->group == 0);
+    assert(Find(files, count, L"empty1")->group == 0);
+    assert(Find(files, count, L"a1")->group == Find(files, count, L"c1")->group);
+    assert(Find(files, count, L"b1")->group != 0 && Find(files, count, L"b1")->group != Find(files, count, L"a1")->group);
+
+    // Candidates of one group are adjacent
+    for (DWORD i = 0; i < count; i++) {
+        for (DWORD j = i + 1; j < count; j++) {
+            if (files[i].group == 0 || files[j].group != files[i].group) continue;
+            for (DWORD k = i; k < j; k++) assert(files[k].group == files[i].group);
+        }
+    }
+
+    // By sample: a different sample or an unknown one drops out
+    assert(GroupCacheDedupeFiles(files, count, CACHE_DEDUPE_BY_SAMPLE) == 3);
+    assert(Find(files, count, L"c1")->group == 0);
+    assert(Find(files, count, L"b1")->group == 0);
+    assert(Find(files, count, L"a3")->group == Find(files, count, L"a1")->group);
+
+    // By content: only the true copies are left
+    assert(GroupCacheDedupeFiles(files, count, CACHE_DEDUPE_BY_CONTENT) == 2);
+    assert(Find(files, count, L"a1")->group != 0);
+    assert(Find(files, count, L"a1")->group == Find(files, count, L"a2")->group);
+    assert(Find(files, count, L"a3")->group == 0);
+
+    for (DWORD i = 0; i < count; i++) {
+        free(files[i].videoId);
+        free(files[i].filePath);
+    }
+
+    printf("All dedupe grouping tests passed!\n");
+}
+
+void test_hard_links() {
+    printf("Running dedupe hard link tests...\n");
+
+    CacheDedupeReport* report = (CacheDedupeReport*)calloc(1, sizeof(CacheDedupeReport));
+    assert(report);
+    report->count = 5;
+    report->files = (CacheDedupeFile*)malloc(report->count * sizeof(CacheDedupeFile));
+    assert(report->files);
+
+    // x1 and x2 are two names of one file, x3 a real copy; y1 and y2 are one file only
+    report->files[0] = MakeFile(L"x1", 4096, 7, 77);
+    report->files[1] = MakeFile(L"x2", 4096, 7, 77);
+    report->files[2] = MakeFile(L"x3", 4096, 7, 77);
+    report->files[3] = MakeFile(L"y1", 8192, 8, 88);
+    report->files[4] = MakeFile(L"y2", 8192, 8, 88);
+    report->files[0].volumeSerial = report->files[1].volumeSerial = 1;
+    report->files[0].fileIndex = report->files[1].fileIndex = 500;
+    report->files[2].volumeSerial = 1;
+    report->files[2].fileIndex = 501;
+    report->files[3].volumeSerial = report->files[4].volumeSerial = 2;
+    report->files[3].fileIndex = report->files[4].fileIndex = 600;
+
+    assert(GroupCacheDedupeFiles(report->files, report->count, CACHE_DEDUPE_BY_CONTENT) == 3);
+    assert(Find(report->files, report->count, L"y1")->group == 0);
+
+    // Links of one file sort together
+    const CacheDedupeFile* x1 = Find(report->files, report->count, L"x1");
+    const CacheDedupeFile* x2 = Find(report->files, report->count, L"x2");
+    assert(x2 == x1 + 1 || x1 == x2 + 1);
+
+    SummarizeCacheDedupeReport(report);
+    assert(report->groupCount == 1);
+    assert(report->duplicateCount == 1);
+    assert(report->duplicateBytes == 4096);
+
+    // Same index on another volume is another file
+    report->files[3].volumeSerial = 3;
+    assert(GroupCacheDedupeFiles(report->files, report->count, CACHE_DEDUPE_BY_CONTENT) == 5);
+    SummarizeCacheDedupeReport(report);
+    assert(report->groupCount == 2);
+    assert(report->duplicateCount == 2);
+    assert(report->duplicateBytes == 4096 + 8192);
+
+    FreeCacheDedupeReport(report);
+
+    printf("All dedupe hard link tests passed!\n");
+}
+
+void test_throttle() {
+    printf("Running dedupe throttle tests...\n");
+
+    // 1 MB/s: 1 MB after 1 s is on budget, after 0.5 s half a second early
+    assert(GetCacheDedupeThrottleDelay(1024 * 1024, 1000, 1024 * 1024) == 0);
+    assert(GetCacheDedupeThrottleDelay(1024 * 1024, 500, 1024 * 1024) == 500);
+    assert(GetCacheDedupeThrottleDelay(1024 * 1024, 2000, 1024 * 1024) == 0);
+
+    // Pauses are capped so shutdown is never held up for long
+    assert(GetCacheDedupeThrottleDelay(100ull * 1024 * 1024, 0, 1024 * 1024) == 1000);
+
+    // No budget, no pauses
+    assert(GetCacheDedupeThrottleDelay(100ull * 1024 * 1024, 0, 0) == 0);
+
+    printf("All dedupe throttle tests passed!\n");
+}
+
+int main() {
+    test_hash();
+    test_sample_offsets();
+    test_grouping();
+    test_hard_links();
+    test_throttle();
+    return 0;
+}
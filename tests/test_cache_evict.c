@@ -0,0 +1,150 @@
+#include "mock_windows.h"
+
+// Prevent inclusion of the full application header
+#define YOUTUBECACHER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <wctype.h>
+#include <assert.h>
+
+#include "../cache.h"
+#include "cache_duration.c"
+#include "../cachecolumns.c"
+#include "../cachestats.c"
+#include "../cacheevict.c"
+
+#define MB (1024ull * 1024ull)
+#define HOUR (60ull * 60ull * 10000000ull)
+#define NOW (1000ull * HOUR)
+
+static void InitEntry(CacheEntry* entry, const wchar_t* id, ULONGLONG size, ULONGLONG lastAccess, DWORD accesses) {
+    memset(entry, 0, sizeof(CacheEntry));
+    entry->videoId = (wchar_t*)id;
+    entry->mainVideoFile = L"C:\\v\\file.mp4";
+    entry->fileSize = size;
+    entry->lastAccessTime = lastAccess;
+    entry->accessCount = accesses;
+}
+
+// Select victims and return their video IDs in eviction order, joined by spaces
+static const wchar_t* Select(const CacheColumns* columns, ULONGLONG limit, int policy) {
+    static wchar_t result[256];
+    result[0] = L'\0';
+
+    // The root's share of the cache, as the running totals count it
+    ULONGLONG rootBytes = 0;
+    for (DWORD row = 0; row < columns->count; row++) {
+        if (IsCacheRootPath(L"C:\\v", columns->owner[row]->mainVideoFile)) rootBytes += columns->fileSize[row];
+    }
+
+    CacheBudget budget = { limit, policy };
+    CacheEntry** victims = NULL;
+    DWORD count = SelectCacheEvictionVictims(columns, &budget, L"C:\\v", rootBytes, NOW, &victims);
+    assert((count == 0) == (victims == NULL));
+    for (DWORD i = 0; i < count; i++) {
+        if (i > 0) wcscat(result, L" ");
+        wcscat(result, victims[i]->videoId);
+    }
+    free(victims);
+    return result;
+}
+
+void test_budget_setting() {
+    printf("Running cache budget setting tests...\n");
+
+    CacheBudget budget;
+    assert(ParseCacheBudget(L"53687091200,lfu", &budget));
+    assert(budget.limitBytes == 53687091200ull && budget.policy == CACHE_EVICT_LFU);
+    assert(ParseCacheBudget(L"1000,SIZE", &budget));
+    assert(budget.limitBytes == 1000 && budget.policy == CACHE_EVICT_SIZE);
+
+    // A missing or unknown policy falls back to LRU
+    assert(ParseCacheBudget(L"5", &budget));
+    assert(budget.limitBytes == 5 && budget.policy == CACHE_EVICT_LRU);
+    assert(ParseCacheBudget(L"5,fifo", &budget));
+    assert(budget.policy == CACHE_EVICT_LRU);
+
+    assert(!ParseCacheBudget(L"", &budget));
+    assert(!ParseCacheBudget(L"lots,lru", &budget));
+    assert(!ParseCacheBudget(L"12GB", &budget));
+    assert(!ParseCacheBudget(NULL, &budget));
+
+    // Formatting round-trips
+    wchar_t text[64];
+    CacheBudget original = { 123456789012ull, CACHE_EVICT_SIZE };
+    FormatCacheBudget(&original, text, 64);
+    assert(wcscmp(text, L"123456789012,size") == 0);
+    assert(ParseCacheBudget(text, &budget));
+    assert(budget.limitBytes == original.limitBytes && budget.policy == original.policy);
+
+    printf("All cache budget setting tests passed!\n");
+}
+
+void test_victim_selection() {
+    printf("Running cache eviction policy tests...\n");
+
+    CacheEntry entries[5];
+    InitEntry(&entries[0], L"old", 100 * MB, NOW - 48 * HOUR, 10);    // Old but popular
+    InitEntry(&entries[1], L"stale", 10 * MB, NOW - 24 * HOUR, 1);    // Small, played once
+    InitEntry(&entries[2], L"big", 400 * MB, NOW - 12 * HOUR, 2);     // Large, played twice
+    InitEntry(&entries[3], L"fresh", 50 * MB, NOW - 1 * HOUR, 3);     // Recent
+    InitEntry(&entries[4], L"new", 200 * MB, NOW - 60 * 10000000ull, 1); // Downloaded a minute ago
+
+    CacheColumns columns;
+    assert(InitCacheColumns(&columns, 0));
+    for (int i = 0; i < 5; i++) {
+        assert(AppendCacheColumnsRow(&columns, &entries[i]));
+    }
+    // 760 MB in total
+
+    // Under budget, or no budget at all: nothing to do
+    assert(wcscmp(Select(&columns, 1000 * MB, CACHE_EVICT_LRU), L"") == 0);
+    assert(wcscmp(Select(&columns, 760 * MB, CACHE_EVICT_LRU), L"") == 0);
+    assert(wcscmp(Select(&columns, 0, CACHE_EVICT_LRU), L"") == 0);
+
+    // Only as many victims as it takes to get back under the limit
+    assert(wcscmp(Select(&columns, 700 * MB, CACHE_EVICT_LRU), L"old") == 0);
+    assert(wcscmp(Select(&columns, 600 * MB, CACHE_EVICT_LRU), L"old stale big") == 0);
+
+    // LFU takes the fewest accesses first, the older of equals first
+    assert(wcscmp(Select(&columns, 750 * MB, CACHE_EVICT_LFU), L"stale") == 0);
+    assert(wcscmp(Select(&columns, 600 * MB, CACHE_EVICT_LFU), L"stale big") == 0);
+
+    // Size-aware frees the most space for the least use
+    assert(wcscmp(Select(&columns, 700 * MB, CACHE_EVICT_SIZE), L"big") == 0);
+
+    // Entries in their grace period are never chosen, even if the budget cannot be met
+    assert(wcscmp(Select(&columns, 1 * MB, CACHE_EVICT_LRU), L"old stale big fresh") == 0);
+
+    // Entries without access stats date from their download and count as used once
+    entries[4].lastAccessTime = 0;
+    entries[4].accessCount = 0;
+    entries[4].downloadTime.dwHighDateTime = (DWORD)((NOW - 72 * HOUR) >> 32);
+    entries[4].downloadTime.dwLowDateTime = (DWORD)(NOW - 72 * HOUR);
+    UpdateCacheColumnsRow(&columns, &entries[4]);
+    assert(wcscmp(Select(&columns, 700 * MB, CACHE_EVICT_LRU), L"new") == 0);
+    assert(wcscmp(Select(&columns, 750 * MB, CACHE_EVICT_LFU), L"new") == 0);
+
+    // Missing files free nothing and are skipped
+    entries[4].fileSize = 0;
+    UpdateCacheColumnsRow(&columns, &entries[4]);
+    assert(wcscmp(Select(&columns, 500 * MB, CACHE_EVICT_LRU), L"old") == 0);
+
+    // Files outside the download root are never chosen, and do not count against its budget
+    entries[0].mainVideoFile = L"D:\\elsewhere\\file.mp4";
+    assert(wcscmp(Select(&columns, 500 * MB, CACHE_EVICT_LRU), L"") == 0);
+    assert(wcscmp(Select(&columns, 400 * MB, CACHE_EVICT_LRU), L"stale big") == 0);
+
+    FreeCacheColumns(&columns);
+
+    printf("All cache eviction policy tests passed!\n");
+}
+
+int main() {
+    test_budget_setting();
+    test_victim_selection();
+    return 0;
+}
@@ -0,0 +1,301 @@
+#include "mock_windows.h"
+
+// Prevent inclusion of the full application header
+#define YOUTUBECACHER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <assert.h>
+
+#include "../cache.h"
+#include "../cacheindex.h"
+#include "../cacheindex.c"
+
+static void InitEntry(CacheEntry* entry, wchar_t* id, wchar_t* title, wchar_t* duration,
+                      wchar_t* file, wchar_t** subs, int subCount, DWORD size) {
+    memset(entry, 0, sizeof(CacheEntry));
+    entry->videoId = id;
+    entry->title = title;
+    entry->duration = duration;
+    entry->mainVideoFile = file;
+    entry->subtitleFiles = subs;
+    entry->subtitleCount = subCount;
+    entry->fileSize = size;
+    entry->downloadTime.dwLowDateTime = 0x1234;
+    entry->downloadTime.dwHighDateTime = 0x5678;
+}
+
+void test_round_trip() {
+    printf("Running cache index round-trip tests...\n");
+
+    wchar_t* subsA[] = { L"C:\\v\\a.en.vtt", L"C:\\v\\a.de.vtt" };
+    CacheEntry a, b, c;
+    InitEntry(&a, L"dQw4w9WgXcQ", L"First video", L"3:32", L"C:\\v\\a.mp4", subsA, 2, 1000);
+    InitEntry(&b, L"abcdefghijk", L"Second video", NULL, L"C:\\v\\b.webm", NULL, 0, 2000);
+    InitEntry(&c, L"zyxwvutsrqp", NULL, L"1:00:00", L"C:\\v\\c.mkv", NULL, 0, 0);
+    a.lastAccessTime = 0x0123456789ABCDEFull;
+    a.accessCount = 7;
+    b.hashWriteTime = 0x1111222233334444ull;
+    b.sampleHash = 0xAAAABBBBCCCCDDDDull;
+    b.contentHash = 0x0123012301230123ull;
+    b.verifyTime = 0x5555666677778888ull;
+    b.damaged = TRUE;
+    c.fileMissing = TRUE;
+
+    CacheEntry* entries[] = { &a, &b, &c };
+    CacheIndexImage image;
+    assert(BuildCacheIndexImage(entries, 3, 7, &image));
+    assert(image.data != NULL && image.size > sizeof(CacheIndexHeader));
+
+    CacheIndexReader reader;
+    assert(OpenCacheIndexImage(image.data, image.size, &reader));
+    assert(GetCacheIndexEntryCount(&reader) == 3);
+    assert(GetCacheIndexGeneration(&reader) == 7);
+
+    CacheIndexRecord record;
+    assert(ReadCacheIndexRecord(&reader, 0, &record));
+    assert(wcscmp(GetCacheIndexString(&reader, record.videoId), L"dQw4w9WgXcQ") == 0);
+    assert(wcscmp(GetCacheIndexString(&reader, record.title), L"First video") == 0);
+    assert(wcscmp(GetCacheIndexString(&reader, record.duration), L"3:32") == 0);
+    assert(wcscmp(GetCacheIndexString(&reader, record.mainVideoFile), L"C:\\v\\a.mp4") == 0);
+    assert(record.subtitleCount == 2);
+    assert(wcscmp(GetCacheIndexSubtitle(&reader, &record, 0), L"C:\\v\\a.en.vtt") == 0);
+    assert(wcscmp(GetCacheIndexSubtitle(&reader, &record, 1), L"C:\\v\\a.de.vtt") == 0);
+    assert(GetCacheIndexSubtitle(&reader, &record, 2) == NULL);
+    assert(record.fileSize == 1000);
+    assert(record.downloadTime.dwLowDateTime == 0x1234 && record.downloadTime.dwHighDateTime == 0x5678);
+    assert(record.lastAccessTime == 0x0123456789ABCDEFull && record.accessCount == 7);
+
+    assert(ReadCacheIndexRecord(&reader, 1, &record));
+    assert(wcscmp(GetCacheIndexString(&reader, record.videoId), L"abcdefghijk") == 0);
+    assert(GetCacheIndexString(&reader, record.duration) == NULL);
+    assert(record.subtitleCount == 0);
+    assert(record.hashWriteTime == 0x1111222233334444ull);
+    assert(record.sampleHash == 0xAAAABBBBCCCCDDDDull && record.contentHash == 0x0123012301230123ull);
+    assert(record.verifyTime == 0x5555666677778888ull && record.flags == CACHE_INDEX_FLAG_DAMAGED);
+
+    assert(ReadCacheIndexRecord(&reader, 2, &record));
+    assert(GetCacheIndexString(&reader, record.title) == NULL);
+    assert(wcscmp(GetCacheIndexString(&reader, record.duration), L"1:00:00") == 0);
+    assert(record.flags == CACHE_INDEX_FLAG_MISSING);
+
+    assert(!ReadCacheIndexRecord(&reader, 3, &record));
+    assert(GetCacheIndexString(&reader, reader.stringChars) == NULL);
+
+    FreeCacheIndexImage(&image);
+    assert(image.data == NULL && image.size == 0);
+
+    // An empty cache still produces a valid index
+    assert(BuildCacheIndexImage(NULL, 0, 1, &image));
+    assert(OpenCacheIndexImage(image.data, image.size, &reader));
+    assert(GetCacheIndexEntryCount(&reader) == 0);
+    FreeCacheIndexImage(&image);
+
+    printf("All cache index round-trip tests passed!\n");
+}
+
+void test_corruption_rejected() {
+    printf("Running cache index validation tests...\n");
+
+    CacheEntry a;
+    InitEntry(&a, L"dQw4w9WgXcQ", L"Title", L"3:32", L"C:\\v\\a.mp4", NULL, 0, 1);
+    CacheEntry* entries[] = { &a };
+    CacheIndexImage image;
+    CacheIndexReader reader;
+    assert(BuildCacheIndexImage(entries, 1, 1, &image));
+
+    BYTE* copy = (BYTE*)malloc(image.size);
+
+    // Truncated file
+    assert(!OpenCacheIndexImage(image.data, sizeof(CacheIndexHeader) - 1, &reader));
+    assert(!OpenCacheIndexImage(image.data, image.size - sizeof(wchar_t), &reader));
+
+    // Bad magic
+    memcpy(copy, image.data, image.size);
+    ((CacheIndexHeader*)copy)->magic ^= 1;
+    assert(!OpenCacheIndexImage(copy, image.size, &reader));
+
+    // Header modified without updating the checksum
+    memcpy(copy, image.data, image.size);
+    ((CacheIndexHeader*)copy)->entryCount = 1000;
+    assert(!OpenCacheIndexImage(copy, image.size, &reader));
+
+    // Version 5 header cut back to the version 4 size
+    memcpy(copy, image.data, image.size);
+    ((CacheIndexHeader*)copy)->headerSize = CACHE_INDEX_HEADER_V4_SIZE;
+    ((CacheIndexHeader*)copy)->headerChecksum = ComputeCacheIndexHeaderChecksum((CacheIndexHeader*)copy);
+    assert(!OpenCacheIndexImage(copy, image.size, &reader));
+
+    // Future version
+    memcpy(copy, image.data, image.size);
+    ((CacheIndexHeader*)copy)->version = CACHE_INDEX_VERSION + 1;
+    assert(!OpenCacheIndexImage(copy, image.size, &reader));
+
+    // Unterminated string table
+    memcpy(copy, image.data, image.size);
+    ((wchar_t*)(copy + image.size))[-1] = L'x';
+    assert(!OpenCacheIndexImage(copy, image.size, &reader));
+
+    // Out-of-range string offsets resolve to NULL instead of reading past the table
+    memcpy(copy, image.data, image.size);
+    assert(OpenCacheIndexImage(copy, image.size, &reader));
+    CacheIndexRecord* record = (CacheIndexRecord*)(copy + reader.header->recordsOffset);
+    record->title = 0x7FFFFFFF;
+    CacheIndexRecord readBack;
+    assert(ReadCacheIndexRecord(&reader, 0, &readBack));
+    assert(GetCacheIndexString(&reader, readBack.title) == NULL);
+
+    free(copy);
+    FreeCacheIndexImage(&image);
+
+    printf("All cache index validation tests passed!\n");
+}
+
+void test_journal() {
+    printf("Running cache journal tests...\n");
+
+    wchar_t* subs[] = { L"C:\\v\\a.en.vtt" };
+    CacheEntry a;
+    InitEntry(&a, L"dQw4w9WgXcQ", L"Title", L"3:32", L"C:\\v\\a.mp4", subs, 1, 42);
+
+    CacheJournalBuffer buffer;
+    memset(&buffer, 0, sizeof(buffer));
+    assert(AppendCacheJournalPut(&buffer, &a));
+    assert(AppendCacheJournalRemove(&buffer, L"abcdefghijk"));
+    assert(buffer.recordCount == 2);
+    assert(buffer.size % 8 == 0);
+
+    size_t offset = 0;
+    CacheJournalRecord record;
+
+    // PUT carries a one-entry index image
+    assert(ReadCacheJournalRecord(buffer.data, buffer.size, &offset, &record));
+    assert(record.type == CACHE_JOURNAL_PUT);
+    assert(GetCacheJournalRemoveId(&record) == NULL);
+    CacheIndexReader reader;
+    CacheIndexRecord indexRecord;
+    assert(OpenCacheIndexImage(record.payload, record.payloadSize, &reader));
+    assert(GetCacheIndexEntryCount(&reader) == 1);
+    assert(ReadCacheIndexRecord(&reader, 0, &indexRecord));
+    assert(wcscmp(GetCacheIndexString(&reader, indexRecord.videoId), L"dQw4w9WgXcQ") == 0);
+    assert(wcscmp(GetCacheIndexSubtitle(&reader, &indexRecord, 0), L"C:\\v\\a.en.vtt") == 0);
+    assert(indexRecord.fileSize == 42);
+    size_t firstRecordEnd = offset;
+
+    assert(ReadCacheJournalRecord(buffer.data, buffer.size, &offset, &record));
+    assert(record.type == CACHE_JOURNAL_REMOVE);
+    assert(wcscmp(GetCacheJournalRemoveId(&record), L"abcdefghijk") == 0);
+    assert(offset == buffer.size);
+
+    // End of data
+    assert(!ReadCacheJournalRecord(buffer.data, buffer.size, &offset, &record));
+    assert(offset == buffer.size);
+
+    // Torn tail: replay stops after the last complete record
+    offset = 0;
+    size_t tornSize = buffer.size - 3;
+    assert(ReadCacheJournalRecord(buffer.data, tornSize, &offset, &record));
+    assert(!ReadCacheJournalRecord(buffer.data, tornSize, &offset, &record));
+    assert(offset == firstRecordEnd);
+
+    // Corrupt payload fails the checksum
+    buffer.data[firstRecordEnd + sizeof(CacheJournalRecordHeader)] ^= 0xFF;
+    offset = firstRecordEnd;
+    assert(!ReadCacheJournalRecord(buffer.data, buffer.size, &offset, &record));
+    assert(offset == firstRecordEnd);
+
+    // Reset keeps the allocation for reuse
+    size_t capacity = buffer.capacity;
+    ResetCacheJournalBuffer(&buffer);
+    assert(buffer.size == 0 && buffer.recordCount == 0 && buffer.capacity == capacity);
+
+    // Growth across many appends
+    for (int i = 0; i < 1000; i++) {
+        assert(AppendCacheJournalPut(&buffer, &a));
+    }
+    offset = 0;
+    int count = 0;
+    while (ReadCacheJournalRecord(buffer.data, buffer.size, &offset, &record)) {
+        count++;
+    }
+    assert(count == 1000 && offset == buffer.size);
+
+    FreeCacheJournalBuffer(&buffer);
+    assert(buffer.data == NULL && buffer.capacity == 0);
+
+    // The file header names the index generation the records follow
+    BYTE file[sizeof(CacheJournalFileHeader) + sizeof(CacheJournalRecordHeader)];
+    CacheJournalFileHeader fileHeader;
+    ULONGLONG generation = 99;
+    InitCacheJournalFileHeader(&fileHeader, 12);
+    memset(file, 0, sizeof(file));
+    memcpy(file, &fileHeader, sizeof(fileHeader));
+    assert(ReadCacheJournalFileHeader(file, sizeof(file), &offset, &generation));
+    assert(offset == sizeof(CacheJournalFileHeader) && generation == 12);
+
+    // Torn file header
+    assert(!ReadCacheJournalFileHeader(file, sizeof(CacheJournalFileHeader) - 1, &offset, &generation));
+
+    // A journal from before file headers starts with a record and follows generation 0
+    CacheJournalRecordHeader recordHeader = { CACHE_JOURNAL_MAGIC, CACHE_JOURNAL_REMOVE, 0, 0 };
+    memcpy(file, &recordHeader, sizeof(recordHeader));
+    assert(ReadCacheJournalFileHeader(file, sizeof(recordHeader), &offset, &generation));
+    assert(offset == 0 && generation == 0);
+
+    printf("All cache journal tests passed!\n");
+}
+
+// Indexes written before access stats existed have shorter records; they load
+// with the stats zeroed
+void test_version1_records() {
+    printf("Running cache index version 1 tests...\n");
+
+    CacheEntry a, b;
+    InitEntry(&a, L"dQw4w9WgXcQ", L"First", L"3:32", L"C:\\v\\a.mp4", NULL, 0, 1000);
+    InitEntry(&b, L"abcdefghijk", L"Second", NULL, L"C:\\v\\b.mp4", NULL, 0, 2000);
+    a.accessCount = b.accessCount = 5;
+    CacheEntry* entries[] = { &a, &b };
+    CacheIndexImage image;
+    assert(BuildCacheIndexImage(entries, 2, 1, &image));
+
+    // Rewrite as a version 1 image: records packed at the old size, tables left in place
+    CacheIndexHeader* header = (CacheIndexHeader*)image.data;
+    BYTE* records = image.data + header->recordsOffset;
+    for (DWORD i = 0; i < header->entryCount; i++) {
+        memmove(records + i * CACHE_INDEX_RECORD_V1_SIZE, records + i * sizeof(CacheIndexRecord), CACHE_INDEX_RECORD_V1_SIZE);
+    }
+    header->version = 1;
+    header->headerSize = CACHE_INDEX_HEADER_V4_SIZE;
+    header->recordSize = CACHE_INDEX_RECORD_V1_SIZE;
+    header->headerChecksum = ComputeCacheIndexHeaderChecksum(header);
+
+    CacheIndexReader reader;
+    CacheIndexRecord record;
+    assert(OpenCacheIndexImage(image.data, image.size, &reader));
+    assert(GetCacheIndexGeneration(&reader) == 0);
+    assert(ReadCacheIndexRecord(&reader, 1, &record));
+    assert(wcscmp(GetCacheIndexString(&reader, record.videoId), L"abcdefghijk") == 0);
+    assert(record.fileSize == 2000);
+    assert(record.lastAccessTime == 0 && record.accessCount == 0);
+    assert(record.hashWriteTime == 0 && record.sampleHash == 0 && record.contentHash == 0);
+    assert(record.verifyTime == 0 && record.flags == 0);
+
+    // Records too short to hold the version 1 fields are rejected
+    header->recordSize = CACHE_INDEX_RECORD_V1_SIZE - 8;
+    header->headerChecksum = ComputeCacheIndexHeaderChecksum(header);
+    assert(!OpenCacheIndexImage(image.data, image.size, &reader));
+
+    FreeCacheIndexImage(&image);
+
+    printf("All cache index version 1 tests passed!\n");
+}
+
+int main() {
+    test_round_trip();
+    test_corruption_rejected();
+    test_version1_records();
+    test_journal();
+    return 0;
+}
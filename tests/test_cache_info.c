@@ -0,0 +1,185 @@
+#include "mock_windows.h"
+
+// Prevent inclusion of the full application header
+#define YOUTUBECACHER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <assert.h>
+
+#ifndef FILE_SHARE_WRITE
+#define FILE_SHARE_WRITE 0x00000002
+#endif
+#ifndef FILE_FLAG_SEQUENTIAL_SCAN
+#define FILE_FLAG_SEQUENTIAL_SCAN 0x08000000
+#endif
+
+#include "../cacheinfo.h"
+#include "../cacheinfo.c"
+
+// An info JSON as yt-dlp writes it, trimmed: the nested formats carry keys of
+// the same names as the top-level fields
+static const char infoJson[] =
+    "\xEF\xBB\xBF{\"id\": \"dQw4w9WgXcQ\", \"formats\": [{\"id\": \"wrong\", \"title\": \"wrong\", "
+    "\"duration\": 1, \"url\": \"https://example.com/?a=\\\"}\"}], "
+    "\"thumbnails\": {\"title\": \"wrong\"}, \"is_live\": false, \"tags\": [\"a\", [\"b\"]], "
+    "\"title\": \"Caf\xC3\xA9 \\\"live\\\" \\u2603 \\ud83d\\ude00 \xF0\x9F\x8E\xB5\", "
+    "\"duration\": 212.5, \"description\": \"no id here\"}";
+
+// Feed a document in chunks of the given size and decode what was found
+static BOOL ParseInChunks(const char* json, size_t length, size_t chunk, CacheInfo* info) {
+    CacheInfoParser* parser = (CacheInfoParser*)malloc(sizeof(CacheInfoParser));
+    assert(parser);
+    InitCacheInfoParser(parser);
+    for (size_t i = 0; i < length; i += chunk) {
+        size_t size = length - i < chunk ? length - i : chunk;
+        if (!FeedCacheInfoParser(parser, json + i, size)) break;
+    }
+    BOOL result = GetCacheInfoFields(parser, info);
+    FreeCacheInfoParser(parser);
+    free(parser);
+    return result;
+}
+
+void test_fields() {
+    printf("Running info JSON field tests...\n");
+
+    static const wchar_t title[] = L"Caf\x00E9 \"live\" \x2603 \xD83D\xDE00 \xD83C\xDFB5";
+
+    // Split at every possible point, even inside escapes and UTF-8 sequences
+    for (size_t chunk = 1; chunk <= sizeof(infoJson); chunk++) {
+        CacheInfo info;
+        assert(ParseInChunks(infoJson, sizeof(infoJson) - 1, chunk, &info));
+        assert(wcscmp(info.id, L"dQw4w9WgXcQ") == 0);
+        assert(info.title && wcscmp(info.title, title) == 0);
+        assert(info.duration == 212.5);
+        FreeCacheInfo(&info);
+        assert(info.id == NULL && info.title == NULL);
+    }
+
+    // Missing title and duration are left empty
+    CacheInfo info;
+    const char* bare = "{\"id\":\"abcdefghijk\",\"duration\":null}";
+    assert(ParseInChunks(bare, strlen(bare), 64, &info));
+    assert(wcscmp(info.id, L"abcdefghijk") == 0 && info.title == NULL && info.duration == 0);
+    FreeCacheInfo(&info);
+
+    // A number ending the object is kept, and a negative duration is unknown
+    const char* last = "{\"id\":\"abcdefghijk\",\"duration\":-3}";
+    assert(ParseInChunks(last, strlen(last), 1, &info));
+    assert(info.duration == 0);
+    FreeCacheInfo(&info);
+    const char* tail = "{\"id\":\"abcdefghijk\",\"duration\":61}";
+    assert(ParseInChunks(tail, strlen(tail), 3, &info));
+    assert(info.duration == 61);
+    FreeCacheInfo(&info);
+
+    printf("All info JSON field tests passed!\n");
+}
+
+void test_early_stop() {
+    printf("Running info JSON early stop tests...\n");
+
+    CacheInfoParser* parser = (CacheInfoParser*)malloc(sizeof(CacheInfoParser));
+    assert(parser);
+
+    // All fields seen before the formats: nothing after them needs to be read
+    const char* head = "{\"title\":\"T\",\"id\":\"abcdefghijk\",\"duration\":5,\"formats\":[";
+    InitCacheInfoParser(parser);
+    assert(FeedCacheInfoParser(parser, head, strlen(head)));
+    assert(parser->found == CACHE_INFO_ALL_FIELDS && !parser->complete);
+    FreeCacheInfoParser(parser);
+
+    // Nothing after the top-level object is parsed
+    const char* trailing = "{\"id\":\"abcdefghijk\"} {\"title\":\"next\"}";
+    InitCacheInfoParser(parser);
+    assert(FeedCacheInfoParser(parser, trailing, strlen(trailing)));
+    assert(parser->complete && parser->found == (1u << CACHE_INFO_FIELD_ID));
+    FreeCacheInfoParser(parser);
+
+    free(parser);
+
+    printf("All info JSON early stop tests passed!\n");
+}
+
+void test_malformed() {
+    printf("Running malformed info JSON tests...\n");
+
+    CacheInfo info;
+
+    // Not an object, or garbage before it
+    const char* array = "[{\"id\":\"abcdefghijk\"}]";
+    assert(!ParseInChunks(array, strlen(array), 4, &info));
+    const char* text = "id: abcdefghijk";
+    assert(!ParseInChunks(text, strlen(text), 4, &info));
+    const char* closed = "}{\"id\":\"abcdefghijk\"}";
+    assert(!ParseInChunks(closed, strlen(closed), 4, &info));
+    assert(!ParseInChunks("", 0, 4, &info));
+
+    // No video ID
+    const char* noId = "{\"title\":\"T\",\"duration\":5}";
+    assert(!ParseInChunks(noId, strlen(noId), 4, &info));
+    const char* emptyId = "{\"id\":\"\",\"title\":\"T\"}";
+    assert(!ParseInChunks(emptyId, strlen(emptyId), 4, &info));
+
+    // A truncated file still yields the fields completed before the cut
+    const char* cut = "{\"id\":\"abcdefghijk\",\"title\":\"Half a tit";
+    assert(ParseInChunks(cut, strlen(cut), 7, &info));
+    assert(wcscmp(info.id, L"abcdefghijk") == 0 && info.title == NULL);
+    FreeCacheInfo(&info);
+
+    // Overlong values are cut rather than overrun
+    size_t longLength = CACHE_INFO_MAX_VALUE * 2 + 64;
+    char* longTitle = (char*)malloc(longLength + 1);
+    assert(longTitle);
+    int prefix = sprintf(longTitle, "{\"id\":\"abcdefghijk\",\"title\":\"");
+    memset(longTitle + prefix, 'x', longLength - prefix - 2);
+    strcpy(longTitle + longLength - 2, "\"}");
+    assert(ParseInChunks(longTitle, longLength, 1000, &info));
+    assert(wcslen(info.title) == CACHE_INFO_MAX_VALUE);
+    FreeCacheInfo(&info);
+    free(longTitle);
+
+    // Keys longer than any wanted key never match
+    const char* longKey = "{\"id_of_something_else_entirely\":\"x\",\"id\":\"abcdefghijk\"}";
+    assert(ParseInChunks(longKey, strlen(longKey), 5, &info));
+    assert(wcscmp(info.id, L"abcdefghijk") == 0);
+    FreeCacheInfo(&info);
+
+    printf("All malformed info JSON tests passed!\n");
+}
+
+void test_decode() {
+    printf("Running info JSON string decode tests...\n");
+
+    wchar_t* text = DecodeCacheInfoString("a\\/b\\\\c\\n\\t", 11);
+    assert(wcscmp(text, L"a/b\\c\n\t") == 0);
+    free(text);
+
+    // Invalid and cut UTF-8 sequences become replacement characters
+    text = DecodeCacheInfoString("\xFF" "a\xC3", 3);
+    assert(wcscmp(text, L"\xFFFD" L"a\xFFFD") == 0);
+    free(text);
+
+    // A value cut inside an escape ends before it
+    text = DecodeCacheInfoString("ab\\u26", 6);
+    assert(wcscmp(text, L"ab") == 0);
+    free(text);
+    text = DecodeCacheInfoString("ab\\", 3);
+    assert(wcscmp(text, L"ab") == 0);
+    free(text);
+
+    assert(DecodeCacheInfoString(NULL, 0) == NULL);
+
+    printf("All info JSON string decode tests passed!\n");
+}
+
+int main() {
+    test_fields();
+    test_early_stop();
+    test_malformed();
+    test_decode();
+    return 0;
+}
@@ -0,0 +1,232 @@
+#include "mock_windows.h"
+
+// Prevent inclusion of the full application header
+#define YOUTUBECACHER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <wctype.h>
+#include <assert.h>
+
+#include "../cache.h"
+// The real extension lists, not the mock's
+#undef IsSubtitleFileExtension
+#include "media_ext_logic.c"
+#include "../stringarena.c"
+#include "../cachereconcile.c"
+
+// Build a sorted listing from file names, giving each a size from its position
+static void MakeListing(CacheDirectoryListing* listing, const wchar_t* const* names, int count) {
+    assert(InitCacheDirectoryListing(listing));
+    for (int i = 0; i < count; i++) {
+        assert(AddCacheDirectoryFile(listing, names[i], (ULONGLONG)(i + 1) * 100, (ULONGLONG)(i + 1) * 1000, FALSE));
+    }
+    SortCacheDirectoryListing(listing);
+}
+
+// Match a video and return its subtitle siblings in listing order, joined by spaces
+static const wchar_t* Subtitles(const CacheDirectoryListing* listing, const wchar_t* fileName) {
+    static wchar_t result[512];
+    result[0] = L'\0';
+
+    CacheDirectoryMatch match;
+    MatchCacheDirectoryFile(listing, fileName, &match);
+    DWORD found = 0;
+    for (DWORD i = match.siblingFirst; i < match.siblingEnd; i++) {
+        if (!IsCacheSubtitleSibling(listing->files[i].name, match.baseLength)) continue;
+        if (found++ > 0) wcscat(result, L" ");
+        wcscat(result, listing->files[i].name);
+    }
+    assert(found == match.subtitleCount);
+    return result;
+}
+
+void test_listing() {
+    printf("Running directory listing tests...\n");
+
+    static const wchar_t* const names[] = {
+        L"zeta [ccccccccccc].mp4",
+        L"Alpha [aaaaaaaaaaa].mp4",
+        L"beta [bbbbbbbbbbb].webm",
+        L"desktop.ini",
+    };
+    CacheDirectoryListing listing;
+    MakeListing(&listing, names, 4);
+    assert(listing.count == 4);
+
+    // Sorted by name, ignoring case
+    for (DWORD i = 1; i < listing.count; i++) {
+        assert(_wcsicmp(listing.files[i - 1].name, listing.files[i].name) < 0);
+    }
+
+    // Found regardless of case, with the size and write time it was listed with
+    const CacheDirectoryFile* file = FindCacheDirectoryFile(&listing, L"ZETA [ccccccccccc].MP4");
+    assert(file && wcscmp(file->name, L"zeta [ccccccccccc].mp4") == 0);
+    assert(file->size == 100 && file->writeTime == 1000);
+    assert(FindCacheDirectoryFile(&listing, L"beta [bbbbbbbbbbb].webm")->size == 300);
+    assert(FindCacheDirectoryFile(&listing, L"gamma.mp4") == NULL);
+    assert(FindCacheDirectoryFile(&listing, L"") == NULL);
+
+    FreeCacheDirectoryListing(&listing);
+    assert(listing.files == NULL && listing.count == 0);
+
+    // An empty listing finds nothing
+    MakeListing(&listing, NULL, 0);
+    CacheDirectoryMatch match;
+    MatchCacheDirectoryFile(&listing, L"video.mp4", &match);
+    assert(match.file == NULL && match.subtitleCount == 0 && match.siblingFirst == match.siblingEnd);
+    FreeCacheDirectoryListing(&listing);
+
+    // Paths split on either separator
+    assert(wcscmp(GetCachePathFileName(L"C:\\Videos\\a\\b.mp4"), L"b.mp4") == 0);
+    assert(wcscmp(GetCachePathFileName(L"C:/Videos/b.mp4"), L"b.mp4") == 0);
+    assert(wcscmp(GetCachePathFileName(L"b.mp4"), L"b.mp4") == 0);
+
+    printf("All directory listing tests passed!\n");
+}
+
+void test_subtitle_siblings() {
+    printf("Running subtitle sibling tests...\n");
+
+    // What yt-dlp leaves in a download folder, listed in directory order
+    static const wchar_t* const names[] = {
+        L"Talk [dQw4w9WgXcQ].mp4",
+        L"Talk [dQw4w9WgXcQ].en.vtt",
+        L"Talk [dQw4w9WgXcQ].info.json",
+        L"Talk [dQw4w9WgXcQ].de-DE.SRT",
+        L"Talk [dQw4w9WgXcQ].webp",
+        L"Talk [dQw4w9WgXcQ].vtt",
+        L"Talk [dQw4w9WgXcQ].part2.mp4",
+        L"Talk [dQw4w9WgXcQ].part2.en.vtt",
+        L"Talk [dQw4w9WgXcQ] extended.mp4",
+        L"Talk [dQw4w9WgXcQ] extended.en.vtt",
+        L"Talk [dQw4w9WgXcQ]..vtt",
+        L"Talk.mp4",
+        L"Talk.srt",
+        L"v1.2 notes.mp4",
+        L"v1.2 notes.fr.ass",
+    };
+    CacheDirectoryListing listing;
+    MakeListing(&listing, names, (int)(sizeof(names) / sizeof(names[0])));
+
+    // Subtitles with and without a language tag, in any case; not the info JSON,
+    // not the thumbnail, and nothing belonging to a video whose name merely starts
+    // the same way
+    assert(wcscmp(Subtitles(&listing, L"Talk [dQw4w9WgXcQ].mp4"),
+                  L"Talk [dQw4w9WgXcQ].de-DE.SRT Talk [dQw4w9WgXcQ].en.vtt Talk [dQw4w9WgXcQ].vtt") == 0);
+    assert(wcscmp(Subtitles(&listing, L"Talk [dQw4w9WgXcQ].part2.mp4"), L"Talk [dQw4w9WgXcQ].part2.en.vtt") == 0);
+    assert(wcscmp(Subtitles(&listing, L"Talk [dQw4w9WgXcQ] extended.mp4"), L"Talk [dQw4w9WgXcQ] extended.en.vtt") == 0);
+    assert(wcscmp(Subtitles(&listing, L"Talk.mp4"), L"Talk.srt") == 0);
+
+    // Only the last dot starts the extension
+    assert(wcscmp(Subtitles(&listing, L"v1.2 notes.mp4"), L"v1.2 notes.fr.ass") == 0);
+
+    // The match also finds the video itself, even when its subtitles are all that is left
+    CacheDirectoryMatch match;
+    MatchCacheDirectoryFile(&listing, L"talk [DQW4W9WGXCQ].MP4", &match);
+    assert(match.file && match.file->size == 100);
+    assert(match.subtitleCount == 3);
+    MatchCacheDirectoryFile(&listing, L"Gone [dQw4w9WgXcQ].mp4", &match);
+    assert(match.file == NULL && match.subtitleCount == 0);
+
+    // Only the video's own info JSON is found with it
+    MatchCacheDirectoryFile(&listing, L"Talk [dQw4w9WgXcQ].mp4", &match);
+    assert(match.infoFile && wcscmp(match.infoFile->name, L"Talk [dQw4w9WgXcQ].info.json") == 0);
+    MatchCacheDirectoryFile(&listing, L"Talk [dQw4w9WgXcQ].part2.mp4", &match);
+    assert(match.infoFile == NULL);
+    MatchCacheDirectoryFile(&listing, L"Talk.mp4", &match);
+    assert(match.infoFile == NULL);
+
+    // The sibling rule on its own
+    assert(IsCacheSubtitleSibling(L"a.srt", 1));
+    assert(IsCacheSubtitleSibling(L"a.zh-Hans.vtt", 1));
+    assert(!IsCacheSubtitleSibling(L"a.mp4", 1));
+    assert(!IsCacheSubtitleSibling(L"a", 1));
+    assert(!IsCacheSubtitleSibling(L"ab.srt", 1));
+    assert(!IsCacheSubtitleSibling(L"a..srt", 1));
+    assert(!IsCacheSubtitleSibling(L"a.b.en.srt", 1));
+
+    FreeCacheDirectoryListing(&listing);
+
+    printf("All subtitle sibling tests passed!\n");
+}
+
+void test_classify() {
+    printf("Running file name classification tests...\n");
+
+    wchar_t id[CACHE_VIDEO_ID_LENGTH + 1];
+
+    // The app's own downloads, and yt-dlp's default names, in any video container
+    assert(ClassifyCacheFileName(L"dQw4w9WgXcQ.mp4", id) == CACHE_FILE_VIDEO && wcscmp(id, L"dQw4w9WgXcQ") == 0);
+    assert(ClassifyCacheFileName(L"Talk [a-b_c123456].WEBM", id) == CACHE_FILE_VIDEO && wcscmp(id, L"a-b_c123456") == 0);
+    assert(ClassifyCacheFileName(L"[x] Talk [dQw4w9WgXcQ].mp4", id) == CACHE_FILE_VIDEO && wcscmp(id, L"dQw4w9WgXcQ") == 0);
+
+    // Subtitles, with or without a language tag, belong to their video
+    assert(ClassifyCacheFileName(L"dQw4w9WgXcQ.en.vtt", id) == CACHE_FILE_SUBTITLE && wcscmp(id, L"dQw4w9WgXcQ") == 0);
+    assert(ClassifyCacheFileName(L"Talk [dQw4w9WgXcQ].srt", id) == CACHE_FILE_SUBTITLE && wcscmp(id, L"dQw4w9WgXcQ") == 0);
+    assert(ClassifyCacheFileName(L"Talk [dQw4w9WgXcQ].pt-BR.ass", id) == CACHE_FILE_SUBTITLE);
+
+    // Partial downloads, metadata and names without an ID are not the cache's
+    assert(ClassifyCacheFileName(L"dQw4w9WgXcQ.mp4.part", id) == CACHE_FILE_OTHER);
+    assert(ClassifyCacheFileName(L"dQw4w9WgXcQ.info.json", id) == CACHE_FILE_OTHER);
+    assert(ClassifyCacheFileName(L"Holiday video.mp4", id) == CACHE_FILE_OTHER);
+    assert(ClassifyCacheFileName(L"Talk [dQw4w9WgX].mp4", id) == CACHE_FILE_OTHER);
+    assert(ClassifyCacheFileName(L"Talk [dQw4w9WgXcQx].mp4", id) == CACHE_FILE_OTHER);
+    assert(ClassifyCacheFileName(L"Talk [dQw4w9Wg!cQ].mp4", id) == CACHE_FILE_OTHER);
+    assert(ClassifyCacheFileName(L"dQw4w9WgXcQ.de.fr.vtt", id) == CACHE_FILE_OTHER);
+    assert(ClassifyCacheFileName(L".mp4", id) == CACHE_FILE_OTHER);
+    assert(ClassifyCacheFileName(L"dQw4w9WgXcQ", id) == CACHE_FILE_OTHER);
+
+    printf("All file name classification tests passed!\n");
+}
+
+#define TEST_VIDEOS 2000
+
+// Large directory: every video and its subtitles are found from one listing,
+// and the listing grows past its initial capacity
+void test_large_directory() {
+    printf("Running large directory reconcile tests...\n");
+
+    CacheDirectoryListing listing;
+    assert(InitCacheDirectoryListing(&listing));
+    wchar_t name[64];
+    for (int i = TEST_VIDEOS - 1; i >= 0; i--) {
+        swprintf(name, 64, L"Video %d [id%09d].mp4", i, i);
+        assert(AddCacheDirectoryFile(&listing, name, (ULONGLONG)i, 0, FALSE));
+        if (i % 3 == 0) {
+            swprintf(name, 64, L"Video %d [id%09d].en.vtt", i, i);
+            assert(AddCacheDirectoryFile(&listing, name, 1, 0, FALSE));
+        }
+    }
+    SortCacheDirectoryListing(&listing);
+    assert(listing.capacity >= listing.count && listing.count > TEST_VIDEOS);
+
+    DWORD present = 0;
+    for (int i = 0; i < TEST_VIDEOS + 100; i++) {
+        swprintf(name, 64, L"Video %d [id%09d].mp4", i, i);
+        CacheDirectoryMatch match;
+        MatchCacheDirectoryFile(&listing, name, &match);
+        if (i < TEST_VIDEOS) {
+            assert(match.file && match.file->size == (ULONGLONG)i);
+            assert(match.subtitleCount == (i % 3 == 0 ? 1u : 0u));
+            present++;
+        } else {
+            assert(match.file == NULL);
+        }
+    }
+    assert(present == TEST_VIDEOS);
+
+    FreeCacheDirectoryListing(&listing);
+
+    printf("All large directory reconcile tests passed!\n");
+}
+
+int main() {
+    test_listing();
+    test_subtitle_siblings();
+    test_classify();
+    test_large_directory();
+    return 0;
+}
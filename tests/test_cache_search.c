@@ -0,0 +1,210 @@
+#include "mock_windows.h"
+
+// Prevent inclusion of the full application header
+#define YOUTUBECACHER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <wctype.h>
+#include <assert.h>
+
+#include "../cache.h"
+
+void ThreadSafeDebugOutput(const wchar_t* message) { (void)message; }
+
+#include "cache_duration.c"
+#include "../cachecolumns.c"
+#include "../cachesearch.c"
+
+static void InitEntry(CacheEntry* entry, const wchar_t* id, const wchar_t* title) {
+    memset(entry, 0, sizeof(CacheEntry));
+    entry->videoId = (wchar_t*)id;
+    entry->title = (wchar_t*)title;
+    entry->mainVideoFile = L"C:\\v\\file.mp4";
+}
+
+// Run a query and return the matched entries' video IDs in order, joined by spaces
+static const wchar_t* Search(const CacheSearchIndex* index, const wchar_t* text) {
+    static wchar_t result[1024];
+    result[0] = L'\0';
+
+    wchar_t* query = FoldCacheSearchQuery(text);
+    assert(query);
+    CacheSearchMatch* matches = NULL;
+    DWORD count = 0;
+    assert(SearchCacheIndex(index, query, &matches, &count));
+    for (DWORD i = 0; i < count; i++) {
+        if (i > 0) wcscat(result, L" ");
+        wcscat(result, matches[i].entry->videoId);
+    }
+    free(matches);
+    free(query);
+    return result;
+}
+
+void test_search() {
+    printf("Running cache search query tests...\n");
+
+    CacheEntry entries[6];
+    InitEntry(&entries[0], L"id0", L"Never Gonna Give You Up");
+    InitEntry(&entries[1], L"id1", L"The making of NEVER gonna");
+    InitEntry(&entries[2], L"id2", L"Foreverneverland");
+    InitEntry(&entries[3], L"never", L"Unrelated");
+    InitEntry(&entries[4], L"id4", NULL);
+    InitEntry(&entries[5], L"xneverx", L"Other");
+
+    CacheColumns columns;
+    assert(InitCacheColumns(&columns, 0));
+    for (int i = 0; i < 6; i++) {
+        assert(AppendCacheColumnsRow(&columns, &entries[i]));
+    }
+
+    CacheSearchIndex index;
+    InitCacheSearchIndex(&index);
+
+    // Nothing can be searched before the index is built
+    CacheSearchMatch* matches = NULL;
+    DWORD count = 0;
+    assert(!SearchCacheIndex(&index, L"never", &matches, &count));
+
+    assert(BuildCacheSearchIndex(&index, &columns));
+    assert(index.built && index.liveCount == 6);
+
+    // Ranked: exact ID, title prefix, word start, inside a word, part of an ID
+    assert(wcscmp(Search(&index, L"NEVER"), L"never id0 id1 id2 xneverx") == 0);
+    assert(wcscmp(Search(&index, L"  gonna "), L"id0 id1") == 0);
+    assert(wcscmp(Search(&index, L"nevermore"), L"") == 0);
+    assert(wcscmp(Search(&index, L"zzz"), L"") == 0);
+
+    // A match never spans the title and the video ID
+    assert(wcscmp(Search(&index, L"upid0"), L"") == 0);
+    assert(wcscmp(Search(&index, L"up id0"), L"") == 0);
+
+    // Queries under three characters scan every document
+    assert(wcscmp(Search(&index, L"Id"), L"id0 id1 id2 id4") == 0);
+    assert(wcscmp(Search(&index, L"4"), L"id4") == 0);
+
+    // Blank text is no query at all
+    assert(FoldCacheSearchQuery(L"   ") == NULL);
+    assert(FoldCacheSearchQuery(NULL) == NULL);
+
+    // Single entries are matched against the index or folded on the spot
+    assert(MatchCacheSearchEntry(&index, &entries[1], L"making"));
+    assert(!MatchCacheSearchEntry(&index, &entries[2], L"making"));
+    CacheEntry unindexed;
+    InitEntry(&unindexed, L"new", L"Making Of");
+    unindexed.searchDoc = 1;
+    assert(MatchCacheSearchEntry(&index, &unindexed, L"making"));
+    assert(!MatchCacheSearchEntry(&index, &unindexed, L"never"));
+
+    FreeCacheSearchIndex(&index);
+    assert(!index.built && index.docs == NULL && index.buckets == NULL);
+    FreeCacheColumns(&columns);
+
+    printf("All cache search query tests passed!\n");
+}
+
+#define TEST_ENTRIES 400
+
+static const wchar_t* const words[] = {
+    L"Lecture", L"Cooking", L"Guitar", L"lesson", L"MIX", L"live", L"Tour", L"news", L"Review", L"speedrun"
+};
+
+static void MakeTitle(wchar_t* title, size_t size, unsigned int seed) {
+    swprintf(title, size, L"%ls %u %ls %ls", words[seed % 10], seed % 37, words[(seed / 10) % 10], words[(seed * 7 + 3) % 10]);
+}
+
+// Count entries in the live set matching a folded query, the slow way
+static DWORD CountMatches(CacheEntry* entries, const BOOL* live, const wchar_t* query) {
+    DWORD count = 0;
+    for (int i = 0; i < TEST_ENTRIES; i++) {
+        if (!live[i]) continue;
+
+        wchar_t* title = FoldCacheSearchQuery(entries[i].title);
+        wchar_t* id = FoldCacheSearchQuery(entries[i].videoId);
+        if ((title && wcsstr(title, query)) || wcsstr(id, query)) count++;
+        free(title);
+        free(id);
+    }
+    return count;
+}
+
+void test_incremental() {
+    printf("Running cache search maintenance tests...\n");
+
+    static CacheEntry entries[TEST_ENTRIES];
+    static wchar_t ids[TEST_ENTRIES][16];
+    static wchar_t titles[TEST_ENTRIES][96];
+    BOOL live[TEST_ENTRIES];
+
+    CacheColumns columns;
+    assert(InitCacheColumns(&columns, 0));
+    for (int i = 0; i < TEST_ENTRIES; i++) {
+        swprintf(ids[i], 16, L"vid%05d", i);
+        MakeTitle(titles[i], 96, (unsigned int)i);
+        InitEntry(&entries[i], ids[i], titles[i]);
+        live[i] = i < TEST_ENTRIES / 2;
+        if (live[i]) assert(AppendCacheColumnsRow(&columns, &entries[i]));
+    }
+
+    CacheSearchIndex index;
+    InitCacheSearchIndex(&index);
+
+    // Updates before the index is built are ignored
+    AddCacheSearchDocument(&index, &entries[TEST_ENTRIES - 1]);
+    assert(index.liveCount == 0);
+
+    assert(BuildCacheSearchIndex(&index, &columns));
+
+    static const wchar_t* const queries[] = { L"lesson", L"guitar 1", L"mix", L"vid001", L"live", L"ur", L"12 co" };
+    unsigned int seed = 12345;
+    DWORD sweptSlots = 0;
+    for (int round = 0; round < 2000; round++) {
+        seed = seed * 1103515245u + 12345u;
+        int i = (int)((seed >> 8) % TEST_ENTRIES);
+        if (live[i] && (seed & 1)) {
+            RemoveCacheSearchDocument(&index, &entries[i]);
+            live[i] = FALSE;
+        } else if (live[i]) {
+            // Title changed in place
+            MakeTitle(titles[i], 96, seed >> 12);
+            UpdateCacheSearchDocument(&index, &entries[i]);
+        } else {
+            AddCacheSearchDocument(&index, &entries[i]);
+            live[i] = TRUE;
+        }
+        assert(index.built);
+        if (index.freeCount > sweptSlots) sweptSlots = index.freeCount;
+
+        if (round % 50 == 0) {
+            for (size_t q = 0; q < sizeof(queries) / sizeof(queries[0]); q++) {
+                CacheSearchMatch* matches = NULL;
+                DWORD count = 0;
+                assert(SearchCacheIndex(&index, queries[q], &matches, &count));
+                assert(count == CountMatches(entries, live, queries[q]));
+                for (DWORD m = 0; m < count; m++) {
+                    assert(live[matches[m].entry - entries]);
+                    assert(m == 0 || matches[m - 1].rank <= matches[m].rank);
+                }
+                free(matches);
+            }
+        }
+    }
+
+    // Removed documents were swept and their slots reused, so the index stays bounded
+    assert(sweptSlots > 0);
+    assert(index.docCount <= TEST_ENTRIES + CACHE_SEARCH_SWEEP_MIN_DEAD + TEST_ENTRIES / 3);
+
+    FreeCacheSearchIndex(&index);
+    FreeCacheColumns(&columns);
+
+    printf("All cache search maintenance tests passed!\n");
+}
+
+int main() {
+    test_search();
+    test_incremental();
+    return 0;
+}
@@ -0,0 +1,237 @@
+#include "mock_windows.h"
+
+// Prevent inclusion of the full application header
+#define YOUTUBECACHER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <assert.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "../cache.h"
+#include "../cacheview.h"
+#include "cache_duration.c"
+#include "../stringarena.c"
+#include "../cachecolumns.c"
+#include "../cachesort.c"
+#include "../cacheview.c"
+
+#define WRITER_COUNT        2
+#define WRITER_BATCHES      15
+#define BATCH_SIZE          50
+#define HOLD_MS             20      // Writer time under the cache lock per batch, standing in for index work
+#define ENTRY_COUNT         (WRITER_COUNT * WRITER_BATCHES * BATCH_SIZE)
+
+static void InitEntry(CacheEntry* entry, wchar_t* id, wchar_t* title, wchar_t* file, ULONGLONG size) {
+    memset(entry, 0, sizeof(CacheEntry));
+    entry->videoId = id;
+    entry->title = title;
+    entry->mainVideoFile = file;
+    entry->fileSize = size;
+}
+
+static long long NowMicroseconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+static void SleepMilliseconds(int ms) {
+    struct timespec pause = { 0, ms * 1000000L };
+    nanosleep(&pause, NULL);
+}
+
+static BOOL KeepEvenSizes(const CacheViewRow* row, void* context) {
+    (void)context;
+    return row->fileSize % 2 == 0;
+}
+
+void test_publisher() {
+    printf("Running cache snapshot publisher tests...\n");
+
+    CacheEntry e[3];
+    InitEntry(&e[0], L"id0", L"Zero", L"C:\\v\\0.mp4", 10);
+    InitEntry(&e[1], L"id1", NULL, L"C:\\v\\1.mp4", 11);
+    InitEntry(&e[2], L"id2", L"Two", L"C:\\v\\2.mp4", 12);
+    CacheEntry* order[3] = { &e[0], &e[1], &e[2] };
+
+    CacheViewPublisher publisher;
+    InitCacheViewPublisher(&publisher);
+    assert(AcquireCacheViewSnapshot(&publisher) == NULL);
+
+    // The publisher takes over the builder's reference; each reader gets its own
+    CacheViewSnapshot* first = BuildCacheViewSnapshot(order, 3, NULL, CACHE_SORT_NONE, TRUE);
+    PublishCacheViewSnapshot(&publisher, first);
+    assert(first->refCount == 1);
+    CacheViewSnapshot* reader = AcquireCacheViewSnapshot(&publisher);
+    assert(reader == first && first->refCount == 2);
+
+    // Lookups by video ID
+    const CacheViewRow* row = FindCacheViewRow(reader, L"id2");
+    assert(row && row->fileSize == 12 && wcscmp(row->title, L"Two") == 0);
+    assert(FindCacheViewRow(reader, L"missing") == NULL);
+    assert(FindCacheViewRow(NULL, L"id0") == NULL);
+
+    // A new publish leaves the old snapshot to the reader still holding it
+    CacheViewSnapshot* second = BuildCacheViewSnapshot(order, 2, NULL, CACHE_SORT_NONE, TRUE);
+    PublishCacheViewSnapshot(&publisher, second);
+    assert(first->refCount == 1);
+    assert(reader->count == 3 && wcscmp(reader->rows[2].videoId, L"id2") == 0);
+    ReleaseCacheViewSnapshot(reader);
+
+    // Copies keep the rows the filter passes, share the strings and leave the source alone
+    CacheViewSnapshot* latest = AcquireCacheViewSnapshot(&publisher);
+    CacheViewSnapshot* copy = CopyCacheViewSnapshot(latest, KeepEvenSizes, NULL);
+    assert(copy && copy->count == 1 && copy->refCount == 1);
+    assert(copy->rows[0].videoId == latest->rows[0].videoId);
+    assert(latest->count == 2);
+    ReleaseCacheViewSnapshot(latest);
+
+    // The copy keeps the strings alive after the publisher lets go
+    FreeCacheViewPublisher(&publisher);
+    assert(wcscmp(copy->rows[0].videoId, L"id0") == 0);
+    ReleaseCacheViewSnapshot(copy);
+    assert(CopyCacheViewSnapshot(NULL, NULL, NULL) == NULL);
+
+    printf("All cache snapshot publisher tests passed!\n");
+}
+
+// A cache under heavy insert load: writers add batches of entries under the
+// cache lock and publish a snapshot derived from the last one before releasing it
+typedef struct {
+    pthread_mutex_t lock;           // The cache lock
+    CacheViewPublisher publisher;
+    CacheEntry* entries;
+    wchar_t (*ids)[16];
+    volatile LONG writersDone;
+} LoadedCache;
+
+typedef struct {
+    LoadedCache* cache;
+    int writer;
+} Writer;
+
+static void* RunWriter(void* param) {
+    Writer* writer = (Writer*)param;
+    LoadedCache* cache = writer->cache;
+
+    for (int batch = 0; batch < WRITER_BATCHES; batch++) {
+        int first = (writer->writer * WRITER_BATCHES + batch) * BATCH_SIZE;
+        CacheEntry* added[BATCH_SIZE];
+        const wchar_t* changedIds[BATCH_SIZE];
+        for (int i = 0; i < BATCH_SIZE; i++) {
+            swprintf(cache->ids[first + i], 16, L"w%d-%06d", writer->writer, first + i);
+            InitEntry(&cache->entries[first + i], cache->ids[first + i], cache->ids[first + i], cache->ids[first + i], 1);
+            added[i] = &cache->entries[first + i];
+            changedIds[i] = cache->ids[first + i];
+        }
+
+        pthread_mutex_lock(&cache->lock);
+        SleepMilliseconds(HOLD_MS);
+        CacheViewSnapshot* patch = BuildCacheViewSnapshot(added, BATCH_SIZE, NULL, CACHE_SORT_NONE, TRUE);
+        assert(patch);
+        CacheViewSnapshot* next = ApplyCacheViewChanges(cache->publisher.current, changedIds, BATCH_SIZE, patch);
+        assert(next);
+        ReleaseCacheViewSnapshot(patch);
+        PublishCacheViewSnapshot(&cache->publisher, next);
+        pthread_mutex_unlock(&cache->lock);
+
+        SleepMilliseconds(1);
+    }
+
+    InterlockedIncrement(&cache->writersDone);
+    return NULL;
+}
+
+// Run the writers while the UI thread reads the entry count and total size,
+// either from published snapshots or under the cache lock. Returns the longest
+// read in microseconds.
+static long long MeasureReads(BOOL useSnapshots, int* reads) {
+    LoadedCache cache;
+    pthread_mutex_init(&cache.lock, NULL);
+    InitCacheViewPublisher(&cache.publisher);
+    PublishCacheViewSnapshot(&cache.publisher, BuildCacheViewSnapshot(NULL, 0, NULL, CACHE_SORT_NONE, TRUE));
+    cache.entries = (CacheEntry*)calloc(ENTRY_COUNT, sizeof(CacheEntry));
+    cache.ids = calloc(ENTRY_COUNT, sizeof(*cache.ids));
+    cache.writersDone = 0;
+    assert(cache.entries && cache.ids);
+
+    Writer writers[WRITER_COUNT];
+    pthread_t threads[WRITER_COUNT];
+    for (int i = 0; i < WRITER_COUNT; i++) {
+        writers[i].cache = &cache;
+        writers[i].writer = i;
+        assert(pthread_create(&threads[i], NULL, RunWriter, &writers[i]) == 0);
+    }
+
+    long long longest = 0;
+    DWORD lastCount = 0;
+    *reads = 0;
+    while (cache.writersDone < WRITER_COUNT) {
+        long long start = NowMicroseconds();
+        DWORD count = 0;
+        ULONGLONG totalSize = 0;
+        if (useSnapshots) {
+            CacheViewSnapshot* snapshot = AcquireCacheViewSnapshot(&cache.publisher);
+            count = snapshot->count;
+            for (DWORD i = 0; i < count; i++) totalSize += snapshot->rows[i].fileSize;
+            ReleaseCacheViewSnapshot(snapshot);
+        } else {
+            pthread_mutex_lock(&cache.lock);
+            count = cache.publisher.current->count;
+            for (DWORD i = 0; i < count; i++) totalSize += cache.publisher.current->rows[i].fileSize;
+            pthread_mutex_unlock(&cache.lock);
+        }
+        long long elapsed = NowMicroseconds() - start;
+        if (elapsed > longest) longest = elapsed;
+        (*reads)++;
+
+        // Every read sees whole batches, in publish order
+        assert(count % BATCH_SIZE == 0 && count >= lastCount);
+        assert(totalSize == count);
+        lastCount = count;
+
+        SleepMilliseconds(1);
+    }
+
+    for (int i = 0; i < WRITER_COUNT; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    CacheViewSnapshot* final = AcquireCacheViewSnapshot(&cache.publisher);
+    assert(final->count == ENTRY_COUNT);
+    for (int i = 0; i < ENTRY_COUNT; i += 97) {
+        assert(FindCacheViewRow(final, cache.ids[i]) != NULL);
+    }
+    ReleaseCacheViewSnapshot(final);
+
+    FreeCacheViewPublisher(&cache.publisher);
+    pthread_mutex_destroy(&cache.lock);
+    free(cache.entries);
+    free(cache.ids);
+    return longest;
+}
+
+void test_contention() {
+    printf("Running cache snapshot contention tests...\n");
+
+    int lockedReads = 0, snapshotReads = 0;
+    long long lockedWait = MeasureReads(FALSE, &lockedReads);
+    long long snapshotWait = MeasureReads(TRUE, &snapshotReads);
+    printf("  Longest UI read under the cache lock: %lld us (%d reads)\n", lockedWait, lockedReads);
+    printf("  Longest UI read from snapshots: %lld us (%d reads)\n", snapshotWait, snapshotReads);
+
+    // Snapshot reads never wait out a writer's batch
+    assert(snapshotWait < HOLD_MS * 1000);
+
+    printf("All cache snapshot contention tests passed!\n");
+}
+
+int main() {
+    test_publisher();
+    test_contention();
+    return 0;
+}
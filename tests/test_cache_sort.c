@@ -0,0 +1,153 @@
+#include "mock_windows.h"
+
+// Prevent inclusion of the full application header
+#define YOUTUBECACHER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <wctype.h>
+#include <assert.h>
+
+#include "../cache.h"
+#include "cache_duration.c"
+#include "../cachecolumns.c"
+#include "../cachesort.c"
+
+#define ENTRY_COUNT 500
+
+static wchar_t g_ids[ENTRY_COUNT][16];
+static wchar_t g_titles[ENTRY_COUNT][32];
+static wchar_t g_durations[ENTRY_COUNT][16];
+
+static void InitEntry(CacheEntry* entry, int i) {
+    // Deterministic pseudo-random keys with plenty of ties
+    unsigned int r = (unsigned int)i * 2654435761u;
+    swprintf(g_ids[i], 16, L"id%05d", i);
+    swprintf(g_titles[i], 32, L"%c%c title %d", L'a' + (r >> 8) % 5, L'A' + (r >> 12) % 3, i % 7);
+    swprintf(g_durations[i], 16, L"%u:%02u", (r >> 16) % 10, (r >> 4) % 60);
+
+    memset(entry, 0, sizeof(CacheEntry));
+    entry->videoId = g_ids[i];
+    entry->title = g_titles[i];
+    entry->duration = g_durations[i];
+    entry->fileSize = (ULONGLONG)((r >> 20) % 50) << 30; // Multiples of 1 GB, up to 49 GB
+}
+
+// The order must hold every row exactly once and be strictly increasing
+static void AssertSorted(const CacheSortOrder* sortOrder, const CacheColumns* columns) {
+    assert(sortOrder->valid);
+    assert(sortOrder->count == columns->count);
+    for (DWORD i = 1; i < sortOrder->count; i++) {
+        assert(CompareSortedEntries(sortOrder, columns, sortOrder->order[i - 1], sortOrder->order[i]) < 0);
+    }
+    for (DWORD row = 0; row < columns->count; row++) {
+        DWORD seen = 0;
+        for (DWORD i = 0; i < sortOrder->count; i++) {
+            if (sortOrder->order[i] == columns->owner[row]) seen++;
+        }
+        assert(seen == 1);
+    }
+}
+
+void test_build() {
+    printf("Running cache sort build tests...\n");
+
+    static CacheEntry entries[ENTRY_COUNT];
+    CacheColumns columns;
+    CacheSortOrder sortOrder;
+    assert(InitCacheColumns(&columns, ENTRY_COUNT));
+    InitCacheSortOrder(&sortOrder);
+    assert(!IsCacheSortOrderActive(&sortOrder));
+
+    // An empty cache sorts to an empty, valid order
+    assert(BuildCacheSortOrder(&sortOrder, &columns, CACHE_COLUMN_TITLE, TRUE));
+    assert(sortOrder.valid && sortOrder.count == 0);
+
+    for (int i = 0; i < ENTRY_COUNT; i++) {
+        InitEntry(&entries[i], i);
+        assert(AppendCacheColumnsRow(&columns, &entries[i]));
+    }
+
+    for (int column = CACHE_COLUMN_TITLE; column <= CACHE_COLUMN_SIZE; column++) {
+        assert(BuildCacheSortOrder(&sortOrder, &columns, column, TRUE));
+        AssertSorted(&sortOrder, &columns);
+        assert(BuildCacheSortOrder(&sortOrder, &columns, column, FALSE));
+        AssertSorted(&sortOrder, &columns);
+    }
+
+    // Descending reverses the column order but ties stay in video ID order
+    assert(BuildCacheSortOrder(&sortOrder, &columns, CACHE_COLUMN_SIZE, FALSE));
+    assert(columns.fileSize[sortOrder.order[0]->row] >= columns.fileSize[sortOrder.order[ENTRY_COUNT - 1]->row]);
+
+    // No sort column means no permutation is kept
+    assert(BuildCacheSortOrder(&sortOrder, &columns, CACHE_SORT_NONE, TRUE));
+    assert(!IsCacheSortOrderActive(&sortOrder) && sortOrder.count == 0);
+
+    FreeCacheSortOrder(&sortOrder);
+    FreeCacheColumns(&columns);
+
+    printf("All cache sort build tests passed!\n");
+}
+
+void test_incremental() {
+    printf("Running cache sort maintenance tests...\n");
+
+    static CacheEntry entries[ENTRY_COUNT];
+    CacheColumns columns;
+    CacheSortOrder sortOrder;
+    assert(InitCacheColumns(&columns, 0));
+    InitCacheSortOrder(&sortOrder);
+
+    // Start sorted with half the entries, then link the rest one at a time
+    for (int i = 0; i < ENTRY_COUNT / 2; i++) {
+        InitEntry(&entries[i], i);
+        assert(AppendCacheColumnsRow(&columns, &entries[i]));
+    }
+    assert(BuildCacheSortOrder(&sortOrder, &columns, CACHE_COLUMN_DURATION, TRUE));
+    for (int i = ENTRY_COUNT / 2; i < ENTRY_COUNT; i++) {
+        InitEntry(&entries[i], i);
+        assert(AppendCacheColumnsRow(&columns, &entries[i]));
+        assert(InsertCacheSortOrder(&sortOrder, &columns, &entries[i]));
+    }
+    AssertSorted(&sortOrder, &columns);
+
+    // Unlink every third entry: sort order first, then its row
+    for (int i = 0; i < ENTRY_COUNT; i += 3) {
+        RemoveCacheSortOrder(&sortOrder, &columns, &entries[i]);
+        RemoveCacheColumnsRow(&columns, &entries[i]);
+    }
+    AssertSorted(&sortOrder, &columns);
+
+    // In-place key change: remove with old keys, update the row, reinsert
+    CacheEntry* changed = &entries[1];
+    RemoveCacheSortOrder(&sortOrder, &columns, changed);
+    changed->duration = L"99:59:59";
+    UpdateCacheColumnsRow(&columns, changed);
+    assert(InsertCacheSortOrder(&sortOrder, &columns, changed));
+    AssertSorted(&sortOrder, &columns);
+    assert(sortOrder.order[sortOrder.count - 1] == changed);
+
+    // Removing an entry that is not in the order leaves it unchanged
+    DWORD count = sortOrder.count;
+    RemoveCacheSortOrder(&sortOrder, &columns, &entries[0]);
+    assert(sortOrder.count == count);
+
+    // Inserting while no sort is active is a no-op
+    CacheSortOrder inactive;
+    InitCacheSortOrder(&inactive);
+    assert(InsertCacheSortOrder(&inactive, &columns, &entries[2]));
+    assert(inactive.count == 0);
+
+    FreeCacheSortOrder(&sortOrder);
+    FreeCacheColumns(&columns);
+
+    printf("All cache sort maintenance tests passed!\n");
+}
+
+int main() {
+    test_build();
+    test_incremental();
+    return 0;
+}
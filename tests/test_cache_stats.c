@@ -0,0 +1,163 @@
+#include "mock_windows.h"
+
+// Prevent inclusion of the full application header
+#define YOUTUBECACHER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <assert.h>
+#include <pthread.h>
+
+#include "../cachestats.h"
+#include "../cachestats.c"
+
+#define GB (1024ull * 1024 * 1024)
+
+static CacheStatsItem MakeItem(ULONGLONG bytes, int subtitles, BOOL missing, BOOL damaged, BOOL inRoot) {
+    CacheStatsItem item;
+    MakeCacheStatsItem(&item, bytes, subtitles, missing, damaged, inRoot);
+    return item;
+}
+
+static BOOL SameStats(const CacheStats* a, const CacheStats* b) {
+    return memcmp(a, b, sizeof(CacheStats)) == 0;
+}
+
+void test_running_totals() {
+    printf("Running cache stats running total tests...\n");
+
+    CacheStatsCounter counter;
+    InitCacheStatsCounter(&counter);
+    CacheStatsItem none;
+    memset(&none, 0, sizeof(none));
+
+    // Three linked entries; sizes beyond 4 GB must not wrap
+    CacheStatsItem counted[3];
+    memset(counted, 0, sizeof(counted));
+    CacheStatsItem items[3] = {
+        MakeItem(5 * GB, 2, FALSE, FALSE, TRUE),
+        MakeItem(3 * GB, 0, FALSE, TRUE, FALSE),
+        MakeItem(0, 1, TRUE, FALSE, TRUE),
+    };
+    for (int i = 0; i < 3; i++) {
+        UpdateCacheStats(&counter, &counted[i], &items[i]);
+    }
+
+    CacheStats stats;
+    ReadCacheStats(&counter, &stats);
+    assert(stats.totalBytes == 8 * GB);
+    assert(stats.rootBytes == 5 * GB);
+    assert(stats.entries == 3 && stats.rootEntries == 2);
+    assert(stats.missingEntries == 1 && stats.damagedEntries == 1);
+    assert(stats.subtitledEntries == 2 && stats.subtitleFiles == 3);
+
+    CacheStats recount;
+    SumCacheStatsItems(counted, 3, &recount);
+    assert(SameStats(&stats, &recount));
+
+    // Changing an entry replaces its old contribution
+    CacheStatsItem found = MakeItem(1 * GB, 0, FALSE, FALSE, TRUE);
+    UpdateCacheStats(&counter, &counted[2], &found);
+    ReadCacheStats(&counter, &stats);
+    assert(stats.totalBytes == 9 * GB && stats.rootBytes == 6 * GB);
+    assert(stats.entries == 3 && stats.missingEntries == 0);
+    assert(stats.subtitledEntries == 1 && stats.subtitleFiles == 2);
+
+    // An unchanged entry is a no-op, without bumping the sequence
+    LONG sequence = counter.sequence;
+    UpdateCacheStats(&counter, &counted[2], &found);
+    assert(counter.sequence == sequence);
+
+    // Unlinking takes it out again; a second unlink changes nothing
+    UpdateCacheStats(&counter, &counted[1], &none);
+    UpdateCacheStats(&counter, &counted[1], &none);
+    ReadCacheStats(&counter, &stats);
+    assert(stats.totalBytes == 6 * GB && stats.entries == 2 && stats.damagedEntries == 0);
+    SumCacheStatsItems(counted, 3, &recount);
+    assert(SameStats(&stats, &recount));
+
+    UpdateCacheStats(&counter, &counted[0], &none);
+    UpdateCacheStats(&counter, &counted[2], &none);
+    ReadCacheStats(&counter, &stats);
+    CacheStats zero;
+    memset(&zero, 0, sizeof(zero));
+    assert(SameStats(&stats, &zero));
+
+    printf("All cache stats running total tests passed!\n");
+}
+
+void test_root_paths() {
+    printf("Running cache stats root path tests...\n");
+
+    assert(IsCacheRootPath(L"C:\\Videos", L"C:\\Videos\\a.mp4"));
+    assert(IsCacheRootPath(L"C:\\Videos\\", L"C:\\Videos\\sub\\a.mp4"));
+    assert(IsCacheRootPath(L"c:\\videos", L"C:\\Videos\\a.mp4"));
+    assert(!IsCacheRootPath(L"C:\\Videos", L"C:\\Videos2\\a.mp4"));
+    assert(!IsCacheRootPath(L"C:\\Videos", L"C:\\Videos"));
+    assert(!IsCacheRootPath(L"C:\\Videos", L"C:\\Videos\\"));
+    assert(!IsCacheRootPath(L"C:\\Videos", L"D:\\Videos\\a.mp4"));
+    assert(!IsCacheRootPath(NULL, L"C:\\Videos\\a.mp4"));
+    assert(!IsCacheRootPath(L"C:\\Videos", NULL));
+    assert(!IsCacheRootPath(L"", L"C:\\a.mp4"));
+
+    printf("All cache stats root path tests passed!\n");
+}
+
+// One writer flips an entry between two states while a reader checks that
+// every copy it takes is one of them, never a mix
+typedef struct {
+    CacheStatsCounter counter;
+    CacheStatsItem counted;
+    volatile LONG done;
+} Flipper;
+
+static void* RunFlipper(void* param) {
+    Flipper* flipper = (Flipper*)param;
+    CacheStatsItem small = MakeItem(1, 0, FALSE, FALSE, FALSE);
+    CacheStatsItem large = MakeItem(7 * GB, 3, TRUE, TRUE, TRUE);
+    for (int i = 0; i < 200000; i++) {
+        UpdateCacheStats(&flipper->counter, &flipper->counted, (i & 1) ? &large : &small);
+    }
+    InterlockedIncrement(&flipper->done);
+    return NULL;
+}
+
+void test_concurrent_reads() {
+    printf("Running cache stats concurrent read tests...\n");
+
+    Flipper flipper;
+    InitCacheStatsCounter(&flipper.counter);
+    memset(&flipper.counted, 0, sizeof(flipper.counted));
+    flipper.done = 0;
+
+    pthread_t thread;
+    assert(pthread_create(&thread, NULL, RunFlipper, &flipper) == 0);
+
+    int reads = 0;
+    while (!InterlockedCompareExchange(&flipper.done, 0, 0)) {
+        CacheStats stats;
+        ReadCacheStats(&flipper.counter, &stats);
+        if (stats.entries == 0) continue;
+        assert(stats.entries == 1);
+        if (stats.totalBytes == 1) {
+            assert(stats.rootBytes == 0 && stats.subtitleFiles == 0 && stats.missingEntries == 0);
+        } else {
+            assert(stats.totalBytes == 7 * GB && stats.rootBytes == 7 * GB);
+            assert(stats.subtitleFiles == 3 && stats.missingEntries == 1 && stats.damagedEntries == 1);
+        }
+        reads++;
+    }
+    pthread_join(thread, NULL);
+    printf("  %d consistent reads during the updates\n", reads);
+
+    printf("All cache stats concurrent read tests passed!\n");
+}
+
+int main() {
+    test_running_totals();
+    test_root_paths();
+    test_concurrent_reads();
+    return 0;
+}
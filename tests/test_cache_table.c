@@ -0,0 +1,185 @@
+#include "mock_windows.h"
+
+// Prevent inclusion of the full application header
+#define YOUTUBECACHER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <assert.h>
+
+#include "../cache.h"
+#include "../cachetable.h"
+#include "../cachetable.c"
+
+#define TEST_ENTRY_COUNT 5000
+
+static CacheEntry entries[TEST_ENTRY_COUNT];
+static wchar_t ids[TEST_ENTRY_COUNT][16];
+
+static void InitEntries(void) {
+    memset(entries, 0, sizeof(entries));
+    for (int i = 0; i < TEST_ENTRY_COUNT; i++) {
+        swprintf(ids[i], 16, L"vid%08d", i);
+        entries[i].videoId = ids[i];
+    }
+}
+
+void test_insert_find() {
+    printf("Running cache table insert/find tests...\n");
+
+    CacheHashTable table;
+    assert(InitCacheHashTable(&table, 0));
+    assert(table.capacity == CACHE_TABLE_MIN_CAPACITY);
+    assert(CacheHashTableFind(&table, L"missing") == NULL);
+
+    for (int i = 0; i < TEST_ENTRY_COUNT; i++) {
+        assert(CacheHashTableInsert(&table, &entries[i]));
+        // Load factor never exceeds the limit
+        assert((ULONGLONG)table.count * 100 <= (ULONGLONG)table.capacity * CACHE_TABLE_MAX_LOAD_PERCENT);
+    }
+    assert(table.count == TEST_ENTRY_COUNT);
+    assert((table.capacity & (table.capacity - 1)) == 0);
+
+    for (int i = 0; i < TEST_ENTRY_COUNT; i++) {
+        assert(CacheHashTableFind(&table, ids[i]) == &entries[i]);
+    }
+    assert(CacheHashTableFind(&table, L"vid99999999") == NULL);
+
+    // Re-inserting a key replaces the entry without growing the count
+    CacheEntry replacement;
+    memset(&replacement, 0, sizeof(replacement));
+    replacement.videoId = L"vid00000042";
+    assert(CacheHashTableInsert(&table, &replacement));
+    assert(table.count == TEST_ENTRY_COUNT);
+    assert(CacheHashTableFind(&table, L"vid00000042") == &replacement);
+
+    FreeCacheHashTable(&table);
+    assert(table.slots == NULL && table.capacity == 0 && table.count == 0);
+
+    printf("All cache table insert/find tests passed!\n");
+}
+
+void test_remove() {
+    printf("Running cache table removal tests...\n");
+
+    CacheHashTable table;
+    assert(InitCacheHashTable(&table, TEST_ENTRY_COUNT));
+    DWORD reservedCapacity = table.capacity;
+    for (int i = 0; i < TEST_ENTRY_COUNT; i++) {
+        assert(CacheHashTableInsert(&table, &entries[i]));
+    }
+    // Reserving up front avoids any rehash during the bulk insert
+    assert(table.capacity == reservedCapacity);
+
+    // Remove every third entry; the rest must stay reachable after backward shifts
+    for (int i = 0; i < TEST_ENTRY_COUNT; i += 3) {
+        assert(CacheHashTableRemove(&table, ids[i]) == &entries[i]);
+        assert(CacheHashTableRemove(&table, ids[i]) == NULL);
+    }
+    for (int i = 0; i < TEST_ENTRY_COUNT; i++) {
+        CacheEntry* expected = (i % 3 == 0) ? NULL : &entries[i];
+        assert(CacheHashTableFind(&table, ids[i]) == expected);
+    }
+
+    // Removed keys can be inserted again
+    for (int i = 0; i < TEST_ENTRY_COUNT; i += 3) {
+        assert(CacheHashTableInsert(&table, &entries[i]));
+    }
+    assert(table.count == TEST_ENTRY_COUNT);
+    for (int i = 0; i < TEST_ENTRY_COUNT; i++) {
+        assert(CacheHashTableFind(&table, ids[i]) == &entries[i]);
+    }
+
+    // Drain completely
+    for (int i = TEST_ENTRY_COUNT - 1; i >= 0; i--) {
+        assert(CacheHashTableRemove(&table, ids[i]) == &entries[i]);
+    }
+    assert(table.count == 0);
+    for (DWORD i = 0; i < table.capacity; i++) {
+        assert(table.slots[i].entry == NULL);
+    }
+
+    ClearCacheHashTable(&table);
+    assert(table.count == 0 && table.capacity == reservedCapacity);
+    FreeCacheHashTable(&table);
+
+    printf("All cache table removal tests passed!\n");
+}
+
+void test_wraparound() {
+    printf("Running cache table wraparound tests...\n");
+
+    // Fill a minimum-size table to its limit so probe runs wrap past the last slot
+    CacheHashTable table;
+    assert(InitCacheHashTable(&table, 0));
+    int limit = (CACHE_TABLE_MIN_CAPACITY * CACHE_TABLE_MAX_LOAD_PERCENT) / 100;
+    for (int i = 0; i < limit; i++) {
+        assert(CacheHashTableInsert(&table, &entries[i]));
+    }
+    assert(table.capacity == CACHE_TABLE_MIN_CAPACITY);
+
+    for (int round = 0; round < 50; round++) {
+        for (int i = round % 2; i < limit; i += 2) {
+            assert(CacheHashTableRemove(&table, ids[i]) == &entries[i]);
+        }
+        for (int i = 0; i < limit; i++) {
+            CacheEntry* expected = ((i - round) % 2 == 0) ? NULL : &entries[i];
+            assert(CacheHashTableFind(&table, ids[i]) == expected);
+        }
+        for (int i = round % 2; i < limit; i += 2) {
+            assert(CacheHashTableInsert(&table, &entries[i]));
+        }
+    }
+    assert(table.count == (DWORD)limit);
+    FreeCacheHashTable(&table);
+
+    printf("All cache table wraparound tests passed!\n");
+}
+
+// Index lines for the same video: the last one wins and the rest keep their order
+void test_keep_last() {
+    printf("Running cache table keep-last tests...\n");
+
+    CacheEntry lines[6];
+    const wchar_t* lineIds[6] = { L"a", L"b", L"a", L"c", L"b", L"a" };
+    CacheEntry* order[6];
+    memset(lines, 0, sizeof(lines));
+    for (int i = 0; i < 6; i++) {
+        lines[i].videoId = (wchar_t*)lineIds[i];
+        order[i] = &lines[i];
+    }
+
+    assert(KeepLastCacheEntries(order, 6) == 3);
+    assert(order[0] == &lines[3]);  // c
+    assert(order[1] == &lines[4]);  // b, its second line
+    assert(order[2] == &lines[5]);  // a, its third line
+    // The replaced lines follow, in file order
+    assert(order[3] == &lines[0]);
+    assert(order[4] == &lines[1]);
+    assert(order[5] == &lines[2]);
+
+    // Without duplicates nothing moves
+    CacheEntry* unique[TEST_ENTRY_COUNT];
+    for (int i = 0; i < TEST_ENTRY_COUNT; i++) {
+        unique[i] = &entries[i];
+    }
+    assert(KeepLastCacheEntries(unique, TEST_ENTRY_COUNT) == TEST_ENTRY_COUNT);
+    for (int i = 0; i < TEST_ENTRY_COUNT; i++) {
+        assert(unique[i] == &entries[i]);
+    }
+    assert(KeepLastCacheEntries(unique, 1) == 1);
+    assert(KeepLastCacheEntries(unique, 0) == 0);
+
+    printf("All cache table keep-last tests passed!\n");
+}
+
+int main() {
+    InitEntries();
+    test_insert_find();
+    test_remove();
+    test_wraparound();
+    test_keep_last();
+    return 0;
+}
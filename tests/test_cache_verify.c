@@ -0,0 +1,88 @@
+#include "mock_windows.h"
+
+// Prevent inclusion of the full application header
+#define YOUTUBECACHER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <assert.h>
+
+#include "../cacheverify.h"
+#include "../cacheverify.c"
+
+#define TICKS_PER_MS 10000ull
+
+static CacheVerifyChecksum MakeChecksum(ULONGLONG writeTime, ULONGLONG hash) {
+    CacheVerifyChecksum checksum;
+    checksum.writeTime = writeTime;
+    checksum.hash = hash;
+    return checksum;
+}
+
+void test_checksum() {
+    printf("Running integrity checksum tests...\n");
+
+    CacheVerifyChecksum stored = MakeChecksum(1000, 0xABCD);
+
+    // Same file, same contents
+    CacheVerifyChecksum current = MakeChecksum(1000, 0xABCD);
+    assert(CheckCacheVerifyChecksum(&stored, &current) == CACHE_VERIFY_OK);
+
+    // Contents changed under an unchanged write time
+    current = MakeChecksum(1000, 0xABCE);
+    assert(CheckCacheVerifyChecksum(&stored, &current) == CACHE_VERIFY_DAMAGED);
+
+    // A new write replaces the checksum, whatever the contents
+    current = MakeChecksum(2000, 0x1234);
+    assert(CheckCacheVerifyChecksum(&stored, &current) == CACHE_VERIFY_CHANGED);
+    current = MakeChecksum(2000, 0xABCD);
+    assert(CheckCacheVerifyChecksum(&stored, &current) == CACHE_VERIFY_CHANGED);
+
+    // Without a checksum the first hash becomes it, even one taken at the stored write time
+    CacheVerifyChecksum none = MakeChecksum(1000, 0);
+    current = MakeChecksum(1000, 0xABCD);
+    assert(CheckCacheVerifyChecksum(&none, &current) == CACHE_VERIFY_BASELINE);
+    assert(CheckCacheVerifyChecksum(NULL, &current) == CACHE_VERIFY_BASELINE);
+
+    printf("All integrity checksum tests passed!\n");
+}
+
+void test_schedule() {
+    printf("Running integrity schedule tests...\n");
+
+    ULONGLONG now = 133000000000000000ull; // A FILETIME in 2022
+
+    // Never checked is due before anything else
+    assert(GetCacheVerifyDueTime(0) == 0);
+    assert(GetCacheVerifyWait(GetCacheVerifyDueTime(0), now) == 0);
+
+    // Checked just now: due after the interval, waited for in capped steps
+    assert(GetCacheVerifyDueTime(now) == now + CACHE_VERIFY_INTERVAL);
+    assert(GetCacheVerifyWait(GetCacheVerifyDueTime(now), now) == CACHE_VERIFY_MAX_WAIT_MS);
+    assert(GetCacheVerifyWait(now + 1500 * TICKS_PER_MS, now) == 1500);
+    assert(GetCacheVerifyWait(now, now) == 0);
+    assert(GetCacheVerifyWait(now - 1, now) == 0);
+
+    // Checked longer ago than the interval is overdue
+    assert(GetCacheVerifyWait(GetCacheVerifyDueTime(now - CACHE_VERIFY_INTERVAL - 1), now) == 0);
+
+    // An unreadable file is due again after the retry delay, not before other overdue files
+    ULONGLONG retry = GetCacheVerifyRetryTime(now);
+    assert(retry != 0);
+    assert(GetCacheVerifyDueTime(retry) == now + CACHE_VERIFY_RETRY);
+    assert(GetCacheVerifyDueTime(retry) > GetCacheVerifyDueTime(now - CACHE_VERIFY_INTERVAL));
+
+    // A clock before the epoch of the schedule still never records 0
+    assert(GetCacheVerifyRetryTime(0) != 0);
+    assert(GetCacheVerifyRetryTime(CACHE_VERIFY_INTERVAL - CACHE_VERIFY_RETRY) != 0);
+
+    printf("All integrity schedule tests passed!\n");
+}
+
+int main() {
+    test_checksum();
+    test_schedule();
+    return 0;
+}
@@ -0,0 +1,328 @@
+#include "mock_windows.h"
+
+// Prevent inclusion of the full application header
+#define YOUTUBECACHER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <assert.h>
+
+#include "../cache.h"
+#include "../cacheview.h"
+#include "cache_duration.c"
+#include "../stringarena.c"
+#include "../cachecolumns.c"
+#include "../cachesort.c"
+#include "../cacheview.c"
+
+static void InitEntry(CacheEntry* entry, wchar_t* id, wchar_t* title, wchar_t* duration, wchar_t* file, ULONGLONG size) {
+    memset(entry, 0, sizeof(CacheEntry));
+    entry->videoId = id;
+    entry->title = title;
+    entry->duration = duration;
+    entry->mainVideoFile = file;
+    entry->fileSize = size;
+}
+
+// Keep rows whose file name does not contain "gone"
+static BOOL KeepPresentFiles(const CacheViewRow* row, void* context) {
+    int* calls = (int*)context;
+    (*calls)++;
+    return row->mainVideoFile && !wcsstr(row->mainVideoFile, L"gone");
+}
+
+void test_snapshot() {
+    printf("Running cache view snapshot tests...\n");
+
+    wchar_t title[] = L"Mutable Title";
+    CacheEntry e[4];
+    InitEntry(&e[0], L"id0", title, L"3:00", L"C:\\v\\a.mp4", 30);
+    InitEntry(&e[1], L"id1", NULL, NULL, L"C:\\v\\gone.mp4", 10);
+    InitEntry(&e[2], NULL, L"No ID", L"1:00", L"C:\\v\\c.mp4", 5);
+    InitEntry(&e[3], L"id3", L"alpha", L"0:10", L"C:\\v\\d.mp4", 7);
+    CacheEntry* order[4] = { &e[3], &e[0], &e[1], &e[2] };
+
+    CacheViewSnapshot* snapshot = BuildCacheViewSnapshot(order, 4, NULL, CACHE_SORT_NONE, TRUE);
+    assert(snapshot && snapshot->refCount == 1);
+
+    // Entries without an ID are never listed; the rest keep the given order
+    assert(snapshot->count == 3);
+    assert(wcscmp(snapshot->rows[0].videoId, L"id3") == 0);
+    assert(wcscmp(snapshot->rows[1].videoId, L"id0") == 0);
+    assert(wcscmp(snapshot->rows[2].videoId, L"id1") == 0);
+    assert(snapshot->rows[1].fileSize == 30);
+
+    // Rows own copies, so later entry changes do not show through
+    title[0] = L'X';
+    assert(wcscmp(GetCacheViewCellText(snapshot, 1, CACHE_COLUMN_TITLE), L"Mutable Title") == 0);
+    assert(snapshot->rows[1].title != e[0].title);
+
+    // Missing values and out-of-range cells use the list's placeholders
+    assert(wcscmp(GetCacheViewCellText(snapshot, 2, CACHE_COLUMN_TITLE), L"Unknown Title") == 0);
+    assert(wcscmp(GetCacheViewCellText(snapshot, 2, CACHE_COLUMN_DURATION), L"Unknown") == 0);
+    assert(wcscmp(GetCacheViewCellText(snapshot, 0, CACHE_COLUMN_DURATION), L"0:10") == 0);
+    assert(wcscmp(GetCacheViewCellText(snapshot, 3, CACHE_COLUMN_TITLE), L"") == 0);
+    assert(wcscmp(GetCacheViewCellText(snapshot, 0, CACHE_COLUMN_SIZE), L"") == 0);
+    assert(wcscmp(GetCacheViewCellText(NULL, 0, CACHE_COLUMN_TITLE), L"") == 0);
+    assert(GetCacheViewRow(snapshot, 3) == NULL);
+
+    // Filtering compacts in place and keeps order
+    int calls = 0;
+    assert(FilterCacheViewSnapshot(snapshot, KeepPresentFiles, &calls) == 2);
+    assert(calls == 3);
+    assert(wcscmp(snapshot->rows[0].videoId, L"id3") == 0);
+    assert(wcscmp(snapshot->rows[1].videoId, L"id0") == 0);
+    assert(FilterCacheViewSnapshot(snapshot, NULL, NULL) == 2);
+
+    // A retained snapshot outlives the list's reference
+    RetainCacheViewSnapshot(snapshot);
+    ReleaseCacheViewSnapshot(snapshot);
+    assert(snapshot->refCount == 1);
+    assert(wcscmp(GetCacheViewRow(snapshot, 0)->videoId, L"id3") == 0);
+    ReleaseCacheViewSnapshot(snapshot);
+
+    // An empty cache gives an empty snapshot
+    snapshot = BuildCacheViewSnapshot(NULL, 0, NULL, CACHE_SORT_NONE, TRUE);
+    assert(snapshot && snapshot->count == 0);
+    assert(GetCacheViewRow(snapshot, 0) == NULL);
+    ReleaseCacheViewSnapshot(snapshot);
+
+    printf("All cache view snapshot tests passed!\n");
+}
+
+void test_find() {
+    printf("Running cache view find tests...\n");
+
+    CacheEntry e[4];
+    InitEntry(&e[0], L"id0", L"Banana", L"1:00", L"a.mp4", 1);
+    InitEntry(&e[1], L"id1", L"apple", L"1:00", L"b.mp4", 1);
+    InitEntry(&e[2], L"id2", L"Bandana", L"1:00", L"c.mp4", 1);
+    InitEntry(&e[3], L"id3", NULL, L"1:00", L"d.mp4", 1);
+    CacheEntry* order[4] = { &e[0], &e[1], &e[2], &e[3] };
+
+    CacheViewSnapshot* snapshot = BuildCacheViewSnapshot(order, 4, NULL, CACHE_SORT_NONE, TRUE);
+    assert(snapshot && snapshot->count == 4);
+
+    // Prefix match is case-insensitive and starts at the given row
+    assert(FindCacheViewRowByPrefix(snapshot, L"ban", 0, FALSE) == 0);
+    assert(FindCacheViewRowByPrefix(snapshot, L"ban", 1, FALSE) == 2);
+    assert(FindCacheViewRowByPrefix(snapshot, L"BANANA", 1, FALSE) == -1);
+    assert(FindCacheViewRowByPrefix(snapshot, L"BANANA", 1, TRUE) == 0);
+    assert(FindCacheViewRowByPrefix(snapshot, L"A", 2, TRUE) == 1);
+    assert(FindCacheViewRowByPrefix(snapshot, L"unknown", 0, FALSE) == 3);
+    assert(FindCacheViewRowByPrefix(snapshot, L"zzz", 0, TRUE) == -1);
+    assert(FindCacheViewRowByPrefix(snapshot, L"b", 10, FALSE) == -1);
+    assert(FindCacheViewRowByPrefix(snapshot, L"b", 10, TRUE) == 0);
+    assert(FindCacheViewRowByPrefix(NULL, L"b", 0, TRUE) == -1);
+
+    ReleaseCacheViewSnapshot(snapshot);
+
+    printf("All cache view find tests passed!\n");
+}
+
+void test_large() {
+    printf("Running cache view large snapshot tests...\n");
+
+    const DWORD count = 100000;
+    CacheEntry* entries = (CacheEntry*)malloc(count * sizeof(CacheEntry));
+    CacheEntry** order = (CacheEntry**)malloc(count * sizeof(CacheEntry*));
+    wchar_t (*ids)[16] = malloc(count * sizeof(*ids));
+    assert(entries && order && ids);
+
+    for (DWORD i = 0; i < count; i++) {
+        swprintf(ids[i], 16, L"id%06lu", (unsigned long)i);
+        InitEntry(&entries[i], ids[i], L"A fairly ordinary video title", L"12:34", L"C:\\Downloads\\video.mp4", i);
+        order[count - 1 - i] = &entries[i];
+    }
+
+    CacheViewSnapshot* snapshot = BuildCacheViewSnapshot(order, count, NULL, CACHE_SORT_NONE, TRUE);
+    assert(snapshot && snapshot->count == count);
+    assert(wcscmp(snapshot->rows[0].videoId, L"id099999") == 0);
+    assert(wcscmp(snapshot->rows[count - 1].videoId, L"id000000") == 0);
+    assert(snapshot->rows[10].fileSize == count - 11);
+    ReleaseCacheViewSnapshot(snapshot);
+
+    free(ids);
+    free(order);
+    free(entries);
+
+    printf("All cache view large snapshot tests passed!\n");
+}
+
+#define APPLY_ENTRIES 200
+
+static wchar_t g_ids[APPLY_ENTRIES][16];
+static wchar_t g_titles[APPLY_ENTRIES][32];
+static wchar_t g_durations[APPLY_ENTRIES][16];
+
+static void InitApplyEntry(CacheEntry* entry, int i) {
+    unsigned int r = (unsigned int)i * 2654435761u;
+    swprintf(g_ids[i], 16, L"id%05d", i);
+    swprintf(g_titles[i], 32, L"%c title %d", L'a' + (r >> 8) % 5, i % 7);
+    swprintf(g_durations[i], 16, L"%u:%02u", (r >> 16) % 10, (r >> 4) % 60);
+    InitEntry(entry, g_ids[i], g_titles[i], g_durations[i], L"C:\\v\\file.mp4", (r >> 20) % 50);
+}
+
+// Build the patch for a batch of changed IDs (sorted) from the entries that are still linked
+static CacheViewSnapshot* BuildPatch(const wchar_t** ids, DWORD idCount, CacheEntry* entries, BOOL* linked,
+                                     const CacheColumns* columns, int sortColumn, BOOL ascending) {
+    CacheEntry* patchEntries[APPLY_ENTRIES];
+    DWORD count = 0;
+    for (DWORD i = 0; i < idCount; i++) {
+        for (int e = 0; e < APPLY_ENTRIES; e++) {
+            if (linked[e] && wcscmp(entries[e].videoId, ids[i]) == 0) patchEntries[count++] = &entries[e];
+        }
+    }
+    return BuildCacheViewSnapshot(patchEntries, count, columns, sortColumn, ascending);
+}
+
+static void AssertSameRows(const CacheViewSnapshot* a, const CacheViewSnapshot* b) {
+    assert(a->count == b->count);
+    for (DWORD i = 0; i < a->count; i++) {
+        assert(wcscmp(a->rows[i].videoId, b->rows[i].videoId) == 0);
+        assert(wcscmp(a->rows[i].title, b->rows[i].title) == 0);
+        assert(a->rows[i].fileSize == b->rows[i].fileSize);
+    }
+}
+
+static int CompareIdPointers(const void* a, const void* b) {
+    return wcscmp(*(const wchar_t* const*)a, *(const wchar_t* const*)b);
+}
+
+// Apply rounds of removals, size changes and additions as deltas and compare
+// with a snapshot rebuilt from scratch after each round
+static void RunApplyRounds(int sortColumn, BOOL ascending) {
+    static CacheEntry entries[APPLY_ENTRIES];
+    BOOL linked[APPLY_ENTRIES] = {0};
+    CacheColumns columns;
+    CacheSortOrder sortOrder;
+    assert(InitCacheColumns(&columns, 0));
+    InitCacheSortOrder(&sortOrder);
+
+    // Start with the first half linked; new entries are linked at the head
+    CacheEntry* listOrder[APPLY_ENTRIES];
+    DWORD listCount = 0;
+    for (int i = APPLY_ENTRIES / 2 - 1; i >= 0; i--) {
+        InitApplyEntry(&entries[i], i);
+        assert(AppendCacheColumnsRow(&columns, &entries[i]));
+        linked[i] = TRUE;
+    }
+    for (int i = 0; i < APPLY_ENTRIES / 2; i++) listOrder[listCount++] = &entries[i];
+
+    if (sortColumn != CACHE_SORT_NONE) {
+        assert(BuildCacheSortOrder(&sortOrder, &columns, sortColumn, ascending));
+    }
+    CacheViewSnapshot* current = sortColumn != CACHE_SORT_NONE
+        ? BuildCacheViewSnapshot(sortOrder.order, sortOrder.count, &columns, sortColumn, ascending)
+        : BuildCacheViewSnapshot(listOrder, listCount, &columns, CACHE_SORT_NONE, TRUE);
+    assert(current);
+
+    int nextNew = APPLY_ENTRIES / 2;
+    for (int round = 0; round < 12; round++) {
+        const wchar_t* ids[16];
+        DWORD idCount = 0;
+
+        // Remove one entry, resize another, add a new one
+        int removed = round * 7 % (APPLY_ENTRIES / 2);
+        if (linked[removed]) {
+            RemoveCacheSortOrder(&sortOrder, &columns, &entries[removed]);
+            RemoveCacheColumnsRow(&columns, &entries[removed]);
+            linked[removed] = FALSE;
+            for (DWORD i = 0; i < listCount; i++) {
+                if (listOrder[i] == &entries[removed]) {
+                    memmove(&listOrder[i], &listOrder[i + 1], (listCount - i - 1) * sizeof(CacheEntry*));
+                    listCount--;
+                    break;
+                }
+            }
+            ids[idCount++] = entries[removed].videoId;
+        }
+
+        int resized = (round * 13 + 5) % (APPLY_ENTRIES / 2);
+        if (linked[resized]) {
+            RemoveCacheSortOrder(&sortOrder, &columns, &entries[resized]);
+            entries[resized].fileSize += 1000 + round;
+            UpdateCacheColumnsRow(&columns, &entries[resized]);
+            InsertCacheSortOrder(&sortOrder, &columns, &entries[resized]);
+            ids[idCount++] = entries[resized].videoId;
+        }
+
+        InitApplyEntry(&entries[nextNew], nextNew);
+        assert(AppendCacheColumnsRow(&columns, &entries[nextNew]));
+        InsertCacheSortOrder(&sortOrder, &columns, &entries[nextNew]);
+        linked[nextNew] = TRUE;
+        memmove(&listOrder[1], &listOrder[0], listCount * sizeof(CacheEntry*));
+        listOrder[0] = &entries[nextNew];
+        listCount++;
+        ids[idCount++] = entries[nextNew].videoId;
+        nextNew++;
+
+        qsort(ids, idCount, sizeof(ids[0]), CompareIdPointers);
+        CacheViewSnapshot* patch = BuildPatch(ids, idCount, entries, linked, &columns, sortColumn, ascending);
+        assert(patch);
+        CacheViewSnapshot* next = ApplyCacheViewChanges(current, ids, idCount, patch);
+        assert(next);
+        assert(next->arenaCount <= CACHE_VIEW_MAX_ARENAS);
+        ReleaseCacheViewSnapshot(patch);
+        ReleaseCacheViewSnapshot(current);
+        current = next;
+
+        CacheViewSnapshot* expected = sortColumn != CACHE_SORT_NONE
+            ? BuildCacheViewSnapshot(sortOrder.order, sortOrder.count, &columns, sortColumn, ascending)
+            : BuildCacheViewSnapshot(listOrder, listCount, &columns, CACHE_SORT_NONE, TRUE);
+        assert(expected);
+        AssertSameRows(current, expected);
+        ReleaseCacheViewSnapshot(expected);
+    }
+
+    // Compaction kept the arena count bounded across the rounds
+    assert(current->arenaCount < 12);
+
+    ReleaseCacheViewSnapshot(current);
+    FreeCacheSortOrder(&sortOrder);
+    FreeCacheColumns(&columns);
+}
+
+void test_apply() {
+    printf("Running cache view delta tests...\n");
+
+    RunApplyRounds(CACHE_SORT_NONE, TRUE);
+    RunApplyRounds(CACHE_COLUMN_TITLE, TRUE);
+    RunApplyRounds(CACHE_COLUMN_SIZE, FALSE);
+    RunApplyRounds(CACHE_COLUMN_DURATION, TRUE);
+
+    // Patches from a different order are refused so the caller rebuilds
+    CacheEntry e;
+    InitEntry(&e, L"id0", L"Title", L"1:00", L"a.mp4", 1);
+    CacheEntry* one[1] = { &e };
+    CacheViewSnapshot* base = BuildCacheViewSnapshot(one, 1, NULL, CACHE_COLUMN_TITLE, TRUE);
+    CacheViewSnapshot* patch = BuildCacheViewSnapshot(one, 1, NULL, CACHE_COLUMN_SIZE, TRUE);
+    const wchar_t* ids[1] = { L"id0" };
+    assert(ApplyCacheViewChanges(base, ids, 1, patch) == NULL);
+    ReleaseCacheViewSnapshot(patch);
+
+    // Removing the last row leaves an empty snapshot
+    patch = BuildCacheViewSnapshot(NULL, 0, NULL, CACHE_COLUMN_TITLE, TRUE);
+    CacheViewSnapshot* next = ApplyCacheViewChanges(base, ids, 1, patch);
+    assert(next && next->count == 0);
+    ReleaseCacheViewSnapshot(next);
+    ReleaseCacheViewSnapshot(patch);
+
+    // The base stays usable after a derived snapshot is released
+    assert(wcscmp(GetCacheViewCellText(base, 0, CACHE_COLUMN_TITLE), L"Title") == 0);
+    assert(FindCacheViewRowById(base, L"id0") == 0);
+    assert(FindCacheViewRowById(base, L"id1") == -1);
+    ReleaseCacheViewSnapshot(base);
+
+    printf("All cache view delta tests passed!\n");
+}
+
+int main() {
+    test_snapshot();
+    test_find();
+    test_large();
+    test_apply();
+    return 0;
+}
@@ -0,0 +1,291 @@
+#include "mock_windows.h"
+
+// Prevent inclusion of the full application header
+#define YOUTUBECACHER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <assert.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#ifndef INFINITE
+#define INFINITE 0xFFFFFFFF
+#endif
+
+// The watch loop needs a clock that moves
+static DWORD TestTickCount(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (DWORD)(now.tv_sec * 1000 + now.tv_nsec / 1000000);
+}
+#define GetTickCount TestTickCount
+
+#include "../cachewatch.h"
+#include "../cachewatch.c"
+#include "../cachewatch_inotify.c"
+
+// Collects what the queue applies, joined by spaces, one string per batch
+typedef struct {
+    wchar_t batches[8][512];
+    int batchCount;
+    int rescans;
+    pthread_mutex_t lock;
+} Applied;
+
+static int ComparePaths(const void* a, const void* b) {
+    return wcscmp(*(const wchar_t* const*)a, *(const wchar_t* const*)b);
+}
+
+static void Apply(void* context, wchar_t* const* paths, DWORD count, BOOL rescan) {
+    Applied* applied = (Applied*)context;
+    pthread_mutex_lock(&applied->lock);
+    if (rescan) {
+        assert(paths == NULL && count == 0);
+        applied->rescans++;
+    } else if (applied->batchCount < 8) {
+        // Sorted, as the order of paths within a batch does not matter
+        qsort((void*)paths, count, sizeof(wchar_t*), ComparePaths);
+        wchar_t* batch = applied->batches[applied->batchCount++];
+        batch[0] = L'\0';
+        for (DWORD i = 0; i < count; i++) {
+            if (i > 0) wcscat(batch, L" ");
+            wcscat(batch, paths[i]);
+        }
+    }
+    pthread_mutex_unlock(&applied->lock);
+}
+
+static void InitApplied(Applied* applied) {
+    memset(applied, 0, sizeof(Applied));
+    pthread_mutex_init(&applied->lock, NULL);
+}
+
+void test_debounce() {
+    printf("Running watch debounce tests...\n");
+
+    Applied applied;
+    InitApplied(&applied);
+    CacheWatchQueue queue;
+    InitCacheWatchQueue(&queue, 100);
+
+    // Nothing pending: wait forever, apply nothing
+    assert(GetCacheWatchTimeout(&queue, 0) == INFINITE);
+    assert(!FlushCacheWatchQueue(&queue, 0, Apply, &applied));
+
+    PushCacheWatchPath(&queue, L"a.mp4", 1000);
+    PushCacheWatchPath(&queue, L"b.part", 1040);
+    assert(GetCacheWatchTimeout(&queue, 1050) == 50);
+
+    // Reports of the same path, in any case, restart its wait
+    PushCacheWatchPath(&queue, L"A.MP4", 1090);
+    assert(queue.count == 2);
+    assert(GetCacheWatchTimeout(&queue, 1100) == 40);
+
+    // Only quiet paths are applied
+    assert(FlushCacheWatchQueue(&queue, 1140, Apply, &applied));
+    assert(applied.batchCount == 1 && wcscmp(applied.batches[0], L"b.part") == 0);
+    assert(queue.count == 1);
+    assert(!FlushCacheWatchQueue(&queue, 1150, Apply, &applied));
+    assert(FlushCacheWatchQueue(&queue, 1190, Apply, &applied));
+    assert(applied.batchCount == 2 && wcscmp(applied.batches[1], L"a.mp4") == 0);
+    assert(queue.count == 0);
+
+    // Paths settling together are applied in one batch
+    PushCacheWatchPath(&queue, L"sub\\x.mp4", 2000);
+    PushCacheWatchPath(&queue, L"x.mp4", 2001);
+    PushCacheWatchPath(&queue, L"x.en.vtt", 2002);
+    assert(FlushCacheWatchQueue(&queue, 2500, Apply, &applied));
+    assert(applied.batchCount == 3 && wcscmp(applied.batches[2], L"sub\\x.mp4 x.en.vtt x.mp4") == 0);
+
+    // Tick counts wrap around
+    PushCacheWatchPath(&queue, L"wrap.mp4", 0xFFFFFFF0u);
+    assert(GetCacheWatchTimeout(&queue, 0xFFFFFFFAu) == 90);
+    assert(GetCacheWatchTimeout(&queue, 0x10u) == 68);
+    assert(!FlushCacheWatchQueue(&queue, 0x10u, Apply, &applied));
+    assert(FlushCacheWatchQueue(&queue, 0x60u, Apply, &applied));
+    assert(applied.batchCount == 4 && wcscmp(applied.batches[3], L"wrap.mp4") == 0);
+
+    // Too many paths turn into one rescan, which absorbs further reports
+    wchar_t path[32];
+    for (int i = 0; i <= CACHE_WATCH_MAX_PENDING; i++) {
+        swprintf(path, 32, L"file%d.mp4", i);
+        PushCacheWatchPath(&queue, path, 3000);
+    }
+    assert(queue.rescan && queue.count == 0);
+    PushCacheWatchPath(&queue, L"late.mp4", 3000);
+    assert(queue.count == 0);
+    assert(GetCacheWatchTimeout(&queue, 3000) == 0);
+    assert(FlushCacheWatchQueue(&queue, 3000, Apply, &applied));
+    assert(applied.rescans == 1 && applied.batchCount == 4);
+    assert(!queue.rescan);
+
+    FreeCacheWatchQueue(&queue);
+
+    printf("All watch debounce tests passed!\n");
+}
+
+// Gather what one wait reports
+static void Collect(void* context, const wchar_t* path) {
+    wchar_t* reported = (wchar_t*)context;
+    if (wcsstr(reported, path)) return;
+    if (reported[0]) wcscat(reported, L" ");
+    wcscat(reported, path);
+}
+
+// Wait until the backend has reported every expected path
+static BOOL WaitForPaths(CacheWatchBackend* backend, const wchar_t* const* expected, int count) {
+    static wchar_t reported[2048];
+    reported[0] = L'\0';
+    for (int round = 0; round < 20; round++) {
+        int found = 0;
+        for (int i = 0; i < count; i++) {
+            if (wcsstr(reported, expected[i])) found++;
+        }
+        if (found == count) return TRUE;
+        int result = WaitCacheWatchBackend(backend, 100, Collect, reported);
+        assert(result == CACHE_WATCH_EVENTS || result == CACHE_WATCH_TIMEOUT);
+    }
+    fprintf(stderr, "reported: %ls\n", reported);
+    return FALSE;
+}
+
+static void WriteFile(const char* path) {
+    FILE* file = fopen(path, "wb");
+    assert(file);
+    fputs("data", file);
+    fclose(file);
+}
+
+static char root[64];
+
+static void MakePath(char* buffer, const char* relative) {
+    snprintf(buffer, 256, "%s/%s", root, relative);
+}
+
+void test_inotify_backend() {
+    printf("Running inotify watch backend tests...\n");
+
+    wchar_t wideRoot[64];
+    mbstowcs(wideRoot, root, 64);
+    CacheWatchBackend* backend = OpenCacheWatchBackend(wideRoot);
+    assert(backend);
+    assert(OpenCacheWatchBackend(L"/nonexistent/youtubecacher") == NULL);
+
+    char path[256], target[256];
+
+    // Files written and renamed in the root
+    MakePath(path, "abcdefghijk.mp4.part");
+    WriteFile(path);
+    MakePath(target, "abcdefghijk.mp4");
+    assert(rename(path, target) == 0);
+    const wchar_t* const renamed[] = { L"abcdefghijk.mp4.part", L"abcdefghijk.mp4" };
+    assert(WaitForPaths(backend, renamed, 2));
+
+    // A new directory is watched as well, including files written right after it
+    MakePath(path, "Music");
+    assert(mkdir(path, 0755) == 0);
+    MakePath(path, "Music/Song [lmnopqrstuv].webm");
+    WriteFile(path);
+    const wchar_t* const nested[] = { L"Music", L"Music/Song [lmnopqrstuv].webm" };
+    assert(WaitForPaths(backend, nested, 2));
+
+    // Moves between directories and deletes
+    MakePath(target, "Music/abcdefghijk.mp4");
+    MakePath(path, "abcdefghijk.mp4");
+    assert(rename(path, target) == 0);
+    MakePath(path, "Music/Song [lmnopqrstuv].webm");
+    assert(unlink(path) == 0);
+    const wchar_t* const moved[] = { L"abcdefghijk.mp4", L"Music/abcdefghijk.mp4", L"Music/Song [lmnopqrstuv].webm" };
+    assert(WaitForPaths(backend, moved, 3));
+
+    // Quiet folder
+    static wchar_t nothing[16];
+    assert(WaitCacheWatchBackend(backend, 10, Collect, nothing) == CACHE_WATCH_TIMEOUT);
+
+    // Stopping wakes the wait and every later one
+    StopCacheWatchBackend(backend);
+    assert(WaitCacheWatchBackend(backend, INFINITE, Collect, nothing) == CACHE_WATCH_STOPPED);
+    assert(WaitCacheWatchBackend(backend, 0, Collect, nothing) == CACHE_WATCH_STOPPED);
+
+    CloseCacheWatchBackend(backend);
+
+    printf("All inotify watch backend tests passed!\n");
+}
+
+typedef struct {
+    CacheWatchBackend* backend;
+    Applied* applied;
+    int result;
+} WatchThread;
+
+static void* RunWatch(void* param) {
+    WatchThread* thread = (WatchThread*)param;
+    thread->result = RunCacheWatch(thread->backend, 150, Apply, thread->applied);
+    return NULL;
+}
+
+void test_watch_loop() {
+    printf("Running watch loop tests...\n");
+
+    wchar_t wideRoot[64];
+    mbstowcs(wideRoot, root, 64);
+    Applied applied;
+    InitApplied(&applied);
+    WatchThread thread = { OpenCacheWatchBackend(wideRoot), &applied, -1 };
+    assert(thread.backend);
+
+    pthread_t id;
+    assert(pthread_create(&id, NULL, RunWatch, &thread) == 0);
+
+    // A file written in several steps inside the debounce period is applied once
+    char path[256];
+    MakePath(path, "mnopqrstuvw.mkv");
+    for (int i = 0; i < 5; i++) {
+        WriteFile(path);
+        struct timespec pause = { 0, 20 * 1000000 };
+        nanosleep(&pause, NULL);
+    }
+
+    for (int i = 0; i < 100; i++) {
+        pthread_mutex_lock(&applied.lock);
+        int batches = applied.batchCount;
+        pthread_mutex_unlock(&applied.lock);
+        if (batches > 0) break;
+        struct timespec pause = { 0, 20 * 1000000 };
+        nanosleep(&pause, NULL);
+    }
+    struct timespec settle = { 0, 300 * 1000000 };
+    nanosleep(&settle, NULL);
+
+    StopCacheWatchBackend(thread.backend);
+    pthread_join(id, NULL);
+    assert(thread.result == CACHE_WATCH_STOPPED);
+    assert(applied.batchCount == 1);
+    assert(wcscmp(applied.batches[0], L"mnopqrstuvw.mkv") == 0);
+    assert(applied.rescans == 0);
+
+    CloseCacheWatchBackend(thread.backend);
+
+    printf("All watch loop tests passed!\n");
+}
+
+static void RemoveTree(void) {
+    char command[128];
+    snprintf(command, sizeof(command), "rm -rf '%s'", root);
+    assert(system(command) == 0);
+}
+
+int main() {
+    test_debounce();
+
+    strcpy(root, "/tmp/ytc_watch_XXXXXX");
+    assert(mkdtemp(root));
+    test_inotify_backend();
+    test_watch_loop();
+    RemoveTree();
+    return 0;
+}
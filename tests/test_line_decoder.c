@@ -0,0 +1,254 @@
+#include "mock_windows.h"
+
+// Prevent inclusion of the full application header
+#define YOUTUBECACHER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <assert.h>
+#include <pthread.h>
+
+// The decoder needs a real UTF-8 conversion; wchar_t holds whole code points here
+static int TestMultiByteToWideChar(uint32_t cp, DWORD flags, const char* src, int srclen, wchar_t* dst, int dstlen) {
+    (void)cp; (void)flags;
+    const unsigned char* p = (const unsigned char*)src;
+    const unsigned char* end = p + srclen;
+    int count = 0;
+    while (p < end) {
+        unsigned long c = *p++;
+        int extra = c >= 0xF0 ? 3 : c >= 0xE0 ? 2 : c >= 0xC0 ? 1 : 0;
+        c &= extra == 3 ? 0x07 : extra == 2 ? 0x0F : extra == 1 ? 0x1F : 0x7F;
+        for (int i = 0; i < extra; i++) {
+            assert(p < end && (*p & 0xC0) == 0x80);
+            c = (c << 6) | (*p++ & 0x3F);
+        }
+        if (dst) {
+            if (count >= dstlen) return 0;
+            dst[count] = (wchar_t)c;
+        }
+        count++;
+    }
+    return count;
+}
+#define MultiByteToWideChar TestMultiByteToWideChar
+
+#include "../linedecoder.h"
+#include "../linedecoder.c"
+
+static size_t EncodeUtf8(unsigned long c, char* out) {
+    if (c < 0x80) { out[0] = (char)c; return 1; }
+    if (c < 0x800) { out[0] = (char)(0xC0 | (c >> 6)); out[1] = (char)(0x80 | (c & 0x3F)); return 2; }
+    if (c < 0x10000) {
+        out[0] = (char)(0xE0 | (c >> 12)); out[1] = (char)(0x80 | ((c >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (c & 0x3F));
+        return 3;
+    }
+    out[0] = (char)(0xF0 | (c >> 18)); out[1] = (char)(0x80 | ((c >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((c >> 6) & 0x3F)); out[3] = (char)(0x80 | (c & 0x3F));
+    return 4;
+}
+
+// Collects lines as wide strings
+typedef struct {
+    wchar_t lines[8][16];
+    int count;
+} SmallLines;
+
+static void CollectSmallLine(void* context, const wchar_t* line, size_t length) {
+    SmallLines* lines = (SmallLines*)context;
+    assert(lines->count < 8 && length < 16 && line[length] == L'\0');
+    wcscpy(lines->lines[lines->count++], line);
+}
+
+void test_splitting() {
+    printf("Running line decoder splitting tests...\n");
+
+    // \n, \r and \r\n each end one line; empty lines are reported too
+    LineDecoder decoder;
+    InitLineDecoder(&decoder);
+    SmallLines lines;
+    memset(&lines, 0, sizeof(lines));
+    const char* text = "one\r\ntwo\rthree\n\nfour";
+    DecodeLines(&decoder, text, strlen(text), CollectSmallLine, &lines);
+    assert(lines.count == 4);
+    assert(wcscmp(lines.lines[0], L"one") == 0 && wcscmp(lines.lines[1], L"two") == 0);
+    assert(wcscmp(lines.lines[2], L"three") == 0 && wcscmp(lines.lines[3], L"") == 0);
+
+    // The unfinished line waits for the end of the stream
+    FlushLineDecoder(&decoder, CollectSmallLine, &lines);
+    assert(lines.count == 5 && wcscmp(lines.lines[4], L"four") == 0);
+    FlushLineDecoder(&decoder, CollectSmallLine, &lines);
+    assert(lines.count == 5);
+
+    // A \r\n split across reads still counts once
+    memset(&lines, 0, sizeof(lines));
+    DecodeLines(&decoder, "a\r", 2, CollectSmallLine, &lines);
+    DecodeLines(&decoder, "\nb\n", 3, CollectSmallLine, &lines);
+    assert(lines.count == 2 && wcscmp(lines.lines[0], L"a") == 0 && wcscmp(lines.lines[1], L"b") == 0);
+
+    // A character split across reads comes out whole
+    memset(&lines, 0, sizeof(lines));
+    DecodeLines(&decoder, "\xE2", 1, CollectSmallLine, &lines);
+    DecodeLines(&decoder, "\x82", 1, CollectSmallLine, &lines);
+    DecodeLines(&decoder, "\xAC 5\n", 4, CollectSmallLine, &lines);
+    assert(lines.count == 1 && wcscmp(lines.lines[0], L"\x20AC 5") == 0);
+
+    FreeLineDecoder(&decoder);
+    FreeLineDecoder(&decoder);
+
+    printf("All line decoder splitting tests passed!\n");
+}
+
+// Stress: every stream is random text with short, long and multi-byte lines,
+// fed to its own decoder in random pieces while the other streams run
+#define STREAM_COUNT    16
+#define STREAM_LINES    1000
+
+typedef struct {
+    unsigned int seed;
+    char* bytes;                // The whole stream
+    size_t length;
+    size_t* lineStart;          // Expected lines, as offsets into bytes
+    size_t* lineLength;
+    int lineCount;
+    int nextLine;               // Next line the decoder should report
+    char* encoded;              // Scratch for re-encoding a reported line
+    size_t encodedCapacity;
+    pthread_barrier_t* start;
+} Stream;
+
+static unsigned int NextRandom(unsigned int* seed) {
+    *seed = *seed * 1103515245u + 12345u;
+    return (*seed >> 8) & 0xFFFFFF;
+}
+
+static void AppendBytes(Stream* stream, size_t* capacity, const char* data, size_t length) {
+    while (stream->length + length > *capacity) {
+        *capacity *= 2;
+        stream->bytes = (char*)realloc(stream->bytes, *capacity);
+        assert(stream->bytes);
+    }
+    memcpy(stream->bytes + stream->length, data, length);
+    stream->length += length;
+}
+
+static void BuildStream(Stream* stream) {
+    static const unsigned long wideChars[] = { 0xE9, 0x416, 0x20AC, 0x4E2D, 0x1F600 };
+    size_t capacity = 65536;
+    stream->bytes = (char*)malloc(capacity);
+    stream->length = 0;
+    stream->lineStart = (size_t*)malloc(STREAM_LINES * sizeof(size_t));
+    stream->lineLength = (size_t*)malloc(STREAM_LINES * sizeof(size_t));
+    assert(stream->bytes && stream->lineStart && stream->lineLength);
+
+    BOOL afterCR = FALSE;
+    for (int i = 0; i < STREAM_LINES; i++) {
+        unsigned int kind = NextRandom(&stream->seed) % 100;
+        size_t chars = kind < 2 ? 5000 + NextRandom(&stream->seed) % 60000 :
+                       kind < 10 ? 0 : NextRandom(&stream->seed) % 120;
+
+        stream->lineStart[i] = stream->length;
+        for (size_t c = 0; c < chars; c++) {
+            char encoded[4];
+            unsigned int pick = NextRandom(&stream->seed) % 10;
+            unsigned long code = pick < 5 ? 0x20 + NextRandom(&stream->seed) % 0x5F : wideChars[pick - 5];
+            AppendBytes(stream, &capacity, encoded, EncodeUtf8(code, encoded));
+        }
+        stream->lineLength[i] = stream->length - stream->lineStart[i];
+
+        // The last line is left unterminated; an empty line right after a \r
+        // must not end with \n, or the two would read as one \r\n
+        if (i == STREAM_LINES - 1 && chars > 0) break;
+        unsigned int ending = NextRandom(&stream->seed) % 3;
+        if (afterCR && chars == 0) ending = 1;
+        const char* terminator = ending == 0 ? "\n" : ending == 1 ? "\r" : "\r\n";
+        AppendBytes(stream, &capacity, terminator, strlen(terminator));
+        afterCR = (ending == 1);
+    }
+    stream->lineCount = STREAM_LINES;
+}
+
+static void CheckStreamLine(void* context, const wchar_t* line, size_t length) {
+    Stream* stream = (Stream*)context;
+    assert(stream->nextLine < stream->lineCount);
+    assert(line[length] == L'\0');
+
+    if (length * 4 > stream->encodedCapacity) {
+        stream->encodedCapacity = length * 4 + 1;
+        stream->encoded = (char*)realloc(stream->encoded, stream->encodedCapacity);
+        assert(stream->encoded);
+    }
+    size_t encodedLength = 0;
+    for (size_t i = 0; i < length; i++) {
+        encodedLength += EncodeUtf8((unsigned long)line[i], stream->encoded + encodedLength);
+    }
+
+    int index = stream->nextLine++;
+    assert(encodedLength == stream->lineLength[index]);
+    assert(encodedLength == 0 || memcmp(stream->encoded, stream->bytes + stream->lineStart[index], encodedLength) == 0);
+}
+
+static void* RunStream(void* param) {
+    Stream* stream = (Stream*)param;
+    LineDecoder decoder;
+    InitLineDecoder(&decoder);
+    pthread_barrier_wait(stream->start);
+
+    size_t offset = 0;
+    while (offset < stream->length) {
+        // Mostly tiny pieces, to split characters and \r\n pairs, with some as large as a pipe read
+        unsigned int kind = NextRandom(&stream->seed) % 4;
+        size_t piece = kind == 0 ? 4096 : 1 + NextRandom(&stream->seed) % (kind == 1 ? 700 : 7);
+        if (piece > stream->length - offset) piece = stream->length - offset;
+        DecodeLines(&decoder, stream->bytes + offset, piece, CheckStreamLine, stream);
+        offset += piece;
+    }
+    FlushLineDecoder(&decoder, CheckStreamLine, stream);
+    FreeLineDecoder(&decoder);
+    return NULL;
+}
+
+void test_parallel_streams() {
+    printf("Running line decoder parallel stream tests...\n");
+
+    pthread_barrier_t start;
+    pthread_barrier_init(&start, NULL, STREAM_COUNT);
+    static Stream streams[STREAM_COUNT];
+    pthread_t threads[STREAM_COUNT];
+    size_t totalBytes = 0;
+
+    for (int i = 0; i < STREAM_COUNT; i++) {
+        memset(&streams[i], 0, sizeof(Stream));
+        streams[i].seed = 0x5EED0000u + (unsigned int)i;
+        streams[i].start = &start;
+        BuildStream(&streams[i]);
+        totalBytes += streams[i].length;
+    }
+    for (int i = 0; i < STREAM_COUNT; i++) {
+        assert(pthread_create(&threads[i], NULL, RunStream, &streams[i]) == 0);
+    }
+    for (int i = 0; i < STREAM_COUNT; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    // Every line of every stream came back, in order and byte for byte
+    for (int i = 0; i < STREAM_COUNT; i++) {
+        assert(streams[i].nextLine == streams[i].lineCount);
+        free(streams[i].bytes);
+        free(streams[i].lineStart);
+        free(streams[i].lineLength);
+        free(streams[i].encoded);
+    }
+    pthread_barrier_destroy(&start);
+    printf("  %d streams, %zu bytes decoded\n", STREAM_COUNT, totalBytes);
+
+    printf("All line decoder parallel stream tests passed!\n");
+}
+
+int main() {
+    test_splitting();
+    test_parallel_streams();
+    return 0;
+}
@@ -0,0 +1,394 @@
+#include "mock_windows.h"
+
+// Prevent inclusion of the full application header
+#define YOUTUBECACHER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <assert.h>
+
+#define MAX_URL_LENGTH 1024
+#define WM_USER 0x0400
+#define WM_METADATA_PREFETCHED (WM_USER + 205)
+#define BELOW_NORMAL_PRIORITY_CLASS 0x00004000
+#define THREAD_PRIORITY_BELOW_NORMAL (-1)
+
+typedef struct {
+    wchar_t* title;
+    wchar_t* duration;
+    wchar_t* id;
+    BOOL success;
+} VideoMetadata;
+
+typedef enum {
+    YTDLP_OP_GET_TITLE_DURATION = 1
+} YtDlpOperation;
+
+typedef struct {
+    int unused;
+} YtDlpConfig;
+
+typedef struct {
+    YtDlpOperation operation;
+    wchar_t url[MAX_URL_LENGTH];
+} YtDlpRequest;
+
+// A yt-dlp run that finishes after a set number of polls with the scripted
+// output, or as soon as it is cancelled
+typedef struct {
+    wchar_t url[MAX_URL_LENGTH];
+    DWORD priorityClass;
+    int pollsLeft;
+    BOOL cancelled;
+} ThreadSafeSubprocessContext;
+
+static const wchar_t* scriptedOutput = L"A Title\n3:25\n";
+static DWORD scriptedExitCode = 0;
+static int scriptedPolls = 2;
+static int processesStarted = 0;
+static int processesCancelled = 0;
+static DWORD lastPriorityClass = 0;
+
+static BOOL InitializeYtDlpConfig(YtDlpConfig* config) { config->unused = 0; return TRUE; }
+static void CleanupYtDlpConfig(YtDlpConfig* config) { (void)config; }
+
+static YtDlpRequest* CreateYtDlpRequest(YtDlpOperation operation, const wchar_t* url, const wchar_t* outputPath) {
+    (void)outputPath;
+    YtDlpRequest* request = (YtDlpRequest*)calloc(1, sizeof(YtDlpRequest));
+    request->operation = operation;
+    wcscpy(request->url, url);
+    return request;
+}
+
+static void FreeYtDlpRequest(YtDlpRequest* request) { free(request); }
+
+static ThreadSafeSubprocessContext* CreateThreadSafeSubprocessFromYtDlp(const YtDlpConfig* config, const YtDlpRequest* request) {
+    (void)config;
+    assert(request->operation == YTDLP_OP_GET_TITLE_DURATION);
+    ThreadSafeSubprocessContext* context = (ThreadSafeSubprocessContext*)calloc(1, sizeof(ThreadSafeSubprocessContext));
+    wcscpy(context->url, request->url);
+    context->pollsLeft = scriptedPolls;
+    return context;
+}
+
+static BOOL SetSubprocessPriorityClass(ThreadSafeSubprocessContext* context, DWORD priorityClass) {
+    context->priorityClass = priorityClass;
+    return TRUE;
+}
+
+static BOOL ExecuteThreadSafeSubprocessWithOutput(ThreadSafeSubprocessContext* context) {
+    lastPriorityClass = context->priorityClass;
+    processesStarted++;
+    return TRUE;
+}
+
+static BOOL WaitForThreadSafeSubprocessCompletion(ThreadSafeSubprocessContext* context, DWORD timeoutMs) {
+    (void)timeoutMs;
+    if (context->cancelled) return TRUE;
+    return --context->pollsLeft <= 0;
+}
+
+static BOOL WaitForThreadSafeSubprocessWithOutputCompletion(ThreadSafeSubprocessContext* context, DWORD timeoutMs) {
+    (void)timeoutMs;
+    return context->pollsLeft <= 0;
+}
+
+static BOOL CancelThreadSafeSubprocess(ThreadSafeSubprocessContext* context) {
+    context->cancelled = TRUE;
+    processesCancelled++;
+    return TRUE;
+}
+
+static BOOL ForceKillThreadSafeSubprocess(ThreadSafeSubprocessContext* context) {
+    (void)context;
+    assert(!"a cancelled process ends without being killed");
+    return TRUE;
+}
+
+static BOOL GetFinalThreadSafeSubprocessOutput(ThreadSafeSubprocessContext* context, wchar_t** output, size_t* length, DWORD* exitCode) {
+    (void)context;
+    *output = _wcsdup_mock(scriptedOutput);
+    *length = wcslen(scriptedOutput);
+    *exitCode = scriptedExitCode;
+    return TRUE;
+}
+
+static void CleanupThreadSafeSubprocessContext(ThreadSafeSubprocessContext* context) { (void)context; }
+
+static BOOL ParseTitleDurationOutput(const wchar_t* output, VideoMetadata* metadata) {
+    const wchar_t* newline = wcschr(output, L'\n');
+    size_t titleLength = newline ? (size_t)(newline - output) : wcslen(output);
+    if (titleLength == 0) return FALSE;
+    metadata->title = (wchar_t*)calloc(titleLength + 1, sizeof(wchar_t));
+    wcsncpy(metadata->title, output, titleLength);
+    if (newline && newline[1]) {
+        metadata->duration = _wcsdup_mock(newline + 1);
+        wchar_t* end = wcschr(metadata->duration, L'\n');
+        if (end) *end = L'\0';
+    }
+    metadata->success = TRUE;
+    return TRUE;
+}
+
+static void FreeVideoMetadata(VideoMetadata* metadata) {
+    free(metadata->title);
+    free(metadata->duration);
+    free(metadata->id);
+    memset(metadata, 0, sizeof(VideoMetadata));
+}
+
+// Threads are queued and run one at a time by the tests
+typedef struct {
+    LPTHREAD_START_ROUTINE routine;
+    LPVOID param;
+} QueuedThread;
+
+static QueuedThread threads[16];
+static int threadCount = 0;
+static int threadPriority = 0;
+
+static HANDLE TestCreateThread(LPSECURITY_ATTRIBUTES sa, size_t stack, LPTHREAD_START_ROUTINE start, LPVOID param, DWORD flags, DWORD* tid) {
+    (void)sa; (void)stack; (void)flags; (void)tid;
+    assert(threadCount < 16);
+    threads[threadCount].routine = start;
+    threads[threadCount].param = param;
+    threadCount++;
+    return (HANDLE)1;
+}
+
+static void RunThread(int index) {
+    threadPriority = 0;
+    threads[index].routine(threads[index].param);
+}
+
+static HANDLE GetCurrentThread(void) { return (HANDLE)2; }
+static BOOL SetThreadPriority(HANDLE h, int priority) { (void)h; threadPriority = priority; return TRUE; }
+
+// Posted messages are kept for the tests to inspect
+static UINT postedMessage = 0;
+static WPARAM postedWParam = 0;
+static LPARAM postedLParam = 0;
+static int postCount = 0;
+static BOOL postSucceeds = TRUE;
+
+static BOOL PostMessageW(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+    (void)hWnd;
+    if (!postSucceeds) return FALSE;
+    postedMessage = msg;
+    postedWParam = wParam;
+    postedLParam = lParam;
+    postCount++;
+    return TRUE;
+}
+
+#define CreateThread TestCreateThread
+
+#include "../metaprefetch.h"
+#include "../metaprefetch.c"
+
+#define DIALOG ((HWND)0x1234)
+#define URL_A L"https://www.youtube.com/watch?v=aaaaaaaaaaa"
+#define URL_B L"https://www.youtube.com/watch?v=bbbbbbbbbbb"
+#define URL_C L"https://www.youtube.com/watch?v=ccccccccccc"
+
+static void ResetRecords(void) {
+    threadCount = 0;
+    postCount = 0;
+    postedMessage = 0;
+    postedLParam = 0;
+    processesStarted = 0;
+    processesCancelled = 0;
+    scriptedOutput = L"A Title\n3:25\n";
+    scriptedExitCode = 0;
+    scriptedPolls = 2;
+    postSucceeds = TRUE;
+}
+
+static MetadataPrefetchResult* TakePrefetchedResult(void) {
+    assert(postCount == 1 && postedMessage == WM_METADATA_PREFETCHED);
+    postCount = 0;
+    return (MetadataPrefetchResult*)postedLParam;
+}
+
+void test_fetch_and_dedupe() {
+    printf("Running metadata prefetch fetch tests...\n");
+    ResetRecords();
+
+    // The same URL twice is one fetch
+    assert(StartMetadataPrefetch(DIALOG, URL_A));
+    assert(StartMetadataPrefetch(DIALOG, URL_A));
+    assert(threadCount == 1 && g_prefetcher.activeCount == 1);
+
+    // Below normal priority for both the thread and yt-dlp
+    RunThread(0);
+    assert(threadPriority == THREAD_PRIORITY_BELOW_NORMAL);
+    assert(lastPriorityClass == BELOW_NORMAL_PRIORITY_CLASS);
+    assert(g_prefetcher.activeCount == 0);
+
+    MetadataPrefetchResult* result = TakePrefetchedResult();
+    assert(wcscmp(result->url, URL_A) == 0);
+    assert(result->metadata->success);
+    assert(wcscmp(result->metadata->title, L"A Title") == 0);
+    assert(wcscmp(result->metadata->duration, L"3:25") == 0);
+    FreeMetadataPrefetchResult(result);
+
+    // Once done, the URL can be fetched again
+    assert(StartMetadataPrefetch(DIALOG, URL_A));
+    assert(threadCount == 2);
+    RunThread(1);
+    FreeMetadataPrefetchResult(TakePrefetchedResult());
+
+    // A failed fetch still reports, so the receiver can free it
+    ResetRecords();
+    scriptedExitCode = 1;
+    assert(StartMetadataPrefetch(DIALOG, URL_A));
+    RunThread(0);
+    result = TakePrefetchedResult();
+    assert(!result->metadata->success && result->metadata->title == NULL);
+    FreeMetadataPrefetchResult(result);
+
+    // Nothing to fetch
+    assert(!StartMetadataPrefetch(DIALOG, L""));
+    assert(!StartMetadataPrefetch(DIALOG, NULL));
+    assert(!StartMetadataPrefetch(NULL, URL_A));
+    assert(threadCount == 1);
+
+    printf("All metadata prefetch fetch tests passed!\n");
+}
+
+void test_cancel_and_cap() {
+    printf("Running metadata prefetch cancel tests...\n");
+    ResetRecords();
+
+    // A new URL cancels the fetch for the old one, which then posts nothing
+    assert(StartMetadataPrefetch(DIALOG, URL_A));
+    assert(StartMetadataPrefetch(DIALOG, URL_B));
+    assert(threadCount == 2 && g_prefetcher.activeCount == 2);
+
+    // Both slots are taken while the cancelled fetch winds down
+    assert(!StartMetadataPrefetch(DIALOG, URL_C));
+    assert(threadCount == 2);
+
+    RunThread(0);
+    assert(processesCancelled == 1 && postCount == 0);
+    RunThread(1);
+    assert(processesCancelled == 2 && postCount == 0);
+    assert(g_prefetcher.activeCount == 0);
+
+    // A cancelled URL is fetched afresh if it comes back
+    assert(StartMetadataPrefetch(DIALOG, URL_C));
+    assert(StartMetadataPrefetch(DIALOG, URL_A));
+    RunThread(2);
+    assert(StartMetadataPrefetch(DIALOG, URL_C));
+    assert(threadCount == 5 && g_prefetcher.activeCount == 2);
+    RunThread(3);
+    assert(postCount == 0);
+    RunThread(4);
+    FreeMetadataPrefetchResult(TakePrefetchedResult());
+
+    // Editing the box cancels fetches for anything else
+    ResetRecords();
+    assert(StartMetadataPrefetch(DIALOG, URL_A));
+    CancelMetadataPrefetchesExcept(URL_A);
+    CancelMetadataPrefetchesExcept(URL_B);
+    RunThread(0);
+    assert(processesCancelled == 1 && postCount == 0);
+
+    // A result the window never gets is freed by the fetch
+    ResetRecords();
+    postSucceeds = FALSE;
+    assert(StartMetadataPrefetch(DIALOG, URL_A));
+    RunThread(0);
+    assert(postCount == 0 && g_prefetcher.activeCount == 0);
+
+    printf("All metadata prefetch cancel tests passed!\n");
+}
+
+void test_adopt() {
+    printf("Running metadata prefetch adoption tests...\n");
+    ResetRecords();
+
+    assert(!AdoptMetadataPrefetch(URL_A));
+    assert(StartMetadataPrefetch(DIALOG, URL_A));
+    assert(!AdoptMetadataPrefetch(URL_B));
+    assert(AdoptMetadataPrefetch(URL_A));
+
+    // A taken-over fetch is not cancelled by a change of URL
+    CancelMetadataPrefetchesExcept(NULL);
+    assert(StartMetadataPrefetch(DIALOG, URL_B));
+    RunThread(0);
+    assert(processesCancelled == 0);
+
+    // It reports as a Get Info does
+    assert(postCount == 1 && postedMessage == WM_USER + 103 && postedWParam == TRUE);
+    VideoMetadata* metadata = (VideoMetadata*)postedLParam;
+    assert(metadata->success && wcscmp(metadata->title, L"A Title") == 0);
+    FreeVideoMetadata(metadata);
+    free(metadata);
+
+    // Finished fetches cannot be taken over
+    assert(!AdoptMetadataPrefetch(URL_A));
+    postCount = 0;
+    RunThread(1);
+    FreeMetadataPrefetchResult(TakePrefetchedResult());
+    assert(!AdoptMetadataPrefetch(URL_B));
+
+    // A cancelled one cannot either
+    ResetRecords();
+    assert(StartMetadataPrefetch(DIALOG, URL_A));
+    CancelMetadataPrefetchesExcept(NULL);
+    assert(!AdoptMetadataPrefetch(URL_A));
+    RunThread(0);
+
+    // A failed fetch that was taken over reports failure
+    ResetRecords();
+    scriptedOutput = L"";
+    assert(StartMetadataPrefetch(DIALOG, URL_A));
+    assert(AdoptMetadataPrefetch(URL_A));
+    RunThread(0);
+    assert(postCount == 1 && postedMessage == WM_USER + 103 && postedWParam == FALSE);
+    metadata = (VideoMetadata*)postedLParam;
+    FreeVideoMetadata(metadata);
+    free(metadata);
+
+    printf("All metadata prefetch adoption tests passed!\n");
+}
+
+void test_shutdown() {
+    printf("Running metadata prefetch shutdown tests...\n");
+    ResetRecords();
+
+    // Shutdown cancels even a taken-over fetch; one still running keeps the
+    // prefetcher alive until it ends
+    assert(StartMetadataPrefetch(DIALOG, URL_A));
+    assert(AdoptMetadataPrefetch(URL_A));
+    ShutdownMetadataPrefetcher();
+    assert(g_prefetcher.initialized);
+    RunThread(0);
+    assert(processesCancelled == 1);
+    // The window may still be there; the result is the window's to free
+    assert(postCount == 1 && postedMessage == WM_USER + 103 && postedWParam == FALSE);
+    VideoMetadata* metadata = (VideoMetadata*)postedLParam;
+    FreeVideoMetadata(metadata);
+    free(metadata);
+
+    ShutdownMetadataPrefetcher();
+    assert(!g_prefetcher.initialized);
+    assert(!StartMetadataPrefetch(DIALOG, URL_A));
+    assert(!AdoptMetadataPrefetch(URL_A));
+    CancelMetadataPrefetchesExcept(NULL);
+    assert(threadCount == 1);
+
+    printf("All metadata prefetch shutdown tests passed!\n");
+}
+
+int main() {
+    InitializeMetadataPrefetcher();
+    test_fetch_and_dedupe();
+    test_cancel_and_cap();
+    test_adopt();
+    test_shutdown();
+    return 0;
+}
@@ -0,0 +1,307 @@
+#include "mock_windows.h"
+
+// Prevent inclusion of the full application header
+#define YOUTUBECACHER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <assert.h>
+
+// A scripted pipe. Each wait first applies the next step of the script, as if
+// it had happened while the reader slept, then reports what is signalled.
+#define STEP_NONE       0   // Nothing happens; the wait times out
+#define STEP_WRITE      1   // The child writes text
+#define STEP_EXIT       2   // The child exits, its own children keeping the write end open
+#define STEP_WRITE_EXIT 3   // The child writes its last output and exits
+#define STEP_CLOSE      4   // Every write end is closed
+#define STEP_CANCEL     5
+
+#define READ_EVENT      ((HANDLE)1)     // What the CreateEventW mock returns
+#define PROCESS         ((HANDLE)2)
+#define CANCEL_EVENT    ((HANDLE)3)
+
+typedef struct {
+    int step;
+    const char* text;
+} ScriptStep;
+
+static struct {
+    char data[65536];
+    size_t head, tail;
+    BOOL writersClosed, exited, cancelled;
+
+    char* readBuffer;           // The outstanding read
+    DWORD readSize;
+    BOOL readPending, readDone;
+    DWORD readBytes, readError;
+
+    const ScriptStep* script;
+    int nextStep;
+    DWORD lastError;
+    int readCalls, waitCalls, cancelCalls;
+    DWORD lastWaitMs, lastWaitCount;
+} pipe;
+
+static void ResetPipe(const ScriptStep* script) {
+    memset(&pipe, 0, sizeof(pipe));
+    pipe.script = script;
+}
+
+static void FinishRead(void) {
+    size_t available = pipe.tail - pipe.head;
+    DWORD bytes = available < pipe.readSize ? (DWORD)available : pipe.readSize;
+    memcpy(pipe.readBuffer, pipe.data + pipe.head, bytes);
+    pipe.head += bytes;
+    pipe.readBytes = bytes;
+    pipe.readError = 0;
+    pipe.readDone = TRUE;
+}
+
+static void WriteToPipe(const char* text) {
+    size_t length = strlen(text);
+    assert(pipe.tail + length <= sizeof(pipe.data));
+    memcpy(pipe.data + pipe.tail, text, length);
+    pipe.tail += length;
+    if (pipe.readPending && !pipe.readDone) FinishRead();
+}
+
+static DWORD ScriptedGetLastError(void) {
+    return pipe.lastError;
+}
+
+static BOOL ScriptedReadFile(HANDLE h, LPVOID buffer, DWORD size, DWORD* read, LPOVERLAPPED overlapped) {
+    (void)h; (void)read; (void)overlapped;
+    assert(!pipe.readPending);
+    pipe.readCalls++;
+    pipe.readBuffer = (char*)buffer;
+    pipe.readSize = size;
+    pipe.readPending = TRUE;
+    pipe.readDone = FALSE;
+
+    if (pipe.tail > pipe.head) {
+        FinishRead();
+        return TRUE;
+    }
+    if (pipe.writersClosed) {
+        pipe.readPending = FALSE;
+        pipe.lastError = ERROR_BROKEN_PIPE;
+        return FALSE;
+    }
+    pipe.lastError = ERROR_IO_PENDING;
+    return FALSE;
+}
+
+static BOOL ScriptedGetOverlappedResult(HANDLE h, LPOVERLAPPED overlapped, DWORD* bytes, BOOL wait) {
+    (void)h; (void)overlapped;
+    assert(pipe.readPending);
+    // Waiting on a read that can never finish would hang the reader
+    assert(pipe.readDone || !wait);
+    if (!pipe.readDone) {
+        pipe.lastError = 996; // ERROR_IO_INCOMPLETE
+        return FALSE;
+    }
+    pipe.readPending = FALSE;
+    *bytes = pipe.readBytes;
+    if (pipe.readError) {
+        pipe.lastError = pipe.readError;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static BOOL ScriptedCancelIoEx(HANDLE h, LPOVERLAPPED overlapped) {
+    (void)h; (void)overlapped;
+    pipe.cancelCalls++;
+    if (pipe.readPending && !pipe.readDone) {
+        pipe.readBytes = 0;
+        pipe.readError = ERROR_OPERATION_ABORTED;
+        pipe.readDone = TRUE;
+    }
+    return TRUE;
+}
+
+static DWORD ScriptedWaitForMultipleObjects(DWORD count, const HANDLE* handles, BOOL waitAll, DWORD ms) {
+    assert(!waitAll);
+    pipe.waitCalls++;
+    pipe.lastWaitMs = ms;
+    pipe.lastWaitCount = count;
+
+    ScriptStep step = pipe.script[pipe.nextStep];
+    if (step.step != STEP_NONE) pipe.nextStep++;
+    switch (step.step) {
+        case STEP_WRITE: WriteToPipe(step.text); break;
+        case STEP_EXIT: pipe.exited = TRUE; break;
+        case STEP_WRITE_EXIT: WriteToPipe(step.text); pipe.exited = TRUE; break;
+        case STEP_CANCEL: pipe.cancelled = TRUE; break;
+        case STEP_CLOSE:
+            pipe.writersClosed = TRUE;
+            if (pipe.readPending && !pipe.readDone) {
+                pipe.readBytes = 0;
+                pipe.readError = ERROR_BROKEN_PIPE;
+                pipe.readDone = TRUE;
+            }
+            break;
+    }
+
+    for (DWORD i = 0; i < count; i++) {
+        if ((handles[i] == READ_EVENT && pipe.readDone) || (handles[i] == PROCESS && pipe.exited) ||
+            (handles[i] == CANCEL_EVENT && pipe.cancelled)) {
+            return WAIT_OBJECT_0 + i;
+        }
+    }
+    return WAIT_TIMEOUT;
+}
+
+#define GetLastError ScriptedGetLastError
+#define ReadFile ScriptedReadFile
+#define GetOverlappedResult ScriptedGetOverlappedResult
+#define CancelIoEx ScriptedCancelIoEx
+#define WaitForMultipleObjects ScriptedWaitForMultipleObjects
+
+#include "../outputpipe.h"
+#include "../outputpipe.c"
+
+// Read until something other than output comes back, collecting the output
+static int ReadAll(OutputPipeReader* reader, HANDLE hProcess, HANDLE hCancel, char* output, size_t outputSize) {
+    size_t used = 0;
+    output[0] = '\0';
+    for (;;) {
+        char* data = NULL;
+        DWORD length = 0;
+        int result = ReadOutputPipe(reader, hProcess, hCancel, INFINITE, &data, &length);
+        if (result != OUTPUT_PIPE_DATA) return result;
+
+        assert(length > 0 && length <= OUTPUT_PIPE_READ_SIZE && data[length] == '\0');
+        assert(used + length < outputSize);
+        memcpy(output + used, data, length);
+        used += length;
+        output[used] = '\0';
+    }
+}
+
+void test_buffered_output() {
+    printf("Running output pipe buffered output tests...\n");
+
+    // Output already in the pipe comes back without waiting, in read-sized pieces
+    static char expected[10000 + 1];
+    for (int i = 0; i < 10000; i++) expected[i] = (char)('a' + i % 26);
+    expected[10000] = '\0';
+
+    static const ScriptStep script[] = { { STEP_EXIT, NULL }, { STEP_NONE, NULL } };
+    ResetPipe(script);
+    WriteToPipe(expected);
+
+    OutputPipeReader* reader = OpenOutputPipeReader((HANDLE)10);
+    assert(reader);
+    static char output[20000];
+    assert(ReadAll(reader, PROCESS, CANCEL_EVENT, output, sizeof(output)) == OUTPUT_PIPE_EXITED);
+    assert(strcmp(output, expected) == 0);
+    assert(pipe.readCalls == 4);
+    assert(!pipe.readPending);
+    CloseOutputPipeReader(reader);
+
+    printf("All output pipe buffered output tests passed!\n");
+}
+
+void test_idle_waits() {
+    printf("Running output pipe idle wait tests...\n");
+
+    static const ScriptStep script[] = {
+        { STEP_NONE, NULL },
+    };
+    ResetPipe(script);
+    OutputPipeReader* reader = OpenOutputPipeReader((HANDLE)10);
+
+    // An idle child costs one wait per call, for as long as the caller allows
+    char* data = NULL;
+    DWORD length = 99;
+    assert(ReadOutputPipe(reader, PROCESS, CANCEL_EVENT, 30000, &data, &length) == OUTPUT_PIPE_TIMEOUT);
+    assert(length == 0);
+    assert(pipe.waitCalls == 1 && pipe.lastWaitMs == 30000 && pipe.lastWaitCount == 3);
+    assert(pipe.readCalls == 1 && pipe.readPending);
+
+    // The read stays outstanding and picks up output written later
+    static const ScriptStep later[] = { { STEP_WRITE, "[download]  42.0% of 10MiB\r" }, { STEP_NONE, NULL } };
+    pipe.script = later;
+    pipe.nextStep = 0;
+    assert(ReadOutputPipe(reader, PROCESS, CANCEL_EVENT, INFINITE, &data, &length) == OUTPUT_PIPE_DATA);
+    assert(pipe.readCalls == 1 && pipe.waitCalls == 2);
+    assert(strcmp(data, "[download]  42.0% of 10MiB\r") == 0);
+
+    // Without a process or cancel event only the read is waited on
+    assert(ReadOutputPipe(reader, NULL, NULL, 0, &data, &length) == OUTPUT_PIPE_TIMEOUT);
+    assert(pipe.lastWaitCount == 1);
+
+    // Closing with a read outstanding cancels it
+    CloseOutputPipeReader(reader);
+    assert(pipe.cancelCalls == 1 && !pipe.readPending);
+
+    printf("All output pipe idle wait tests passed!\n");
+}
+
+void test_process_exit() {
+    printf("Running output pipe process exit tests...\n");
+
+    // Output written while the reader sleeps, then an exit with a grandchild
+    // still holding the write end: all output first, then the exit
+    static const ScriptStep script[] = {
+        { STEP_WRITE, "line one\n" },
+        { STEP_WRITE_EXIT, "last line\n" },
+        { STEP_NONE, NULL },
+    };
+    ResetPipe(script);
+    OutputPipeReader* reader = OpenOutputPipeReader((HANDLE)10);
+    char output[256];
+    assert(ReadAll(reader, PROCESS, CANCEL_EVENT, output, sizeof(output)) == OUTPUT_PIPE_EXITED);
+    assert(strcmp(output, "line one\nlast line\n") == 0);
+    assert(!pipe.writersClosed && !pipe.readPending);
+    CloseOutputPipeReader(reader);
+    assert(pipe.cancelCalls == 1);
+
+    // Every write end closing ends the output too
+    static const ScriptStep closing[] = {
+        { STEP_WRITE, "only line\n" },
+        { STEP_CLOSE, NULL },
+        { STEP_NONE, NULL },
+    };
+    ResetPipe(closing);
+    reader = OpenOutputPipeReader((HANDLE)10);
+    assert(ReadAll(reader, PROCESS, CANCEL_EVENT, output, sizeof(output)) == OUTPUT_PIPE_CLOSED);
+    assert(strcmp(output, "only line\n") == 0);
+    assert(ReadAll(reader, PROCESS, CANCEL_EVENT, output, sizeof(output)) == OUTPUT_PIPE_CLOSED);
+    CloseOutputPipeReader(reader);
+    assert(pipe.cancelCalls == 0);
+
+    printf("All output pipe process exit tests passed!\n");
+}
+
+void test_cancel() {
+    printf("Running output pipe cancel tests...\n");
+
+    static const ScriptStep script[] = { { STEP_CANCEL, NULL }, { STEP_NONE, NULL } };
+    ResetPipe(script);
+    OutputPipeReader* reader = OpenOutputPipeReader((HANDLE)10);
+    char* data = NULL;
+    DWORD length = 0;
+    assert(ReadOutputPipe(reader, PROCESS, CANCEL_EVENT, INFINITE, &data, &length) == OUTPUT_PIPE_CANCELLED);
+    assert(length == 0 && !pipe.readPending && pipe.cancelCalls == 1);
+    CloseOutputPipeReader(reader);
+    assert(pipe.cancelCalls == 1);
+
+    assert(OpenOutputPipeReader(NULL) == NULL);
+    assert(OpenOutputPipeReader(INVALID_HANDLE_VALUE) == NULL);
+    assert(ReadOutputPipe(NULL, PROCESS, NULL, 0, &data, &length) == OUTPUT_PIPE_FAILED);
+    CloseOutputPipeReader(NULL);
+
+    printf("All output pipe cancel tests passed!\n");
+}
+
+int main() {
+    test_buffered_output();
+    test_idle_waits();
+    test_process_exit();
+    test_cancel();
+    return 0;
+}
@@ -0,0 +1,287 @@
+#include "mock_windows.h"
+
+// Prevent inclusion of the full application header
+#define YOUTUBECACHER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include <time.h>
+
+// The ring's two sides wake each other through events, so the stress test
+// needs real auto-reset events rather than the mock's stand-ins
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    BOOL signalled;
+} TestEvent;
+
+static HANDLE TestCreateEventW(void* sa, BOOL manual, BOOL initial, LPCWSTR name) {
+    (void)sa; (void)name;
+    assert(!manual);
+    TestEvent* event = (TestEvent*)calloc(1, sizeof(TestEvent));
+    pthread_mutex_init(&event->mutex, NULL);
+    pthread_cond_init(&event->cond, NULL);
+    event->signalled = initial;
+    return (HANDLE)event;
+}
+
+static BOOL TestSetEvent(HANDLE h) {
+    TestEvent* event = (TestEvent*)h;
+    pthread_mutex_lock(&event->mutex);
+    event->signalled = TRUE;
+    pthread_cond_signal(&event->cond);
+    pthread_mutex_unlock(&event->mutex);
+    return TRUE;
+}
+
+static BOOL TestCloseHandle(HANDLE h) {
+    TestEvent* event = (TestEvent*)h;
+    pthread_mutex_destroy(&event->mutex);
+    pthread_cond_destroy(&event->cond);
+    free(event);
+    return TRUE;
+}
+
+static DWORD TestGetTickCount(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (DWORD)(now.tv_sec * 1000 + now.tv_nsec / 1000000);
+}
+
+static DWORD TestWaitForSingleObject(HANDLE h, DWORD ms) {
+    TestEvent* event = (TestEvent*)h;
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    if (ms != INFINITE) {
+        deadline.tv_sec += ms / 1000;
+        deadline.tv_nsec += (long)(ms % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+    }
+
+    pthread_mutex_lock(&event->mutex);
+    while (!event->signalled) {
+        if (ms == INFINITE) {
+            pthread_cond_wait(&event->cond, &event->mutex);
+        } else if (pthread_cond_timedwait(&event->cond, &event->mutex, &deadline) != 0) {
+            break;
+        }
+    }
+    BOOL signalled = event->signalled;
+    event->signalled = FALSE;
+    pthread_mutex_unlock(&event->mutex);
+    return signalled ? WAIT_OBJECT_0 : WAIT_TIMEOUT;
+}
+
+// The writer waits on room or a cancel event; the tests only set the cancel
+// event before a write starts, so checking it first is enough
+static volatile LONG cancelSet = 0;
+#define CANCEL_EVENT ((HANDLE)3)
+
+static DWORD TestWaitForMultipleObjects(DWORD count, const HANDLE* handles, BOOL waitAll, DWORD ms) {
+    assert(!waitAll && count >= 1);
+    if (count == 2 && handles[1] == CANCEL_EVENT && cancelSet) return WAIT_OBJECT_0 + 1;
+    return TestWaitForSingleObject(handles[0], ms);
+}
+
+#define CreateEventW TestCreateEventW
+#define SetEvent TestSetEvent
+#define CloseHandle TestCloseHandle
+#define GetTickCount TestGetTickCount
+#define WaitForSingleObject TestWaitForSingleObject
+#define WaitForMultipleObjects TestWaitForMultipleObjects
+
+#include "../outputring.h"
+#include "../outputring.c"
+
+void test_single_thread() {
+    printf("Running output ring single thread tests...\n");
+
+    // Sizes round up to a power of two
+    OutputRing* ring = CreateOutputRing(10);
+    assert(ring);
+    OutputRingStats stats;
+    GetOutputRingStats(ring, &stats);
+    assert(stats.size == 16 && stats.highWater == 0);
+
+    // Nothing written yet: a zero wait times out at once
+    const char* data = NULL;
+    DWORD length = 0;
+    assert(ReadOutputRing(ring, 0, &data, &length) == OUTPUT_RING_TIMEOUT);
+    assert(data == NULL && length == 0);
+
+    // Bytes come back in place and stay until consumed
+    assert(WriteOutputRing(ring, "0123456789", 10, NULL));
+    assert(ReadOutputRing(ring, 0, &data, &length) == OUTPUT_RING_DATA);
+    assert(length == 10 && memcmp(data, "0123456789", 10) == 0);
+    assert(ReadOutputRing(ring, 0, &data, &length) == OUTPUT_RING_DATA && length == 10);
+    ConsumeOutputRing(ring, 4);
+    assert(ReadOutputRing(ring, 0, &data, &length) == OUTPUT_RING_DATA);
+    assert(length == 6 && memcmp(data, "456789", 6) == 0);
+    ConsumeOutputRing(ring, 6);
+
+    // A write that wraps is read back in two pieces
+    assert(WriteOutputRing(ring, "abcdefghij", 10, NULL));
+    assert(ReadOutputRing(ring, 0, &data, &length) == OUTPUT_RING_DATA);
+    assert(length == 6 && memcmp(data, "abcdef", 6) == 0);
+    ConsumeOutputRing(ring, length);
+    assert(ReadOutputRing(ring, 0, &data, &length) == OUTPUT_RING_DATA);
+    assert(length == 4 && memcmp(data, "ghij", 4) == 0);
+
+    // Consuming more than is held gives back only what is there
+    ConsumeOutputRing(ring, 100);
+    assert(ReadOutputRing(ring, 0, &data, &length) == OUTPUT_RING_TIMEOUT);
+
+    // The ring fills exactly; the writer has not had to wait yet
+    assert(WriteOutputRing(ring, "ABCDEFGHIJKLMNOP", 16, NULL));
+    GetOutputRingStats(ring, &stats);
+    assert(stats.highWater == 16 && stats.bytesWritten == 36 && stats.writerStalls == 0);
+
+    // Closing the writer still delivers what it wrote
+    CloseOutputRingWriter(ring);
+    size_t total = 0;
+    while (ReadOutputRing(ring, INFINITE, &data, &length) == OUTPUT_RING_DATA) {
+        assert(memcmp(data, "ABCDEFGHIJKLMNOP" + total, length) == 0);
+        total += length;
+        ConsumeOutputRing(ring, length);
+    }
+    assert(total == 16);
+    assert(ReadOutputRing(ring, INFINITE, &data, &length) == OUTPUT_RING_CLOSED);
+    FreeOutputRing(ring);
+
+    // A write into a full ring gives up on cancellation or a closed reader
+    ring = CreateOutputRing(8);
+    assert(WriteOutputRing(ring, "12345678", 8, CANCEL_EVENT));
+    cancelSet = 1;
+    assert(!WriteOutputRing(ring, "9", 1, CANCEL_EVENT));
+    cancelSet = 0;
+    GetOutputRingStats(ring, &stats);
+    assert(stats.writerStalls == 1);
+    CloseOutputRingReader(ring);
+    assert(!WriteOutputRing(ring, "9", 1, NULL));
+    FreeOutputRing(ring);
+
+    assert(CreateOutputRing(0) == NULL);
+    assert(!WriteOutputRing(NULL, "x", 1, NULL));
+    assert(ReadOutputRing(NULL, 0, &data, &length) == OUTPUT_RING_CLOSED);
+    GetOutputRingStats(NULL, &stats);
+    assert(stats.size == 0);
+
+    printf("All output ring single thread tests passed!\n");
+}
+
+// Stress: a drain thread pushes a long pseudo-random stream in pipe-sized
+// pieces through a small ring to a reader that consumes in odd amounts and
+// sometimes stalls, so both sides wait on each other many times over
+#define STRESS_BYTES    (32 * 1024 * 1024)
+#define STRESS_RING     4096
+
+static unsigned char StreamByte(size_t i) {
+    return (unsigned char)((i * 2654435761u) >> 13);
+}
+
+static unsigned int NextRandom(unsigned int* seed) {
+    *seed = *seed * 1103515245u + 12345u;
+    return (*seed >> 8) & 0xFFFFFF;
+}
+
+static void* StressWriter(void* param) {
+    OutputRing* ring = (OutputRing*)param;
+    static unsigned char piece[4096];
+    unsigned int seed = 7;
+    size_t sent = 0;
+
+    while (sent < STRESS_BYTES) {
+        size_t length = 1 + NextRandom(&seed) % sizeof(piece);
+        if (length > STRESS_BYTES - sent) length = STRESS_BYTES - sent;
+        for (size_t i = 0; i < length; i++) piece[i] = StreamByte(sent + i);
+        assert(WriteOutputRing(ring, (const char*)piece, (DWORD)length, NULL));
+        sent += length;
+    }
+    CloseOutputRingWriter(ring);
+    return NULL;
+}
+
+void test_stress() {
+    printf("Running output ring stress tests...\n");
+
+    OutputRing* ring = CreateOutputRing(STRESS_RING);
+    pthread_t writer;
+    assert(pthread_create(&writer, NULL, StressWriter, ring) == 0);
+
+    unsigned int seed = 11;
+    size_t received = 0;
+    int reads = 0;
+    const char* data = NULL;
+    DWORD length = 0;
+    int result;
+    while ((result = ReadOutputRing(ring, INFINITE, &data, &length)) == OUTPUT_RING_DATA) {
+        assert(length > 0 && length <= STRESS_RING);
+        DWORD take = 1 + NextRandom(&seed) % length;
+        for (DWORD i = 0; i < take; i++) {
+            assert((unsigned char)data[i] == StreamByte(received + i));
+        }
+        received += take;
+        ConsumeOutputRing(ring, take);
+
+        // A slow parse now and then lets the ring fill
+        if (++reads % 5000 == 0) {
+            struct timespec pause = { 0, 2000000 };
+            nanosleep(&pause, NULL);
+        }
+    }
+    assert(result == OUTPUT_RING_CLOSED);
+    pthread_join(writer, NULL);
+    assert(received == STRESS_BYTES);
+
+    OutputRingStats stats;
+    GetOutputRingStats(ring, &stats);
+    assert(stats.bytesWritten == STRESS_BYTES);
+    assert(stats.highWater == STRESS_RING);
+    assert(stats.writerStalls > 0 && stats.writerStallMs > 0);
+    printf("  %d reads, high-water %lu, writer stalled %lu times for %lu ms, reader waited %lu ms\n",
+           reads, (unsigned long)stats.highWater, (unsigned long)stats.writerStalls,
+           (unsigned long)stats.writerStallMs, (unsigned long)stats.readerWaitMs);
+    FreeOutputRing(ring);
+
+    printf("All output ring stress tests passed!\n");
+}
+
+// A reader that closes early must not leave the writer waiting forever
+static void* BlockedWriter(void* param) {
+    OutputRing* ring = (OutputRing*)param;
+    char block[64];
+    memset(block, 'x', sizeof(block));
+    while (WriteOutputRing(ring, block, sizeof(block), NULL)) {
+    }
+    return NULL;
+}
+
+void test_reader_close() {
+    printf("Running output ring reader close tests...\n");
+
+    OutputRing* ring = CreateOutputRing(256);
+    pthread_t writer;
+    assert(pthread_create(&writer, NULL, BlockedWriter, ring) == 0);
+
+    const char* data = NULL;
+    DWORD length = 0;
+    assert(ReadOutputRing(ring, INFINITE, &data, &length) == OUTPUT_RING_DATA);
+    CloseOutputRingReader(ring);
+    pthread_join(writer, NULL);
+    FreeOutputRing(ring);
+
+    printf("All output ring reader close tests passed!\n");
+}
+
+int main() {
+    test_single_thread();
+    test_stress();
+    test_reader_close();
+    return 0;
+}
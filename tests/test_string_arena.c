@@ -0,0 +1,96 @@
+#include "mock_windows.h"
+
+// Prevent inclusion of the full application header
+#define YOUTUBECACHER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "../stringarena.h"
+#include "../stringarena.c"
+
+static int CountBlocks(const StringArena* arena) {
+    int count = 0;
+    for (const StringArenaBlock* block = arena->blocks; block; block = block->next) {
+        count++;
+    }
+    return count;
+}
+
+void test_allocation() {
+    printf("Running string arena allocation tests...\n");
+
+    StringArena* arena = CreateStringArena(256);
+    assert(arena != NULL);
+    assert(arena->refCount == 1);
+
+    wchar_t* a = StringArenaWcsDup(arena, L"dQw4w9WgXcQ");
+    wchar_t* b = StringArenaWcsDup(arena, L"");
+    wchar_t* c = StringArenaWcsDup(arena, L"C:\\Videos\\title.mp4");
+    assert(a && b && c);
+    assert(wcscmp(a, L"dQw4w9WgXcQ") == 0);
+    assert(wcscmp(b, L"") == 0);
+    assert(wcscmp(c, L"C:\\Videos\\title.mp4") == 0);
+    assert(StringArenaWcsDup(arena, NULL) == NULL);
+    assert(StringArenaAlloc(arena, 0) == NULL);
+
+    // Allocations are pointer-aligned and do not overlap
+    assert(((uintptr_t)a % sizeof(void*)) == 0);
+    assert(((uintptr_t)b % sizeof(void*)) == 0);
+    assert(((uintptr_t)c % sizeof(void*)) == 0);
+    assert((BYTE*)b >= (BYTE*)a + (wcslen(a) + 1) * sizeof(wchar_t));
+    assert(CountBlocks(arena) == 1);
+
+    // Filling the block starts a new one; earlier strings stay intact
+    for (int i = 0; i < 100; i++) {
+        assert(StringArenaWcsDup(arena, L"0123456789") != NULL);
+    }
+    assert(CountBlocks(arena) > 1);
+    assert(wcscmp(a, L"dQw4w9WgXcQ") == 0);
+
+    // Requests larger than the block size get a block of their own
+    size_t bigChars = 1000;
+    wchar_t* big = (wchar_t*)StringArenaAlloc(arena, bigChars * sizeof(wchar_t));
+    assert(big != NULL);
+    wmemset(big, L'x', bigChars);
+    assert(arena->blocks->size >= bigChars * sizeof(wchar_t));
+
+    ReleaseStringArena(arena);
+
+    printf("All string arena allocation tests passed!\n");
+}
+
+void test_reference_counting() {
+    printf("Running string arena reference counting tests...\n");
+
+    StringArena* arena = CreateStringArena(0);
+    assert(arena->blockSize == STRING_ARENA_DEFAULT_BLOCK_SIZE);
+
+    // Loader reference plus one per entry
+    RetainStringArena(arena);
+    RetainStringArena(arena);
+    assert(arena->refCount == 3);
+
+    wchar_t* s = StringArenaWcsDup(arena, L"still alive");
+    ReleaseStringArena(arena); // Loader done
+    ReleaseStringArena(arena); // First entry removed
+    assert(arena->refCount == 1);
+    assert(wcscmp(s, L"still alive") == 0);
+    ReleaseStringArena(arena); // Last entry frees everything
+
+    // Releasing NULL is a no-op
+    ReleaseStringArena(NULL);
+    RetainStringArena(NULL);
+
+    printf("All string arena reference counting tests passed!\n");
+}
+
+int main() {
+    test_allocation();
+    test_reference_counting();
+    return 0;
+}
@@ -13,7 +13,8 @@ typedef enum {
     YTDLP_OP_DOWNLOAD,
     YTDLP_OP_VALIDATE,
     YTDLP_OP_GET_PLAYLIST_INFO,
-    YTDLP_OP_DOWNLOAD_PLAYLIST
+    YTDLP_OP_DOWNLOAD_PLAYLIST,
+    YTDLP_OP_DOWNLOAD_BATCH
 } YtDlpOperation;
 
 typedef enum {
@@ -25,6 +26,9 @@ typedef enum {
 
 // Progress callback function type
 typedef void (*ProgressCallback)(int percentage, const wchar_t* status, void* userData);
+typedef void (*SubprocessLineCallback)(const wchar_t* line, void* userData);
+
+#define MAX_EXTENDED_PATH 32767
 
 // Struct definitions exactly as in production headers
 typedef struct {
@@ -86,8 +90,11 @@ typedef struct {
     wchar_t* arguments;
     wchar_t* workingDirectory;
     DWORD timeoutMs;
+    DWORD priorityClass;
     ProgressCallback progressCallback;
     void* callbackUserData;
+    SubprocessLineCallback lineCallback;
+    void* lineCallbackUserData;
     HWND parentWindow;
     BOOL cancellationRequested;
     HANDLE cancellationEvent;
@@ -180,6 +187,27 @@ BOOL SetSubprocessParentWindow(ThreadSafeSubprocessContext* context, HWND parent
 BOOL IsThreadSafeSubprocessRunning(ThreadSafeSubprocessContext* context) {
     (void)context; return TRUE;
 }
+BOOL SetSubprocessLineCallback(ThreadSafeSubprocessContext* context, SubprocessLineCallback callback, void* userData) {
+    (void)context; (void)callback; (void)userData; return TRUE;
+}
+BOOL IsThreadSafeSubprocessOutputComplete(ThreadSafeSubprocessContext* context) {
+    (void)context; return TRUE;
+}
+DWORD GetThreadSafeSubprocessExitCode(ThreadSafeSubprocessContext* context) {
+    (void)context; return 0;
+}
+YtDlpRequest* CreateYtDlpRequest(YtDlpOperation operation, const wchar_t* url, const wchar_t* outputPath) {
+    (void)operation; (void)url; (void)outputPath; return NULL;
+}
+void FreeYtDlpRequest(YtDlpRequest* request) { (void)request; }
+BOOL DeleteFileW(LPCWSTR path) { (void)path; return TRUE; }
+
+#include "../ytdlpbatch.h"
+BOOL WriteYtDlpBatchFile(const YtDlpBatch* batch, const wchar_t* path) {
+    (void)batch; (void)path; return FALSE;
+}
+void TrackYtDlpBatchLine(YtDlpBatch* batch, const wchar_t* line) { (void)batch; (void)line; }
+void FinishYtDlpBatch(YtDlpBatch* batch, BOOL cancelled) { (void)batch; (void)cancelled; }
 
 // Include the implementation to test
 #include "../subproc.c"
@@ -23,6 +23,7 @@ typedef struct { int dummy; } ErrorHandler;
 typedef struct { int dummy; } MemoryManager;
 typedef struct { int dummy; } ApplicationState;
 typedef void (*ProgressCallback)(int, const wchar_t*, void*);
+typedef void (*SubprocessLineCallback)(const wchar_t* line, void* userData);
 typedef struct {
     CRITICAL_SECTION criticalSection;
     BOOL isRunning;
@@ -71,8 +72,11 @@ typedef struct {
     wchar_t* arguments;
     wchar_t* workingDirectory;
     DWORD timeoutMs;
+    DWORD priorityClass;
     ProgressCallback progressCallback;
     void* callbackUserData;
+    SubprocessLineCallback lineCallback;
+    void* lineCallbackUserData;
     HWND parentWindow;
     HANDLE hProcess;
     HANDLE hThread;
@@ -89,8 +93,12 @@ BOOL ForceKillThreadSafeSubprocess(ThreadSafeSubprocessContext* context);
 
 ErrorHandler g_ErrorHandler;
 
-// Include the actual source file
+// Include the actual source files
+#include "../outputpipe.h"
+#include "../linedecoder.h"
 #include "../threadsafe.c"
+#include "../outputpipe.c"
+#include "../linedecoder.c"
 
 int test_initialization() {
     printf("Starting thread safety initialization tests...\n");
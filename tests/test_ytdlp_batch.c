@@ -0,0 +1,276 @@
+#include "mock_windows.h"
+
+// Prevent inclusion of the full application header
+#define YOUTUBECACHER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+#include <wctype.h>
+#include <assert.h>
+
+#ifndef CREATE_ALWAYS
+#define CREATE_ALWAYS 2
+#endif
+
+// The batch file is captured rather than written to disk
+static char writtenFile[4096];
+static DWORD writtenLength = 0;
+
+static BOOL TestWriteFile(HANDLE h, const void* data, DWORD length, DWORD* written, void* overlapped) {
+    (void)h; (void)overlapped;
+    assert(writtenLength + length <= sizeof(writtenFile));
+    memcpy(writtenFile + writtenLength, data, length);
+    writtenLength += length;
+    if (written) *written = length;
+    return TRUE;
+}
+
+// UTF-8 for the code points the tests use; wchar_t holds whole code points here
+static int TestWideCharToMultiByte(uint32_t cp, DWORD flags, const wchar_t* src, int srclen,
+                                   char* dst, int dstlen, const char* defaultChar, BOOL* usedDefault) {
+    (void)cp; (void)flags; (void)defaultChar; (void)usedDefault;
+    size_t count = srclen < 0 ? wcslen(src) + 1 : (size_t)srclen;
+    int needed = 0;
+    for (size_t i = 0; i < count; i++) {
+        unsigned long c = (unsigned long)src[i];
+        char encoded[3];
+        int length = 1;
+        if (c < 0x80) {
+            encoded[0] = (char)c;
+        } else {
+            assert(c < 0x800);
+            encoded[0] = (char)(0xC0 | (c >> 6));
+            encoded[1] = (char)(0x80 | (c & 0x3F));
+            length = 2;
+        }
+        if (dst) {
+            if (needed + length > dstlen) return 0;
+            memcpy(dst + needed, encoded, length);
+        }
+        needed += length;
+    }
+    return needed;
+}
+
+#define WriteFile TestWriteFile
+#define WideCharToMultiByte TestWideCharToMultiByte
+
+// The cache's parser logs as it goes; the v= form is all the tests need
+static wchar_t* ExtractVideoIdFromUrl(const wchar_t* url) {
+    const wchar_t* id = wcsstr(url, L"v=");
+    if (!id || wcslen(id + 2) < 11) return NULL;
+    wchar_t* videoId = (wchar_t*)malloc(12 * sizeof(wchar_t));
+    wcsncpy(videoId, id + 2, 11);
+    videoId[11] = L'\0';
+    return videoId;
+}
+
+#include "../ytdlpbatch.h"
+#include "../ytdlpbatch.c"
+
+// Records every callback as "<index>:<state>:<percentage>"
+typedef struct {
+    char events[64][16];
+    int count;
+} Events;
+
+static void RecordEvent(const YtDlpBatch* batch, int index, void* userData) {
+    Events* events = (Events*)userData;
+    assert(events->count < 64);
+    snprintf(events->events[events->count++], 16, "%d:%d:%d",
+             index, (int)batch->items[index].state, batch->items[index].percentage);
+}
+
+static const wchar_t* urls[] = {
+    L"https://www.youtube.com/watch?v=aaaaaaaaaaa",
+    L"https://www.youtube.com/watch?v=bbbbbbbbbbb",
+    L"https://www.youtube.com/watch?v=ccccccccccc",
+    L"https://vimeo.com/12345",
+};
+
+void test_markers() {
+    printf("Running yt-dlp batch marker tests...\n");
+
+    wchar_t* videoId = NULL;
+    wchar_t* title = NULL;
+    assert(ParseVideoStartMarker(L"VIDEOSTART|abc|A title | with bars", &videoId, &title));
+    assert(wcscmp(videoId, L"abc") == 0 && wcscmp(title, L"A title | with bars") == 0);
+    free(videoId);
+    free(title);
+    assert(!ParseVideoStartMarker(L"VIDEOSTART|no separator", &videoId, &title));
+    assert(videoId == NULL && title == NULL);
+
+    assert(ParseVideoEndMarker(L"VIDEOEND|abc \r\n", &videoId));
+    assert(wcscmp(videoId, L"abc") == 0);
+    free(videoId);
+    assert(!ParseVideoEndMarker(L"VIDEOEND|", &videoId));
+    free(videoId);
+    assert(!ParseVideoEndMarker(L"[download] 5%", &videoId));
+
+    printf("All yt-dlp batch marker tests passed!\n");
+}
+
+void test_batch_size() {
+    printf("Running yt-dlp batch size tests...\n");
+
+    assert(ParseYtDlpBatchSize(NULL) == YTDLP_BATCH_DEFAULT_SIZE);
+    assert(ParseYtDlpBatchSize(L"") == YTDLP_BATCH_DEFAULT_SIZE);
+    assert(ParseYtDlpBatchSize(L"0") == YTDLP_BATCH_DEFAULT_SIZE);
+    assert(ParseYtDlpBatchSize(L"-4") == YTDLP_BATCH_DEFAULT_SIZE);
+    assert(ParseYtDlpBatchSize(L"1") == 1);
+    assert(ParseYtDlpBatchSize(L"40") == 40);
+    assert(ParseYtDlpBatchSize(L"100000") == YTDLP_BATCH_MAX_SIZE);
+
+    printf("All yt-dlp batch size tests passed!\n");
+}
+
+void test_batch_file() {
+    printf("Running yt-dlp batch file tests...\n");
+
+    const wchar_t* fileUrls[] = { L"https://example.com/a", L"https://example.com/\x00E9t\x00E9" };
+    YtDlpBatch batch;
+    assert(InitYtDlpBatch(&batch, fileUrls, 2, NULL, NULL));
+    writtenLength = 0;
+    assert(WriteYtDlpBatchFile(&batch, L"batch.txt"));
+    const char expected[] = "https://example.com/a\nhttps://example.com/\xC3\xA9t\xC3\xA9\n";
+    assert(writtenLength == sizeof(expected) - 1 && memcmp(writtenFile, expected, writtenLength) == 0);
+    FreeYtDlpBatch(&batch);
+
+    // A line break would split one URL into two
+    const wchar_t* badUrls[] = { L"https://example.com/a\nhttps://example.com/b" };
+    assert(InitYtDlpBatch(&batch, badUrls, 1, NULL, NULL));
+    assert(!WriteYtDlpBatchFile(&batch, L"batch.txt"));
+    FreeYtDlpBatch(&batch);
+
+    assert(!InitYtDlpBatch(&batch, fileUrls, 0, NULL, NULL));
+    assert(!WriteYtDlpBatchFile(&batch, L"batch.txt"));
+    FreeYtDlpBatch(&batch);
+
+    printf("All yt-dlp batch file tests passed!\n");
+}
+
+void test_attribution() {
+    printf("Running yt-dlp batch attribution tests...\n");
+
+    // Every URL downloads; progress moves only on whole percents
+    Events events;
+    memset(&events, 0, sizeof(events));
+    YtDlpBatch batch;
+    assert(InitYtDlpBatch(&batch, urls, 3, RecordEvent, &events));
+    assert(wcscmp(batch.items[1].videoId, L"bbbbbbbbbbb") == 0);
+    TrackYtDlpBatchLine(&batch, L"[youtube] Extracting URL: https://www.youtube.com/watch?v=aaaaaaaaaaa");
+    TrackYtDlpBatchLine(&batch, L"VIDEOSTART|aaaaaaaaaaa|First");
+    TrackYtDlpBatchLine(&batch, L"NA|NA|NA|NA");
+    TrackYtDlpBatchLine(&batch, L"500|1000|2000.5|3");
+    TrackYtDlpBatchLine(&batch, L"501|1000|2000.5|3");
+    TrackYtDlpBatchLine(&batch, L"1000|1000|2000.5|0");
+    TrackYtDlpBatchLine(&batch, L"VIDEOEND|aaaaaaaaaaa");
+    TrackYtDlpBatchLine(&batch, L"VIDEOSTART|bbbbbbbbbbb|Second");
+    TrackYtDlpBatchLine(&batch, L"VIDEOEND|bbbbbbbbbbb");
+    TrackYtDlpBatchLine(&batch, L"VIDEOSTART|ccccccccccc|Third");
+    TrackYtDlpBatchLine(&batch, L"VIDEOEND|ccccccccccc");
+    FinishYtDlpBatch(&batch, FALSE);
+
+    const char* expected[] = { "0:1:0", "0:1:50", "0:1:99", "0:2:100", "1:1:0", "1:2:100", "2:1:0", "2:2:100" };
+    assert(events.count == 8);
+    for (int i = 0; i < 8; i++) assert(strcmp(events.events[i], expected[i]) == 0);
+    assert(wcscmp(batch.items[2].title, L"Third") == 0);
+    assert(batch.current == -1 && batch.firstPending == 3);
+    FreeYtDlpBatch(&batch);
+
+    // An unavailable video fails before it starts: the error names it, and it
+    // counts as failed once yt-dlp moves on to the next URL
+    memset(&events, 0, sizeof(events));
+    assert(InitYtDlpBatch(&batch, urls, 3, RecordEvent, &events));
+    TrackYtDlpBatchLine(&batch, L"ERROR: [youtube] aaaaaaaaaaa: Video unavailable");
+    assert(batch.items[0].state == YTDLP_BATCH_PENDING && events.count == 0);
+    TrackYtDlpBatchLine(&batch, L"VIDEOSTART|bbbbbbbbbbb|Second");
+    assert(batch.items[0].state == YTDLP_BATCH_FAILED);
+    assert(wcscmp(batch.items[0].errorMessage, L"ERROR: [youtube] aaaaaaaaaaa: Video unavailable") == 0);
+    assert(strcmp(events.events[0], "0:3:0") == 0 && strcmp(events.events[1], "1:1:0") == 0);
+
+    // A download that breaks off fails where it stands; the process ending
+    // fails the URL it never reached
+    TrackYtDlpBatchLine(&batch, L"10|100|NA|NA");
+    TrackYtDlpBatchLine(&batch, L"ERROR: unable to download video data: HTTP Error 403: Forbidden");
+    assert(batch.items[1].state == YTDLP_BATCH_FAILED && batch.items[1].percentage == 10);
+    assert(wcsstr(batch.items[1].errorMessage, L"403") != NULL);
+    FinishYtDlpBatch(&batch, FALSE);
+    assert(batch.items[2].state == YTDLP_BATCH_FAILED);
+    assert(wcscmp(batch.items[2].errorMessage, L"yt-dlp stopped before reaching this URL") == 0);
+    assert(events.count == 5);
+    FreeYtDlpBatch(&batch);
+
+    // A skipped URL with no error of its own still fails when a later one starts
+    memset(&events, 0, sizeof(events));
+    assert(InitYtDlpBatch(&batch, urls, 3, RecordEvent, &events));
+    TrackYtDlpBatchLine(&batch, L"VIDEOSTART|ccccccccccc|Third");
+    assert(batch.items[0].state == YTDLP_BATCH_FAILED && batch.items[1].state == YTDLP_BATCH_FAILED);
+    assert(wcscmp(batch.items[1].errorMessage, L"yt-dlp could not download this URL") == 0);
+    assert(batch.current == 2);
+
+    // Stopping the batch cancels what had not finished
+    FinishYtDlpBatch(&batch, TRUE);
+    assert(batch.items[2].state == YTDLP_BATCH_CANCELLED && batch.items[2].errorMessage == NULL);
+    FreeYtDlpBatch(&batch);
+
+    // A URL that names no video is matched by its place in line
+    memset(&events, 0, sizeof(events));
+    assert(InitYtDlpBatch(&batch, urls + 2, 2, RecordEvent, &events));
+    assert(batch.items[1].videoId == NULL);
+    TrackYtDlpBatchLine(&batch, L"VIDEOSTART|ccccccccccc|Third");
+    TrackYtDlpBatchLine(&batch, L"VIDEOEND|ccccccccccc");
+    TrackYtDlpBatchLine(&batch, L"VIDEOSTART|12345|Vimeo video");
+    TrackYtDlpBatchLine(&batch, L"VIDEOEND|12345");
+    assert(batch.items[0].state == YTDLP_BATCH_SUCCEEDED && batch.items[1].state == YTDLP_BATCH_SUCCEEDED);
+    assert(wcscmp(batch.items[1].title, L"Vimeo video") == 0);
+
+    // Markers past the end of the batch change nothing
+    TrackYtDlpBatchLine(&batch, L"VIDEOSTART|zzzzzzzzzzz|Stray");
+    TrackYtDlpBatchLine(&batch, L"VIDEOEND|zzzzzzzzzzz");
+    TrackYtDlpBatchLine(&batch, L"ERROR: stray");
+    assert(batch.current == -1 && events.count == 4);
+    FinishYtDlpBatch(&batch, FALSE);
+    assert(events.count == 4);
+    FreeYtDlpBatch(&batch);
+
+    // The same video twice is downloaded twice, one item each time
+    const wchar_t* twice[] = { urls[0], urls[1], urls[0] };
+    memset(&events, 0, sizeof(events));
+    assert(InitYtDlpBatch(&batch, twice, 3, RecordEvent, &events));
+    TrackYtDlpBatchLine(&batch, L"VIDEOSTART|aaaaaaaaaaa|First");
+    TrackYtDlpBatchLine(&batch, L"VIDEOEND|aaaaaaaaaaa");
+    TrackYtDlpBatchLine(&batch, L"VIDEOSTART|bbbbbbbbbbb|Second");
+    TrackYtDlpBatchLine(&batch, L"VIDEOEND|bbbbbbbbbbb");
+    TrackYtDlpBatchLine(&batch, L"VIDEOSTART|aaaaaaaaaaa|First");
+    assert(batch.current == 2);
+    TrackYtDlpBatchLine(&batch, L"VIDEOEND|aaaaaaaaaaa");
+    for (int i = 0; i < 3; i++) assert(batch.items[i].state == YTDLP_BATCH_SUCCEEDED);
+    FreeYtDlpBatch(&batch);
+
+    // Output without markers, as from a yt-dlp that died at startup, fails everything
+    memset(&events, 0, sizeof(events));
+    assert(InitYtDlpBatch(&batch, urls, 2, RecordEvent, &events));
+    TrackYtDlpBatchLine(&batch, L"Traceback (most recent call last):");
+    FinishYtDlpBatch(&batch, FALSE);
+    assert(batch.items[0].state == YTDLP_BATCH_FAILED && batch.items[1].state == YTDLP_BATCH_FAILED);
+    assert(events.count == 2);
+    FreeYtDlpBatch(&batch);
+
+    // Nothing to do on an empty batch
+    TrackYtDlpBatchLine(&batch, L"VIDEOSTART|aaaaaaaaaaa|First");
+    FinishYtDlpBatch(&batch, FALSE);
+    FinishYtDlpBatch(NULL, FALSE);
+
+    printf("All yt-dlp batch attribution tests passed!\n");
+}
+
+int main() {
+    test_markers();
+    test_batch_size();
+    test_batch_file();
+    test_attribution();
+    return 0;
+}
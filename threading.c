@@ -18,6 +18,7 @@ BOOL InitializeThreadContext(ThreadContext* threadContext) {
     // Note: InitializeCriticalSection can raise exceptions on low memory,
     // but we'll handle this with standard error checking
     InitializeCriticalSection(&threadContext->criticalSection);
+    threadContext->cancelEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
 
     // Initialize enhanced lifecycle management fields
     threadContext->timeoutMs = 30000; // Default 30 second timeout
@@ -37,6 +38,7 @@ void CleanupThreadContext(ThreadContext* threadContext) {
         EnterCriticalSection(&threadContext->criticalSection);
         threadContext->cancelRequested = TRUE;
         LeaveCriticalSection(&threadContext->criticalSection);
+        if (threadContext->cancelEvent) SetEvent(threadContext->cancelEvent);
 
         // Use the thread's configured timeout or default to 5 seconds
         DWORD timeout = (threadContext->timeoutMs > 0) ? threadContext->timeoutMs : 5000;
@@ -57,6 +59,10 @@ void CleanupThreadContext(ThreadContext* threadContext) {
 
     // Clean up critical section
     DeleteCriticalSection(&threadContext->criticalSection);
+    if (threadContext->cancelEvent) {
+        CloseHandle(threadContext->cancelEvent);
+        threadContext->cancelEvent = NULL;
+    }
 
     // Reset state
     threadContext->isRunning = FALSE;
@@ -71,6 +77,7 @@ BOOL SetCancellationFlag(ThreadContext* threadContext) {
     EnterCriticalSection(&threadContext->criticalSection);
     threadContext->cancelRequested = TRUE;
     LeaveCriticalSection(&threadContext->criticalSection);
+    if (threadContext->cancelEvent) SetEvent(threadContext->cancelEvent);
 
     return TRUE;
 }
@@ -534,11 +541,7 @@ void HandleDownloadCompletion(HWND hDlg, YtDlpResult* result, NonBlockingDownloa
 
             SAFE_FREE(videoId);
 
-            // Refresh the cache list UI
-            ThreadSafeDebugOutput(L"YouTubeCacher: HandleDownloadCompletion - Refreshing cache list UI");
-            RefreshCacheList(GetDlgItem(hDlg, IDC_LIST), GetCacheManager());
-            UpdateCacheListStatus(hDlg, GetCacheManager());
-            ThreadSafeDebugOutput(L"YouTubeCacher: HandleDownloadCompletion - Cache list refreshed");
+            // The new entry reaches the cache list as a WM_CACHE_CHANGED delta
         }
     } else {
         UpdateMainProgressBar(hDlg, 0, L"Download failed");
@@ -8,6 +8,9 @@
 // Progress callback function type
 typedef void (*ProgressCallback)(int percentage, const wchar_t* status, void* userData);
 
+// Output line callback function type, called for every line the subprocess writes
+typedef void (*SubprocessLineCallback)(const wchar_t* line, void* userData);
+
 // IPC Message Types for efficient cross-thread communication
 typedef enum {
     IPC_MSG_PROGRESS_UPDATE = 1,
@@ -100,6 +103,7 @@ typedef struct {
     DWORD threadId;
     BOOL isRunning;
     BOOL cancelRequested;
+    HANDLE cancelEvent;         // Set along with cancelRequested, for threads that wait on handles
     CRITICAL_SECTION criticalSection;
     
     // Enhanced lifecycle management fields
@@ -191,10 +195,13 @@ typedef struct {
     wchar_t* arguments;
     wchar_t* workingDirectory;
     DWORD timeoutMs;
+    DWORD priorityClass;            // CreateProcessW priority flag; 0 inherits ours
     
     // Progress and status
     ProgressCallback progressCallback;
     void* callbackUserData;
+    SubprocessLineCallback lineCallback;
+    void* lineCallbackUserData;
     HWND parentWindow;
     
     // Cancellation support
@@ -212,7 +219,9 @@ BOOL SetSubprocessExecutable(ThreadSafeSubprocessContext* context, const wchar_t
 BOOL SetSubprocessArguments(ThreadSafeSubprocessContext* context, const wchar_t* args);
 BOOL SetSubprocessWorkingDirectory(ThreadSafeSubprocessContext* context, const wchar_t* dir);
 BOOL SetSubprocessTimeout(ThreadSafeSubprocessContext* context, DWORD timeoutMs);
+BOOL SetSubprocessPriorityClass(ThreadSafeSubprocessContext* context, DWORD priorityClass);
 BOOL SetSubprocessProgressCallback(ThreadSafeSubprocessContext* context, ProgressCallback callback, void* userData);
+BOOL SetSubprocessLineCallback(ThreadSafeSubprocessContext* context, SubprocessLineCallback callback, void* userData);
 BOOL SetSubprocessParentWindow(ThreadSafeSubprocessContext* context, HWND parentWindow);
 
 // Thread-safe process control functions
@@ -235,6 +244,7 @@ BOOL ForceKillThreadSafeSubprocess(ThreadSafeSubprocessContext* context);
 BOOL StartThreadSafeSubprocessOutputCollection(ThreadSafeSubprocessContext* context);
 BOOL ExecuteThreadSafeSubprocessWithOutput(ThreadSafeSubprocessContext* context);
 BOOL WaitForThreadSafeSubprocessWithOutputCompletion(ThreadSafeSubprocessContext* context, DWORD timeoutMs);
+BOOL IsThreadSafeSubprocessOutputComplete(ThreadSafeSubprocessContext* context);
 BOOL GetFinalThreadSafeSubprocessOutput(ThreadSafeSubprocessContext* context, wchar_t** output, size_t* length, DWORD* exitCode);
 
 // Adapter functions for integrating with existing ytdlp.c code
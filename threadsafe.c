@@ -444,6 +444,20 @@ BOOL SetSubprocessTimeout(ThreadSafeSubprocessContext* context, DWORD timeoutMs)
     return TRUE;
 }
 
+/**
+ * Set the priority class the subprocess runs at, e.g. BELOW_NORMAL_PRIORITY_CLASS
+ */
+BOOL SetSubprocessPriorityClass(ThreadSafeSubprocessContext* context, DWORD priorityClass) {
+    if (!context || !context->initialized) {
+        return FALSE;
+    }
+
+    EnterCriticalSection(&context->configLock);
+    context->priorityClass = priorityClass;
+    LeaveCriticalSection(&context->configLock);
+    return TRUE;
+}
+
 /**
  * Set the progress callback for the subprocess
  */
@@ -458,6 +472,23 @@ BOOL SetSubprocessProgressCallback(ThreadSafeSubprocessContext* context, Progres
     return TRUE;
 }
 
+/**
+ * Set the callback that sees every line of subprocess output
+ */
+BOOL SetSubprocessLineCallback(ThreadSafeSubprocessContext* context, SubprocessLineCallback callback, void* userData) {
+    if (!context || !context->initialized) {
+        return FALSE;
+    }
+
+    // Set before the process starts; cleared while the reader runs, it takes
+    // effect before this returns, since the reader calls it under the same lock
+    EnterCriticalSection(&context->outputLock);
+    context->lineCallback = callback;
+    context->lineCallbackUserData = userData;
+    LeaveCriticalSection(&context->outputLock);
+    return TRUE;
+}
+
 /**
  * Set the parent window for the subprocess
  */
@@ -640,20 +671,18 @@ BOOL StartThreadSafeSubprocess(ThreadSafeSubprocessContext* context) {
     if (context->workingDirectory) {
         workDir = SAFE_WCSDUP(context->workingDirectory);
     }
+    DWORD priorityClass = context->priorityClass;
     LeaveCriticalSection(&context->configLock);
 
     // Create pipes for output capture
     SECURITY_ATTRIBUTES sa = { sizeof(sa), NULL, TRUE };
     HANDLE hOutputRead = NULL, hOutputWrite = NULL;
     
-    if (!CreatePipe(&hOutputRead, &hOutputWrite, &sa, 0)) {
+    if (!CreateOutputPipe(&hOutputRead, &hOutputWrite, &sa)) {
         SAFE_FREE(cmdLine);
         if (workDir) SAFE_FREE(workDir);
         return FALSE;
     }
-    
-    // Make sure the read handle is not inherited
-    SetHandleInformation(hOutputRead, HANDLE_FLAG_INHERIT, 0);
 
     // Set up process startup info
     STARTUPINFOW si = {0};
@@ -672,7 +701,7 @@ BOOL StartThreadSafeSubprocess(ThreadSafeSubprocessContext* context) {
         NULL,           // Process handle not inheritable
         NULL,           // Thread handle not inheritable
         TRUE,           // Set handle inheritance to TRUE for pipes
-        CREATE_NO_WINDOW, // No window
+        CREATE_NO_WINDOW | priorityClass, // No window, at the requested priority
         NULL,           // Use parent's environment block
         workDir,        // Working directory
         &si,            // Pointer to STARTUPINFO structure
@@ -945,6 +974,59 @@ BOOL ForceKillThreadSafeSubprocess(ThreadSafeSubprocessContext* context) {
 
 // Thread-safe subprocess output collection implementation
 
+// State the output reader's line handler needs, one per subprocess
+typedef struct {
+    ThreadSafeSubprocessContext* context;
+    wchar_t* lineWithEnding;        // Line plus \r\n, reused from line to line
+    size_t capacity;
+} SubprocessOutputLines;
+
+/**
+ * Collect one decoded line of subprocess output
+ */
+static void HandleSubprocessOutputLine(void* param, const wchar_t* line, size_t length) {
+    SubprocessOutputLines* lines = (SubprocessOutputLines*)param;
+    ThreadSafeSubprocessContext* context = lines->context;
+    if (length == 0) {
+        return;
+    }
+
+    // Append to output buffer with Windows line endings
+    if (length + 3 > lines->capacity) {
+        size_t capacity = (length + 3) * 2;
+        wchar_t* grown = (wchar_t*)SAFE_REALLOC(lines->lineWithEnding, capacity * sizeof(wchar_t));
+        if (!grown) {
+            ThreadSafeDebugOutput(L"SubprocessOutputReaderThread: Failed to append output");
+            return;
+        }
+        lines->lineWithEnding = grown;
+        lines->capacity = capacity;
+    }
+    memcpy(lines->lineWithEnding, line, length * sizeof(wchar_t));
+    wcscpy(lines->lineWithEnding + length, L"\r\n");
+
+    if (!AppendToThreadSafeSubprocessOutput(context, lines->lineWithEnding, length + 2)) {
+        ThreadSafeDebugOutput(L"SubprocessOutputReaderThread: Failed to append output");
+    }
+
+    // Also append to session log (in-memory only, separate from disk logging)
+    AppendToYtDlpSessionLog(lines->lineWithEnding);
+
+    EnterCriticalSection(&context->outputLock);
+    if (context->lineCallback) {
+        context->lineCallback(line, context->lineCallbackUserData);
+    }
+    LeaveCriticalSection(&context->outputLock);
+
+    // Call progress callback if available
+    if (context->progressCallback) {
+        // Parse progress information from the line if it looks like progress
+        if (wcsstr(line, L"%") || wcsstr(line, L"download") || wcsstr(line, L"Downloading")) {
+            context->progressCallback(-1, line, context->callbackUserData);
+        }
+    }
+}
+
 /**
  * Worker thread function for collecting subprocess output
  * Runs in background to continuously read from subprocess output pipe
@@ -957,157 +1039,59 @@ static DWORD WINAPI SubprocessOutputReaderThread(LPVOID lpParam) {
 
     ThreadSafeDebugOutput(L"SubprocessOutputReaderThread: Starting output collection");
 
-    char buffer[4096];
+    EnterCriticalSection(&context->processStateLock);
+    HANDLE hOutputRead = context->hOutputRead;
+    HANDLE hProcess = context->hProcess;
+    LeaveCriticalSection(&context->processStateLock);
+
+    OutputPipeReader* reader = OpenOutputPipeReader(hOutputRead);
+    if (!reader) {
+        ThreadSafeDebugOutput(L"SubprocessOutputReaderThread: No output handle available");
+    }
+
+    char* buffer = NULL;
     DWORD bytesRead;
-    BOOL success = TRUE;
 
-    // Accumulator for incomplete UTF-8 sequences
-    static char utf8Accumulator[8] = {0};
-    static size_t accumulatorLength = 0;
+    // Lines are split and decoded per subprocess, so subprocesses running at
+    // the same time never share a partial line
+    LineDecoder decoder;
+    InitLineDecoder(&decoder);
+    SubprocessOutputLines lines;
+    lines.context = context;
+    lines.lineWithEnding = NULL;
+    lines.capacity = 0;
 
-    while (success) {
+    while (reader) {
         // Check for cancellation
         if (context->cancellationRequested) {
             ThreadSafeDebugOutput(L"SubprocessOutputReaderThread: Cancellation requested, exiting");
             break;
         }
 
-        // Check if process is still running
-        if (!IsThreadSafeSubprocessRunning(context)) {
-            ThreadSafeDebugOutput(L"SubprocessOutputReaderThread: Process no longer running");
+        // Sleep until output arrives, the process exits or cancellation is requested
+        int readResult = ReadOutputPipe(reader, hProcess, context->cancellationEvent, INFINITE, &buffer, &bytesRead);
+        if (readResult == OUTPUT_PIPE_CANCELLED) {
+            ThreadSafeDebugOutput(L"SubprocessOutputReaderThread: Cancellation requested, exiting");
             break;
         }
-
-        // Read from output pipe with timeout
-        EnterCriticalSection(&context->processStateLock);
-        HANDLE hOutputRead = context->hOutputRead;
-        LeaveCriticalSection(&context->processStateLock);
-
-        if (!hOutputRead) {
-            ThreadSafeDebugOutput(L"SubprocessOutputReaderThread: No output handle available");
+        if (readResult == OUTPUT_PIPE_EXITED || readResult == OUTPUT_PIPE_CLOSED) {
+            ThreadSafeDebugOutput(L"SubprocessOutputReaderThread: Process ended and its output is drained");
             break;
         }
-
-        // Use PeekNamedPipe to check if data is available (non-blocking)
-        DWORD bytesAvailable = 0;
-        if (!PeekNamedPipe(hOutputRead, NULL, 0, NULL, &bytesAvailable, NULL)) {
-            DWORD error = GetLastError();
-            if (error == ERROR_BROKEN_PIPE) {
-                ThreadSafeDebugOutput(L"SubprocessOutputReaderThread: Pipe broken, process ended");
-                break;
-            } else {
-                ThreadSafeDebugOutputF(L"SubprocessOutputReaderThread: PeekNamedPipe failed with error %lu", error);
-                Sleep(100); // Wait a bit before retrying
-                continue;
-            }
-        }
-
-        if (bytesAvailable == 0) {
-            Sleep(50); // No data available, wait a bit
-            continue;
-        }
-
-        // Read available data
-        success = ReadFile(hOutputRead, buffer, sizeof(buffer) - 1, &bytesRead, NULL);
-        if (!success) {
-            DWORD error = GetLastError();
-            if (error == ERROR_BROKEN_PIPE) {
-                ThreadSafeDebugOutput(L"SubprocessOutputReaderThread: Pipe broken during read, process ended");
-                break;
-            } else {
-                ThreadSafeDebugOutputF(L"SubprocessOutputReaderThread: ReadFile failed with error %lu", error);
-                break;
-            }
-        }
-
-        if (bytesRead == 0) {
-            continue; // No data read, continue loop
-        }
-
-        buffer[bytesRead] = '\0'; // Null-terminate
-
-        // Combine with any accumulated bytes from previous incomplete UTF-8 sequences
-        size_t totalBytes = accumulatorLength + bytesRead;
-        char* processBuffer = buffer;
-        
-        if (accumulatorLength > 0) {
-            // We have incomplete UTF-8 from previous read
-            if (totalBytes < sizeof(utf8Accumulator)) {
-                memcpy(utf8Accumulator + accumulatorLength, buffer, bytesRead);
-                utf8Accumulator[totalBytes] = '\0';
-                processBuffer = utf8Accumulator;
-                bytesRead = (DWORD)totalBytes;
-                accumulatorLength = 0; // Reset accumulator
-            } else {
-                // Too much data, process what we have and continue
-                accumulatorLength = 0;
-            }
-        }
-
-        // Process complete lines only to avoid partial UTF-8 sequences
-        char* lineStart = processBuffer;
-        char* lineEnd;
-        
-        while ((lineEnd = strchr(lineStart, '\n')) != NULL) {
-            *lineEnd = '\0'; // Null-terminate the line
-            
-            // Remove \r if present (Windows line endings)
-            size_t lineLength = lineEnd - lineStart;
-            if (lineLength > 0 && lineStart[lineLength - 1] == '\r') {
-                lineStart[lineLength - 1] = '\0';
-                lineLength--;
-            }
-
-            // Convert UTF-8 line to wide characters
-            if (lineLength > 0) {
-                wchar_t wideBuffer[2048];
-                int converted = MultiByteToWideChar(CP_UTF8, 0, lineStart, (int)lineLength, wideBuffer, 2047);
-                if (converted > 0) {
-                    wideBuffer[converted] = L'\0';
-                    
-                    // Append to output buffer with Windows line endings
-                    wchar_t lineWithEnding[2050];
-                    swprintf(lineWithEnding, 2050, L"%ls\r\n", wideBuffer);
-                    
-                    if (!AppendToThreadSafeSubprocessOutput(context, lineWithEnding, wcslen(lineWithEnding))) {
-                        ThreadSafeDebugOutput(L"SubprocessOutputReaderThread: Failed to append output");
-                    }
-                    
-                    // Also append to session log (in-memory only, separate from disk logging)
-                    AppendToYtDlpSessionLog(lineWithEnding);
-
-                    // Call progress callback if available
-                    if (context->progressCallback) {
-                        // Parse progress information from the line if it looks like progress
-                        if (wcsstr(wideBuffer, L"%") || wcsstr(wideBuffer, L"download") || wcsstr(wideBuffer, L"Downloading")) {
-                            context->progressCallback(-1, wideBuffer, context->callbackUserData);
-                        }
-                    }
-                }
-            }
-
-            lineStart = lineEnd + 1; // Move to next line
+        if (readResult != OUTPUT_PIPE_DATA) {
+            ThreadSafeDebugOutput(L"SubprocessOutputReaderThread: Reading output failed");
+            break;
         }
 
-        // Handle any remaining incomplete line (save for next iteration)
-        size_t remainingLength = strlen(lineStart);
-        if (remainingLength > 0 && remainingLength < sizeof(utf8Accumulator)) {
-            memcpy(utf8Accumulator, lineStart, remainingLength);
-            utf8Accumulator[remainingLength] = '\0';
-            accumulatorLength = remainingLength;
-        }
+        // Hand every complete line to the handler
+        DecodeLines(&decoder, buffer, bytesRead, HandleSubprocessOutputLine, &lines);
     }
 
-    // Process any final accumulated data
-    if (accumulatorLength > 0) {
-        wchar_t wideBuffer[2048];
-        int converted = MultiByteToWideChar(CP_UTF8, 0, utf8Accumulator, (int)accumulatorLength, wideBuffer, 2047);
-        if (converted > 0) {
-            wideBuffer[converted] = L'\0';
-            AppendToThreadSafeSubprocessOutput(context, wideBuffer, converted);
-        }
-        accumulatorLength = 0;
-    }
+    // Process any unterminated last line
+    FlushLineDecoder(&decoder, HandleSubprocessOutputLine, &lines);
+    FreeLineDecoder(&decoder);
+    SAFE_FREE(lines.lineWithEnding);
+    CloseOutputPipeReader(reader);
 
     // Mark output as complete
     EnterCriticalSection(&context->outputLock);
@@ -1179,6 +1163,20 @@ BOOL ExecuteThreadSafeSubprocessWithOutput(ThreadSafeSubprocessContext* context)
     return TRUE;
 }
 
+/**
+ * Whether the output reader has finished and will not touch the context again
+ */
+BOOL IsThreadSafeSubprocessOutputComplete(ThreadSafeSubprocessContext* context) {
+    if (!context || !context->initialized) {
+        return FALSE;
+    }
+
+    EnterCriticalSection(&context->outputLock);
+    BOOL outputComplete = context->outputComplete;
+    LeaveCriticalSection(&context->outputLock);
+    return outputComplete;
+}
+
 /**
  * Wait for subprocess completion and ensure all output is collected
  */
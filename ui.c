@@ -2,6 +2,7 @@
 
 // Timer IDs
 #define IDT_PROGRESS_HIDE_TIMER 9998
+#define IDT_CACHE_FILTER_TIMER  9997
 
 // Subclass procedure for text field to detect paste operations
 LRESULT CALLBACK TextFieldSubclassProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
@@ -63,6 +64,12 @@ void UpdateVideoProgress(HWND hDlg, int current, int total) {
     SetDlgItemTextW(hDlg, IDC_VIDEO_PROGRESS, progressText);
 }
 
+// Fetch a new URL's title and duration in the background unless they are cached
+static void PrefetchVideoMetadata(HWND hDlg, const wchar_t* url) {
+    if (IsCachedMetadataValid(GetCachedVideoMetadata(), url)) return;
+    StartMetadataPrefetch(hDlg, url);
+}
+
 void CheckClipboardForYouTubeURL(HWND hDlg) {
     // Check if autopaste is enabled
     if (!GetAutopasteState()) {
@@ -84,6 +91,10 @@ void CheckClipboardForYouTubeURL(HWND hDlg) {
                     SetCurrentBrush(GetBrush(BRUSH_LIGHT_GREEN));
                     InvalidateRect(GetDlgItem(hDlg, IDC_TEXT_FIELD), NULL, TRUE);
                     SetProgrammaticChangeFlag(FALSE);
+
+                    // The user will likely download it - have its info ready
+                    GetDlgItemTextW(hDlg, IDC_TEXT_FIELD, currentText, MAX_BUFFER_SIZE);
+                    PrefetchVideoMetadata(hDlg, currentText);
                 }
                 GlobalUnlock(hData);
             }
@@ -718,8 +729,10 @@ void ResizeControls(HWND hDlg) {
     // Status labels
     SetWindowPos(GetDlgItem(hDlg, IDC_LABEL2), NULL,
                 downloadGroupX + margin, offlineContentY, (int)(150 * scaleX), labelHeight, SWP_NOZORDER);
+    int itemsLabelX = downloadGroupX + margin + (int)(160 * scaleX);
+    int itemsLabelWidth = (int)(130 * scaleX);  // Room for "Items: N of M" while filtered
     SetWindowPos(GetDlgItem(hDlg, IDC_LABEL3), NULL,
-                downloadGroupX + margin + (int)(160 * scaleX), offlineContentY, (int)(100 * scaleX), labelHeight, SWP_NOZORDER);
+                itemsLabelX, offlineContentY, itemsLabelWidth, labelHeight, SWP_NOZORDER);
 
     // Calculate listbox and side buttons
     int listY = offlineContentY + labelHeight + margin;
@@ -741,6 +754,15 @@ void ResizeControls(HWND hDlg) {
     // Resize ListView columns
     ResizeCacheListViewColumns(GetDlgItem(hDlg, IDC_LIST), listWidth);
 
+    // Search box: rest of the status row, ending with the list
+    int filterX = itemsLabelX + itemsLabelWidth + margin;
+    int filterWidth = downloadGroupX + margin + listWidth - filterX;
+    if (filterWidth < (int)(80 * scaleX)) {
+        filterWidth = (int)(80 * scaleX);
+    }
+    SetWindowPos(GetDlgItem(hDlg, IDC_CACHE_FILTER), NULL,
+                filterX, offlineContentY - (textHeight - labelHeight) / 2, filterWidth, textHeight, SWP_NOZORDER);
+
     // Side buttons (Play, Delete, and Add)
     int sideButtonHeight = (int)(32 * scaleY);
     SetWindowPos(GetDlgItem(hDlg, IDC_BUTTON2), NULL,
@@ -787,6 +809,52 @@ void ResizeControls(HWND hDlg) {
                 sideButtonX + colorButtonWidth + colorButtonSpacing, debugButtonRow2Y, colorButtonWidth, colorButtonHeight, SWP_NOZORDER);
 }
 
+// Fill the cache limit controls of the settings dialog from a download folder's budget
+static void LoadCacheBudgetControls(HWND hDlg, const wchar_t* downloadPath) {
+    static const wchar_t* const policyLabels[CACHE_EVICT_POLICY_COUNT] = {
+        L"Least recently played", L"Least often played", L"Largest, least played"
+    };
+
+    HWND hPolicy = GetDlgItem(hDlg, IDC_CACHE_POLICY);
+    for (int i = 0; i < CACHE_EVICT_POLICY_COUNT; i++) {
+        SendMessageW(hPolicy, CB_ADDSTRING, 0, (LPARAM)policyLabels[i]);
+    }
+
+    CacheBudget budget;
+    LoadCacheBudgetSetting(downloadPath, &budget);
+    if (budget.limitBytes > 0) {
+        wchar_t text[32];
+        swprintf(text, 32, L"%.4g", (double)budget.limitBytes / (1024.0 * 1024.0 * 1024.0));
+        SetDlgItemTextW(hDlg, IDC_CACHE_LIMIT, text);
+    }
+    SendMessageW(hPolicy, CB_SETCURSEL, budget.policy, 0);
+    SendDlgItemMessageW(hDlg, IDC_CACHE_LIMIT, EM_SETCUEBANNER, TRUE, (LPARAM)L"No limit");
+}
+
+// Read the cache limit controls; fails if the limit is neither empty nor a number of gigabytes
+static BOOL ReadCacheBudgetControls(HWND hDlg, CacheBudget* budget) {
+    wchar_t text[32];
+    GetDlgItemTextW(hDlg, IDC_CACHE_LIMIT, text, 32);
+
+    const wchar_t* start = text;
+    while (iswspace(*start)) start++;
+
+    double gigabytes = 0.0;
+    if (*start) {
+        wchar_t* end = NULL;
+        gigabytes = wcstod(start, &end);
+        while (iswspace(*end)) end++;
+        if (end == start || *end || gigabytes < 0.0 || gigabytes > 1e9) {
+            return FALSE;
+        }
+    }
+
+    budget->limitBytes = (ULONGLONG)(gigabytes * 1024.0 * 1024.0 * 1024.0);
+    LRESULT policy = SendDlgItemMessageW(hDlg, IDC_CACHE_POLICY, CB_GETCURSEL, 0, 0);
+    budget->policy = (policy >= 0 && policy < CACHE_EVICT_POLICY_COUNT) ? (int)policy : CACHE_EVICT_LRU;
+    return TRUE;
+}
+
 // Settings dialog procedure
 // Settings dialog component storage
 typedef struct {
@@ -823,6 +891,10 @@ INT_PTR CALLBACK SettingsDialogProc(HWND hDlg, UINT message, WPARAM wParam, LPAR
                         SetControlFont(GetDlgItem(hDlg, IDC_ENABLE_DEBUG), defaultFont, context->currentDpi);
                         SetControlFont(GetDlgItem(hDlg, IDC_ENABLE_LOGFILE), defaultFont, context->currentDpi);
                         SetControlFont(GetDlgItem(hDlg, IDC_ENABLE_AUTOPASTE), defaultFont, context->currentDpi);
+                        SetControlFont(GetDlgItem(hDlg, IDC_CACHE_LIMIT_LABEL), defaultFont, context->currentDpi);
+                        SetControlFont(GetDlgItem(hDlg, IDC_CACHE_LIMIT), defaultFont, context->currentDpi);
+                        SetControlFont(GetDlgItem(hDlg, IDC_CACHE_POLICY_LABEL), defaultFont, context->currentDpi);
+                        SetControlFont(GetDlgItem(hDlg, IDC_CACHE_POLICY), defaultFont, context->currentDpi);
                         SetControlFont(GetDlgItem(hDlg, IDOK), defaultFont, context->currentDpi);
                         SetControlFont(GetDlgItem(hDlg, IDCANCEL), defaultFont, context->currentDpi);
                     }
@@ -972,6 +1044,9 @@ INT_PTR CALLBACK SettingsDialogProc(HWND hDlg, UINT message, WPARAM wParam, LPAR
                 SetFileBrowserPath(components->playerBrowser, playerPath);
             }
 
+            // Cache limit of the download folder
+            LoadCacheBudgetControls(hDlg, downloadPath);
+
             // Load other settings (checkboxes, etc.) using existing LoadSettings function
             // But we need to load checkboxes manually since we're not using the old controls
             if (RegOpenKeyExW(HKEY_CURRENT_USER, REGISTRY_KEY, 0, KEY_READ, &hKey) == ERROR_SUCCESS) {
@@ -993,12 +1068,14 @@ INT_PTR CALLBACK SettingsDialogProc(HWND hDlg, UINT message, WPARAM wParam, LPAR
             SetControlAccessibility(GetDlgItem(hDlg, IDC_ENABLE_DEBUG), L"Enable debug mode", L"Show debug information in the main window");
             SetControlAccessibility(GetDlgItem(hDlg, IDC_ENABLE_LOGFILE), L"Enable log file", L"Write debug information to a log file");
             SetControlAccessibility(GetDlgItem(hDlg, IDC_ENABLE_AUTOPASTE), L"Enable auto-paste", L"Automatically paste URLs from clipboard");
+            SetControlAccessibility(GetDlgItem(hDlg, IDC_CACHE_LIMIT), L"Cache limit", L"Largest total size of cached videos in gigabytes, empty for no limit");
+            SetControlAccessibility(GetDlgItem(hDlg, IDC_CACHE_POLICY), L"Eviction policy", L"Which videos are removed when the cache exceeds its limit");
             SetControlAccessibility(GetDlgItem(hDlg, IDOK), L"OK", L"Save settings and close dialog");
             SetControlAccessibility(GetDlgItem(hDlg, IDCANCEL), L"Cancel", L"Close dialog without saving");
 
             // Configure tab order
             TabOrderConfig tabConfig;
-            TabOrderEntry entries[6];
+            TabOrderEntry entries[8];
             entries[0].controlId = IDC_YTDLP_PATH + 1; // Edit control of first component
             entries[0].tabOrder = 0;
             entries[0].isTabStop = TRUE;
@@ -1011,15 +1088,21 @@ INT_PTR CALLBACK SettingsDialogProc(HWND hDlg, UINT message, WPARAM wParam, LPAR
             entries[3].controlId = IDC_ENABLE_DEBUG;
             entries[3].tabOrder = 3;
             entries[3].isTabStop = TRUE;
-            entries[4].controlId = IDOK;
+            entries[4].controlId = IDC_CACHE_LIMIT;
             entries[4].tabOrder = 4;
             entries[4].isTabStop = TRUE;
-            entries[5].controlId = IDCANCEL;
+            entries[5].controlId = IDC_CACHE_POLICY;
             entries[5].tabOrder = 5;
             entries[5].isTabStop = TRUE;
+            entries[6].controlId = IDOK;
+            entries[6].tabOrder = 6;
+            entries[6].isTabStop = TRUE;
+            entries[7].controlId = IDCANCEL;
+            entries[7].tabOrder = 7;
+            entries[7].isTabStop = TRUE;
 
             tabConfig.entries = entries;
-            tabConfig.count = 6;
+            tabConfig.count = 8;
             SetDialogTabOrder(hDlg, &tabConfig);
 
             // Apply DPI-aware positioning (similar to error dialog)
@@ -1121,6 +1204,14 @@ INT_PTR CALLBACK SettingsDialogProc(HWND hDlg, UINT message, WPARAM wParam, LPAR
                         FreeValidationSummary(validationSummary);
                     }
 
+                    CacheBudget budget;
+                    if (!ReadCacheBudgetControls(hDlg, &budget)) {
+                        MessageBoxW(hDlg, L"The cache limit must be a number of gigabytes, or empty for no limit.",
+                                    L"Settings", MB_OK | MB_ICONWARNING);
+                        SetFocus(GetDlgItem(hDlg, IDC_CACHE_LIMIT));
+                        return TRUE;
+                    }
+
                     // Get values from components and save to registry
                     const wchar_t* ytdlpPath = GetFileBrowserPath(components->ytdlpBrowser);
                     const wchar_t* downloadPath = GetFolderBrowserPath(components->downloadFolderBrowser);
@@ -1155,6 +1246,13 @@ INT_PTR CALLBACK SettingsDialogProc(HWND hDlg, UINT message, WPARAM wParam, LPAR
                         RegCloseKey(hKey);
                     }
 
+                    // The limit belongs to the chosen download folder, and applies at once
+                    // if that is the folder the cache is indexing
+                    if (downloadPath && wcslen(downloadPath) > 0) {
+                        SaveCacheBudgetSetting(downloadPath, &budget);
+                        SetCacheBudget(GetCacheManager(), downloadPath, &budget);
+                    }
+
                     EndDialog(hDlg, IDOK);
                     return TRUE;
                 }
@@ -1337,6 +1435,7 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                         SetControlFont(GetDlgItem(hDlg, IDC_DOWNLOAD_BTN), defaultFont, context->currentDpi);
                         SetControlFont(GetDlgItem(hDlg, IDC_GETINFO_BTN), defaultFont, context->currentDpi);
                         SetControlFont(GetDlgItem(hDlg, IDC_LIST), defaultFont, context->currentDpi);
+                        SetControlFont(GetDlgItem(hDlg, IDC_CACHE_FILTER), defaultFont, context->currentDpi);
                     }
                 }
             }
@@ -1347,6 +1446,7 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
             // Initialize ListView with columns first
             HWND hListView = GetDlgItem(hDlg, IDC_LIST);
             InitializeCacheListView(hListView);
+            SendDlgItemMessageW(hDlg, IDC_CACHE_FILTER, EM_SETCUEBANNER, TRUE, (LPARAM)L"Search cached videos");
 
             // Load debug settings from registry
             wchar_t buffer[MAX_EXTENDED_PATH];
@@ -1376,15 +1476,28 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
             }
 
             if (InitializeCacheManager(GetCacheManager(), downloadPath)) {
-                // Scan for existing videos in download folder
-                ScanDownloadFolderForVideos(GetCacheManager(), downloadPath);
+                // Enforce the folder's storage limit in the background
+                CacheBudget budget;
+                if (LoadCacheBudgetSetting(downloadPath, &budget)) {
+                    SetCacheBudget(GetCacheManager(), downloadPath, &budget);
+                }
+
+                // Listen for changes first so none are missed between the refresh and the listener
+                SetCacheChangeListener(GetCacheManager(), hDlg);
 
                 // Refresh the UI with cached videos
                 RefreshCacheList(hListView, GetCacheManager());
                 UpdateCacheListStatus(hDlg, GetCacheManager());
 
-                // Start background thread to populate file sizes
-                StartFileSizeUpdateThread(GetCacheManager(), hDlg);
+                // Scan the download folder for new videos in the background; they
+                // arrive as changes. Sizes and missing files are then reconciled
+                // with the disk, and the folder is watched from there on.
+                wchar_t threadsText[16];
+                DWORD statThreads = 0;
+                if (LoadSettingFromRegistry(REG_FILE_INFO_THREADS, threadsText, 16)) {
+                    statThreads = (DWORD)_wtoi(threadsText);
+                }
+                StartCacheFolderScan(GetCacheManager(), hDlg, statThreads);
             } else {
                 // Initialize dialog controls with defaults if cache fails
                 SetDlgItemTextW(hDlg, IDC_LABEL2, L"Status: Cache initialization failed");
@@ -1393,6 +1506,7 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
 
             // Initialize cached video metadata
             InitializeCachedMetadata(GetCachedVideoMetadata());
+            InitializeMetadataPrefetcher();
 
             // Update debug control visibility
             UpdateDebugControlVisibility(hDlg);
@@ -1405,6 +1519,7 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                 SetCurrentBrush(GetBrush(BRUSH_LIGHT_TEAL));
                 InvalidateRect(GetDlgItem(hDlg, IDC_TEXT_FIELD), NULL, TRUE);
                 SetProgrammaticChangeFlag(FALSE);
+                PrefetchVideoMetadata(hDlg, cmdURL);
             } else {
                 // Check clipboard for YouTube URL
                 CheckClipboardForYouTubeURL(hDlg);
@@ -1562,12 +1677,89 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
             break;
         }
 
-        case WM_CACHE_SIZE_UPDATE: {
-            // Background thread has updated file sizes - refresh the status display
+        case WM_CACHE_CHANGED: {
+            // Cache entries were added, removed or updated - apply the queued changes
+            ApplyCacheListChanges(hDlg, GetCacheManager());
+            return TRUE;
+        }
+
+        case WM_CACHE_SCAN_PROGRESS: {
+            // File size scan finished a batch - show its progress
             UpdateCacheListStatus(hDlg, GetCacheManager());
             return TRUE;
         }
 
+        case WM_CACHE_DEDUPE_COMPLETE: {
+            // Duplicate scan finished - show what it found, and offer to link the copies
+            CacheDedupeReport* report = (CacheDedupeReport*)lParam;
+            if (!report) return TRUE;
+
+            wchar_t* details = FormatCacheDedupeReport(report);
+            wchar_t* wasted = FormatFileSize(report->duplicateBytes);
+            wchar_t message[512];
+            UnifiedDialogConfig config = {0};
+            config.dialogType = UNIFIED_DIALOG_INFO;
+            config.title = L"Duplicate Videos";
+            config.message = message;
+            config.details = details;
+            config.tab1_name = L"Details";
+            config.showDetailsButton = details != NULL;
+            config.showCopyButton = details != NULL;
+
+            if (report->duplicateCount == 0) {
+                wcscpy(message, L"No duplicate videos were found in the cache.");
+                config.showDetailsButton = FALSE;
+                config.showCopyButton = FALSE;
+            } else if (report->linking) {
+                swprintf(message, 512, L"%lu of %lu duplicate copies were replaced with hard links.",
+                         report->linkedCount, report->duplicateCount);
+                if (report->linkErrors > 0) config.dialogType = UNIFIED_DIALOG_WARNING;
+            } else {
+                swprintf(message, 512, L"Found %lu duplicate copies in %lu sets of identical videos, taking %ls.",
+                         report->duplicateCount, report->groupCount, wasted ? wasted : L"unknown space");
+            }
+            ShowUnifiedDialog(hDlg, &config);
+
+            if (report->duplicateCount > 0 && !report->linking) {
+                int result = MessageBoxW(hDlg,
+                                         L"Replace the duplicate copies with hard links to one copy?\r\n\r\n"
+                                         L"Every video stays in the cache under its own name, but the copies "
+                                         L"no longer take space of their own. Files are only linked after a "
+                                         L"byte-by-byte comparison.",
+                                         L"Link Duplicates", MB_YESNO | MB_ICONQUESTION | MB_DEFBUTTON2);
+                if (result == IDYES) {
+                    StartCacheDedupe(GetCacheManager(), hDlg, TRUE);
+                }
+            }
+
+            if (wasted) SAFE_FREE(wasted);
+            if (details) SAFE_FREE(details);
+            FreeCacheDedupeReport(report);
+            return TRUE;
+        }
+
+        case WM_METADATA_PREFETCHED: {
+            // Background fetch finished before anyone asked for it - keep it for
+            // the next Download or Get Info if its URL is still the one in the box
+            MetadataPrefetchResult* result = (MetadataPrefetchResult*)lParam;
+            if (!result) return TRUE;
+
+            wchar_t url[MAX_URL_LENGTH];
+            GetDlgItemTextW(hDlg, IDC_TEXT_FIELD, url, MAX_URL_LENGTH);
+            if (result->metadata && result->metadata->success && wcscmp(url, result->url) == 0) {
+                StoreCachedMetadata(GetCachedVideoMetadata(), result->url, result->metadata);
+            }
+
+            FreeMetadataPrefetchResult(result);
+            return TRUE;
+        }
+
+        case WM_CACHE_SORT_COMPLETE: {
+            // Sort worker has built the new display order - show it
+            RefreshCacheList(GetDlgItem(hDlg, IDC_LIST), GetCacheManager());
+            return TRUE;
+        }
+
         case WM_INITMENUPOPUP: {
             if (LOWORD(lParam) == 1) {  // Edit menu (index 1)
                 HMENU hMenu = (HMENU)wParam;
@@ -1668,6 +1860,18 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                 SortListViewByColumn(GetDlgItem(hDlg, IDC_LIST), pnmv->iSubItem, GetCacheManager(), &sortInfo);
                 return TRUE;
             }
+
+            // Owner-data ListView: cell text comes from the current cache snapshot
+            if (pnmh->idFrom == IDC_LIST && pnmh->code == LVN_GETDISPINFOW) {
+                GetCacheListDisplayInfo(pnmh->hwndFrom, (NMLVDISPINFOW*)lParam);
+                return TRUE;
+            }
+
+            if (pnmh->idFrom == IDC_LIST && pnmh->code == LVN_ODFINDITEMW) {
+                int foundIndex = FindCacheListItem(pnmh->hwndFrom, (NMLVFINDITEMW*)lParam);
+                SetWindowLongPtrW(hDlg, DWLP_MSGRESULT, (LONG_PTR)foundIndex);
+                return TRUE;
+            }
             break;
         }
 
@@ -1696,6 +1900,17 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                         EnableMenuItem(hPopup, ID_LISTVIEW_COPY_PATH, MF_BYCOMMAND | (singleSelection ? MF_ENABLED : MF_GRAYED));
                         EnableMenuItem(hPopup, ID_LISTVIEW_COPY_URL, MF_BYCOMMAND | (singleSelection ? MF_ENABLED : MF_GRAYED));
 
+                        // Only videos that failed their integrity check can be downloaded again
+                        BOOL damaged = FALSE;
+                        if (singleSelection) {
+                            wchar_t* videoId = GetSelectedVideoId(hListView);
+                            if (videoId) {
+                                damaged = IsCacheEntryDamaged(GetCacheManager(), videoId);
+                                SAFE_FREE(videoId);
+                            }
+                        }
+                        EnableMenuItem(hPopup, ID_LISTVIEW_REDOWNLOAD, MF_BYCOMMAND | (damaged ? MF_ENABLED : MF_GRAYED));
+
                         TrackPopupMenu(hPopup, TPM_RIGHTBUTTON, pt.x, pt.y, 0, hDlg, NULL);
                     }
                     DestroyMenu(hMenu);
@@ -1760,6 +1975,84 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                     return TRUE;
                 }
 
+                case ID_LISTVIEW_FIND_DUPLICATES: {
+                    // Runs in the background; the result arrives as WM_CACHE_DEDUPE_COMPLETE
+                    if (!StartCacheDedupe(GetCacheManager(), hDlg, FALSE)) {
+                        UnifiedDialogConfig config = {0};
+                        config.dialogType = UNIFIED_DIALOG_INFO;
+                        config.title = L"Duplicate Videos";
+                        config.message = L"A search for duplicate videos is already running.";
+                        config.details = L"The results will be shown when the current search finishes.";
+                        config.tab1_name = L"Details";
+                        config.showDetailsButton = FALSE;
+                        config.showCopyButton = FALSE;
+                        ShowUnifiedDialog(hDlg, &config);
+                    }
+                    return TRUE;
+                }
+
+                case ID_LISTVIEW_REDOWNLOAD: {
+                    HWND hListView = GetDlgItem(hDlg, IDC_LIST);
+                    wchar_t* videoId = GetSelectedVideoId(hListView);
+                    if (!videoId || !IsCacheEntryDamaged(GetCacheManager(), videoId)) {
+                        if (videoId) SAFE_FREE(videoId);
+                        return TRUE;
+                    }
+
+                    if (IsDownloadActive()) {
+                        UnifiedDialogConfig config = {0};
+                        config.dialogType = UNIFIED_DIALOG_INFO;
+                        config.title = L"Re-download Video";
+                        config.message = L"Please wait for the current download to finish.";
+                        config.details = L"Only one video is downloaded at a time. The damaged video can be downloaded again once the current download is done.";
+                        config.tab1_name = L"Details";
+                        config.showDetailsButton = FALSE;
+                        config.showCopyButton = FALSE;
+                        ShowUnifiedDialog(hDlg, &config);
+                        SAFE_FREE(videoId);
+                        return TRUE;
+                    }
+
+                    int result = MessageBoxW(hDlg,
+                                             L"This video's file no longer matches the checksum taken when it was "
+                                             L"downloaded, so it is probably damaged.\r\n\r\n"
+                                             L"Delete the damaged file and download the video again?",
+                                             L"Re-download Video", MB_YESNO | MB_ICONQUESTION);
+                    if (result != IDYES) {
+                        SAFE_FREE(videoId);
+                        return TRUE;
+                    }
+
+                    // The damaged files go first, or the download would find them and stop
+                    DeleteResult* deleteResult = DeleteCacheEntryFilesDetailed(GetCacheManager(), videoId);
+                    if (deleteResult && deleteResult->errorCount > 0) {
+                        wchar_t* errorDetails = FormatDeleteErrorDetails(deleteResult);
+                        UnifiedDialogConfig config = {0};
+                        config.dialogType = UNIFIED_DIALOG_ERROR;
+                        config.title = L"Re-download Video";
+                        config.message = L"The damaged files could not be deleted, so the video was not downloaded again.";
+                        config.details = errorDetails ? errorDetails : L"The damaged files could not be deleted.";
+                        config.tab1_name = L"Details";
+                        config.showDetailsButton = TRUE;
+                        config.showCopyButton = TRUE;
+                        ShowUnifiedDialog(hDlg, &config);
+                        if (errorDetails) SAFE_FREE(errorDetails);
+                    } else {
+                        wchar_t* url = GetYouTubeUrlFromVideoId(videoId);
+                        if (url) {
+                            SetDlgItemTextW(hDlg, IDC_TEXT_FIELD, url);
+                            SendMessage(hDlg, WM_COMMAND, MAKEWPARAM(IDC_DOWNLOAD_BTN, BN_CLICKED), 0);
+                            SAFE_FREE(url);
+                        }
+                    }
+                    if (deleteResult) FreeDeleteResult(deleteResult);
+
+                    RefreshCacheList(hListView, GetCacheManager());
+                    UpdateCacheListStatus(hDlg, GetCacheManager());
+                    SAFE_FREE(videoId);
+                    return TRUE;
+                }
+
                 case ID_LISTVIEW_DELETE: {
                     // Trigger the Delete button (IDC_BUTTON3)
                     SendMessage(hDlg, WM_COMMAND, MAKEWPARAM(IDC_BUTTON3, BN_CLICKED), 0);
@@ -1770,17 +2063,18 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                     HWND hListView = GetDlgItem(hDlg, IDC_LIST);
                     wchar_t* videoId = GetSelectedVideoId(hListView);
                     if (videoId) {
-                        CacheEntry* entry = FindCacheEntry(GetCacheManager(), videoId);
-                        if (entry && entry->title) {
+                        CacheViewSnapshot* snapshot = AcquireCacheSnapshot(GetCacheManager());
+                        const CacheViewRow* row = FindCacheViewRow(snapshot, videoId);
+                        if (row && row->title) {
                             // Copy title to clipboard
                             if (OpenClipboard(hDlg)) {
                                 EmptyClipboard();
-                                size_t len = wcslen(entry->title);
+                                size_t len = wcslen(row->title);
                                 HGLOBAL hMem = GlobalAlloc(GMEM_MOVEABLE, (len + 1) * sizeof(wchar_t));
                                 if (hMem) {
                                     wchar_t* pMem = (wchar_t*)GlobalLock(hMem);
                                     if (pMem) {
-                                        wcscpy(pMem, entry->title);
+                                        wcscpy(pMem, row->title);
                                         GlobalUnlock(hMem);
                                         SetClipboardData(CF_UNICODETEXT, hMem);
                                     }
@@ -1788,6 +2082,7 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                                 CloseClipboard();
                             }
                         }
+                        ReleaseCacheViewSnapshot(snapshot);
                         SAFE_FREE(videoId);
                     }
                     return TRUE;
@@ -1797,17 +2092,18 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                     HWND hListView = GetDlgItem(hDlg, IDC_LIST);
                     wchar_t* videoId = GetSelectedVideoId(hListView);
                     if (videoId) {
-                        CacheEntry* entry = FindCacheEntry(GetCacheManager(), videoId);
-                        if (entry && entry->mainVideoFile) {
+                        CacheViewSnapshot* snapshot = AcquireCacheSnapshot(GetCacheManager());
+                        const CacheViewRow* row = FindCacheViewRow(snapshot, videoId);
+                        if (row && row->mainVideoFile) {
                             // Copy file path to clipboard
                             if (OpenClipboard(hDlg)) {
                                 EmptyClipboard();
-                                size_t len = wcslen(entry->mainVideoFile);
+                                size_t len = wcslen(row->mainVideoFile);
                                 HGLOBAL hMem = GlobalAlloc(GMEM_MOVEABLE, (len + 1) * sizeof(wchar_t));
                                 if (hMem) {
                                     wchar_t* pMem = (wchar_t*)GlobalLock(hMem);
                                     if (pMem) {
-                                        wcscpy(pMem, entry->mainVideoFile);
+                                        wcscpy(pMem, row->mainVideoFile);
                                         GlobalUnlock(hMem);
                                         SetClipboardData(CF_UNICODETEXT, hMem);
                                     }
@@ -1815,6 +2111,7 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                                 CloseClipboard();
                             }
                         }
+                        ReleaseCacheViewSnapshot(snapshot);
                         SAFE_FREE(videoId);
                     }
                     return TRUE;
@@ -1872,6 +2169,13 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                     DialogBoxParamW(GetModuleHandle(NULL), MAKEINTRESOURCEW(IDD_MULTI_DOWNLOAD), hDlg, MultiDownloadDialogProc, (LPARAM)hDlg);
                     return TRUE;
 
+                case IDC_CACHE_FILTER:
+                    if (HIWORD(wParam) == EN_CHANGE) {
+                        // Restart the delay so a burst of keystrokes filters once
+                        SetTimer(hDlg, IDT_CACHE_FILTER_TIMER, 150, NULL);
+                    }
+                    break;
+
                 case IDC_TEXT_FIELD:
                     if (HIWORD(wParam) == EN_CHANGE) {
                         // Skip processing if this is a programmatic change
@@ -1886,6 +2190,9 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                         wchar_t buffer[MAX_BUFFER_SIZE];
                         GetDlgItemTextW(hDlg, IDC_TEXT_FIELD, buffer, MAX_BUFFER_SIZE);
 
+                        // Background fetches for a URL no longer in the box are wasted
+                        CancelMetadataPrefetchesExcept(buffer);
+
                         // Handle different user input scenarios
                         HBRUSH currentBrush = GetCurrentBrush();
                         if (currentBrush == GetBrush(BRUSH_LIGHT_GREEN)) {
@@ -1898,6 +2205,7 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                             // Manual paste of YouTube URL - set to light blue
                             SetCurrentBrush(GetBrush(BRUSH_LIGHT_BLUE));
                             SetManualPasteFlag(FALSE); // Reset flag after use
+                            PrefetchVideoMetadata(hDlg, buffer);
                         } else if (GetManualPasteFlag()) {
                             // Manual paste of non-YouTube content - keep white but reset flag
                             SetManualPasteFlag(FALSE);
@@ -2057,8 +2365,10 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                         // Set flag to indicate we want to download after getting info
                         SetDownloadAfterInfoFlag(TRUE);
 
-                        // Start asynchronous metadata retrieval
-                        if (!StartNonBlockingGetInfo(hDlg, url, GetCachedVideoMetadata())) {
+                        // Start asynchronous metadata retrieval, or take over the
+                        // background fetch already under way for this URL
+                        if (!AdoptMetadataPrefetch(url) &&
+                            !StartNonBlockingGetInfo(hDlg, url, GetCachedVideoMetadata())) {
                             // Failed to start async get info
                             SetDownloadAfterInfoFlag(FALSE);
                             SetProgressBarMarquee(hDlg, FALSE);
@@ -2216,6 +2526,11 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                     SetProgressBarMarquee(hDlg, TRUE);
                     UpdateMainProgressBar(hDlg, -1, L"Getting video information...");
 
+                    // A background fetch for this URL reports as a Get Info would
+                    if (AdoptMetadataPrefetch(url)) {
+                        break;
+                    }
+
                     // Start non-blocking Get Info operation with enhanced error reporting
                     OperationResult* result = StartNonBlockingGetInfoEx(hDlg, url, GetCachedVideoMetadata());
                     if (!result || !result->success) {
@@ -2302,6 +2617,7 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                         config.showCopyButton = FALSE;
 
                         ShowUnifiedDialog(hDlg, &config);
+                        SAFE_FREE(selectedVideoId);
                         break;
                     }
 
@@ -2327,6 +2643,7 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                         config.showCopyButton = FALSE;
 
                         ShowUnifiedDialog(hDlg, &config);
+                        SAFE_FREE(selectedVideoId);
                         break;
                     }
 
@@ -2353,6 +2670,7 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                         RefreshCacheList(hListView, GetCacheManager());
                         UpdateCacheListStatus(hDlg, GetCacheManager());
                     }
+                    SAFE_FREE(selectedVideoId);
                     break;
                 }
 
@@ -2382,16 +2700,19 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                         break;
                     }
 
+                    // Title of a single selected video, from the published snapshot
+                    CacheViewSnapshot* snapshot = AcquireCacheSnapshot(GetCacheManager());
+                    const CacheViewRow* row = selectedCount == 1 ? FindCacheViewRow(snapshot, selectedVideoIds[0]) : NULL;
+
                     // Build confirmation message
                     wchar_t confirmMsg[1024];
                     if (selectedCount == 1) {
                         // Single video - show title if available
-                        CacheEntry* entry = FindCacheEntry(GetCacheManager(), selectedVideoIds[0]);
-                        if (entry && entry->title) {
+                        if (row && row->title) {
                             swprintf(confirmMsg, 1024,
                                     L"Are you sure you want to delete \"%ls\"?\r\n\r\n"
                                     L"This will permanently delete the video file and any associated subtitle files.",
-                                    entry->title);
+                                    row->title);
                         } else {
                             wcscpy(confirmMsg, L"Are you sure you want to delete the selected video?\r\n\r\n"
                                              L"This will permanently delete the video file and any associated subtitle files.");
@@ -2412,10 +2733,9 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                     if (result == IDYES) {
                         // Log the start of delete operation
                         if (selectedCount == 1) {
-                            CacheEntry* entry = FindCacheEntry(GetCacheManager(), selectedVideoIds[0]);
-                            if (entry && entry->title) {
+                            if (row && row->title) {
                                 ThreadSafeDebugOutputF(L"Starting delete operation for video: %ls (ID: %ls)",
-                                        entry->title, selectedVideoIds[0]);
+                                        row->title, selectedVideoIds[0]);
                             } else {
                                 ThreadSafeDebugOutputF(L"Starting delete operation for video ID: %ls", selectedVideoIds[0]);
                             }
@@ -2423,60 +2743,13 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                             ThreadSafeDebugOutputF(L"Starting delete operation for %d selected videos", selectedCount);
                         }
 
-                        // Delete all selected videos
-                        int totalErrors = 0;
-                        int totalSuccessful = 0;
-                        wchar_t* combinedErrorDetails = NULL;
-                        size_t combinedErrorSize = 0;
-
-                        for (int i = 0; i < selectedCount; i++) {
-                            DeleteResult* deleteResult = DeleteCacheEntryFilesDetailed(GetCacheManager(), selectedVideoIds[i]);
-
-                            if (deleteResult) {
-                                if (deleteResult->errorCount == 0) {
-                                    totalSuccessful++;
-                                } else {
-                                    totalErrors += deleteResult->errorCount;
-
-                                    // Combine error details
-                                    wchar_t* errorDetails = FormatDeleteErrorDetails(deleteResult);
-                                    if (errorDetails) {
-                                        size_t errorLen = wcslen(errorDetails);
-                                        size_t newSize = combinedErrorSize + errorLen + 100; // Extra space for headers
-
-                                        wchar_t* newCombined = (wchar_t*)SAFE_REALLOC(combinedErrorDetails, newSize * sizeof(wchar_t));
-                                        if (newCombined) {
-                                            combinedErrorDetails = newCombined;
-
-                                            if (combinedErrorSize == 0) {
-                                                wcscpy(combinedErrorDetails, L"Multiple Delete Operation Results:\n");
-                                                wcscpy(combinedErrorDetails + wcslen(combinedErrorDetails), L"=====================================\n\n");
-                                            }
-
-                                            // Add video identifier
-                                            CacheEntry* entry = FindCacheEntry(GetCacheManager(), selectedVideoIds[i]);
-                                            if (entry && entry->title) {
-                                                swprintf(combinedErrorDetails + wcslen(combinedErrorDetails),
-                                                        newSize - wcslen(combinedErrorDetails),
-                                                        L"Video: %ls\n", entry->title);
-                                            } else {
-                                                swprintf(combinedErrorDetails + wcslen(combinedErrorDetails),
-                                                        newSize - wcslen(combinedErrorDetails),
-                                                        L"Video ID: %ls\n", selectedVideoIds[i]);
-                                            }
-
-                                            wcscat(combinedErrorDetails, errorDetails);
-                                            wcscat(combinedErrorDetails, L"\n");
-
-                                            combinedErrorSize = wcslen(combinedErrorDetails);
-                                        }
-
-                                        SAFE_FREE(errorDetails);
-                                    }
-                                }
-
-                                FreeDeleteResult(deleteResult);
-                            }
+                        // Delete all selected videos as one batch
+                        DeleteResult* deleteResult = DeleteCacheEntriesDetailed(GetCacheManager(), selectedVideoIds, selectedCount);
+                        int totalErrors = deleteResult ? deleteResult->errorCount : 0;
+                        int totalSuccessful = deleteResult ? deleteResult->removedEntries : 0;
+                        wchar_t* combinedErrorDetails = totalErrors > 0 ? FormatDeleteErrorDetails(deleteResult) : NULL;
+                        if (deleteResult) {
+                            FreeDeleteResult(deleteResult);
                         }
 
                         // Show results
@@ -2545,15 +2818,12 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                             SAFE_FREE(combinedErrorDetails);
                         }
 
-                        // Log delete operation summary
+                        // Log delete operation summary; the removed rows arrive as WM_CACHE_CHANGED
                         ThreadSafeDebugOutputF(L"Delete operation completed: %d videos processed, %d successful, %d failed", selectedCount, totalSuccessful, selectedCount - totalSuccessful);
-
-                        // Refresh the list to show current state
-                        RefreshCacheList(hListView, GetCacheManager());
-                        UpdateCacheListStatus(hDlg, GetCacheManager());
                     }
 
                     // Clean up selected video IDs
+                    ReleaseCacheViewSnapshot(snapshot);
                     FreeSelectedVideoIds(selectedVideoIds, selectedCount);
                     break;
                 }
@@ -2567,13 +2837,8 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                     // Create download directory if it doesn't exist
                     CreateDownloadDirectoryIfNeeded(downloadPath);
 
-                    // Add dummy video (no success popup)
-                    if (AddDummyVideo(GetCacheManager(), downloadPath)) {
-                        // Refresh the list
-                        HWND hListView = GetDlgItem(hDlg, IDC_LIST);
-                        RefreshCacheList(hListView, GetCacheManager());
-                        UpdateCacheListStatus(hDlg, GetCacheManager());
-                    } else {
+                    // Add dummy video (no success popup); the new row arrives as WM_CACHE_CHANGED
+                    if (!AddDummyVideo(GetCacheManager(), downloadPath)) {
                         UnifiedDialogConfig config = {0};
                         config.dialogType = UNIFIED_DIALOG_ERROR;
                         config.title = L"Add Failed";
@@ -2693,6 +2958,14 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                 ShowMainProgressBar(hDlg, FALSE);
                 return TRUE;
             }
+            // Apply the cache search once typing pauses
+            if (wParam == IDT_CACHE_FILTER_TIMER) {
+                KillTimer(hDlg, IDT_CACHE_FILTER_TIMER);
+                wchar_t filter[MAX_BUFFER_SIZE];
+                GetDlgItemTextW(hDlg, IDC_CACHE_FILTER, filter, MAX_BUFFER_SIZE);
+                SetCacheListFilter(hDlg, GetCacheManager(), filter);
+                return TRUE;
+            }
             return FALSE;
 
         case WM_SYSCOLORCHANGE:
@@ -2985,9 +3258,13 @@ INT_PTR CALLBACK DialogProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lPara
                 SetOriginalTextFieldProc(NULL);
             }
 
-            // Clean up ListView item data
+            // Stop change notifications and clean up ListView item data
+            SetCacheChangeListener(GetCacheManager(), NULL);
             CleanupListViewItemData(GetDlgItem(hDlg, IDC_LIST));
 
+            // Stop background metadata fetches before the state they report into goes
+            ShutdownMetadataPrefetcher();
+
             // Clean up application state (this includes cache manager cleanup)
             ApplicationState* state = GetApplicationState();
             if (state) {
@@ -1022,6 +1022,24 @@ BOOL GetYtDlpArgsForOperation(YtDlpOperation operation, const wchar_t* url, cons
             }
             break;
 
+        case YTDLP_OP_DOWNLOAD_BATCH:
+            if (escapedUrl && escapedOutputPath) {
+                // One process for every URL in the batch file (url is its path). --print
+                // marks where each video starts and ends but implies --quiet, so
+                // --progress keeps the progress lines coming.
+                swprintf(operationArgs, 4096,
+                    L"--newline --no-colors --force-overwrites --ignore-errors "
+                    L"--write-info-json --no-simulate --progress "
+                    L"--print \"%ls\" --print \"%ls\" "
+                    L"--progress-template \"download:%%(progress.downloaded_bytes)s|%%(progress.total_bytes_estimate)s|%%(progress.speed)s|%%(progress.eta)s\" "
+                    L"--output %ls --batch-file %ls",
+                    YTDLP_BATCH_START_TEMPLATE, YTDLP_BATCH_END_TEMPLATE,
+                    escapedOutputPath, escapedUrl);
+            } else {
+                goto cleanup;
+            }
+            break;
+
         default:
             goto cleanup;
     }
@@ -1206,59 +1224,6 @@ BOOL ParsePlaylistProgressLine(const wchar_t* line, int* current, int* total) {
     return (*current > 0 && *total > 0);
 }
 
-// Parse VIDEOSTART marker: "VIDEOSTART|id|title"
-BOOL ParseVideoStartMarker(const wchar_t* line, wchar_t** videoId, wchar_t** title) {
-    if (!line || !videoId || !title) return FALSE;
-
-    *videoId = NULL;
-    *title = NULL;
-
-    const wchar_t* marker = wcsstr(line, L"VIDEOSTART|");
-    if (!marker) return FALSE;
-
-    marker += wcslen(L"VIDEOSTART|");
-
-    // Find next separator
-    const wchar_t* sep = wcschr(marker, L'|');
-    if (!sep) return FALSE;
-
-    // Extract video ID
-    size_t idLen = sep - marker;
-    *videoId = (wchar_t*)SAFE_MALLOC((idLen + 1) * sizeof(wchar_t));
-    if (!*videoId) return FALSE;
-    wcsncpy(*videoId, marker, idLen);
-    (*videoId)[idLen] = L'\0';
-
-    // Extract title (rest of line)
-    *title = SAFE_WCSDUP(sep + 1);
-
-    return TRUE;
-}
-
-// Parse VIDEOEND marker: "VIDEOEND|id"
-BOOL ParseVideoEndMarker(const wchar_t* line, wchar_t** videoId) {
-    if (!line || !videoId) return FALSE;
-
-    *videoId = NULL;
-
-    const wchar_t* marker = wcsstr(line, L"VIDEOEND|");
-    if (!marker) return FALSE;
-
-    marker += wcslen(L"VIDEOEND|");
-
-    *videoId = SAFE_WCSDUP(marker);
-
-    // Trim trailing whitespace/newlines
-    if (*videoId) {
-        size_t len = wcslen(*videoId);
-        while (len > 0 && ((*videoId)[len-1] == L'\r' || (*videoId)[len-1] == L'\n' || (*videoId)[len-1] == L' ')) {
-            (*videoId)[--len] = L'\0';
-        }
-    }
-
-    return (*videoId != NULL && (*videoId)[0] != L'\0');
-}
-
 // Parse JSON output from yt-dlp to extract metadata
 BOOL ParseVideoMetadataFromJson(const wchar_t* jsonOutput, VideoMetadata* metadata) {
     if (!jsonOutput || !metadata) return FALSE;
@@ -1340,6 +1305,40 @@ BOOL ParseVideoMetadataFromJson(const wchar_t* jsonOutput, VideoMetadata* metada
     return metadata->success;
 }
 
+// Parse the output of --get-title --get-duration: first line title, second duration
+BOOL ParseTitleDurationOutput(const wchar_t* output, VideoMetadata* metadata) {
+    if (!output || !metadata) return FALSE;
+
+    wchar_t* copy = SAFE_WCSDUP(output);
+    if (!copy) {
+        ThreadSafeDebugOutput(L"ParseTitleDurationOutput: Failed to duplicate output string");
+        return FALSE;
+    }
+
+    wchar_t* context = NULL;
+    wchar_t* line = wcstok(copy, L"\n", &context);
+    if (line) {
+        // First line is title
+        metadata->title = SAFE_WCSDUP(line);
+        ThreadSafeDebugOutputF(L"ParseTitleDurationOutput: Extracted title: %ls", metadata->title);
+
+        // Second line is duration
+        line = wcstok(NULL, L"\n", &context);
+        if (line) {
+            metadata->duration = SAFE_WCSDUP(line);
+            ThreadSafeDebugOutputF(L"ParseTitleDurationOutput: Extracted duration: %ls", metadata->duration);
+        } else {
+            ThreadSafeDebugOutput(L"ParseTitleDurationOutput: Warning - No duration found in output");
+        }
+    } else {
+        ThreadSafeDebugOutput(L"ParseTitleDurationOutput: Error - No lines found in yt-dlp output");
+    }
+    SAFE_FREE(copy);
+
+    metadata->success = (metadata->title != NULL);
+    return metadata->success;
+}
+
 // Extract video metadata using yt-dlp (optimized version)
 // Uses --get-title --get-duration together for faster, simpler parsing
 // Output format: First line = title, Second line = duration
@@ -1379,33 +1378,7 @@ BOOL GetVideoMetadata(const wchar_t* url, VideoMetadata* metadata) {
                     wcslen(result->output));
 
             // Parse the output - first line is title, second line is duration
-            wchar_t* output = SAFE_WCSDUP(result->output);
-            if (output) {
-                wchar_t* context = NULL;
-                wchar_t* line = wcstok(output, L"\n", &context);
-                if (line) {
-                    // First line is title
-                    metadata->title = SAFE_WCSDUP(line);
-                    ThreadSafeDebugOutputF(L"GetVideoMetadata: Extracted title: %ls", metadata->title);
-
-                    // Second line is duration
-                    line = wcstok(NULL, L"\n", &context);
-                    if (line) {
-                        metadata->duration = SAFE_WCSDUP(line);
-                        ThreadSafeDebugOutputF(L"GetVideoMetadata: Extracted duration: %ls", metadata->duration);
-                    } else {
-                        ThreadSafeDebugOutput(L"GetVideoMetadata: Warning - No duration found in output");
-                    }
-                } else {
-                    ThreadSafeDebugOutput(L"GetVideoMetadata: Error - No lines found in yt-dlp output");
-                }
-                SAFE_FREE(output);
-
-                metadata->success = (metadata->title != NULL);
-                success = metadata->success;
-            } else {
-                ThreadSafeDebugOutput(L"GetVideoMetadata: Failed to duplicate output string");
-            }
+            success = ParseTitleDurationOutput(result->output, metadata);
         } else {
             // Log detailed error information
             if (!result->success) {
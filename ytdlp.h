@@ -41,6 +41,11 @@ void FreeYtDlpRequest(YtDlpRequest* request);
 YtDlpResult* ExecuteYtDlpRequest(const YtDlpConfig* config, const YtDlpRequest* request);
 void FreeYtDlpResult(YtDlpResult* result);
 
+// Download every URL of a batch with one yt-dlp process, stopping it once
+// *stopRequested is set; FALSE only if the process could not be started
+BOOL ExecuteYtDlpBatchThreadSafe(const YtDlpConfig* config, YtDlpBatch* batch, const wchar_t* outputPath,
+                                 const wchar_t* tempDir, volatile LONG* stopRequested);
+
 // Error message processing
 wchar_t* ExtractSimpleErrorFromYtDlpOutput(const wchar_t* output);
 wchar_t* CreateUserFriendlyYtDlpError(DWORD exitCode, const wchar_t* output, const wchar_t* url);
@@ -80,6 +85,7 @@ void FreeErrorAnalysis(ErrorAnalysis* analysis);
 // Video metadata functions
 BOOL GetVideoMetadata(const wchar_t* url, VideoMetadata* metadata);
 BOOL ParseVideoMetadataFromJson(const wchar_t* jsonOutput, VideoMetadata* metadata);
+BOOL ParseTitleDurationOutput(const wchar_t* output, VideoMetadata* metadata);
 void FreeVideoMetadata(VideoMetadata* metadata);
 
 // Playlist metadata functions
@@ -87,8 +93,6 @@ void FreePlaylistVideoEntry(PlaylistVideoEntry* entry);
 void FreePlaylistMetadata(PlaylistMetadata* playlist);
 BOOL ParsePlaylistMetadataOutput(const wchar_t* output, PlaylistMetadata* playlist);
 BOOL ParsePlaylistProgressLine(const wchar_t* line, int* current, int* total);
-BOOL ParseVideoStartMarker(const wchar_t* line, wchar_t** videoId, wchar_t** title);
-BOOL ParseVideoEndMarker(const wchar_t* line, wchar_t** videoId);
 
 // Cached metadata functions
 void InitializeCachedMetadata(CachedVideoMetadata* cached);
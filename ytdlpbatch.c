@@ -0,0 +1,282 @@
+#include "YouTubeCacher.h"
+
+static void NotifyItem(YtDlpBatch* batch, int index) {
+    if (batch->callback) batch->callback(batch, index, batch->userData);
+}
+
+// Keep the first error given for an item; later ones are usually fallout
+static void RecordItemError(YtDlpBatchItem* item, const wchar_t* message) {
+    if (!item->errorMessage && message) item->errorMessage = SAFE_WCSDUP(message);
+}
+
+static void EndItem(YtDlpBatch* batch, int index, YtDlpBatchState state) {
+    YtDlpBatchItem* item = &batch->items[index];
+    item->state = state;
+    if (state == YTDLP_BATCH_SUCCEEDED) item->percentage = 100;
+    if (batch->current == index) batch->current = -1;
+    while (batch->firstPending < batch->count && batch->items[batch->firstPending].state != YTDLP_BATCH_PENDING) {
+        batch->firstPending++;
+    }
+    NotifyItem(batch, index);
+}
+
+BOOL InitYtDlpBatch(YtDlpBatch* batch, const wchar_t* const* urls, int count,
+                    YtDlpBatchCallback callback, void* userData) {
+    if (!batch) return FALSE;
+    memset(batch, 0, sizeof(YtDlpBatch));
+    batch->current = -1;
+    if (!urls || count <= 0) return FALSE;
+
+    batch->items = (YtDlpBatchItem*)SAFE_MALLOC(count * sizeof(YtDlpBatchItem));
+    if (!batch->items) return FALSE;
+    memset(batch->items, 0, count * sizeof(YtDlpBatchItem));
+    batch->count = count;
+    batch->callback = callback;
+    batch->userData = userData;
+
+    for (int i = 0; i < count; i++) {
+        batch->items[i].url = urls[i];
+        batch->items[i].videoId = urls[i] ? ExtractVideoIdFromUrl(urls[i]) : NULL;
+    }
+    return TRUE;
+}
+
+void FreeYtDlpBatch(YtDlpBatch* batch) {
+    if (!batch) return;
+
+    for (int i = 0; i < batch->count; i++) {
+        SAFE_FREE(batch->items[i].videoId);
+        SAFE_FREE(batch->items[i].title);
+        SAFE_FREE(batch->items[i].errorMessage);
+    }
+    SAFE_FREE(batch->items);
+    batch->count = 0;
+    batch->current = -1;
+    batch->firstPending = 0;
+}
+
+int ParseYtDlpBatchSize(const wchar_t* setting) {
+    int size = (setting && setting[0]) ? _wtoi(setting) : 0;
+    if (size <= 0) return YTDLP_BATCH_DEFAULT_SIZE;
+    if (size > YTDLP_BATCH_MAX_SIZE) return YTDLP_BATCH_MAX_SIZE;
+    return size;
+}
+
+BOOL WriteYtDlpBatchFile(const YtDlpBatch* batch, const wchar_t* path) {
+    if (!batch || batch->count <= 0 || !path) return FALSE;
+
+    // Size the file first; a line break inside a URL would split it in two
+    size_t total = 0;
+    for (int i = 0; i < batch->count; i++) {
+        const wchar_t* url = batch->items[i].url;
+        if (!url || !url[0] || wcspbrk(url, L"\r\n")) return FALSE;
+        int bytes = WideCharToMultiByte(CP_UTF8, 0, url, -1, NULL, 0, NULL, NULL);
+        if (bytes <= 0) return FALSE;
+        total += (size_t)bytes;     // The terminator's byte becomes the line's \n
+    }
+
+    char* text = (char*)SAFE_MALLOC(total);
+    if (!text) return FALSE;
+    size_t offset = 0;
+    for (int i = 0; i < batch->count; i++) {
+        int bytes = WideCharToMultiByte(CP_UTF8, 0, batch->items[i].url, -1,
+                                        text + offset, (int)(total - offset), NULL, NULL);
+        if (bytes <= 0) {
+            SAFE_FREE(text);
+            return FALSE;
+        }
+        offset += (size_t)bytes;
+        text[offset - 1] = '\n';
+    }
+
+    BOOL written = FALSE;
+    HANDLE hFile = CreateFileW(path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hFile != INVALID_HANDLE_VALUE) {
+        DWORD bytesWritten = 0;
+        written = WriteFile(hFile, text, (DWORD)offset, &bytesWritten, NULL) && bytesWritten == (DWORD)offset;
+        CloseHandle(hFile);
+    }
+    SAFE_FREE(text);
+    return written;
+}
+
+// yt-dlp works through the file in order, so the video that just started
+// belongs to a URL at or after the first pending one: the URL naming its ID,
+// else the first that names no ID, else simply the next in line
+static int FindStartedItem(const YtDlpBatch* batch, const wchar_t* videoId) {
+    int firstUnnamed = -1;
+    for (int i = batch->firstPending; i < batch->count; i++) {
+        const YtDlpBatchItem* item = &batch->items[i];
+        if (item->state != YTDLP_BATCH_PENDING) continue;
+        if (item->videoId) {
+            if (videoId && wcscmp(item->videoId, videoId) == 0) return i;
+        } else if (firstUnnamed < 0) {
+            firstUnnamed = i;
+        }
+    }
+    if (firstUnnamed >= 0) return firstUnnamed;
+    return batch->firstPending < batch->count ? batch->firstPending : -1;
+}
+
+static void StartItem(YtDlpBatch* batch, int index, wchar_t* title) {
+    // Whatever was still open, and every URL skipped on the way here, failed
+    if (batch->current >= 0) {
+        RecordItemError(&batch->items[batch->current], L"yt-dlp moved on before finishing this URL");
+        EndItem(batch, batch->current, YTDLP_BATCH_FAILED);
+    }
+    for (int i = batch->firstPending; i < index; i++) {
+        if (batch->items[i].state != YTDLP_BATCH_PENDING) continue;
+        RecordItemError(&batch->items[i], L"yt-dlp could not download this URL");
+        EndItem(batch, i, YTDLP_BATCH_FAILED);
+    }
+
+    YtDlpBatchItem* item = &batch->items[index];
+    SAFE_FREE(item->title);
+    item->title = title;
+    item->state = YTDLP_BATCH_STARTED;
+    item->percentage = 0;
+    batch->current = index;
+    NotifyItem(batch, index);
+}
+
+// A progress line from the download template: downloaded|estimate|speed|eta,
+// with NA for anything yt-dlp does not know yet
+static void TrackProgress(YtDlpBatch* batch, const wchar_t* line) {
+    wchar_t* end = NULL;
+    double downloaded = wcstod(line, &end);
+    if (end == line || *end != L'|') return;
+
+    const wchar_t* field = end + 1;
+    double total = wcstod(field, &end);
+    if (end == field || total <= 0) return;
+
+    int percentage = (int)(downloaded * 100.0 / total);
+    if (percentage < 0) percentage = 0;
+    if (percentage > 99) percentage = 99;   // 100 waits for the file to be moved into place
+
+    YtDlpBatchItem* item = &batch->items[batch->current];
+    if (percentage != item->percentage) {
+        item->percentage = percentage;
+        NotifyItem(batch, batch->current);
+    }
+}
+
+void TrackYtDlpBatchLine(YtDlpBatch* batch, const wchar_t* line) {
+    if (!batch || !batch->items || !line) return;
+
+    wchar_t* videoId = NULL;
+    wchar_t* title = NULL;
+    if (ParseVideoStartMarker(line, &videoId, &title)) {
+        int index = FindStartedItem(batch, videoId);
+        SAFE_FREE(videoId);
+        if (index >= 0) {
+            StartItem(batch, index, title);
+        } else {
+            SAFE_FREE(title);
+        }
+        return;
+    }
+    SAFE_FREE(videoId);
+    SAFE_FREE(title);
+
+    if (ParseVideoEndMarker(line, &videoId)) {
+        SAFE_FREE(videoId);
+        if (batch->current >= 0) EndItem(batch, batch->current, YTDLP_BATCH_SUCCEEDED);
+        return;
+    }
+    SAFE_FREE(videoId);
+
+    if (wcsncmp(line, L"ERROR:", 6) == 0) {
+        if (batch->current >= 0) {
+            RecordItemError(&batch->items[batch->current], line);
+            EndItem(batch, batch->current, YTDLP_BATCH_FAILED);
+            return;
+        }
+
+        // Failed before it could start: yt-dlp usually names the video, else
+        // it is the next URL in line. It counts as failed once a later URL
+        // starts or the process ends.
+        int target = -1;
+        for (int i = batch->firstPending; i < batch->count && target < 0; i++) {
+            const YtDlpBatchItem* item = &batch->items[i];
+            if (item->state == YTDLP_BATCH_PENDING && item->videoId && wcsstr(line, item->videoId)) target = i;
+        }
+        if (target < 0 && batch->firstPending < batch->count) target = batch->firstPending;
+        if (target >= 0) RecordItemError(&batch->items[target], line);
+        return;
+    }
+
+    if (batch->current >= 0 && iswdigit(line[0])) TrackProgress(batch, line);
+}
+
+void FinishYtDlpBatch(YtDlpBatch* batch, BOOL cancelled) {
+    if (!batch || !batch->items) return;
+
+    for (int i = 0; i < batch->count; i++) {
+        YtDlpBatchItem* item = &batch->items[i];
+        if (item->state != YTDLP_BATCH_PENDING && item->state != YTDLP_BATCH_STARTED) continue;
+
+        // An item that already reported an error failed whether or not the batch was stopped
+        if (cancelled && !item->errorMessage) {
+            EndItem(batch, i, YTDLP_BATCH_CANCELLED);
+        } else {
+            RecordItemError(item, item->state == YTDLP_BATCH_STARTED ?
+                            L"yt-dlp stopped before finishing this URL" :
+                            L"yt-dlp stopped before reaching this URL");
+            EndItem(batch, i, YTDLP_BATCH_FAILED);
+        }
+    }
+}
+
+// Parse VIDEOSTART marker: "VIDEOSTART|id|title"
+BOOL ParseVideoStartMarker(const wchar_t* line, wchar_t** videoId, wchar_t** title) {
+    if (!line || !videoId || !title) return FALSE;
+
+    *videoId = NULL;
+    *title = NULL;
+
+    const wchar_t* marker = wcsstr(line, L"VIDEOSTART|");
+    if (!marker) return FALSE;
+
+    marker += wcslen(L"VIDEOSTART|");
+
+    // Find next separator
+    const wchar_t* sep = wcschr(marker, L'|');
+    if (!sep) return FALSE;
+
+    // Extract video ID
+    size_t idLen = sep - marker;
+    *videoId = (wchar_t*)SAFE_MALLOC((idLen + 1) * sizeof(wchar_t));
+    if (!*videoId) return FALSE;
+    wcsncpy(*videoId, marker, idLen);
+    (*videoId)[idLen] = L'\0';
+
+    // Extract title (rest of line)
+    *title = SAFE_WCSDUP(sep + 1);
+
+    return TRUE;
+}
+
+// Parse VIDEOEND marker: "VIDEOEND|id"
+BOOL ParseVideoEndMarker(const wchar_t* line, wchar_t** videoId) {
+    if (!line || !videoId) return FALSE;
+
+    *videoId = NULL;
+
+    const wchar_t* marker = wcsstr(line, L"VIDEOEND|");
+    if (!marker) return FALSE;
+
+    marker += wcslen(L"VIDEOEND|");
+
+    *videoId = SAFE_WCSDUP(marker);
+
+    // Trim trailing whitespace/newlines
+    if (*videoId) {
+        size_t len = wcslen(*videoId);
+        while (len > 0 && ((*videoId)[len-1] == L'\r' || (*videoId)[len-1] == L'\n' || (*videoId)[len-1] == L' ')) {
+            (*videoId)[--len] = L'\0';
+        }
+    }
+
+    return (*videoId != NULL && (*videoId)[0] != L'\0');
+}
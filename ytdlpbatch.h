@@ -0,0 +1,79 @@
+#ifndef YTDLPBATCH_H
+#define YTDLPBATCH_H
+
+#include <windows.h>
+
+// Many URLs downloaded by one yt-dlp process.
+//
+// Every yt-dlp process spends about a second on Python startup and extractor
+// imports before it touches the network, which dominates a queue of short
+// videos. A batch hands a group of URLs to a single process through
+// --batch-file and works out from the output which URL each line belongs to.
+// yt-dlp takes the URLs strictly in file order. It prints
+// VIDEOSTART|id|title before downloading each video and VIDEOEND|id once the
+// file is in place. With --ignore-errors it reports a URL it cannot download
+// with an ERROR line and moves on to the next, so a URL still waiting when a
+// later one starts has failed.
+
+#define YTDLP_BATCH_DEFAULT_SIZE    25
+#define YTDLP_BATCH_MAX_SIZE        500
+
+// --print templates that make yt-dlp write the markers
+#define YTDLP_BATCH_START_TEMPLATE  L"before_dl:VIDEOSTART|%(id)s|%(title)s"
+#define YTDLP_BATCH_END_TEMPLATE    L"after_move:VIDEOEND|%(id)s"
+
+typedef enum {
+    YTDLP_BATCH_PENDING,            // Not reached yet
+    YTDLP_BATCH_STARTED,            // Between its VIDEOSTART and VIDEOEND
+    YTDLP_BATCH_SUCCEEDED,
+    YTDLP_BATCH_FAILED,
+    YTDLP_BATCH_CANCELLED
+} YtDlpBatchState;
+
+typedef struct {
+    const wchar_t* url;             // Owned by the caller
+    wchar_t* videoId;               // From the URL; NULL when it names no single video
+    wchar_t* title;                 // From VIDEOSTART
+    wchar_t* errorMessage;          // The first ERROR line given for it
+    YtDlpBatchState state;
+    int percentage;                 // Download progress
+} YtDlpBatchItem;
+
+typedef struct YtDlpBatch YtDlpBatch;
+
+// Called on the thread that reads yt-dlp's output whenever an item starts,
+// moves on by a percent, or finishes
+typedef void (*YtDlpBatchCallback)(const YtDlpBatch* batch, int index, void* userData);
+
+struct YtDlpBatch {
+    YtDlpBatchItem* items;
+    int count;
+    int current;                    // The started item, or -1
+    int firstPending;               // No item before this one is still pending
+    YtDlpBatchCallback callback;
+    void* userData;
+};
+
+BOOL InitYtDlpBatch(YtDlpBatch* batch, const wchar_t* const* urls, int count,
+                    YtDlpBatchCallback callback, void* userData);
+void FreeYtDlpBatch(YtDlpBatch* batch);
+
+// Batch size from its setting: missing or 0 gives the default, 1 runs one
+// process per URL, and anything above YTDLP_BATCH_MAX_SIZE is capped
+int ParseYtDlpBatchSize(const wchar_t* setting);
+
+// Write the URLs for --batch-file, one per line in UTF-8
+BOOL WriteYtDlpBatchFile(const YtDlpBatch* batch, const wchar_t* path);
+
+// Attribute one line of yt-dlp's output to the item it belongs to
+void TrackYtDlpBatchLine(YtDlpBatch* batch, const wchar_t* line);
+
+// The process has ended: every item it did not finish failed, or was
+// cancelled when the batch was stopped
+void FinishYtDlpBatch(YtDlpBatch* batch, BOOL cancelled);
+
+// Markers, also seen by the single download parser
+BOOL ParseVideoStartMarker(const wchar_t* line, wchar_t** videoId, wchar_t** title);
+BOOL ParseVideoEndMarker(const wchar_t* line, wchar_t** videoId);
+
+#endif // YTDLPBATCH_H